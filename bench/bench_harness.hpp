@@ -0,0 +1,259 @@
+/**
+ * @file bench_harness.hpp
+ * @brief 基准测试框架
+ *
+ * 每个用例是一个接受迭代次数的函数。运行器先倍增迭代次数直到单次采样
+ * 不短于 min_time，再以该次数重复采样，报告每次操作耗时的最小值、中位数和最大值。
+ * 结果以 JSON 输出，便于长期跟踪。
+ */
+
+#ifndef VDL_BENCH_HARNESS_HPP
+#define VDL_BENCH_HARNESS_HPP
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace vdl {
+namespace bench {
+
+// ============================================================================
+// 防止被优化掉
+// ============================================================================
+
+/**
+ * @brief 让编译器认为 value 被读取，基准循环不会被整体消除
+ */
+template <typename T>
+inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    __asm__ __volatile__("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// ============================================================================
+// 配置与结果
+// ============================================================================
+
+/**
+ * @brief 运行参数
+ */
+struct bench_options_t {
+    std::string filter;             ///< 只运行名称包含该子串的用例
+    double min_time_ms = 50.0;      ///< 单次采样的最短时间
+    size_t repetitions = 5;         ///< 采样次数
+    std::string output;             ///< JSON 输出文件，空时写到标准输出
+    bool list_only = false;         ///< 只列出用例名称
+};
+
+/**
+ * @brief 单个用例的结果
+ */
+struct bench_result_t {
+    std::string name;
+    uint64_t iterations = 0;        ///< 每次采样的迭代次数
+    size_t bytes_per_op = 0;        ///< 每次操作处理的字节数（0 表示不计吞吐量）
+    std::vector<double> ns_per_op;  ///< 每次采样的每次操作耗时
+};
+
+using bench_fn_t = std::function<void(uint64_t iterations)>;
+
+// ============================================================================
+// bench_runner_t - 用例注册与运行
+// ============================================================================
+
+class bench_runner_t {
+public:
+    explicit bench_runner_t(const bench_options_t& options)
+        : m_options(options) {
+    }
+
+    /**
+     * @brief 注册用例
+     * @param name 用例名称（如 "crc16/1024"）
+     * @param bytes_per_op 每次操作处理的字节数
+     * @param fn 执行给定次数操作的函数
+     */
+    void add(const std::string& name, size_t bytes_per_op, bench_fn_t fn) {
+        m_cases.push_back(case_t{name, bytes_per_op, std::move(fn)});
+    }
+
+    /**
+     * @brief 运行所有匹配的用例并输出结果
+     * @return 进程退出码
+     */
+    int run() {
+        if (m_options.list_only) {
+            for (const auto& c : m_cases) {
+                std::cout << c.name << "\n";
+            }
+            return 0;
+        }
+
+        std::vector<bench_result_t> results;
+        for (const auto& c : m_cases) {
+            if (!m_options.filter.empty() && c.name.find(m_options.filter) == std::string::npos) {
+                continue;
+            }
+            results.push_back(_measure(c));
+            const bench_result_t& r = results.back();
+            std::cerr << c.name << ": " << _median(r.ns_per_op) << " ns/op\n";
+        }
+
+        const std::string text = _to_json(results).dump(2);
+        if (m_options.output.empty()) {
+            std::cout << text << "\n";
+            return 0;
+        }
+        FILE* file = std::fopen(m_options.output.c_str(), "w");
+        if (file == nullptr) {
+            std::cerr << "cannot open " << m_options.output << "\n";
+            return 1;
+        }
+        std::fwrite(text.data(), 1, text.size(), file);
+        std::fputc('\n', file);
+        std::fclose(file);
+        return 0;
+    }
+
+private:
+    struct case_t {
+        std::string name;
+        size_t bytes_per_op;
+        bench_fn_t fn;
+    };
+
+    typedef std::chrono::steady_clock bench_clock_t;
+
+    static double _elapsed_ns(const bench_fn_t& fn, uint64_t iterations) {
+        const bench_clock_t::time_point start = bench_clock_t::now();
+        fn(iterations);
+        const bench_clock_t::time_point stop = bench_clock_t::now();
+        return static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+    }
+
+    bench_result_t _measure(const case_t& c) const {
+        const double min_ns = m_options.min_time_ms * 1e6;
+
+        // 预热并标定迭代次数
+        uint64_t iterations = 1;
+        double elapsed = _elapsed_ns(c.fn, iterations);
+        while (elapsed < min_ns && iterations < (uint64_t(1) << 40)) {
+            const double scale = elapsed > 0.0 ? min_ns / elapsed * 1.2 : 10.0;
+            const uint64_t next = static_cast<uint64_t>(static_cast<double>(iterations) *
+                                                        std::min(std::max(scale, 2.0), 100.0));
+            iterations = std::max(next, iterations + 1);
+            elapsed = _elapsed_ns(c.fn, iterations);
+        }
+
+        bench_result_t result;
+        result.name = c.name;
+        result.iterations = iterations;
+        result.bytes_per_op = c.bytes_per_op;
+        for (size_t i = 0; i < m_options.repetitions; ++i) {
+            result.ns_per_op.push_back(_elapsed_ns(c.fn, iterations) /
+                                       static_cast<double>(iterations));
+        }
+        return result;
+    }
+
+    static double _median(std::vector<double> values) {
+        if (values.empty()) {
+            return 0.0;
+        }
+        std::sort(values.begin(), values.end());
+        const size_t mid = values.size() / 2;
+        return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+    }
+
+    nlohmann::json _to_json(const std::vector<bench_result_t>& results) const {
+        char timestamp[32] = {};
+        const std::time_t now = std::time(nullptr);
+        std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        nlohmann::json doc;
+        doc["context"] = {
+            {"timestamp", timestamp},
+#if defined(__VERSION__)
+            {"compiler", __VERSION__},
+#endif
+#if defined(VDL_BENCH_BUILD_TYPE)
+            {"build_type", VDL_BENCH_BUILD_TYPE},
+#endif
+            {"min_time_ms", m_options.min_time_ms},
+            {"repetitions", m_options.repetitions}
+        };
+
+        nlohmann::json list = nlohmann::json::array();
+        for (const auto& r : results) {
+            const double median = _median(r.ns_per_op);
+            nlohmann::json entry = {
+                {"name", r.name},
+                {"iterations", r.iterations},
+                {"ns_per_op", {
+                    {"min", *std::min_element(r.ns_per_op.begin(), r.ns_per_op.end())},
+                    {"median", median},
+                    {"max", *std::max_element(r.ns_per_op.begin(), r.ns_per_op.end())}
+                }}
+            };
+            if (r.bytes_per_op > 0) {
+                entry["bytes_per_op"] = r.bytes_per_op;
+                entry["mb_per_s"] = median > 0.0
+                    ? static_cast<double>(r.bytes_per_op) * 1e3 / median : 0.0;
+            }
+            list.push_back(entry);
+        }
+        doc["benchmarks"] = list;
+        return doc;
+    }
+
+    bench_options_t m_options;
+    std::vector<case_t> m_cases;
+};
+
+/**
+ * @brief 解析命令行
+ * @return 参数无效时返回 false
+ */
+inline bool parse_options(int argc, char** argv, bench_options_t& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--filter" && has_value) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time-ms" && has_value) {
+            options.min_time_ms = std::atof(argv[++i]);
+        } else if (arg == "--repetitions" && has_value) {
+            options.repetitions = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--out" && has_value) {
+            options.output = argv[++i];
+        } else if (arg == "--list") {
+            options.list_only = true;
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--filter <substr>] [--min-time-ms <ms>] [--repetitions <n>]"
+                         " [--out <file.json>] [--list]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace bench
+}  // namespace vdl
+
+#endif  // VDL_BENCH_HARNESS_HPP
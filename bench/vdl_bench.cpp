@@ -0,0 +1,327 @@
+/**
+ * @file vdl_bench.cpp
+ * @brief VDL 基准测试
+ *
+ * 覆盖热点路径：CRC、二进制编解码、环形缓冲区、SCPI 数值解析、错误对象创建，
+ * 以及经过模拟传输层的端到端 execute()/query()。
+ *
+ * 用法：
+ * vdl_bench [--filter codec] [--min-time-ms 50] [--repetitions 5] [--out result.json]
+ */
+
+#include "bench_harness.hpp"
+
+#include <vdl/vdl.hpp>
+#include <vdl/device/scpi_adapter.hpp>
+#include <vdl/transport/mock_transport.hpp>
+#include <vdl/transport/sim_transport.hpp>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using vdl::bench::bench_runner_t;
+using vdl::bench::keep;
+
+namespace {
+
+const size_t k_payload_sizes[] = {16, 256, 4096, 60000};
+const size_t k_trace_points[] = {1000, 10000, 100000};
+
+vdl::bytes_t make_pattern(size_t size) {
+    vdl::bytes_t data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<vdl::byte_t>(i * 31 + 7);
+    }
+    return data;
+}
+
+/**
+ * @brief 生成仪器风格的 ASCII 迹线（科学计数法，逗号分隔）
+ */
+std::string make_trace(size_t values) {
+    std::string text;
+    text.reserve(values * 18);
+    char field[32];
+    for (size_t i = 0; i < values; ++i) {
+        const double v = -45.0 + static_cast<double>(i % 997) * 0.0371;
+        std::snprintf(field, sizeof(field), i == 0 ? "%+.9E" : ",%+.9E", v);
+        text += field;
+    }
+    return text;
+}
+
+// ============================================================================
+// CRC
+// ============================================================================
+
+void add_crc_benches(bench_runner_t& runner) {
+    const size_t sizes[] = {64, 1024, 65536};
+    for (size_t size : sizes) {
+        auto data = std::make_shared<vdl::bytes_t>(make_pattern(size));
+        runner.add("crc16/" + std::to_string(size), size, [data](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                uint16_t crc = vdl::binary_frame::crc16(data->data(), data->size());
+                keep(crc);
+            }
+        });
+    }
+}
+
+// ============================================================================
+// binary_codec_t
+// ============================================================================
+
+void add_codec_benches(bench_runner_t& runner) {
+    for (size_t size : k_payload_sizes) {
+        auto cmd = std::make_shared<vdl::command_t>();
+        cmd->set_function_code(0x03).set_data(make_pattern(size));
+        auto codec = std::make_shared<vdl::binary_codec_t>();
+        auto frame = std::make_shared<vdl::bytes_t>(codec->encode(*cmd).value());
+        auto out = std::make_shared<vdl::bytes_t>(frame->size());
+
+        runner.add("binary_codec/encode_into/" + std::to_string(size), frame->size(),
+                   [cmd, codec, out](uint64_t n) {
+            for (uint64_t i = 0; i < n; ++i) {
+                auto len = codec->encode_into(*cmd, vdl::byte_span_t(out->data(), out->size()));
+                keep(len);
+            }
+        });
+
+        runner.add("binary_codec/decode/" + std::to_string(size), frame->size(),
+                   [codec, frame](uint64_t n) {
+            const vdl::const_byte_span_t view(frame->data(), frame->size());
+            for (uint64_t i = 0; i < n; ++i) {
+                size_t consumed = 0;
+                auto response = codec->decode(view, consumed);
+                keep(response);
+            }
+        });
+
+        runner.add("binary_codec/decode_slice/" + std::to_string(size), frame->size(),
+                   [codec, frame](uint64_t n) {
+            const vdl::byte_slice_t slab{vdl::bytes_t(*frame)};
+            for (uint64_t i = 0; i < n; ++i) {
+                size_t consumed = 0;
+                auto response = codec->decode_slice(slab, consumed);
+                keep(response);
+            }
+        });
+    }
+}
+
+// ============================================================================
+// ring_buffer_t
+// ============================================================================
+
+void add_ring_buffer_benches(bench_runner_t& runner) {
+    const size_t chunks[] = {64, 1024};
+    for (size_t chunk : chunks) {
+        auto data = std::make_shared<vdl::bytes_t>(make_pattern(chunk));
+        runner.add("ring_buffer/write_peek_read/" + std::to_string(chunk), chunk * 2,
+                   [data, chunk](uint64_t n) {
+            vdl::ring_buffer_t ring(4096 + 7);   // 非 2 的幂，覆盖回绕
+            vdl::bytes_t scratch(chunk);
+            for (uint64_t i = 0; i < n; ++i) {
+                ring.write(data->data(), chunk);
+                keep(ring.peek(scratch.data(), chunk));
+                keep(ring.read(scratch.data(), chunk));
+            }
+        });
+
+        runner.add("ring_buffer/write_span_linearize/" + std::to_string(chunk), chunk,
+                   [data, chunk](uint64_t n) {
+            vdl::ring_buffer_t ring(4096 + 7);
+            for (uint64_t i = 0; i < n; ++i) {
+                vdl::byte_span_t space = ring.write_span();
+                const size_t len = std::min(space.size(), chunk);
+                std::memcpy(space.data(), data->data(), len);
+                ring.commit_write(len);
+                vdl::const_byte_span_t view = ring.linearize();
+                keep(view);
+                ring.consume(view.size());
+            }
+        });
+    }
+}
+
+// ============================================================================
+// SCPI 数值解析
+// ============================================================================
+
+void add_parser_benches(bench_runner_t& runner) {
+    for (size_t points : k_trace_points) {
+        auto trace = std::make_shared<std::string>(make_trace(points));
+        runner.add("parse_data_doubles/" + std::to_string(points), trace->size(),
+                   [trace](uint64_t n) {
+            std::vector<double> values;
+            for (uint64_t i = 0; i < n; ++i) {
+                values.clear();
+                auto count = vdl::scpi_adapter_t::parse_data_doubles(*trace, values);
+                keep(count);
+            }
+        });
+
+        auto complex_trace = std::make_shared<std::string>(make_trace(points * 2));
+        runner.add("parse_complex_data/" + std::to_string(points), complex_trace->size(),
+                   [complex_trace](uint64_t n) {
+            std::vector<double> real;
+            std::vector<double> imag;
+            for (uint64_t i = 0; i < n; ++i) {
+                real.clear();
+                imag.clear();
+                auto count = vdl::scpi_adapter_t::parse_complex_data(*complex_trace, real, imag);
+                keep(count);
+            }
+        });
+    }
+}
+
+// ============================================================================
+// error_t
+// ============================================================================
+
+void add_error_benches(bench_runner_t& runner) {
+    runner.add("error/code_only", 0, [](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            auto result = vdl::make_error<int>(vdl::error_code_t::timeout);
+            keep(result);
+        }
+    });
+
+    runner.add("error/static_message", 0, [](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            auto result = vdl::make_error<int>(vdl::error_code_t::timeout, "Read timeout");
+            keep(result);
+        }
+    });
+
+    runner.add("error/string_message", 0, [](uint64_t n) {
+        const std::string message = "Device reported error -113, \"Undefined header\"";
+        for (uint64_t i = 0; i < n; ++i) {
+            auto result = vdl::make_error<int>(vdl::error_code_t::device_error, message);
+            keep(result);
+        }
+    });
+}
+
+// ============================================================================
+// 端到端
+// ============================================================================
+
+/**
+ * @brief 回声应答（二进制帧）
+ */
+vdl::sim_responder_t make_echo_responder() {
+    return vdl::make_codec_responder(
+        std::make_shared<vdl::binary_codec_t>(),
+        [](const vdl::response_t& request) -> vdl::optional_t<vdl::command_t> {
+            vdl::command_t reply;
+            reply.set_function_code(request.function_code()).set_data(request.data());
+            return reply;
+        });
+}
+
+/**
+ * @brief 逐行应答（SCPI 文本）
+ */
+vdl::sim_responder_t make_line_responder(const std::string& reply_text) {
+    return [reply_text](vdl::const_byte_span_t request, vdl::bytes_t& reply) -> size_t {
+        const void* hit = std::memchr(request.data(), '\n', request.size());
+        if (hit == nullptr) {
+            return 0;
+        }
+        reply.insert(reply.end(), reply_text.begin(), reply_text.end());
+        return static_cast<size_t>(static_cast<const vdl::byte_t*>(hit) - request.data()) + 1;
+    };
+}
+
+void add_device_benches(bench_runner_t& runner) {
+    // mock_transport_t：不含链路延迟，只测库自身开销
+    runner.add("device/execute/mock/16", 0, [](uint64_t n) {
+        auto transport = vdl::make_unique<vdl::mock_transport_t>();
+        auto* mock = transport.get();
+        vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+        device.connect();
+
+        vdl::command_t cmd;
+        cmd.set_function_code(0x03).set_data(make_pattern(16));
+        vdl::binary_codec_t codec;
+        const vdl::bytes_t reply = codec.encode(cmd).value();
+        for (uint64_t i = 0; i < n; ++i) {
+            mock->set_response(reply);
+            auto response = device.execute(cmd);
+            keep(response);
+        }
+    });
+
+    runner.add("device/query/mock", 0, [](uint64_t n) {
+        auto transport = vdl::make_unique<vdl::mock_transport_t>();
+        auto* mock = transport.get();
+        vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+        device.connect();
+
+        const std::string text = "+1.234567890E+09\n";
+        const vdl::bytes_t reply(text.begin(), text.end());
+        for (uint64_t i = 0; i < n; ++i) {
+            mock->set_response(reply);
+            auto response = device.query("SENS:FREQ:CENT?");
+            keep(response);
+        }
+    });
+
+    // sim_transport_t：单向 50 us 延迟、100 MB/s 链路
+    vdl::sim_link_config_t link;
+    link.latency_us = 50;
+    link.bandwidth_bps = 100000000;
+
+    const size_t sizes[] = {16, 4096};
+    for (size_t size : sizes) {
+        runner.add("device/execute/sim_50us/" + std::to_string(size), size, [link, size](uint64_t n) {
+            auto transport = vdl::make_unique<vdl::sim_transport_t>(link);
+            transport->set_responder(make_echo_responder());
+            vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+            device.connect();
+
+            vdl::command_t cmd;
+            cmd.set_function_code(0x03).set_data(make_pattern(size));
+            for (uint64_t i = 0; i < n; ++i) {
+                auto response = device.execute(cmd);
+                keep(response);
+            }
+        });
+    }
+
+    runner.add("device/query/sim_50us", 0, [link](uint64_t n) {
+        auto transport = vdl::make_unique<vdl::sim_transport_t>(link);
+        transport->set_responder(make_line_responder("+1.234567890E+09\n"));
+        vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+        device.connect();
+
+        for (uint64_t i = 0; i < n; ++i) {
+            auto response = device.query("SENS:FREQ:CENT?");
+            keep(response);
+        }
+    });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    vdl::bench::bench_options_t options;
+    if (!vdl::bench::parse_options(argc, argv, options)) {
+        return 2;
+    }
+
+    vdl::set_log_level(vdl::log_level_t::warn);
+
+    bench_runner_t runner(options);
+    add_crc_benches(runner);
+    add_codec_benches(runner);
+    add_ring_buffer_benches(runner);
+    add_parser_benches(runner);
+    add_error_benches(runner);
+    add_device_benches(runner);
+    return runner.run();
+}
@@ -35,7 +35,18 @@ if(NOT TARGET Catch2::Catch2)
     add_library(Catch2::Catch2 ALIAS Catch2)
 endif()
 
+# ============================================================================
+# nlohmann_json (仅基准测试使用)
+# ============================================================================
+
+if(NOT TARGET nlohmann_json::nlohmann_json)
+    add_library(nlohmann_json INTERFACE)
+    target_include_directories(nlohmann_json SYSTEM INTERFACE ${THIRD_PARTY_DIR}/nlohmann_json)
+    add_library(nlohmann_json::nlohmann_json ALIAS nlohmann_json)
+endif()
+
 message(STATUS "Third-party libraries configured:")
 message(STATUS "  - tl::expected")
 message(STATUS "  - tl::optional")
 message(STATUS "  - Catch2::Catch2")
+message(STATUS "  - nlohmann_json::nlohmann_json")
@@ -14,317 +14,12 @@
  */
 
 #include <vdl/vdl.hpp>
+#include <vdl/transport/tcp_transport.hpp>
 #include <iostream>
 #include <string>
 #include <cstring>
 #include <sstream>
 
-#ifdef _WIN32
-    #include <winsock2.h>
-    #include <ws2tcpip.h>
-    #ifdef _MSC_VER
-        #pragma comment(lib, "ws2_32.lib")
-    #endif
-    typedef int socklen_t;
-#else
-    #include <sys/socket.h>
-    #include <netinet/in.h>
-    #include <arpa/inet.h>
-    #include <unistd.h>
-    #include <fcntl.h>
-    #include <sys/select.h>
-    #define INVALID_SOCKET -1
-    #define SOCKET_ERROR -1
-    typedef int SOCKET;
-#endif
-
-namespace vdl {
-
-// ============================================================================
-// TCP 传输层实现
-// ============================================================================
-
-/**
- * @brief TCP 传输层
- * 
- * 用于基于 TCP/IP 的设备通信（如以太网 VNA）
- */
-class tcp_transport_t : public transport_base_t {
-public:
-    /**
-     * @brief 构造函数
-     * @param host 主机地址（IP 或主机名）
-     * @param port 端口号
-     */
-    tcp_transport_t(const std::string& host, uint16_t port)
-        : m_host(host), m_port(port), m_socket(INVALID_SOCKET) {
-#ifdef _WIN32
-        // Windows 需要初始化 Winsock
-        WSADATA wsa_data;
-        WSAStartup(MAKEWORD(2, 2), &wsa_data);
-#endif
-    }
-
-    ~tcp_transport_t() {
-        close();
-#ifdef _WIN32
-        WSACleanup();
-#endif
-    }
-
-    // ========================================================================
-    // 连接管理
-    // ========================================================================
-
-    result_t<void> open() override {
-        if (is_open()) {
-            return make_ok();
-        }
-
-        // 创建 socket
-        m_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-        if (m_socket == INVALID_SOCKET) {
-            return make_error_void(error_code_t::communication_error, "Failed to create socket");
-        }
-
-        // 设置地址
-        struct sockaddr_in server_addr;
-        memset(&server_addr, 0, sizeof(server_addr));
-        server_addr.sin_family = AF_INET;
-        server_addr.sin_port = htons(m_port);
-        
-#ifdef _WIN32
-        server_addr.sin_addr.s_addr = inet_addr(m_host.c_str());
-#else
-        if (inet_pton(AF_INET, m_host.c_str(), &server_addr.sin_addr) <= 0) {
-            close();
-            return make_error_void(error_code_t::address_invalid, "Invalid IP address");
-        }
-#endif
-
-        // 连接
-        if (connect(m_socket, (struct sockaddr*)&server_addr, sizeof(server_addr)) == SOCKET_ERROR) {
-            close();
-            return make_error_void(error_code_t::connection_failed, "Failed to connect to device");
-        }
-
-        return make_ok();
-    }
-
-    void close() override {
-        if (m_socket != INVALID_SOCKET) {
-#ifdef _WIN32
-            closesocket(m_socket);
-#else
-            ::close(m_socket);
-#endif
-            m_socket = INVALID_SOCKET;
-        }
-    }
-
-    bool is_open() const override {
-        return m_socket != INVALID_SOCKET;
-    }
-
-    // ========================================================================
-    // 读写操作
-    // ========================================================================
-
-    result_t<size_t> read(byte_span_t buffer, milliseconds_t timeout_ms = 0) override {
-        if (!is_open()) {
-            return make_error<size_t>(error_code_t::not_connected);
-        }
-
-        // 设置超时
-        if (timeout_ms == 0) {
-            timeout_ms = m_config.read_timeout;
-        }
-
-        // 使用 select 实现超时
-        fd_set read_fds;
-        FD_ZERO(&read_fds);
-        FD_SET(m_socket, &read_fds);
-
-        struct timeval tv;
-        tv.tv_sec = static_cast<long>(timeout_ms / 1000);
-        tv.tv_usec = static_cast<long>((timeout_ms % 1000) * 1000);
-
-#ifdef _WIN32
-        int ret = select(0, &read_fds, NULL, NULL, &tv);  // Windows 忽略第一个参数
-#else
-        int ret = select(m_socket + 1, &read_fds, NULL, NULL, &tv);  // Linux/Unix
-#endif
-        if (ret == 0) {
-            return make_error<size_t>(error_code_t::timeout);
-        } else if (ret < 0) {
-            return make_error<size_t>(error_code_t::io_error);
-        }
-
-        // 读取数据
-#ifdef _WIN32
-        ssize_t n = recv(m_socket, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0);
-#else
-        ssize_t n = recv(m_socket, reinterpret_cast<char*>(buffer.data()), buffer.size(), 0);
-#endif
-        if (n < 0) {
-            return make_error<size_t>(error_code_t::io_error);
-        } else if (n == 0) {
-            return make_error<size_t>(error_code_t::connection_closed);
-        }
-
-        return make_ok<size_t>(static_cast<size_t>(n));
-    }
-
-    result_t<size_t> write(const_byte_span_t data, milliseconds_t timeout_ms = 0) override {
-        (void)timeout_ms;  // 暂时未使用
-        if (!is_open()) {
-            return make_error<size_t>(error_code_t::not_connected);
-        }
-
-#ifdef _WIN32
-        ssize_t n = send(m_socket, reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size()), 0);
-#else
-        ssize_t n = send(m_socket, reinterpret_cast<const char*>(data.data()), data.size(), 0);
-#endif
-        if (n < 0) {
-            return make_error<size_t>(error_code_t::io_error);
-        }
-
-        return make_ok<size_t>(static_cast<size_t>(n));
-    }
-
-    const char* type_name() const override {
-        return "TCP";
-    }
-
-private:
-    std::string m_host;
-    uint16_t m_port;
-    SOCKET m_socket;
-};
-
-// ============================================================================
-// SCPI 编解码器实现
-// ============================================================================
-
-/**
- * @brief SCPI 编解码器
- * 
- * SCPI 协议特点：
- * - 基于文本的命令
- * - 命令以换行符结束（\n）
- * - 响应以换行符结束（\n）
- * - 支持查询命令（以 ? 结尾）
- */
-class scpi_codec_t : public codec_base_t {
-public:
-    scpi_codec_t() = default;
-
-    // ========================================================================
-    // 编码
-    // ========================================================================
-
-    /**
-     * @brief 编码 SCPI 命令
-     * 
-     * 对于 SCPI，我们使用 command_t 的 data 字段存储命令字符串
-     */
-    result_t<bytes_t> encode(const command_t& cmd) override {
-        bytes_t result;
-        
-        // 获取命令字符串
-        const bytes_t& cmd_data = cmd.data();
-        
-        // 复制命令数据
-        result.insert(result.end(), cmd_data.begin(), cmd_data.end());
-        
-        // SCPI 命令以换行符结束
-        result.push_back('\n');
-        
-        return make_ok(std::move(result));
-    }
-
-    // ========================================================================
-    // 解码
-    // ========================================================================
-
-    /**
-     * @brief 解码 SCPI 响应
-     * 
-     * SCPI 响应以换行符结束
-     */
-    result_t<response_t> decode(const_byte_span_t buffer, size_t& consumed) override {
-        // 查找换行符
-        size_t frame_len = frame_length(buffer);
-        
-        if (frame_len == 0) {
-            // 数据不完整
-            return make_error<response_t>(error_code_t::incomplete_frame);
-        }
-        
-        // 创建响应对象
-        response_t response;
-        response.set_status(response_status_t::success);
-        
-        // 提取响应数据（去除换行符）
-        bytes_t data;
-        for (size_t i = 0; i < frame_len - 1; ++i) {
-            if (buffer[i] == '\r') continue;  // 跳过回车符
-            data.push_back(buffer[i]);
-        }
-        
-        response.set_data(std::move(data));
-        
-        // 设置消耗的字节数
-        consumed = frame_len;
-        
-        return make_ok(std::move(response));
-    }
-
-    /**
-     * @brief 检查是否有完整的 SCPI 帧
-     * 
-     * SCPI 帧以换行符结束
-     */
-    size_t frame_length(const_byte_span_t buffer) const override {
-        for (size_t i = 0; i < buffer.size(); ++i) {
-            if (buffer[i] == '\n') {
-                return i + 1;
-            }
-        }
-        return 0;  // 没有找到完整帧
-    }
-
-    const char* name() const override {
-        return "SCPI";
-    }
-};
-
-// ============================================================================
-// SCPI 命令辅助函数
-// ============================================================================
-
-/**
- * @brief 创建 SCPI 命令
- * @param scpi_string SCPI 命令字符串
- */
-inline command_t make_scpi_command(const std::string& scpi_string) {
-    command_t cmd;
-    bytes_t data(scpi_string.begin(), scpi_string.end());
-    cmd.set_data(std::move(data));
-    return cmd;
-}
-
-/**
- * @brief 从响应中提取字符串
- */
-inline std::string get_response_string(const response_t& response) {
-    const bytes_t& data = response.data();
-    return std::string(data.begin(), data.end());
-}
-
-}  // namespace vdl
-
 // ============================================================================
 // 使用示例
 // ============================================================================
@@ -344,7 +39,7 @@ void example_vna_identification(const std::string& host, uint16_t port) {
         new tcp_transport_t(host, port)
     );
     auto codec = std::unique_ptr<i_codec_t>(
-        new scpi_codec_t()
+        new ascii_codec_t()
     );
 
     // 创建设备对象
@@ -382,7 +77,7 @@ void example_vna_frequency_control(const std::string& host, uint16_t port) {
     std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
 
     auto transport = std::unique_ptr<i_transport_t>(new tcp_transport_t(host, port));
-    auto codec = std::unique_ptr<i_codec_t>(new scpi_codec_t());
+    auto codec = std::unique_ptr<i_codec_t>(new ascii_codec_t());
     device_impl_t device(std::move(transport), std::move(codec));
 
     if (!device.connect().has_value()) {
@@ -431,7 +126,7 @@ void example_vna_sweep_config(const std::string& host, uint16_t port) {
     std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
 
     auto transport = std::unique_ptr<i_transport_t>(new tcp_transport_t(host, port));
-    auto codec = std::unique_ptr<i_codec_t>(new scpi_codec_t());
+    auto codec = std::unique_ptr<i_codec_t>(new ascii_codec_t());
     device_impl_t device(std::move(transport), std::move(codec));
 
     if (!device.connect().has_value()) {
@@ -482,7 +177,7 @@ void example_vna_s_parameters(const std::string& host, uint16_t port) {
     std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
 
     auto transport = std::unique_ptr<i_transport_t>(new tcp_transport_t(host, port));
-    auto codec = std::unique_ptr<i_codec_t>(new scpi_codec_t());
+    auto codec = std::unique_ptr<i_codec_t>(new ascii_codec_t());
     device_impl_t device(std::move(transport), std::move(codec));
 
     if (!device.connect().has_value()) {
@@ -537,7 +232,7 @@ void example_vna_error_checking(const std::string& host, uint16_t port) {
     std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
 
     auto transport = std::unique_ptr<i_transport_t>(new tcp_transport_t(host, port));
-    auto codec = std::unique_ptr<i_codec_t>(new scpi_codec_t());
+    auto codec = std::unique_ptr<i_codec_t>(new ascii_codec_t());
     device_impl_t device(std::move(transport), std::move(codec));
 
     if (!device.connect().has_value()) {
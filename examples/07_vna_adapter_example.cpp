@@ -85,7 +85,7 @@ void example_architecture() {
     std::cout << "      +-- device_impl_t\n";
     std::cout << "      |   \\__ Transport + Codec 组合\n";
     std::cout << "      |       |        |\n";
-    std::cout << "      +-- tcp_transport_t  scpi_codec_t\n";
+    std::cout << "      +-- tcp_transport_t  ascii_codec_t\n";
     std::cout << "          \\__ 具体实现\n\n";
 }
 
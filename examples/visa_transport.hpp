@@ -20,6 +20,8 @@
 
 #include <vdl/transport/transport.hpp>
 #include <string>
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <iostream>
 
@@ -30,14 +32,20 @@
 
 // VISA 类型定义
 typedef unsigned int ViUInt32;
+typedef unsigned short ViUInt16;
 typedef int ViInt32;
 typedef unsigned char ViByte;
 typedef void* ViSession;
 typedef int ViStatus;
+typedef ViUInt32 ViEventType;
+typedef ViSession ViEvent;
+typedef ViUInt32 ViJobId;
+typedef ViUInt32 ViAttr;
 
 // VISA 常量
 const ViSession VI_NULL = 0;
 const ViStatus VI_SUCCESS = 0;
+const ViStatus VI_SUCCESS_MAX_CNT = 0x3FFF0006;
 const ViStatus VI_ERROR_TMO = -1073807339;
 const ViStatus VI_ERROR_CONN_LOST = -1073807234;
 const ViStatus VI_ERROR_TIMEOUT = -1073807339;
@@ -46,6 +54,16 @@ const ViStatus VI_ERROR_INV_RSRC = -1073807301;
 
 const ViInt32 VI_ATTR_TMO_VALUE = 1073676312;
 
+const ViEventType VI_EVENT_SERVICE_REQ = 0x3FFF200B;
+const ViUInt16 VI_QUEUE = 1;
+
+const ViEventType VI_EVENT_IO_COMPLETION = 0x3FFF2009;
+const ViAttr VI_ATTR_STATUS = 0x3FFF4025;
+const ViAttr VI_ATTR_RET_COUNT = 0x3FFF4026;
+
+const ViUInt16 VI_READ_BUF = 1;
+const ViUInt16 VI_WRITE_BUF = 2;
+
 // 模拟的 VISA 函数声明
 // 在实际使用中，这些应该来自真实的 VISA 库
 extern "C" {
@@ -61,6 +79,15 @@ extern "C" {
     ViStatus viSetAttribute(ViSession vi, ViInt32 attr, 
                             ViUInt32 attr_state);
     ViStatus viClear(ViSession vi);
+    ViStatus viEnableEvent(ViSession vi, ViEventType event_type,
+                           ViUInt16 mechanism, ViUInt32 context);
+    ViStatus viWaitOnEvent(ViSession vi, ViEventType in_event_type,
+                           ViUInt32 timeout, ViEventType* out_event_type,
+                           ViEvent* out_context);
+    ViStatus viReadSTB(ViSession vi, ViUInt16* status);
+    ViStatus viSetBuf(ViSession vi, ViUInt16 mask, ViUInt32 size);
+    ViStatus viReadAsync(ViSession vi, ViByte* buf, ViUInt32 count, ViJobId* job_id);
+    ViStatus viGetAttribute(ViSession vi, ViAttr attr, void* attr_state);
 }
 
 // ============================================================================
@@ -93,6 +120,13 @@ public:
     virtual ~visa_transport_t();
 
     // Transport 接口实现
+
+    /**
+     * @brief 打开会话
+     *
+     * 打开后调用 _apply_buffer_sizes()，按 config() 中的
+     * read_buffer_size / write_buffer_size 设置 VISA 格式化 I/O 缓冲区。
+     */
     vdl::result_t<void> open() override;
     void close() override;
     
@@ -106,15 +140,59 @@ public:
         vdl::milliseconds_t timeout_ms = 0
     ) override;
 
+    /**
+     * @brief 读取数据
+     *
+     * 同步模式下直接 viRead 到调用者的缓冲区（设备层传入的是接收缓冲区
+     * 或二进制块的目标内存，一次可读取整段）；异步模式下转到 _read_async()。
+     */
     vdl::result_t<size_t> read(
         vdl::byte_span_t buffer,
         vdl::milliseconds_t timeout_ms = 0
     ) override;
 
+    /**
+     * @brief 更新配置；会话已打开时立即重新设置缓冲区大小
+     */
+    void set_config(const vdl::transport_config_t& config) override {
+        vdl::transport_base_t::set_config(config);
+        if (m_is_open) {
+            (void)_apply_buffer_sizes();
+        }
+    }
+
+    /**
+     * @brief 启用异步预读（viReadAsync + viWaitOnEvent）
+     *
+     * 一次读满 read_buffer_size 字节的暂存区后，立即为下一块发起
+     * viReadAsync，调用者解析当前块时仪器数据继续流入，读写重叠。
+     * 只有上一块读满（VI_SUCCESS_MAX_CNT，说明消息未结束）时才预读，
+     * 不会在消息之间挂起读操作。
+     */
+    void set_async_read(bool enable) {
+        m_async_read = enable;
+    }
+
+    bool async_read() const {
+        return m_async_read;
+    }
+
     bool is_open() const override;
 
     const char* type_name() const override;
 
+    /**
+     * @brief 等待 VISA 服务请求事件（viEnableEvent + viWaitOnEvent）
+     *
+     * 首次调用时以队列方式启用 VI_EVENT_SERVICE_REQ。
+     */
+    vdl::result_t<void> wait_service_request(vdl::milliseconds_t timeout_ms) override;
+
+    /**
+     * @brief 串行轮询读取状态字节（viReadSTB）
+     */
+    vdl::result_t<uint8_t> read_status_byte() override;
+
     // VISA 特定方法
     
     /**
@@ -152,6 +230,20 @@ private:
     std::string m_resource_string;
     uint32_t m_timeout_ms = 2000;
     bool m_is_open = false;
+    bool m_srq_enabled = false;     ///< 是否已启用 SRQ 事件队列
+
+    // 异步预读状态
+    bool m_async_read = false;
+    bool m_io_event_enabled = false;
+    bool m_read_pending = false;    ///< 是否有进行中的 viReadAsync（写入 m_next）
+    vdl::bytes_t m_stage;           ///< 已完成、待交给调用者的数据
+    vdl::bytes_t m_next;            ///< 预读目标
+    size_t m_stage_pos = 0;
+    size_t m_stage_end = 0;
+
+    vdl::result_t<void> _apply_buffer_sizes();
+    vdl::result_t<void> _start_async_read();
+    vdl::result_t<size_t> _read_async(vdl::byte_span_t buffer, vdl::milliseconds_t timeout_ms);
 
     // 辅助方法
     std::string visa_error_to_string(ViStatus status) const;
@@ -162,10 +254,165 @@ private:
     vdl::result_t<std::string> query(const std::string& command) const;
 };
 
+// ============================================================================
+// 服务请求
+// ============================================================================
+
+inline vdl::result_t<void> visa_transport_t::wait_service_request(
+    vdl::milliseconds_t timeout_ms) {
+    if (!m_is_open) {
+        return vdl::make_error_void(vdl::error_code_t::not_connected,
+                                    "VISA session not open");
+    }
+
+    if (!m_srq_enabled) {
+        ViStatus status = viEnableEvent(m_instrument, VI_EVENT_SERVICE_REQ, VI_QUEUE, 0);
+        if (status < VI_SUCCESS) {
+            return vdl::make_error_void(vdl::error_code_t::not_supported,
+                                        visa_error_to_string(status));
+        }
+        m_srq_enabled = true;
+    }
+
+    ViEventType event_type = 0;
+    ViEvent event = VI_NULL;
+    ViStatus status = viWaitOnEvent(m_instrument, VI_EVENT_SERVICE_REQ,
+                                    static_cast<ViUInt32>(timeout_ms), &event_type, &event);
+    if (status == VI_ERROR_TMO) {
+        return vdl::make_error_void(vdl::error_code_t::timeout, "SRQ wait timeout");
+    }
+    if (status < VI_SUCCESS) {
+        return vdl::make_error_void(vdl::error_code_t::read_failed,
+                                    visa_error_to_string(status));
+    }
+    viClose(event);
+    return vdl::make_ok();
+}
+
+inline vdl::result_t<uint8_t> visa_transport_t::read_status_byte() {
+    ViUInt16 stb = 0;
+    ViStatus status = viReadSTB(m_instrument, &stb);
+    if (status < VI_SUCCESS) {
+        return vdl::make_error<uint8_t>(vdl::error_code_t::read_failed,
+                                        visa_error_to_string(status));
+    }
+    return static_cast<uint8_t>(stb & 0xFF);
+}
+
+// ============================================================================
+// 缓冲区与异步读取
+// ============================================================================
+
+inline vdl::result_t<void> visa_transport_t::_apply_buffer_sizes() {
+    const auto& config = this->config();
+    if (config.read_buffer_size > 0) {
+        ViStatus status = viSetBuf(m_instrument, VI_READ_BUF,
+                                   static_cast<ViUInt32>(config.read_buffer_size));
+        if (status < VI_SUCCESS) {
+            return vdl::make_error_void(vdl::error_code_t::invalid_argument,
+                                        visa_error_to_string(status));
+        }
+    }
+    if (config.write_buffer_size > 0) {
+        ViStatus status = viSetBuf(m_instrument, VI_WRITE_BUF,
+                                   static_cast<ViUInt32>(config.write_buffer_size));
+        if (status < VI_SUCCESS) {
+            return vdl::make_error_void(vdl::error_code_t::invalid_argument,
+                                        visa_error_to_string(status));
+        }
+    }
+    return vdl::make_ok();
+}
+
+inline vdl::result_t<void> visa_transport_t::_start_async_read() {
+    if (!m_io_event_enabled) {
+        ViStatus status = viEnableEvent(m_instrument, VI_EVENT_IO_COMPLETION, VI_QUEUE, 0);
+        if (status < VI_SUCCESS) {
+            return vdl::make_error_void(vdl::error_code_t::not_supported,
+                                        visa_error_to_string(status));
+        }
+        m_io_event_enabled = true;
+    }
+
+    const size_t chunk = std::max<size_t>(config().read_buffer_size, 1);
+    if (m_next.size() != chunk) {
+        m_next.resize(chunk);
+    }
+
+    ViJobId job = 0;
+    ViStatus status = viReadAsync(m_instrument, m_next.data(),
+                                  static_cast<ViUInt32>(chunk), &job);
+    if (status < VI_SUCCESS) {
+        return vdl::make_error_void(vdl::error_code_t::read_failed,
+                                    visa_error_to_string(status));
+    }
+    m_read_pending = true;
+    return vdl::make_ok();
+}
+
+inline vdl::result_t<size_t> visa_transport_t::_read_async(
+    vdl::byte_span_t buffer, vdl::milliseconds_t timeout_ms) {
+    if (m_stage_pos == m_stage_end) {
+        if (!m_read_pending) {
+            auto started = _start_async_read();
+            if (!started) {
+                return vdl::make_unexpected(started.error());
+            }
+        }
+
+        ViEventType event_type = 0;
+        ViEvent event = VI_NULL;
+        ViStatus status = viWaitOnEvent(m_instrument, VI_EVENT_IO_COMPLETION,
+                                        static_cast<ViUInt32>(timeout_ms ? timeout_ms : m_timeout_ms),
+                                        &event_type, &event);
+        if (status == VI_ERROR_TMO) {
+            return vdl::make_error<size_t>(vdl::error_code_t::timeout, "VISA read timeout");
+        }
+        if (status < VI_SUCCESS) {
+            return vdl::make_error<size_t>(vdl::error_code_t::read_failed,
+                                           visa_error_to_string(status));
+        }
+
+        ViStatus io_status = VI_SUCCESS;
+        ViUInt32 count = 0;
+        viGetAttribute(event, VI_ATTR_STATUS, &io_status);
+        viGetAttribute(event, VI_ATTR_RET_COUNT, &count);
+        viClose(event);
+        m_read_pending = false;
+
+        if (io_status < VI_SUCCESS && io_status != VI_ERROR_TMO) {
+            return vdl::make_error<size_t>(vdl::error_code_t::read_failed,
+                                           visa_error_to_string(io_status));
+        }
+
+        m_stage.swap(m_next);
+        m_stage_pos = 0;
+        m_stage_end = count;
+
+        // 暂存区读满说明消息还有后续数据：立即预读下一块
+        if (io_status == VI_SUCCESS_MAX_CNT) {
+            (void)_start_async_read();
+        }
+        if (count == 0) {
+            return vdl::make_error<size_t>(vdl::error_code_t::timeout, "VISA read timeout");
+        }
+    }
+
+    const size_t n = std::min(buffer.size(), m_stage_end - m_stage_pos);
+    std::memcpy(buffer.data(), m_stage.data() + m_stage_pos, n);
+    m_stage_pos += n;
+    return n;
+}
+
 // ============================================================================
 // VISA 配置辅助类
 // ============================================================================
 
+/**
+ * @brief make_visa_transport() 使用的默认 VISA 缓冲区大小
+ */
+constexpr size_t k_visa_default_buffer_size = 64 * 1024;
+
 /**
  * @class visa_config_builder_t
  * @brief 帮助构建 VISA 资源字符串
@@ -233,7 +480,14 @@ inline std::unique_ptr<visa_transport_t> make_visa_transport(
     const std::string& resource_string,
     uint32_t timeout_ms = 2000
 ) {
-    return std::make_unique<visa_transport_t>(resource_string, timeout_ms);
+    auto transport = vdl::make_unique<visa_transport_t>(resource_string, timeout_ms);
+
+    // 大块读写：1.6 MB 的迹线只需几十次 viRead
+    vdl::transport_config_t config = transport->config();
+    config.read_buffer_size = k_visa_default_buffer_size;
+    config.write_buffer_size = k_visa_default_buffer_size;
+    transport->set_config(config);
+    return transport;
 }
 
 #endif // VISA_TRANSPORT_HPP
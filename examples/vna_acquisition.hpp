@@ -0,0 +1,402 @@
+/**
+ * @file vna_acquisition.hpp
+ * @brief VNA 连续采集流水线 - 示例实现
+ *
+ * 单次 trigger_sweep() + get_complex_data_parsed() 严格串行：
+ * 仪器扫描时主机空等，主机传输和解析时仪器空闲。
+ * 连续采集把两者重叠起来：读完第 N 次扫描的数据后立即触发第 N+1 次，
+ * 第 N 次的数据在工作线程上解析到两个预分配迹线缓冲区之一。
+ * 解析和传输耗时与扫描耗时相当时，每秒扫描次数约提高一倍。
+ */
+
+#ifndef VNA_ACQUISITION_HPP
+#define VNA_ACQUISITION_HPP
+
+#include "vna_adapter.hpp"
+#include <vdl/core/noncopyable.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vdl {
+
+// ============================================================================
+// 迹线与统计
+// ============================================================================
+
+/**
+ * @brief 一次扫描的复数迹线
+ */
+struct vna_trace_t {
+    uint64_t sequence = 0;                          ///< 扫描序号（从 0 开始）
+    std::vector<double> real;                       ///< 实部
+    std::vector<double> imag;                       ///< 虚部
+    std::chrono::steady_clock::time_point fetched;  ///< 数据读取完成的时间
+};
+
+/**
+ * @brief 迹线回调（在解析线程上执行，返回后缓冲区被复用）
+ */
+using vna_trace_callback_t = std::function<void(const vna_trace_t& trace)>;
+
+/**
+ * @brief 采集统计
+ */
+struct vna_acquisition_stats_t {
+    uint64_t sweeps = 0;        ///< 已读取的扫描数
+    uint64_t traces = 0;        ///< 已解析的迹线数
+    uint64_t stalls = 0;        ///< 两个缓冲区都被占用、采集线程等待消费者的次数
+    int64_t sweep_us = 0;       ///< 最近一次等待扫描完成的耗时
+    int64_t fetch_us = 0;       ///< 最近一次读取数据的耗时
+    int64_t parse_us = 0;       ///< 最近一次解析的耗时
+};
+
+// ============================================================================
+// vna_acquisition_t - 连续采集
+// ============================================================================
+
+/**
+ * @brief 双缓冲的连续扫描采集
+ *
+ * 采集线程：等待扫描完成 → 读取数据 → 立即触发下一次扫描 → 交给解析线程；
+ * 解析线程：把文本解析到该次扫描对应的迹线缓冲区，交给回调或 pop()。
+ * 两个缓冲区都未被消费时采集线程等待，不会丢弃迹线。
+ *
+ * @code
+ * vna_acquisition_t acquisition(vna, 401);
+ * acquisition.set_callback([](const vna_trace_t& trace) {
+ *     process(trace.sequence, trace.real, trace.imag);
+ * });
+ * acquisition.start(5000, 100);   // 100 次扫描，每次最多等 5 s
+ * acquisition.wait();
+ *
+ * // 或者不设回调，由消费者拉取（交换缓冲区，不复制数据）
+ * vna_trace_t trace;
+ * acquisition.start(5000);
+ * while (acquisition.pop(trace, 10000)) { ... }
+ * @endcode
+ *
+ * @note 采集期间不要通过同一个适配器发送其他命令；
+ *       仪器应处于单次扫描模式（disable_continuous_sweep()），数据格式为 ASCII
+ */
+class vna_acquisition_t : private noncopyable_t, private nonmovable_t {
+public:
+    /**
+     * @brief 构造函数
+     * @param vna 适配器（必须比采集对象活得久）
+     * @param points 扫描点数，用于预留迹线缓冲区
+     */
+    explicit vna_acquisition_t(vna_adapter_t& vna, size_t points = 0)
+        : m_vna(vna) {
+        for (auto& slot : m_slots) {
+            slot.trace.real.reserve(points);
+            slot.trace.imag.reserve(points);
+        }
+    }
+
+    ~vna_acquisition_t() {
+        stop();
+    }
+
+    /**
+     * @brief 设置迹线回调（start() 之前调用；未设置时迹线由 pop() 取走）
+     */
+    void set_callback(vna_trace_callback_t callback) {
+        m_callback = std::move(callback);
+    }
+
+    /**
+     * @brief 开始连续采集
+     * @param sweep_timeout_ms 单次扫描的等待超时
+     * @param max_sweeps 扫描次数（0 表示直到 stop()）
+     */
+    result_t<void> start(milliseconds_t sweep_timeout_ms, uint64_t max_sweeps = 0) {
+        if (m_acquire_thread.joinable() || m_parse_thread.joinable()) {
+            return make_error_void(error_code_t::invalid_state, "Acquisition already started");
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& slot : m_slots) {
+                slot.state = slot_state_t::free;
+            }
+            m_status = make_ok();
+            m_stats = vna_acquisition_stats_t();
+            m_stop = false;
+            m_acquiring = true;
+            m_parsing = true;
+            m_pop_sequence = 0;
+        }
+        m_acquire_thread = std::thread([this, sweep_timeout_ms, max_sweeps] {
+            _acquire_loop(sweep_timeout_ms, max_sweeps);
+        });
+        m_parse_thread = std::thread([this] { _parse_loop(); });
+        return make_ok();
+    }
+
+    /**
+     * @brief 停止采集并等待线程退出（正在等待的扫描最多再等 sweep_timeout_ms）
+     */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        _join();
+    }
+
+    /**
+     * @brief 等待 max_sweeps 次扫描全部解析完成（出错时提前返回）
+     *
+     * 只适用于回调模式；pop() 模式下由消费者取完迹线。
+     */
+    result_t<void> wait() {
+        _join();
+        return status();
+    }
+
+    /**
+     * @brief 取走下一条迹线（与 out 交换缓冲区）
+     * @param out 接收迹线，原有缓冲区交还采集流水线复用
+     * @param timeout_ms 等待超时
+     * @return 采集结束且没有剩余迹线时返回 operation_cancelled（出错时返回该错误）
+     */
+    result_t<void> pop(vna_trace_t& out, milliseconds_t timeout_ms) {
+        if (m_callback) {
+            return make_error_void(error_code_t::invalid_state,
+                                   "Traces are delivered to the callback");
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        slot_t& slot = m_slots[m_pop_sequence % m_slots.size()];
+        const bool ready = m_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&] {
+            return slot.state == slot_state_t::parsed || !m_parsing;
+        });
+        if (slot.state != slot_state_t::parsed) {
+            if (!ready) {
+                return make_error_void(error_code_t::timeout, "No trace within timeout");
+            }
+            if (!m_status) {
+                return m_status;
+            }
+            return make_error_void(error_code_t::operation_cancelled, "Acquisition finished");
+        }
+
+        out.sequence = slot.trace.sequence;
+        out.fetched = slot.trace.fetched;
+        out.real.swap(slot.trace.real);
+        out.imag.swap(slot.trace.imag);
+        slot.state = slot_state_t::free;
+        ++m_pop_sequence;
+        lock.unlock();
+        m_cv.notify_all();
+        return make_ok();
+    }
+
+    bool running() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_acquiring || m_parsing;
+    }
+
+    /**
+     * @brief 第一个错误（没有错误时为 ok）
+     */
+    result_t<void> status() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_status;
+    }
+
+    vna_acquisition_stats_t stats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+private:
+    enum class slot_state_t : uint8_t {
+        free = 0,      ///< 可写入下一次扫描的数据
+        fetched = 1,   ///< 原始文本已读取，等待解析
+        parsed = 2     ///< 已解析，等待 pop()
+    };
+
+    struct slot_t {
+        std::string raw;
+        vna_trace_t trace;
+        slot_state_t state = slot_state_t::free;
+    };
+
+    using steady_clock_t = std::chrono::steady_clock;
+
+    static int64_t _elapsed_us(steady_clock_t::time_point begin) {
+        return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            steady_clock_t::now() - begin).count());
+    }
+
+    void _join() {
+        if (m_acquire_thread.joinable()) {
+            m_acquire_thread.join();
+        }
+        if (m_parse_thread.joinable()) {
+            m_parse_thread.join();
+        }
+    }
+
+    /**
+     * @brief 记录第一个错误并停止采集（调用者持有 m_mutex）
+     */
+    void _fail_locked(const error_t& error) {
+        if (m_status) {
+            m_status = make_error_void(error);
+        }
+        m_stop = true;
+    }
+
+    void _fail(const error_t& error) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            _fail_locked(error);
+        }
+        m_cv.notify_all();
+    }
+
+    // 采集线程：扫描 N+1 与解析 N 重叠
+    void _acquire_loop(milliseconds_t sweep_timeout_ms, uint64_t max_sweeps) {
+        auto started = m_vna.start_sweep();
+        if (!started) {
+            _fail(started.error());
+        }
+
+        for (uint64_t sequence = 0; started; ++sequence) {
+            const auto sweeping = steady_clock_t::now();
+            auto swept = m_vna.wait_sweep_complete(sweep_timeout_ms);
+            const int64_t sweep_us = _elapsed_us(sweeping);
+            if (!swept) {
+                _fail(swept.error());
+                break;
+            }
+
+            slot_t& slot = m_slots[sequence % m_slots.size()];
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (slot.state != slot_state_t::free) {
+                    ++m_stats.stalls;
+                }
+                m_cv.wait(lock, [&] { return m_stop || slot.state == slot_state_t::free; });
+                if (m_stop) {
+                    break;
+                }
+            }
+
+            const auto fetching = steady_clock_t::now();
+            auto data = m_vna.get_complex_data();
+            const int64_t fetch_us = _elapsed_us(fetching);
+            if (!data) {
+                _fail(data.error());
+                break;
+            }
+
+            // 数据已取走，仪器可以开始下一次扫描
+            const bool more = max_sweeps == 0 || sequence + 1 < max_sweeps;
+            if (more) {
+                started = m_vna.start_sweep();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                slot.raw.swap(*data);
+                slot.trace.sequence = sequence;
+                slot.trace.fetched = steady_clock_t::now();
+                slot.state = slot_state_t::fetched;
+                ++m_stats.sweeps;
+                m_stats.sweep_us = sweep_us;
+                m_stats.fetch_us = fetch_us;
+                if (!started) {
+                    _fail_locked(started.error());
+                }
+            }
+            m_cv.notify_all();
+
+            if (!more || m_stop) {
+                break;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_acquiring = false;
+        }
+        m_cv.notify_all();
+    }
+
+    // 解析线程：按序号顺序解析并交付
+    void _parse_loop() {
+        for (uint64_t sequence = 0; ; ++sequence) {
+            slot_t& slot = m_slots[sequence % m_slots.size()];
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [&] { return slot.state == slot_state_t::fetched || !m_acquiring; });
+                if (slot.state != slot_state_t::fetched) {
+                    break;
+                }
+            }
+
+            // 采集线程只写 free 状态的槽，解析期间不加锁
+            const auto parsing = steady_clock_t::now();
+            slot.trace.real.clear();
+            slot.trace.imag.clear();
+            auto parsed = scpi_adapter_t::parse_complex_data(slot.raw, slot.trace.real,
+                                                             slot.trace.imag);
+            const int64_t parse_us = _elapsed_us(parsing);
+            if (parsed && m_callback) {
+                m_callback(slot.trace);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stats.parse_us = parse_us;
+                if (!parsed) {
+                    _fail_locked(parsed.error());
+                    slot.state = slot_state_t::free;
+                } else {
+                    ++m_stats.traces;
+                    slot.state = m_callback ? slot_state_t::free : slot_state_t::parsed;
+                }
+            }
+            m_cv.notify_all();
+            if (!parsed) {
+                break;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_parsing = false;
+        }
+        m_cv.notify_all();
+    }
+
+    vna_adapter_t& m_vna;
+    vna_trace_callback_t m_callback;
+    std::array<slot_t, 2> m_slots;              ///< 双缓冲（扫描 N 使用 m_slots[N % 2]）
+
+    mutable std::mutex m_mutex;                 ///< 保护槽状态、统计和错误
+    std::condition_variable m_cv;
+    result_t<void> m_status = make_ok();
+    vna_acquisition_stats_t m_stats;
+    bool m_stop = false;
+    bool m_acquiring = false;
+    bool m_parsing = false;
+    uint64_t m_pop_sequence = 0;                ///< 下一条由 pop() 取走的迹线
+
+    std::thread m_acquire_thread;
+    std::thread m_parse_thread;
+};
+
+}  // namespace vdl
+
+#endif  // VNA_ACQUISITION_HPP
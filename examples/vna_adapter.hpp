@@ -12,6 +12,7 @@
 #define VNA_ADAPTER_HPP
 
 #include <vdl/device/scpi_adapter.hpp>
+#include <future>
 #include <string>
 #include <vector>
 #include <sstream>
@@ -36,7 +37,7 @@ namespace vdl {
  * 
  * @code
  * auto transport = std::make_unique<tcp_transport_t>("192.168.1.100", 5025);
- * auto codec = std::make_unique<scpi_codec_t>();
+ * auto codec = std::make_unique<ascii_codec_t>();
  * device_impl_t device(std::move(transport), std::move(codec));
  * 
  * vna_adapter_t vna(device);
@@ -90,6 +91,33 @@ public:
         return m_scpi.is_connected();
     }
 
+    // ========================================================================
+    // 设置缓存
+    // ========================================================================
+
+    /**
+     * @brief 启用影子缓存：get_* 直接返回本端最近写入的值，不再往返仪器
+     *
+     * *RST、重连或 invalidate() 后缓存失效。
+     */
+    void enable_shadow_cache(bool enable = true) {
+        m_scpi.enable_shadow_cache(enable);
+    }
+
+    /**
+     * @brief 校验模式：get_* 仍查询仪器（并刷新缓存）
+     */
+    void set_verify(bool verify) {
+        m_scpi.set_verify(verify);
+    }
+
+    /**
+     * @brief 使缓存失效（如仪器被前面板或其他客户端修改后）
+     */
+    void invalidate() {
+        m_scpi.invalidate_cache();
+    }
+
     // ========================================================================
     // 频率相关命令
     // ========================================================================
@@ -99,17 +127,15 @@ public:
      * @param freq_hz 频率（Hz）
      */
     result_t<void> set_start_freq(double freq_hz) {
-        std::ostringstream oss;
-        oss << std::scientific << std::setprecision(10) 
-            << "SENS:FREQ:STAR " << freq_hz;
-        return m_scpi.command(oss.str());
+        m_scpi.invalidate_cache("SENS:FREQ");   // 起止频率与中心/跨度相互关联
+        return m_scpi.set_double("SENS:FREQ:STAR", freq_hz);
     }
 
     /**
      * @brief 查询起始频率
      */
     result_t<double> get_start_freq() {
-        return m_scpi.query_double("SENS:FREQ:STAR?");
+        return m_scpi.get_double("SENS:FREQ:STAR");
     }
 
     /**
@@ -117,17 +143,15 @@ public:
      * @param freq_hz 频率（Hz）
      */
     result_t<void> set_stop_freq(double freq_hz) {
-        std::ostringstream oss;
-        oss << std::scientific << std::setprecision(10) 
-            << "SENS:FREQ:STOP " << freq_hz;
-        return m_scpi.command(oss.str());
+        m_scpi.invalidate_cache("SENS:FREQ");   // 起止频率与中心/跨度相互关联
+        return m_scpi.set_double("SENS:FREQ:STOP", freq_hz);
     }
 
     /**
      * @brief 查询终止频率
      */
     result_t<double> get_stop_freq() {
-        return m_scpi.query_double("SENS:FREQ:STOP?");
+        return m_scpi.get_double("SENS:FREQ:STOP");
     }
 
     /**
@@ -135,17 +159,15 @@ public:
      * @param freq_hz 频率（Hz）
      */
     result_t<void> set_center_freq(double freq_hz) {
-        std::ostringstream oss;
-        oss << std::scientific << std::setprecision(10) 
-            << "SENS:FREQ:CENT " << freq_hz;
-        return m_scpi.command(oss.str());
+        m_scpi.invalidate_cache("SENS:FREQ");   // 起止频率与中心/跨度相互关联
+        return m_scpi.set_double("SENS:FREQ:CENT", freq_hz);
     }
 
     /**
      * @brief 查询中心频率
      */
     result_t<double> get_center_freq() {
-        return m_scpi.query_double("SENS:FREQ:CENT?");
+        return m_scpi.get_double("SENS:FREQ:CENT");
     }
 
     /**
@@ -153,17 +175,109 @@ public:
      * @param span_hz 跨度（Hz）
      */
     result_t<void> set_freq_span(double span_hz) {
-        std::ostringstream oss;
-        oss << std::scientific << std::setprecision(10) 
-            << "SENS:FREQ:SPAN " << span_hz;
-        return m_scpi.command(oss.str());
+        m_scpi.invalidate_cache("SENS:FREQ");   // 起止频率与中心/跨度相互关联
+        return m_scpi.set_double("SENS:FREQ:SPAN", span_hz);
     }
 
     /**
      * @brief 查询频率跨度
      */
     result_t<double> get_freq_span() {
-        return m_scpi.query_double("SENS:FREQ:SPAN?");
+        return m_scpi.get_double("SENS:FREQ:SPAN");
+    }
+
+    /**
+     * @brief 设置点频频率（逐点扫描用，命令头预先编好，无堆分配）
+     * @param freq_hz 频率（Hz）
+     */
+    result_t<void> set_cw_freq(double freq_hz) {
+        return m_scpi.send(m_cw_freq_cmd, freq_hz);
+    }
+
+    /**
+     * @brief 设置源功率（逐点扫描用，无堆分配）
+     * @param power_dbm 功率（dBm）
+     */
+    result_t<void> set_source_power(double power_dbm) {
+        return m_scpi.send(m_source_power_cmd, power_dbm);
+    }
+
+    /**
+     * @brief 一次往返设置完整的扫描参数
+     * @param start_hz 起始频率（Hz）
+     * @param stop_hz 终止频率（Hz）
+     * @param points 扫描点数
+     * @param if_bw_hz 中频带宽（Hz）
+     */
+    result_t<void> configure_sweep(double start_hz, double stop_hz,
+                                   int points, double if_bw_hz) {
+        std::ostringstream oss;
+        oss << std::scientific << std::setprecision(10);
+
+        scpi_batch_t batch;
+        oss << "SENS:FREQ:STAR " << start_hz;
+        batch.command(oss.str());
+        oss.str("");
+        oss << "SENS:FREQ:STOP " << stop_hz;
+        batch.command(oss.str());
+        batch.command("SENS:SWE:POIN " + std::to_string(points));
+        oss.str("");
+        oss << "SENS:BAND " << if_bw_hz;
+        batch.command(oss.str());
+
+        auto result = m_scpi.execute(batch);
+        if (!result) {
+            return make_unexpected(result.error());
+        }
+
+        m_scpi.invalidate_cache("SENS:FREQ");
+        m_scpi.update_cache("SENS:FREQ:STAR", start_hz);
+        m_scpi.update_cache("SENS:FREQ:STOP", stop_hz);
+        m_scpi.update_cache("SENS:SWE:POIN", static_cast<double>(points));
+        m_scpi.update_cache("SENS:BAND", if_bw_hz);
+        return make_ok();
+    }
+
+    /**
+     * @brief 扫描参数
+     */
+    struct sweep_config_t {
+        double start_hz = 0.0;
+        double stop_hz = 0.0;
+        int points = 0;
+        double if_bw_hz = 0.0;
+    };
+
+    /**
+     * @brief 一次往返读回扫描参数
+     */
+    result_t<sweep_config_t> get_sweep_config() {
+        scpi_batch_t batch;
+        const size_t start = batch.query("SENS:FREQ:STAR?");
+        const size_t stop = batch.query("SENS:FREQ:STOP?");
+        const size_t points = batch.query("SENS:SWE:POIN?");
+        const size_t if_bw = batch.query("SENS:BAND?");
+
+        auto result = m_scpi.execute(batch);
+        if (!result) {
+            return make_unexpected(result.error());
+        }
+
+        auto start_hz = result->as_double(start);
+        auto stop_hz = result->as_double(stop);
+        auto point_count = result->as_int(points);
+        auto if_bw_hz = result->as_double(if_bw);
+        if (!start_hz || !stop_hz || !point_count || !if_bw_hz) {
+            return make_error<sweep_config_t>(error_code_t::invalid_format,
+                                              "Invalid sweep configuration reply");
+        }
+
+        sweep_config_t config;
+        config.start_hz = *start_hz;
+        config.stop_hz = *stop_hz;
+        config.points = *point_count;
+        config.if_bw_hz = *if_bw_hz;
+        return config;
     }
 
     // ========================================================================
@@ -175,16 +289,14 @@ public:
      * @param points 点数
      */
     result_t<void> set_sweep_points(int points) {
-        std::ostringstream oss;
-        oss << "SENS:SWE:POIN " << points;
-        return m_scpi.command(oss.str());
+        return m_scpi.set_int("SENS:SWE:POIN", points);
     }
 
     /**
      * @brief 查询扫描点数
      */
     result_t<int> get_sweep_points() {
-        return m_scpi.query_int("SENS:SWE:POIN?");
+        return m_scpi.get_int("SENS:SWE:POIN");
     }
 
     /**
@@ -192,17 +304,14 @@ public:
      * @param bw_hz 带宽（Hz）
      */
     result_t<void> set_if_bandwidth(double bw_hz) {
-        std::ostringstream oss;
-        oss << std::scientific << std::setprecision(10) 
-            << "SENS:BAND " << bw_hz;
-        return m_scpi.command(oss.str());
+        return m_scpi.set_double("SENS:BAND", bw_hz);
     }
 
     /**
      * @brief 查询中频带宽
      */
     result_t<double> get_if_bandwidth() {
-        return m_scpi.query_double("SENS:BAND?");
+        return m_scpi.get_double("SENS:BAND");
     }
 
     /**
@@ -226,6 +335,52 @@ public:
         return m_scpi.command("INIT:IMM");
     }
 
+    /**
+     * @brief 触发单次扫描，扫描结束（SRQ）时 future 就绪
+     * @param timeout_ms 等待扫描完成的超时
+     *
+     * 需要先调用 enable_sweep_complete_notification()。
+     */
+    std::future<result_t<void>> trigger_sweep_async(milliseconds_t timeout_ms) {
+        return m_scpi.start_operation("INIT:IMM", timeout_ms);
+    }
+
+    /**
+     * @brief 触发单次扫描并在当前线程等待扫描完成（SRQ 或 *ESR? 轮询）
+     * @param timeout_ms 等待扫描完成的超时
+     */
+    result_t<void> trigger_sweep_and_wait(milliseconds_t timeout_ms) {
+        auto result = start_sweep();
+        if (!result) {
+            return result;
+        }
+        return wait_sweep_complete(timeout_ms);
+    }
+
+    /**
+     * @brief 触发单次扫描并立即返回（扫描结束时置位 OPC）
+     *
+     * 与 wait_sweep_complete() 配合，可以在扫描进行时处理上一条迹线。
+     */
+    result_t<void> start_sweep() {
+        return m_scpi.command("INIT:IMM;*OPC");
+    }
+
+    /**
+     * @brief 等待 start_sweep() 触发的扫描完成
+     * @param timeout_ms 等待扫描完成的超时
+     */
+    result_t<void> wait_sweep_complete(milliseconds_t timeout_ms) {
+        return m_scpi.wait_operation_complete(timeout_ms);
+    }
+
+    /**
+     * @brief 启用扫描完成的服务请求通知
+     */
+    result_t<void> enable_sweep_complete_notification() {
+        return m_scpi.enable_opc_service_request();
+    }
+
     // ========================================================================
     // 测量相关命令
     // ========================================================================
@@ -268,22 +423,68 @@ public:
      * @brief 读取格式化数据并解析为 double 向量
      */
     result_t<std::vector<double>> get_formatted_data_parsed() {
-        auto result = get_formatted_data();
+        std::vector<double> data;
+        auto result = get_formatted_data_parsed(data);
         if (!result) {
             return make_unexpected(result.error());
         }
-        return scpi_adapter_t::parse_data_doubles(*result);
+        return make_ok(std::move(data));
+    }
+
+    /**
+     * @brief 读取格式化数据并边接收边解析到 out（不生成完整响应字符串）
+     * @return 成功返回数据点数
+     */
+    result_t<size_t> get_formatted_data_parsed(std::vector<double>& out) {
+        return m_scpi.query_data_doubles("CALC:DATA? FDAT", out);
     }
 
     /**
      * @brief 读取复数数据并解析为复数向量对
      */
     result_t<std::vector<std::pair<double, double>>> get_complex_data_parsed() {
-        auto result = get_complex_data();
+        std::vector<double> values;
+        auto result = m_scpi.query_data_doubles("CALC:DATA? SDAT", values);
         if (!result) {
             return make_unexpected(result.error());
         }
-        return scpi_adapter_t::parse_complex_data(*result);
+        if (values.size() % 2 != 0) {
+            return make_error<std::vector<std::pair<double, double>>>(
+                error_code_t::invalid_format,
+                "Complex data must have even number of values");
+        }
+
+        std::vector<std::pair<double, double>> pairs;
+        pairs.reserve(values.size() / 2);
+        for (size_t i = 0; i < values.size(); i += 2) {
+            pairs.emplace_back(values[i], values[i + 1]);
+        }
+        return make_ok(std::move(pairs));
+    }
+
+    /**
+     * @brief 切换到 REAL,64 二进制传输（数据量约为 ASCII 的 1/3，且无需解析）
+     */
+    result_t<void> enable_binary_transfer() {
+        auto result = m_scpi.command("FORM:DATA REAL,64");
+        if (!result) {
+            return result;
+        }
+        return m_scpi.set_byte_order(byte_order_t::native);
+    }
+
+    /**
+     * @brief 以二进制块读取格式化数据（需先调用 enable_binary_transfer()）
+     */
+    result_t<size_t> get_formatted_data_binary(std::vector<double>& out) {
+        return m_scpi.query_real64_array("CALC:DATA? FDAT", out);
+    }
+
+    /**
+     * @brief 以二进制块读取复数数据，交错排列（real1,imag1,real2,imag2,...）
+     */
+    result_t<size_t> get_complex_data_binary(std::vector<double>& out) {
+        return m_scpi.query_real64_array("CALC:DATA? SDAT", out);
     }
 
     // ========================================================================
@@ -320,6 +521,8 @@ public:
 
 private:
     scpi_adapter_t m_scpi;
+    scpi_command_template_t m_cw_freq_cmd{"SENS:FREQ:CW"};
+    scpi_command_template_t m_source_power_cmd{"SOUR:POW"};
 };
 
 }  // namespace vdl
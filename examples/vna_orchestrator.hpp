@@ -0,0 +1,197 @@
+/**
+ * @file vna_orchestrator.hpp
+ * @brief 多台 VNA 并行扫描编排 - 示例实现
+ *
+ * 在共享的有界线程池上并行配置、触发和读取多台 VNA，
+ * 并记录每台仪器各阶段的耗时，便于找出拖慢整体节拍的仪器。
+ */
+
+#ifndef VNA_ORCHESTRATOR_HPP
+#define VNA_ORCHESTRATOR_HPP
+
+#include "vna_adapter.hpp"
+#include <vdl/core/thread_pool.hpp>
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace vdl {
+
+// ============================================================================
+// 单台仪器的结果
+// ============================================================================
+
+/**
+ * @brief 各阶段耗时（微秒）
+ */
+struct vna_timing_t {
+    int64_t configure_us = 0;   ///< configure() 耗时
+    int64_t sweep_us = 0;       ///< 从触发到扫描完成
+    int64_t fetch_us = 0;       ///< 读取迹线
+    int64_t total_us = 0;       ///< run_sweep() 中该仪器的总耗时（含错峰等待）
+};
+
+/**
+ * @brief 单台仪器的扫描结果槽（预先分配，反复使用）
+ */
+struct vna_sweep_slot_t {
+    std::vector<double> trace;                  ///< 迹线数据，容量在 configure() 时预留
+    result_t<void> status = make_ok();          ///< 最近一次操作的结果
+    vna_timing_t timing;
+};
+
+// ============================================================================
+// vna_orchestrator_t - 并行扫描编排
+// ============================================================================
+
+/**
+ * @brief 多台 VNA 的并行扫描编排器
+ *
+ * 每台仪器的操作作为一个任务提交到线程池；线程数少于仪器数时
+ * 任务排队执行，不会为每台仪器单独创建线程。
+ *
+ * @code
+ * thread_pool_t pool(4);
+ * vna_orchestrator_t orchestrator({&vna1, &vna2, &vna3}, pool);
+ * orchestrator.configure(1e9, 6e9, 401, 1e3);
+ * orchestrator.run_sweep(30000);
+ * const auto& slot = orchestrator.slot(orchestrator.straggler());
+ * @endcode
+ *
+ * @note 适配器和线程池必须比编排器活得久；同一时间只能有一个 run_sweep()/configure()
+ */
+class vna_orchestrator_t {
+public:
+    vna_orchestrator_t(std::vector<vna_adapter_t*> adapters, thread_pool_t& pool)
+        : m_adapters(std::move(adapters))
+        , m_slots(m_adapters.size())
+        , m_pool(pool) {
+    }
+
+    size_t size() const {
+        return m_adapters.size();
+    }
+
+    /**
+     * @brief 设置触发错峰间隔：第 i 台仪器在 i * stagger_ms 后触发（0 表示同时触发）
+     */
+    void set_trigger_stagger(milliseconds_t stagger_ms) {
+        m_stagger_ms = stagger_ms;
+    }
+
+    /**
+     * @brief 并行配置所有仪器的扫描参数，并按点数预留迹线缓冲区
+     * @return 所有仪器都成功返回 ok，否则返回第一个失败仪器的错误
+     */
+    result_t<void> configure(double start_hz, double stop_hz, int points, double if_bw_hz) {
+        const size_t reserve = points > 0 ? static_cast<size_t>(points) : 0;
+        return _run_all([=](size_t index) {
+            vna_sweep_slot_t& slot = m_slots[index];
+            slot.trace.reserve(reserve);
+
+            const auto begin = steady_clock_t::now();
+            slot.status = m_adapters[index]->configure_sweep(start_hz, stop_hz, points, if_bw_hz);
+            slot.timing.configure_us = _elapsed_us(begin);
+        });
+    }
+
+    /**
+     * @brief 并行触发扫描、等待完成并读取格式化迹线到各自的结果槽
+     * @param timeout_ms 单台仪器等待扫描完成的超时
+     */
+    result_t<void> run_sweep(milliseconds_t timeout_ms) {
+        const auto launch = steady_clock_t::now();
+        return _run_all([=](size_t index) {
+            vna_sweep_slot_t& slot = m_slots[index];
+            vna_adapter_t& vna = *m_adapters[index];
+            slot.trace.clear();   // 保留容量
+
+            if (m_stagger_ms > 0) {
+                std::this_thread::sleep_until(
+                    launch + std::chrono::milliseconds(m_stagger_ms) * static_cast<int64_t>(index));
+            }
+
+            const auto triggered = steady_clock_t::now();
+            slot.status = vna.trigger_sweep_and_wait(timeout_ms);
+            slot.timing.sweep_us = _elapsed_us(triggered);
+
+            if (slot.status) {
+                const auto fetching = steady_clock_t::now();
+                auto fetched = vna.get_formatted_data_parsed(slot.trace);
+                slot.timing.fetch_us = _elapsed_us(fetching);
+                if (!fetched) {
+                    slot.status = make_error_void(fetched.error());
+                }
+            }
+            slot.timing.total_us = _elapsed_us(launch);
+        });
+    }
+
+    /**
+     * @brief 获取第 index 台仪器的结果槽
+     */
+    const vna_sweep_slot_t& slot(size_t index) const {
+        return m_slots[index];
+    }
+
+    /**
+     * @brief 最近一次 run_sweep() 中总耗时最长的仪器序号
+     */
+    size_t straggler() const {
+        size_t slowest = 0;
+        for (size_t i = 1; i < m_slots.size(); ++i) {
+            if (m_slots[i].timing.total_us > m_slots[slowest].timing.total_us) {
+                slowest = i;
+            }
+        }
+        return slowest;
+    }
+
+private:
+    using steady_clock_t = std::chrono::steady_clock;
+
+    static int64_t _elapsed_us(steady_clock_t::time_point begin) {
+        return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            steady_clock_t::now() - begin).count());
+    }
+
+    // 为每台仪器提交一个任务并等待全部完成，汇总第一个错误
+    template<typename Task>
+    result_t<void> _run_all(Task task) {
+        std::vector<std::future<void>> pending;
+        pending.reserve(m_adapters.size());
+
+        for (size_t i = 0; i < m_adapters.size(); ++i) {
+            auto future = m_pool.submit([task, i] { task(i); });
+            if (!future.valid()) {
+                m_slots[i].status = make_error_void(error_code_t::invalid_state,
+                                                    "Thread pool is shut down");
+            }
+            pending.push_back(std::move(future));
+        }
+
+        for (auto& future : pending) {
+            if (future.valid()) {
+                future.wait();
+            }
+        }
+
+        for (const auto& slot : m_slots) {
+            if (!slot.status) {
+                return slot.status;
+            }
+        }
+        return make_ok();
+    }
+
+    std::vector<vna_adapter_t*> m_adapters;
+    std::vector<vna_sweep_slot_t> m_slots;
+    thread_pool_t& m_pool;
+    milliseconds_t m_stagger_ms = 0;
+};
+
+}  // namespace vdl
+
+#endif  // VNA_ORCHESTRATOR_HPP
@@ -0,0 +1,303 @@
+/**
+ * @file ascii_codec.hpp
+ * @brief 行文本协议编解码器
+ *
+ * 命令数据即消息文本，编码时追加终止符；响应以终止符分帧。
+ * 识别 IEEE 488.2 定长块（#<n><长度><数据>），块数据中的换行不会截断帧。
+ * 这样 SCPI 等文本协议也能走 execute()/execute_batch()/execute_async() 的
+ * 重试、统计、批处理和流水线路径。
+ */
+
+#ifndef VDL_CODEC_ASCII_CODEC_HPP
+#define VDL_CODEC_ASCII_CODEC_HPP
+
+#include "codec.hpp"
+#include "../core/buffer.hpp"
+#include "../core/memory.hpp"
+
+#include <cstring>
+#include <string>
+
+namespace vdl {
+
+// ============================================================================
+// ascii_codec_t - 行文本编解码器
+// ============================================================================
+
+/**
+ * @brief 行文本协议编解码器
+ *
+ * - 编码：命令数据 + 终止符（数据已以终止符结尾时不再追加）
+ * - 分帧：memchr 查找终止符；响应数据元素以 '#' 开头的定长块整体跳过
+ * - 解码：响应数据为去掉终止符的文本（终止符为 "\n" 时同时去掉行尾的 '\r'）
+ *
+ * @code
+ * device_impl_t device(make_unique<tcp_transport_t>("192.168.1.50", 5025),
+ *                      make_unique<ascii_codec_t>());
+ * auto resp = device.execute(make_ascii_command("*IDN?"));
+ * if (resp) {
+ *     std::string idn = response_text(*resp);
+ * }
+ * @endcode
+ *
+ * @note 只有期望响应的消息（查询）适合 execute()；不产生响应的命令用 write()
+ */
+class ascii_codec_t : public codec_base_t {
+public:
+    /**
+     * @brief 构造函数
+     * @param terminator 消息终止符（空时使用 "\n"）
+     */
+    explicit ascii_codec_t(const std::string& terminator = "\n")
+        : m_terminator(terminator.empty() ? std::string("\n") : terminator) {
+    }
+
+    const std::string& terminator() const {
+        return m_terminator;
+    }
+
+    // ========================================================================
+    // i_codec_t 实现
+    // ========================================================================
+
+    result_t<bytes_t> encode(const command_t& cmd) override {
+        auto size_result = encoded_size(cmd);
+        if (!size_result) {
+            return make_unexpected(size_result.error());
+        }
+
+        bytes_t frame = size_class_pool_t::instance().acquire(*size_result);
+        auto result = encode_into(cmd, byte_span_t(frame.data(), frame.size()));
+        if (!result) {
+            size_class_pool_t::instance().release(std::move(frame));
+            return make_unexpected(result.error());
+        }
+        return frame;
+    }
+
+    result_t<size_t> encoded_size(const command_t& cmd) override {
+        const payload_bytes_t& data = cmd.data();
+        const size_t frame_len = data.size() + _trailer_size(data);
+        if (frame_len > m_max_frame_size) {
+            return make_error<size_t>(error_code_t::frame_too_large,
+                                      "Frame size exceeds maximum");
+        }
+        return frame_len;
+    }
+
+    result_t<size_t> encode_into(const command_t& cmd, byte_span_t out) override {
+        auto size_result = encoded_size(cmd);
+        if (!size_result) {
+            return size_result;
+        }
+        const payload_bytes_t& data = cmd.data();
+        const size_t trailer = _trailer_size(data);
+        if (out.size() < trailer || data.size() > out.size() - trailer) {
+            return make_error<size_t>(error_code_t::invalid_size,
+                                      "Output buffer too small for encoded frame");
+        }
+        if (!data.empty()) {
+            std::memcpy(out.data(), data.data(), data.size());
+        }
+        if (trailer > 0) {
+            std::memcpy(out.data() + data.size(), m_terminator.data(), trailer);
+        }
+        return data.size() + trailer;
+    }
+
+    result_t<void> encode_parts(const command_t& cmd, frame_parts_t& parts) override {
+        if (m_terminator.size() > frame_parts_t::k_max_part_size) {
+            return make_error_void(error_code_t::not_supported,
+                                   "Terminator exceeds inline capacity");
+        }
+        auto size_result = encoded_size(cmd);
+        if (!size_result) {
+            return make_error_void(size_result.error());
+        }
+        const payload_bytes_t& data = cmd.data();
+        const size_t trailer = _trailer_size(data);
+        parts.header.set_size(0);
+        parts.payload = const_byte_span_t(data.data(), data.size());
+        parts.trailer.set_size(trailer);
+        if (trailer > 0) {
+            std::memcpy(parts.trailer.data(), m_terminator.data(), trailer);
+        }
+        return make_ok();
+    }
+
+    result_t<response_t> decode(const_byte_span_t buffer, size_t& consumed) override {
+        return _decode(buffer, consumed, nullptr);
+    }
+
+    result_t<response_t> decode_slice(const byte_slice_t& frame, size_t& consumed) override {
+        return _decode(frame.view(), consumed, &frame);
+    }
+
+    size_t frame_length(const_byte_span_t buffer) const override {
+        return _scan(buffer);
+    }
+
+    const char* name() const override {
+        return "ascii";
+    }
+
+private:
+    /**
+     * @brief 需要追加的终止符长度
+     */
+    size_t _trailer_size(const payload_bytes_t& data) const {
+        const size_t term = m_terminator.size();
+        if (data.size() >= term &&
+            std::memcmp(data.data() + data.size() - term, m_terminator.data(), term) == 0) {
+            return 0;
+        }
+        return term;
+    }
+
+    /**
+     * @brief '#' 是否处于响应数据元素的开头（消息开头或分隔符之后）
+     */
+    static bool _is_element_start(const byte_t* base, size_t pos) {
+        if (pos == 0) {
+            return true;
+        }
+        const byte_t prev = base[pos - 1];
+        return prev == ',' || prev == ';' || prev == ' ' || prev == '\t';
+    }
+
+    /**
+     * @brief 查找完整帧
+     * @return 帧长度（含终止符），数据不完整时返回 0
+     */
+    size_t _scan(const_byte_span_t buffer) const {
+        const byte_t* base = buffer.data();
+        const size_t size = buffer.size();
+        const size_t term = m_terminator.size();
+        const byte_t term_last = static_cast<byte_t>(m_terminator[term - 1]);
+        size_t pos = 0;
+
+        while (pos < size) {
+            const void* hit = std::memchr(base + pos, term_last, size - pos);
+            const size_t limit = hit ? static_cast<size_t>(static_cast<const byte_t*>(hit) - base)
+                                     : size;
+
+            // 终止符之前的定长块：跳过块数据后继续查找
+            const void* hash = std::memchr(base + pos, '#', limit - pos);
+            if (hash) {
+                const size_t at = static_cast<size_t>(static_cast<const byte_t*>(hash) - base);
+                if (_is_element_start(base, at)) {
+                    if (at + 2 > size) {
+                        return 0;
+                    }
+                    const byte_t n = base[at + 1];
+                    if (n >= '1' && n <= '9') {
+                        const size_t digits = static_cast<size_t>(n - '0');
+                        if (size - at - 2 < digits) {
+                            return 0;
+                        }
+                        size_t length = 0;
+                        bool valid = true;
+                        for (size_t i = 0; i < digits; ++i) {
+                            const byte_t c = base[at + 2 + i];
+                            if (c < '0' || c > '9') {
+                                valid = false;
+                                break;
+                            }
+                            length = length * 10 + static_cast<size_t>(c - '0');
+                        }
+                        if (valid) {
+                            const size_t data_begin = at + 2 + digits;
+                            if (length > size - data_begin) {
+                                return 0;
+                            }
+                            pos = data_begin + length;
+                            continue;
+                        }
+                    }
+                }
+                // 不是定长块（含 #0 不定长块），按普通文本处理
+                pos = at + 1;
+                continue;
+            }
+
+            if (!hit) {
+                return 0;
+            }
+            const size_t end = limit + 1;
+            if (end >= term &&
+                std::memcmp(base + end - term, m_terminator.data(), term) == 0) {
+                return end;
+            }
+            pos = end;
+        }
+        return 0;
+    }
+
+    result_t<response_t> _decode(const_byte_span_t buffer, size_t& consumed,
+                                 const byte_slice_t* slab) {
+        consumed = 0;
+        const size_t frame_len = _scan(buffer);
+        if (frame_len == 0) {
+            if (buffer.size() >= m_max_frame_size) {
+                consumed = buffer.size();
+                return make_error<response_t>(error_code_t::frame_too_large,
+                                              "Frame size exceeds maximum");
+            }
+            return make_error<response_t>(error_code_t::incomplete_frame,
+                                          "Incomplete frame: need more data");
+        }
+
+        size_t text_len = frame_len - m_terminator.size();
+        if (m_terminator.size() == 1 && m_terminator[0] == '\n' &&
+            text_len > 0 && buffer[text_len - 1] == '\r') {
+            --text_len;
+        }
+
+        response_t response;
+        response.set_status(response_status_t::success);
+        if (slab) {
+            if (text_len > 0) {
+                response.set_data_slice(slab->subslice(0, text_len));
+            }
+            response.set_raw_frame_slice(slab->subslice(0, frame_len));
+        } else {
+            if (text_len > 0) {
+                response.set_data(buffer.first(text_len));
+            }
+            response.set_raw_frame(buffer.first(frame_len));
+        }
+
+        consumed = frame_len;
+        return response;
+    }
+
+    std::string m_terminator;
+};
+
+// ============================================================================
+// 辅助函数
+// ============================================================================
+
+/**
+ * @brief 创建文本消息命令（数据即消息文本，终止符由编解码器追加）
+ */
+inline command_t make_ascii_command(const std::string& text) {
+    return command_t()
+        .set_type(command_type_t::query)
+        .set_data(const_byte_span_t(reinterpret_cast<const byte_t*>(text.data()), text.size()));
+}
+
+/**
+ * @brief 响应文本
+ */
+inline std::string response_text(const response_t& response) {
+    const const_byte_span_t data = response.data_view();
+    if (data.empty()) {
+        return std::string();
+    }
+    return std::string(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+}  // namespace vdl
+
+#endif  // VDL_CODEC_ASCII_CODEC_HPP
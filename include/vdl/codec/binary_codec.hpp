@@ -9,7 +9,11 @@
 #define VDL_CODEC_BINARY_CODEC_HPP
 
 #include "codec.hpp"
+#include "crc16.hpp"
 #include "../core/buffer.hpp"
+#include "../core/memory.hpp"
+
+#include <cstring>
 
 namespace vdl {
 
@@ -36,25 +40,200 @@ constexpr size_t HEADER_SIZE = 4;     ///< 头部大小 (SOF + LEN + FUNC)
 constexpr size_t CRC_SIZE = 2;        ///< CRC 大小
 constexpr size_t MIN_FRAME_SIZE = 6;  ///< 最小帧大小
 
+/**
+ * @brief 增量计算 CRC16 (CCITT)
+ * @param crc 之前的 CRC 值（首段为 0xFFFF）
+ */
+inline uint16_t crc16_update(uint16_t crc, const byte_t* data, size_t len) {
+    return crc16_ccitt_t::update(crc, data, len);
+}
+
 /**
  * @brief 计算 CRC16 (CCITT)
  */
 inline uint16_t crc16(const byte_t* data, size_t len) {
-    uint16_t crc = 0xFFFF;
-    for (size_t i = 0; i < len; ++i) {
-        crc ^= static_cast<uint16_t>(static_cast<uint16_t>(data[i]) << 8);
-        for (int j = 0; j < 8; ++j) {
-            if (crc & 0x8000) {
-                crc = static_cast<uint16_t>((crc << 1) ^ 0x1021);
-            } else {
-                crc = static_cast<uint16_t>(crc << 1);
+    return crc16_ccitt_t::compute(data, len);
+}
+
+}  // namespace binary_frame
+
+// ============================================================================
+// binary_stream_decoder_t - 二进制帧增量解码器
+// ============================================================================
+
+/**
+ * @brief 二进制帧的原生流解码器
+ *
+ * 逐段接收：memchr 查找 SOF，凑齐 4 字节帧头后按 LEN 分配整帧缓冲区，
+ * 之后的数据直接追加并累计 CRC，每个字节只复制和校验一次。
+ * 完整帧由响应以共享切片接管，不再复制。
+ *
+ * 帧头长度超限或 CRC 不符时，从候选帧的第二个字节起重新查找 SOF，
+ * 与 binary_codec_t::decode_all() 的重同步方式一致。
+ */
+class binary_stream_decoder_t : public i_stream_decoder_t {
+public:
+    /**
+     * @brief 构造函数
+     * @param max_frame_size 最大帧长度
+     */
+    explicit binary_stream_decoder_t(size_t max_frame_size = 65536)
+        : m_max_frame_size(max_frame_size) {
+    }
+
+    size_t feed(const_byte_span_t data, const frame_callback_t& on_frame) override {
+        size_t frames = 0;
+        const_byte_span_t input = data;
+        bytes_t backlog;
+
+        while (!input.empty()) {
+            input = input.subspan(_step(input, on_frame, frames));
+
+            if (!m_rejected.empty()) {
+                // 候选帧无效：其余字节与剩余输入一起重新查找帧头
+                bytes_t replay;
+                replay.reserve(m_rejected.size() - 1 + input.size());
+                replay.insert(replay.end(), m_rejected.begin() + 1, m_rejected.end());
+                replay.insert(replay.end(), input.begin(), input.end());
+                m_rejected.clear();
+                ++m_discarded;
+                backlog.swap(replay);
+                input = const_byte_span_t(backlog.data(), backlog.size());
             }
         }
+        return frames;
     }
-    return crc;
-}
 
-}  // namespace binary_frame
+    void reset() override {
+        m_header_size = 0;
+        m_frame.clear();
+        m_filled = 0;
+    }
+
+    size_t buffered() const override {
+        return m_frame.empty() ? m_header_size : m_filled;
+    }
+
+    size_t discarded() const override {
+        return m_discarded;
+    }
+
+private:
+    /**
+     * @brief 处理输入的一段（查找 SOF、填充帧头或填充帧体）
+     * @return 消耗的输入字节数
+     */
+    size_t _step(const_byte_span_t input, const frame_callback_t& on_frame, size_t& frames) {
+        const byte_t* base = input.data();
+        const size_t size = input.size();
+
+        if (m_header_size == 0) {
+            const void* hit = std::memchr(base, binary_frame::SOF, size);
+            if (hit == nullptr) {
+                m_discarded += size;
+                return size;
+            }
+            const size_t at = static_cast<size_t>(static_cast<const byte_t*>(hit) - base);
+            m_discarded += at;
+            m_header[0] = binary_frame::SOF;
+            m_header_size = 1;
+            return at + 1;
+        }
+
+        if (m_frame.empty()) {
+            const size_t n = std::min(binary_frame::HEADER_SIZE - m_header_size, size);
+            std::memcpy(m_header + m_header_size, base, n);
+            m_header_size += n;
+            if (m_header_size == binary_frame::HEADER_SIZE) {
+                _begin_frame();
+            }
+            return n;
+        }
+
+        const size_t frame_len = m_frame.size();
+        const size_t n = std::min(frame_len - m_filled, size);
+        std::memcpy(m_frame.data() + m_filled, base, n);
+        m_filled += n;
+
+        // CRC 只覆盖 CRC 字段之前的字节
+        const size_t covered = std::min(m_filled, frame_len - binary_frame::CRC_SIZE);
+        if (covered > m_crc_pos) {
+            m_crc = binary_frame::crc16_update(m_crc, m_frame.data() + m_crc_pos, covered - m_crc_pos);
+            m_crc_pos = covered;
+        }
+
+        if (m_filled == frame_len) {
+            _finish_frame(on_frame, frames);
+        }
+        return n;
+    }
+
+    /**
+     * @brief 帧头完整：校验长度并分配整帧缓冲区
+     */
+    void _begin_frame() {
+        const size_t data_len = static_cast<size_t>(m_header[1]) |
+                                (static_cast<size_t>(m_header[2]) << 8);
+        const size_t frame_len = binary_frame::HEADER_SIZE + data_len + binary_frame::CRC_SIZE;
+        if (frame_len > m_max_frame_size) {
+            m_rejected.assign(m_header, m_header + binary_frame::HEADER_SIZE);
+            m_header_size = 0;
+            return;
+        }
+
+        m_frame.resize(frame_len);
+        std::memcpy(m_frame.data(), m_header, binary_frame::HEADER_SIZE);
+        m_filled = binary_frame::HEADER_SIZE;
+        m_crc = binary_frame::crc16_update(0xFFFF, m_header, binary_frame::HEADER_SIZE);
+        m_crc_pos = binary_frame::HEADER_SIZE;
+    }
+
+    /**
+     * @brief 整帧到齐：校验 CRC 并交出响应
+     */
+    void _finish_frame(const frame_callback_t& on_frame, size_t& frames) {
+        const size_t frame_len = m_frame.size();
+        const uint16_t actual_crc = static_cast<uint16_t>(
+            static_cast<uint16_t>(m_frame[frame_len - 2]) |
+            (static_cast<uint16_t>(m_frame[frame_len - 1]) << 8));
+        m_header_size = 0;
+        m_filled = 0;
+
+        if (actual_crc != m_crc) {
+            m_rejected.swap(m_frame);
+            m_frame.clear();
+            return;
+        }
+
+        const byte_t function_code = m_frame[3];
+        const size_t data_len = frame_len - binary_frame::MIN_FRAME_SIZE;
+        byte_slice_t slab(std::move(m_frame));
+        m_frame = bytes_t();
+
+        response_t response;
+        response.set_status(response_status_t::success);
+        response.set_function_code(function_code);
+        if (data_len > 0) {
+            response.set_data_slice(slab.subslice(binary_frame::HEADER_SIZE, data_len));
+        }
+        response.set_raw_frame_slice(slab);
+
+        ++frames;
+        if (on_frame) {
+            on_frame(response);
+        }
+    }
+
+    size_t m_max_frame_size;
+    byte_t m_header[binary_frame::HEADER_SIZE] = {};
+    size_t m_header_size = 0;     ///< 已收到的帧头字节数
+    bytes_t m_frame;              ///< 当前帧（帧头完整后分配为整帧长度）
+    size_t m_filled = 0;          ///< m_frame 中已填充的字节数
+    uint16_t m_crc = 0;           ///< 已覆盖字节的累计 CRC
+    size_t m_crc_pos = 0;         ///< CRC 已覆盖到的位置
+    bytes_t m_rejected;           ///< 待重新扫描的无效候选帧
+    size_t m_discarded = 0;
+};
 
 // ============================================================================
 // binary_codec_t - 二进制编解码器
@@ -83,17 +262,52 @@ public:
     // ========================================================================
 
     result_t<bytes_t> encode(const command_t& cmd) override {
-        const bytes_t& data = cmd.data();
-        size_t data_len = data.size();
-        size_t frame_len = binary_frame::HEADER_SIZE + data_len + 
+        auto size_result = encoded_size(cmd);
+        if (!size_result) {
+            return make_unexpected(size_result.error());
+        }
+
+        // 缓冲区取自分级池，调用者用完后可以 release() 归还
+        bytes_t frame = size_class_pool_t::instance().acquire(*size_result);
+        auto result = encode_into(cmd, byte_span_t(frame.data(), frame.size()));
+        if (!result) {
+            size_class_pool_t::instance().release(std::move(frame));
+            return make_unexpected(result.error());
+        }
+
+        return frame;
+    }
+
+    result_t<size_t> encoded_size(const command_t& cmd) override {
+        size_t frame_len = binary_frame::HEADER_SIZE + cmd.data().size() + 
                           binary_frame::CRC_SIZE;
 
         if (frame_len > m_max_frame_size) {
-            return make_error<bytes_t>(error_code_t::frame_too_large,
-                                       "Frame size exceeds maximum");
+            return make_error<size_t>(error_code_t::frame_too_large,
+                                      "Frame size exceeds maximum");
+        }
+
+        return frame_len;
+    }
+
+    result_t<size_t> encode_into(const command_t& cmd, byte_span_t out) override {
+        auto size_result = encoded_size(cmd);
+        if (!size_result) {
+            return size_result;
         }
 
-        bytes_t frame(frame_len);
+        const payload_bytes_t& data = cmd.data();
+        const size_t data_len = data.size();
+        const size_t frame_len = binary_frame::HEADER_SIZE + data_len + binary_frame::CRC_SIZE;
+
+        // 写成不会回绕的形式，编译器据此可知数据长度有界
+        if (out.size() < binary_frame::MIN_FRAME_SIZE ||
+            data_len > out.size() - binary_frame::MIN_FRAME_SIZE) {
+            return make_error<size_t>(error_code_t::invalid_size,
+                                      "Output buffer too small for encoded frame");
+        }
+
+        byte_t* frame = out.data();
 
         // SOF
         frame[0] = binary_frame::SOF;
@@ -106,18 +320,163 @@ public:
         frame[3] = cmd.function_code();
 
         // DATA
-        std::copy(data.begin(), data.end(), frame.begin() + 4);
+        std::copy(data.begin(), data.end(), frame + 4);
 
         // CRC (小端序)
-        uint16_t crc = binary_frame::crc16(frame.data(), frame_len - 2);
+        uint16_t crc = binary_frame::crc16(frame, frame_len - 2);
         frame[frame_len - 2] = static_cast<byte_t>(crc & 0xFF);
         frame[frame_len - 1] = static_cast<byte_t>((crc >> 8) & 0xFF);
 
-        return frame;
+        return frame_len;
+    }
+
+    result_t<void> encode_parts(const command_t& cmd, frame_parts_t& parts) override {
+        auto size_result = encoded_size(cmd);
+        if (!size_result) {
+            return make_error_void(size_result.error());
+        }
+
+        const payload_bytes_t& data = cmd.data();
+        size_t data_len = data.size();
+
+        // 头部: SOF + LEN(LE) + FUNC
+        parts.header.set_size(binary_frame::HEADER_SIZE);
+        parts.header[0] = binary_frame::SOF;
+        parts.header[1] = static_cast<byte_t>(data_len & 0xFF);
+        parts.header[2] = static_cast<byte_t>((data_len >> 8) & 0xFF);
+        parts.header[3] = cmd.function_code();
+
+        parts.payload = const_byte_span_t(data.data(), data_len);
+
+        // 尾部: CRC(LE)，依次覆盖头部和负载
+        uint16_t crc = binary_frame::crc16_update(0xFFFF, parts.header.data(),
+                                                  binary_frame::HEADER_SIZE);
+        crc = binary_frame::crc16_update(crc, data.data(), data_len);
+        parts.trailer.set_size(binary_frame::CRC_SIZE);
+        parts.trailer[0] = static_cast<byte_t>(crc & 0xFF);
+        parts.trailer[1] = static_cast<byte_t>((crc >> 8) & 0xFF);
+
+        return make_ok();
     }
 
     result_t<response_t> decode(const_byte_span_t buffer, 
                                  size_t& consumed) override {
+        return _decode(buffer, consumed, nullptr);
+    }
+
+    result_t<response_t> decode_slice(const byte_slice_t& frame,
+                                       size_t& consumed) override {
+        return _decode(frame.view(), consumed, &frame);
+    }
+
+    size_t decode_all(const_byte_span_t buffer, const frame_callback_t& on_frame) override {
+        const byte_t* base = buffer.data();
+        const size_t size = buffer.size();
+        size_t pos = 0;
+
+        while (pos < size) {
+            // memchr 一次跳过整段噪声
+            const void* hit = std::memchr(base + pos, binary_frame::SOF, size - pos);
+            if (hit == nullptr) {
+                return size;
+            }
+            pos = static_cast<size_t>(static_cast<const byte_t*>(hit) - base);
+
+            size_t consumed = 0;
+            auto result = _decode(buffer.subspan(pos), consumed, nullptr);
+            if (result) {
+                if (on_frame) {
+                    on_frame(*result);
+                }
+                pos += consumed;
+                continue;
+            }
+
+            // 候选帧不完整：若其后还有可通过校验的完整帧，说明它是噪声中的 0xAA；
+            // 否则保留等待更多数据
+            if (result.error().code() == error_code_t::incomplete_frame) {
+                size_t next = _find_valid_frame(buffer, pos + 1);
+                if (next == size) {
+                    break;
+                }
+                pos = next;
+                continue;
+            }
+
+            // 长度或 CRC 无效：这是噪声中的 0xAA，从下一字节继续查找
+            ++pos;
+        }
+
+        return pos;
+    }
+
+    size_t frame_length(const_byte_span_t buffer) const override {
+        if (buffer.size() < 3) {
+            return 0;
+        }
+
+        if (buffer[0] != binary_frame::SOF) {
+            return 0;
+        }
+
+        uint16_t data_len = static_cast<uint16_t>(static_cast<uint16_t>(buffer[1]) |
+                           (static_cast<uint16_t>(buffer[2]) << 8));
+
+        size_t frame_len = binary_frame::HEADER_SIZE + data_len + 
+                          binary_frame::CRC_SIZE;
+
+        return frame_len;
+    }
+
+    stream_decoder_ptr_t make_stream_decoder() override {
+        return stream_decoder_ptr_t(new binary_stream_decoder_t(m_max_frame_size));
+    }
+
+    const char* name() const override {
+        return "binary";
+    }
+
+private:
+    /**
+     * @brief 从 start 开始查找下一个可完整通过校验的帧
+     * @return 帧起始位置，没有时返回 buffer.size()
+     */
+    size_t _find_valid_frame(const_byte_span_t buffer, size_t start) const {
+        const byte_t* base = buffer.data();
+        const size_t size = buffer.size();
+        size_t pos = start;
+
+        while (pos + binary_frame::MIN_FRAME_SIZE <= size) {
+            const void* hit = std::memchr(base + pos, binary_frame::SOF, size - pos);
+            if (hit == nullptr) {
+                break;
+            }
+            pos = static_cast<size_t>(static_cast<const byte_t*>(hit) - base);
+
+            const_byte_span_t candidate = buffer.subspan(pos);
+            size_t frame_len = frame_length(candidate);
+            if (frame_len >= binary_frame::MIN_FRAME_SIZE && frame_len <= m_max_frame_size &&
+                frame_len <= candidate.size()) {
+                uint16_t expected_crc = binary_frame::crc16(candidate.data(), frame_len - 2);
+                uint16_t actual_crc = static_cast<uint16_t>(
+                    static_cast<uint16_t>(candidate[frame_len - 2]) |
+                    (static_cast<uint16_t>(candidate[frame_len - 1]) << 8));
+                if (expected_crc == actual_crc) {
+                    return pos;
+                }
+            }
+            ++pos;
+        }
+
+        return size;
+    }
+
+    /**
+     * @brief 解码实现
+     * @param slab 非空时 buffer 为 slab 的视图，响应直接引用 slab
+     */
+    result_t<response_t> _decode(const_byte_span_t buffer, size_t& consumed,
+                                 const byte_slice_t* slab) {
         consumed = 0;
 
         // 检查最小长度
@@ -127,11 +486,9 @@ public:
         }
 
         // 查找 SOF
-        size_t sof_pos = 0;
-        while (sof_pos < buffer.size() && 
-               buffer[sof_pos] != binary_frame::SOF) {
-            ++sof_pos;
-        }
+        const void* hit = std::memchr(buffer.data(), binary_frame::SOF, buffer.size());
+        size_t sof_pos = hit ? static_cast<size_t>(static_cast<const byte_t*>(hit) - buffer.data())
+                             : buffer.size();
 
         if (sof_pos > 0) {
             consumed = sof_pos;
@@ -146,19 +503,19 @@ public:
         size_t frame_len = binary_frame::HEADER_SIZE + data_len + 
                           binary_frame::CRC_SIZE;
 
-        // 检查帧是否完整
-        if (buffer.size() < frame_len) {
-            return make_error<response_t>(error_code_t::incomplete_frame,
-                                          "Incomplete frame: need more data");
-        }
-
-        // 检查帧大小
+        // 检查帧大小（先于完整性检查，超长的伪 SOF 无需等待更多数据）
         if (frame_len > m_max_frame_size) {
             consumed = 1;  // 跳过无效的 SOF
             return make_error<response_t>(error_code_t::frame_too_large,
                                           "Frame size exceeds maximum");
         }
 
+        // 检查帧是否完整
+        if (buffer.size() < frame_len) {
+            return make_error<response_t>(error_code_t::incomplete_frame,
+                                          "Incomplete frame: need more data");
+        }
+
         // 验证 CRC
         uint16_t expected_crc = binary_frame::crc16(buffer.data(), 
                                                      frame_len - 2);
@@ -176,44 +533,26 @@ public:
         response.set_status(response_status_t::success);
         response.set_function_code(buffer[3]);
 
+        if (slab) {
+            // 数据和原始帧共享同一缓冲区，不复制
+            if (data_len > 0) {
+                response.set_data_slice(slab->subslice(binary_frame::HEADER_SIZE, data_len));
+            }
+            response.set_raw_frame_slice(slab->subslice(0, frame_len));
+            consumed = frame_len;
+            return response;
+        }
+
         if (data_len > 0) {
-            bytes_t data(data_len);
-            std::copy(buffer.begin() + 4, 
-                     buffer.begin() + 4 + data_len,
-                     data.begin());
-            response.set_data(std::move(data));
+            response.set_data(buffer.subspan(binary_frame::HEADER_SIZE, data_len));
         }
 
         // 保存原始帧
-        bytes_t raw(frame_len);
-        std::copy(buffer.begin(), buffer.begin() + frame_len, raw.begin());
-        response.set_raw_frame(std::move(raw));
+        response.set_raw_frame(buffer.first(frame_len));
 
         consumed = frame_len;
         return response;
     }
-
-    size_t frame_length(const_byte_span_t buffer) const override {
-        if (buffer.size() < 3) {
-            return 0;
-        }
-
-        if (buffer[0] != binary_frame::SOF) {
-            return 0;
-        }
-
-        uint16_t data_len = static_cast<uint16_t>(static_cast<uint16_t>(buffer[1]) |
-                           (static_cast<uint16_t>(buffer[2]) << 8));
-
-        size_t frame_len = binary_frame::HEADER_SIZE + data_len + 
-                          binary_frame::CRC_SIZE;
-
-        return frame_len;
-    }
-
-    const char* name() const override {
-        return "binary";
-    }
 };
 
 }  // namespace vdl
@@ -11,13 +11,99 @@
 #include "../core/types.hpp"
 #include "../core/error.hpp"
 #include "../core/noncopyable.hpp"
+#include "../core/buffer.hpp"
 #include "../protocol/command.hpp"
 #include "../protocol/response.hpp"
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 
 namespace vdl {
 
+// ============================================================================
+// frame_parts_t - 分段编码结果
+// ============================================================================
+
+/**
+ * @brief 分段编码的帧：头部 + 负载 + 尾部
+ * 
+ * 头部和尾部存放在内联缓冲区中，负载直接引用命令数据，
+ * 配合 i_transport_t::writev() 发送时无需拷贝负载。
+ * 
+ * @note payload 只在原命令对象存活且未修改期间有效
+ */
+struct frame_parts_t {
+    static constexpr size_t k_max_part_size = 16;   ///< 头部/尾部的最大长度
+
+    static_buffer_t<k_max_part_size> header;   ///< 帧头
+    const_byte_span_t payload;                 ///< 负载（引用命令数据）
+    static_buffer_t<k_max_part_size> trailer;  ///< 帧尾（如校验和）
+
+    /**
+     * @brief 帧的总长度
+     */
+    size_t total_size() const {
+        return header.size() + payload.size() + trailer.size();
+    }
+};
+
+/**
+ * @brief decode_all() 每解出一帧时调用的回调
+ */
+using frame_callback_t = std::function<void(response_t& response)>;
+
+// ============================================================================
+// i_stream_decoder_t - 增量流解码器接口
+// ============================================================================
+
+/**
+ * @brief 增量流解码器
+ *
+ * 与 i_codec_t 的无状态接口不同，流解码器记住已解析的帧头、期望长度和
+ * 累计校验值，每次 feed() 只处理新到的字节，帧一完整就交给回调。
+ * 大帧分多次到达时不会被反复从头检查。
+ *
+ * @code
+ * auto decoder = codec.make_stream_decoder();
+ * while (running) {
+ *     auto n = transport.read(span, 100);
+ *     decoder->feed(span.first(*n), [](response_t& resp) { handle(resp); });
+ * }
+ * @endcode
+ */
+class i_stream_decoder_t : private noncopyable_t {
+public:
+    virtual ~i_stream_decoder_t() = default;
+
+    /**
+     * @brief 输入新收到的字节
+     * @param data 新数据（调用返回后不再引用）
+     * @param on_frame 每解出一个完整帧调用一次
+     * @return 本次解出的帧数
+     *
+     * 帧前的噪声和校验失败的候选帧被跳过并计入 discarded()。
+     */
+    virtual size_t feed(const_byte_span_t data, const frame_callback_t& on_frame) = 0;
+
+    /**
+     * @brief 丢弃未完成的帧，回到初始状态
+     */
+    virtual void reset() = 0;
+
+    /**
+     * @brief 已缓存、尚未组成完整帧的字节数
+     */
+    virtual size_t buffered() const = 0;
+
+    /**
+     * @brief 累计丢弃的字节数
+     */
+    virtual size_t discarded() const = 0;
+};
+
+using stream_decoder_ptr_t = std::unique_ptr<i_stream_decoder_t>;
+
 // ============================================================================
 // i_codec_t - 编解码器接口
 // ============================================================================
@@ -49,6 +135,57 @@ public:
      */
     virtual result_t<bytes_t> encode(const command_t& cmd) = 0;
 
+    /**
+     * @brief 查询命令编码后的长度
+     * @param cmd 命令对象
+     * @return 成功返回编码长度，命令无法编码时返回错误
+     * 
+     * 默认实现调用 encode()，具体编解码器应重写以避免分配。
+     */
+    virtual result_t<size_t> encoded_size(const command_t& cmd) {
+        auto result = encode(cmd);
+        if (!result) {
+            return make_unexpected(result.error());
+        }
+        return result->size();
+    }
+
+    /**
+     * @brief 将命令编码到调用者提供的缓冲区
+     * @param cmd 命令对象
+     * @param out 输出缓冲区，长度至少为 encoded_size(cmd)
+     * @return 成功返回写入的字节数；缓冲区不足返回 invalid_size
+     * 
+     * 默认实现调用 encode() 再拷贝，具体编解码器应重写以避免分配。
+     */
+    virtual result_t<size_t> encode_into(const command_t& cmd, byte_span_t out) {
+        auto result = encode(cmd);
+        if (!result) {
+            return make_unexpected(result.error());
+        }
+        if (result->size() > out.size()) {
+            return make_error<size_t>(error_code_t::invalid_size,
+                                      "Output buffer too small for encoded frame");
+        }
+        std::copy(result->begin(), result->end(), out.begin());
+        return result->size();
+    }
+
+    /**
+     * @brief 分段编码命令（不拷贝负载）
+     * @param cmd 命令对象，在 parts 使用完毕前必须保持有效
+     * @param parts [out] 编码结果
+     * @return 成功返回 ok；编解码器不支持分段编码时返回 not_supported
+     * 
+     * 默认不支持，调用者应回退到 encode()。
+     */
+    virtual result_t<void> encode_parts(const command_t& cmd, frame_parts_t& parts) {
+        (void)cmd;
+        (void)parts;
+        return make_error_void(error_code_t::not_supported,
+                               "Codec does not support scatter encoding");
+    }
+
     // ========================================================================
     // 解码
     // ========================================================================
@@ -64,6 +201,49 @@ public:
     virtual result_t<response_t> decode(const_byte_span_t buffer, 
                                          size_t& consumed) = 0;
 
+    /**
+     * @brief 一次性解出缓冲区中的所有完整帧
+     * @param buffer 输入缓冲区
+     * @param on_frame 每个成功解码的响应调用一次
+     * @return 已消耗的字节数（完整帧与无效数据）；末尾不完整的帧不计入
+     * 
+     * 帧前的噪声、校验失败的候选帧会被跳过，调用者只需丢弃返回的字节数，
+     * 保留其余字节等待更多数据。
+     */
+    virtual size_t decode_all(const_byte_span_t buffer, const frame_callback_t& on_frame) {
+        size_t pos = 0;
+        while (pos < buffer.size()) {
+            size_t consumed = 0;
+            auto result = decode(buffer.subspan(pos), consumed);
+            if (result) {
+                if (on_frame) {
+                    on_frame(*result);
+                }
+                pos += consumed;
+                continue;
+            }
+            if (result.error().code() == error_code_t::incomplete_frame || consumed == 0) {
+                break;
+            }
+            pos += consumed;
+        }
+        return pos;
+    }
+
+    /**
+     * @brief 从共享切片解码完整帧
+     * @param frame 恰好包含一个完整帧的共享切片
+     * @param consumed [out] 消耗的字节数
+     * @return 成功返回响应对象
+     * 
+     * 实现可以让响应的数据和原始帧直接引用 frame 的底层缓冲区，
+     * 避免复制。默认实现调用 decode()（会复制）。
+     */
+    virtual result_t<response_t> decode_slice(const byte_slice_t& frame,
+                                               size_t& consumed) {
+        return decode(frame.view(), consumed);
+    }
+
     /**
      * @brief 检查缓冲区是否包含完整帧
      * @param buffer 输入缓冲区
@@ -71,6 +251,28 @@ public:
      */
     virtual size_t frame_length(const_byte_span_t buffer) const = 0;
 
+    /**
+     * @brief 从完整帧中提取关联键
+     * @param frame 完整的请求帧或响应帧
+     * @return 关联键；协议没有关联字段时返回空
+     * 
+     * 流水线执行（execute_async）时，请求帧和响应帧都会调用此方法，
+     * 键相同的响应分发给对应请求；返回空时按 FIFO 顺序匹配。
+     */
+    virtual optional_t<uint32_t> correlation_key(const_byte_span_t frame) const {
+        (void)frame;
+        return tl::nullopt;
+    }
+
+    /**
+     * @brief 创建增量流解码器
+     * @return 流解码器，引用本编解码器，不能存活到编解码器销毁之后
+     *
+     * 默认实现包装无状态的 frame_length()/decode_slice()（见 codec_stream_decoder_t），
+     * 能按字节维护帧状态的编解码器可以提供原生实现。
+     */
+    virtual stream_decoder_ptr_t make_stream_decoder();
+
     // ========================================================================
     // 配置
     // ========================================================================
@@ -118,6 +320,120 @@ protected:
     size_t m_max_frame_size = 65536;
 };
 
+// ============================================================================
+// codec_stream_decoder_t - 无状态编解码器的流解码适配器
+// ============================================================================
+
+/**
+ * @brief 把无状态编解码器包装为流解码器
+ *
+ * 未完成的字节缓存在内部缓冲区中。frame_length() 给出的长度会被记住，
+ * 缓存不足该长度前不再调用编解码器；帧头无法识别时调用 decode() 跳过无效数据。
+ */
+class codec_stream_decoder_t : public i_stream_decoder_t {
+public:
+    /**
+     * @brief 构造函数
+     * @param codec 被包装的编解码器（须比解码器存活更久）
+     */
+    explicit codec_stream_decoder_t(i_codec_t& codec)
+        : m_codec(codec) {
+    }
+
+    size_t feed(const_byte_span_t data, const frame_callback_t& on_frame) override {
+        m_buffer.insert(m_buffer.end(), data.begin(), data.end());
+        if (m_expected > m_buffer.size()) {
+            return 0;
+        }
+        m_expected = 0;
+
+        size_t frames = 0;
+        size_t pos = 0;
+        while (pos < m_buffer.size()) {
+            const_byte_span_t pending(m_buffer.data() + pos, m_buffer.size() - pos);
+            const size_t frame_len = m_codec.frame_length(pending);
+
+            if (frame_len > pending.size() && frame_len <= m_codec.max_frame_size()) {
+                m_expected = frame_len;
+                break;
+            }
+
+            if (frame_len > 0 && frame_len <= pending.size()) {
+                byte_slice_t slab(bytes_t(pending.begin(), pending.begin() + frame_len));
+                size_t consumed = 0;
+                auto result = m_codec.decode_slice(slab, consumed);
+                if (consumed == 0) {
+                    consumed = frame_len;
+                }
+                if (result) {
+                    ++frames;
+                    if (on_frame) {
+                        on_frame(*result);
+                    }
+                } else {
+                    m_discarded += consumed;
+                }
+                pos += consumed;
+                continue;
+            }
+
+            // 帧头无法识别或长度超限：让编解码器跳过无效数据
+            size_t skipped = 0;
+            auto result = m_codec.decode(pending, skipped);
+            if (result && skipped > 0) {
+                ++frames;
+                if (on_frame) {
+                    on_frame(*result);
+                }
+                pos += skipped;
+                continue;
+            }
+            if (!result && skipped > 0 &&
+                result.error().code() != error_code_t::incomplete_frame) {
+                m_discarded += skipped;
+                pos += skipped;
+                continue;
+            }
+            break;
+        }
+
+        if (pos > 0) {
+            m_buffer.erase(m_buffer.begin(), m_buffer.begin() + static_cast<std::ptrdiff_t>(pos));
+        }
+
+        // 缓存超过最大帧长仍没有完整帧：整体丢弃
+        if (m_buffer.size() > m_codec.max_frame_size()) {
+            m_discarded += m_buffer.size();
+            m_buffer.clear();
+            m_expected = 0;
+        }
+        return frames;
+    }
+
+    void reset() override {
+        m_buffer.clear();
+        m_expected = 0;
+    }
+
+    size_t buffered() const override {
+        return m_buffer.size();
+    }
+
+    size_t discarded() const override {
+        return m_discarded;
+    }
+
+private:
+    i_codec_t& m_codec;
+    bytes_t m_buffer;           ///< 未完成的字节
+    size_t m_expected = 0;      ///< 已知的帧长度（缓存不足时等待）
+    size_t m_discarded = 0;
+};
+
+inline stream_decoder_ptr_t i_codec_t::make_stream_decoder() {
+    return stream_decoder_ptr_t(new codec_stream_decoder_t(*this));
+}
+
 }  // namespace vdl
 
 #endif  // VDL_CODEC_CODEC_HPP
@@ -0,0 +1,312 @@
+/**
+ * @file crc16.hpp
+ * @brief CRC16 校验
+ *
+ * 提供查表法实现的两种 CRC16：
+ * - crc16_ccitt_t: CRC-16/CCITT-FALSE（多项式 0x1021，初值 0xFFFF，不反射，slicing-by-8）
+ * - crc16_modbus_t: CRC-16/MODBUS（多项式 0x8005 反射为 0xA001，初值 0xFFFF，单表逐字节）
+ */
+
+#ifndef VDL_CODEC_CRC16_HPP
+#define VDL_CODEC_CRC16_HPP
+
+#include "../core/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vdl {
+
+namespace detail {
+
+// ============================================================================
+// 编译期生成的查找表
+// ============================================================================
+
+template<size_t... I>
+struct crc_index_sequence_t {};
+
+template<size_t N, size_t... I>
+struct make_crc_index_sequence_t : make_crc_index_sequence_t<N - 1, N - 1, I...> {};
+
+template<size_t... I>
+struct make_crc_index_sequence_t<0, I...> {
+    using type = crc_index_sequence_t<I...>;
+};
+
+// 逐位处理一位
+constexpr uint16_t crc16_ccitt_bit(uint16_t crc) {
+    return (crc & 0x8000) ? static_cast<uint16_t>(static_cast<uint16_t>(crc << 1) ^ 0x1021)
+                          : static_cast<uint16_t>(crc << 1);
+}
+
+constexpr uint16_t crc16_ccitt_bits(uint16_t crc, int count) {
+    return count == 0 ? crc : crc16_ccitt_bits(crc16_ccitt_bit(crc), count - 1);
+}
+
+// T0[i]：单个字节 i 的余数
+constexpr uint16_t crc16_ccitt_entry0(size_t i) {
+    return crc16_ccitt_bits(static_cast<uint16_t>(i << 8), 8);
+}
+
+// 在余数后追加一个零字节
+constexpr uint16_t crc16_ccitt_advance(uint16_t crc) {
+    return static_cast<uint16_t>(static_cast<uint16_t>(crc << 8) ^
+                                 crc16_ccitt_entry0(static_cast<size_t>(crc >> 8)));
+}
+
+// Tk[i]：字节 i 之后再跟 k 个零字节的余数
+constexpr uint16_t crc16_ccitt_entry(size_t k, size_t i) {
+    return k == 0 ? crc16_ccitt_entry0(i) : crc16_ccitt_advance(crc16_ccitt_entry(k - 1, i));
+}
+
+struct crc16_table_set_t {
+    uint16_t t[8][256];
+};
+
+template<size_t... I>
+constexpr crc16_table_set_t make_crc16_ccitt_tables(crc_index_sequence_t<I...>) {
+    return crc16_table_set_t{{
+        {crc16_ccitt_entry(0, I)...},
+        {crc16_ccitt_entry(1, I)...},
+        {crc16_ccitt_entry(2, I)...},
+        {crc16_ccitt_entry(3, I)...},
+        {crc16_ccitt_entry(4, I)...},
+        {crc16_ccitt_entry(5, I)...},
+        {crc16_ccitt_entry(6, I)...},
+        {crc16_ccitt_entry(7, I)...},
+    }};
+}
+
+// 模板化以便在头文件中定义静态成员
+template<typename Dummy = void>
+struct crc16_ccitt_tables_t {
+    static constexpr crc16_table_set_t value =
+        make_crc16_ccitt_tables(make_crc_index_sequence_t<256>::type());
+};
+
+template<typename Dummy>
+constexpr crc16_table_set_t crc16_ccitt_tables_t<Dummy>::value;
+
+// ============================================================================
+// CRC-16/MODBUS 查找表
+// ============================================================================
+
+// 反射算法逐位处理一位
+constexpr uint16_t crc16_modbus_bit(uint16_t crc) {
+    return (crc & 0x0001) ? static_cast<uint16_t>(static_cast<uint16_t>(crc >> 1) ^ 0xA001)
+                          : static_cast<uint16_t>(crc >> 1);
+}
+
+constexpr uint16_t crc16_modbus_bits(uint16_t crc, int count) {
+    return count == 0 ? crc : crc16_modbus_bits(crc16_modbus_bit(crc), count - 1);
+}
+
+struct crc16_table_t {
+    uint16_t t[256];
+};
+
+template<size_t... I>
+constexpr crc16_table_t make_crc16_modbus_table(crc_index_sequence_t<I...>) {
+    return crc16_table_t{{crc16_modbus_bits(static_cast<uint16_t>(I), 8)...}};
+}
+
+template<typename Dummy = void>
+struct crc16_modbus_table_t {
+    static constexpr crc16_table_t value =
+        make_crc16_modbus_table(make_crc_index_sequence_t<256>::type());
+};
+
+template<typename Dummy>
+constexpr crc16_table_t crc16_modbus_table_t<Dummy>::value;
+
+}  // namespace detail
+
+// ============================================================================
+// crc16_ccitt_t - CRC16-CCITT 计算器
+// ============================================================================
+
+/**
+ * @brief CRC16-CCITT 计算器，支持增量更新
+ *
+ * 每 8 字节查 8 张表（slicing-by-8），尾部逐字节查表，
+ * 结果与逐位算法完全一致。
+ *
+ * @code
+ * // 一次性计算
+ * uint16_t crc = crc16_ccitt_t::compute(frame.data(), frame.size());
+ *
+ * // 流式计算（数据分段到达）
+ * crc16_ccitt_t crc;
+ * crc.update(header, 4);
+ * crc.update(payload.data(), payload.size());
+ * uint16_t value = crc.value();
+ * @endcode
+ */
+class crc16_ccitt_t {
+public:
+    crc16_ccitt_t() : m_crc(0xFFFF) {}
+
+    explicit crc16_ccitt_t(uint16_t init) : m_crc(init) {}
+
+    /**
+     * @brief 追加数据
+     */
+    crc16_ccitt_t& update(const byte_t* data, size_t len) {
+        m_crc = update(m_crc, data, len);
+        return *this;
+    }
+
+    crc16_ccitt_t& update(const_byte_span_t data) {
+        return update(data.data(), data.size());
+    }
+
+    crc16_ccitt_t& update(byte_t b) {
+        m_crc = _step(m_crc, b);
+        return *this;
+    }
+
+    /**
+     * @brief 当前 CRC 值
+     */
+    uint16_t value() const {
+        return m_crc;
+    }
+
+    /**
+     * @brief 重置为初值
+     */
+    void reset(uint16_t init = 0xFFFF) {
+        m_crc = init;
+    }
+
+    /**
+     * @brief 在已有 CRC 值上追加数据
+     */
+    static uint16_t update(uint16_t crc, const byte_t* data, size_t len) {
+        const auto& tables = detail::crc16_ccitt_tables_t<>::value.t;
+
+        while (len >= 8) {
+            crc = static_cast<uint16_t>(
+                tables[7][static_cast<byte_t>(crc >> 8) ^ data[0]] ^
+                tables[6][static_cast<byte_t>(crc & 0xFF) ^ data[1]] ^
+                tables[5][data[2]] ^
+                tables[4][data[3]] ^
+                tables[3][data[4]] ^
+                tables[2][data[5]] ^
+                tables[1][data[6]] ^
+                tables[0][data[7]]);
+            data += 8;
+            len -= 8;
+        }
+
+        while (len > 0) {
+            crc = _step(crc, *data);
+            ++data;
+            --len;
+        }
+        return crc;
+    }
+
+    /**
+     * @brief 计算数据的 CRC（初值 0xFFFF）
+     */
+    static uint16_t compute(const byte_t* data, size_t len) {
+        return update(0xFFFF, data, len);
+    }
+
+    /**
+     * @brief 逐位参考实现（用于校验）
+     */
+    static uint16_t compute_bitwise(const byte_t* data, size_t len) {
+        uint16_t crc = 0xFFFF;
+        for (size_t i = 0; i < len; ++i) {
+            crc ^= static_cast<uint16_t>(static_cast<uint16_t>(data[i]) << 8);
+            crc = detail::crc16_ccitt_bits(crc, 8);
+        }
+        return crc;
+    }
+
+private:
+    static uint16_t _step(uint16_t crc, byte_t b) {
+        const auto& t0 = detail::crc16_ccitt_tables_t<>::value.t[0];
+        return static_cast<uint16_t>(static_cast<uint16_t>(crc << 8) ^
+                                     t0[static_cast<byte_t>(crc >> 8) ^ b]);
+    }
+
+    uint16_t m_crc;
+};
+
+// ============================================================================
+// crc16_modbus_t - CRC-16/MODBUS 计算器
+// ============================================================================
+
+/**
+ * @brief CRC-16/MODBUS 计算器（Modbus RTU 帧校验），支持增量更新
+ *
+ * 帧中按低字节在前的顺序发送。
+ *
+ * @code
+ * uint16_t crc = crc16_modbus_t::compute(adu, len);
+ * adu[len] = static_cast<byte_t>(crc & 0xFF);
+ * adu[len + 1] = static_cast<byte_t>(crc >> 8);
+ * @endcode
+ */
+class crc16_modbus_t {
+public:
+    crc16_modbus_t() : m_crc(0xFFFF) {}
+
+    crc16_modbus_t& update(const byte_t* data, size_t len) {
+        m_crc = update(m_crc, data, len);
+        return *this;
+    }
+
+    crc16_modbus_t& update(const_byte_span_t data) {
+        return update(data.data(), data.size());
+    }
+
+    uint16_t value() const {
+        return m_crc;
+    }
+
+    void reset() {
+        m_crc = 0xFFFF;
+    }
+
+    /**
+     * @brief 在已有 CRC 值上追加数据
+     */
+    static uint16_t update(uint16_t crc, const byte_t* data, size_t len) {
+        const auto& table = detail::crc16_modbus_table_t<>::value.t;
+        for (size_t i = 0; i < len; ++i) {
+            crc = static_cast<uint16_t>(static_cast<uint16_t>(crc >> 8) ^
+                                        table[static_cast<byte_t>(crc ^ data[i])]);
+        }
+        return crc;
+    }
+
+    /**
+     * @brief 计算数据的 CRC（初值 0xFFFF）
+     */
+    static uint16_t compute(const byte_t* data, size_t len) {
+        return update(0xFFFF, data, len);
+    }
+
+    /**
+     * @brief 逐位参考实现（用于校验）
+     */
+    static uint16_t compute_bitwise(const byte_t* data, size_t len) {
+        uint16_t crc = 0xFFFF;
+        for (size_t i = 0; i < len; ++i) {
+            crc = detail::crc16_modbus_bits(static_cast<uint16_t>(crc ^ data[i]), 8);
+        }
+        return crc;
+    }
+
+private:
+    uint16_t m_crc;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CODEC_CRC16_HPP
@@ -0,0 +1,727 @@
+/**
+ * @file frame_layout.hpp
+ * @brief 编译期声明的帧格式
+ *
+ * 用字段类型列表描述帧格式（标志、长度、功能码、负载、校验和），
+ * 字段偏移在编译期算出，编码、frame_length() 和解码都展开为直线代码。
+ * 新协议只需声明一个 frame_layout_t，不必再手写 i_codec_t 子类。
+ *
+ * @code
+ * // 与 binary_codec_t 相同的帧: SOF | LEN(LE16) | FUNC | DATA | CRC16(LE)
+ * typedef layout::frame_layout_t<
+ *     layout::marker_t<0xAA>,
+ *     layout::length_t<2>,
+ *     layout::function_t,
+ *     layout::payload_t,
+ *     layout::checksum_t<layout::crc16_ccitt_policy_t>
+ * > my_layout_t;
+ *
+ * layout_codec_t<my_layout_t> codec("my_protocol");
+ * @endcode
+ */
+
+#ifndef VDL_CODEC_FRAME_LAYOUT_HPP
+#define VDL_CODEC_FRAME_LAYOUT_HPP
+
+#include "codec.hpp"
+#include "crc16.hpp"
+#include "../core/buffer.hpp"
+#include "../core/memory.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+namespace vdl {
+
+namespace layout {
+
+namespace detail {
+
+enum class field_kind_t : uint8_t {
+    marker,
+    length,
+    function,
+    payload,
+    checksum
+};
+
+/**
+ * @brief 固定宽度无符号整数的读写
+ */
+template <size_t Width, byte_order_t Order>
+struct uint_field_t {
+    static_assert(Width >= 1 && Width <= 4, "Integer field width must be 1..4 bytes");
+    static_assert(Order != byte_order_t::native, "Wire fields need an explicit byte order");
+
+    static constexpr uint32_t max_value() {
+        return static_cast<uint32_t>((static_cast<uint64_t>(1) << (8 * Width)) - 1);
+    }
+
+    static void store(byte_t* p, uint32_t value) {
+        for (size_t i = 0; i < Width; ++i) {
+            const size_t shift = 8 * (Order == byte_order_t::little ? i : Width - 1 - i);
+            p[i] = static_cast<byte_t>((value >> shift) & 0xFF);
+        }
+    }
+
+    static uint32_t load(const byte_t* p) {
+        uint32_t value = 0;
+        for (size_t i = 0; i < Width; ++i) {
+            const size_t shift = 8 * (Order == byte_order_t::little ? i : Width - 1 - i);
+            value |= static_cast<uint32_t>(p[i]) << shift;
+        }
+        return value;
+    }
+};
+
+/**
+ * @brief 帧的三段：头部（负载之前的字段）、负载、尾部（负载之后的字段）
+ *
+ * 连续帧和分段帧（frame_parts_t）都用它表示，校验和按逻辑偏移跨段计算。
+ */
+struct frame_segments_t {
+    const byte_t* header;
+    size_t header_size;
+    const byte_t* payload;
+    size_t payload_size;
+    const byte_t* trailer;
+
+    /**
+     * @brief 对逻辑区间 [from, to) 计算校验和
+     */
+    template <typename Policy>
+    typename Policy::value_type checksum(size_t from, size_t to) const {
+        typename Policy::value_type value = Policy::init();
+        const size_t payload_end = header_size + payload_size;
+        if (from < header_size) {
+            const size_t end = to < header_size ? to : header_size;
+            value = Policy::update(value, header + from, end - from);
+        }
+        if (to > header_size && from < payload_end) {
+            const size_t begin = from > header_size ? from : header_size;
+            const size_t end = to < payload_end ? to : payload_end;
+            value = Policy::update(value, payload + (begin - header_size), end - begin);
+        }
+        if (to > payload_end) {
+            const size_t begin = from > payload_end ? from : payload_end;
+            value = Policy::update(value, trailer + (begin - payload_end), to - begin);
+        }
+        return value;
+    }
+};
+
+// 类型列表工具（C++11，无 constexpr 循环）
+
+template <size_t I, typename... Ts>
+struct type_at_t;
+
+template <typename T, typename... Ts>
+struct type_at_t<0, T, Ts...> {
+    typedef T type;
+};
+
+template <size_t I, typename T, typename... Ts>
+struct type_at_t<I, T, Ts...> : type_at_t<I - 1, Ts...> {};
+
+/**
+ * @brief 前 N 个字段的固定长度之和
+ */
+template <size_t N, typename... Ts>
+struct size_before_t : std::integral_constant<size_t, 0> {};
+
+template <size_t N, typename T, typename... Ts>
+struct size_before_t<N, T, Ts...>
+    : std::integral_constant<size_t, (N > 0 ? T::size + size_before_t<(N > 0 ? N - 1 : 0), Ts...>::value
+                                            : 0)> {};
+
+/**
+ * @brief 第一个 kind 字段的序号（不存在时为字段个数）
+ */
+template <field_kind_t K, typename... Ts>
+struct index_of_t : std::integral_constant<size_t, 0> {};
+
+template <field_kind_t K, typename T, typename... Ts>
+struct index_of_t<K, T, Ts...>
+    : std::integral_constant<size_t, (T::kind == K ? 0 : 1 + index_of_t<K, Ts...>::value)> {};
+
+template <field_kind_t K, typename... Ts>
+struct count_of_t : std::integral_constant<size_t, 0> {};
+
+template <field_kind_t K, typename T, typename... Ts>
+struct count_of_t<K, T, Ts...>
+    : std::integral_constant<size_t, (T::kind == K ? 1 : 0) + count_of_t<K, Ts...>::value> {};
+
+/**
+ * @brief 字段的默认行为（无数据可写、总是匹配）
+ */
+struct field_base_t {
+    static void write(byte_t*, const command_t&, size_t) {}
+    static bool matches(const byte_t*) { return true; }
+    static void seal(byte_t*, const frame_segments_t&, size_t) {}
+    static bool verify(const byte_t*, const frame_segments_t&, size_t) { return true; }
+};
+
+}  // namespace detail
+
+// ============================================================================
+// 字段
+// ============================================================================
+
+/**
+ * @brief 常量标志（帧起始/结束符等），解码时逐字节比对
+ */
+template <byte_t... Bytes>
+struct marker_t : detail::field_base_t {
+    static_assert(sizeof...(Bytes) > 0, "Marker needs at least one byte");
+
+    static constexpr detail::field_kind_t kind = detail::field_kind_t::marker;
+    static constexpr size_t size = sizeof...(Bytes);
+
+    static constexpr byte_t first_byte() {
+        return detail::type_at_t<0, std::integral_constant<byte_t, Bytes>...>::type::value;
+    }
+
+    static void write(byte_t* p, const command_t&, size_t) {
+        const byte_t value[] = {Bytes...};
+        std::memcpy(p, value, sizeof(value));
+    }
+
+    static bool matches(const byte_t* p) {
+        const byte_t value[] = {Bytes...};
+        return std::memcmp(p, value, sizeof(value)) == 0;
+    }
+};
+
+/**
+ * @brief 负载长度字段
+ * @tparam Width 宽度（1..4 字节）
+ * @tparam Order 字节序（vdl::byte_order_t，little 或 big）
+ * @tparam Bias 线上值 = 负载长度 + Bias（长度字段还计入其他字段时使用）
+ */
+template <size_t Width, byte_order_t Order = byte_order_t::little, size_t Bias = 0>
+struct length_t : detail::field_base_t {
+    static constexpr detail::field_kind_t kind = detail::field_kind_t::length;
+    static constexpr size_t size = Width;
+
+    static_assert(Bias < detail::uint_field_t<Width, Order>::max_value(),
+                  "Length bias leaves no room for payload");
+
+    /**
+     * @brief 可表示的最大负载长度
+     */
+    static constexpr size_t max_payload() {
+        return detail::uint_field_t<Width, Order>::max_value() - Bias;
+    }
+
+    static void write(byte_t* p, const command_t&, size_t payload_size) {
+        detail::uint_field_t<Width, Order>::store(p, static_cast<uint32_t>(payload_size + Bias));
+    }
+
+    /**
+     * @brief 读出的负载长度，线上值小于 Bias 时返回 false
+     */
+    static bool read(const byte_t* p, size_t& payload_size) {
+        const size_t wire = detail::uint_field_t<Width, Order>::load(p);
+        if (wire < Bias) {
+            return false;
+        }
+        payload_size = wire - Bias;
+        return true;
+    }
+};
+
+/**
+ * @brief 功能码（1 字节）
+ */
+struct function_t : detail::field_base_t {
+    static constexpr detail::field_kind_t kind = detail::field_kind_t::function;
+    static constexpr size_t size = 1;
+
+    static void write(byte_t* p, const command_t& cmd, size_t) {
+        *p = cmd.function_code();
+    }
+};
+
+/**
+ * @brief 负载（命令/响应数据），长度由 length_t 给出
+ */
+struct payload_t : detail::field_base_t {
+    static constexpr detail::field_kind_t kind = detail::field_kind_t::payload;
+    static constexpr size_t size = 0;
+};
+
+/**
+ * @brief 校验和字段
+ * @tparam Policy 校验算法（见下方 *_policy_t）
+ * @tparam Order 字节序
+ * @tparam Skip 从帧首跳过的字节数（如不计入起始标志）
+ *
+ * 覆盖 [Skip, 本字段偏移) 的全部字节，包括之前的校验和字段。
+ */
+template <typename Policy, byte_order_t Order = byte_order_t::little, size_t Skip = 0>
+struct checksum_t : detail::field_base_t {
+    static constexpr detail::field_kind_t kind = detail::field_kind_t::checksum;
+    static constexpr size_t size = Policy::size;
+    static constexpr size_t skip = Skip;
+
+    static void seal(byte_t* p, const detail::frame_segments_t& frame, size_t offset) {
+        detail::uint_field_t<Policy::size, Order>::store(
+            p, static_cast<uint32_t>(frame.template checksum<Policy>(Skip, offset)));
+    }
+
+    static bool verify(const byte_t* p, const detail::frame_segments_t& frame, size_t offset) {
+        return detail::uint_field_t<Policy::size, Order>::load(p) ==
+               static_cast<uint32_t>(frame.template checksum<Policy>(Skip, offset));
+    }
+};
+
+// ============================================================================
+// 校验算法
+// ============================================================================
+
+/**
+ * @brief CRC-16/CCITT-FALSE（binary_codec_t 使用）
+ */
+struct crc16_ccitt_policy_t {
+    typedef uint16_t value_type;
+    static constexpr size_t size = 2;
+
+    static value_type init() { return 0xFFFF; }
+
+    static value_type update(value_type crc, const byte_t* data, size_t len) {
+        return crc16_ccitt_t::update(crc, data, len);
+    }
+};
+
+/**
+ * @brief CRC-16/MODBUS
+ */
+struct crc16_modbus_policy_t {
+    typedef uint16_t value_type;
+    static constexpr size_t size = 2;
+
+    static value_type init() { return 0xFFFF; }
+
+    static value_type update(value_type crc, const byte_t* data, size_t len) {
+        return crc16_modbus_t::update(crc, data, len);
+    }
+};
+
+/**
+ * @brief 8 位累加和
+ */
+struct sum8_policy_t {
+    typedef uint8_t value_type;
+    static constexpr size_t size = 1;
+
+    static value_type init() { return 0; }
+
+    static value_type update(value_type sum, const byte_t* data, size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            sum = static_cast<value_type>(sum + data[i]);
+        }
+        return sum;
+    }
+};
+
+/**
+ * @brief 8 位异或和
+ */
+struct xor8_policy_t {
+    typedef uint8_t value_type;
+    static constexpr size_t size = 1;
+
+    static value_type init() { return 0; }
+
+    static value_type update(value_type sum, const byte_t* data, size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            sum = static_cast<value_type>(sum ^ data[i]);
+        }
+        return sum;
+    }
+};
+
+// ============================================================================
+// frame_layout_t - 帧格式
+// ============================================================================
+
+namespace detail {
+
+/**
+ * @brief 逐字段展开的操作（I 为编译期序号，递归在编译期完成）
+ */
+template <typename Layout, size_t I, size_t N>
+struct field_walker_t {
+    typedef typename Layout::template field_at<I>::type field_type;
+    typedef field_walker_t<Layout, I + 1, N> next_t;
+
+    static constexpr bool in_trailer = I > Layout::payload_index;
+    static constexpr size_t offset = Layout::template field_offset<I>::value;
+
+    /**
+     * @brief 字段在所属段中的位置
+     */
+    static byte_t* locate(byte_t* header, byte_t* trailer) {
+        return in_trailer ? trailer + (offset - Layout::header_size) : header + offset;
+    }
+
+    static const byte_t* locate(const byte_t* header, const byte_t* trailer) {
+        return in_trailer ? trailer + (offset - Layout::header_size) : header + offset;
+    }
+
+    static size_t logical_offset(size_t payload_size) {
+        return in_trailer ? offset + payload_size : offset;
+    }
+
+    static void write(byte_t* header, byte_t* trailer, const command_t& cmd, size_t payload_size) {
+        field_type::write(locate(header, trailer), cmd, payload_size);
+        next_t::write(header, trailer, cmd, payload_size);
+    }
+
+    static void seal(byte_t* header, byte_t* trailer, const frame_segments_t& frame) {
+        field_type::seal(locate(header, trailer), frame, logical_offset(frame.payload_size));
+        next_t::seal(header, trailer, frame);
+    }
+
+    static bool matches(const byte_t* header, const byte_t* trailer, bool trailer_part) {
+        return (in_trailer != trailer_part || field_type::matches(locate(header, trailer))) &&
+               next_t::matches(header, trailer, trailer_part);
+    }
+
+    static bool verify(const frame_segments_t& frame) {
+        return field_type::verify(locate(frame.header, frame.trailer), frame,
+                                  logical_offset(frame.payload_size)) &&
+               next_t::verify(frame);
+    }
+};
+
+template <typename Layout, size_t N>
+struct field_walker_t<Layout, N, N> {
+    static void write(byte_t*, byte_t*, const command_t&, size_t) {}
+    static void seal(byte_t*, byte_t*, const frame_segments_t&) {}
+    static bool matches(const byte_t*, const byte_t*, bool) { return true; }
+    static bool verify(const frame_segments_t&) { return true; }
+};
+
+}  // namespace detail
+
+/**
+ * @brief 由字段列表声明的帧格式
+ *
+ * 必须恰好包含一个 payload_t 和一个位于其前的 length_t；
+ * 负载之前的字段构成帧头，之后的构成帧尾，两者的长度都是编译期常量。
+ * 所有操作都是静态函数，可以不经虚函数直接调用。
+ */
+template <typename... Fields>
+class frame_layout_t {
+public:
+    template <size_t I>
+    struct field_at : detail::type_at_t<I, Fields...> {};
+
+    template <size_t I>
+    struct field_offset : detail::size_before_t<I, Fields...> {};
+
+    static constexpr size_t field_count = sizeof...(Fields);
+    static constexpr size_t payload_index =
+        detail::index_of_t<detail::field_kind_t::payload, Fields...>::value;
+    static constexpr size_t length_index =
+        detail::index_of_t<detail::field_kind_t::length, Fields...>::value;
+    static constexpr size_t function_index =
+        detail::index_of_t<detail::field_kind_t::function, Fields...>::value;
+
+    static_assert(detail::count_of_t<detail::field_kind_t::payload, Fields...>::value == 1,
+                  "Layout needs exactly one payload_t");
+    static_assert(detail::count_of_t<detail::field_kind_t::length, Fields...>::value == 1,
+                  "Layout needs exactly one length_t");
+    static_assert(length_index < payload_index, "length_t must precede payload_t");
+    static_assert(detail::count_of_t<detail::field_kind_t::function, Fields...>::value <= 1,
+                  "Layout has more than one function_t");
+
+    typedef typename field_at<length_index>::type length_type;
+
+    static constexpr size_t header_size = field_offset<payload_index>::value;       ///< 帧头长度
+    static constexpr size_t fixed_size = field_offset<field_count>::value;          ///< 除负载外的长度
+    static constexpr size_t trailer_size = fixed_size - header_size;                ///< 帧尾长度
+    static constexpr size_t length_offset = field_offset<length_index>::value;
+    static constexpr bool has_function = function_index < field_count;
+
+    /**
+     * @brief 可表示的最大负载长度
+     */
+    static constexpr size_t max_payload_size() {
+        return length_type::max_payload();
+    }
+
+    /**
+     * @brief 负载为 payload_size 时的帧长度
+     */
+    static constexpr size_t frame_size(size_t payload_size) {
+        return fixed_size + payload_size;
+    }
+
+    /**
+     * @brief 编码到连续缓冲区
+     * @return 帧长度；负载过长或缓冲区不足时返回错误
+     */
+    static result_t<size_t> encode_into(const command_t& cmd, byte_span_t out) {
+        const payload_bytes_t& data = cmd.data();
+        const size_t payload_size = data.size();
+        if (payload_size > max_payload_size()) {
+            return make_error<size_t>(error_code_t::frame_too_large,
+                                      "Payload exceeds length field range");
+        }
+        // 写成不会回绕的形式，编译器据此可知负载长度有界
+        if (out.size() < fixed_size || payload_size > out.size() - fixed_size) {
+            return make_error<size_t>(error_code_t::invalid_size,
+                                      "Output buffer too small for encoded frame");
+        }
+
+        byte_t* header = out.data();
+        byte_t* trailer = header + header_size + payload_size;
+        if (payload_size > 0) {
+            std::memcpy(header + header_size, data.data(), payload_size);
+        }
+        walker_t::write(header, trailer, cmd, payload_size);
+        walker_t::seal(header, trailer, _segments(header, header + header_size, payload_size, trailer));
+        return fixed_size + payload_size;
+    }
+
+    /**
+     * @brief 分段编码（头部/尾部不超过 frame_parts_t::k_max_part_size 时可用）
+     */
+    static result_t<void> encode_parts(const command_t& cmd, frame_parts_t& parts) {
+        if (header_size > frame_parts_t::k_max_part_size ||
+            trailer_size > frame_parts_t::k_max_part_size) {
+            return make_error_void(error_code_t::not_supported,
+                                   "Frame parts exceed inline capacity");
+        }
+        const payload_bytes_t& data = cmd.data();
+        const size_t payload_size = data.size();
+        if (payload_size > max_payload_size()) {
+            return make_error_void(error_code_t::frame_too_large,
+                                   "Payload exceeds length field range");
+        }
+
+        parts.header.set_size(header_size);
+        parts.trailer.set_size(trailer_size);
+        parts.payload = const_byte_span_t(data.data(), payload_size);
+
+        byte_t* header = parts.header.data();
+        byte_t* trailer = parts.trailer.data();
+        walker_t::write(header, trailer, cmd, payload_size);
+        walker_t::seal(header, trailer, _segments(header, data.data(), payload_size, trailer));
+        return make_ok();
+    }
+
+    /**
+     * @brief 完整帧的长度（帧头不完整或标志不符时返回 0）
+     */
+    static size_t frame_length(const_byte_span_t buffer) {
+        if (buffer.size() < header_size) {
+            return 0;
+        }
+        const byte_t* header = buffer.data();
+        if (!walker_t::matches(header, nullptr, false)) {
+            return 0;
+        }
+        size_t payload_size = 0;
+        if (!length_type::read(header + length_offset, payload_size)) {
+            return 0;
+        }
+        return fixed_size + payload_size;
+    }
+
+    /**
+     * @brief 解码一帧
+     * @param slab 非空时 buffer 为 slab 的视图，响应直接引用 slab
+     * @param max_frame_size 允许的最大帧长度
+     *
+     * 与 binary_codec_t 相同：帧前有无效数据时 consumed 跳到下一个可能的帧首；
+     * 长度、标志或校验和无效时跳过 1 字节。
+     */
+    static result_t<response_t> decode(const_byte_span_t buffer, size_t& consumed,
+                                       const byte_slice_t* slab, size_t max_frame_size) {
+        consumed = 0;
+        if (buffer.size() < fixed_size) {
+            return make_error<response_t>(error_code_t::incomplete_frame,
+                                          "Incomplete frame: need more data");
+        }
+
+        const byte_t* header = buffer.data();
+        if (!walker_t::matches(header, nullptr, false)) {
+            consumed = _resync(buffer);
+            return make_error<response_t>(error_code_t::invalid_frame,
+                                          "Invalid data before frame start");
+        }
+
+        size_t payload_size = 0;
+        if (!length_type::read(header + length_offset, payload_size)) {
+            consumed = 1;
+            return make_error<response_t>(error_code_t::invalid_frame, "Invalid length field");
+        }
+
+        // 先于完整性检查，超长的伪帧头无需等待更多数据
+        const size_t frame_len = fixed_size + payload_size;
+        if (frame_len > max_frame_size) {
+            consumed = 1;
+            return make_error<response_t>(error_code_t::frame_too_large,
+                                          "Frame size exceeds maximum");
+        }
+        if (buffer.size() < frame_len) {
+            return make_error<response_t>(error_code_t::incomplete_frame,
+                                          "Incomplete frame: need more data");
+        }
+
+        const byte_t* trailer = header + header_size + payload_size;
+        if (!walker_t::matches(header, trailer, true)) {
+            consumed = 1;
+            return make_error<response_t>(error_code_t::invalid_frame, "Frame end marker mismatch");
+        }
+        if (!walker_t::verify(_segments(header, header + header_size, payload_size, trailer))) {
+            consumed = 1;
+            return make_error<response_t>(error_code_t::checksum_error, "Checksum mismatch");
+        }
+
+        response_t response;
+        response.set_status(response_status_t::success);
+        if (has_function) {
+            response.set_function_code(header[field_offset<function_index>::value]);
+        }
+
+        if (slab) {
+            if (payload_size > 0) {
+                response.set_data_slice(slab->subslice(header_size, payload_size));
+            }
+            response.set_raw_frame_slice(slab->subslice(0, frame_len));
+        } else {
+            if (payload_size > 0) {
+                response.set_data(buffer.subspan(header_size, payload_size));
+            }
+            response.set_raw_frame(buffer.first(frame_len));
+        }
+
+        consumed = frame_len;
+        return response;
+    }
+
+private:
+    typedef detail::field_walker_t<frame_layout_t, 0, field_count> walker_t;
+    typedef typename field_at<0>::type first_field_t;
+
+    static detail::frame_segments_t _segments(const byte_t* header, const byte_t* payload,
+                                              size_t payload_size, const byte_t* trailer) {
+        detail::frame_segments_t segments;
+        segments.header = header;
+        segments.header_size = header_size;
+        segments.payload = payload;
+        segments.payload_size = payload_size;
+        segments.trailer = trailer;
+        return segments;
+    }
+
+    /**
+     * @brief 帧首不符时应跳过的字节数
+     *
+     * 首字段是标志时跳到其首字节的下一次出现，否则逐字节重试。
+     */
+    static size_t _resync(const_byte_span_t buffer) {
+        return _resync(buffer, std::integral_constant<bool,
+                                   first_field_t::kind == detail::field_kind_t::marker>());
+    }
+
+    static size_t _resync(const_byte_span_t buffer, std::true_type) {
+        const void* hit = std::memchr(buffer.data() + 1, first_field_t::first_byte(),
+                                      buffer.size() - 1);
+        return hit ? static_cast<size_t>(static_cast<const byte_t*>(hit) - buffer.data())
+                   : buffer.size();
+    }
+
+    static size_t _resync(const_byte_span_t, std::false_type) {
+        return 1;
+    }
+};
+
+}  // namespace layout
+
+// ============================================================================
+// layout_codec_t - 由帧格式生成的编解码器
+// ============================================================================
+
+/**
+ * @brief 由 layout::frame_layout_t 生成的编解码器
+ *
+ * 只是把 Layout 的静态函数接到 i_codec_t 上；需要避免虚调用时直接使用 Layout。
+ */
+template <typename Layout>
+class layout_codec_t : public codec_base_t {
+public:
+    typedef Layout layout_type;
+
+    explicit layout_codec_t(const char* name = "layout")
+        : m_name(name) {
+    }
+
+    result_t<bytes_t> encode(const command_t& cmd) override {
+        auto size_result = encoded_size(cmd);
+        if (!size_result) {
+            return make_unexpected(size_result.error());
+        }
+
+        // 缓冲区取自分级池，调用者用完后可以 release() 归还
+        bytes_t frame = size_class_pool_t::instance().acquire(*size_result);
+        auto result = Layout::encode_into(cmd, byte_span_t(frame.data(), frame.size()));
+        if (!result) {
+            size_class_pool_t::instance().release(std::move(frame));
+            return make_unexpected(result.error());
+        }
+        return frame;
+    }
+
+    result_t<size_t> encoded_size(const command_t& cmd) override {
+        const size_t frame_len = Layout::frame_size(cmd.data().size());
+        if (frame_len > m_max_frame_size) {
+            return make_error<size_t>(error_code_t::frame_too_large,
+                                      "Frame size exceeds maximum");
+        }
+        return frame_len;
+    }
+
+    result_t<size_t> encode_into(const command_t& cmd, byte_span_t out) override {
+        auto size_result = encoded_size(cmd);
+        if (!size_result) {
+            return size_result;
+        }
+        return Layout::encode_into(cmd, out);
+    }
+
+    result_t<void> encode_parts(const command_t& cmd, frame_parts_t& parts) override {
+        auto size_result = encoded_size(cmd);
+        if (!size_result) {
+            return make_error_void(size_result.error());
+        }
+        return Layout::encode_parts(cmd, parts);
+    }
+
+    result_t<response_t> decode(const_byte_span_t buffer, size_t& consumed) override {
+        return Layout::decode(buffer, consumed, nullptr, m_max_frame_size);
+    }
+
+    result_t<response_t> decode_slice(const byte_slice_t& frame, size_t& consumed) override {
+        return Layout::decode(frame.view(), consumed, &frame, m_max_frame_size);
+    }
+
+    size_t frame_length(const_byte_span_t buffer) const override {
+        return Layout::frame_length(buffer);
+    }
+
+    const char* name() const override {
+        return m_name;
+    }
+
+private:
+    const char* m_name;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CODEC_FRAME_LAYOUT_HPP
@@ -0,0 +1,599 @@
+/**
+ * @file modbus_codec.hpp
+ * @brief Modbus TCP / RTU 编解码器
+ *
+ * 命令到 Modbus PDU 的映射：
+ *
+ * | 功能码              | 请求 PDU                                   | command_t 字段          |
+ * |---------------------|--------------------------------------------|-------------------------|
+ * | 0x01-0x04（读）     | FC ADDR(2) COUNT(2)                        | address, count          |
+ * | 0x05/0x06（写单个） | FC ADDR(2) VALUE(2)                        | address, data(2 字节)   |
+ * | 0x0F/0x10（写多个） | FC ADDR(2) COUNT(2) BYTES(1) DATA          | address, count, data    |
+ * | 其他                | FC DATA                                    | data（调用者组好的 PDU）|
+ *
+ * 多字节字段均为大端序。响应的数据：读功能为字节计数之后的数据，
+ * 写功能为回显的 ADDR + VALUE/COUNT；异常响应的状态为 error，
+ * error_code() 为异常码，function_code() 为去掉 0x80 标志的功能码。
+ */
+
+#ifndef VDL_CODEC_MODBUS_CODEC_HPP
+#define VDL_CODEC_MODBUS_CODEC_HPP
+
+#include "codec.hpp"
+#include "crc16.hpp"
+#include "../core/buffer.hpp"
+#include "../core/memory.hpp"
+
+#include <cstring>
+
+namespace vdl {
+
+// ============================================================================
+// Modbus 协议常量与 PDU 编解码
+// ============================================================================
+
+namespace modbus {
+
+constexpr uint8_t read_coils = 0x01;
+constexpr uint8_t read_discrete_inputs = 0x02;
+constexpr uint8_t read_holding_registers = 0x03;
+constexpr uint8_t read_input_registers = 0x04;
+constexpr uint8_t write_single_coil = 0x05;
+constexpr uint8_t write_single_register = 0x06;
+constexpr uint8_t read_exception_status = 0x07;
+constexpr uint8_t diagnostics = 0x08;
+constexpr uint8_t write_multiple_coils = 0x0F;
+constexpr uint8_t write_multiple_registers = 0x10;
+constexpr uint8_t report_server_id = 0x11;
+constexpr uint8_t mask_write_register = 0x16;
+constexpr uint8_t read_write_multiple_registers = 0x17;
+
+constexpr uint8_t exception_flag = 0x80;        ///< 异常响应的功能码标志
+
+constexpr size_t MAX_PDU_SIZE = 253;            ///< PDU 最大长度
+constexpr size_t MBAP_HEADER_SIZE = 7;          ///< MBAP 头（事务 + 协议 + 长度 + 单元）
+constexpr size_t TCP_MAX_ADU_SIZE = 260;        ///< TCP 帧最大长度
+constexpr size_t RTU_MAX_ADU_SIZE = 256;        ///< RTU 帧最大长度
+constexpr size_t CRC_SIZE = 2;
+constexpr size_t MAX_PDU_HEADER_SIZE = 6;       ///< PDU 中位于数据之前的最大长度
+
+/**
+ * @brief 返回带字节计数的响应（读功能）
+ */
+inline bool is_byte_count_response(uint8_t function_code) {
+    switch (function_code) {
+        case read_coils:
+        case read_discrete_inputs:
+        case read_holding_registers:
+        case read_input_registers:
+        case report_server_id:
+        case read_write_multiple_registers:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief 写入 PDU 中位于数据之前的部分（功能码和固定字段）
+ * @param out 至少 MAX_PDU_HEADER_SIZE 字节
+ * @return 成功返回写入长度；命令字段不合法返回 invalid_argument
+ */
+inline result_t<size_t> encode_pdu_header(const command_t& cmd, byte_t* out) {
+    const uint8_t fc = cmd.function_code();
+    const size_t data_len = cmd.data().size();
+    out[0] = fc;
+
+    switch (fc) {
+        case read_coils:
+        case read_discrete_inputs:
+        case read_holding_registers:
+        case read_input_registers: {
+            const uint16_t limit = (fc <= read_discrete_inputs) ? 2000 : 125;
+            if (cmd.count() == 0 || cmd.count() > limit || data_len != 0) {
+                return make_error<size_t>(error_code_t::invalid_argument,
+                                          "Modbus: read count out of range");
+            }
+            out[1] = static_cast<byte_t>(cmd.address() >> 8);
+            out[2] = static_cast<byte_t>(cmd.address() & 0xFF);
+            out[3] = static_cast<byte_t>(cmd.count() >> 8);
+            out[4] = static_cast<byte_t>(cmd.count() & 0xFF);
+            return static_cast<size_t>(5);
+        }
+
+        case write_single_coil:
+        case write_single_register:
+            if (data_len != 2) {
+                return make_error<size_t>(error_code_t::invalid_argument,
+                                          "Modbus: single write needs a 2-byte value");
+            }
+            out[1] = static_cast<byte_t>(cmd.address() >> 8);
+            out[2] = static_cast<byte_t>(cmd.address() & 0xFF);
+            return static_cast<size_t>(3);
+
+        case write_multiple_coils:
+        case write_multiple_registers: {
+            // 寄存器个数可由数据长度推出；线圈个数必须给出
+            uint16_t count = cmd.count();
+            if (fc == write_multiple_registers && count == 0) {
+                count = static_cast<uint16_t>(data_len / 2);
+            }
+            const size_t expected = (fc == write_multiple_registers)
+                ? static_cast<size_t>(count) * 2 : (static_cast<size_t>(count) + 7) / 8;
+            if (count == 0 || data_len != expected || data_len + 6 > MAX_PDU_SIZE) {
+                return make_error<size_t>(error_code_t::invalid_argument,
+                                          "Modbus: write count does not match data");
+            }
+            out[1] = static_cast<byte_t>(cmd.address() >> 8);
+            out[2] = static_cast<byte_t>(cmd.address() & 0xFF);
+            out[3] = static_cast<byte_t>(count >> 8);
+            out[4] = static_cast<byte_t>(count & 0xFF);
+            out[5] = static_cast<byte_t>(data_len);
+            return static_cast<size_t>(6);
+        }
+
+        default:
+            if (data_len + 1 > MAX_PDU_SIZE) {
+                return make_error<size_t>(error_code_t::frame_too_large,
+                                          "Modbus: PDU exceeds 253 bytes");
+            }
+            return static_cast<size_t>(1);
+    }
+}
+
+/**
+ * @brief 从响应 PDU 推算其长度
+ * @param pdu 已收到的 PDU 前缀
+ * @return PDU 长度；数据不足以判断时返回 0；功能码无法识别时返回 1
+ */
+inline size_t response_pdu_length(const_byte_span_t pdu) {
+    if (pdu.empty()) {
+        return 0;
+    }
+    const uint8_t fc = pdu[0];
+    if (fc & exception_flag) {
+        return 2;
+    }
+    if (is_byte_count_response(fc)) {
+        return pdu.size() < 2 ? 0 : 2 + static_cast<size_t>(pdu[1]);
+    }
+    switch (fc) {
+        case write_single_coil:
+        case write_single_register:
+        case diagnostics:
+        case write_multiple_coils:
+        case write_multiple_registers:
+            return 5;
+        case read_exception_status:
+            return 2;
+        case mask_write_register:
+            return 7;
+        default:
+            return 1;
+    }
+}
+
+/**
+ * @brief 解码响应 PDU 到 response（数据引用 slab 或被复制）
+ * @param pdu 完整的 PDU
+ * @param pdu_offset PDU 在 slab 中的偏移（slab 为空时忽略）
+ */
+inline result_t<void> decode_pdu(const_byte_span_t pdu, response_t& response,
+                                 const byte_slice_t* slab, size_t pdu_offset) {
+    const uint8_t fc = pdu[0];
+    if (fc & exception_flag) {
+        if (pdu.size() < 2) {
+            return make_error_void(error_code_t::invalid_frame, "Modbus: truncated exception");
+        }
+        response.set_status(response_status_t::error)
+                .set_function_code(static_cast<uint8_t>(fc & ~exception_flag))
+                .set_error_code(pdu[1]);
+        return make_ok();
+    }
+
+    size_t offset = 1;
+    if (is_byte_count_response(fc)) {
+        if (pdu.size() < 2 || static_cast<size_t>(pdu[1]) + 2 != pdu.size()) {
+            return make_error_void(error_code_t::invalid_frame, "Modbus: byte count mismatch");
+        }
+        offset = 2;
+    }
+
+    response.set_status(response_status_t::success).set_function_code(fc);
+    const size_t data_len = pdu.size() - offset;
+    if (data_len > 0) {
+        if (slab) {
+            response.set_data_slice(slab->subslice(pdu_offset + offset, data_len));
+        } else {
+            response.set_data(pdu.subspan(offset, data_len));
+        }
+    }
+    return make_ok();
+}
+
+}  // namespace modbus
+
+// ============================================================================
+// modbus_tcp_codec_t - Modbus TCP（MBAP）编解码器
+// ============================================================================
+
+/**
+ * @brief Modbus TCP 编解码器
+ *
+ * 每次编码分配新的事务号，correlation_key() 返回帧中的事务号，
+ * 因此 execute_async() 可以在一条连接上保持多个在途请求，
+ * 网关乱序返回时仍能分发给对应的请求。
+ *
+ * @code
+ * device_impl_t device(make_unique<tcp_transport_t>("192.168.1.100", 502),
+ *                      make_unique<modbus_tcp_codec_t>(1));
+ * device_config_t config = device.config();
+ * config.max_in_flight = 16;
+ * device.set_config(config);
+ *
+ * std::vector<async_response_t> pending;
+ * for (uint16_t block = 0; block < 16; ++block) {
+ *     pending.push_back(device.execute_async(
+ *         make_read_command(modbus::read_holding_registers, block * 100, 100)));
+ * }
+ * @endcode
+ *
+ * @note 编解码器由设备锁保护，事务号不做同步
+ */
+class modbus_tcp_codec_t : public codec_base_t {
+public:
+    explicit modbus_tcp_codec_t(uint8_t unit_id = 1)
+        : m_unit_id(unit_id) {}
+
+    // ========================================================================
+    // i_codec_t 实现
+    // ========================================================================
+
+    result_t<bytes_t> encode(const command_t& cmd) override {
+        auto size_result = encoded_size(cmd);
+        if (!size_result) {
+            return make_unexpected(size_result.error());
+        }
+        bytes_t frame = size_class_pool_t::instance().acquire(*size_result);
+        auto result = encode_into(cmd, byte_span_t(frame.data(), frame.size()));
+        if (!result) {
+            size_class_pool_t::instance().release(std::move(frame));
+            return make_unexpected(result.error());
+        }
+        return frame;
+    }
+
+    result_t<size_t> encoded_size(const command_t& cmd) override {
+        byte_t header[modbus::MAX_PDU_HEADER_SIZE];
+        auto header_len = modbus::encode_pdu_header(cmd, header);
+        if (!header_len) {
+            return header_len;
+        }
+        return modbus::MBAP_HEADER_SIZE + *header_len + cmd.data().size();
+    }
+
+    result_t<size_t> encode_into(const command_t& cmd, byte_span_t out) override {
+        byte_t header[modbus::MBAP_HEADER_SIZE + modbus::MAX_PDU_HEADER_SIZE];
+        auto header_len = _encode_header(cmd, header);
+        if (!header_len) {
+            return header_len;
+        }
+        const size_t data_len = cmd.data().size();
+        if (out.size() < *header_len || data_len > out.size() - *header_len) {
+            return make_error<size_t>(error_code_t::invalid_size,
+                                      "Output buffer too small for encoded frame");
+        }
+        std::memcpy(out.data(), header, *header_len);
+        if (data_len > 0) {
+            std::memcpy(out.data() + *header_len, cmd.data().data(), data_len);
+        }
+        _advance_transaction();
+        return *header_len + data_len;
+    }
+
+    result_t<void> encode_parts(const command_t& cmd, frame_parts_t& parts) override {
+        parts.header.set_size(modbus::MBAP_HEADER_SIZE + modbus::MAX_PDU_HEADER_SIZE);
+        auto header_len = _encode_header(cmd, parts.header.data());
+        if (!header_len) {
+            return make_error_void(header_len.error());
+        }
+        parts.header.set_size(*header_len);
+        parts.payload = cmd.data().as_span();
+        parts.trailer.clear();
+        _advance_transaction();
+        return make_ok();
+    }
+
+    result_t<response_t> decode(const_byte_span_t buffer, size_t& consumed) override {
+        return _decode(buffer, consumed, nullptr);
+    }
+
+    result_t<response_t> decode_slice(const byte_slice_t& frame, size_t& consumed) override {
+        return _decode(frame.view(), consumed, &frame);
+    }
+
+    size_t frame_length(const_byte_span_t buffer) const override {
+        if (buffer.size() < 6) {
+            return 0;
+        }
+        return 6 + _length_field(buffer);
+    }
+
+    /**
+     * @brief 关联键：MBAP 事务号
+     */
+    optional_t<uint32_t> correlation_key(const_byte_span_t frame) const override {
+        if (frame.size() < 2) {
+            return tl::nullopt;
+        }
+        return static_cast<uint32_t>((static_cast<uint32_t>(frame[0]) << 8) | frame[1]);
+    }
+
+    const char* name() const override {
+        return "modbus_tcp";
+    }
+
+    // ========================================================================
+    // 配置
+    // ========================================================================
+
+    uint8_t unit_id() const { return m_unit_id; }
+    void set_unit_id(uint8_t unit_id) { m_unit_id = unit_id; }
+
+    /**
+     * @brief 下一次编码使用的事务号
+     */
+    uint16_t next_transaction_id() const { return m_next_transaction; }
+    void set_next_transaction_id(uint16_t id) { m_next_transaction = id; }
+
+private:
+    static size_t _length_field(const_byte_span_t frame) {
+        return (static_cast<size_t>(frame[4]) << 8) | frame[5];
+    }
+
+    /**
+     * @brief 写入 MBAP 头和 PDU 固定部分
+     */
+    result_t<size_t> _encode_header(const command_t& cmd, byte_t* out) {
+        auto pdu_header = modbus::encode_pdu_header(cmd, out + modbus::MBAP_HEADER_SIZE);
+        if (!pdu_header) {
+            return pdu_header;
+        }
+        const size_t length = 1 + *pdu_header + cmd.data().size();   // 单元 + PDU
+        out[0] = static_cast<byte_t>(m_next_transaction >> 8);
+        out[1] = static_cast<byte_t>(m_next_transaction & 0xFF);
+        out[2] = 0;
+        out[3] = 0;
+        out[4] = static_cast<byte_t>(length >> 8);
+        out[5] = static_cast<byte_t>(length & 0xFF);
+        out[6] = m_unit_id;
+        return modbus::MBAP_HEADER_SIZE + *pdu_header;
+    }
+
+    void _advance_transaction() {
+        ++m_next_transaction;
+    }
+
+    result_t<response_t> _decode(const_byte_span_t buffer, size_t& consumed,
+                                 const byte_slice_t* slab) {
+        consumed = 0;
+        if (buffer.size() < 6) {
+            return make_error<response_t>(error_code_t::incomplete_frame,
+                                          "Incomplete frame: need more data");
+        }
+
+        const size_t length = _length_field(buffer);
+        const size_t frame_len = 6 + length;
+        if (buffer[2] != 0 || buffer[3] != 0 || length < 2) {
+            consumed = buffer.size() < frame_len ? buffer.size() : frame_len;
+            return make_error<response_t>(error_code_t::invalid_frame,
+                                          "Modbus: invalid MBAP header");
+        }
+        if (frame_len > modbus::TCP_MAX_ADU_SIZE || frame_len > m_max_frame_size) {
+            return make_error<response_t>(error_code_t::frame_too_large,
+                                          "Frame size exceeds maximum");
+        }
+        if (buffer.size() < frame_len) {
+            return make_error<response_t>(error_code_t::incomplete_frame,
+                                          "Incomplete frame: need more data");
+        }
+
+        const_byte_span_t pdu = buffer.subspan(modbus::MBAP_HEADER_SIZE,
+                                               frame_len - modbus::MBAP_HEADER_SIZE);
+        response_t response;
+        auto decoded = modbus::decode_pdu(pdu, response, slab, modbus::MBAP_HEADER_SIZE);
+        consumed = frame_len;
+        if (!decoded) {
+            return make_unexpected(decoded.error());
+        }
+        if (slab) {
+            response.set_raw_frame_slice(slab->subslice(0, frame_len));
+        } else {
+            response.set_raw_frame(buffer.first(frame_len));
+        }
+        return response;
+    }
+
+    uint8_t m_unit_id;
+    uint16_t m_next_transaction = 1;
+};
+
+// ============================================================================
+// modbus_rtu_codec_t - Modbus RTU 编解码器
+// ============================================================================
+
+/**
+ * @brief Modbus RTU 编解码器
+ *
+ * 帧格式：地址(1) + PDU + CRC-16/MODBUS(2, 低字节在前)。
+ * RTU 没有事务号，请求按发送顺序匹配（一问一答）；
+ * 帧边界由响应的功能码推出，串口帧间隔见 modbus_rtu_frame_gap_us()。
+ */
+class modbus_rtu_codec_t : public codec_base_t {
+public:
+    explicit modbus_rtu_codec_t(uint8_t slave_id = 1)
+        : m_slave_id(slave_id) {}
+
+    // ========================================================================
+    // i_codec_t 实现
+    // ========================================================================
+
+    result_t<bytes_t> encode(const command_t& cmd) override {
+        auto size_result = encoded_size(cmd);
+        if (!size_result) {
+            return make_unexpected(size_result.error());
+        }
+        bytes_t frame = size_class_pool_t::instance().acquire(*size_result);
+        auto result = encode_into(cmd, byte_span_t(frame.data(), frame.size()));
+        if (!result) {
+            size_class_pool_t::instance().release(std::move(frame));
+            return make_unexpected(result.error());
+        }
+        return frame;
+    }
+
+    result_t<size_t> encoded_size(const command_t& cmd) override {
+        byte_t header[modbus::MAX_PDU_HEADER_SIZE];
+        auto header_len = modbus::encode_pdu_header(cmd, header);
+        if (!header_len) {
+            return header_len;
+        }
+        return 1 + *header_len + cmd.data().size() + modbus::CRC_SIZE;
+    }
+
+    result_t<size_t> encode_into(const command_t& cmd, byte_span_t out) override {
+        byte_t header[1 + modbus::MAX_PDU_HEADER_SIZE];
+        auto header_len = _encode_header(cmd, header);
+        if (!header_len) {
+            return header_len;
+        }
+        const size_t data_len = cmd.data().size();
+        const size_t fixed = *header_len + modbus::CRC_SIZE;
+        if (out.size() < fixed || data_len > out.size() - fixed) {
+            return make_error<size_t>(error_code_t::invalid_size,
+                                      "Output buffer too small for encoded frame");
+        }
+
+        byte_t* frame = out.data();
+        std::memcpy(frame, header, *header_len);
+        if (data_len > 0) {
+            std::memcpy(frame + *header_len, cmd.data().data(), data_len);
+        }
+        const size_t body_len = *header_len + data_len;
+        _write_crc(crc16_modbus_t::compute(frame, body_len), frame + body_len);
+        return body_len + modbus::CRC_SIZE;
+    }
+
+    result_t<void> encode_parts(const command_t& cmd, frame_parts_t& parts) override {
+        parts.header.set_size(1 + modbus::MAX_PDU_HEADER_SIZE);
+        auto header_len = _encode_header(cmd, parts.header.data());
+        if (!header_len) {
+            return make_error_void(header_len.error());
+        }
+        parts.header.set_size(*header_len);
+        parts.payload = cmd.data().as_span();
+
+        crc16_modbus_t crc;
+        crc.update(parts.header.as_span()).update(parts.payload);
+        parts.trailer.set_size(modbus::CRC_SIZE);
+        _write_crc(crc.value(), parts.trailer.data());
+        return make_ok();
+    }
+
+    result_t<response_t> decode(const_byte_span_t buffer, size_t& consumed) override {
+        return _decode(buffer, consumed, nullptr);
+    }
+
+    result_t<response_t> decode_slice(const byte_slice_t& frame, size_t& consumed) override {
+        return _decode(frame.view(), consumed, &frame);
+    }
+
+    size_t frame_length(const_byte_span_t buffer) const override {
+        if (buffer.size() < 2) {
+            return 0;
+        }
+        const size_t pdu_len = modbus::response_pdu_length(buffer.subspan(1));
+        if (pdu_len == 0) {
+            return 0;
+        }
+        if (pdu_len == 1) {
+            return 1;       // 无法识别的功能码：交给 decode() 丢弃一个字节重新同步
+        }
+        return 1 + pdu_len + modbus::CRC_SIZE;
+    }
+
+    const char* name() const override {
+        return "modbus_rtu";
+    }
+
+    // ========================================================================
+    // 配置
+    // ========================================================================
+
+    uint8_t slave_id() const { return m_slave_id; }
+    void set_slave_id(uint8_t slave_id) { m_slave_id = slave_id; }
+
+private:
+    static void _write_crc(uint16_t crc, byte_t* out) {
+        out[0] = static_cast<byte_t>(crc & 0xFF);
+        out[1] = static_cast<byte_t>(crc >> 8);
+    }
+
+    result_t<size_t> _encode_header(const command_t& cmd, byte_t* out) {
+        auto pdu_header = modbus::encode_pdu_header(cmd, out + 1);
+        if (!pdu_header) {
+            return pdu_header;
+        }
+        out[0] = m_slave_id;
+        return 1 + *pdu_header;
+    }
+
+    result_t<response_t> _decode(const_byte_span_t buffer, size_t& consumed,
+                                 const byte_slice_t* slab) {
+        consumed = 0;
+        const size_t frame_len = frame_length(buffer);
+        if (frame_len == 1) {
+            consumed = 1;
+            return make_error<response_t>(error_code_t::invalid_frame,
+                                          "Modbus: unknown function code");
+        }
+        if (frame_len > modbus::RTU_MAX_ADU_SIZE || frame_len > m_max_frame_size) {
+            consumed = 1;
+            return make_error<response_t>(error_code_t::frame_too_large,
+                                          "Frame size exceeds maximum");
+        }
+        if (frame_len == 0 || buffer.size() < frame_len) {
+            return make_error<response_t>(error_code_t::incomplete_frame,
+                                          "Incomplete frame: need more data");
+        }
+
+        const size_t body_len = frame_len - modbus::CRC_SIZE;
+        const uint16_t expected = crc16_modbus_t::compute(buffer.data(), body_len);
+        const uint16_t actual = static_cast<uint16_t>(
+            static_cast<uint16_t>(buffer[body_len]) |
+            (static_cast<uint16_t>(buffer[body_len + 1]) << 8));
+        if (expected != actual) {
+            consumed = 1;
+            return make_error<response_t>(error_code_t::checksum_error, "CRC mismatch");
+        }
+
+        response_t response;
+        auto decoded = modbus::decode_pdu(buffer.subspan(1, body_len - 1), response, slab, 1);
+        consumed = frame_len;
+        if (!decoded) {
+            return make_unexpected(decoded.error());
+        }
+        if (slab) {
+            response.set_raw_frame_slice(slab->subslice(0, frame_len));
+        } else {
+            response.set_raw_frame(buffer.first(frame_len));
+        }
+        return response;
+    }
+
+    uint8_t m_slave_id;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CODEC_MODBUS_CODEC_HPP
@@ -0,0 +1,285 @@
+/**
+ * @file arena.hpp
+ * @brief 事务级内存区（bump allocator）
+ *
+ * 一次命令/查询往返中的临时对象从内存区顺序分配，事务结束时整体回收。
+ * 内存块在回收后保留，稳态循环不再向系统申请内存。
+ */
+
+#ifndef VDL_CORE_ARENA_HPP
+#define VDL_CORE_ARENA_HPP
+
+#include "types.hpp"
+#include "noncopyable.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace vdl {
+
+// ============================================================================
+// arena_t - 内存区
+// ============================================================================
+
+/**
+ * @brief 顺序分配的内存区
+ *
+ * - allocate() 只移动偏移；当前块不够时使用下一个块（不存在则新建，大小翻倍）
+ * - 单个对象不能单独释放，reset()/rewind() 一次回收
+ * - 块在回收后保留复用，直到内存区析构或调用 release()
+ *
+ * @note 非线程安全，每个线程/事务使用自己的内存区
+ */
+class arena_t : private noncopyable_t {
+public:
+    /**
+     * @brief 回收位置（见 mark()/rewind()）
+     */
+    struct marker_t {
+        size_t block = 0;
+        size_t offset = 0;
+    };
+
+    static constexpr size_t k_default_block_size = 4096;
+
+    explicit arena_t(size_t initial_block_size = k_default_block_size)
+        : m_initial_block_size(initial_block_size > 0 ? initial_block_size : 1) {}
+
+    /**
+     * @brief 分配 size 字节（按 alignment 对齐）
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        if (size == 0) {
+            size = 1;
+        }
+        while (m_block < m_blocks.size()) {
+            block_t& block = m_blocks[m_block];
+            const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+            const uintptr_t aligned = (base + m_offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+            const size_t start = static_cast<size_t>(aligned - base);
+            if (start + size <= block.size) {
+                m_offset = start + size;
+                m_used += size;
+                return block.data.get() + start;
+            }
+            ++m_block;
+            m_offset = 0;
+        }
+
+        // 保留的块都不够：新建一个，至少容纳本次请求
+        size_t block_size = m_blocks.empty() ? m_initial_block_size : m_blocks.back().size * 2;
+        if (block_size < size + alignment) {
+            block_size = size + alignment;
+        }
+        block_t block;
+        block.data.reset(new byte_t[block_size]);
+        block.size = block_size;
+        m_reserved += block_size;
+        m_blocks.push_back(std::move(block));
+        m_block = m_blocks.size() - 1;
+        m_offset = 0;
+        return allocate(size, alignment);
+    }
+
+    /**
+     * @brief 当前分配位置
+     */
+    marker_t mark() const {
+        marker_t marker;
+        marker.block = m_block;
+        marker.offset = m_offset;
+        return marker;
+    }
+
+    /**
+     * @brief 回收 marker 之后分配的全部内存
+     */
+    void rewind(const marker_t& marker) {
+        if (marker.block < m_block || (marker.block == m_block && marker.offset < m_offset)) {
+            m_block = marker.block;
+            m_offset = marker.offset;
+        }
+        if (m_block == 0 && m_offset == 0) {
+            m_used = 0;
+        }
+    }
+
+    /**
+     * @brief 回收全部内存（保留内存块）
+     */
+    void reset() {
+        m_block = 0;
+        m_offset = 0;
+        m_used = 0;
+    }
+
+    /**
+     * @brief 回收全部内存并归还内存块
+     */
+    void release() {
+        reset();
+        m_blocks.clear();
+        m_reserved = 0;
+    }
+
+    /**
+     * @brief 自上次 reset() 以来分配的字节数（不含对齐填充）
+     */
+    size_t bytes_used() const {
+        return m_used;
+    }
+
+    /**
+     * @brief 已向系统申请的字节数
+     */
+    size_t bytes_reserved() const {
+        return m_reserved;
+    }
+
+    size_t block_count() const {
+        return m_blocks.size();
+    }
+
+private:
+    struct block_t {
+        std::unique_ptr<byte_t[]> data;
+        size_t size = 0;
+    };
+
+    const size_t m_initial_block_size;
+    std::vector<block_t> m_blocks;
+    size_t m_block = 0;             ///< 当前分配所在的块
+    size_t m_offset = 0;            ///< 当前块中的偏移
+    size_t m_used = 0;
+    size_t m_reserved = 0;
+};
+
+// ============================================================================
+// arena_allocator_t - 标准分配器适配
+// ============================================================================
+
+/**
+ * @brief 从 arena_t 分配的标准分配器
+ *
+ * deallocate() 不释放内存（由内存区统一回收）。默认构造（无内存区）时退回全局 new/delete，
+ * 使 arena_bytes_t 等类型可以像普通容器一样默认构造。
+ */
+template <typename T>
+class arena_allocator_t {
+public:
+    using value_type = T;
+
+    arena_allocator_t() noexcept = default;
+
+    explicit arena_allocator_t(arena_t& arena) noexcept
+        : m_arena(&arena) {}
+
+    template <typename U>
+    arena_allocator_t(const arena_allocator_t<U>& other) noexcept
+        : m_arena(other.arena()) {}
+
+    T* allocate(size_t count) {
+        if (m_arena) {
+            return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, size_t /*count*/) noexcept {
+        if (!m_arena) {
+            ::operator delete(pointer);
+        }
+    }
+
+    arena_t* arena() const noexcept {
+        return m_arena;
+    }
+
+    template <typename U>
+    bool operator==(const arena_allocator_t<U>& other) const noexcept {
+        return m_arena == other.arena();
+    }
+
+    template <typename U>
+    bool operator!=(const arena_allocator_t<U>& other) const noexcept {
+        return m_arena != other.arena();
+    }
+
+private:
+    arena_t* m_arena = nullptr;
+};
+
+/**
+ * @brief 从内存区分配的字节数组
+ */
+using arena_bytes_t = std::vector<byte_t, arena_allocator_t<byte_t>>;
+
+/**
+ * @brief 从内存区分配的字符串
+ */
+using arena_string_t = std::basic_string<char, std::char_traits<char>, arena_allocator_t<char>>;
+
+// ============================================================================
+// transaction_scope_t - 事务作用域
+// ============================================================================
+
+/**
+ * @brief 事务作用域：析构时回收作用域内从内存区分配的全部临时对象
+ *
+ * 作用域可以嵌套；从作用域得到的对象不能存活到作用域结束之后。
+ *
+ * @code
+ * arena_t arena;
+ * for (;;) {
+ *     transaction_scope_t scope(arena);
+ *     auto text = device.query("MEAS:VOLT?", scope);   // 响应文本在内存区中
+ *     ...
+ * }                                                    // 一次回收，下一轮复用同一块内存
+ * @endcode
+ */
+class transaction_scope_t : private noncopyable_t {
+public:
+    explicit transaction_scope_t(arena_t& arena)
+        : m_arena(arena)
+        , m_marker(arena.mark()) {}
+
+    ~transaction_scope_t() {
+        m_arena.rewind(m_marker);
+    }
+
+    arena_t& arena() {
+        return m_arena;
+    }
+
+    /**
+     * @brief 本作用域的字节分配器
+     */
+    arena_allocator_t<byte_t> allocator() {
+        return arena_allocator_t<byte_t>(m_arena);
+    }
+
+    /**
+     * @brief 在作用域内创建 size 字节（清零）的数组
+     */
+    arena_bytes_t make_bytes(size_t size = 0) {
+        return arena_bytes_t(size, 0, arena_allocator_t<byte_t>(m_arena));
+    }
+
+    /**
+     * @brief 在作用域内创建字符串
+     */
+    arena_string_t make_string(const char* data = "", size_t size = 0) {
+        return arena_string_t(data, size, arena_allocator_t<char>(m_arena));
+    }
+
+private:
+    arena_t& m_arena;
+    arena_t::marker_t m_marker;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CORE_ARENA_HPP
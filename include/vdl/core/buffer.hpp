@@ -12,7 +12,10 @@
 #include <vdl/core/error.hpp>
 #include <vdl/core/noncopyable.hpp>
 #include <algorithm>
+#include <initializer_list>
+#include <memory>
 #include <cstring>
+#include <type_traits>
 
 namespace vdl {
 
@@ -24,6 +27,21 @@ namespace vdl {
  * @brief 环形缓冲区
  * 
  * 适用于流式数据的缓冲区实现。
+ * 
+ * 除了复制式的 read()/peek()，还提供零拷贝视图：
+ * - readable_first()/readable_second(): 可读数据的一段或两段视图
+ * - linearize(): 将可读数据整理为一段连续内存并返回视图
+ * - write_span()/commit_write(): 直接向空闲空间写入（如传输层 read() 的目标）
+ * 
+ * @code
+ * ring_buffer_t rx(4096);
+ * byte_span_t space = rx.write_span();
+ * auto n = transport.read(space);
+ * if (n) rx.commit_write(*n);
+ * 
+ * const_byte_span_t data = rx.linearize();
+ * size_t len = codec.frame_length(data);
+ * @endcode
  */
 class ring_buffer_t : public noncopyable_t {
 public:
@@ -127,6 +145,7 @@ public:
 
         m_read_pos = (m_read_pos + to_read) % m_capacity;
         m_size -= to_read;
+        _rewind_if_empty();
 
         return to_read;
     }
@@ -166,8 +185,12 @@ public:
      */
     size_t skip(size_t len) {
         size_t to_skip = std::min(len, m_size);
+        if (to_skip == 0) {
+            return 0;
+        }
         m_read_pos = (m_read_pos + to_skip) % m_capacity;
         m_size -= to_skip;
+        _rewind_if_empty();
         return to_skip;
     }
 
@@ -211,6 +234,7 @@ public:
         byte_t b = m_buffer[m_read_pos];
         m_read_pos = (m_read_pos + 1) % m_capacity;
         --m_size;
+        _rewind_if_empty();
         return b;
     }
 
@@ -223,7 +247,115 @@ public:
         m_size = 0;
     }
 
+    // ========================================================================
+    // 零拷贝视图
+    // ========================================================================
+
+    /**
+     * @brief 可读数据的第一段（从读位置到数据末尾或缓冲区末尾）
+     */
+    const_byte_span_t readable_first() const {
+        size_t len = std::min(m_size, m_capacity - m_read_pos);
+        return const_byte_span_t(m_buffer.data() + m_read_pos, len);
+    }
+
+    /**
+     * @brief 可读数据的第二段（数据跨越缓冲区末尾时的回绕部分，否则为空）
+     */
+    const_byte_span_t readable_second() const {
+        size_t first = std::min(m_size, m_capacity - m_read_pos);
+        return const_byte_span_t(m_buffer.data(), m_size - first);
+    }
+
+    /**
+     * @brief 检查可读数据是否为一段连续内存
+     */
+    bool is_contiguous() const {
+        return m_read_pos + m_size <= m_capacity;
+    }
+
+    /**
+     * @brief 将可读数据整理为连续内存并返回视图
+     * 
+     * 数据未回绕时不做任何复制；回绕时原地旋转一次。
+     * 返回的视图在下一次写入、读取或整理前有效。
+     */
+    const_byte_span_t linearize() {
+        if (!is_contiguous()) {
+            std::rotate(m_buffer.begin(),
+                        m_buffer.begin() + static_cast<offset_t>(m_read_pos),
+                        m_buffer.end());
+            m_read_pos = 0;
+            m_write_pos = m_size % m_capacity;
+        }
+        return readable_first();
+    }
+
+    /**
+     * @brief 获取一段连续的可写空间
+     * 
+     * 尾部连续空间不足总空闲空间的一半时，先把数据前移以腾出连续空间，
+     * 因此通过本接口写入的数据不会回绕，linearize() 通常无需复制。
+     * 写入后必须调用 commit_write() 提交实际写入的字节数。
+     */
+    byte_span_t write_span() {
+        if (m_size == 0) {
+            m_read_pos = 0;
+            m_write_pos = 0;
+        } else if (is_contiguous() && m_read_pos > 0 &&
+                   _tail_space() < available() / 2) {
+            _compact();
+        }
+        return writable_first();
+    }
+
+    /**
+     * @brief 可写空间的第一段（从写位置开始的连续空闲空间）
+     */
+    byte_span_t writable_first() {
+        size_t len = std::min(available(), m_capacity - m_write_pos);
+        return byte_span_t(m_buffer.data() + m_write_pos, len);
+    }
+
+    /**
+     * @brief 可写空间的第二段（回绕到缓冲区开头的空闲空间，否则为空）
+     */
+    byte_span_t writable_second() {
+        size_t first = std::min(available(), m_capacity - m_write_pos);
+        return byte_span_t(m_buffer.data(), available() - first);
+    }
+
+    /**
+     * @brief 提交直接写入空闲空间的字节
+     * @param len 已写入的字节数
+     * @return 实际提交的字节数（不超过可用空间）
+     */
+    size_t commit_write(size_t len) {
+        size_t to_commit = std::min(len, available());
+        m_write_pos = (m_write_pos + to_commit) % m_capacity;
+        m_size += to_commit;
+        return to_commit;
+    }
+
 private:
+    // 连续数据之后到缓冲区末尾的空闲字节数（仅在 is_contiguous() 时有意义）
+    size_t _tail_space() const {
+        return m_capacity - (m_read_pos + m_size);
+    }
+
+    void _compact() {
+        std::memmove(m_buffer.data(), m_buffer.data() + m_read_pos, m_size);
+        m_read_pos = 0;
+        m_write_pos = m_size % m_capacity;
+    }
+
+    void _rewind_if_empty() {
+        if (m_size == 0) {
+            m_read_pos = 0;
+            m_write_pos = 0;
+        }
+    }
+
     bytes_t m_buffer;
     size_t m_capacity;
     size_t m_read_pos;
@@ -263,6 +395,402 @@ private:
     size_t m_size;
 };
 
+// ============================================================================
+// 小缓冲区优化的字节数组
+// ============================================================================
+
+/**
+ * @brief 带内联存储的字节数组
+ *
+ * 不超过 N 字节的数据直接存放在对象内部，超过时才使用堆内存，
+ * 接口与 bytes_t 常用部分一致（data/size/迭代器/resize/push_back/assign 等）。
+ * 命令参数、响应数据绝大多数只有几个到十几个字节，复制、移动都不分配内存。
+ *
+ * @code
+ * small_bytes_t<32> payload = {0x00, 0x10, 0x00, 0x08};   // 内联存储
+ * payload.resize(100);                                      // 转为堆存储
+ * @endcode
+ */
+template<size_t N>
+class small_bytes_t {
+public:
+    typedef byte_t         value_type;
+    typedef size_t         size_type;
+    typedef byte_t*        iterator;
+    typedef const byte_t*  const_iterator;
+    typedef byte_t&        reference;
+    typedef const byte_t&  const_reference;
+
+    small_bytes_t() : m_heap(nullptr), m_size(0), m_capacity(N) {}
+
+    explicit small_bytes_t(size_t count, byte_t value = 0) : small_bytes_t() {
+        assign(count, value);
+    }
+
+    small_bytes_t(std::initializer_list<byte_t> init) : small_bytes_t() {
+        assign(init.begin(), init.size());
+    }
+
+    explicit small_bytes_t(const_byte_span_t data) : small_bytes_t() {
+        assign(data.data(), data.size());
+    }
+
+    explicit small_bytes_t(const bytes_t& data) : small_bytes_t() {
+        assign(data.data(), data.size());
+    }
+
+    template<typename InputIt,
+             typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    small_bytes_t(InputIt first, InputIt last) : small_bytes_t() {
+        assign(first, last);
+    }
+
+    small_bytes_t(const small_bytes_t& other) : small_bytes_t() {
+        assign(other.data(), other.size());
+    }
+
+    small_bytes_t(small_bytes_t&& other) noexcept : small_bytes_t() {
+        _take(other);
+    }
+
+    ~small_bytes_t() {
+        delete[] m_heap;
+    }
+
+    small_bytes_t& operator=(const small_bytes_t& other) {
+        if (this != &other) {
+            assign(other.data(), other.size());
+        }
+        return *this;
+    }
+
+    small_bytes_t& operator=(small_bytes_t&& other) noexcept {
+        if (this != &other) {
+            delete[] m_heap;
+            m_heap = nullptr;
+            m_size = 0;
+            m_capacity = N;
+            _take(other);
+        }
+        return *this;
+    }
+
+    small_bytes_t& operator=(std::initializer_list<byte_t> init) {
+        assign(init.begin(), init.size());
+        return *this;
+    }
+
+    // ========================================================================
+    // 访问
+    // ========================================================================
+
+    byte_t* data() { return m_heap ? m_heap : m_inline; }
+    const byte_t* data() const { return m_heap ? m_heap : m_inline; }
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+
+    /**
+     * @brief 数据是否在内联存储中
+     */
+    bool is_inline() const { return m_heap == nullptr; }
+
+    byte_t& operator[](size_t idx) { return data()[idx]; }
+    const byte_t& operator[](size_t idx) const { return data()[idx]; }
+    byte_t& front() { return data()[0]; }
+    const byte_t& front() const { return data()[0]; }
+    byte_t& back() { return data()[m_size - 1]; }
+    const byte_t& back() const { return data()[m_size - 1]; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + m_size; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + m_size; }
+    const_iterator cbegin() const { return data(); }
+    const_iterator cend() const { return data() + m_size; }
+
+    byte_span_t as_span() { return byte_span_t(data(), m_size); }
+    const_byte_span_t as_span() const { return const_byte_span_t(data(), m_size); }
+
+    /**
+     * @brief 复制为 bytes_t
+     */
+    bytes_t to_bytes() const {
+        return bytes_t(begin(), end());
+    }
+
+    // ========================================================================
+    // 修改
+    // ========================================================================
+
+    void clear() { m_size = 0; }
+
+    void reserve(size_t capacity) {
+        if (capacity > m_capacity) {
+            _grow(capacity);
+        }
+    }
+
+    void resize(size_t count, byte_t value = 0) {
+        reserve(count);
+        if (count > m_size) {
+            std::memset(data() + m_size, value, count - m_size);
+        }
+        m_size = count;
+    }
+
+    void push_back(byte_t value) {
+        if (m_size == m_capacity) {
+            _grow(m_capacity * 2);
+        }
+        data()[m_size++] = value;
+    }
+
+    void pop_back() { --m_size; }
+
+// GCC 12 在内联后对堆分配分支给出 -Warray-bounds/-Wstringop-overread 误报（该分支只在 count 大于内联容量时执行）
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#pragma GCC diagnostic ignored "-Wstringop-overread"
+#endif
+    void assign(const byte_t* source, size_t count) {
+        if (count > m_capacity) {
+            // 新数据可能来自自身，先分配再复制
+            small_bytes_t copy;
+            copy._grow(count);
+            std::memcpy(copy.m_heap, source, count);
+            copy.m_size = count;
+            *this = std::move(copy);
+            return;
+        }
+        if (count > 0) {
+            std::memmove(data(), source, count);
+        }
+        m_size = count;
+    }
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 12
+#pragma GCC diagnostic pop
+#endif
+
+    void assign(size_t count, byte_t value) {
+        clear();
+        resize(count, value);
+    }
+
+    template<typename InputIt,
+             typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        for (; first != last; ++first) {
+            push_back(static_cast<byte_t>(*first));
+        }
+    }
+
+    void assign(std::initializer_list<byte_t> init) {
+        assign(init.begin(), init.size());
+    }
+
+    /**
+     * @brief 在末尾追加数据
+     */
+    void append(const byte_t* source, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        if (m_size + count > m_capacity) {
+            // 追加的数据可能来自自身
+            const byte_t* current = data();
+            const bool self = source >= current && source < current + m_size;
+            const size_t offset = self ? static_cast<size_t>(source - current) : 0;
+            _grow(std::max(m_size + count, m_capacity * 2));
+            if (self) {
+                source = m_heap + offset;
+            }
+        }
+        std::memmove(data() + m_size, source, count);
+        m_size += count;
+    }
+
+    void append(const_byte_span_t source) {
+        append(source.data(), source.size());
+    }
+
+    // ========================================================================
+    // 比较
+    // ========================================================================
+
+    friend bool operator==(const small_bytes_t& a, const small_bytes_t& b) {
+        return _equal(a.as_span(), b.as_span());
+    }
+
+    friend bool operator!=(const small_bytes_t& a, const small_bytes_t& b) {
+        return !(a == b);
+    }
+
+    friend bool operator==(const small_bytes_t& a, const bytes_t& b) {
+        return _equal(a.as_span(), const_byte_span_t(b.data(), b.size()));
+    }
+
+    friend bool operator==(const bytes_t& a, const small_bytes_t& b) {
+        return b == a;
+    }
+
+    friend bool operator!=(const small_bytes_t& a, const bytes_t& b) {
+        return !(a == b);
+    }
+
+    friend bool operator!=(const bytes_t& a, const small_bytes_t& b) {
+        return !(b == a);
+    }
+
+private:
+    static bool _equal(const_byte_span_t a, const_byte_span_t b) {
+        return a.size() == b.size() &&
+               (a.empty() || std::memcmp(a.data(), b.data(), a.size()) == 0);
+    }
+
+    void _grow(size_t capacity) {
+        if (capacity < N * 2) {
+            capacity = N * 2;
+        }
+        byte_t* heap = new byte_t[capacity];
+        if (m_size > 0) {
+            std::memcpy(heap, data(), m_size);
+        }
+        delete[] m_heap;
+        m_heap = heap;
+        m_capacity = capacity;
+    }
+
+    // 前置条件：*this 为空的内联状态
+    void _take(small_bytes_t& other) {
+        if (other.m_heap == nullptr) {
+            if (other.m_size > 0) {
+                std::memcpy(m_inline, other.m_inline, other.m_size);
+            }
+            m_size = other.m_size;
+        } else {
+            m_heap = other.m_heap;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            other.m_heap = nullptr;
+            other.m_capacity = N;
+        }
+        other.m_size = 0;
+    }
+
+    byte_t m_inline[N];
+    byte_t* m_heap;         ///< 堆存储，内联时为空
+    size_t m_size;
+    size_t m_capacity;
+};
+
+/**
+ * @brief 命令/响应负载的内联容量
+ */
+constexpr size_t k_inline_payload_size = 32;
+
+/**
+ * @brief 命令/响应负载（不超过 k_inline_payload_size 字节时不分配堆内存）
+ */
+typedef small_bytes_t<k_inline_payload_size> payload_bytes_t;
+
+// ============================================================================
+// 共享字节切片
+// ============================================================================
+
+/**
+ * @brief 引用计数的只读字节切片
+ * 
+ * 多个切片可以共享同一块底层缓冲区（slab），复制切片只增加引用计数，
+ * 不复制数据。最后一个引用释放时缓冲区被回收。
+ * 
+ * @code
+ * byte_slice_t frame(std::move(received));      // 接管接收到的整帧
+ * byte_slice_t payload = frame.subslice(4, n);  // 负载视图，共享同一缓冲区
+ * process(payload.view());
+ * @endcode
+ */
+class byte_slice_t {
+public:
+    byte_slice_t() : m_offset(0), m_size(0) {}
+
+    /**
+     * @brief 接管 bytes_t 作为底层缓冲区
+     */
+    explicit byte_slice_t(bytes_t&& data)
+        : m_owner(std::make_shared<const bytes_t>(std::move(data)))
+        , m_offset(0)
+        , m_size(m_owner->size()) {
+    }
+
+    /**
+     * @brief 引用已有缓冲区的一部分
+     */
+    byte_slice_t(std::shared_ptr<const bytes_t> owner, size_t offset, size_t size)
+        : m_owner(std::move(owner))
+        , m_offset(offset)
+        , m_size(size) {
+        if (!m_owner || m_offset > m_owner->size()) {
+            m_offset = 0;
+            m_size = 0;
+        } else if (m_size > m_owner->size() - m_offset) {
+            m_size = m_owner->size() - m_offset;
+        }
+    }
+
+    const byte_t* data() const {
+        return m_size > 0 ? m_owner->data() + m_offset : nullptr;
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    /**
+     * @brief 获取只读视图（不复制）
+     */
+    const_byte_span_t view() const {
+        return const_byte_span_t(data(), m_size);
+    }
+
+    /**
+     * @brief 获取子切片（共享同一缓冲区）
+     */
+    byte_slice_t subslice(size_t offset, size_t count = static_cast<size_t>(-1)) const {
+        if (offset >= m_size) {
+            return byte_slice_t();
+        }
+        return byte_slice_t(m_owner, m_offset + offset, std::min(count, m_size - offset));
+    }
+
+    /**
+     * @brief 复制为独立的 bytes_t
+     */
+    bytes_t to_bytes() const {
+        const byte_t* p = data();
+        return p ? bytes_t(p, p + m_size) : bytes_t();
+    }
+
+    /**
+     * @brief 底层缓冲区的引用计数（0 表示空切片）
+     */
+    long use_count() const {
+        return m_owner.use_count();
+    }
+
+    void reset() {
+        m_owner.reset();
+        m_offset = 0;
+        m_size = 0;
+    }
+
+private:
+    std::shared_ptr<const bytes_t> m_owner;
+    size_t m_offset;
+    size_t m_size;
+};
+
 // ============================================================================
 // 辅助函数
 // ============================================================================
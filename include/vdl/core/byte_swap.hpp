@@ -0,0 +1,185 @@
+/**
+ * @file byte_swap.hpp
+ * @brief 字节序转换
+ *
+ * 标量转换和批量转换内核。批量内核在编译目标支持时使用
+ * SSSE3 pshufb（-mssse3 及以上）或 NEON rev（AArch64/ARMv7 NEON），否则逐元素转换。
+ */
+
+#ifndef VDL_CORE_BYTE_SWAP_HPP
+#define VDL_CORE_BYTE_SWAP_HPP
+
+#include "types.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace vdl {
+
+// ============================================================================
+// 标量转换
+// ============================================================================
+
+inline uint16_t byte_swap(uint16_t v) {
+    return static_cast<uint16_t>((v << 8) | (v >> 8));
+}
+
+inline uint32_t byte_swap(uint32_t v) {
+#if defined(__GNUC__)
+    return __builtin_bswap32(v);
+#else
+    v = (v << 16) | (v >> 16);
+    return ((v & 0x00FF00FFu) << 8) | ((v & 0xFF00FF00u) >> 8);
+#endif
+}
+
+inline uint64_t byte_swap(uint64_t v) {
+#if defined(__GNUC__)
+    return __builtin_bswap64(v);
+#else
+    v = ((v & 0x00000000FFFFFFFFull) << 32) | ((v & 0xFFFFFFFF00000000ull) >> 32);
+    v = ((v & 0x0000FFFF0000FFFFull) << 16) | ((v & 0xFFFF0000FFFF0000ull) >> 16);
+    return ((v & 0x00FF00FF00FF00FFull) << 8) | ((v & 0xFF00FF00FF00FF00ull) >> 8);
+#endif
+}
+
+/**
+ * @brief 数据字节序为 order 时是否需要翻转（native 视为本机字节序）
+ */
+inline bool needs_byte_swap(byte_order_t order) {
+    return order != byte_order_t::native && order != host_byte_order();
+}
+
+namespace detail {
+
+template <size_t Width>
+struct swap_word_t;
+
+template <>
+struct swap_word_t<2> {
+    typedef uint16_t type;
+};
+
+template <>
+struct swap_word_t<4> {
+    typedef uint32_t type;
+};
+
+template <>
+struct swap_word_t<8> {
+    typedef uint64_t type;
+};
+
+/**
+ * @brief 逐元素转换（尾部及无 SIMD 时使用）
+ */
+template <size_t Width>
+inline void swap_copy_scalar(byte_t* dst, const byte_t* src, size_t count) {
+    typedef typename swap_word_t<Width>::type word_t;
+    for (size_t i = 0; i < count; ++i) {
+        word_t v;
+        std::memcpy(&v, src + i * Width, Width);
+        v = byte_swap(v);
+        std::memcpy(dst + i * Width, &v, Width);
+    }
+}
+
+/**
+ * @brief 每 16 字节一组的 SIMD 转换，返回已处理的元素数
+ */
+template <size_t Width>
+inline size_t swap_copy_simd(byte_t* dst, const byte_t* src, size_t count) {
+#if defined(__SSSE3__)
+    const __m128i mask = Width == 2
+        ? _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+        : Width == 4
+            ? _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+            : _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    const size_t per_block = 16 / Width;
+    const size_t blocks = count / per_block;
+    for (size_t b = 0; b < blocks; ++b) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + b * 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + b * 16), _mm_shuffle_epi8(v, mask));
+    }
+    return blocks * per_block;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const size_t per_block = 16 / Width;
+    const size_t blocks = count / per_block;
+    for (size_t b = 0; b < blocks; ++b) {
+        const uint8x16_t v = vld1q_u8(src + b * 16);
+        vst1q_u8(dst + b * 16, Width == 2 ? vrev16q_u8(v) : Width == 4 ? vrev32q_u8(v) : vrev64q_u8(v));
+    }
+    return blocks * per_block;
+#else
+    (void)dst;
+    (void)src;
+    (void)count;
+    return 0;
+#endif
+}
+
+template <size_t Width>
+inline void swap_copy_width(byte_t* dst, const byte_t* src, size_t count) {
+    const size_t done = swap_copy_simd<Width>(dst, src, count);
+    swap_copy_scalar<Width>(dst + done * Width, src + done * Width, count - done);
+}
+
+}  // namespace detail
+
+// ============================================================================
+// 批量转换
+// ============================================================================
+
+/**
+ * @brief 复制 count 个宽度为 width 的元素并翻转每个元素的字节序
+ *
+ * dst 与 src 可以相同（原地翻转），但不能部分重叠。width 为 1 时只复制。
+ */
+inline void byte_swap_copy(byte_t* dst, const byte_t* src, size_t count, size_t width) {
+    switch (width) {
+    case 1:
+        if (dst != src && count > 0) {
+            std::memcpy(dst, src, count);
+        }
+        break;
+    case 2:
+        detail::swap_copy_width<2>(dst, src, count);
+        break;
+    case 4:
+        detail::swap_copy_width<4>(dst, src, count);
+        break;
+    case 8:
+        detail::swap_copy_width<8>(dst, src, count);
+        break;
+    default:
+        for (size_t i = 0; i < count; ++i) {
+            const byte_t* from = src + i * width;
+            byte_t* to = dst + i * width;
+            if (to == from) {
+                std::reverse(to, to + width);
+            } else {
+                std::reverse_copy(from, from + width, to);
+            }
+        }
+        break;
+    }
+}
+
+/**
+ * @brief 原地翻转 count 个宽度为 width 的元素的字节序
+ */
+inline void byte_swap_in_place(byte_t* data, size_t count, size_t width) {
+    byte_swap_copy(data, data, count, width);
+}
+
+}  // namespace vdl
+
+#endif  // VDL_CORE_BYTE_SWAP_HPP
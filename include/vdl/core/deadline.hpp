@@ -0,0 +1,150 @@
+/**
+ * @file deadline.hpp
+ * @brief 绝对截止时间与取消令牌
+ *
+ * 命令路径上的每次传输调用只拿到截止时间前剩余的时间，
+ * 重试和等待都不会让一次调用超出调用者给出的超时。
+ */
+
+#ifndef VDL_CORE_DEADLINE_HPP
+#define VDL_CORE_DEADLINE_HPP
+
+#include "types.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+
+namespace vdl {
+
+// ============================================================================
+// deadline_t - 单调时钟截止时间
+// ============================================================================
+
+/**
+ * @brief 基于单调时钟的绝对截止时间
+ *
+ * @code
+ * deadline_t deadline = deadline_t::after(1000);
+ * while (!deadline.expired()) {
+ *     auto n = transport.read(buffer, deadline.remaining_ms());
+ *     ...
+ * }
+ * @endcode
+ */
+class deadline_t {
+public:
+    using io_clock_t = std::chrono::steady_clock;
+
+    /**
+     * @brief 从现在起 timeout_ms 毫秒后到期（非正数表示已到期）
+     */
+    static deadline_t after(milliseconds_t timeout_ms) {
+        deadline_t deadline;
+        deadline.m_at = io_clock_t::now() +
+            std::chrono::milliseconds(timeout_ms > 0 ? timeout_ms : 0);
+        return deadline;
+    }
+
+    /**
+     * @brief 永不到期
+     */
+    static deadline_t never() {
+        deadline_t deadline;
+        deadline.m_never = true;
+        return deadline;
+    }
+
+    bool is_never() const { return m_never; }
+
+    io_clock_t::time_point at() const { return m_at; }
+
+    bool expired() const {
+        return !m_never && io_clock_t::now() >= m_at;
+    }
+
+    /**
+     * @brief 剩余毫秒数
+     * @return 已到期返回 0；未到期时向上取整，至少为 1
+     *
+     * 传输层把 0 解释为“使用默认超时”，因此未到期时不会返回 0。
+     */
+    milliseconds_t remaining_ms() const {
+        if (m_never) {
+            return k_never_ms;
+        }
+        const auto left = m_at - io_clock_t::now();
+        if (left <= io_clock_t::duration::zero()) {
+            return 0;
+        }
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(left);
+        const milliseconds_t whole = static_cast<milliseconds_t>(ms.count());
+        return left > ms ? whole + 1 : whole;
+    }
+
+    /**
+     * @brief 剩余时间与 limit 中较小者（用于分段等待）
+     */
+    milliseconds_t remaining_ms(milliseconds_t limit) const {
+        const milliseconds_t left = remaining_ms();
+        return (limit > 0 && limit < left) ? limit : left;
+    }
+
+private:
+    static constexpr milliseconds_t k_never_ms = std::numeric_limits<int32_t>::max();
+
+    io_clock_t::time_point m_at;
+    bool m_never = false;
+};
+
+// ============================================================================
+// cancellation_token_t - 取消令牌
+// ============================================================================
+
+/**
+ * @brief 跨线程取消令牌
+ *
+ * 副本共享同一个状态：把令牌传给阻塞调用，在另一个线程中调用 cancel()，
+ * 阻塞调用在一个轮询间隔内以 operation_cancelled 返回。
+ *
+ * @code
+ * cancellation_token_t token;
+ * std::thread watchdog([token] {
+ *     std::this_thread::sleep_for(std::chrono::milliseconds(200));
+ *     token.cancel();
+ * });
+ * auto result = device.execute(cmd, 5000, token);
+ * @endcode
+ */
+class cancellation_token_t {
+public:
+    cancellation_token_t()
+        : m_state(std::make_shared<std::atomic<bool>>(false)) {
+    }
+
+    /**
+     * @brief 请求取消（线程安全）
+     */
+    void cancel() const {
+        m_state->store(true, std::memory_order_release);
+    }
+
+    bool cancelled() const {
+        return m_state->load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 清除取消状态以便复用
+     */
+    void reset() const {
+        m_state->store(false, std::memory_order_release);
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_state;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CORE_DEADLINE_HPP
@@ -11,8 +11,12 @@
 #include <vdl/core/types.hpp>
 #include <tl/expected.hpp>
 #include <tl/optional.hpp>
+#include <atomic>
+#include <cstring>
+#include <ostream>
 #include <string>
 #include <sstream>
+#include <utility>
 
 namespace vdl {
 
@@ -204,10 +208,67 @@ inline const char* get_error_name(error_code_t code) {
 // 错误类
 // ============================================================================
 
+/**
+ * @brief 错误消息/上下文的只读视图
+ *
+ * 与 std::string 常用的只读操作兼容（c_str/empty/size/比较/输出），不复制文本。
+ */
+class error_text_t {
+public:
+    explicit error_text_t(const char* text) : m_text(text ? text : "") {}
+
+    const char* c_str() const { return m_text; }
+    size_t size() const { return std::strlen(m_text); }
+    bool empty() const { return m_text[0] == '\0'; }
+    std::string str() const { return std::string(m_text); }
+
+    operator std::string() const { return str(); }
+
+    friend bool operator==(const error_text_t& a, const char* b) {
+        return std::strcmp(a.m_text, b ? b : "") == 0;
+    }
+    friend bool operator==(const error_text_t& a, const std::string& b) {
+        return b == a.m_text;
+    }
+    friend bool operator==(const error_text_t& a, const error_text_t& b) {
+        return std::strcmp(a.m_text, b.m_text) == 0;
+    }
+    friend bool operator!=(const error_text_t& a, const char* b) { return !(a == b); }
+    friend bool operator!=(const error_text_t& a, const std::string& b) { return !(a == b); }
+    friend bool operator!=(const error_text_t& a, const error_text_t& b) { return !(a == b); }
+
+    friend std::ostream& operator<<(std::ostream& os, const error_text_t& text) {
+        return os << text.m_text;
+    }
+
+private:
+    const char* m_text;
+};
+
+namespace detail {
+
+/**
+ * @brief 错误的动态部分（运行时生成的消息、上下文），引用计数共享
+ */
+struct error_detail_t {
+    std::atomic<unsigned> refs{1};
+    std::string message;
+    std::string context;
+};
+
+}  // namespace detail
+
 /**
  * @brief 错误类
  * 
  * 包含错误码、消息和上下文信息。
+ * 
+ * 消息默认是静态字符串（const char* 构造时只保存指针），超时、帧不完整等
+ * 高频错误的创建、复制都不分配内存。运行时拼接的 std::string 消息和
+ * with_context() 添加的上下文存放在引用计数的详情块中，复制错误只增加引用计数。
+ * 
+ * @note const char* 消息必须在错误的整个生命周期内有效（通常是字符串字面量），
+ *       临时文本请使用 std::string 重载
  */
 class error_t {
 public:
@@ -219,31 +280,96 @@ public:
     /**
      * @brief 从错误码构造
      */
-    explicit error_t(error_code_t code, const std::string& message = "")
-        : m_code(code)
-        , m_message(message) {}
+    explicit error_t(error_code_t code)
+        : m_code(code) {}
 
     /**
-     * @brief 从错误码和消息构造
+     * @brief 从错误码和静态消息构造（不复制消息）
      */
     error_t(error_code_t code, const char* message)
         : m_code(code)
-        , m_message(message ? message : "") {}
+        , m_message(message) {}
+
+    /**
+     * @brief 从错误码和运行时消息构造
+     */
+    error_t(error_code_t code, const std::string& message)
+        : m_code(code) {
+        if (!message.empty()) {
+            m_detail = new detail::error_detail_t();
+            m_detail->message = message;
+        }
+    }
+
+    error_t(const error_t& other)
+        : m_code(other.m_code)
+        , m_message(other.m_message)
+        , m_detail(other.m_detail) {
+        if (m_detail) {
+            m_detail->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    error_t(error_t&& other) noexcept
+        : m_code(other.m_code)
+        , m_message(other.m_message)
+        , m_detail(other.m_detail) {
+        other.m_detail = nullptr;
+    }
+
+    error_t& operator=(const error_t& other) {
+        if (this != &other) {
+            error_t copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    error_t& operator=(error_t&& other) noexcept {
+        if (this != &other) {
+            _release();
+            m_code = other.m_code;
+            m_message = other.m_message;
+            m_detail = other.m_detail;
+            other.m_detail = nullptr;
+        }
+        return *this;
+    }
+
+    ~error_t() {
+        _release();
+    }
+
+    void swap(error_t& other) noexcept {
+        std::swap(m_code, other.m_code);
+        std::swap(m_message, other.m_message);
+        std::swap(m_detail, other.m_detail);
+    }
 
     // 访问器
     error_code_t code() const { return m_code; }
     error_category_t category() const { return get_error_category(m_code); }
-    const std::string& message() const { return m_message; }
-    const std::string& context() const { return m_context; }
+
+    error_text_t message() const {
+        if (m_message) {
+            return error_text_t(m_message);
+        }
+        return error_text_t(m_detail ? m_detail->message.c_str() : nullptr);
+    }
+
+    error_text_t context() const {
+        return error_text_t(m_detail ? m_detail->context.c_str() : nullptr);
+    }
 
     /**
      * @brief 添加上下文信息
      */
     error_t& with_context(const std::string& ctx) {
-        if (!m_context.empty()) {
-            m_context += " <- ";
+        detail::error_detail_t& detail = _own_detail();
+        if (!detail.context.empty()) {
+            detail.context += " <- ";
         }
-        m_context += ctx;
+        detail.context += ctx;
         return *this;
     }
 
@@ -268,17 +394,23 @@ public:
     std::string to_string() const {
         std::ostringstream oss;
         oss << get_error_name(m_code) << "(" << static_cast<int>(m_code) << ")";
-        if (!m_message.empty()) {
-            oss << ": " << m_message;
+        const error_text_t text = message();
+        if (!text.empty()) {
+            oss << ": " << text;
         }
-        if (!m_context.empty()) {
-            oss << " [" << m_context << "]";
+        const error_text_t ctx = context();
+        if (!ctx.empty()) {
+            oss << " [" << ctx << "]";
         }
         return oss.str();
     }
 
     // 便捷构造
-    static error_t make(error_code_t code, const std::string& msg = "") {
+    static error_t make(error_code_t code, const char* msg = nullptr) {
+        return error_t(code, msg);
+    }
+
+    static error_t make(error_code_t code, const std::string& msg) {
         return error_t(code, msg);
     }
 
@@ -286,18 +418,53 @@ public:
         return error_t(code, msg);
     }
 
+    static error_t transport(error_code_t code, const char* msg) {
+        return error_t(code, msg);
+    }
+
     static error_t device(error_code_t code, const std::string& msg) {
         return error_t(code, msg);
     }
 
+    static error_t device(error_code_t code, const char* msg) {
+        return error_t(code, msg);
+    }
+
     static error_t protocol(error_code_t code, const std::string& msg) {
         return error_t(code, msg);
     }
 
+    static error_t protocol(error_code_t code, const char* msg) {
+        return error_t(code, msg);
+    }
+
 private:
+    void _release() {
+        if (m_detail && m_detail->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete m_detail;
+        }
+        m_detail = nullptr;
+    }
+
+    /**
+     * @brief 获取独占的详情块（写时复制）
+     */
+    detail::error_detail_t& _own_detail() {
+        if (!m_detail) {
+            m_detail = new detail::error_detail_t();
+        } else if (m_detail->refs.load(std::memory_order_acquire) != 1) {
+            detail::error_detail_t* copy = new detail::error_detail_t();
+            copy->message = m_detail->message;
+            copy->context = m_detail->context;
+            _release();
+            m_detail = copy;
+        }
+        return *m_detail;
+    }
+
     error_code_t m_code;
-    std::string m_message;
-    std::string m_context;
+    const char* m_message = nullptr;                ///< 静态消息，为空时使用详情块中的消息
+    detail::error_detail_t* m_detail = nullptr;     ///< 动态部分，没有时为空
 };
 
 // ============================================================================
@@ -336,14 +503,23 @@ inline result_t<void> make_ok() {
  * @brief 创建错误结果
  */
 template<typename T>
-inline result_t<T> make_error(error_code_t code, const std::string& msg = "") {
+inline result_t<T> make_error(error_code_t code, const char* msg = nullptr) {
+    return tl::make_unexpected(error_t(code, msg));
+}
+
+template<typename T>
+inline result_t<T> make_error(error_code_t code, const std::string& msg) {
     return tl::make_unexpected(error_t(code, msg));
 }
 
 /**
  * @brief 创建 void 类型的错误结果
  */
-inline result_t<void> make_error_void(error_code_t code, const std::string& msg = "") {
+inline result_t<void> make_error_void(error_code_t code, const char* msg = nullptr) {
+    return tl::make_unexpected(error_t(code, msg));
+}
+
+inline result_t<void> make_error_void(error_code_t code, const std::string& msg) {
     return tl::make_unexpected(error_t(code, msg));
 }
 
@@ -357,7 +533,11 @@ inline result_t<void> make_error_void(const error_t& err) {
 /**
  * @brief 创建 unexpected 错误对象
  */
-inline tl::unexpected<error_t> make_unexpected(error_code_t code, const std::string& msg = "") {
+inline tl::unexpected<error_t> make_unexpected(error_code_t code, const char* msg = nullptr) {
+    return tl::make_unexpected(error_t(code, msg));
+}
+
+inline tl::unexpected<error_t> make_unexpected(error_code_t code, const std::string& msg) {
     return tl::make_unexpected(error_t(code, msg));
 }
 
@@ -0,0 +1,276 @@
+/**
+ * @file event_dispatcher.hpp
+ * @brief 异步事件分发器
+ *
+ * 心跳和重连线程把事件复制进无锁队列后立即返回，
+ * 用户回调在专用的分发线程中执行，慢回调不会拖慢心跳或命令路径。
+ */
+
+#ifndef VDL_CORE_EVENT_DISPATCHER_HPP
+#define VDL_CORE_EVENT_DISPATCHER_HPP
+
+#include "types.hpp"
+#include "noncopyable.hpp"
+#include "mpsc_queue.hpp"
+#include "logging.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace vdl {
+
+// ============================================================================
+// event_dispatcher_t - 事件分发器
+// ============================================================================
+
+/**
+ * @brief 异步事件分发器
+ *
+ * - post() 可在任意线程调用，无锁入队；队列满时让出 CPU 直到有空位（不丢事件）
+ * - 事件按投递顺序在同一个分发线程中执行
+ * - post_coalesced()：同一合并标志的事件尚未执行时，新事件被合并（丢弃并计数），
+ *   用于高频且内容相同的事件（如连续的心跳成功）
+ * - flush() 等待此前投递的事件全部执行完
+ *
+ * @code
+ * event_dispatcher_t& dispatcher = event_dispatcher_t::instance();
+ * runner.set_event_dispatcher(&dispatcher, true);   // 合并连续的 success 事件
+ * device.set_event_dispatcher(&dispatcher);
+ * @endcode
+ *
+ * @note 回调在分发线程中执行；在回调中调用 post()/flush() 是安全的
+ */
+class event_dispatcher_t : private noncopyable_t, private nonmovable_t {
+public:
+    using task_t = std::function<void()>;
+    using coalesce_flag_t = std::shared_ptr<std::atomic<bool>>;
+
+    static constexpr size_t k_default_queue_capacity = 1024;
+
+    /**
+     * @brief 构造函数（启动分发线程）
+     * @param queue_capacity 待执行事件的最大数量
+     */
+    explicit event_dispatcher_t(size_t queue_capacity = k_default_queue_capacity)
+        : m_queue(queue_capacity) {
+        m_thread = std::thread([this] { _run(); });
+    }
+
+    /**
+     * @brief 析构函数：执行完已投递的事件后停止
+     */
+    ~event_dispatcher_t() {
+        stop();
+    }
+
+    /**
+     * @brief 进程级共享分发器（首次使用时创建）
+     */
+    static event_dispatcher_t& instance() {
+        static event_dispatcher_t dispatcher;
+        return dispatcher;
+    }
+
+    /**
+     * @brief 创建合并标志（每个事件源一个）
+     */
+    static coalesce_flag_t make_coalesce_flag() {
+        return std::make_shared<std::atomic<bool>>(false);
+    }
+
+    // ========================================================================
+    // 投递（任意线程）
+    // ========================================================================
+
+    /**
+     * @brief 投递事件
+     * @return 分发器已停止时返回 false（事件被丢弃）
+     */
+    bool post(task_t task) {
+        if (!task || m_stopping.load(std::memory_order_acquire)) {
+            return false;
+        }
+        while (!m_queue.try_push(std::move(task))) {
+            // 分发线程自身投递时不能等待自己，直接执行
+            if (in_dispatcher_thread()) {
+                _invoke(task);
+                return true;
+            }
+            if (m_stopping.load(std::memory_order_acquire)) {
+                return false;
+            }
+            _wake();
+            std::this_thread::yield();
+        }
+        _wake();
+        return true;
+    }
+
+    /**
+     * @brief 投递可合并的事件
+     *
+     * flag 已置位（同源事件仍在队列中）时不再入队，只增加合并计数。
+     */
+    bool post_coalesced(const coalesce_flag_t& flag, task_t task) {
+        if (!flag) {
+            return post(std::move(task));
+        }
+        if (flag->exchange(true, std::memory_order_acq_rel)) {
+            m_coalesced.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        coalesce_flag_t held = flag;
+        const bool posted = post([held, task] {
+            // 执行前清除标志：执行期间到达的同源事件会再次入队
+            held->store(false, std::memory_order_release);
+            task();
+        });
+        if (!posted) {
+            flag->store(false, std::memory_order_release);
+        }
+        return posted;
+    }
+
+    /**
+     * @brief 等待此前投递的事件全部执行完
+     *
+     * 在分发线程中调用时立即返回。
+     */
+    void flush() {
+        if (in_dispatcher_thread()) {
+            return;
+        }
+        const size_t target = m_queue.push_count();
+        std::unique_lock<std::mutex> lock(m_wake_mutex);
+        // 与 _run() 中 m_executed 的存储/m_flush_waiters 的读取配对（均为 seq_cst）：
+        // 分发线程没看到等待者时，这里一定能看到新的 m_executed，不会丢失唤醒
+        m_flush_waiters.fetch_add(1, std::memory_order_seq_cst);
+        _wake_locked();
+        m_flushed.wait(lock, [this, target] {
+            return m_executed.load(std::memory_order_seq_cst) >= target ||
+                   !m_running.load(std::memory_order_acquire);
+        });
+        m_flush_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 停止分发线程（已投递的事件先执行完）
+     */
+    void stop() {
+        m_stopping.store(true, std::memory_order_release);
+        std::thread worker;
+        {
+            std::lock_guard<std::mutex> guard(m_wake_mutex);
+            worker.swap(m_thread);
+            m_wake.notify_one();
+        }
+        if (worker.joinable()) {
+            if (worker.get_id() == std::this_thread::get_id()) {
+                worker.detach();
+            } else {
+                worker.join();
+            }
+        }
+    }
+
+    bool in_dispatcher_thread() const {
+        return m_thread_id.load(std::memory_order_acquire) == std::this_thread::get_id();
+    }
+
+    // ========================================================================
+    // 统计
+    // ========================================================================
+
+    uint64_t delivered_count() const {
+        return m_delivered.load(std::memory_order_relaxed);
+    }
+
+    uint64_t coalesced_count() const {
+        return m_coalesced.load(std::memory_order_relaxed);
+    }
+
+    size_t pending() const {
+        return m_queue.size();
+    }
+
+private:
+    void _run() {
+        m_thread_id.store(std::this_thread::get_id(), std::memory_order_release);
+        task_t task;
+        while (true) {
+            if (m_queue.try_pop(task)) {
+                _invoke(task);
+                task = nullptr;
+                m_delivered.fetch_add(1, std::memory_order_relaxed);
+                m_executed.store(m_queue.pop_count(), std::memory_order_seq_cst);
+                if (m_flush_waiters.load(std::memory_order_seq_cst) > 0) {
+                    std::lock_guard<std::mutex> guard(m_wake_mutex);
+                    m_flushed.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            if (m_stopping.load(std::memory_order_acquire) && m_queue.empty()) {
+                break;
+            }
+            m_sleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // 声明休眠后再检查一次，避免错过生产者的唤醒
+            if (m_queue.empty() && !m_stopping.load(std::memory_order_acquire)) {
+                m_wake.wait(lock);
+            }
+            m_sleeping.store(false);
+        }
+
+        std::lock_guard<std::mutex> guard(m_wake_mutex);
+        m_running.store(false, std::memory_order_release);
+        m_flushed.notify_all();
+    }
+
+    static void _invoke(const task_t& task) {
+        try {
+            task();
+        } catch (const std::exception& e) {
+            VDL_LOG_WARN("Event callback threw exception: %s", e.what());
+        }
+    }
+
+    void _wake() {
+        // 两侧的全序栅栏保证“入队后读标志”和“置标志后读队列”至少一方看到对方
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleeping.exchange(false)) {
+            std::lock_guard<std::mutex> guard(m_wake_mutex);
+            m_wake.notify_one();
+        }
+    }
+
+    void _wake_locked() {
+        m_sleeping.store(false);
+        m_wake.notify_one();
+    }
+
+    mpsc_queue_t<task_t> m_queue;
+    std::atomic<uint64_t> m_delivered{0};
+    std::atomic<uint64_t> m_coalesced{0};
+    std::atomic<size_t> m_executed{0};          ///< 已执行到的队列位置
+    std::atomic<uint32_t> m_flush_waiters{0};
+
+    std::mutex m_wake_mutex;                    ///< 分发线程休眠与 flush() 等待
+    std::condition_variable m_wake;
+    std::condition_variable m_flushed;
+    std::atomic<bool> m_sleeping{false};
+    std::atomic<bool> m_stopping{false};
+    std::atomic<bool> m_running{true};
+    std::atomic<std::thread::id> m_thread_id{std::thread::id()};
+    std::thread m_thread;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CORE_EVENT_DISPATCHER_HPP
@@ -0,0 +1,323 @@
+/**
+ * @file fair_mutex.hpp
+ * @brief 公平的可重入互斥锁
+ *
+ * 提供 fair_mutex_t，用于串行化对同一设备的访问。
+ * 排队按优先级分级（设备层映射为 control/normal/bulk/heartbeat），
+ * 同级内 FIFO。
+ */
+
+#ifndef VDL_CORE_FAIR_MUTEX_HPP
+#define VDL_CORE_FAIR_MUTEX_HPP
+
+#include "types.hpp"
+#include "noncopyable.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace vdl {
+
+// ============================================================================
+// 加锁优先级
+// ============================================================================
+
+constexpr uint8_t k_lock_priority_levels = 4;     ///< 优先级级数（0 最高）
+constexpr uint8_t k_default_lock_priority = 1;    ///< 未设置时的优先级
+
+namespace detail {
+
+inline uint8_t clamp_lock_priority(uint8_t priority) {
+    return priority < k_lock_priority_levels ? priority
+                                             : static_cast<uint8_t>(k_lock_priority_levels - 1);
+}
+
+inline uint8_t& thread_lock_priority() {
+    static thread_local uint8_t priority = k_default_lock_priority;
+    return priority;
+}
+
+}  // namespace detail
+
+/**
+ * @brief 当前线程排队时使用的优先级
+ */
+inline uint8_t current_lock_priority() {
+    return detail::thread_lock_priority();
+}
+
+/**
+ * @brief 优先级作用域：作用域内当前线程对 fair_mutex_t 的排队使用指定优先级
+ *
+ * 可嵌套，析构时恢复原优先级。
+ */
+class lock_priority_scope_t : private noncopyable_t {
+public:
+    explicit lock_priority_scope_t(uint8_t priority)
+        : m_previous(detail::thread_lock_priority()) {
+        detail::thread_lock_priority() = detail::clamp_lock_priority(priority);
+    }
+
+    ~lock_priority_scope_t() {
+        detail::thread_lock_priority() = m_previous;
+    }
+
+private:
+    uint8_t m_previous;
+};
+
+/**
+ * @brief 某一优先级的排队统计
+ *
+ * 只统计需要排队的加锁；无竞争的快速路径不计入。
+ */
+struct lock_wait_stats_t {
+    uint32_t waiting = 0;           ///< 当前排队数
+    uint64_t waits = 0;             ///< 累计排队次数（含超时放弃）
+    uint64_t timeouts = 0;          ///< 超时放弃次数
+    uint64_t total_wait_ns = 0;     ///< 累计排队时间
+    uint64_t max_wait_ns = 0;       ///< 最长一次排队时间
+
+    uint64_t mean_wait_ns() const {
+        return waits == 0 ? 0 : total_wait_ns / waits;
+    }
+};
+
+// ============================================================================
+// fair_mutex_t - 公平可重入互斥锁
+// ============================================================================
+
+/**
+ * @brief 公平的可重入互斥锁
+ *
+ * - 无竞争时只有一次原子 CAS，不进入内核
+ * - 有等待者时按优先级移交，同一优先级内 FIFO，新来的线程不能插队
+ *   （排队优先级取自当前线程的 lock_priority_scope_t，默认 k_default_lock_priority）
+ * - 同一线程可重复加锁，需对应次数的 unlock()
+ * - 支持带超时的 try_lock_for()
+ *
+ * 满足 Lockable 要求，可与 std::lock_guard / std::unique_lock 搭配使用。
+ *
+ * @code
+ * fair_mutex_t mutex;
+ * {
+ *     std::lock_guard<fair_mutex_t> lock(mutex);
+ *     // 独占访问
+ * }
+ *
+ * if (mutex.try_lock_for(100)) {
+ *     // ...
+ *     mutex.unlock();
+ * }
+ * @endcode
+ */
+class fair_mutex_t : private noncopyable_t, private nonmovable_t {
+public:
+    fair_mutex_t() = default;
+
+    /**
+     * @brief 阻塞加锁
+     */
+    void lock() {
+        _lock_until(nullptr);
+    }
+
+    /**
+     * @brief 尝试加锁（不阻塞）
+     * @return 成功返回 true；已被其他线程持有或有线程在排队时返回 false
+     */
+    bool try_lock() {
+        if (_owned_by_current_thread()) {
+            ++m_depth;
+            return true;
+        }
+        return _try_acquire_fast();
+    }
+
+    /**
+     * @brief 带超时的加锁
+     * @param timeout_ms 最长等待时间（毫秒），<= 0 等同于 try_lock()
+     * @return 成功返回 true，超时返回 false
+     */
+    bool try_lock_for(milliseconds_t timeout_ms) {
+        if (timeout_ms <= 0) {
+            return try_lock();
+        }
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::milliseconds(timeout_ms);
+        return _lock_until(&deadline);
+    }
+
+    /**
+     * @brief 解锁
+     *
+     * @note 必须由持有锁的线程调用
+     */
+    void unlock() {
+        if (--m_depth > 0) {
+            return;
+        }
+
+        m_owner.store(std::thread::id(), std::memory_order_relaxed);
+        m_locked.store(false, std::memory_order_seq_cst);
+
+        // 有排队者时唤醒队首
+        if (m_waiters.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_cv.notify_all();
+        }
+    }
+
+    /**
+     * @brief 检查锁是否被某个线程持有
+     */
+    bool is_locked() const {
+        return m_locked.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 检查当前线程是否持有锁
+     */
+    bool owned_by_current_thread() const {
+        return _owned_by_current_thread();
+    }
+
+    /**
+     * @brief 某一优先级的排队统计
+     */
+    lock_wait_stats_t wait_stats(uint8_t priority) const {
+        const uint8_t level = detail::clamp_lock_priority(priority);
+        std::lock_guard<std::mutex> guard(m_mutex);
+        lock_wait_stats_t stats = m_stats[level];
+        stats.waiting = static_cast<uint32_t>(m_queues[level].size());
+        return stats;
+    }
+
+    /**
+     * @brief 清零排队统计
+     */
+    void reset_wait_stats() {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        for (auto& stats : m_stats) {
+            stats = lock_wait_stats_t();
+        }
+    }
+
+private:
+    using clock_t = std::chrono::steady_clock;
+
+    bool _owned_by_current_thread() const {
+        return m_locked.load(std::memory_order_acquire) &&
+               m_owner.load(std::memory_order_relaxed) == std::this_thread::get_id();
+    }
+
+    // 无竞争快速路径：没有排队者时直接 CAS
+    bool _try_acquire_fast() {
+        if (m_waiters.load(std::memory_order_seq_cst) != 0) {
+            return false;
+        }
+        return _try_acquire();
+    }
+
+    bool _try_acquire() {
+        bool expected = false;
+        if (!m_locked.compare_exchange_strong(expected, true, std::memory_order_seq_cst)) {
+            return false;
+        }
+        m_owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        m_depth = 1;
+        return true;
+    }
+
+    bool _lock_until(const clock_t::time_point* deadline) {
+        if (_owned_by_current_thread()) {
+            ++m_depth;
+            return true;
+        }
+        if (_try_acquire_fast()) {
+            return true;
+        }
+
+        // 慢速路径：按优先级排队等待
+        const uint8_t priority = current_lock_priority();
+        const clock_t::time_point queued = clock_t::now();
+        std::unique_lock<std::mutex> guard(m_mutex);
+        std::deque<uint64_t>& queue = m_queues[priority];
+        const uint64_t ticket = m_next_ticket++;
+        queue.push_back(ticket);
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+
+        bool acquired = false;
+        for (;;) {
+            if (_is_head(priority, ticket) && _try_acquire()) {
+                acquired = true;
+                break;
+            }
+            if (deadline == nullptr) {
+                m_cv.wait(guard);
+            } else if (m_cv.wait_until(guard, *deadline) == std::cv_status::timeout) {
+                if (_is_head(priority, ticket) && _try_acquire()) {
+                    acquired = true;
+                }
+                break;
+            }
+        }
+
+        // 离开队列（成功或超时）
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            if (*it == ticket) {
+                queue.erase(it);
+                break;
+            }
+        }
+        m_waiters.fetch_sub(1, std::memory_order_seq_cst);
+
+        lock_wait_stats_t& stats = m_stats[priority];
+        const auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            clock_t::now() - queued).count();
+        const uint64_t waited_ns = waited > 0 ? static_cast<uint64_t>(waited) : 0;
+        ++stats.waits;
+        stats.total_wait_ns += waited_ns;
+        if (waited_ns > stats.max_wait_ns) {
+            stats.max_wait_ns = waited_ns;
+        }
+        if (!acquired) {
+            ++stats.timeouts;
+            // 让下一个排队者有机会获取
+            m_cv.notify_all();
+        }
+        return acquired;
+    }
+
+    std::atomic<bool> m_locked{false};
+    std::atomic<std::thread::id> m_owner{std::thread::id()};
+    std::atomic<uint32_t> m_waiters{0};
+    uint32_t m_depth = 0;               ///< 重入深度（仅持有者访问）
+
+    /**
+     * @brief 票号是否排在所有更高优先级的队列之后的队首
+     */
+    bool _is_head(uint8_t priority, uint64_t ticket) const {
+        for (uint8_t level = 0; level < priority; ++level) {
+            if (!m_queues[level].empty()) {
+                return false;
+            }
+        }
+        return m_queues[priority].front() == ticket;
+    }
+
+    mutable std::mutex m_mutex;         ///< 保护排队状态
+    std::condition_variable m_cv;
+    std::deque<uint64_t> m_queues[k_lock_priority_levels];   ///< 按优先级的排队票号
+    lock_wait_stats_t m_stats[k_lock_priority_levels];
+    uint64_t m_next_ticket = 0;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CORE_FAIR_MUTEX_HPP
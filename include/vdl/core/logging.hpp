@@ -1,15 +1,47 @@
 /**
  * @file logging.hpp
  * @brief VDL 日志接口
- * 
- * 提供简单的日志宏和接口。
+ *
+ * 提供日志宏、可替换的输出端（sink）和可选的异步后端。
+ *
+ * - 编译期过滤：低于 VDL_LOG_ACTIVE_LEVEL 的宏编译为空，参数不求值
+ * - 运行期过滤：先检查级别再求值参数，被过滤的日志不产生函数调用
+ * - 异步后端：格式化好的记录放入无锁队列，后台线程写入 sink，生产者从不阻塞
+ *
+ * @code
+ * // 编译期去掉 trace/debug：-DVDL_LOG_ACTIVE_LEVEL=2（CMake: -DVDL_LOG_ACTIVE_LEVEL=2）
+ * vdl::set_log_level(vdl::log_level_t::debug);
+ * vdl::enable_async_logging();          // 设备线程不再争用 stderr
+ * ...
+ * vdl::disable_async_logging();         // 退出前写完剩余记录
+ * @endcode
  */
 
 #ifndef VDL_CORE_LOGGING_HPP
 #define VDL_CORE_LOGGING_HPP
 
+#include "types.hpp"
+#include "noncopyable.hpp"
+#include "mpsc_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdarg>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief 编译期日志级别下限（0=trace … 6=off）
+ *
+ * 低于该级别的 VDL_LOG_* 宏展开为空语句。
+ */
+#ifndef VDL_LOG_ACTIVE_LEVEL
+#define VDL_LOG_ACTIVE_LEVEL 0
+#endif
 
 namespace vdl {
 
@@ -28,16 +60,41 @@ enum class log_level_t {
 };
 
 // ============================================================================
-// 日志配置
+// 日志记录与输出端
 // ============================================================================
 
-namespace detail {
+/**
+ * @brief 一条已格式化的日志记录
+ *
+ * message 只在 write() 调用期间有效。
+ */
+struct log_record_t {
+    log_level_t level = log_level_t::info;
+    const char* file = "";                          ///< 源文件（字符串字面量）
+    int line = 0;
+    std::chrono::system_clock::time_point time;     ///< 产生时间
+    const char* message = "";                       ///< 格式化后的消息（不含换行）
+    size_t length = 0;
+};
 
-// 全局日志级别
-inline log_level_t& get_log_level() {
-    static log_level_t s_level = log_level_t::info;
-    return s_level;
-}
+/**
+ * @brief 日志输出端接口
+ *
+ * 同步模式下 write() 在产生日志的线程中调用（可能并发）；
+ * 异步模式下只在后台线程中调用。
+ */
+class i_log_sink_t {
+public:
+    virtual ~i_log_sink_t() = default;
+
+    virtual void write(const log_record_t& record) = 0;
+
+    virtual void flush() {}
+};
+
+using log_sink_ptr_t = std::shared_ptr<i_log_sink_t>;
+
+namespace detail {
 
 // 日志级别名称
 inline const char* get_level_name(log_level_t level) {
@@ -52,21 +109,246 @@ inline const char* get_level_name(log_level_t level) {
     }
 }
 
-// 简单日志输出
+}  // namespace detail
+
+/**
+ * @brief 默认输出端：每条记录一次 fwrite 到 stderr
+ */
+class stderr_log_sink_t : public i_log_sink_t {
+public:
+    void write(const log_record_t& record) override {
+        char line[k_line_size];
+        int prefix = std::snprintf(line, sizeof(line), "[%s] %s:%d: ",
+                                   detail::get_level_name(record.level),
+                                   record.file, record.line);
+        if (prefix < 0) {
+            return;
+        }
+        size_t used = static_cast<size_t>(prefix) < sizeof(line) - 1
+            ? static_cast<size_t>(prefix) : sizeof(line) - 1;
+        const size_t room = sizeof(line) - 1 - used;
+        const size_t body = record.length < room ? record.length : room;
+        std::memcpy(line + used, record.message, body);
+        used += body;
+        line[used++] = '\n';
+        std::fwrite(line, 1, used, stderr);
+    }
+
+    void flush() override {
+        std::fflush(stderr);
+    }
+
+private:
+    static constexpr size_t k_line_size = 1024;
+};
+
+// ============================================================================
+// async_log_backend_t - 异步后端
+// ============================================================================
+
+namespace detail {
+log_sink_ptr_t current_log_sink();
+}  // namespace detail
+
+/**
+ * @brief 异步日志后端
+ *
+ * - push() 把记录复制进定长槽位的 MPSC 无锁队列；队列满时丢弃并计数，从不阻塞
+ * - 后台线程每 flush_interval 或队列过半时醒来，把记录交给当前 sink
+ * - 消息超过 k_message_size - 1 字节时截断
+ */
+class async_log_backend_t : private noncopyable_t, private nonmovable_t {
+public:
+    static constexpr size_t k_message_size = 384;
+    static constexpr size_t k_default_capacity = 1024;
+    static constexpr milliseconds_t k_default_flush_interval = 10;
+
+    explicit async_log_backend_t(size_t capacity = k_default_capacity,
+                                 milliseconds_t flush_interval = k_default_flush_interval)
+        : m_queue(capacity)
+        , m_flush_interval(flush_interval > 0 ? flush_interval : 1) {
+        m_thread = std::thread([this] { _run(); });
+    }
+
+    ~async_log_backend_t() {
+        stop();
+    }
+
+    /**
+     * @brief 投递一条记录（任意线程，不阻塞）
+     * @return 队列已满或后端已停止时返回 false
+     */
+    bool push(const log_record_t& record) {
+        if (m_stopping.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slot_t slot;
+        slot.level = record.level;
+        slot.file = record.file;
+        slot.line = record.line;
+        slot.time = record.time;
+        slot.length = record.length < k_message_size - 1 ? record.length : k_message_size - 1;
+        std::memcpy(slot.message, record.message, slot.length);
+        if (!m_queue.try_push(slot)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (m_queue.size() * 2 >= m_queue.capacity()) {
+            m_wake.notify_one();
+        }
+        return true;
+    }
+
+    /**
+     * @brief 等待此前投递的记录全部写入 sink
+     */
+    void flush() {
+        const size_t target = m_queue.push_count();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+        m_flushed.wait(lock, [this, target] {
+            return m_written.load(std::memory_order_acquire) >= target ||
+                   !m_running.load(std::memory_order_acquire);
+        });
+    }
+
+    /**
+     * @brief 写完剩余记录后停止后台线程
+     */
+    void stop() {
+        m_stopping.store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_wake.notify_one();
+        }
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    uint64_t dropped_count() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct slot_t {
+        log_level_t level;
+        const char* file;
+        int line;
+        std::chrono::system_clock::time_point time;
+        size_t length;
+        char message[k_message_size];
+    };
+
+    void _run() {
+        slot_t slot;
+        while (true) {
+            bool wrote = false;
+            log_sink_ptr_t sink;
+            while (m_queue.try_pop(slot)) {
+                if (!sink) {
+                    sink = detail::current_log_sink();
+                }
+                slot.message[slot.length] = '\0';
+                log_record_t record;
+                record.level = slot.level;
+                record.file = slot.file;
+                record.line = slot.line;
+                record.time = slot.time;
+                record.message = slot.message;
+                record.length = slot.length;
+                sink->write(record);
+                m_written.store(m_queue.pop_count(), std::memory_order_release);
+                wrote = true;
+            }
+            if (wrote) {
+                sink->flush();
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_flushed.notify_all();
+            if (m_stopping.load(std::memory_order_acquire) && m_queue.empty()) {
+                break;
+            }
+            m_wake.wait_for(lock, std::chrono::milliseconds(m_flush_interval));
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running.store(false, std::memory_order_release);
+        m_flushed.notify_all();
+    }
+
+    mpsc_queue_t<slot_t> m_queue;
+    const milliseconds_t m_flush_interval;
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<size_t> m_written{0};           ///< 已写入 sink 的队列位置
+    std::atomic<bool> m_stopping{false};
+    std::atomic<bool> m_running{true};
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_flushed;
+    std::thread m_thread;
+};
+
+// ============================================================================
+// 日志配置
+// ============================================================================
+
+namespace detail {
+
+struct log_state_t {
+    std::atomic<int> level{static_cast<int>(log_level_t::info)};
+    log_sink_ptr_t sink = std::make_shared<stderr_log_sink_t>();   ///< 只通过 atomic_load/atomic_store 访问
+    std::shared_ptr<async_log_backend_t> async;                    ///< 只通过 atomic_load/atomic_store 访问
+};
+
+// 全局日志状态（有意不析构，静态对象析构期间仍可记录日志）
+inline log_state_t& log_state() {
+    static log_state_t* s_state = new log_state_t();
+    return *s_state;
+}
+
+inline log_sink_ptr_t current_log_sink() {
+    return std::atomic_load(&log_state().sink);
+}
+
+inline bool log_enabled(log_level_t level) {
+    return static_cast<int>(level) >= log_state().level.load(std::memory_order_relaxed);
+}
+
+// 仅用于被编译期过滤的宏：在不求值的上下文中“使用”参数，避免未使用变量告警
+int log_discard(const char* fmt, ...);
+
+// 格式化并输出一条日志（调用前已检查级别）
 inline void log_output(log_level_t level, const char* file, int line,
                        const char* fmt, ...) {
-    if (level < get_log_level()) {
+    if (!log_enabled(level)) {
         return;
     }
 
-    std::fprintf(stderr, "[%s] %s:%d: ", get_level_name(level), file, line);
-
+    char message[async_log_backend_t::k_message_size];
     va_list args;
     va_start(args, fmt);
-    std::vfprintf(stderr, fmt, args);
+    const int written = std::vsnprintf(message, sizeof(message), fmt, args);
     va_end(args);
+    if (written < 0) {
+        return;
+    }
+
+    log_record_t record;
+    record.level = level;
+    record.file = file;
+    record.line = line;
+    record.time = std::chrono::system_clock::now();
+    record.message = message;
+    record.length = static_cast<size_t>(written) < sizeof(message) - 1
+        ? static_cast<size_t>(written) : sizeof(message) - 1;
 
-    std::fprintf(stderr, "\n");
+    std::shared_ptr<async_log_backend_t> async = std::atomic_load(&log_state().async);
+    if (async) {
+        async->push(record);   // 队列已满时丢弃并计数，不阻塞调用线程
+        return;
+    }
+    current_log_sink()->write(record);
 }
 
 }  // namespace detail
@@ -79,14 +361,84 @@ inline void log_output(log_level_t level, const char* file, int line,
  * @brief 设置日志级别
  */
 inline void set_log_level(log_level_t level) {
-    detail::get_log_level() = level;
+    detail::log_state().level.store(static_cast<int>(level), std::memory_order_relaxed);
 }
 
 /**
  * @brief 获取当前日志级别
  */
 inline log_level_t get_log_level() {
-    return detail::get_log_level();
+    return static_cast<log_level_t>(detail::log_state().level.load(std::memory_order_relaxed));
+}
+
+/**
+ * @brief 替换日志输出端（nullptr 恢复默认的 stderr）
+ */
+inline void set_log_sink(log_sink_ptr_t sink) {
+    if (!sink) {
+        sink = std::make_shared<stderr_log_sink_t>();
+    }
+    std::atomic_store(&detail::log_state().sink, std::move(sink));
+}
+
+/**
+ * @brief 当前日志输出端
+ */
+inline log_sink_ptr_t get_log_sink() {
+    return detail::current_log_sink();
+}
+
+/**
+ * @brief 启用异步日志（已启用时无效果）
+ * @param capacity 待写入记录的最大数量，队列满时新记录被丢弃
+ * @param flush_interval 后台线程的最长休眠时间
+ */
+inline void enable_async_logging(size_t capacity = async_log_backend_t::k_default_capacity,
+                                 milliseconds_t flush_interval =
+                                     async_log_backend_t::k_default_flush_interval) {
+    auto& state = detail::log_state();
+    if (std::atomic_load(&state.async)) {
+        return;
+    }
+    std::atomic_store(&state.async,
+                      std::make_shared<async_log_backend_t>(capacity, flush_interval));
+}
+
+/**
+ * @brief 关闭异步日志：写完剩余记录后恢复同步输出
+ */
+inline void disable_async_logging() {
+    auto previous = std::atomic_exchange(&detail::log_state().async,
+                                         std::shared_ptr<async_log_backend_t>());
+    if (previous) {
+        previous->stop();
+    }
+}
+
+/**
+ * @brief 是否启用了异步日志
+ */
+inline bool async_logging_enabled() {
+    return static_cast<bool>(std::atomic_load(&detail::log_state().async));
+}
+
+/**
+ * @brief 等待已产生的日志全部写入输出端
+ */
+inline void flush_log() {
+    auto async = std::atomic_load(&detail::log_state().async);
+    if (async) {
+        async->flush();
+    }
+    detail::current_log_sink()->flush();
+}
+
+/**
+ * @brief 异步模式下因队列已满丢弃的记录数
+ */
+inline uint64_t log_dropped_count() {
+    auto async = std::atomic_load(&detail::log_state().async);
+    return async ? async->dropped_count() : 0;
 }
 
 }  // namespace vdl
@@ -95,22 +447,50 @@ inline log_level_t get_log_level() {
 // 日志宏
 // ============================================================================
 
-#define VDL_LOG_TRACE(fmt, ...) \
-    vdl::detail::log_output(vdl::log_level_t::trace, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#define VDL_LOG_IMPL_(level, fmt, ...)                                                \
+    do {                                                                              \
+        if (vdl::detail::log_enabled(level)) {                                        \
+            vdl::detail::log_output(level, __FILE__, __LINE__, fmt, ##__VA_ARGS__);   \
+        }                                                                             \
+    } while (0)
+
+#define VDL_LOG_DISCARD_(fmt, ...) \
+    do { (void)sizeof(vdl::detail::log_discard(fmt, ##__VA_ARGS__)); } while (0)
+
+#if VDL_LOG_ACTIVE_LEVEL <= 0
+#define VDL_LOG_TRACE(fmt, ...) VDL_LOG_IMPL_(vdl::log_level_t::trace, fmt, ##__VA_ARGS__)
+#else
+#define VDL_LOG_TRACE(fmt, ...) VDL_LOG_DISCARD_(fmt, ##__VA_ARGS__)
+#endif
 
-#define VDL_LOG_DEBUG(fmt, ...) \
-    vdl::detail::log_output(vdl::log_level_t::debug, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#if VDL_LOG_ACTIVE_LEVEL <= 1
+#define VDL_LOG_DEBUG(fmt, ...) VDL_LOG_IMPL_(vdl::log_level_t::debug, fmt, ##__VA_ARGS__)
+#else
+#define VDL_LOG_DEBUG(fmt, ...) VDL_LOG_DISCARD_(fmt, ##__VA_ARGS__)
+#endif
 
-#define VDL_LOG_INFO(fmt, ...) \
-    vdl::detail::log_output(vdl::log_level_t::info, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#if VDL_LOG_ACTIVE_LEVEL <= 2
+#define VDL_LOG_INFO(fmt, ...) VDL_LOG_IMPL_(vdl::log_level_t::info, fmt, ##__VA_ARGS__)
+#else
+#define VDL_LOG_INFO(fmt, ...) VDL_LOG_DISCARD_(fmt, ##__VA_ARGS__)
+#endif
 
-#define VDL_LOG_WARN(fmt, ...) \
-    vdl::detail::log_output(vdl::log_level_t::warn, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#if VDL_LOG_ACTIVE_LEVEL <= 3
+#define VDL_LOG_WARN(fmt, ...) VDL_LOG_IMPL_(vdl::log_level_t::warn, fmt, ##__VA_ARGS__)
+#else
+#define VDL_LOG_WARN(fmt, ...) VDL_LOG_DISCARD_(fmt, ##__VA_ARGS__)
+#endif
 
-#define VDL_LOG_ERROR(fmt, ...) \
-    vdl::detail::log_output(vdl::log_level_t::error, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#if VDL_LOG_ACTIVE_LEVEL <= 4
+#define VDL_LOG_ERROR(fmt, ...) VDL_LOG_IMPL_(vdl::log_level_t::error, fmt, ##__VA_ARGS__)
+#else
+#define VDL_LOG_ERROR(fmt, ...) VDL_LOG_DISCARD_(fmt, ##__VA_ARGS__)
+#endif
 
-#define VDL_LOG_CRITICAL(fmt, ...) \
-    vdl::detail::log_output(vdl::log_level_t::critical, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#if VDL_LOG_ACTIVE_LEVEL <= 5
+#define VDL_LOG_CRITICAL(fmt, ...) VDL_LOG_IMPL_(vdl::log_level_t::critical, fmt, ##__VA_ARGS__)
+#else
+#define VDL_LOG_CRITICAL(fmt, ...) VDL_LOG_DISCARD_(fmt, ##__VA_ARGS__)
+#endif
 
 #endif  // VDL_CORE_LOGGING_HPP
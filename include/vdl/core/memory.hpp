@@ -3,6 +3,11 @@
  * @brief 内存管理工具
  * 
  * 提供内存池和智能指针相关工具。
+ *
+ * - buffer_pool_t：固定大小的缓冲区池
+ * - size_class_pool_t：按 2 的幂分级的缓冲区池（线程缓存 + 无锁全局空闲表），
+ *   编解码和接收路径使用其进程级实例
+ * - slab_cache_t：复用解码用的整帧 slab
  */
 
 #ifndef VDL_CORE_MEMORY_HPP
@@ -11,8 +16,12 @@
 #include "compat.hpp"
 #include "noncopyable.hpp"
 #include "types.hpp"
+#include "buffer.hpp"
 
+#include <array>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <cstring>
 
@@ -24,6 +33,8 @@ namespace vdl {
 
 /**
  * @brief 缓冲区池，用于复用缓冲区减少内存分配
+ *
+ * 所有缓冲区大小相同，接口线程安全。大小不一的缓冲区使用 size_class_pool_t。
  * 
  * @code
  * buffer_pool_t pool(1024);  // 每个缓冲区 1024 字节
@@ -42,6 +53,7 @@ public:
      */
     explicit buffer_pool_t(size_t buffer_size, size_t initial_count = 4)
         : m_buffer_size(buffer_size) {
+        m_pool.reserve(initial_count);
         for (size_t i = 0; i < initial_count; ++i) {
             m_pool.push_back(bytes_t(buffer_size));
         }
@@ -52,6 +64,7 @@ public:
      * @return 缓冲区
      */
     bytes_t acquire() {
+        std::lock_guard<std::mutex> lock(m_mutex);
         if (!m_pool.empty()) {
             bytes_t buf = std::move(m_pool.back());
             m_pool.pop_back();
@@ -65,6 +78,7 @@ public:
      * @param buf 要归还的缓冲区
      */
     void release(bytes_t buf) {
+        std::lock_guard<std::mutex> lock(m_mutex);
         if (buf.size() == m_buffer_size && m_pool.size() < m_max_pool_size) {
             m_pool.push_back(std::move(buf));
         }
@@ -81,6 +95,7 @@ public:
      * @brief 获取池中缓冲区数量
      */
     size_t pool_size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
         return m_pool.size();
     }
 
@@ -88,6 +103,7 @@ public:
      * @brief 设置最大池大小
      */
     void set_max_pool_size(size_t max_size) {
+        std::lock_guard<std::mutex> lock(m_mutex);
         m_max_pool_size = max_size;
     }
 
@@ -95,10 +111,12 @@ public:
      * @brief 清空池
      */
     void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
         m_pool.clear();
     }
 
 private:
+    mutable std::mutex m_mutex;
     size_t m_buffer_size;
     size_t m_max_pool_size = 64;
     std::vector<bytes_t> m_pool;
@@ -205,6 +223,346 @@ inline pooled_buffer_t acquire_buffer(buffer_pool_t& pool) {
     return pooled_buffer_t(pool, pool.acquire());
 }
 
+// ============================================================================
+// size_class_pool_t - 分级缓冲区池
+// ============================================================================
+
+namespace detail {
+
+/**
+ * @brief 多生产者多消费者无锁有界队列（Vyukov），用作全局空闲表
+ */
+template <typename T>
+class bounded_free_list_t : private noncopyable_t {
+public:
+    explicit bounded_free_list_t(size_t capacity)
+        : m_capacity(_round_up_pow2(capacity < 2 ? 2 : capacity))
+        , m_mask(m_capacity - 1)
+        , m_cells(new cell_t[m_capacity]) {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool try_push(T&& value) {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        cell_t* cell;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& out) {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        cell_t* cell;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+        out = std::move(cell->value);
+        cell->sequence.store(pos + m_capacity, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 当前元素个数（并发时为近似值）
+     */
+    size_t size() const {
+        const size_t head = m_head.load(std::memory_order_acquire);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        return head > tail ? head - tail : 0;
+    }
+
+private:
+    struct cell_t {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static size_t _round_up_pow2(size_t value) {
+        size_t capacity = 1;
+        while (capacity < value) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<cell_t[]> m_cells;
+    std::atomic<size_t> m_head{0};
+    std::atomic<size_t> m_tail{0};
+};
+
+}  // namespace detail
+
+/**
+ * @brief 分级缓冲区池
+ *
+ * - 容量按 2 的幂分级（64 B ~ 1 MiB），更大的请求直接分配、归还时释放
+ * - 每个线程为每个池保留少量缓冲区（无同步），缓存满或为空时
+ *   与全局空闲表批量交换；全局空闲表是无锁有界队列，满时多余的缓冲区被释放
+ * - trim() 按高水位修剪：只保留自上次修剪以来峰值所需的缓冲区
+ *
+ * acquire() 返回的 bytes_t 是普通 vector，可按需传递；
+ * 用完后 release() 归还（未归还只是少一次复用）。
+ *
+ * @code
+ * auto& pool = size_class_pool_t::instance();
+ * bytes_t frame = pool.acquire(frame_len);   // size() == frame_len
+ * ...
+ * pool.release(std::move(frame));
+ * @endcode
+ *
+ * @note 线程缓存在线程退出时释放；局部池销毁后，其他线程中残留的缓存同样在线程退出时释放
+ */
+class size_class_pool_t : private noncopyable_t, private nonmovable_t {
+public:
+    static constexpr size_t k_min_class_shift = 6;                  ///< 最小级别 64 B
+    static constexpr size_t k_max_class_shift = 20;                 ///< 最大级别 1 MiB
+    static constexpr size_t k_class_count = k_max_class_shift - k_min_class_shift + 1;
+    static constexpr size_t k_default_max_cached = 256;             ///< 每级全局空闲表容量
+    static constexpr size_t k_thread_cache_limit = 8;               ///< 每级线程缓存上限
+
+    /**
+     * @param max_cached 每级全局空闲表最多保留的缓冲区数
+     */
+    explicit size_class_pool_t(size_t max_cached = k_default_max_cached)
+        : m_id(_next_pool_id()) {
+        for (size_t i = 0; i < k_class_count; ++i) {
+            m_classes[i].free_list.reset(new detail::bounded_free_list_t<bytes_t>(max_cached));
+        }
+    }
+
+    /**
+     * @brief 进程级共享池（有意不析构，线程缓存可在静态析构期间安全归还）
+     */
+    static size_class_pool_t& instance() {
+        static size_class_pool_t* s_pool = new size_class_pool_t();
+        return *s_pool;
+    }
+
+    /**
+     * @brief 容量级别（0 起），超过最大级别时返回 k_class_count
+     */
+    static size_t class_index(size_t size) {
+        size_t shift = k_min_class_shift;
+        while (shift <= k_max_class_shift && (static_cast<size_t>(1) << shift) < size) {
+            ++shift;
+        }
+        return shift - k_min_class_shift;
+    }
+
+    static size_t class_size(size_t index) {
+        return static_cast<size_t>(1) << (index + k_min_class_shift);
+    }
+
+    /**
+     * @brief 获取 size 字节的缓冲区（内容清零，容量为所在级别大小）
+     */
+    bytes_t acquire(size_t size) {
+        const size_t index = class_index(size);
+        if (index >= k_class_count) {
+            m_oversize.fetch_add(1, std::memory_order_relaxed);
+            return bytes_t(size);
+        }
+
+        std::vector<bytes_t>& local = _local(index);
+        if (local.empty()) {
+            _refill(index, local);
+        }
+        bytes_t buffer;
+        if (!local.empty()) {
+            buffer = std::move(local.back());
+            local.pop_back();
+        } else {
+            buffer.reserve(class_size(index));
+            m_fresh.fetch_add(1, std::memory_order_relaxed);
+            _taken(m_classes[index], 1);
+        }
+        buffer.resize(size);
+        return buffer;
+    }
+
+    /**
+     * @brief 归还缓冲区（级别按容量向下取整；过小或过大时直接释放）
+     */
+    void release(bytes_t&& buffer) {
+        const size_t capacity = buffer.capacity();
+        if (capacity < class_size(0) || capacity > class_size(k_class_count - 1)) {
+            return;
+        }
+        size_t index = k_class_count - 1;
+        while (class_size(index) > capacity) {
+            --index;
+        }
+
+        buffer.clear();
+        std::vector<bytes_t>& local = _local(index);
+        local.push_back(std::move(buffer));
+        if (local.size() > k_thread_cache_limit) {
+            _flush(index, local, k_thread_cache_limit / 2);
+        }
+    }
+
+    /**
+     * @brief 把全局空闲表修剪到上次修剪以来的峰值需求
+     *
+     * 峰值按全局层面统计：某一时刻从全局层（含新分配）取出尚未归还的缓冲区数。
+     * 调用线程自己的缓存先归还到全局空闲表。
+     */
+    void trim() {
+        for (size_t index = 0; index < k_class_count; ++index) {
+            class_t& cls = m_classes[index];
+            std::vector<bytes_t>& local = _local(index);
+            _flush(index, local, 0);
+
+            const int64_t outstanding = cls.outstanding.load(std::memory_order_relaxed);
+            const int64_t peak = cls.peak.exchange(outstanding > 0 ? outstanding : 0,
+                                                   std::memory_order_relaxed);
+            const size_t keep = peak > outstanding ? static_cast<size_t>(peak - outstanding) : 0;
+            bytes_t dropped;
+            while (cls.free_list->size() > keep && cls.free_list->try_pop(dropped)) {
+                bytes_t().swap(dropped);
+            }
+        }
+    }
+
+    // ========================================================================
+    // 统计
+    // ========================================================================
+
+    /**
+     * @brief 新分配的缓冲区数（复用的不计）
+     */
+    uint64_t allocation_count() const {
+        return m_fresh.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 超过最大级别、未经池管理的请求数
+     */
+    uint64_t oversize_count() const {
+        return m_oversize.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 某一级别全局空闲表中的缓冲区数
+     */
+    size_t cached_count(size_t index) const {
+        return index < k_class_count ? m_classes[index].free_list->size() : 0;
+    }
+
+private:
+    static constexpr size_t k_refill_batch = k_thread_cache_limit / 2;
+
+    struct class_t {
+        std::unique_ptr<detail::bounded_free_list_t<bytes_t>> free_list;
+        std::atomic<int64_t> outstanding{0};        ///< 已离开全局层的缓冲区数
+        std::atomic<int64_t> peak{0};
+    };
+
+    struct thread_cache_t {
+        struct entry_t {
+            uint64_t pool_id;
+            std::array<std::vector<bytes_t>, k_class_count> lists;
+        };
+        std::vector<entry_t> entries;
+        size_t last = 0;
+    };
+
+    static uint64_t _next_pool_id() {
+        static std::atomic<uint64_t> s_next{0};
+        return ++s_next;
+    }
+
+    std::vector<bytes_t>& _local(size_t index) {
+        static thread_local thread_cache_t t_cache;
+        if (t_cache.last < t_cache.entries.size() &&
+            t_cache.entries[t_cache.last].pool_id == m_id) {
+            return t_cache.entries[t_cache.last].lists[index];
+        }
+        for (size_t i = 0; i < t_cache.entries.size(); ++i) {
+            if (t_cache.entries[i].pool_id == m_id) {
+                t_cache.last = i;
+                return t_cache.entries[i].lists[index];
+            }
+        }
+        t_cache.entries.emplace_back();
+        t_cache.last = t_cache.entries.size() - 1;
+        auto& entry = t_cache.entries.back();
+        entry.pool_id = m_id;
+        for (auto& list : entry.lists) {
+            list.reserve(k_thread_cache_limit + 1);
+        }
+        return entry.lists[index];
+    }
+
+    static void _taken(class_t& cls, int64_t count) {
+        const int64_t now = cls.outstanding.fetch_add(count, std::memory_order_relaxed) + count;
+        int64_t peak = cls.peak.load(std::memory_order_relaxed);
+        while (now > peak &&
+               !cls.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+        }
+    }
+
+    void _refill(size_t index, std::vector<bytes_t>& local) {
+        class_t& cls = m_classes[index];
+        bytes_t buffer;
+        int64_t taken = 0;
+        while (local.size() < k_refill_batch && cls.free_list->try_pop(buffer)) {
+            local.push_back(std::move(buffer));
+            ++taken;
+        }
+        if (taken > 0) {
+            _taken(cls, taken);
+        }
+    }
+
+    // 把线程缓存归还到全局空闲表，直到只剩 keep 个；全局表满时直接释放
+    void _flush(size_t index, std::vector<bytes_t>& local, size_t keep) {
+        class_t& cls = m_classes[index];
+        int64_t returned = 0;
+        while (local.size() > keep) {
+            cls.free_list->try_push(std::move(local.back()));
+            local.pop_back();
+            ++returned;
+        }
+        if (returned > 0) {
+            cls.outstanding.fetch_sub(returned, std::memory_order_relaxed);
+        }
+    }
+
+    const uint64_t m_id;
+    std::array<class_t, k_class_count> m_classes;
+    std::atomic<uint64_t> m_fresh{0};
+    std::atomic<uint64_t> m_oversize{0};
+};
+
 // ============================================================================
 // 内存操作工具
 // ============================================================================
@@ -247,6 +605,70 @@ inline int mem_compare(const void* lhs, const void* rhs, size_t count) {
     return std::memcmp(lhs, rhs, count);
 }
 
+// ============================================================================
+// slab_cache_t - 可复用的整帧 slab
+// ============================================================================
+
+/**
+ * @brief 解码用整帧 slab 的复用缓存
+ *
+ * 接收路径把整帧复制到 slab，响应的数据和原始帧以 byte_slice_t 引用它。
+ * copy() 优先复用已不被任何切片引用的 slab（稳态下不分配内存）；
+ * 全部仍被引用时新建一个（容量取自 size_class_pool_t）并替换最早的。
+ *
+ * @note 非线程安全，由所属设备加锁；切片可以在任意线程释放
+ */
+class slab_cache_t : private noncopyable_t {
+public:
+    static constexpr size_t k_default_slots = 4;
+
+    explicit slab_cache_t(size_t slots = k_default_slots)
+        : m_slots(slots > 0 ? slots : 1) {}
+
+    /**
+     * @brief 把 frame 复制到一个 slab，返回引用整个 slab 的切片
+     */
+    byte_slice_t copy(const_byte_span_t frame) {
+        for (auto& slab : m_slabs) {
+            if (slab.use_count() == 1) {
+                // 与其他线程释放最后一个切片时的引用计数递减同步
+                std::atomic_thread_fence(std::memory_order_acquire);
+                slab->assign(frame.begin(), frame.end());
+                ++m_reused;
+                return byte_slice_t(slab, 0, frame.size());
+            }
+        }
+
+        auto slab = std::make_shared<bytes_t>(size_class_pool_t::instance().acquire(frame.size()));
+        mem_copy(slab->data(), frame.data(), frame.size());
+        if (m_slabs.size() < m_slots) {
+            m_slabs.push_back(slab);
+        } else {
+            m_slabs[m_next] = slab;
+            m_next = (m_next + 1) % m_slots;
+        }
+        return byte_slice_t(slab, 0, frame.size());
+    }
+
+    /**
+     * @brief 复用已有 slab 的次数
+     */
+    uint64_t reuse_count() const {
+        return m_reused;
+    }
+
+    void clear() {
+        m_slabs.clear();
+        m_next = 0;
+    }
+
+private:
+    const size_t m_slots;
+    std::vector<std::shared_ptr<bytes_t>> m_slabs;
+    size_t m_next = 0;                  ///< 下一个被替换的 slab
+    uint64_t m_reused = 0;
+};
+
 }  // namespace vdl
 
 #endif  // VDL_CORE_MEMORY_HPP
@@ -0,0 +1,201 @@
+/**
+ * @file mpsc_queue.hpp
+ * @brief 多生产者单消费者无锁对象队列
+ *
+ * 用于多个心跳/重连线程向事件分发线程投递事件。
+ */
+
+#ifndef VDL_CORE_MPSC_QUEUE_HPP
+#define VDL_CORE_MPSC_QUEUE_HPP
+
+#include "types.hpp"
+#include "noncopyable.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace vdl {
+
+// ============================================================================
+// mpsc_queue_t - MPSC 有界队列
+// ============================================================================
+
+/**
+ * @brief 多生产者单消费者无锁有界队列
+ *
+ * 每个槽位带序号（Vyukov 有界队列）：生产者用 CAS 预留写位置，
+ * 构造完元素后发布序号；消费者只读序号，不需要 CAS。
+ *
+ * - 容量向上取整为 2 的幂（至少为 2）
+ * - 队列满时 try_push() 立即返回 false
+ * - 元素按预留写位置的顺序出队
+ *
+ * @code
+ * mpsc_queue_t<event_t> queue(1024);
+ *
+ * // 任意生产者线程
+ * if (!queue.try_push(std::move(event))) { ++dropped; }
+ *
+ * // 唯一的消费者线程
+ * event_t event;
+ * while (queue.try_pop(event)) { handle(event); }
+ * @endcode
+ */
+template <typename T>
+class mpsc_queue_t : private noncopyable_t, private nonmovable_t {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 最小容量（向上取整为 2 的幂）
+     */
+    explicit mpsc_queue_t(size_t capacity)
+        : m_capacity(_round_up_pow2(capacity < 2 ? 2 : capacity))
+        , m_mask(m_capacity - 1)
+        , m_cells(new cell_t[m_capacity]) {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~mpsc_queue_t() {
+        for (size_t pos = m_tail.load(std::memory_order_relaxed);; ++pos) {
+            cell_t& cell = m_cells[pos & m_mask];
+            if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+                break;
+            }
+            _item(cell)->~T();
+        }
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+    /**
+     * @brief 当前元素个数（并发时为近似值）
+     */
+    size_t size() const {
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief 已预留的写位置总数（单调递增）
+     */
+    size_t push_count() const {
+        return m_head.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 已出队的元素总数（单调递增）
+     */
+    size_t pop_count() const {
+        return m_tail.load(std::memory_order_acquire);
+    }
+
+    // ========================================================================
+    // 生产者接口（任意线程）
+    // ========================================================================
+
+    /**
+     * @brief 入队
+     * @return 队列已满时返回 false，value 保持不变
+     */
+    bool try_push(T&& value) {
+        return _emplace(std::move(value));
+    }
+
+    bool try_push(const T& value) {
+        return _emplace(value);
+    }
+
+    // ========================================================================
+    // 消费者接口（单线程）
+    // ========================================================================
+
+    /**
+     * @brief 出队
+     * @return 队列为空（或队首元素尚未发布）时返回 false
+     */
+    bool try_pop(T& out) {
+        const size_t pos = m_tail.load(std::memory_order_relaxed);
+        cell_t& cell = m_cells[pos & m_mask];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+        T* item = _item(cell);
+        out = std::move(*item);
+        item->~T();
+        cell.sequence.store(pos + m_capacity, std::memory_order_release);
+        m_tail.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    using storage_t = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    struct cell_t {
+        std::atomic<size_t> sequence;
+        storage_t storage;
+    };
+
+    static constexpr size_t k_cache_line_size = 64;
+
+    static size_t _round_up_pow2(size_t value) {
+        size_t capacity = 1;
+        while (capacity < value) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    static T* _item(cell_t& cell) {
+        return reinterpret_cast<T*>(&cell.storage);
+    }
+
+    template <typename U>
+    bool _emplace(U&& value) {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        cell_t* cell;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;   // 槽位尚未被消费者释放：队列已满
+            } else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+        ::new (static_cast<void*>(_item(*cell))) T(std::forward<U>(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只读成员
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<cell_t[]> m_cells;
+    char m_pad0[k_cache_line_size];
+
+    // 生产者竞争的写位置
+    std::atomic<size_t> m_head{0};
+    char m_pad1[k_cache_line_size - sizeof(std::atomic<size_t>)];
+
+    // 消费者独占的读位置
+    std::atomic<size_t> m_tail{0};
+    char m_pad2[k_cache_line_size - sizeof(std::atomic<size_t>)];
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CORE_MPSC_QUEUE_HPP
@@ -0,0 +1,125 @@
+/**
+ * @file number_format.hpp
+ * @brief 与区域设置无关的数值格式化
+ *
+ * 将整数和浮点数直接格式化到调用者提供的字符缓冲区，不分配内存，
+ * 小数点固定为 '.'（与 number_parser.hpp 对应）。
+ */
+
+#ifndef VDL_CORE_NUMBER_FORMAT_HPP
+#define VDL_CORE_NUMBER_FORMAT_HPP
+
+#include "types.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace vdl {
+
+/**
+ * @brief double 格式化结果的最大长度（不含结尾的 '\0'）
+ */
+constexpr size_t k_max_formatted_double = 32;
+
+/**
+ * @brief 格式化有符号整数
+ * @param out 输出缓冲区
+ * @param capacity 缓冲区大小
+ * @param value 数值
+ * @return 写入的字符数；空间不足返回 0（不写入）
+ */
+inline size_t format_int(char* out, size_t capacity, int64_t value) {
+    char digits[20];
+    size_t count = 0;
+    // 取绝对值时避免 INT64_MIN 溢出
+    uint64_t magnitude = value < 0 ? static_cast<uint64_t>(-(value + 1)) + 1
+                                   : static_cast<uint64_t>(value);
+    do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    const size_t length = count + (value < 0 ? 1 : 0);
+    if (length > capacity) {
+        return 0;
+    }
+
+    size_t pos = 0;
+    if (value < 0) {
+        out[pos++] = '-';
+    }
+    while (count > 0) {
+        out[pos++] = digits[--count];
+    }
+    return length;
+}
+
+/**
+ * @brief 格式化浮点数
+ * @param out 输出缓冲区
+ * @param capacity 缓冲区大小
+ * @param value 数值
+ * @param significant_digits 有效数字位数（1~17）
+ * @return 写入的字符数；空间不足返回 0
+ *
+ * - 绝对值小于 1e15 的整数值按整数输出（如 "1500000000"），精确且最短
+ * - 其余按 "%.*G" 输出，并把 locale 相关的小数点统一替换为 '.'
+ * - 非有限值输出 SCPI 关键字 NAN / INF / NINF
+ */
+inline size_t format_double(char* out, size_t capacity, double value,
+                            int significant_digits = 15) {
+    if (std::isnan(value) || std::isinf(value)) {
+        const char* word = std::isnan(value) ? "NAN" : (value > 0 ? "INF" : "NINF");
+        const size_t length = std::strlen(word);
+        if (length > capacity) {
+            return 0;
+        }
+        std::memcpy(out, word, length);
+        return length;
+    }
+
+    if (std::floor(value) == value && std::fabs(value) < 1e15) {
+        return format_int(out, capacity, static_cast<int64_t>(value));
+    }
+
+    if (significant_digits < 1) {
+        significant_digits = 1;
+    } else if (significant_digits > 17) {
+        significant_digits = 17;
+    }
+
+    char text[k_max_formatted_double + 16];
+    const int written = std::snprintf(text, sizeof(text), "%.*G", significant_digits, value);
+    if (written <= 0) {
+        return 0;
+    }
+
+    // 复制并规范化小数点（locale 的小数点可能不是 '.'，甚至是多字节）
+    size_t length = 0;
+    const size_t text_len = std::min(static_cast<size_t>(written), sizeof(text) - 1);
+    for (size_t i = 0; i < text_len; ++i) {
+        const char c = text[i];
+        const bool numeric = (c >= '0' && c <= '9') || c == '-' || c == '+' || c == 'E';
+        if (!numeric) {
+            if (length > 0 && out[length - 1] == '.') {
+                continue;   // 多字节小数点的后续字节
+            }
+            if (length >= capacity) {
+                return 0;
+            }
+            out[length++] = '.';
+            continue;
+        }
+        if (length >= capacity) {
+            return 0;
+        }
+        out[length++] = c;
+    }
+    return length;
+}
+
+}  // namespace vdl
+
+#endif  // VDL_CORE_NUMBER_FORMAT_HPP
@@ -0,0 +1,533 @@
+/**
+ * @file number_parser.hpp
+ * @brief 与区域设置无关的数值解析
+ *
+ * 提供不抛异常、不依赖 locale 的浮点解析，以及逗号分隔数据的批量解析，
+ * 用于解析仪器返回的大段 ASCII 数据（如 VNA 迹线）。
+ */
+
+#ifndef VDL_CORE_NUMBER_PARSER_HPP
+#define VDL_CORE_NUMBER_PARSER_HPP
+
+#include "types.hpp"
+#include "error.hpp"
+
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace vdl {
+
+namespace detail {
+
+inline bool is_number_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline bool is_number_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// 可精确表示的 10 的幂
+inline double exact_pow10(int exponent) {
+    static const double s_table[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    return s_table[exponent];
+}
+
+// 不区分大小写匹配关键字，返回匹配后的位置，不匹配返回 nullptr
+inline const char* match_keyword(const char* p, const char* last, const char* word) {
+    for (; *word; ++word, ++p) {
+        if (p == last) {
+            return nullptr;
+        }
+        char c = *p;
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<char>(c - 'a' + 'A');
+        }
+        if (c != *word) {
+            return nullptr;
+        }
+    }
+    return p;
+}
+
+// 慢速路径：按 "C" locale 解析（有效数字过多或指数超出精确范围时）
+inline bool parse_double_classic(const char* first, const char* last, double& out) {
+    std::istringstream iss(std::string(first, last));
+    iss.imbue(std::locale::classic());
+    double value = 0.0;
+    iss >> value;
+    if (iss.fail()) {
+        return false;
+    }
+    out = value;
+    return true;
+}
+
+}  // namespace detail
+
+// ============================================================================
+// 单值解析
+// ============================================================================
+
+/**
+ * @brief 从 [first, last) 开头解析一个浮点数
+ * @param first 起始位置
+ * @param last 结束位置
+ * @param out [out] 解析结果
+ * @return 成功返回数值之后的位置，失败返回 nullptr
+ *
+ * 支持 [+-]digits[.digits][(e|E)[+-]digits] 以及 INF/INFINITY/NAN（不区分大小写）。
+ * 小数点固定为 '.'，与当前 locale 无关。
+ *
+ * 有效数字不超过 19 位、尾数不超过 2^53 且十进制指数在 ±22 以内时
+ * 直接用一次乘/除得到正确舍入的结果；其余情况回退到 "C" locale 的标准解析。
+ */
+inline const char* parse_double_prefix(const char* first, const char* last, double& out) {
+    const char* p = first;
+    bool negative = false;
+    if (p != last && (*p == '+' || *p == '-')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;          // 已计入尾数的有效数字
+    int exponent = 0;        // 十进制指数
+    bool any_digit = false;
+    bool truncated = false;  // 有效数字超过 19 位
+
+    while (p != last && detail::is_number_digit(*p)) {
+        const unsigned d = static_cast<unsigned>(*p - '0');
+        any_digit = true;
+        if (mantissa == 0 && d == 0) {
+            // 前导零
+        } else if (digits < 19) {
+            mantissa = mantissa * 10 + d;
+            ++digits;
+        } else {
+            ++exponent;
+            truncated = truncated || d != 0;
+        }
+        ++p;
+    }
+
+    if (p != last && *p == '.') {
+        ++p;
+        while (p != last && detail::is_number_digit(*p)) {
+            const unsigned d = static_cast<unsigned>(*p - '0');
+            any_digit = true;
+            if (mantissa == 0 && d == 0) {
+                --exponent;
+            } else if (digits < 19) {
+                mantissa = mantissa * 10 + d;
+                ++digits;
+                --exponent;
+            } else {
+                truncated = truncated || d != 0;
+            }
+            ++p;
+        }
+    }
+
+    if (!any_digit) {
+        const char* end = detail::match_keyword(p, last, "INF");
+        if (end) {
+            const char* longer = detail::match_keyword(end, last, "INITY");
+            out = negative ? -std::numeric_limits<double>::infinity()
+                           : std::numeric_limits<double>::infinity();
+            return longer ? longer : end;
+        }
+        end = detail::match_keyword(p, last, "NAN");
+        if (end) {
+            out = std::numeric_limits<double>::quiet_NaN();
+            return end;
+        }
+        return nullptr;
+    }
+
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool exp_negative = false;
+        if (q != last && (*q == '+' || *q == '-')) {
+            exp_negative = (*q == '-');
+            ++q;
+        }
+        if (q != last && detail::is_number_digit(*q)) {
+            int exp_value = 0;
+            while (q != last && detail::is_number_digit(*q)) {
+                if (exp_value < 100000) {
+                    exp_value = exp_value * 10 + (*q - '0');
+                }
+                ++q;
+            }
+            exponent += exp_negative ? -exp_value : exp_value;
+            p = q;
+        }
+        // 'e' 之后没有数字时不属于数值，由调用者按分隔符检查报错
+    }
+
+    if (mantissa == 0) {
+        out = negative ? -0.0 : 0.0;
+        return p;
+    }
+
+    if (!truncated && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+        double value = static_cast<double>(mantissa);
+        value = exponent >= 0 ? value * detail::exact_pow10(exponent)
+                              : value / detail::exact_pow10(-exponent);
+        out = negative ? -value : value;
+        return p;
+    }
+
+    if (!detail::parse_double_classic(first, p, out)) {
+        return nullptr;
+    }
+    return p;
+}
+
+/**
+ * @brief 解析完整的浮点数字符串（允许前后空白）
+ * @return 整个字符串是一个合法数值时返回 true
+ */
+inline bool parse_double(const char* first, const char* last, double& out) {
+    while (first != last && detail::is_number_space(*first)) {
+        ++first;
+    }
+    const char* end = parse_double_prefix(first, last, out);
+    if (end == nullptr) {
+        return false;
+    }
+    while (end != last && detail::is_number_space(*end)) {
+        ++end;
+    }
+    return end == last;
+}
+
+inline bool parse_double(const std::string& text, double& out) {
+    return parse_double(text.data(), text.data() + text.size(), out);
+}
+
+// ============================================================================
+// 批量解析
+// ============================================================================
+
+/**
+ * @brief 根据逗号个数估计数值个数（用于预分配）
+ */
+inline size_t estimate_value_count(const char* data, size_t len) {
+    if (len == 0) {
+        return 0;
+    }
+    size_t count = 1;
+    const char* p = data;
+    const char* last = data + len;
+    while (p != last) {
+        const void* hit = std::memchr(p, ',', static_cast<size_t>(last - p));
+        if (hit == nullptr) {
+            break;
+        }
+        ++count;
+        p = static_cast<const char*>(hit) + 1;
+    }
+    return count;
+}
+
+namespace detail {
+
+/**
+ * @brief 单次遍历逗号分隔的数值，逐个交给 sink
+ *
+ * sink(double) 返回 false 表示输出已满。空白和空字段被跳过。
+ */
+template<typename Sink>
+inline result_t<size_t> parse_separated_values(const char* data, size_t len, Sink&& sink) {
+    const char* p = data;
+    const char* last = data + len;
+    size_t count = 0;
+
+    for (;;) {
+        while (p != last && (*p == ',' || is_number_space(*p))) {
+            ++p;
+        }
+        if (p == last) {
+            break;
+        }
+
+        double value = 0.0;
+        const char* end = parse_double_prefix(p, last, value);
+        if (end == nullptr) {
+            return make_error<size_t>(error_code_t::invalid_format,
+                                      "Failed to parse double value");
+        }
+        while (end != last && is_number_space(*end)) {
+            ++end;
+        }
+        if (end != last && *end != ',') {
+            return make_error<size_t>(error_code_t::invalid_format,
+                                      "Failed to parse double value");
+        }
+
+        if (!sink(value)) {
+            return make_error<size_t>(error_code_t::out_of_range,
+                                      "Output buffer too small");
+        }
+        ++count;
+        p = end;
+    }
+
+    return count;
+}
+
+}  // namespace detail
+
+/**
+ * @brief 解析逗号分隔的浮点数，追加到 out
+ * @param data 数据
+ * @param len 数据长度
+ * @param out [out] 输出向量（按字节数预估容量）
+ * @return 成功返回解析出的个数；失败返回 invalid_format，out 恢复原状
+ *
+ * @code
+ * std::vector<double> trace;
+ * auto n = parse_doubles_into(text.data(), text.size(), trace);
+ * @endcode
+ */
+inline result_t<size_t> parse_doubles_into(const char* data, size_t len,
+                                           std::vector<double>& out) {
+    const size_t original = out.size();
+    out.reserve(original + estimate_value_count(data, len));
+
+    auto result = detail::parse_separated_values(data, len, [&out](double v) {
+        out.push_back(v);
+        return true;
+    });
+    if (!result) {
+        out.resize(original);
+    }
+    return result;
+}
+
+/**
+ * @brief 解析逗号分隔的浮点数到固定大小的缓冲区
+ * @return 成功返回写入的个数；数值多于缓冲区时返回 out_of_range
+ */
+inline result_t<size_t> parse_doubles_into(const char* data, size_t len, span_t<double> out) {
+    size_t index = 0;
+    return detail::parse_separated_values(data, len, [&out, &index](double v) {
+        if (index >= out.size()) {
+            return false;
+        }
+        out[index++] = v;
+        return true;
+    });
+}
+
+/**
+ * @brief 解析交错的复数数据（实部1,虚部1,实部2,虚部2,...），追加到 out
+ * @return 成功返回复数个数；数值个数为奇数时返回 invalid_format
+ */
+inline result_t<size_t> parse_complex_into(const char* data, size_t len,
+                                           std::vector<std::complex<double>>& out) {
+    const size_t original = out.size();
+    out.reserve(original + estimate_value_count(data, len) / 2);
+
+    double real = 0.0;
+    bool has_real = false;
+    auto result = detail::parse_separated_values(data, len, [&](double v) {
+        if (has_real) {
+            out.emplace_back(real, v);
+        } else {
+            real = v;
+        }
+        has_real = !has_real;
+        return true;
+    });
+
+    if (result && has_real) {
+        result = make_error<size_t>(error_code_t::invalid_format,
+                                    "Complex data must have even number of values");
+    }
+    if (!result) {
+        out.resize(original);
+        return result;
+    }
+    return out.size() - original;
+}
+
+/**
+ * @brief 解析交错的复数数据到实部/虚部两个数组（SoA）
+ * @return 成功返回复数个数
+ */
+inline result_t<size_t> parse_complex_into(const char* data, size_t len,
+                                           std::vector<double>& real_out,
+                                           std::vector<double>& imag_out) {
+    const size_t original_real = real_out.size();
+    const size_t original_imag = imag_out.size();
+    const size_t estimate = estimate_value_count(data, len) / 2;
+    real_out.reserve(original_real + estimate);
+    imag_out.reserve(original_imag + estimate);
+
+    bool next_is_real = true;
+    auto result = detail::parse_separated_values(data, len, [&](double v) {
+        (next_is_real ? real_out : imag_out).push_back(v);
+        next_is_real = !next_is_real;
+        return true;
+    });
+
+    if (result && !next_is_real) {
+        result = make_error<size_t>(error_code_t::invalid_format,
+                                    "Complex data must have even number of values");
+    }
+    if (!result) {
+        real_out.resize(original_real);
+        imag_out.resize(original_imag);
+        return result;
+    }
+    return real_out.size() - original_real;
+}
+
+// ============================================================================
+// number_stream_parser_t - 增量解析
+// ============================================================================
+
+/**
+ * @brief 逗号分隔浮点数的增量解析器
+ *
+ * 数据可按任意边界分块送入，跨块的半个数值暂存在内部固定缓冲区中，
+ * 因此内存占用只有输出数组本身。
+ *
+ * @code
+ * std::vector<double> trace;
+ * number_stream_parser_t parser(trace);
+ * parser.feed(chunk1, len1);
+ * parser.feed(chunk2, len2);
+ * auto done = parser.finish();
+ * @endcode
+ */
+class number_stream_parser_t {
+public:
+    static constexpr size_t k_max_token_size = 64;  ///< 单个数值的最大字符数
+
+    explicit number_stream_parser_t(std::vector<double>& out)
+        : m_out(out) {
+    }
+
+    /**
+     * @brief 送入一块数据
+     * @return 失败返回 invalid_format，之后的 feed() 都会返回同一错误
+     */
+    result_t<void> feed(const char* data, size_t len) {
+        if (m_failed) {
+            return _failure();
+        }
+
+        const char* p = data;
+        const char* last = data + len;
+
+        // 先补全上一块遗留的半个数值
+        if (m_partial_size > 0) {
+            while (p != last && !_is_delimiter(*p)) {
+                if (m_partial_size == k_max_token_size) {
+                    m_failed = true;
+                    return _failure();
+                }
+                m_partial[m_partial_size++] = *p++;
+            }
+            if (p == last) {
+                return make_ok();
+            }
+            auto flushed = _flush_partial();
+            if (!flushed) {
+                return flushed;
+            }
+        }
+
+        // 最后一个分隔符之前的数值都是完整的
+        const char* tail = last;
+        while (tail != p && !_is_delimiter(*(tail - 1))) {
+            --tail;
+        }
+        if (tail != p) {
+            auto parsed = detail::parse_separated_values(
+                p, static_cast<size_t>(tail - p), [this](double v) {
+                    m_out.push_back(v);
+                    return true;
+                });
+            if (!parsed) {
+                m_failed = true;
+                return make_unexpected(parsed.error());
+            }
+            m_count += *parsed;
+        }
+
+        const size_t rest = static_cast<size_t>(last - tail);
+        if (rest > k_max_token_size) {
+            m_failed = true;
+            return _failure();
+        }
+        std::memcpy(m_partial, tail, rest);
+        m_partial_size = rest;
+        return make_ok();
+    }
+
+    /**
+     * @brief 数据结束，解析最后一个数值
+     */
+    result_t<void> finish() {
+        if (m_failed) {
+            return _failure();
+        }
+        if (m_partial_size > 0) {
+            return _flush_partial();
+        }
+        return make_ok();
+    }
+
+    /**
+     * @brief 已解析的数值个数
+     */
+    size_t count() const {
+        return m_count;
+    }
+
+private:
+    static bool _is_delimiter(char c) {
+        return c == ',' || detail::is_number_space(c);
+    }
+
+    static result_t<void> _failure() {
+        return make_error_void(error_code_t::invalid_format, "Failed to parse double value");
+    }
+
+    result_t<void> _flush_partial() {
+        double value = 0.0;
+        const size_t size = m_partial_size;
+        m_partial_size = 0;
+        if (!parse_double(m_partial, m_partial + size, value)) {
+            m_failed = true;
+            return _failure();
+        }
+        m_out.push_back(value);
+        ++m_count;
+        return make_ok();
+    }
+
+    std::vector<double>& m_out;
+    char m_partial[k_max_token_size];
+    size_t m_partial_size = 0;
+    size_t m_count = 0;
+    bool m_failed = false;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CORE_NUMBER_PARSER_HPP
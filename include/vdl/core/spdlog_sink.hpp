@@ -0,0 +1,72 @@
+/**
+ * @file spdlog_sink.hpp
+ * @brief 把 VDL 日志转发到 spdlog 的输出端
+ *
+ * 不包含在 vdl.hpp 中，需要时单独包含：
+ *
+ * @code
+ * #include <vdl/core/spdlog_sink.hpp>
+ *
+ * vdl::set_log_sink(std::make_shared<vdl::spdlog_sink_t>(spdlog::stdout_color_mt("vdl")));
+ * @endcode
+ */
+
+#ifndef VDL_CORE_SPDLOG_SINK_HPP
+#define VDL_CORE_SPDLOG_SINK_HPP
+
+#include "logging.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <memory>
+#include <string>
+
+namespace vdl {
+
+// ============================================================================
+// spdlog_sink_t - spdlog 输出端
+// ============================================================================
+
+/**
+ * @brief spdlog 输出端
+ *
+ * 消息格式为 "file:line: message"，级别映射到 spdlog 的同名级别，
+ * 级别过滤仍由 vdl::set_log_level() 和 logger 自身的级别共同决定。
+ */
+class spdlog_sink_t : public i_log_sink_t {
+public:
+    explicit spdlog_sink_t(std::shared_ptr<spdlog::logger> logger)
+        : m_logger(std::move(logger)) {}
+
+    void write(const log_record_t& record) override {
+        if (!m_logger) {
+            return;
+        }
+        std::string text(record.file);
+        text += ':';
+        text += std::to_string(record.line);
+        text += ": ";
+        text.append(record.message, record.length);
+
+        switch (record.level) {
+            case log_level_t::trace:    m_logger->trace(text); break;
+            case log_level_t::debug:    m_logger->debug(text); break;
+            case log_level_t::info:     m_logger->info(text); break;
+            case log_level_t::warn:     m_logger->warn(text); break;
+            case log_level_t::error:    m_logger->error(text); break;
+            case log_level_t::critical: m_logger->critical(text); break;
+            default: break;
+        }
+    }
+
+    const std::shared_ptr<spdlog::logger>& logger() const {
+        return m_logger;
+    }
+
+private:
+    std::shared_ptr<spdlog::logger> m_logger;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CORE_SPDLOG_SINK_HPP
@@ -0,0 +1,166 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief 单生产者单消费者无锁对象队列
+ *
+ * 用于接收泵与用户回调线程之间交接已解码的帧。
+ */
+
+#ifndef VDL_CORE_SPSC_QUEUE_HPP
+#define VDL_CORE_SPSC_QUEUE_HPP
+
+#include "types.hpp"
+#include "noncopyable.hpp"
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace vdl {
+
+// ============================================================================
+// spsc_queue_t - SPSC 有界队列
+// ============================================================================
+
+/**
+ * @brief 单生产者单消费者无锁有界队列
+ *
+ * - 容量向上取整为 2 的幂，槽位按需构造和析构，T 不需要默认构造
+ * - 队列满时 try_push() 立即返回 false，生产者永远不会阻塞
+ * - 布局与 spsc_ring_buffer_t 相同：两端位置位于不同缓存行并缓存对方位置
+ *
+ * @code
+ * spsc_queue_t<response_t> queue(256);
+ *
+ * // 生产者线程
+ * if (!queue.try_push(std::move(resp))) { ++dropped; }
+ *
+ * // 消费者线程
+ * response_t resp;
+ * while (queue.try_pop(resp)) { handle(resp); }
+ * @endcode
+ */
+template <typename T>
+class spsc_queue_t : private noncopyable_t, private nonmovable_t {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 最小容量（向上取整为 2 的幂）
+     */
+    explicit spsc_queue_t(size_t capacity)
+        : m_capacity(_round_up_pow2(capacity))
+        , m_mask(m_capacity - 1)
+        , m_slots(new slot_t[m_capacity]) {
+    }
+
+    ~spsc_queue_t() {
+        const size_t head = m_head.load(std::memory_order_acquire);
+        for (size_t pos = m_tail.load(std::memory_order_relaxed); pos != head; ++pos) {
+            _slot(pos)->~T();
+        }
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+    /**
+     * @brief 当前元素个数（并发时为近似值）
+     */
+    size_t size() const {
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // ========================================================================
+    // 生产者接口
+    // ========================================================================
+
+    /**
+     * @brief 入队
+     * @return 队列已满时返回 false，value 保持不变
+     */
+    bool try_push(T&& value) {
+        return _emplace(std::move(value));
+    }
+
+    bool try_push(const T& value) {
+        return _emplace(value);
+    }
+
+    // ========================================================================
+    // 消费者接口
+    // ========================================================================
+
+    /**
+     * @brief 出队
+     * @return 队列为空时返回 false
+     */
+    bool try_pop(T& out) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_cached_head) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            if (tail == m_cached_head) {
+                return false;
+            }
+        }
+        T* item = _slot(tail);
+        out = std::move(*item);
+        item->~T();
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    using slot_t = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    static constexpr size_t k_cache_line_size = 64;
+
+    static size_t _round_up_pow2(size_t value) {
+        size_t capacity = 1;
+        while (capacity < value) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    T* _slot(size_t pos) {
+        return reinterpret_cast<T*>(&m_slots[pos & m_mask]);
+    }
+
+    template <typename U>
+    bool _emplace(U&& value) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cached_tail == m_capacity) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cached_tail == m_capacity) {
+                return false;
+            }
+        }
+        ::new (static_cast<void*>(_slot(head))) T(std::forward<U>(value));
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 只读成员
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<slot_t[]> m_slots;
+    char m_pad0[k_cache_line_size];
+
+    // 生产者缓存行
+    std::atomic<size_t> m_head{0};           ///< 写位置（单调递增）
+    size_t m_cached_tail = 0;                ///< 生产者缓存的读位置
+    char m_pad1[k_cache_line_size - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+
+    // 消费者缓存行
+    std::atomic<size_t> m_tail{0};           ///< 读位置（单调递增）
+    size_t m_cached_head = 0;                ///< 消费者缓存的写位置
+    char m_pad2[k_cache_line_size - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CORE_SPSC_QUEUE_HPP
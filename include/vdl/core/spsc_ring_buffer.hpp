@@ -0,0 +1,266 @@
+/**
+ * @file spsc_ring_buffer.hpp
+ * @brief 单生产者单消费者无锁环形缓冲区
+ *
+ * 用于传输层读取线程与解码线程之间的字节流交接。
+ */
+
+#ifndef VDL_CORE_SPSC_RING_BUFFER_HPP
+#define VDL_CORE_SPSC_RING_BUFFER_HPP
+
+#include "types.hpp"
+#include "noncopyable.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+namespace vdl {
+
+// ============================================================================
+// spsc_ring_buffer_t - SPSC 环形缓冲区
+// ============================================================================
+
+/**
+ * @brief 单生产者单消费者无锁字节环形缓冲区
+ *
+ * - 容量向上取整为 2 的幂，位置单调递增，用掩码代替取模
+ * - 写位置和读位置位于不同的缓存行，各自缓存对方位置，减少跨核同步
+ * - 生产者：write()、write_span()/commit_write()
+ * - 消费者：read()、read_span()/consume()、linearize()
+ *
+ * 接口与 ring_buffer_t 中设备接收路径使用的部分一致
+ * （write_span/commit_write/linearize/consume/full/clear），
+ * 可作为跨线程接收缓冲区使用。
+ *
+ * @code
+ * spsc_ring_buffer_t rx(65536);
+ *
+ * // 读取线程
+ * byte_span_t space = rx.write_span();
+ * auto n = transport.read(space);
+ * if (n) rx.commit_write(*n);
+ *
+ * // 解码线程
+ * const_byte_span_t data = rx.linearize();
+ * size_t len = codec.frame_length(data);
+ * @endcode
+ */
+class spsc_ring_buffer_t : private noncopyable_t, private nonmovable_t {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 最小容量（向上取整为 2 的幂）
+     */
+    explicit spsc_ring_buffer_t(size_t capacity)
+        : m_capacity(_round_up_pow2(capacity))
+        , m_mask(m_capacity - 1)
+        , m_buffer(new byte_t[m_capacity]) {
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+    /**
+     * @brief 当前数据大小（并发时为近似值）
+     */
+    size_t size() const {
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    size_t available() const { return m_capacity - size(); }
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() == m_capacity; }
+
+    /**
+     * @brief 清空缓冲区（调用时不得有并发的读写）
+     */
+    void clear() {
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+        m_cached_head = 0;
+        m_cached_tail = 0;
+    }
+
+    // ========================================================================
+    // 生产者接口
+    // ========================================================================
+
+    /**
+     * @brief 写入数据
+     * @return 实际写入的字节数（空间不足时只写入一部分）
+     */
+    size_t write(const byte_t* data, size_t len) {
+        if (data == nullptr || len == 0) {
+            return 0;
+        }
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t to_write = std::min(len, _producer_space(head, len));
+        if (to_write == 0) {
+            return 0;
+        }
+        const size_t index = head & m_mask;
+        const size_t first = std::min(to_write, m_capacity - index);
+        std::memcpy(m_buffer.get() + index, data, first);
+        if (to_write > first) {
+            std::memcpy(m_buffer.get(), data + first, to_write - first);
+        }
+        m_head.store(head + to_write, std::memory_order_release);
+        return to_write;
+    }
+
+    size_t write(const_byte_span_t data) {
+        return write(data.data(), data.size());
+    }
+
+    /**
+     * @brief 获取一段连续的可写空间（到缓冲区末尾为止）
+     *
+     * 写入后调用 commit_write() 发布实际写入的字节数。
+     */
+    byte_span_t write_span() {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t index = head & m_mask;
+        const size_t len = std::min(_producer_space(head, m_capacity), m_capacity - index);
+        return byte_span_t(m_buffer.get() + index, len);
+    }
+
+    /**
+     * @brief 发布直接写入的字节
+     * @return 实际提交的字节数（不超过可用空间）
+     */
+    size_t commit_write(size_t len) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t to_commit = std::min(len, _producer_space(head, len));
+        m_head.store(head + to_commit, std::memory_order_release);
+        return to_commit;
+    }
+
+    // ========================================================================
+    // 消费者接口
+    // ========================================================================
+
+    /**
+     * @brief 读取数据
+     * @return 实际读取的字节数
+     */
+    size_t read(byte_t* buffer, size_t len) {
+        if (buffer == nullptr || len == 0) {
+            return 0;
+        }
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t to_read = std::min(len, _consumer_size(tail, len));
+        if (to_read == 0) {
+            return 0;
+        }
+        const size_t index = tail & m_mask;
+        const size_t first = std::min(to_read, m_capacity - index);
+        std::memcpy(buffer, m_buffer.get() + index, first);
+        if (to_read > first) {
+            std::memcpy(buffer + first, m_buffer.get(), to_read - first);
+        }
+        m_tail.store(tail + to_read, std::memory_order_release);
+        return to_read;
+    }
+
+    size_t read(byte_span_t buffer) {
+        return read(buffer.data(), buffer.size());
+    }
+
+    /**
+     * @brief 可读数据的第一段（到缓冲区末尾为止，零拷贝）
+     */
+    const_byte_span_t read_span() {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t index = tail & m_mask;
+        const size_t len = std::min(_consumer_size(tail, m_capacity), m_capacity - index);
+        return const_byte_span_t(m_buffer.get() + index, len);
+    }
+
+    /**
+     * @brief 以一段连续内存返回全部可读数据
+     *
+     * 数据未回绕时直接返回缓冲区视图；回绕时复制到消费者私有的暂存区。
+     * 视图在下一次 consume()/read()/linearize() 之前有效。
+     */
+    const_byte_span_t linearize() {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t count = _consumer_size(tail, m_capacity);
+        const size_t index = tail & m_mask;
+        if (count <= m_capacity - index) {
+            return const_byte_span_t(m_buffer.get() + index, count);
+        }
+        if (!m_scratch) {
+            m_scratch.reset(new byte_t[m_capacity]);
+        }
+        const size_t first = m_capacity - index;
+        std::memcpy(m_scratch.get(), m_buffer.get() + index, first);
+        std::memcpy(m_scratch.get() + first, m_buffer.get(), count - first);
+        return const_byte_span_t(m_scratch.get(), count);
+    }
+
+    /**
+     * @brief 丢弃已处理的数据
+     * @return 实际丢弃的字节数
+     */
+    size_t consume(size_t len) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t to_consume = std::min(len, _consumer_size(tail, len));
+        m_tail.store(tail + to_consume, std::memory_order_release);
+        return to_consume;
+    }
+
+private:
+    static constexpr size_t k_cache_line_size = 64;
+
+    static size_t _round_up_pow2(size_t value) {
+        size_t capacity = 1;
+        while (capacity < value) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    // 生产者视角的空闲空间：缓存的读位置已能满足 wanted 时不访问消费者缓存行
+    size_t _producer_space(size_t head, size_t wanted) {
+        size_t space = m_capacity - (head - m_cached_tail);
+        if (space < wanted) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            space = m_capacity - (head - m_cached_tail);
+        }
+        return space;
+    }
+
+    // 消费者视角的可读数据量：缓存的写位置已能满足 wanted 时不访问生产者缓存行
+    size_t _consumer_size(size_t tail, size_t wanted) {
+        size_t count = m_cached_head - tail;
+        if (count < wanted) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            count = m_cached_head - tail;
+        }
+        return count;
+    }
+
+    // 只读成员
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<byte_t[]> m_buffer;
+    std::unique_ptr<byte_t[]> m_scratch;     ///< linearize() 回绕时的暂存区（消费者私有）
+    char m_pad0[k_cache_line_size];
+
+    // 生产者缓存行
+    std::atomic<size_t> m_head{0};           ///< 写位置（单调递增）
+    size_t m_cached_tail = 0;                ///< 生产者缓存的读位置
+    char m_pad1[k_cache_line_size - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+
+    // 消费者缓存行
+    std::atomic<size_t> m_tail{0};           ///< 读位置（单调递增）
+    size_t m_cached_head = 0;                ///< 消费者缓存的写位置
+    char m_pad2[k_cache_line_size - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CORE_SPSC_RING_BUFFER_HPP
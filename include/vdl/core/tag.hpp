@@ -0,0 +1,170 @@
+/**
+ * @file tag.hpp
+ * @brief 驻留（interned）字符串标签
+ *
+ * 命令标签只用于调试/追踪，取值集合很小且反复出现。
+ * 标签文本在全局表中只保存一份，tag_t 本身只是一个指针，复制、移动、比较都不分配内存。
+ */
+
+#ifndef VDL_CORE_TAG_HPP
+#define VDL_CORE_TAG_HPP
+
+#include "types.hpp"
+
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace vdl {
+
+namespace detail {
+
+/**
+ * @brief 标签驻留表（进程内唯一，永不释放）
+ */
+class tag_registry_t {
+public:
+    static tag_registry_t& instance() {
+        // 故意泄漏：静态对象析构期间仍可能创建带标签的命令
+        static tag_registry_t* registry = new tag_registry_t();
+        return *registry;
+    }
+
+    /**
+     * @brief 返回 text 的驻留副本（在进程生命周期内有效）
+     */
+    const char* intern(const char* text, size_t length) {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_key.assign(text, length);
+        auto it = m_tags.find(m_key);
+        if (it == m_tags.end()) {
+            it = m_tags.insert(m_key).first;
+        }
+        return it->c_str();
+    }
+
+    /**
+     * @brief 驻留的标签数
+     */
+    size_t size() const {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        return m_tags.size();
+    }
+
+private:
+    tag_registry_t() = default;
+
+    mutable std::mutex m_mutex;
+    std::string m_key;                          ///< 查找用的临时键（复用其容量）
+    std::unordered_set<std::string> m_tags;     ///< 节点地址稳定，元素的 c_str() 可长期引用
+};
+
+}  // namespace detail
+
+// ============================================================================
+// tag_t - 驻留标签
+// ============================================================================
+
+/**
+ * @brief 驻留字符串标签
+ *
+ * 由同一文本构造的标签指向同一份驻留文本，相等比较只比较指针。
+ * 构造时查一次驻留表（加锁），之后的复制/移动与复制一个指针相同。
+ *
+ * 构造函数是 explicit 的，避免在调用处把字符串隐式转换成标签：
+ * - 热路径上使用预先驻留的 static const tag_t，不要每次调用都从字符串构造
+ * - 驻留表永不释放，不要用含序号、时间等动态内容的字符串作标签
+ *
+ * @code
+ * static const tag_t k_poll_tag("poll");     // 热路径上预先驻留
+ * cmd.set_tag(k_poll_tag);
+ * @endcode
+ */
+class tag_t {
+public:
+    tag_t() = default;
+
+    explicit tag_t(const char* text)
+        : m_text(_intern(text, text ? std::strlen(text) : 0)) {}
+
+    explicit tag_t(const std::string& text)
+        : m_text(_intern(text.data(), text.size())) {}
+
+    bool empty() const {
+        return m_text == nullptr;
+    }
+
+    /**
+     * @brief 标签文本（空标签返回 ""）
+     */
+    const char* c_str() const {
+        return m_text ? m_text : "";
+    }
+
+    size_t size() const {
+        return m_text ? std::strlen(m_text) : 0;
+    }
+
+    std::string str() const {
+        return std::string(c_str());
+    }
+
+    void clear() {
+        m_text = nullptr;
+    }
+
+    friend bool operator==(const tag_t& a, const tag_t& b) {
+        return a.m_text == b.m_text;
+    }
+
+    friend bool operator!=(const tag_t& a, const tag_t& b) {
+        return a.m_text != b.m_text;
+    }
+
+    friend bool operator==(const tag_t& a, const char* b) {
+        return std::strcmp(a.c_str(), b ? b : "") == 0;
+    }
+
+    friend bool operator==(const char* a, const tag_t& b) {
+        return b == a;
+    }
+
+    friend bool operator!=(const tag_t& a, const char* b) {
+        return !(a == b);
+    }
+
+    friend bool operator!=(const char* a, const tag_t& b) {
+        return !(b == a);
+    }
+
+    friend bool operator==(const tag_t& a, const std::string& b) {
+        return b == a.c_str();
+    }
+
+    friend bool operator==(const std::string& a, const tag_t& b) {
+        return a == b.c_str();
+    }
+
+    friend bool operator!=(const tag_t& a, const std::string& b) {
+        return !(a == b);
+    }
+
+    friend bool operator!=(const std::string& a, const tag_t& b) {
+        return !(a == b);
+    }
+
+private:
+    static const char* _intern(const char* text, size_t length) {
+        if (length == 0) {
+            return nullptr;
+        }
+        return detail::tag_registry_t::instance().intern(text, length);
+    }
+
+    const char* m_text = nullptr;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CORE_TAG_HPP
@@ -0,0 +1,180 @@
+/**
+ * @file thread_pool.hpp
+ * @brief 有界线程池
+ *
+ * 固定数量的工作线程 + 有界任务队列，用于多台设备的并行操作。
+ */
+
+#ifndef VDL_CORE_THREAD_POOL_HPP
+#define VDL_CORE_THREAD_POOL_HPP
+
+#include "types.hpp"
+#include "noncopyable.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vdl {
+
+// ============================================================================
+// thread_pool_t - 有界线程池
+// ============================================================================
+
+/**
+ * @brief 固定线程数、有界队列的线程池
+ *
+ * - 队列满时 submit() 阻塞，避免无限堆积任务
+ * - 析构时执行完已入队的任务再退出
+ *
+ * @code
+ * thread_pool_t pool(4);
+ * auto f = pool.submit([] { return 42; });
+ * int value = f.get();
+ * @endcode
+ */
+class thread_pool_t : private noncopyable_t, private nonmovable_t {
+public:
+    static constexpr size_t k_default_queue_capacity = 64;
+
+    /**
+     * @brief 构造函数
+     * @param thread_count 工作线程数（0 视为 1）
+     * @param queue_capacity 队列容量（0 视为 1）
+     */
+    explicit thread_pool_t(size_t thread_count,
+                           size_t queue_capacity = k_default_queue_capacity)
+        : m_capacity(queue_capacity == 0 ? 1 : queue_capacity) {
+        if (thread_count == 0) {
+            thread_count = 1;
+        }
+        m_workers.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; ++i) {
+            m_workers.emplace_back([this] { _worker_loop(); });
+        }
+    }
+
+    ~thread_pool_t() {
+        shutdown();
+    }
+
+    /**
+     * @brief 提交任务
+     * @return 任务结果的 future；线程池已关闭时返回无效的 future（valid() == false）
+     */
+    template<typename F>
+    auto submit(F&& task) -> std::future<decltype(task())> {
+        using result_type = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<result_type()>>(
+            std::forward<F>(task));
+        std::future<result_type> future = packaged->get_future();
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_not_full.wait(lock, [this] {
+                return m_stopping || m_queue.size() < m_capacity;
+            });
+            if (m_stopping) {
+                return std::future<result_type>();
+            }
+            m_queue.emplace_back([packaged] { (*packaged)(); });
+        }
+        m_not_empty.notify_one();
+        return future;
+    }
+
+    /**
+     * @brief 停止接收新任务，执行完队列中的任务后等待所有线程退出
+     */
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping && m_workers.empty()) {
+                return;
+            }
+            m_stopping = true;
+        }
+        m_not_empty.notify_all();
+        m_not_full.notify_all();
+
+        for (auto& worker : m_workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        m_workers.clear();
+    }
+
+    /**
+     * @brief 把工作线程增加到 thread_count 个（已不少于该数或已关闭时无操作）
+     */
+    void grow(size_t thread_count) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            return;
+        }
+        while (m_workers.size() < thread_count) {
+            m_workers.emplace_back([this] { _worker_loop(); });
+        }
+    }
+
+    /**
+     * @brief 工作线程数
+     */
+    size_t thread_count() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_workers.size();
+    }
+
+    /**
+     * @brief 队列容量
+     */
+    size_t queue_capacity() const {
+        return m_capacity;
+    }
+
+    /**
+     * @brief 当前排队（尚未开始执行）的任务数
+     */
+    size_t pending() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_queue.size();
+    }
+
+private:
+    void _worker_loop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_not_empty.wait(lock, [this] {
+                    return m_stopping || !m_queue.empty();
+                });
+                if (m_queue.empty()) {
+                    return;   // 已停止且队列已清空
+                }
+                task = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+            m_not_full.notify_one();
+            task();
+        }
+    }
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    std::deque<std::function<void()>> m_queue;
+    std::vector<std::thread> m_workers;
+    size_t m_capacity;
+    bool m_stopping = false;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_CORE_THREAD_POOL_HPP
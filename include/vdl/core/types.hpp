@@ -14,6 +14,7 @@
 #include <cstddef>
 #include <chrono>
 #include <string>
+#include <type_traits>
 
 namespace vdl {
 
@@ -92,6 +93,15 @@ enum class byte_order_t {
     native      ///< 本地字节序
 };
 
+/**
+ * @brief 获取本机字节序（little 或 big）
+ */
+inline byte_order_t host_byte_order() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const unsigned char*>(&probe) == 1 ? byte_order_t::little
+                                                               : byte_order_t::big;
+}
+
 // ============================================================================
 // Span 类型（轻量级非所有权视图）
 // ============================================================================
@@ -138,6 +148,14 @@ public:
         : m_data(vec.empty() ? nullptr : vec.data())
         , m_size(vec.size()) {}
 
+    /**
+     * @brief 从元素类型可转换的 span 构造（如 span_t<T> -> span_t<const T>）
+     */
+    template<typename U,
+             typename = typename std::enable_if<
+                 std::is_convertible<U (*)[], T (*)[]>::value>::type>
+    span_t(const span_t<U>& other) : m_data(other.data()), m_size(other.size()) {}
+
     // 访问
     pointer data() const { return m_data; }
     size_type size() const { return m_size; }
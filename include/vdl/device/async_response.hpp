@@ -0,0 +1,225 @@
+/**
+ * @file async_response.hpp
+ * @brief 异步响应句柄
+ *
+ * 定义流水线执行（execute_async）返回的响应句柄。
+ */
+
+#ifndef VDL_DEVICE_ASYNC_RESPONSE_HPP
+#define VDL_DEVICE_ASYNC_RESPONSE_HPP
+
+#include "../core/types.hpp"
+#include "../core/error.hpp"
+#include "../core/tag.hpp"
+#include "../protocol/response.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <string>
+
+namespace vdl {
+
+/**
+ * @brief 异步完成回调类型
+ *
+ * 在完成该请求的线程中调用（即调用 get()/wait_all() 或发起新请求的线程）。
+ */
+using async_callback_t = std::function<void(const result_t<response_t>& result)>;
+
+namespace detail {
+
+struct async_state_t;
+
+/**
+ * @brief 异步请求的驱动者（由设备实现）
+ *
+ * 句柄等待时通过它推进接收，直到目标请求完成。
+ */
+class i_async_source_t {
+public:
+    /**
+     * @brief 持续接收并分发响应，直到 state 完成
+     */
+    virtual void wait_async(async_state_t& state) = 0;
+
+protected:
+    ~i_async_source_t() = default;
+};
+
+/**
+ * @brief 异步请求的共享状态
+ *
+ * 设备在持有设备锁时完成请求，句柄可能在任意线程上查询或等待：
+ * result/callback/source 由 mutex 保护，done 以 release 发布、acquire 读取，
+ * 看到 done 之后 result 不再改变，可以不加锁读取。
+ * key/timeout_ms 只在设备锁内访问，tag 在句柄创建前写入后不再改变。
+ */
+struct async_state_t {
+    optional_t<result_t<response_t>> result;   ///< 完成后的结果（done 之后只读）
+    optional_t<uint32_t> key;                  ///< 关联键（编解码器从请求帧中提取）
+    milliseconds_t timeout_ms = 0;             ///< 等待该请求响应的超时
+    tag_t tag;                                 ///< 命令标签（用于调试/追踪）
+    async_callback_t callback;                 ///< 完成回调
+    i_async_source_t* source = nullptr;        ///< 驱动者，完成或设备销毁后为空
+
+    bool ready() const {
+        return done.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 当前的驱动者（已完成时为空）
+     */
+    i_async_source_t* current_source() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return source;
+    }
+
+    /**
+     * @brief 设置驱动者（请求发出后、交给句柄前由设备调用）
+     */
+    void set_source(i_async_source_t* value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        source = value;
+    }
+
+    /**
+     * @brief 设置结果并触发回调（只生效一次）
+     *
+     * 回调在释放状态锁之后、于完成该请求的线程中调用。
+     */
+    void complete(result_t<response_t> value) {
+        async_callback_t cb;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (done.load(std::memory_order_relaxed)) {
+                return;
+            }
+            result = std::move(value);
+            source = nullptr;
+            cb = std::move(callback);
+            callback = nullptr;
+            done.store(true, std::memory_order_release);
+        }
+        finished.notify_all();
+        if (cb) {
+            cb(*result);
+        }
+    }
+
+    /**
+     * @brief 阻塞直到其他线程完成该请求
+     */
+    void wait_done() {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return done.load(std::memory_order_relaxed); });
+    }
+
+    mutable std::mutex mutex;
+    std::condition_variable finished;
+    std::atomic<bool> done{false};
+};
+
+using async_state_ptr_t = std::shared_ptr<async_state_t>;
+
+}  // namespace detail
+
+// ============================================================================
+// async_response_t - 异步响应句柄
+// ============================================================================
+
+/**
+ * @brief 流水线请求的响应句柄
+ *
+ * 类似 std::future，但不依赖后台线程：等待时由调用线程驱动设备接收，
+ * 并按顺序完成排在前面的请求（同时触发它们的回调）。
+ *
+ * @code
+ * auto h1 = device.execute_async(cmd1);
+ * auto h2 = device.execute_async(cmd2);   // 无需等待 h1 的往返
+ *
+ * auto r1 = h1.get();
+ * auto r2 = h2.get();
+ * @endcode
+ */
+class async_response_t {
+public:
+    async_response_t() = default;
+
+    explicit async_response_t(detail::async_state_ptr_t state)
+        : m_state(std::move(state)) {
+    }
+
+    /**
+     * @brief 检查句柄是否关联了请求
+     */
+    bool valid() const {
+        return static_cast<bool>(m_state);
+    }
+
+    /**
+     * @brief 检查结果是否已就绪（不阻塞）
+     */
+    bool is_ready() const {
+        return m_state && m_state->ready();
+    }
+
+    /**
+     * @brief 等待请求完成
+     *
+     * 请求仍在驱动者的在途队列中时由本线程驱动接收；
+     * 已经没有驱动者（正被其他线程完成）时在状态的条件变量上等待。
+     */
+    void wait() {
+        if (!m_state || m_state->ready()) {
+            return;
+        }
+        detail::i_async_source_t* source = m_state->current_source();
+        if (!source) {
+            m_state->wait_done();
+            return;
+        }
+        source->wait_async(*m_state);
+        if (!m_state->ready()) {
+            m_state->complete(make_error<response_t>(error_code_t::operation_cancelled,
+                                                     "Async request abandoned"));
+        }
+    }
+
+    /**
+     * @brief 等待并获取结果
+     */
+    result_t<response_t> get() {
+        if (!m_state) {
+            return make_error<response_t>(error_code_t::invalid_state,
+                                          "Empty async response handle");
+        }
+        wait();
+        return *m_state->result;
+    }
+
+    /**
+     * @brief 获取请求的命令标签
+     */
+    tag_t tag() const {
+        return m_state ? m_state->tag : tag_t();
+    }
+
+private:
+    detail::async_state_ptr_t m_state;
+};
+
+/**
+ * @brief 创建已完成的异步句柄（用于立即失败等场景）
+ */
+inline async_response_t make_ready_async_response(result_t<response_t> result) {
+    auto state = std::make_shared<detail::async_state_t>();
+    state->complete(std::move(result));
+    return async_response_t(std::move(state));
+}
+
+}  // namespace vdl
+
+#endif  // VDL_DEVICE_ASYNC_RESPONSE_HPP
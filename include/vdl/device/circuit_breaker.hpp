@@ -0,0 +1,182 @@
+/**
+ * @file circuit_breaker.hpp
+ * @brief 重连熔断器
+ *
+ * 反复重连失败的设备进入熔断状态，在冷却期内不再占用线程尝试重连。
+ */
+
+#ifndef VDL_DEVICE_CIRCUIT_BREAKER_HPP
+#define VDL_DEVICE_CIRCUIT_BREAKER_HPP
+
+#include "../core/types.hpp"
+#include "../core/noncopyable.hpp"
+
+#include <chrono>
+#include <mutex>
+
+namespace vdl {
+
+// ============================================================================
+// 熔断器状态与配置
+// ============================================================================
+
+/**
+ * @brief 熔断器状态
+ */
+enum class circuit_state_t : uint8_t {
+    closed = 0,       ///< 正常：允许重连
+    open = 1,         ///< 熔断：冷却期内拒绝重连
+    half_open = 2     ///< 半开：冷却期结束，只允许一次试探
+};
+
+/**
+ * @brief 获取熔断器状态名称
+ */
+inline const char* circuit_state_name(circuit_state_t state) {
+    switch (state) {
+        case circuit_state_t::closed: return "closed";
+        case circuit_state_t::open: return "open";
+        case circuit_state_t::half_open: return "half_open";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief 熔断器配置
+ */
+struct circuit_breaker_config_t {
+    uint8_t failure_threshold = 0;          ///< 连续失败多少轮后熔断（0 表示不熔断）
+    milliseconds_t open_duration = 30000;   ///< 熔断后的冷却时间
+};
+
+// ============================================================================
+// circuit_breaker_t - 熔断器
+// ============================================================================
+
+/**
+ * @brief 熔断器（线程安全）
+ *
+ * - closed：allow() 总是返回 true，连续 failure_threshold 次失败后进入 open
+ * - open：冷却期内 allow() 返回 false；冷却期结束后第一次 allow() 进入 half_open
+ * - half_open：只放行一次试探，成功回到 closed，失败重新进入 open
+ *
+ * @code
+ * if (breaker.allow()) {
+ *     bool ok = try_reconnect();
+ *     ok ? breaker.record_success() : breaker.record_failure();
+ * }
+ * @endcode
+ */
+class circuit_breaker_t : private noncopyable_t {
+public:
+    using io_clock_t = std::chrono::steady_clock;
+
+    circuit_breaker_t() = default;
+
+    explicit circuit_breaker_t(const circuit_breaker_config_t& config)
+        : m_config(config) {
+    }
+
+    void set_config(const circuit_breaker_config_t& config) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_config = config;
+        if (m_config.failure_threshold == 0) {
+            _close();
+        }
+    }
+
+    /**
+     * @brief 是否允许一次尝试
+     *
+     * 返回 true 后调用者必须以 record_success()/record_failure() 报告结果。
+     */
+    bool allow() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_config.failure_threshold == 0) {
+            return true;
+        }
+        switch (m_state) {
+            case circuit_state_t::closed:
+                return true;
+            case circuit_state_t::open:
+                if (io_clock_t::now() - m_opened_at <
+                    std::chrono::milliseconds(m_config.open_duration)) {
+                    return false;
+                }
+                m_state = circuit_state_t::half_open;
+                m_trial_in_flight = true;
+                return true;
+            case circuit_state_t::half_open:
+            default:
+                if (m_trial_in_flight) {
+                    return false;
+                }
+                m_trial_in_flight = true;
+                return true;
+        }
+    }
+
+    void record_success() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        _close();
+    }
+
+    void record_failure() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_config.failure_threshold == 0) {
+            return;
+        }
+        m_trial_in_flight = false;
+        if (m_state == circuit_state_t::half_open) {
+            _open();
+            return;
+        }
+        if (m_failures < 0xFF) {
+            ++m_failures;
+        }
+        if (m_failures >= m_config.failure_threshold) {
+            _open();
+        }
+    }
+
+    /**
+     * @brief 手动复位为 closed
+     */
+    void reset() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        _close();
+    }
+
+    circuit_state_t state() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_state;
+    }
+
+    uint8_t failure_count() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_failures;
+    }
+
+private:
+    void _open() {
+        m_state = circuit_state_t::open;
+        m_opened_at = io_clock_t::now();
+    }
+
+    void _close() {
+        m_state = circuit_state_t::closed;
+        m_failures = 0;
+        m_trial_in_flight = false;
+    }
+
+    mutable std::mutex m_mutex;
+    circuit_breaker_config_t m_config;
+    circuit_state_t m_state = circuit_state_t::closed;
+    uint8_t m_failures = 0;
+    bool m_trial_in_flight = false;
+    io_clock_t::time_point m_opened_at;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_DEVICE_CIRCUIT_BREAKER_HPP
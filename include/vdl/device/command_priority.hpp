@@ -0,0 +1,118 @@
+/**
+ * @file command_priority.hpp
+ * @brief 命令优先级与分块传输
+ *
+ * 每台设备的独占锁（fair_mutex_t）就是它的命令队列：排队按优先级分级，
+ * 同级 FIFO。线程通过 command_priority_scope_t 声明自己接下来的调用属于哪一级，
+ * 设备锁释放时排在最高优先级队首的线程先获得设备。
+ *
+ * 一次设备调用期间不会被打断，因此大块传输应拆成多次有界的调用
+ * （SCPI 分段读取、寄存器分页读取）：块之间设备锁被释放，
+ * 排队中的 control 命令可以插在两块之间执行，不必等整个传输结束。
+ */
+
+#ifndef VDL_DEVICE_COMMAND_PRIORITY_HPP
+#define VDL_DEVICE_COMMAND_PRIORITY_HPP
+
+#include "../core/types.hpp"
+#include "../core/error.hpp"
+#include "../core/fair_mutex.hpp"
+
+namespace vdl {
+
+// ============================================================================
+// command_priority_t - 命令优先级
+// ============================================================================
+
+/**
+ * @brief 命令优先级（数值越小越优先）
+ */
+enum class command_priority_t : uint8_t {
+    control = 0,     ///< 安全相关的控制命令（如关闭输出）
+    normal = 1,      ///< 默认
+    bulk = 2,        ///< 大块数据传输
+    heartbeat = 3    ///< 心跳（设备空闲时才执行）
+};
+
+constexpr size_t k_command_priority_count = 4;
+
+static_assert(k_command_priority_count == k_lock_priority_levels,
+              "command priorities must map onto fair_mutex_t priority levels");
+static_assert(static_cast<uint8_t>(command_priority_t::normal) == k_default_lock_priority,
+              "normal must be the default lock priority");
+
+inline const char* command_priority_name(command_priority_t priority) {
+    switch (priority) {
+    case command_priority_t::control: return "control";
+    case command_priority_t::normal: return "normal";
+    case command_priority_t::bulk: return "bulk";
+    case command_priority_t::heartbeat: return "heartbeat";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief 当前线程的命令优先级
+ */
+inline command_priority_t current_command_priority() {
+    return static_cast<command_priority_t>(current_lock_priority());
+}
+
+/**
+ * @brief 命令优先级作用域：作用域内当前线程的设备调用按指定优先级排队
+ *
+ * @code
+ * // 安全联锁线程
+ * command_priority_scope_t priority(command_priority_t::control);
+ * psu.execute(make_ascii_command("OUTP OFF"));
+ * @endcode
+ *
+ * @note 优先级只影响排队，已在执行的调用不会被抢占
+ */
+class command_priority_scope_t : private noncopyable_t {
+public:
+    explicit command_priority_scope_t(command_priority_t priority)
+        : m_scope(static_cast<uint8_t>(priority)) {
+    }
+
+private:
+    lock_priority_scope_t m_scope;
+};
+
+// ============================================================================
+// for_each_chunk - 分块执行
+// ============================================================================
+
+/**
+ * @brief 按块执行大块传输
+ * @param count 块数
+ * @param chunk 执行第 i 块，返回 result_t<void>；每块应只做一次有界的设备调用
+ * @param priority 各块的排队优先级
+ * @return 全部成功返回 ok，否则返回第一个失败块的错误（其后的块不再执行）
+ *
+ * 每块结束时设备锁被释放（调用方未持有 device_lock_t 时），
+ * 更高优先级的排队者会先于下一块获得设备。
+ *
+ * @code
+ * // 每次取 4096 点，两段之间允许其他命令插入
+ * for_each_chunk(points / 4096, [&](size_t i) {
+ *     return read_segment(i * 4096, 4096);
+ * });
+ * @endcode
+ */
+template <typename F>
+result_t<void> for_each_chunk(size_t count, F&& chunk,
+                              command_priority_t priority = command_priority_t::bulk) {
+    command_priority_scope_t scope(priority);
+    for (size_t i = 0; i < count; ++i) {
+        result_t<void> result = chunk(i);
+        if (!result) {
+            return result;
+        }
+    }
+    return make_ok();
+}
+
+}  // namespace vdl
+
+#endif  // VDL_DEVICE_COMMAND_PRIORITY_HPP
@@ -13,7 +13,9 @@
 #include "../core/noncopyable.hpp"
 #include "../protocol/command.hpp"
 #include "../protocol/response.hpp"
+#include "circuit_breaker.hpp"
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <functional>
@@ -90,13 +92,23 @@ using reconnect_callback_t = std::function<void(reconnect_event_t event,
                                                  uint8_t max_attempts,
                                                  const error_t& error)>;
 
+/**
+ * @brief 文本响应的行终止方式
+ */
+enum class line_terminator_t : uint8_t {
+    lf = 0,       ///< "\n"（行内的 '\r' 被去除）
+    crlf = 1,     ///< "\r\n"
+    eoi = 2       ///< 无终止符，一次传输读取即为完整消息（如 VISA/USBTMC 的 EOI）
+};
+
 /**
  * @brief 设备配置
  */
 struct device_config_t {
-    milliseconds_t command_timeout = 1000;  ///< 命令超时
+    milliseconds_t command_timeout = 1000;  ///< 命令超时（整个调用的截止时间，包括重试）
     milliseconds_t retry_delay = 100;       ///< 重试延迟（首次）
     uint8_t max_retries = 3;                ///< 最大重试次数
+    milliseconds_t cancel_poll_interval = 10; ///< 持有取消令牌时单次传输等待的上限
     bool auto_reconnect = true;             ///< 自动重连
     
     // 重连高级配置
@@ -104,6 +116,21 @@ struct device_config_t {
     milliseconds_t max_reconnect_delay = 5000; ///< 最大重连延迟（退避上限）
     float backoff_multiplier = 2.0f;        ///< 退避倍数
     bool reconnect_on_timeout = false;      ///< 超时是否触发重连
+    bool background_reconnect = false;      ///< 在后台线程中重连，出错的调用立即返回
+    milliseconds_t reconnect_wait = 0;      ///< 后台重连期间 execute() 等待恢复的上限（0 表示立即返回 not_connected）
+    circuit_breaker_config_t breaker;       ///< 重连熔断（默认不熔断）
+
+    // 流水线配置
+    uint16_t max_in_flight = 8;             ///< execute_async 的最大在途请求数
+
+    // 响应配置
+    bool retain_raw_frame = true;           ///< 响应是否保留原始帧（生产环境可关闭）
+    bool block_terminator = true;           ///< 二进制块之后是否跟随终止符（仅以 EOI 结束的传输设为 false）
+    size_t max_block_size = 256u * 1024u * 1024u; ///< 定长二进制块数据长度上限（防止损坏的块头触发巨量分配）
+    line_terminator_t read_terminator = line_terminator_t::lf; ///< read()/read_chunked() 的行终止方式
+
+    // 指标配置
+    bool collect_metrics = true;            ///< execute()/query() 是否记录分阶段延迟（见 metrics()）
 };
 
 // ============================================================================
@@ -169,6 +196,36 @@ public:
     virtual result_t<response_t> execute(const command_t& cmd,
                                           milliseconds_t timeout_ms) = 0;
 
+    // ========================================================================
+    // 独占访问
+    // ========================================================================
+
+    /**
+     * @brief 获取设备独占锁（阻塞）
+     * 
+     * 锁是可重入的；持有期间其他线程的 execute() 会排队等待，
+     * 心跳（pause_during_lock）会跳过。
+     */
+    virtual void lock() = 0;
+
+    /**
+     * @brief 尝试获取设备独占锁（不阻塞）
+     * @return 成功返回 true，设备正被其他线程使用时返回 false
+     */
+    virtual bool try_lock() = 0;
+
+    /**
+     * @brief 获取设备独占锁（带超时）
+     * @param timeout_ms 最长等待时间
+     * @return 成功返回 true，超时返回 false
+     */
+    virtual bool try_lock_for(milliseconds_t timeout_ms) = 0;
+
+    /**
+     * @brief 释放设备独占锁
+     */
+    virtual void unlock() = 0;
+
     // ========================================================================
     // 设备信息
     // ========================================================================
@@ -192,6 +249,21 @@ public:
      * @brief 获取设备类型名称
      */
     virtual const char* type_name() const = 0;
+
+    // ========================================================================
+    // 活动状态
+    // ========================================================================
+
+    /**
+     * @brief 最后一次成功 I/O（收到完整响应）的时间
+     * @return 从未成功时返回默认构造的 time_point
+     *
+     * 心跳的 idle_only 模式据此跳过刚有应用流量的设备；
+     * 不记录活动的实现使用默认值，心跳照常发送。
+     */
+    virtual std::chrono::steady_clock::time_point last_success_time() const {
+        return std::chrono::steady_clock::time_point();
+    }
 };
 
 // ============================================================================
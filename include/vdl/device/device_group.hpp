@@ -0,0 +1,572 @@
+/**
+ * @file device_group.hpp
+ * @brief 设备组：并行分发/汇集
+ *
+ * 对机架上的每台设备发送同一条命令（*RST、输出开关、同步读取）时，
+ * 逐台 execute() 的总耗时是 N × RTT。设备组把每台设备的调用作为任务
+ * 提交到线程池并行执行，总耗时约为 max(RTT)，并以组级截止时间兜底。
+ * 启动时的连接与身份查询（connect_all()）同样并行进行，可选的身份缓存
+ * 让已知设备跳过 *IDN? 往返。
+ */
+
+#ifndef VDL_DEVICE_DEVICE_GROUP_HPP
+#define VDL_DEVICE_DEVICE_GROUP_HPP
+
+#include "device.hpp"
+#include "identity_cache.hpp"
+#include "../core/deadline.hpp"
+#include "../core/logging.hpp"
+#include "../core/noncopyable.hpp"
+#include "../core/thread_pool.hpp"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace vdl {
+
+// ============================================================================
+// device_group_t - 设备组
+// ============================================================================
+
+/**
+ * @brief 设备组
+ *
+ * - gather()：每台设备执行同一条命令，按设备顺序返回各自的结果
+ * - scatter()：第 i 条命令发给第 i 台设备
+ * - broadcast()：只关心是否全部成功
+ *
+ * 截止时间是整组的：任务开始时只拿到截止时间前剩余的时间作为超时；
+ * 到期仍未完成的设备记为 timeout，其余结果照常返回（部分结果）。
+ * 需要全部成功时用 gather_all()。
+ *
+ * connect_all() 并行连接所有设备；设置了身份查询函数时连接后查询身份，
+ * 结果通过 info() 读取。设置了身份缓存且设备有资源字符串时，缓存命中的
+ * 设备不再同步查询，而是在 connect_all() 返回后由线程池在后台校验，
+ * 身份变化时更新缓存并回调 identity_callback_t。
+ *
+ * @code
+ * thread_pool_t pool(8);
+ * device_group_t rack({&psu1, &psu2, &dmm1, &dmm2}, pool);
+ * rack.broadcast(make_ascii_command("*RST"), 2000);
+ *
+ * auto readings = rack.gather(make_ascii_command("MEAS:VOLT?"), 500);
+ * for (size_t i = 0; i < readings.size(); ++i) {
+ *     if (readings[i]) { ... }
+ * }
+ * @endcode
+ *
+ * @note 设备、线程池和身份缓存必须比设备组活得久；截止时间到期后仍在执行的
+ *       调用和后台身份校验会在后台结束（不超过该调用自己的超时），期间设备不能析构
+ */
+class device_group_t : private noncopyable_t {
+public:
+    using results_t = std::vector<result_t<response_t>>;
+    using connect_results_t = std::vector<result_t<void>>;
+
+    /**
+     * @brief 身份变化回调（后台校验发现与缓存不一致时，在线程池线程上调用）
+     * @param index 设备序号
+     * @param info 查询到的新身份
+     */
+    using identity_callback_t = std::function<void(size_t index, const device_info_t& info)>;
+
+    /**
+     * @brief 构造函数
+     * @param devices 组内设备（不获取所有权）
+     * @param pool 执行调用的线程池，线程数决定同时进行的调用数
+     */
+    device_group_t(std::vector<i_device_t*> devices, thread_pool_t& pool)
+        : m_devices(std::move(devices))
+        , m_resources(m_devices.size())
+        , m_pool(pool)
+        , m_identity(std::make_shared<_identity_state_t>()) {
+        m_identity->infos.resize(m_devices.size());
+        m_identity->verify.resize(m_devices.size(), false);
+    }
+
+    /**
+     * @brief 添加设备
+     * @param device 设备（不获取所有权）
+     * @param resource 资源字符串（身份缓存的键，空表示不缓存）
+     */
+    void add(i_device_t& device, const std::string& resource = std::string()) {
+        m_devices.push_back(&device);
+        m_resources.push_back(resource);
+        std::lock_guard<std::mutex> lock(m_identity->mutex);
+        m_identity->infos.resize(m_devices.size());
+        m_identity->verify.resize(m_devices.size(), false);
+    }
+
+    /**
+     * @brief 设置设备的资源字符串（身份缓存的键）
+     */
+    void set_resource(size_t index, const std::string& resource) {
+        m_resources[index] = resource;
+    }
+
+    const std::string& resource(size_t index) const {
+        return m_resources[index];
+    }
+
+    size_t size() const {
+        return m_devices.size();
+    }
+
+    i_device_t& device(size_t index) {
+        return *m_devices[index];
+    }
+
+    /**
+     * @brief 设置默认截止时间（调用时传 0 使用该值；0 表示使用各设备的 command_timeout）
+     */
+    void set_default_deadline(milliseconds_t deadline_ms) {
+        m_default_deadline = deadline_ms;
+    }
+
+    /**
+     * @brief 设置身份查询
+     * @param cache 身份缓存（nullptr 表示每次都查询）
+     * @param identify 身份查询函数（为空时 connect_all() 只连接）
+     */
+    void set_identity_cache(device_identity_cache_t* cache,
+                            identify_fn_t identify = scpi_identify) {
+        m_cache = cache;
+        m_identify = std::move(identify);
+    }
+
+    void set_identity_callback(identity_callback_t callback) {
+        std::lock_guard<std::mutex> lock(m_identity->mutex);
+        m_identity->on_changed = std::move(callback);
+    }
+
+    /**
+     * @brief 设备身份（connect_all() 查询或从缓存取得；未知时各字段为空）
+     */
+    device_info_t info(size_t index) const {
+        std::lock_guard<std::mutex> lock(m_identity->mutex);
+        return m_identity->infos[index];
+    }
+
+    // ========================================================================
+    // 连接
+    // ========================================================================
+
+    /**
+     * @brief 并行连接所有设备（已连接的跳过）并取得身份
+     * @param deadline_ms 组级截止时间（0 使用默认值）
+     * @return 与设备顺序一致的结果（截止时间前未完成的为 timeout）
+     *
+     * 同时进行的连接数由线程池线程数限制。每台设备的 connect() 使用
+     * 其自身的 connect_timeout，截止时间到期时尚未开始的设备不再连接；
+     * 身份查询使用截止时间前剩余的时间作为超时。
+     */
+    connect_results_t connect_all(milliseconds_t deadline_ms = 0) {
+        auto identity = m_identity;
+        auto resources = std::make_shared<const std::vector<std::string>>(m_resources);
+        device_identity_cache_t* cache = m_cache;
+        identify_fn_t identify = m_identify;
+
+        connect_results_t results = _run<void>(
+            [identity, resources, cache, identify](i_device_t& device, size_t index,
+                                                   milliseconds_t timeout_ms) -> result_t<void> {
+                if (!device.is_connected()) {
+                    auto connected = device.connect();
+                    if (!connected) {
+                        return connected;
+                    }
+                }
+                if (!identify) {
+                    return make_ok();
+                }
+                const std::string& resource = (*resources)[index];
+                if (cache && !resource.empty()) {
+                    auto cached = cache->find(resource);
+                    if (cached) {
+                        identity->set(index, *cached, true);
+                        return make_ok();
+                    }
+                }
+                auto info = identify(device, timeout_ms);
+                if (!info) {
+                    return make_error_void(info.error());
+                }
+                if (cache && !resource.empty()) {
+                    cache->store(resource, *info);
+                }
+                identity->set(index, *info, false);
+                return make_ok();
+            }, deadline_ms);
+
+        _verify_cached();
+        return results;
+    }
+
+    /**
+     * @brief 断开所有设备
+     */
+    void disconnect_all() {
+        for (auto* device : m_devices) {
+            device->disconnect();
+        }
+    }
+
+    /**
+     * @brief 等待后台身份校验结束
+     * @param timeout_ms 最长等待时间（0 表示不限）
+     * @return 全部结束返回 true，超时返回 false
+     */
+    bool wait_identified(milliseconds_t timeout_ms = 0) {
+        std::unique_lock<std::mutex> lock(m_identity->mutex);
+        auto idle = [this] { return m_identity->pending == 0; };
+        if (timeout_ms == 0) {
+            m_identity->idle.wait(lock, idle);
+            return true;
+        }
+        return m_identity->idle.wait_for(lock, std::chrono::milliseconds(timeout_ms), idle);
+    }
+
+    // ========================================================================
+    // 分发/汇集
+    // ========================================================================
+
+    /**
+     * @brief 每台设备执行同一条命令
+     * @param cmd 命令
+     * @param deadline_ms 组级截止时间（0 使用默认值）
+     * @return 与设备顺序一致的结果（截止时间前未完成的为 timeout）
+     */
+    results_t gather(const command_t& cmd, milliseconds_t deadline_ms = 0) {
+        return _execute(std::make_shared<std::vector<command_t>>(1, cmd), deadline_ms);
+    }
+
+    /**
+     * @brief 第 i 条命令发给第 i 台设备
+     * @param commands 命令（个数必须与设备数相同）
+     * @param deadline_ms 组级截止时间（0 使用默认值）
+     */
+    results_t scatter(const std::vector<command_t>& commands, milliseconds_t deadline_ms = 0) {
+        if (commands.size() != m_devices.size()) {
+            return results_t(m_devices.size(), make_error<response_t>(
+                error_code_t::invalid_argument, "Command count does not match group size"));
+        }
+        return _execute(std::make_shared<std::vector<command_t>>(commands), deadline_ms);
+    }
+
+    /**
+     * @brief 每台设备执行同一条命令，全部成功才返回响应
+     * @return 失败时返回设备顺序中第一个错误
+     */
+    result_t<std::vector<response_t>> gather_all(const command_t& cmd,
+                                                 milliseconds_t deadline_ms = 0) {
+        results_t results = gather(cmd, deadline_ms);
+        std::vector<response_t> responses;
+        responses.reserve(results.size());
+        for (auto& result : results) {
+            if (!result) {
+                return make_unexpected(result.error());
+            }
+            responses.push_back(std::move(*result));
+        }
+        return make_ok(std::move(responses));
+    }
+
+    /**
+     * @brief 每台设备执行同一条命令，丢弃响应
+     * @return 全部成功返回 ok，否则返回设备顺序中第一个错误
+     */
+    result_t<void> broadcast(const command_t& cmd, milliseconds_t deadline_ms = 0) {
+        results_t results = gather(cmd, deadline_ms);
+        for (const auto& result : results) {
+            if (!result) {
+                return make_error_void(result.error());
+            }
+        }
+        return make_ok();
+    }
+
+private:
+    /**
+     * @brief 单台设备上的任务
+     * @param timeout_ms 截止时间前剩余的时间（0 表示没有截止时间）
+     */
+    template <typename T>
+    using _task_t = std::function<result_t<T>(i_device_t& device, size_t index,
+                                              milliseconds_t timeout_ms)>;
+
+    /**
+     * @brief 一次分发的共享状态（截止时间后才完成的任务仍会写入）
+     */
+    template <typename T>
+    struct _batch_t {
+        explicit _batch_t(size_t count)
+            : results(count)
+            , remaining(count) {
+        }
+
+        _task_t<T> task;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::vector<optional_t<result_t<T>>> results;
+        size_t remaining;
+    };
+
+    /**
+     * @brief 身份状态（后台校验在设备组之外仍可能写入）
+     */
+    struct _identity_state_t {
+        void set(size_t index, const device_info_t& info, bool needs_verify) {
+            std::lock_guard<std::mutex> lock(mutex);
+            infos[index] = info;
+            verify[index] = needs_verify;
+        }
+
+        void finish_one() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) {
+                idle.notify_all();
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable idle;
+        std::vector<device_info_t> infos;
+        std::vector<bool> verify;           ///< 取自缓存、尚待校验
+        size_t pending = 0;                 ///< 进行中的后台校验数
+        identity_callback_t on_changed;
+    };
+
+    template <typename T>
+    static void _complete(_batch_t<T>& batch, size_t index, result_t<T> result) {
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> lock(batch.mutex);
+            batch.results[index] = std::move(result);
+            last = --batch.remaining == 0;
+        }
+        if (last) {
+            batch.done.notify_all();
+        }
+    }
+
+    results_t _execute(std::shared_ptr<const std::vector<command_t>> commands,
+                       milliseconds_t deadline_ms) {
+        return _run<response_t>(
+            [commands](i_device_t& device, size_t index, milliseconds_t timeout_ms) {
+                const command_t& cmd = (*commands)[commands->size() == 1 ? 0 : index];
+                return timeout_ms > 0 ? device.execute(cmd, timeout_ms) : device.execute(cmd);
+            }, deadline_ms);
+    }
+
+    template <typename T>
+    std::vector<result_t<T>> _run(_task_t<T> task, milliseconds_t deadline_ms) {
+        const size_t count = m_devices.size();
+        if (count == 0) {
+            return std::vector<result_t<T>>();
+        }
+        if (deadline_ms == 0) {
+            deadline_ms = m_default_deadline;
+        }
+        const bool has_deadline = deadline_ms > 0;
+        const deadline_t deadline = deadline_t::after(deadline_ms);
+
+        auto batch = std::make_shared<_batch_t<T>>(count);
+        batch->task = std::move(task);
+
+        for (size_t i = 0; i < count; ++i) {
+            i_device_t* device = m_devices[i];
+            auto future = m_pool.submit([batch, device, i, has_deadline, deadline] {
+                if (!has_deadline) {
+                    _complete(*batch, i, batch->task(*device, i, 0));
+                    return;
+                }
+                const milliseconds_t left = deadline.remaining_ms();
+                if (left == 0) {
+                    _complete(*batch, i, result_t<T>(make_unexpected(
+                        error_t(error_code_t::timeout, "Group deadline exceeded"))));
+                    return;
+                }
+                _complete(*batch, i, batch->task(*device, i, left));
+            });
+            if (!future.valid()) {
+                _complete(*batch, i, result_t<T>(make_unexpected(
+                    error_t(error_code_t::invalid_state, "Thread pool is shut down"))));
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(batch->mutex);
+        if (has_deadline) {
+            batch->done.wait_until(lock, deadline.at(), [&batch] { return batch->remaining == 0; });
+        } else {
+            batch->done.wait(lock, [&batch] { return batch->remaining == 0; });
+        }
+
+        std::vector<result_t<T>> results;
+        results.reserve(count);
+        for (auto& slot : batch->results) {
+            if (slot) {
+                results.push_back(std::move(*slot));
+            } else {
+                results.push_back(make_unexpected(
+                    error_t(error_code_t::timeout, "Group deadline exceeded")));
+            }
+        }
+        return results;
+    }
+
+    /**
+     * @brief 把取自缓存的身份交给线程池在后台校验
+     */
+    void _verify_cached() {
+        std::vector<size_t> indices;
+        {
+            std::lock_guard<std::mutex> lock(m_identity->mutex);
+            for (size_t i = 0; i < m_identity->verify.size(); ++i) {
+                if (m_identity->verify[i]) {
+                    m_identity->verify[i] = false;
+                    indices.push_back(i);
+                }
+            }
+            m_identity->pending += indices.size();
+        }
+
+        for (size_t index : indices) {
+            auto identity = m_identity;
+            device_identity_cache_t* cache = m_cache;
+            identify_fn_t identify = m_identify;
+            std::string resource = m_resources[index];
+            i_device_t* device = m_devices[index];
+            auto future = m_pool.submit([identity, cache, identify, resource, device, index] {
+                _verify_one(*identity, cache, identify, resource, *device, index);
+                identity->finish_one();
+            });
+            if (!future.valid()) {
+                identity->finish_one();
+            }
+        }
+    }
+
+    static void _verify_one(_identity_state_t& identity, device_identity_cache_t* cache,
+                            const identify_fn_t& identify, const std::string& resource,
+                            i_device_t& device, size_t index) {
+        auto info = identify(device, 0);
+        if (!info) {
+            VDL_LOG_DEBUG("Identity check for %s failed: %s", resource.c_str(),
+                          info.error().to_string().c_str());
+            return;
+        }
+
+        identity_callback_t callback;
+        {
+            std::lock_guard<std::mutex> lock(identity.mutex);
+            if (same_identity(identity.infos[index], *info)) {
+                return;
+            }
+            identity.infos[index] = *info;
+            callback = identity.on_changed;
+        }
+        VDL_LOG_INFO("Identity of %s changed: %s %s", resource.c_str(),
+                     info->model.c_str(), info->serial_number.c_str());
+        if (cache) {
+            cache->store(resource, *info);
+        }
+        if (callback) {
+            try {
+                callback(index, *info);
+            } catch (const std::exception& e) {
+                VDL_LOG_WARN("Identity callback threw exception: %s", e.what());
+            }
+        }
+    }
+
+    std::vector<i_device_t*> m_devices;
+    std::vector<std::string> m_resources;
+    thread_pool_t& m_pool;
+    milliseconds_t m_default_deadline = 0;
+    device_identity_cache_t* m_cache = nullptr;
+    identify_fn_t m_identify;
+    std::shared_ptr<_identity_state_t> m_identity;
+};
+
+// ============================================================================
+// device_group_guard_t - 设备组连接守卫
+// ============================================================================
+
+/**
+ * @brief 设备组连接守卫，语义同 device_guard_t
+ *
+ * 构造时 connect_all()，析构时断开构造前未连接的设备
+ * （包括截止时间到期后才在后台连上的），原本已连接的设备不受影响。
+ *
+ * @code
+ * {
+ *     device_group_guard_t guard(rack, 5000);
+ *     if (guard.has_error()) {
+ *         // 部分设备未连上：guard.results()[i]
+ *     }
+ *     rack.gather(make_ascii_command("MEAS:VOLT?"), 500);
+ * }  // 自动断开
+ * @endcode
+ */
+class device_group_guard_t : private noncopyable_t {
+public:
+    explicit device_group_guard_t(device_group_t& group, milliseconds_t deadline_ms = 0)
+        : m_group(group)
+        , m_owned(group.size(), false) {
+        for (size_t i = 0; i < group.size(); ++i) {
+            m_owned[i] = !group.device(i).is_connected();
+        }
+        m_results = group.connect_all(deadline_ms);
+    }
+
+    ~device_group_guard_t() {
+        for (size_t i = 0; i < m_owned.size(); ++i) {
+            if (m_owned[i] && m_group.device(i).is_connected()) {
+                m_group.device(i).disconnect();
+            }
+        }
+    }
+
+    /**
+     * @brief 各设备的连接结果
+     */
+    const device_group_t::connect_results_t& results() const {
+        return m_results;
+    }
+
+    /**
+     * @brief 是否有设备连接失败
+     */
+    bool has_error() const {
+        for (const auto& result : m_results) {
+            if (!result) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    device_group_t& group() {
+        return m_group;
+    }
+
+    /**
+     * @brief 释放连接所有权（不再自动断开）
+     */
+    void release() {
+        m_owned.assign(m_owned.size(), false);
+    }
+
+private:
+    device_group_t& m_group;
+    std::vector<bool> m_owned;
+    device_group_t::connect_results_t m_results;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_DEVICE_DEVICE_GROUP_HPP
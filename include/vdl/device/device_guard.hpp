@@ -2,7 +2,7 @@
  * @file device_guard.hpp
  * @brief 设备连接守卫
  * 
- * 提供 RAII 风格的设备连接管理。
+ * 提供 RAII 风格的设备连接管理和独占锁管理。
  */
 
 #ifndef VDL_DEVICE_DEVICE_GUARD_HPP
@@ -116,6 +116,93 @@ private:
     error_t m_connect_error;
 };
 
+// ============================================================================
+// device_lock_t - 设备独占锁守卫
+// ============================================================================
+
+/**
+ * @brief 设备独占锁守卫，RAII 风格管理 i_device_t::lock()/unlock()
+ * 
+ * 持有期间其他线程的命令排队等待，心跳跳过，
+ * 适用于必须连续完成的多步操作（如大块数据传输）。
+ * 
+ * @code
+ * {
+ *     device_lock_t lock(device, 500);
+ *     if (!lock.owns_lock()) {
+ *         // 500ms 内未获得设备
+ *         return;
+ *     }
+ *     
+ *     device.execute(cmd1);
+ *     device.execute(cmd2);
+ * }  // 自动释放
+ * @endcode
+ */
+class device_lock_t : private noncopyable_t {
+public:
+    /**
+     * @brief 构造函数，阻塞直到获得锁
+     * @param device 设备引用
+     */
+    explicit device_lock_t(i_device_t& device)
+        : m_device(&device)
+        , m_owns_lock(true) {
+        device.lock();
+    }
+
+    /**
+     * @brief 构造函数，最多等待 timeout_ms
+     * @param device 设备引用
+     * @param timeout_ms 最长等待时间，<= 0 表示只尝试一次
+     */
+    device_lock_t(i_device_t& device, milliseconds_t timeout_ms)
+        : m_device(&device)
+        , m_owns_lock(device.try_lock_for(timeout_ms)) {
+    }
+
+    /**
+     * @brief 移动构造函数
+     */
+    device_lock_t(device_lock_t&& other)
+        : m_device(other.m_device)
+        , m_owns_lock(other.m_owns_lock) {
+        other.m_owns_lock = false;
+    }
+
+    /**
+     * @brief 析构函数，自动释放锁
+     */
+    ~device_lock_t() {
+        unlock();
+    }
+
+    /**
+     * @brief 检查是否持有锁
+     */
+    bool owns_lock() const {
+        return m_owns_lock;
+    }
+
+    explicit operator bool() const {
+        return m_owns_lock;
+    }
+
+    /**
+     * @brief 提前释放锁
+     */
+    void unlock() {
+        if (m_owns_lock) {
+            m_owns_lock = false;
+            m_device->unlock();
+        }
+    }
+
+private:
+    i_device_t* m_device;
+    bool m_owns_lock;
+};
+
 // ============================================================================
 // 工厂函数
 // ============================================================================
@@ -9,51 +9,210 @@
 #define VDL_DEVICE_DEVICE_IMPL_HPP
 
 #include "device.hpp"
+#include "async_response.hpp"
+#include "device_metrics.hpp"
+#include "execution_observer.hpp"
 #include "../transport/transport.hpp"
 #include "../codec/codec.hpp"
+#include "../core/arena.hpp"
 #include "../core/buffer.hpp"
+#include "../core/deadline.hpp"
+#include "../core/event_dispatcher.hpp"
+#include "../core/fair_mutex.hpp"
 #include "../core/logging.hpp"
+#include "../core/memory.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 #include <thread>
 #include <chrono>
 
 namespace vdl {
 
+namespace detail {
+
 // ============================================================================
-// device_impl_t - 设备实现基类
+// 传输层/编解码器调用分派
 // ============================================================================
 
 /**
- * @brief 设备实现基类
+ * @brief 具体类型用限定名调用（不经虚函数表，可跨层内联），接口类型按虚函数调用
+ */
+template <typename T>
+struct is_direct_dispatch_t : std::integral_constant<bool, !std::is_abstract<T>::value> {};
+
+template <typename Transport, bool Direct = is_direct_dispatch_t<Transport>::value>
+struct transport_ops_t {
+    static bool is_open(const Transport& t) {
+        return t.is_open();
+    }
+
+    static result_t<size_t> read(Transport& t, byte_span_t buffer, milliseconds_t timeout_ms) {
+        return t.read(buffer, timeout_ms);
+    }
+
+    static result_t<void> write_all(Transport& t, const_byte_span_t data, milliseconds_t timeout_ms) {
+        return t.write_all(data, timeout_ms);
+    }
+
+    static result_t<void> writev_all(Transport& t, span_t<const const_byte_span_t> pieces,
+                                     milliseconds_t timeout_ms) {
+        return t.writev_all(pieces, timeout_ms);
+    }
+};
+
+template <typename Transport>
+struct transport_ops_t<Transport, true> {
+    static bool is_open(const Transport& t) {
+        return t.Transport::is_open();
+    }
+
+    static result_t<size_t> read(Transport& t, byte_span_t buffer, milliseconds_t timeout_ms) {
+        return t.Transport::read(buffer, timeout_ms);
+    }
+
+    static result_t<void> write_all(Transport& t, const_byte_span_t data, milliseconds_t timeout_ms) {
+        return t.Transport::write_all(data, timeout_ms);
+    }
+
+    static result_t<void> writev_all(Transport& t, span_t<const const_byte_span_t> pieces,
+                                     milliseconds_t timeout_ms) {
+        return t.Transport::writev_all(pieces, timeout_ms);
+    }
+};
+
+template <typename Codec, bool Direct = is_direct_dispatch_t<Codec>::value>
+struct codec_ops_t {
+    static size_t frame_length(const Codec& c, const_byte_span_t buffer) {
+        return c.frame_length(buffer);
+    }
+
+    static result_t<response_t> decode(Codec& c, const_byte_span_t buffer, size_t& consumed) {
+        return c.decode(buffer, consumed);
+    }
+
+    static result_t<response_t> decode_slice(Codec& c, const byte_slice_t& frame, size_t& consumed) {
+        return c.decode_slice(frame, consumed);
+    }
+
+    static result_t<size_t> encoded_size(Codec& c, const command_t& cmd) {
+        return c.encoded_size(cmd);
+    }
+
+    static result_t<size_t> encode_into(Codec& c, const command_t& cmd, byte_span_t out) {
+        return c.encode_into(cmd, out);
+    }
+
+    static result_t<void> encode_parts(Codec& c, const command_t& cmd, frame_parts_t& parts) {
+        return c.encode_parts(cmd, parts);
+    }
+
+    static optional_t<uint32_t> correlation_key(const Codec& c, const_byte_span_t frame) {
+        return c.correlation_key(frame);
+    }
+
+    static size_t max_frame_size(const Codec& c) {
+        return c.max_frame_size();
+    }
+};
+
+template <typename Codec>
+struct codec_ops_t<Codec, true> {
+    static size_t frame_length(const Codec& c, const_byte_span_t buffer) {
+        return c.Codec::frame_length(buffer);
+    }
+
+    static result_t<response_t> decode(Codec& c, const_byte_span_t buffer, size_t& consumed) {
+        return c.Codec::decode(buffer, consumed);
+    }
+
+    static result_t<response_t> decode_slice(Codec& c, const byte_slice_t& frame, size_t& consumed) {
+        return c.Codec::decode_slice(frame, consumed);
+    }
+
+    static result_t<size_t> encoded_size(Codec& c, const command_t& cmd) {
+        return c.Codec::encoded_size(cmd);
+    }
+
+    static result_t<size_t> encode_into(Codec& c, const command_t& cmd, byte_span_t out) {
+        return c.Codec::encode_into(cmd, out);
+    }
+
+    static result_t<void> encode_parts(Codec& c, const command_t& cmd, frame_parts_t& parts) {
+        return c.Codec::encode_parts(cmd, parts);
+    }
+
+    static optional_t<uint32_t> correlation_key(const Codec& c, const_byte_span_t frame) {
+        return c.Codec::correlation_key(frame);
+    }
+
+    static size_t max_frame_size(const Codec& c) {
+        return c.Codec::max_frame_size();
+    }
+};
+
+}  // namespace detail
+
+// ============================================================================
+// basic_device_t - 设备实现
+// ============================================================================
+
+/**
+ * @brief 设备实现
  * 
  * 通过组合 Transport 和 Codec 实现设备接口。
  * 
+ * - device_impl_t（basic_device_t<i_transport_t, i_codec_t>）按接口调用，是默认选择
+ * - Transport/Codec 为具体类型时，收发和分帧路径上的调用不经虚函数表，
+ *   编译器可以把 CRC、分帧和读循环内联到一起
+ * 
+ * @note 静态分派按 Transport/Codec 的成员直接调用，对象的实际类型必须就是
+ *       Transport/Codec（不能是进一步覆盖了这些函数的派生类）
+ * 
  * @code
  * // 创建设备
  * auto transport = std::make_unique<tcp_transport_t>("192.168.1.100", 502);
- * auto codec = std::make_unique<modbus_codec_t>();
+ * auto codec = std::make_unique<modbus_tcp_codec_t>();
  * 
  * device_impl_t device(std::move(transport), std::move(codec));
  * device.connect();
  * 
  * auto result = device.execute(make_read_command(0x03, 0x0000, 10));
+ * 
+ * // 热循环：静态分派
+ * basic_device_t<tcp_transport_t, modbus_tcp_codec_t> fast(
+ *     make_unique<tcp_transport_t>("192.168.1.100", 502),
+ *     make_unique<modbus_tcp_codec_t>());
  * @endcode
  */
-class device_impl_t : public i_device_t {
+template <typename Transport, typename Codec>
+class basic_device_t : public i_device_t, private detail::i_async_source_t {
 public:
+    typedef Transport transport_type;
+    typedef Codec codec_type;
+
     /**
      * @brief 构造函数
      * @param transport 传输层实现
      * @param codec 编解码器实现
      */
-    device_impl_t(transport_ptr_t transport, codec_ptr_t codec)
+    basic_device_t(std::unique_ptr<Transport> transport, std::unique_ptr<Codec> codec)
         : m_transport(std::move(transport))
         , m_codec(std::move(codec))
-        , m_state(device_state_t::disconnected) {
+        , m_state(device_state_t::disconnected)
+        , m_rx_buffer(_rx_capacity())
+        , m_breaker(m_config.breaker) {
     }
 
-    ~device_impl_t() override {
+    ~basic_device_t() override {
         disconnect();
     }
 
@@ -62,11 +221,14 @@ public:
     // ========================================================================
 
     result_t<void> connect() override {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        _stop_background_reconnect();
         if (m_state == device_state_t::connected) {
             return make_ok();
         }
 
         m_state = device_state_t::connecting;
+        _reset_rx_buffer();
 
         auto result = m_transport->open();
         if (!result) {
@@ -75,15 +237,21 @@ public:
         }
 
         m_state = device_state_t::connected;
+        m_connection_generation.fetch_add(1, std::memory_order_release);
+        m_breaker.reset();
         VDL_LOG_INFO("Device connected via %s", m_transport->type_name());
 
         return make_ok();
     }
 
     void disconnect() override {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        _stop_background_reconnect();
         if (m_transport) {
             m_transport->close();
         }
+        _fail_pending(error_t(error_code_t::not_connected, "Device disconnected"));
+        m_rx_buffer.clear();
         m_state = device_state_t::disconnected;
     }
 
@@ -93,7 +261,22 @@ public:
 
     bool is_connected() const override {
         return m_state == device_state_t::connected && 
-               m_transport && m_transport->is_open();
+               m_transport && transport_ops_t::is_open(*m_transport);
+    }
+
+    /**
+     * @brief 连接代数：每次成功连接或重连后加一
+     *
+     * 上层缓存（如仪器设置的影子缓存）可据此判断连接是否已更换，
+     * 仪器可能已被重新上电或被其他客户端修改。
+     */
+    uint64_t connection_generation() const {
+        return m_connection_generation.load(std::memory_order_acquire);
+    }
+
+    std::chrono::steady_clock::time_point last_success_time() const override {
+        return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(
+            m_last_success.load(std::memory_order_relaxed)));
     }
 
     // ========================================================================
@@ -104,48 +287,296 @@ public:
         return execute(cmd, m_config.command_timeout);
     }
 
+    /**
+     * @brief 执行命令
+     * @param timeout_ms 整个调用的截止时间（从调用开始计算，包括所有重试和重试间隔）
+     */
     result_t<response_t> execute(const command_t& cmd,
                                   milliseconds_t timeout_ms) override {
+        return _execute(cmd, timeout_ms, nullptr);
+    }
+
+    /**
+     * @brief 执行命令（可取消）
+     * @param cmd 命令对象
+     * @param timeout_ms 整个调用的截止时间
+     * @param token 取消令牌，其他线程调用 cancel() 后本调用以 operation_cancelled 返回
+     *
+     * 取消不会触发重连，设备保持连接；接收缓冲区和传输层中已到达的数据被丢弃，
+     * 但仍在路上的迟到响应可能被下一次读取收到。
+     */
+    result_t<response_t> execute(const command_t& cmd, milliseconds_t timeout_ms,
+                                 const cancellation_token_t& token) {
+        return _execute(cmd, timeout_ms, &token);
+    }
+
+    // ========================================================================
+    // 批量执行
+    // ========================================================================
+
+    /**
+     * @brief 批量执行命令
+     * @param commands 命令序列
+     * @return 与命令一一对应的结果
+     * 
+     * 所有命令编码到一个连续缓冲区中，通过一次 write_all 发送，
+     * 然后按顺序从数据流中解码 N 个响应。
+     * 
+     * - 编码失败或解码失败的命令得到各自的错误，不影响其他命令
+     * - 超时或传输错误时，按 device_config_t 的重试策略重发尚未应答的命令
+     * 
+     * @code
+     * std::vector<command_t> cmds;
+     * for (uint16_t reg = 0; reg < 50; ++reg) {
+     *     cmds.push_back(make_read_command(0x03, reg, 1));
+     * }
+     * auto results = device.execute_batch(cmds);
+     * @endcode
+     */
+    std::vector<result_t<response_t>> execute_batch(span_t<const command_t> commands) {
+        return execute_batch(commands, m_config.command_timeout);
+    }
+
+    std::vector<result_t<response_t>> execute_batch(const std::vector<command_t>& commands) {
+        return execute_batch(span_t<const command_t>(commands.data(), commands.size()),
+                             m_config.command_timeout);
+    }
+
+    /**
+     * @brief 批量执行命令
+     * @param timeout_ms 整个批量（含所有重试）的截止时间
+     */
+    std::vector<result_t<response_t>> execute_batch(span_t<const command_t> commands,
+                                                    milliseconds_t timeout_ms) {
+        const deadline_t deadline = deadline_t::after(timeout_ms);
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        std::vector<result_t<response_t>> results;
+        results.reserve(commands.size());
+        for (size_t i = 0; i < commands.size(); ++i) {
+            results.push_back(make_error<response_t>(error_code_t::not_connected,
+                                                     "Device not connected"));
+        }
+
+        if (commands.empty() || !is_connected()) {
+            return results;
+        }
+
+        wait_all();
         if (!is_connected()) {
-            return make_error<response_t>(error_code_t::not_connected, 
-                                        "Device not connected");
+            return results;
         }
 
-        auto encode_result = m_codec->encode(cmd);
-        if (!encode_result) {
-            return make_unexpected(encode_result.error());
+        // 所有命令依次编码到发送缓冲区，记录每帧的位置
+        size_t frames_size = 0;
+        std::vector<size_t> remaining;
+        std::vector<std::pair<size_t, size_t>> frame_pos(commands.size());
+        for (size_t i = 0; i < commands.size(); ++i) {
+            auto encode_result = _encode_to_tx(commands[i], frames_size);
+            if (!encode_result) {
+                results[i] = make_unexpected(encode_result.error());
+                continue;
+            }
+            frame_pos[i] = std::make_pair(frames_size, *encode_result);
+            frames_size += *encode_result;
+            remaining.push_back(i);
         }
+        const bytes_t& frames = m_tx_buffer;
 
-        const auto& frame = *encode_result;
-        const_byte_span_t frame_span(frame.data(), frame.size());
+        if (remaining.empty()) {
+            return results;
+        }
 
         const uint8_t max_attempts = std::max<uint8_t>(1, m_config.max_retries);
         error_t last_error{error_code_t::ok};
+        bytes_t retry_frames;
 
         for (uint8_t attempt = 0; attempt < max_attempts; ++attempt) {
-            auto write_result = m_transport->write_all(frame_span, timeout_ms);
+            const_byte_span_t batch_span(frames.data(), frames_size);
+            if (attempt > 0) {
+                // 只重发尚未应答的命令
+                m_rx_buffer.clear();
+                retry_frames.clear();
+                for (size_t idx : remaining) {
+                    const auto& pos = frame_pos[idx];
+                    retry_frames.insert(retry_frames.end(),
+                                        frames.begin() + static_cast<offset_t>(pos.first),
+                                        frames.begin() + static_cast<offset_t>(pos.first + pos.second));
+                }
+                batch_span = const_byte_span_t(retry_frames.data(), retry_frames.size());
+            }
+
+            auto write_result = _write_pieces(span_t<const const_byte_span_t>(&batch_span, 1),
+                                              deadline);
             if (!write_result) {
                 last_error = write_result.error();
             } else {
-                auto read_result = _read_response(timeout_ms, /*handle_error_on_fail=*/false);
-                if (read_result) {
-                    return read_result;
+                size_t answered = 0;
+                for (size_t idx : remaining) {
+                    auto read_result = _read_response(deadline, /*handle_error_on_fail=*/false);
+                    if (!read_result &&
+                        read_result.error().category() != error_category_t::protocol) {
+                        last_error = read_result.error();
+                        break;
+                    }
+                    results[idx] = std::move(read_result);
+                    ++answered;
+                }
+                remaining.erase(remaining.begin(),
+                                remaining.begin() + static_cast<offset_t>(answered));
+                if (remaining.empty()) {
+                    return results;
                 }
-                last_error = read_result.error();
             }
 
             const bool has_more = (static_cast<uint8_t>(attempt + 1)) < max_attempts;
-            if (!has_more) {
+            if (!has_more || _is_cancelled(last_error) || !_wait_retry_delay(deadline)) {
                 break;
             }
-
-            if (m_config.retry_delay > 0) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(m_config.retry_delay));
-            }
         }
 
+        for (size_t idx : remaining) {
+            results[idx] = make_unexpected(last_error);
+        }
+        if (_is_cancelled(last_error)) {
+            m_rx_buffer.clear();
+            m_transport->flush_read();
+            return results;
+        }
         _handle_error(last_error);
-        return make_unexpected(last_error);
+        return results;
+    }
+
+    /**
+     * @brief 批量执行命令（可取消）
+     * @param timeout_ms 整个批量（含所有重试）的截止时间
+     * @param token 取消令牌，取消后尚未应答的命令以 operation_cancelled 返回
+     */
+    std::vector<result_t<response_t>> execute_batch(span_t<const command_t> commands,
+                                                    milliseconds_t timeout_ms,
+                                                    const cancellation_token_t& token) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        _cancel_scope_t cancel_scope(m_cancel, &token);
+        return execute_batch(commands, timeout_ms);
+    }
+
+    // ========================================================================
+    // 流水线执行
+    // ========================================================================
+
+    /**
+     * @brief 异步执行命令（流水线）
+     * @param cmd 命令对象
+     * @param callback 可选的完成回调
+     * @return 响应句柄
+     * 
+     * 命令立即发送，不等待之前请求的响应；在途请求数达到
+     * device_config_t::max_in_flight 时，先完成最早的请求再发送。
+     * 响应按编解码器提供的关联键匹配，没有关联键时按 FIFO 顺序匹配。
+     * 
+     * @note 流水线请求不做重试；超时或传输错误会使所有在途请求失败，
+     *       因为此后无法确定响应与请求的对应关系
+     * 
+     * @code
+     * std::vector<async_response_t> handles;
+     * for (const auto& cmd : commands) {
+     *     handles.push_back(device.execute_async(cmd));
+     * }
+     * for (auto& h : handles) {
+     *     auto result = h.get();
+     * }
+     * @endcode
+     */
+    async_response_t execute_async(const command_t& cmd,
+                                   async_callback_t callback = nullptr) {
+        return execute_async(cmd, m_config.command_timeout, std::move(callback));
+    }
+
+    /**
+     * @brief 异步执行命令（带超时）
+     */
+    async_response_t execute_async(const command_t& cmd,
+                                   milliseconds_t timeout_ms,
+                                   async_callback_t callback = nullptr) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        auto state = std::make_shared<detail::async_state_t>();
+        state->timeout_ms = timeout_ms;
+        state->tag = cmd.tag();
+        state->callback = std::move(callback);
+
+        if (!is_connected()) {
+            state->complete(make_error<response_t>(error_code_t::not_connected,
+                                                   "Device not connected"));
+            return async_response_t(std::move(state));
+        }
+
+        auto encode_result = _encode_to_tx(cmd, 0);
+        if (!encode_result) {
+            state->complete(make_unexpected(encode_result.error()));
+            return async_response_t(std::move(state));
+        }
+
+        // 窗口已满时先完成最早的请求
+        const size_t window = std::max<size_t>(1, m_config.max_in_flight);
+        while (m_pending.size() >= window) {
+            _complete_next_pending();
+        }
+
+        if (!is_connected()) {
+            state->complete(make_error<response_t>(error_code_t::not_connected,
+                                                   "Device not connected"));
+            return async_response_t(std::move(state));
+        }
+
+        const_byte_span_t frame_span(m_tx_buffer.data(), *encode_result);
+        auto write_result = transport_ops_t::write_all(*m_transport, frame_span, timeout_ms);
+        if (!write_result) {
+            state->complete(make_unexpected(write_result.error()));
+            _fail_pending(write_result.error());
+            _handle_error(write_result.error());
+            return async_response_t(std::move(state));
+        }
+
+        state->key = codec_ops_t::correlation_key(*m_codec, frame_span);
+        state->set_source(this);
+        m_pending.push_back(state);
+        return async_response_t(std::move(state));
+    }
+
+    /**
+     * @brief 获取在途（已发送未完成）的请求数
+     */
+    size_t in_flight() const {
+        return m_pending.size();
+    }
+
+    /**
+     * @brief 完成所有在途请求
+     */
+    void wait_all() {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        while (!m_pending.empty()) {
+            _complete_next_pending();
+        }
+    }
+
+    // ========================================================================
+    // i_device_t 实现 - 独占访问
+    // ========================================================================
+
+    void lock() override {
+        m_lock.lock();
+    }
+
+    bool try_lock() override {
+        return m_lock.try_lock();
+    }
+
+    bool try_lock_for(milliseconds_t timeout_ms) override {
+        return m_lock.try_lock_for(timeout_ms);
+    }
+
+    void unlock() override {
+        m_lock.unlock();
     }
 
     // ========================================================================
@@ -161,7 +592,9 @@ public:
     }
 
     void set_config(const device_config_t& config) override {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
         m_config = config;
+        m_breaker.set_config(config.breaker);
     }
 
     const char* type_name() const override {
@@ -207,46 +640,129 @@ public:
         m_reconnect_callback = std::move(callback);
     }
 
+    /**
+     * @brief 通过事件分发器异步执行重连回调
+     * @param dispatcher 分发器（nullptr 表示在重连线程中直接执行）
+     *
+     * 异步执行时回调不会占用出错命令的线程，也不在设备锁内运行。
+     */
+    void set_event_dispatcher(event_dispatcher_t* dispatcher) {
+        m_event_dispatcher = dispatcher;
+    }
+
     /**
      * @brief 手动触发重连
      * @return 成功返回 ok，失败返回错误
      */
     result_t<void> reconnect() {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        _stop_background_reconnect();
         if (m_state == device_state_t::connected) {
             return make_ok();
         }
 
+        // 手动重连绕过熔断器，成功后熔断器复位
         error_t trigger_error(error_code_t::not_connected, "Manual reconnect requested");
         _try_reconnect(trigger_error);
 
         if (m_state == device_state_t::connected) {
+            m_breaker.reset();
             return make_ok();
         }
         return make_error_void(error_code_t::connection_failed, "Reconnect failed");
     }
 
+    /**
+     * @brief 重连熔断器状态
+     */
+    circuit_state_t circuit_state() const {
+        return m_breaker.state();
+    }
+
+    /**
+     * @brief 复位熔断器（允许立即再次自动重连）
+     */
+    void reset_circuit() {
+        m_breaker.reset();
+    }
+
+    /**
+     * @brief 后台重连是否正在进行
+     */
+    bool reconnecting() const {
+        return m_reconnect_running.load(std::memory_order_acquire);
+    }
+
     /**
      * @brief 获取传输层
      */
-    i_transport_t* transport() {
+    Transport* transport() {
         return m_transport.get();
     }
 
-    const i_transport_t* transport() const {
+    const Transport* transport() const {
         return m_transport.get();
     }
 
     /**
      * @brief 获取编解码器
      */
-    i_codec_t* codec() {
+    Codec* codec() {
         return m_codec.get();
     }
 
-    const i_codec_t* codec() const {
+    const Codec* codec() const {
         return m_codec.get();
     }
 
+    // ========================================================================
+    // 指标
+    // ========================================================================
+
+    /**
+     * @brief 获取分阶段延迟和重试/重连计数的快照
+     *
+     * execute() 记录 encode/write/first_byte/receive/decode/retry_wait/total，
+     * 并按功能码记录 total；query() 记录 write/first_byte/receive/decode/total。
+     * device_config_t::collect_metrics 为 false 时只更新计数。
+     * queues 为设备锁按 command_priority_t 分级的排队深度和等待时间。
+     *
+     * @code
+     * auto m = device.metrics();
+     * auto first = m.phase(execute_phase_t::first_byte);
+     * std::printf("p99 first byte: %llu us\n", first.p99_ns / 1000);
+     * @endcode
+     */
+    device_metrics_t metrics() const {
+        device_metrics_t metrics = m_metrics.snapshot();
+        for (size_t i = 0; i < k_command_priority_count; ++i) {
+            metrics.queues[i] = m_lock.wait_stats(static_cast<uint8_t>(i));
+        }
+        return metrics;
+    }
+
+    void reset_metrics() {
+        m_metrics.reset();
+        m_lock.reset_wait_stats();
+    }
+
+    // ========================================================================
+    // 追踪
+    // ========================================================================
+
+    /**
+     * @brief 挂接执行观察者
+     * @param observer 观察者（nullptr 表示卸下）
+     * @param sample_every execute()/query() 每 sample_every 次观察 1 次（0 视为 1）
+     *
+     * execute()/query() 各产生一个区间，自动重连产生 reconnect 区间（不参与采样）。
+     * 未挂接时每次调用只多一次指针判断。
+     */
+    void set_execution_observer(execution_observer_ptr_t observer, uint32_t sample_every = 1) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        m_observers.set(std::move(observer), sample_every);
+    }
+
     // ========================================================================
     // 便捷接口 - 原始数据读写（低层 API）
     // ========================================================================
@@ -259,6 +775,7 @@ public:
      */
     result_t<void> write_raw(const_byte_span_t data, 
                              milliseconds_t timeout_ms = 0) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
         if (!is_connected()) {
             return make_error_void(error_code_t::not_connected, 
                                   "Device not connected");
@@ -268,7 +785,7 @@ public:
             timeout_ms = m_config.command_timeout;
         }
 
-        return m_transport->write_all(data, timeout_ms);
+        return transport_ops_t::write_all(*m_transport, data, timeout_ms);
     }
 
     /**
@@ -279,6 +796,7 @@ public:
      */
     result_t<bytes_t> read_raw(size_t max_bytes, 
                                milliseconds_t timeout_ms = 0) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
         if (!is_connected()) {
             return make_error<bytes_t>(error_code_t::not_connected);
         }
@@ -289,7 +807,7 @@ public:
 
         bytes_t buffer(max_bytes);
         byte_span_t span(buffer.data(), buffer.size());
-        auto result = m_transport->read(span, timeout_ms);
+        auto result = transport_ops_t::read(*m_transport, span, timeout_ms);
         if (!result) {
             return make_unexpected(result.error());
         }
@@ -308,12 +826,12 @@ public:
      * @return 成功返回 ok，失败返回错误
      */
     result_t<void> write(const std::string& text) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
         if (!is_connected()) {
             return make_error_void(error_code_t::not_connected);
         }
 
-        bytes_t data(text.begin(), text.end());
-        const_byte_span_t span(data.data(), data.size());
+        const_byte_span_t span(reinterpret_cast<const byte_t*>(text.data()), text.size());
         return write_raw(span, m_config.command_timeout);
     }
 
@@ -323,66 +841,134 @@ public:
      * @return 成功返回响应文本，失败返回错误
      */
     result_t<std::string> read(milliseconds_t timeout_ms = 0) {
+        return _read_text<std::string>(timeout_ms, std::allocator<char>());
+    }
+
+    /**
+     * @brief 读取文本响应（响应文本分配在事务内存区中）
+     * @param scope 事务作用域，返回的文本不能存活到作用域结束之后
+     * @param timeout_ms 超时时间
+     * @return 成功返回响应文本，失败返回错误
+     */
+    result_t<arena_string_t> read(transaction_scope_t& scope, milliseconds_t timeout_ms = 0) {
+        return _read_text<arena_string_t>(timeout_ms, arena_allocator_t<char>(scope.arena()));
+    }
+
+    /**
+     * @brief 读取文本响应（可取消）
+     * @param timeout_ms 整个读取的截止时间
+     * @param token 取消令牌，其他线程调用 cancel() 后本调用以 operation_cancelled 返回
+     */
+    result_t<std::string> read(milliseconds_t timeout_ms, const cancellation_token_t& token) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        _cancel_scope_t cancel_scope(m_cancel, &token);
+        return read(timeout_ms);
+    }
+
+    /**
+     * @brief 文本分块回调类型
+     *
+     * 每收到一段数据调用一次，返回错误时停止读取。
+     */
+    using text_chunk_callback_t = std::function<result_t<void>(const char* data, size_t len)>;
+
+    /**
+     * @brief 分块读取一行文本响应，不拼接完整字符串
+     * @param on_chunk 分块回调（不含结尾的终止符，终止方式见 read_terminator）
+     * @param timeout_ms 超时时间
+     * @return 成功返回该行的总字节数，失败返回错误
+     *
+     * 数据从接收缓冲区直接交给回调后即被释放，峰值内存只有一个接收缓冲区。
+     * 终止符之后的数据保留在接收缓冲区中。
+     *
+     * @note lf 模式下回调可能收到行内的 '\r'，调用者应将其视为空白
+     */
+    result_t<size_t> read_chunked(const text_chunk_callback_t& on_chunk,
+                                  milliseconds_t timeout_ms = 0) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
         if (!is_connected()) {
-            return make_error<std::string>(error_code_t::not_connected);
+            return make_error<size_t>(error_code_t::not_connected);
         }
 
         if (timeout_ms == 0) {
             timeout_ms = m_config.command_timeout;
         }
 
-        // 读取数据直到看到换行符或超时
-        ring_buffer_t buffer(m_codec->max_frame_size());
-        bytes_t temp(1024);
-        bytes_t data_copy;
+        wait_all();
+        const deadline_t deadline = deadline_t::after(timeout_ms);
 
+        const bool eoi = m_config.read_terminator == line_terminator_t::eoi;
+        size_t total = 0;
+        optional_t<error_t> chunk_error;   // 回调失败后继续读完该行再返回
         while (true) {
-            // 检查是否有完整行（以 \n 结尾）
-            size_t data_size = buffer.readable_size();
-            if (data_size > 0) {
-                data_copy.resize(data_size);
-                buffer.peek(data_copy.data(), data_size);
-                
-                // 查找换行符
-                auto* newline_pos = static_cast<byte_t*>(
-                    memchr(data_copy.data(), '\n', data_size));
-                if (newline_pos != nullptr) {
-                    size_t line_len = static_cast<size_t>(
-                        newline_pos - data_copy.data()) + 1;
-                    
-                    // 提取行数据
-                    std::string result;
-                    for (size_t i = 0; i < line_len; ++i) {
-                        byte_t c = data_copy[i];
-                        if (c != '\r' && c != '\n') {
-                            result.push_back(static_cast<char>(c));
-                        }
+            const_byte_span_t data = m_rx_buffer.linearize();
+            if (!data.empty()) {
+                size_t terminator_len = 0;
+                const size_t line_end = eoi ? std::string::npos
+                                            : _find_line_end(data, 0, terminator_len);
+                const bool complete = line_end != std::string::npos;
+                size_t chunk_len = complete ? line_end : data.size();
+                if (!complete && m_config.read_terminator == line_terminator_t::crlf &&
+                    chunk_len > 0 && data[chunk_len - 1] == '\r') {
+                    --chunk_len;   // 可能是 "\r\n" 的前半部分，留到下次判断
+                }
+
+                if (chunk_len > 0 && !chunk_error) {
+                    auto chunk_result = on_chunk(reinterpret_cast<const char*>(data.data()),
+                                                 chunk_len);
+                    if (!chunk_result) {
+                        chunk_error = chunk_result.error();
                     }
-                    
-                    buffer.consume(line_len);
-                    return make_ok(std::move(result));
                 }
-            }
+                total += chunk_len;
 
-            // 读取更多数据
-            byte_span_t temp_span(temp.data(), temp.size());
-            auto read_result = m_transport->read(temp_span, timeout_ms);
-            if (!read_result) {
-                return make_unexpected(read_result.error());
+                if (complete) {
+                    m_rx_buffer.consume(chunk_len + terminator_len);
+                    if (chunk_error) {
+                        return make_unexpected(*chunk_error);
+                    }
+                    return total;
+                }
+                m_rx_buffer.consume(chunk_len);
+                if (eoi) {
+                    // 一次读取的数据即为完整消息
+                    if (chunk_error) {
+                        return make_unexpected(*chunk_error);
+                    }
+                    return total;
+                }
             }
 
-            size_t bytes_read = *read_result;
-            if (bytes_read == 0) {
-                return make_error<std::string>(error_code_t::timeout);
+            auto fill_result = _fill_rx_buffer(deadline);
+            if (!fill_result) {
+                return make_unexpected(chunk_error ? *chunk_error : fill_result.error());
             }
+        }
+    }
+
+    /**
+     * @brief 发送查询并分块读取文本响应
+     * @see read_chunked()
+     */
+    result_t<size_t> query_chunked(const std::string& command,
+                                   const text_chunk_callback_t& on_chunk,
+                                   milliseconds_t timeout_ms = 0) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        if (!is_connected()) {
+            return make_error<size_t>(error_code_t::not_connected);
+        }
 
-            buffer.write(temp.data(), bytes_read);
+        std::string cmd_with_newline = command;
+        if (cmd_with_newline.empty() || cmd_with_newline.back() != '\n') {
+            cmd_with_newline.push_back('\n');
+        }
 
-            // 防止缓冲区溢出
-            if (buffer.readable_size() > m_codec->max_frame_size()) {
-                return make_error<std::string>(error_code_t::frame_too_large);
-            }
+        auto write_result = write(cmd_with_newline);
+        if (!write_result) {
+            return make_unexpected(write_result.error());
         }
+
+        return read_chunked(on_chunk, timeout_ms);
     }
 
     /**
@@ -393,6 +979,7 @@ public:
      */
     result_t<std::string> query(const std::string& command,
                                 milliseconds_t timeout_ms = 0) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
         if (!is_connected()) {
             return make_error<std::string>(error_code_t::not_connected);
         }
@@ -401,9 +988,166 @@ public:
             timeout_ms = m_config.command_timeout;
         }
 
+        m_metrics.count_query();
+        execution_span_scope_t span(m_observers.sample(), span_kind_t::query, tag_t(), 0);
+        _timing_scope_t timing(*this, m_config.collect_metrics);
+        _span_binding_t span_binding(m_span, span.get());
+        const metrics_clock_t::time_point started = timing.now();
+
         // 发送命令（确保以换行符结尾）
-        std::string cmd_with_newline = command;
-        if (cmd_with_newline.empty() || cmd_with_newline.back() != '\n') {
+        if (execution_span_t* traced = span.get()) {
+            traced->attempt = 1;
+            traced->bytes_sent = command.size() + (!command.empty() && command.back() == '\n' ? 0 : 1);
+        }
+        auto write_result = _write_line(command);
+        if (!write_result) {
+            m_metrics.count_failure();
+            return span.fail(write_result.error());
+        }
+        const metrics_clock_t::time_point written = timing.begin_read();
+
+        // 读取响应
+        auto result = read(timeout_ms);
+        if (!result) {
+            m_metrics.count_failure();
+        } else if (m_config.collect_metrics) {
+            const metrics_clock_t::time_point done = metrics_clock_t::now();
+            m_metrics.record(execute_phase_t::write, started, written);
+            timing.record_read(written, done);
+            m_metrics.record(execute_phase_t::total, started, done);
+        }
+        return span.finish(std::move(result));
+    }
+
+    /**
+     * @brief 查询（响应文本分配在事务内存区中）
+     * @param command 命令文本（不需要终止符）
+     * @param scope 事务作用域，返回的文本不能存活到作用域结束之后
+     * @param timeout_ms 超时时间
+     * @return 成功返回响应文本，失败返回错误
+     *
+     * 命令和响应都不经过堆分配：命令与终止符以两个片段发送，
+     * 响应文本从内存区分配，作用域结束时一并回收。
+     */
+    result_t<arena_string_t> query(const std::string& command,
+                                   transaction_scope_t& scope,
+                                   milliseconds_t timeout_ms = 0) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        if (!is_connected()) {
+            return make_error<arena_string_t>(error_code_t::not_connected);
+        }
+
+        auto write_result = _write_line(command);
+        if (!write_result) {
+            return make_unexpected(write_result.error());
+        }
+        return read(scope, timeout_ms);
+    }
+
+    // ========================================================================
+    // 便捷接口 - 二进制块（IEEE 488.2 定长块 #<n><length><bytes>）
+    // ========================================================================
+
+    /**
+     * @brief 块目标缓冲区分配器
+     *
+     * 读到块头后以数据长度调用，返回用于接收数据的缓冲区（大小不小于长度）。
+     */
+    using block_allocator_t = std::function<byte_span_t(size_t length)>;
+
+    /**
+     * @brief 读取一个定长二进制块
+     * @param allocate 目标缓冲区分配器
+     * @param timeout_ms 超时时间
+     * @return 成功返回块数据长度，失败返回错误
+     *
+     * 数据直接读入分配器返回的缓冲区（接收缓冲区中已有的部分复制一次），
+     * 然后按 block_terminator 配置读掉结尾的 "\n" / "\r\n"。
+     * 缓冲区不足时仍会读完并丢弃整个块以保持数据流同步，返回 invalid_size。
+     * 块头声明的长度超过 device_config_t::max_block_size 时不分配、不等待，
+     * 清空接收缓冲区并返回 frame_too_large。数据不经过接收缓冲区，长度不受 max_frame_size 限制。
+     *
+     * @code
+     * std::vector<double> trace;
+     * device.write("CALC:DATA? FDAT");
+     * device.read_binary_block([&](size_t len) {
+     *     trace.resize(len / sizeof(double));
+     *     return byte_span_t(reinterpret_cast<byte_t*>(trace.data()), len);
+     * });
+     * @endcode
+     */
+    result_t<size_t> read_binary_block(const block_allocator_t& allocate,
+                                       milliseconds_t timeout_ms = 0) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        if (!is_connected()) {
+            return make_error<size_t>(error_code_t::not_connected);
+        }
+
+        if (timeout_ms == 0) {
+            timeout_ms = m_config.command_timeout;
+        }
+
+        wait_all();
+        const deadline_t deadline = deadline_t::after(timeout_ms);
+
+        auto length_result = _read_block_header(deadline);
+        if (!length_result) {
+            return length_result;
+        }
+        const size_t length = *length_result;
+
+        byte_span_t target = allocate ? allocate(length) : byte_span_t();
+        const bool fits = target.size() >= length;
+
+        auto payload_result = _read_block_payload(fits ? target.data() : nullptr,
+                                                  length, deadline);
+        if (!payload_result) {
+            return make_unexpected(payload_result.error());
+        }
+
+        if (m_config.block_terminator) {
+            _consume_block_terminator(deadline);
+        }
+
+        if (!fits) {
+            return make_error<size_t>(error_code_t::invalid_size,
+                                      "Block destination buffer too small");
+        }
+        return length;
+    }
+
+    /**
+     * @brief 读取一个定长二进制块到新分配的字节数组
+     */
+    result_t<bytes_t> read_binary_block(milliseconds_t timeout_ms = 0) {
+        bytes_t data;
+        auto result = read_binary_block([&data](size_t length) {
+            data.resize(length);
+            return byte_span_t(data.data(), data.size());
+        }, timeout_ms);
+        if (!result) {
+            return make_unexpected(result.error());
+        }
+        return make_ok(std::move(data));
+    }
+
+    /**
+     * @brief 发送查询并读取定长二进制块响应
+     * @param command 命令文本（不需要终止符）
+     * @param allocate 目标缓冲区分配器
+     * @param timeout_ms 超时时间
+     * @return 成功返回块数据长度，失败返回错误
+     */
+    result_t<size_t> query_binary_block(const std::string& command,
+                                        const block_allocator_t& allocate,
+                                        milliseconds_t timeout_ms = 0) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        if (!is_connected()) {
+            return make_error<size_t>(error_code_t::not_connected);
+        }
+
+        std::string cmd_with_newline = command;
+        if (cmd_with_newline.empty() || cmd_with_newline.back() != '\n') {
             cmd_with_newline.push_back('\n');
         }
 
@@ -412,64 +1156,699 @@ public:
             return make_unexpected(write_result.error());
         }
 
-        // 读取响应
-        return read(timeout_ms);
+        return read_binary_block(allocate, timeout_ms);
     }
 
 protected:
+    /**
+     * @brief 执行命令（私有实现）
+     */
+    result_t<response_t> _execute(const command_t& cmd, milliseconds_t timeout_ms,
+                                  const cancellation_token_t* token) {
+        m_metrics.count_execution();
+        const bool timed = m_config.collect_metrics;
+        const metrics_clock_t::time_point started = timed ? metrics_clock_t::now()
+                                                          : metrics_clock_t::time_point();
+        const deadline_t deadline = deadline_t::after(timeout_ms);
+        // 在加锁前等待：后台重连线程每次尝试都需要设备锁
+        _await_background_reconnect(deadline);
+
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        _cancel_scope_t cancel_scope(m_cancel, token);
+        execution_span_scope_t span(m_observers.sample(), span_kind_t::execute,
+                                    cmd.tag(), cmd.function_code());
+        if (!is_connected()) {
+            return span.finish(_not_connected_error());
+        }
+
+        // 先完成在途的流水线请求，保证同步响应不会被错配
+        wait_all();
+        if (!is_connected()) {
+            return span.fail(error_t(error_code_t::not_connected, "Device not connected"));
+        }
+
+        _timing_scope_t timing(*this, timed);
+        _span_binding_t span_binding(m_span, span.get());
+
+        // 优先分段编码：负载直接引用命令数据，通过 writev 发送
+        const metrics_clock_t::time_point encode_start = timed ? metrics_clock_t::now()
+                                                               : metrics_clock_t::time_point();
+        frame_parts_t parts;
+        const_byte_span_t pieces[3];
+        size_t piece_count = 0;
+
+        auto parts_result = codec_ops_t::encode_parts(*m_codec, cmd, parts);
+        if (parts_result) {
+            pieces[0] = parts.header.as_span();
+            pieces[1] = parts.payload;
+            pieces[2] = parts.trailer.as_span();
+            piece_count = 3;
+        } else if (parts_result.error().code() == error_code_t::not_supported) {
+            auto encode_result = _encode_to_tx(cmd, 0);
+            if (!encode_result) {
+                return span.fail(encode_result.error());
+            }
+            pieces[0] = const_byte_span_t(m_tx_buffer.data(), *encode_result);
+            piece_count = 1;
+        } else {
+            return span.fail(parts_result.error());
+        }
+        if (timed) {
+            m_metrics.record(execute_phase_t::encode, encode_start, metrics_clock_t::now());
+        }
+
+        const span_t<const const_byte_span_t> frame_pieces(pieces, piece_count);
+
+        const uint8_t max_attempts = std::max<uint8_t>(1, m_config.max_retries);
+        error_t last_error{error_code_t::ok};
+
+        for (uint8_t attempt = 0; attempt < max_attempts; ++attempt) {
+            if (attempt > 0) {
+                // 重发前丢弃上一次尝试残留的半帧，避免与新响应拼接
+                m_rx_buffer.clear();
+                m_metrics.count_retry();
+            }
+
+            if (execution_span_t* traced = span.get()) {
+                traced->attempt = static_cast<uint8_t>(attempt + 1);
+                traced->bytes_sent = 0;
+                for (size_t i = 0; i < piece_count; ++i) {
+                    traced->bytes_sent += pieces[i].size();
+                }
+            }
+
+            // 每次传输调用只拿到截止时间前剩余的时间
+            const metrics_clock_t::time_point write_start = timing.now();
+            auto write_result = _write_pieces(frame_pieces, deadline);
+            if (!write_result) {
+                last_error = write_result.error();
+            } else {
+                const metrics_clock_t::time_point written = timing.begin_read();
+                auto read_result = _read_response(deadline, /*handle_error_on_fail=*/false);
+                if (read_result) {
+                    if (timed) {
+                        const metrics_clock_t::time_point done = metrics_clock_t::now();
+                        m_metrics.record(execute_phase_t::write, write_start, written);
+                        timing.record_read(written, done);
+                        m_metrics.record(execute_phase_t::total, started, done);
+                        m_metrics.record_function(cmd.function_code(),
+                            device_metrics_recorder_t::elapsed_ns(started, done));
+                    }
+                    return span.finish(std::move(read_result));
+                }
+                last_error = read_result.error();
+            }
+
+            const bool has_more = (static_cast<uint8_t>(attempt + 1)) < max_attempts;
+            if (!has_more || _is_cancelled(last_error)) {
+                break;
+            }
+            const metrics_clock_t::time_point wait_start = timing.now();
+            const bool resume = _wait_retry_delay(deadline);
+            if (timed) {
+                m_metrics.record(execute_phase_t::retry_wait, wait_start, metrics_clock_t::now());
+            }
+            if (!resume) {
+                break;
+            }
+        }
+
+        m_metrics.count_failure();
+
+        if (_is_cancelled(last_error)) {
+            m_rx_buffer.clear();
+            m_transport->flush_read();
+            return span.fail(last_error);
+        }
+        _handle_error(last_error);
+        return span.fail(last_error);
+    }
+
+
+    /**
+     * @brief 在 data[from, size) 中查找行终止符
+     * @param terminator_len [out] 终止符长度
+     * @return 行内容长度（终止符起始位置），未找到返回 std::string::npos
+     *
+     * 只查找 from 之后的新数据；"\r\n" 跨越 from 时同样能识别。
+     */
+    size_t _find_line_end(const_byte_span_t data, size_t from, size_t& terminator_len) const {
+        while (from < data.size()) {
+            auto* newline_pos = static_cast<const byte_t*>(
+                memchr(data.data() + from, '\n', data.size() - from));
+            if (newline_pos == nullptr) {
+                return std::string::npos;
+            }
+            const size_t pos = static_cast<size_t>(newline_pos - data.data());
+            if (m_config.read_terminator != line_terminator_t::crlf) {
+                terminator_len = 1;
+                return pos;
+            }
+            if (pos > 0 && data[pos - 1] == '\r') {
+                terminator_len = 2;
+                return pos - 1;
+            }
+            from = pos + 1;   // 单独的 '\n' 属于行内容
+        }
+        return std::string::npos;
+    }
+
+    /**
+     * @brief 解析块头 #<n><length>，成功后块头从接收缓冲区移除
+     * @return 成功返回数据长度；长度超过 max_block_size 时返回 frame_too_large
+     */
+    result_t<size_t> _read_block_header(const deadline_t& deadline) {
+        while (true) {
+            const_byte_span_t data = m_rx_buffer.linearize();
+            if (data.size() >= 2) {
+                if (data[0] != '#') {
+                    return make_error<size_t>(error_code_t::invalid_format,
+                                              "Expected binary block header");
+                }
+                if (data[1] < '0' || data[1] > '9') {
+                    return make_error<size_t>(error_code_t::invalid_format,
+                                              "Invalid block header digit count");
+                }
+                const size_t digits = static_cast<size_t>(data[1] - '0');
+                if (digits == 0) {
+                    return make_error<size_t>(error_code_t::not_supported,
+                                              "Indefinite-length block not supported");
+                }
+                if (data.size() >= 2 + digits) {
+                    size_t length = 0;
+                    for (size_t i = 0; i < digits; ++i) {
+                        const byte_t c = data[2 + i];
+                        if (c < '0' || c > '9') {
+                            return make_error<size_t>(error_code_t::invalid_format,
+                                                      "Invalid block length");
+                        }
+                        length = length * 10 + static_cast<size_t>(c - '0');
+                    }
+                    if (length > m_config.max_block_size) {
+                        m_rx_buffer.clear();
+                        return make_error<size_t>(error_code_t::frame_too_large,
+                                                  "Block length exceeds max_block_size");
+                    }
+                    m_rx_buffer.consume(2 + digits);
+                    return length;
+                }
+            }
+
+            auto fill_result = _fill_rx_buffer(deadline);
+            if (!fill_result) {
+                return make_unexpected(fill_result.error());
+            }
+        }
+    }
+
+    /**
+     * @brief 读取 length 字节块数据到 dst（dst 为空时读取并丢弃）
+     *
+     * 先取接收缓冲区中已有的数据，其余直接从传输层读入 dst，不经过接收缓冲区。
+     */
+    result_t<void> _read_block_payload(byte_t* dst, size_t length,
+                                       const deadline_t& deadline) {
+        size_t received = 0;
+        while (received < length) {
+            if (!m_rx_buffer.empty()) {
+                const_byte_span_t data = m_rx_buffer.linearize();
+                const size_t n = std::min(data.size(), length - received);
+                if (dst) {
+                    std::memcpy(dst + received, data.data(), n);
+                }
+                m_rx_buffer.consume(n);
+                received += n;
+                continue;
+            }
+
+            if (dst) {
+                auto read_result = _read_transport(
+                    byte_span_t(dst + received, length - received), deadline);
+                if (!read_result) {
+                    return make_unexpected(read_result.error());
+                }
+                if (*read_result == 0) {
+                    return make_error_void(error_code_t::timeout, "Read timeout");
+                }
+                received += *read_result;
+            } else {
+                auto fill_result = _fill_rx_buffer(deadline);
+                if (!fill_result) {
+                    return make_unexpected(fill_result.error());
+                }
+            }
+        }
+        return make_ok();
+    }
+
+    /**
+     * @brief 读掉块之后的终止符（"\n" 或 "\r\n"），等待超时不视为错误
+     */
+    void _consume_block_terminator(const deadline_t& deadline) {
+        while (true) {
+            if (m_rx_buffer.empty() && !_fill_rx_buffer(deadline)) {
+                return;
+            }
+            const byte_t c = m_rx_buffer.linearize()[0];
+            if (c == '\r') {
+                m_rx_buffer.consume(1);
+                continue;
+            }
+            if (c == '\n') {
+                m_rx_buffer.consume(1);
+            }
+            return;
+        }
+    }
+
     /**
      * @brief 读取响应（私有实现）
      */
-    result_t<response_t> _read_response(milliseconds_t timeout_ms,
-                                        bool handle_error_on_fail = true) {
-        ring_buffer_t buffer(m_codec->max_frame_size());
-        bytes_t temp(1024);
-        bytes_t data_copy;  // 用于存储 peek 的数据
+    result_t<response_t> _read_response(const deadline_t& deadline,
+                                        bool handle_error_on_fail = true,
+                                        optional_t<uint32_t>* key_out = nullptr) {
+        // 已知的帧长度：大帧分多次到达时，缓冲区不足该长度前不再检查
+        size_t expected = 0;
 
-        // 循环读取直到获得完整帧
+        // 循环读取直到获得完整帧（上次调用遗留的字节会先被检查）
         while (true) {
-            // 检查是否有完整帧
-            size_t data_size = buffer.readable_size();
-            if (data_size > 0) {
-                data_copy.resize(data_size);
-                buffer.peek(data_copy.data(), data_size);
-                
-                const_byte_span_t data_span(data_copy.data(), data_size);
-                size_t frame_len = m_codec->frame_length(data_span);
+            if (m_rx_buffer.size() > 0 && m_rx_buffer.size() >= expected) {
+                // 直接在接收缓冲区上检查是否有完整帧
+                const_byte_span_t data_span = m_rx_buffer.linearize();
+                size_t data_size = data_span.size();
+                size_t frame_len = codec_ops_t::frame_length(*m_codec, data_span);
+                expected = frame_len > data_size ? frame_len : 0;
                 
                 if (frame_len > 0 && frame_len <= data_size) {
-                    // 解码响应
+                    if (key_out) {
+                        *key_out = codec_ops_t::correlation_key(*m_codec, data_span.first(frame_len));
+                    }
+
+                    _mark_frame_ready(frame_len);
+
+                    // 整帧复制一次到共享 slab，响应的数据和原始帧直接引用它
+                    byte_slice_t slab = m_rx_slabs.copy(data_span.first(frame_len));
                     size_t consumed = 0;
-                    const_byte_span_t frame_span(data_copy.data(), frame_len);
-                    auto decode_result = m_codec->decode(frame_span, consumed);
+                    auto decode_result = codec_ops_t::decode_slice(*m_codec, slab, consumed);
                     
-                    buffer.consume(consumed);
+                    // 解码失败且未消耗数据时丢弃整帧，防止坏帧滞留在持久缓冲区
+                    if (!decode_result && consumed == 0) {
+                        consumed = frame_len;
+                    }
+                    m_rx_buffer.consume(consumed);
+
+                    if (decode_result) {
+                        _mark_success();
+                        if (!m_config.retain_raw_frame) {
+                            decode_result->clear_raw_frame();
+                        }
+                    }
                     return decode_result;
                 }
+
+                if (frame_len == 0) {
+                    // 帧头无法识别时让编解码器跳过帧前的无效数据
+                    size_t skipped = 0;
+                    auto resync_result = codec_ops_t::decode(*m_codec, data_span, skipped);
+                    if (!resync_result && skipped > 0 &&
+                        resync_result.error().code() != error_code_t::incomplete_frame) {
+                        VDL_LOG_DEBUG("Discarding %u bytes before frame start",
+                                      static_cast<unsigned>(skipped));
+                        m_rx_buffer.consume(skipped);
+                        continue;
+                    }
+                }
+            }
+
+            // 缓冲区已满仍没有完整帧
+            if (m_rx_buffer.full()) {
+                m_rx_buffer.clear();
+                return make_error<response_t>(error_code_t::frame_too_large, 
+                                              "Frame exceeds maximum size");
             }
 
             // 读取更多数据
-            byte_span_t temp_span(temp.data(), temp.size());
-            auto read_result = m_transport->read(temp_span, timeout_ms);
-            if (!read_result) {
+            auto fill_result = _fill_rx_buffer(deadline);
+            if (!fill_result) {
                 if (handle_error_on_fail) {
-                    _handle_error(read_result.error());
+                    _handle_error(fill_result.error());
                 }
-                return make_unexpected(read_result.error());
+                return make_unexpected(fill_result.error());
+            }
+        }
+    }
+
+    /**
+     * @brief 记录一次成功 I/O 的时间
+     */
+    void _mark_success() {
+        m_last_success.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                             std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 从传输层读取一次数据并追加到接收缓冲区
+     * @return 成功返回本次读取的字节数，超时、取消或失败返回错误
+     */
+    result_t<size_t> _fill_rx_buffer(const deadline_t& deadline) {
+        // 直接读入接收缓冲区的空闲空间，避免中转复制
+        byte_span_t space = m_rx_buffer.write_span();
+        auto read_result = _read_transport(space, deadline);
+        if (!read_result) {
+            return read_result;
+        }
+
+        size_t bytes_read = *read_result;
+        if (bytes_read == 0) {
+            return make_error<size_t>(error_code_t::timeout, "Read timeout");
+        }
+
+        m_rx_buffer.commit_write(bytes_read);
+        if (m_timing && !m_timing->has_first_byte) {
+            m_timing->first_byte = metrics_clock_t::now();
+            m_timing->has_first_byte = true;
+        }
+        return bytes_read;
+    }
+
+    /**
+     * @brief 在截止时间内从传输层读取一次
+     *
+     * 传输层只拿到剩余时间；持有取消令牌时每次最多等待 cancel_poll_interval，
+     * 分段之间检查令牌。
+     */
+    result_t<size_t> _read_transport(byte_span_t space, const deadline_t& deadline) {
+        while (true) {
+            if (m_cancel && m_cancel->cancelled()) {
+                return make_error<size_t>(error_code_t::operation_cancelled,
+                                          "Operation cancelled");
+            }
+            const milliseconds_t left = deadline.remaining_ms();
+            if (left == 0) {
+                return make_error<size_t>(error_code_t::timeout, "Read timeout");
             }
+            const milliseconds_t slice = m_cancel
+                ? deadline.remaining_ms(m_config.cancel_poll_interval) : left;
 
-            size_t bytes_read = *read_result;
-            if (bytes_read == 0) {
-                return make_error<response_t>(error_code_t::timeout, "Read timeout");
+            auto read_result = transport_ops_t::read(*m_transport, space, slice);
+            if (!read_result && slice < left &&
+                read_result.error().code() == error_code_t::timeout) {
+                continue;   // 分段等待到期，检查取消令牌后继续
             }
+            return read_result;
+        }
+    }
+
+    /**
+     * @brief 读取一条文本响应（read() 的实现，string_type 决定结果文本的分配方式）
+     */
+    template <typename string_type>
+    result_t<string_type> _read_text(milliseconds_t timeout_ms,
+                                     const typename string_type::allocator_type& allocator) {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        if (!is_connected()) {
+            return make_error<string_type>(error_code_t::not_connected);
+        }
 
-            buffer.write(temp.data(), bytes_read);
+        if (timeout_ms == 0) {
+            timeout_ms = m_config.command_timeout;
+        }
 
-            // 防止缓冲区溢出
-            if (buffer.readable_size() > m_codec->max_frame_size()) {
-                return make_error<response_t>(error_code_t::frame_too_large, 
-                                              "Frame exceeds maximum size");
+        wait_all();
+        const deadline_t deadline = deadline_t::after(timeout_ms);
+
+        // 无终止符：一次读取的数据即为完整消息
+        if (m_config.read_terminator == line_terminator_t::eoi) {
+            if (m_rx_buffer.empty()) {
+                auto fill_result = _fill_rx_buffer(deadline);
+                if (!fill_result) {
+                    return make_unexpected(fill_result.error());
+                }
             }
+            const_byte_span_t data = m_rx_buffer.linearize();
+            _mark_frame_ready(data.size());
+            string_type result(reinterpret_cast<const char*>(data.data()), data.size(), allocator);
+            m_rx_buffer.consume(data.size());
+            _mark_success();
+            return make_ok(std::move(result));
+        }
+
+        // 读取数据直到看到终止符或超时（终止符之后的数据保留在接收缓冲区中）
+        size_t scanned = 0;   // 已确认不含终止符的前缀长度，新数据到达后只查找新增部分
+        while (true) {
+            const_byte_span_t data = m_rx_buffer.linearize();
+            if (!data.empty()) {
+                size_t terminator_len = 0;
+                const size_t line_end = _find_line_end(data, scanned, terminator_len);
+                if (line_end != std::string::npos) {
+                    _mark_frame_ready(line_end + terminator_len);
+
+                    // 一次性拷贝行数据
+                    string_type result(reinterpret_cast<const char*>(data.data()), line_end, allocator);
+                    if (m_config.read_terminator == line_terminator_t::lf) {
+                        result.erase(std::remove(result.begin(), result.end(), '\r'),
+                                     result.end());
+                    }
+
+                    m_rx_buffer.consume(line_end + terminator_len);
+                    _mark_success();
+                    return make_ok(std::move(result));
+                }
+                scanned = data.size();
+
+                // 缓冲区已满仍无终止符，说明行超过最大长度
+                if (m_rx_buffer.full()) {
+                    m_rx_buffer.clear();
+                    return make_error<string_type>(error_code_t::frame_too_large);
+                }
+            }
+
+            // 读取更多数据
+            auto fill_result = _fill_rx_buffer(deadline);
+            if (!fill_result) {
+                return make_unexpected(fill_result.error());
+            }
+        }
+    }
+
+    /**
+     * @brief 发送一行命令（命令未以换行符结尾时补一个，不拷贝命令文本）
+     */
+    result_t<void> _write_line(const std::string& command) {
+        static const byte_t newline = '\n';
+        const bool terminated = !command.empty() && command.back() == '\n';
+        const const_byte_span_t pieces[2] = {
+            const_byte_span_t(reinterpret_cast<const byte_t*>(command.data()), command.size()),
+            const_byte_span_t(&newline, terminated ? 0 : 1)
+        };
+        return transport_ops_t::writev_all(*m_transport, span_t<const const_byte_span_t>(pieces, 2),
+                                           m_config.command_timeout);
+    }
+
+    /**
+     * @brief 在截止时间内写出所有片段
+     */
+    result_t<void> _write_pieces(span_t<const const_byte_span_t> pieces,
+                                 const deadline_t& deadline) {
+        if (m_cancel && m_cancel->cancelled()) {
+            return make_error_void(error_code_t::operation_cancelled, "Operation cancelled");
+        }
+        const milliseconds_t left = deadline.remaining_ms();
+        if (left == 0) {
+            return make_error_void(error_code_t::timeout, "Write timeout");
+        }
+        return transport_ops_t::writev_all(*m_transport, pieces, left);
+    }
+
+    /**
+     * @brief 等待重试间隔
+     * @return 截止时间前仍有时间重试且未被取消时返回 true
+     */
+    bool _wait_retry_delay(const deadline_t& deadline) {
+        if (m_config.retry_delay <= 0) {
+            return !deadline.expired();
+        }
+        const deadline_t resume = deadline_t::after(m_config.retry_delay);
+        if (!deadline.is_never() && resume.at() >= deadline.at()) {
+            return false;
+        }
+        while (!resume.expired()) {
+            if (m_cancel && m_cancel->cancelled()) {
+                return false;
+            }
+            const milliseconds_t slice = m_cancel
+                ? resume.remaining_ms(m_config.cancel_poll_interval) : resume.remaining_ms();
+            std::this_thread::sleep_for(std::chrono::milliseconds(slice));
+        }
+        return !(m_cancel && m_cancel->cancelled());
+    }
+
+    bool _is_cancelled(const error_t& error) const {
+        return error.code() == error_code_t::operation_cancelled;
+    }
+
+    /**
+     * @brief 在作用域内安装取消令牌（嵌套调用未提供令牌时沿用外层令牌）
+     */
+    class _cancel_scope_t : private ::vdl::noncopyable_t {
+    public:
+        _cancel_scope_t(const cancellation_token_t*& slot, const cancellation_token_t* token)
+            : m_slot(slot), m_previous(slot) {
+            if (token) {
+                m_slot = token;
+            }
+        }
+
+        ~_cancel_scope_t() {
+            m_slot = m_previous;
+        }
+
+    private:
+        const cancellation_token_t*& m_slot;
+        const cancellation_token_t* m_previous;
+    };
+
+    typedef device_metrics_recorder_t::metrics_clock_t metrics_clock_t;
+
+    /**
+     * @brief 一次读取过程中的阶段时间戳
+     */
+    struct _execute_timing_t {
+        metrics_clock_t::time_point first_byte;   ///< 第一批数据到达
+        metrics_clock_t::time_point frame_ready;  ///< 整帧（整行）到齐
+        bool has_first_byte = false;
+        bool has_frame = false;
+    };
+
+    /**
+     * @brief 在调用期间挂上阶段时间戳（collect_metrics 关闭时不读时钟）
+     */
+    class _timing_scope_t : private ::vdl::noncopyable_t {
+    public:
+        _timing_scope_t(basic_device_t& device, bool enabled)
+            : m_device(device), m_previous(device.m_timing), m_enabled(enabled) {
+            if (m_enabled) {
+                m_device.m_timing = &m_timing;
+            }
+        }
+
+        ~_timing_scope_t() {
+            if (m_enabled) {
+                m_device.m_timing = m_previous;
+            }
+        }
+
+        metrics_clock_t::time_point now() const {
+            return m_enabled ? metrics_clock_t::now() : metrics_clock_t::time_point();
+        }
+
+        /**
+         * @brief 请求已发出，开始等待响应
+         * @return 发送完成的时间
+         */
+        metrics_clock_t::time_point begin_read() {
+            m_timing = _execute_timing_t();
+            return now();
+        }
+
+        /**
+         * @brief 记录 first_byte/receive/decode
+         * @param written 发送完成的时间
+         * @param done 响应解码完成的时间
+         *
+         * 响应在发送前已到达接收缓冲区时，first_byte 记为 0。
+         */
+        void record_read(metrics_clock_t::time_point written, metrics_clock_t::time_point done) {
+            const metrics_clock_t::time_point first =
+                m_timing.has_first_byte ? m_timing.first_byte : written;
+            metrics_clock_t::time_point ready = m_timing.has_frame ? m_timing.frame_ready : done;
+            if (ready < first) {
+                ready = first;
+            }
+            device_metrics_recorder_t& metrics = m_device.m_metrics;
+            metrics.record(execute_phase_t::first_byte, written, first);
+            metrics.record(execute_phase_t::receive, first, ready);
+            metrics.record(execute_phase_t::decode, ready, done);
+        }
+
+    private:
+        basic_device_t& m_device;
+        _execute_timing_t* m_previous;
+        _execute_timing_t m_timing;
+        bool m_enabled;
+    };
+
+    /**
+     * @brief 记录整帧到齐的时间和帧长度
+     */
+    void _mark_frame_ready(size_t frame_len) {
+        if (m_timing && !m_timing->has_frame) {
+            m_timing->frame_ready = metrics_clock_t::now();
+            m_timing->has_frame = true;
+        }
+        if (m_span) {
+            m_span->bytes_received = frame_len;
+        }
+    }
+
+    /**
+     * @brief 在调用期间挂上当前区间，接收路径据此记录响应帧长度
+     */
+    class _span_binding_t : private ::vdl::noncopyable_t {
+    public:
+        _span_binding_t(execution_span_t*& slot, execution_span_t* span)
+            : m_slot(slot), m_previous(slot) {
+            if (span) {
+                m_slot = span;
+            }
+        }
+
+        ~_span_binding_t() {
+            m_slot = m_previous;
+        }
+
+    private:
+        execution_span_t*& m_slot;
+        execution_span_t* m_previous;
+    };
+
+    /**
+     * @brief 将命令编码到发送缓冲区的 offset 处
+     * @return 成功返回帧长度
+     * 
+     * 发送缓冲区只增不减，稳定运行后编码不再分配内存。
+     */
+    result_t<size_t> _encode_to_tx(const command_t& cmd, size_t offset) {
+        auto size_result = codec_ops_t::encoded_size(*m_codec, cmd);
+        if (!size_result) {
+            return size_result;
+        }
+        if (m_tx_buffer.size() < offset + *size_result) {
+            m_tx_buffer.resize(offset + *size_result);
+        }
+        return codec_ops_t::encode_into(*m_codec, cmd,
+                                        byte_span_t(m_tx_buffer.data() + offset, *size_result));
+    }
+
+    /**
+     * @brief 接收缓冲区容量（编解码器的最大帧长）
+     */
+    size_t _rx_capacity() const {
+        if (!m_codec) {
+            return k_default_rx_capacity;
+        }
+        return std::max<size_t>(1, codec_ops_t::max_frame_size(*m_codec));
+    }
+
+    /**
+     * @brief 清空接收缓冲区，并在编解码器最大帧长变化时重新分配
+     */
+    void _reset_rx_buffer() {
+        const size_t capacity = _rx_capacity();
+        if (m_rx_buffer.capacity() != capacity) {
+            m_rx_buffer = ring_buffer_t(capacity);
+        } else {
+            m_rx_buffer.clear();
         }
     }
 
@@ -491,7 +1870,225 @@ protected:
             return;
         }
 
+        if (m_config.background_reconnect) {
+            _start_background_reconnect(error);
+            return;
+        }
+
+        if (!m_breaker.allow()) {
+            _reject_reconnect(error);
+            return;
+        }
         _try_reconnect(error);
+        if (m_state == device_state_t::connected) {
+            m_breaker.record_success();
+        } else {
+            m_breaker.record_failure();
+        }
+    }
+
+    /**
+     * @brief 设备未连接时的错误；后台重连失败的设备在此按需再次发起重连
+     */
+    result_t<response_t> _not_connected_error() {
+        if (m_state == device_state_t::reconnecting) {
+            return make_error<response_t>(error_code_t::not_connected, "Device reconnecting");
+        }
+        if (m_state == device_state_t::error && m_config.auto_reconnect &&
+            m_config.background_reconnect) {
+            if (m_breaker.state() == circuit_state_t::open && !m_breaker.allow()) {
+                return make_error<response_t>(error_code_t::not_connected,
+                                              "Circuit breaker open");
+            }
+            _start_background_reconnect(error_t(error_code_t::not_connected,
+                                                "Reconnect on demand"), /*breaker_checked=*/true);
+        }
+        return make_error<response_t>(error_code_t::not_connected,
+                                      "Device not connected");
+    }
+
+    // ========================================================================
+    // 后台重连
+    // ========================================================================
+
+    /**
+     * @brief 熔断器拒绝重连：设备进入 error 状态，不占用调用线程
+     */
+    void _reject_reconnect(const error_t& trigger_error) {
+        VDL_LOG_WARN("Circuit breaker open, skipping reconnect: %s",
+                     trigger_error.message().c_str());
+        m_state = device_state_t::error;
+        _fail_pending(trigger_error);
+        _reset_rx_buffer();
+        if (m_transport->is_open()) {
+            m_transport->close();
+        }
+    }
+
+    /**
+     * @brief 启动后台重连线程（调用者持有 m_lock）
+     * @param breaker_checked 调用者已经从熔断器获得许可
+     */
+    void _start_background_reconnect(const error_t& trigger_error, bool breaker_checked = false) {
+        if (m_reconnect_running.load(std::memory_order_acquire)) {
+            return;
+        }
+        if (!breaker_checked && !m_breaker.allow()) {
+            _reject_reconnect(trigger_error);
+            return;
+        }
+
+        m_state = device_state_t::reconnecting;
+        _fail_pending(trigger_error);
+        _reset_rx_buffer();
+
+        // 上一轮的线程已经结束（running 已清除），回收后再启动新线程
+        if (m_reconnect_thread.joinable()) {
+            m_reconnect_thread.join();
+        }
+        m_reconnect_stop.store(false, std::memory_order_release);
+        m_reconnect_running.store(true, std::memory_order_release);
+        m_reconnect_thread = std::thread([this, trigger_error] {
+            _background_reconnect(trigger_error);
+        });
+    }
+
+    /**
+     * @brief 停止后台重连线程（调用者持有 m_lock）
+     *
+     * 线程只在不持锁时检查停止标志，因此在持锁时等待它退出是安全的。
+     */
+    void _stop_background_reconnect() {
+        if (!m_reconnect_thread.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> wake(m_reconnect_mutex);
+            m_reconnect_stop.store(true, std::memory_order_release);
+        }
+        m_reconnect_cv.notify_all();
+        if (m_reconnect_thread.get_id() == std::this_thread::get_id()) {
+            m_reconnect_thread.detach();   // 在重连回调中调用
+        } else {
+            m_reconnect_thread.join();
+        }
+        if (m_state == device_state_t::reconnecting) {
+            m_state = device_state_t::error;
+        }
+    }
+
+    /**
+     * @brief 后台重连线程主体：退避等待时不持有设备锁
+     */
+    void _background_reconnect(error_t trigger_error) {
+        const uint8_t max_attempts = std::max<uint8_t>(1, m_config.max_retries);
+        milliseconds_t current_delay = m_config.reconnect_delay;
+        bool connected = false;
+
+        VDL_LOG_INFO("Starting background reconnect (max %u attempts)", max_attempts);
+        if (!_lock_for_reconnect()) {
+            return _finish_background_reconnect();
+        }
+        _trigger_reconnect_callback(reconnect_event_t::started, 0, max_attempts, trigger_error);
+        m_lock.unlock();
+
+        for (uint8_t attempt = 0; attempt < max_attempts && !connected; ++attempt) {
+            if (!_lock_for_reconnect()) {
+                return _finish_background_reconnect();
+            }
+            _trigger_reconnect_callback(reconnect_event_t::attempting,
+                                        static_cast<uint8_t>(attempt + 1), max_attempts,
+                                        trigger_error);
+            if (m_transport->is_open()) {
+                m_transport->close();
+            }
+            auto open_result = m_transport->open();
+            if (open_result) {
+                connected = true;
+                m_state = device_state_t::connected;
+                m_connection_generation.fetch_add(1, std::memory_order_release);
+                m_breaker.record_success();
+                VDL_LOG_INFO("Background reconnect succeeded on attempt %u",
+                             static_cast<unsigned>(attempt + 1));
+                _trigger_reconnect_callback(reconnect_event_t::success,
+                                            static_cast<uint8_t>(attempt + 1), max_attempts,
+                                            error_t(error_code_t::ok, "Reconnected"));
+            }
+            m_lock.unlock();
+
+            const bool has_more = (static_cast<uint8_t>(attempt + 1)) < max_attempts;
+            if (connected || !has_more) {
+                break;
+            }
+
+            // 可中断的退避等待
+            if (current_delay > 0) {
+                std::unique_lock<std::mutex> wait(m_reconnect_mutex);
+                if (m_reconnect_cv.wait_for(wait, std::chrono::milliseconds(current_delay),
+                        [this] { return m_reconnect_stop.load(std::memory_order_acquire); })) {
+                    wait.unlock();
+                    return _finish_background_reconnect();
+                }
+            }
+            milliseconds_t next_delay = static_cast<milliseconds_t>(
+                static_cast<float>(current_delay) * m_config.backoff_multiplier);
+            current_delay = std::min(next_delay, m_config.max_reconnect_delay);
+        }
+
+        if (!connected) {
+            if (!_lock_for_reconnect()) {
+                return _finish_background_reconnect();
+            }
+            m_state = device_state_t::error;
+            m_breaker.record_failure();
+            VDL_LOG_ERROR("Background reconnect failed after %u attempts", max_attempts);
+            _trigger_reconnect_callback(reconnect_event_t::failed, max_attempts, max_attempts,
+                                        trigger_error);
+            m_lock.unlock();
+        }
+        _finish_background_reconnect();
+    }
+
+    /**
+     * @brief 后台线程获取设备锁；收到停止请求时放弃
+     */
+    bool _lock_for_reconnect() {
+        while (!m_lock.try_lock_for(k_reconnect_lock_poll_ms)) {
+            if (m_reconnect_stop.load(std::memory_order_acquire)) {
+                return false;
+            }
+        }
+        if (m_reconnect_stop.load(std::memory_order_acquire)) {
+            m_lock.unlock();
+            return false;
+        }
+        return true;
+    }
+
+    void _finish_background_reconnect() {
+        {
+            std::lock_guard<std::mutex> wake(m_reconnect_mutex);
+            m_reconnect_running.store(false, std::memory_order_release);
+        }
+        m_reconnect_cv.notify_all();
+    }
+
+    /**
+     * @brief 后台重连期间按 reconnect_wait 等待其结束（不持有设备锁）
+     */
+    void _await_background_reconnect(const deadline_t& deadline) {
+        if (m_config.reconnect_wait <= 0 ||
+            !m_reconnect_running.load(std::memory_order_acquire)) {
+            return;
+        }
+        deadline_t limit = deadline_t::after(m_config.reconnect_wait);
+        if (deadline.at() < limit.at()) {
+            limit = deadline;
+        }
+        std::unique_lock<std::mutex> wait(m_reconnect_mutex);
+        m_reconnect_cv.wait_until(wait, limit.at(), [this] {
+            return !m_reconnect_running.load(std::memory_order_acquire);
+        });
     }
 
     /**
@@ -529,6 +2126,8 @@ protected:
      */
     void _try_reconnect(const error_t& trigger_error) {
         m_state = device_state_t::reconnecting;
+        _fail_pending(trigger_error);
+        _reset_rx_buffer();
 
         const uint8_t max_attempts = std::max<uint8_t>(1, m_config.max_retries);
         milliseconds_t current_delay = m_config.reconnect_delay;
@@ -550,6 +2149,7 @@ protected:
             auto open_result = m_transport->open();
             if (open_result) {
                 m_state = device_state_t::connected;
+                m_connection_generation.fetch_add(1, std::memory_order_release);
                 VDL_LOG_INFO("Auto-reconnect succeeded on attempt %u", static_cast<unsigned>(attempt + 1));
                 _trigger_reconnect_callback(reconnect_event_t::success, static_cast<uint8_t>(attempt + 1), max_attempts, 
                                            error_t(error_code_t::ok, "Reconnected"));
@@ -581,6 +2181,85 @@ protected:
         _trigger_reconnect_callback(reconnect_event_t::failed, max_attempts, max_attempts, trigger_error);
     }
 
+    // ========================================================================
+    // 流水线内部实现
+    // ========================================================================
+
+    /**
+     * @brief 接收一个响应并分发给对应的在途请求
+     */
+    void _complete_next_pending() {
+        if (m_pending.empty()) {
+            return;
+        }
+
+        optional_t<uint32_t> key;
+        auto result = _read_response(deadline_t::after(m_pending.front()->timeout_ms),
+                                     /*handle_error_on_fail=*/false, &key);
+        if (!result) {
+            const error_t err = result.error();
+            if (err.category() == error_category_t::protocol) {
+                // 单帧解码错误只影响最早的请求
+                detail::async_state_ptr_t head = m_pending.front();
+                m_pending.pop_front();
+                head->complete(make_unexpected(err));
+                return;
+            }
+
+            // 超时或传输错误后无法确定流的对齐位置
+            _fail_pending(err);
+            _handle_error(err);
+            return;
+        }
+
+        detail::async_state_ptr_t target;
+        if (key) {
+            auto it = std::find_if(m_pending.begin(), m_pending.end(),
+                [&key](const detail::async_state_ptr_t& s) {
+                    return s->key && *s->key == *key;
+                });
+            if (it != m_pending.end()) {
+                target = *it;
+                m_pending.erase(it);
+            }
+        } else {
+            target = m_pending.front();
+            m_pending.pop_front();
+        }
+
+        if (!target) {
+            VDL_LOG_WARN("Dropping response with unmatched correlation key %u",
+                         static_cast<unsigned>(*key));
+            return;
+        }
+
+        target->complete(std::move(result));
+    }
+
+    /**
+     * @brief 以指定错误结束所有在途请求
+     */
+    void _fail_pending(const error_t& error) {
+        if (m_pending.empty()) {
+            return;
+        }
+        std::deque<detail::async_state_ptr_t> pending;
+        pending.swap(m_pending);
+        for (auto& state : pending) {
+            state->complete(make_unexpected(error));
+        }
+    }
+
+    /**
+     * @brief i_async_source_t 实现：驱动接收直到目标请求完成
+     */
+    void wait_async(detail::async_state_t& state) override {
+        std::lock_guard<fair_mutex_t> guard(m_lock);
+        while (!state.ready() && !m_pending.empty()) {
+            _complete_next_pending();
+        }
+    }
+
     /**
      * @brief 触发重连回调
      */
@@ -588,24 +2267,98 @@ protected:
                                      uint8_t attempt,
                                      uint8_t max_attempts,
                                      const error_t& error) {
-        if (m_reconnect_callback) {
-            try {
-                m_reconnect_callback(event, attempt, max_attempts, error);
-            } catch (const std::exception& e) {
-                VDL_LOG_WARN("Reconnect callback threw exception: %s", e.what());
+        switch (event) {
+        case reconnect_event_t::started:
+            m_metrics.begin_reconnect();
+            m_reconnect_observer = m_observers.shared();
+            if (m_reconnect_observer) {
+                m_reconnect_span = execution_span_t();
+                m_reconnect_span.kind = span_kind_t::reconnect;
+                begin_span(*m_reconnect_observer, m_reconnect_span);
             }
+            break;
+        case reconnect_event_t::attempting:
+            m_metrics.count_reconnect_attempt();
+            m_reconnect_span.attempt = attempt;
+            break;
+        case reconnect_event_t::success:
+        case reconnect_event_t::failed:
+            m_metrics.end_reconnect(event == reconnect_event_t::success);
+            if (m_reconnect_observer) {
+                m_reconnect_span.attempt = attempt;
+                m_reconnect_span.outcome = error;
+                if (event == reconnect_event_t::failed && error.code() == error_code_t::ok) {
+                    m_reconnect_span.outcome = error_t(error_code_t::not_connected,
+                                                       "Reconnect failed");
+                }
+                end_span(*m_reconnect_observer, m_reconnect_span);
+                m_reconnect_observer.reset();
+            }
+            break;
+        }
+
+        if (!m_reconnect_callback) {
+            return;
+        }
+        if (m_event_dispatcher) {
+            reconnect_callback_t callback = m_reconnect_callback;
+            m_event_dispatcher->post([callback, event, attempt, max_attempts, error] {
+                callback(event, attempt, max_attempts, error);
+            });
+            return;
+        }
+        try {
+            m_reconnect_callback(event, attempt, max_attempts, error);
+        } catch (const std::exception& e) {
+            VDL_LOG_WARN("Reconnect callback threw exception: %s", e.what());
         }
     }
 
 protected:
-    transport_ptr_t m_transport;
-    codec_ptr_t m_codec;
-    device_state_t m_state;
+    static constexpr size_t k_default_rx_capacity = 65536;  ///< 无编解码器时的接收缓冲区容量
+    static constexpr milliseconds_t k_reconnect_lock_poll_ms = 10;  ///< 后台重连线程检查停止请求的间隔
+
+    typedef detail::transport_ops_t<Transport> transport_ops_t;
+    typedef detail::codec_ops_t<Codec> codec_ops_t;
+
+    std::unique_ptr<Transport> m_transport;
+    std::unique_ptr<Codec> m_codec;
+    std::atomic<device_state_t> m_state;
+    std::atomic<uint64_t> m_connection_generation{0};  ///< 成功连接次数
+    std::atomic<std::chrono::steady_clock::rep> m_last_success{0};  ///< 最后一次成功 I/O（steady_clock 计数）
+    ring_buffer_t m_rx_buffer;   ///< 持久接收缓冲区，保留帧之后的剩余字节
+    bytes_t m_tx_buffer;         ///< 持久发送缓冲区，命令通过 encode_into 编码到其中
+    slab_cache_t m_rx_slabs;     ///< 解码用的整帧 slab，稳态下复用（受 m_lock 保护）
     device_info_t m_info;
     device_config_t m_config;
     reconnect_callback_t m_reconnect_callback;
+    event_dispatcher_t* m_event_dispatcher = nullptr;  ///< 重连回调的异步分发器（nullptr 表示同步执行）
+    std::deque<detail::async_state_ptr_t> m_pending;  ///< 在途的流水线请求（按发送顺序）
+    fair_mutex_t m_lock;         ///< 设备独占锁（可重入，所有 I/O 操作在其保护下进行）
+    const cancellation_token_t* m_cancel = nullptr;  ///< 当前调用的取消令牌（受 m_lock 保护）
+    device_metrics_recorder_t m_metrics;
+    _execute_timing_t* m_timing = nullptr;           ///< 当前调用的阶段时间戳（受 m_lock 保护）
+
+    // 追踪（受 m_lock 保护）
+    execution_observer_slot_t m_observers;
+    execution_span_t* m_span = nullptr;              ///< 当前调用的区间（未观察时为 nullptr）
+    execution_span_t m_reconnect_span;               ///< 进行中的重连区间
+    execution_observer_ptr_t m_reconnect_observer;   ///< 重连开始时的观察者（卸下后仍保持到区间结束）
+
+    // 后台重连（线程句柄受 m_lock 保护）
+    circuit_breaker_t m_breaker;
+    std::thread m_reconnect_thread;
+    std::atomic<bool> m_reconnect_running{false};
+    std::atomic<bool> m_reconnect_stop{false};
+    std::mutex m_reconnect_mutex;                ///< 退避等待和 reconnect_wait 的条件变量锁
+    std::condition_variable m_reconnect_cv;
 };
 
+/**
+ * @brief 类型擦除的设备实现（按接口调用传输层和编解码器）
+ */
+typedef basic_device_t<i_transport_t, i_codec_t> device_impl_t;
+
 }  // namespace vdl
 
 #endif  // VDL_DEVICE_DEVICE_IMPL_HPP
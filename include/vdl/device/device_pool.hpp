@@ -0,0 +1,495 @@
+/**
+ * @file device_pool.hpp
+ * @brief 设备连接池
+ *
+ * 按资源字符串缓存已连接的设备，以独占租约的方式借出，
+ * 避免每个任务都重新建立 TCP/VISA 会话。
+ */
+
+#ifndef VDL_DEVICE_DEVICE_POOL_HPP
+#define VDL_DEVICE_DEVICE_POOL_HPP
+
+#include "device.hpp"
+#include "../heartbeat/heartbeat_strategy.hpp"
+#include "../core/noncopyable.hpp"
+#include "../core/logging.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vdl {
+
+// ============================================================================
+// 连接池配置
+// ============================================================================
+
+/**
+ * @brief 设备工厂：根据资源字符串创建（未连接的）设备
+ */
+using device_factory_t = std::function<result_t<device_ptr_t>(const std::string& resource)>;
+
+/**
+ * @brief 健康检查策略工厂：为资源创建心跳策略，返回空表示只检查 is_connected()
+ */
+using health_check_factory_t = std::function<heartbeat_strategy_ptr_t(const std::string& resource)>;
+
+/**
+ * @brief 连接池配置
+ */
+struct device_pool_config_t {
+    size_t max_sessions_per_resource = 1;        ///< 每台仪器的最大并发会话数
+    milliseconds_t idle_timeout = 60000;         ///< 空闲超过该时间的会话被 evict_idle() 关闭，0 表示不淘汰
+    milliseconds_t health_check_interval = 5000; ///< 空闲超过该时间的会话借出前先做健康检查，0 表示每次都检查
+    milliseconds_t health_check_timeout = 500;   ///< 健康检查命令的超时
+    milliseconds_t acquire_timeout = 5000;       ///< 会话数已满时 acquire() 的默认等待时间
+};
+
+class device_pool_t;
+
+// ============================================================================
+// device_lease_t - 池化设备租约
+// ============================================================================
+
+/**
+ * @brief 池化设备租约，RAII 风格归还设备
+ *
+ * 与 device_guard_t 类似，但析构时不断开连接，而是把设备放回连接池。
+ * 持有期间该会话只属于当前租约。
+ *
+ * @code
+ * auto lease = pool.acquire("TCPIP::192.168.1.10::5025");
+ * if (!lease) {
+ *     return;
+ * }
+ * lease->device().execute(cmd);
+ * // 析构时归还，连接保持打开
+ * @endcode
+ */
+class device_lease_t : private noncopyable_t {
+public:
+    device_lease_t() = default;
+
+    /**
+     * @brief 移动构造函数
+     */
+    device_lease_t(device_lease_t&& other)
+        : m_pool(other.m_pool)
+        , m_resource(std::move(other.m_resource))
+        , m_device(std::move(other.m_device))
+        , m_broken(other.m_broken) {
+        other.m_pool = nullptr;
+    }
+
+    /**
+     * @brief 移动赋值
+     */
+    device_lease_t& operator=(device_lease_t&& other) {
+        if (this != &other) {
+            release();
+            m_pool = other.m_pool;
+            m_resource = std::move(other.m_resource);
+            m_device = std::move(other.m_device);
+            m_broken = other.m_broken;
+            other.m_pool = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 析构函数，自动归还设备
+     */
+    ~device_lease_t() {
+        release();
+    }
+
+    /**
+     * @brief 检查租约是否持有设备
+     */
+    bool valid() const {
+        return m_device != nullptr;
+    }
+
+    /**
+     * @brief 检查是否已连接
+     */
+    bool is_connected() const {
+        return m_device && m_device->is_connected();
+    }
+
+    /**
+     * @brief 获取设备引用（租约必须有效）
+     */
+    i_device_t& device() {
+        return *m_device;
+    }
+
+    const i_device_t& device() const {
+        return *m_device;
+    }
+
+    i_device_t* operator->() {
+        return m_device.get();
+    }
+
+    /**
+     * @brief 资源字符串
+     */
+    const std::string& resource() const {
+        return m_resource;
+    }
+
+    /**
+     * @brief 标记会话已损坏，归还时关闭而不是放回池中
+     *
+     * 仪器状态不确定（如多步操作中途失败）时调用。
+     */
+    void invalidate() {
+        m_broken = true;
+    }
+
+    /**
+     * @brief 提前归还设备
+     */
+    inline void release();
+
+private:
+    friend class device_pool_t;
+
+    device_lease_t(device_pool_t* pool, std::string resource, device_ptr_t device)
+        : m_pool(pool)
+        , m_resource(std::move(resource))
+        , m_device(std::move(device)) {
+    }
+
+    device_pool_t* m_pool = nullptr;
+    std::string m_resource;
+    device_ptr_t m_device;
+    bool m_broken = false;
+};
+
+// ============================================================================
+// device_pool_t - 设备连接池
+// ============================================================================
+
+/**
+ * @brief 设备连接池
+ *
+ * - 按资源字符串保存已连接的设备，归还后保持打开，下次借出无需重新连接
+ * - 空闲时间超过 health_check_interval 的会话在借出前用心跳策略检查，失败则关闭重建
+ * - 每台仪器的并发会话数受 max_sessions_per_resource 限制，超出时 acquire() 等待
+ * - evict_idle() 关闭空闲过久的会话（可由定时任务周期调用）
+ *
+ * 所有接口线程安全。连接池的生命周期必须长于它借出的租约。
+ *
+ * @code
+ * device_pool_t pool([](const std::string& resource) -> result_t<device_ptr_t> {
+ *     return device_ptr_t(new device_impl_t(make_transport(resource),
+ *                                           make_unique<ascii_codec_t>()));
+ * });
+ *
+ * auto lease = pool.acquire("TCPIP::192.168.1.10::5025");
+ * @endcode
+ */
+class device_pool_t : private noncopyable_t, private nonmovable_t {
+public:
+    /**
+     * @brief 构造函数
+     * @param factory 设备工厂
+     * @param health_check 健康检查策略工厂（可为空）
+     * @param config 连接池配置
+     */
+    explicit device_pool_t(device_factory_t factory,
+                           health_check_factory_t health_check = nullptr,
+                           const device_pool_config_t& config = device_pool_config_t())
+        : m_factory(std::move(factory))
+        , m_health_check(std::move(health_check))
+        , m_config(config) {
+    }
+
+    ~device_pool_t() {
+        clear();
+    }
+
+    // ========================================================================
+    // 租约
+    // ========================================================================
+
+    /**
+     * @brief 借出设备（使用默认等待时间）
+     */
+    result_t<device_lease_t> acquire(const std::string& resource) {
+        return acquire(resource, m_config.acquire_timeout);
+    }
+
+    /**
+     * @brief 借出设备
+     * @param resource 资源字符串
+     * @param timeout_ms 会话数已满时的最长等待时间
+     * @return 成功返回租约；等待超时返回 timeout，连接失败返回连接错误
+     */
+    result_t<device_lease_t> acquire(const std::string& resource, milliseconds_t timeout_ms) {
+        const auto deadline = clock_t::now() + std::chrono::milliseconds(timeout_ms);
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (true) {
+            entry_t& entry = m_entries[resource];
+
+            // 优先借出最近归还的会话（最可能仍然有效）
+            while (!entry.idle.empty()) {
+                session_t session = std::move(entry.idle.back());
+                entry.idle.pop_back();
+
+                const auto now = clock_t::now();
+                const bool needs_check = now - session.last_checked >=
+                    std::chrono::milliseconds(m_config.health_check_interval);
+                if (!needs_check) {
+                    return device_lease_t(this, resource, std::move(session.device));
+                }
+
+                lock.unlock();
+                const bool healthy = _check_health(resource, *session.device);
+                if (!healthy) {
+                    VDL_LOG_WARN("Pooled session for %s failed health check", resource.c_str());
+                    session.device->disconnect();
+                    session.device.reset();
+                }
+                lock.lock();
+
+                entry_t& current = m_entries[resource];
+                if (healthy) {
+                    return device_lease_t(this, resource, std::move(session.device));
+                }
+                --current.sessions;
+                m_cv.notify_all();
+            }
+
+            if (m_entries[resource].sessions < _max_sessions()) {
+                ++m_entries[resource].sessions;
+                lock.unlock();
+                auto created = _create(resource);
+                if (!created) {
+                    lock.lock();
+                    --m_entries[resource].sessions;
+                    m_cv.notify_all();
+                    return make_unexpected(created.error());
+                }
+                return device_lease_t(this, resource, std::move(*created));
+            }
+
+            if (m_cv.wait_until(lock, deadline) == std::cv_status::timeout &&
+                m_entries[resource].idle.empty() &&
+                m_entries[resource].sessions >= _max_sessions()) {
+                return make_error<device_lease_t>(error_code_t::timeout,
+                                                  "No pooled session available");
+            }
+        }
+    }
+
+    // ========================================================================
+    // 维护
+    // ========================================================================
+
+    /**
+     * @brief 关闭空闲超过 idle_timeout 的会话
+     * @return 关闭的会话数
+     */
+    size_t evict_idle() {
+        if (m_config.idle_timeout == 0) {
+            return 0;
+        }
+
+        std::vector<device_ptr_t> evicted;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto limit = clock_t::now() - std::chrono::milliseconds(m_config.idle_timeout);
+            for (auto& item : m_entries) {
+                entry_t& entry = item.second;
+                auto keep = entry.idle.begin();
+                for (auto it = entry.idle.begin(); it != entry.idle.end(); ++it) {
+                    if (it->last_used <= limit) {
+                        evicted.push_back(std::move(it->device));
+                        --entry.sessions;
+                    } else {
+                        *keep++ = std::move(*it);
+                    }
+                }
+                entry.idle.erase(keep, entry.idle.end());
+            }
+            if (!evicted.empty()) {
+                m_cv.notify_all();
+            }
+        }
+
+        // 断开连接可能较慢，在锁外进行
+        for (auto& device : evicted) {
+            device->disconnect();
+        }
+        return evicted.size();
+    }
+
+    /**
+     * @brief 关闭所有空闲会话（已借出的会话在归还后照常放回）
+     */
+    void clear() {
+        std::vector<device_ptr_t> closed;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& item : m_entries) {
+                for (auto& session : item.second.idle) {
+                    closed.push_back(std::move(session.device));
+                    --item.second.sessions;
+                }
+                item.second.idle.clear();
+            }
+            m_cv.notify_all();
+        }
+        for (auto& device : closed) {
+            device->disconnect();
+        }
+    }
+
+    // ========================================================================
+    // 状态
+    // ========================================================================
+
+    /**
+     * @brief 资源的空闲会话数
+     */
+    size_t idle_count(const std::string& resource) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(resource);
+        return it == m_entries.end() ? 0 : it->second.idle.size();
+    }
+
+    /**
+     * @brief 资源的会话总数（空闲 + 已借出 + 正在建立）
+     */
+    size_t session_count(const std::string& resource) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(resource);
+        return it == m_entries.end() ? 0 : it->second.sessions;
+    }
+
+    const device_pool_config_t& config() const {
+        return m_config;
+    }
+
+private:
+    friend class device_lease_t;
+
+    using clock_t = std::chrono::steady_clock;
+
+    struct session_t {
+        device_ptr_t device;
+        clock_t::time_point last_used;     ///< 最近一次归还时间
+        clock_t::time_point last_checked;  ///< 最近一次确认连接可用的时间
+    };
+
+    struct entry_t {
+        std::vector<session_t> idle;       ///< 空闲会话（末尾为最近归还）
+        size_t sessions = 0;               ///< 该资源的会话总数
+    };
+
+    size_t _max_sessions() const {
+        return m_config.max_sessions_per_resource > 0 ? m_config.max_sessions_per_resource : 1;
+    }
+
+    result_t<device_ptr_t> _create(const std::string& resource) {
+        if (!m_factory) {
+            return make_error<device_ptr_t>(error_code_t::config_error, "No device factory");
+        }
+        auto created = m_factory(resource);
+        if (!created) {
+            return created;
+        }
+        device_ptr_t device = std::move(*created);
+        if (!device) {
+            return make_error<device_ptr_t>(error_code_t::null_pointer,
+                                            "Device factory returned null");
+        }
+        if (!device->is_connected()) {
+            auto result = device->connect();
+            if (!result) {
+                return make_unexpected(result.error());
+            }
+        }
+        return device;
+    }
+
+    /**
+     * @brief 用心跳策略检查会话是否可用
+     */
+    bool _check_health(const std::string& resource, i_device_t& device) {
+        if (!device.is_connected()) {
+            return false;
+        }
+        if (!m_health_check) {
+            return true;
+        }
+        heartbeat_strategy_ptr_t strategy = m_health_check(resource);
+        if (!strategy) {
+            return true;
+        }
+        auto cmd = strategy->make_heartbeat_command();
+        if (!cmd) {
+            return false;
+        }
+        auto resp = device.execute(*cmd, m_config.health_check_timeout);
+        return resp && strategy->validate_response(*resp);
+    }
+
+    /**
+     * @brief 租约归还
+     */
+    void _release(const std::string& resource, device_ptr_t device, bool broken) {
+        const bool reusable = !broken && device->is_connected();
+        if (!reusable) {
+            device->disconnect();
+            device.reset();
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        entry_t& entry = m_entries[resource];
+        if (reusable) {
+            // 刚用过的会话视为已确认可用
+            const auto now = clock_t::now();
+            session_t session;
+            session.device = std::move(device);
+            session.last_used = now;
+            session.last_checked = now;
+            entry.idle.push_back(std::move(session));
+        } else {
+            --entry.sessions;
+        }
+        m_cv.notify_all();
+    }
+
+    device_factory_t m_factory;
+    health_check_factory_t m_health_check;
+    device_pool_config_t m_config;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::map<std::string, entry_t> m_entries;
+};
+
+inline void device_lease_t::release() {
+    if (m_pool && m_device) {
+        device_pool_t* pool = m_pool;
+        m_pool = nullptr;
+        pool->_release(m_resource, std::move(m_device), m_broken);
+    }
+    m_pool = nullptr;
+    m_device.reset();
+}
+
+}  // namespace vdl
+
+#endif  // VDL_DEVICE_DEVICE_POOL_HPP
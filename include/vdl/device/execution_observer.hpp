@@ -0,0 +1,259 @@
+/**
+ * @file execution_observer.hpp
+ * @brief 执行观察者（追踪钩子）
+ *
+ * 设备在 execute()/query()、重连和心跳的开始与结束时回调观察者，
+ * 回调参数带命令标签、功能码、字节数、尝试次数和结果，
+ * 可以据此生成 OpenTelemetry 风格的 span。
+ * 未挂接观察者时每次调用只多一次可预测的指针判断。
+ */
+
+#ifndef VDL_DEVICE_EXECUTION_OBSERVER_HPP
+#define VDL_DEVICE_EXECUTION_OBSERVER_HPP
+
+#include "../core/types.hpp"
+#include "../core/error.hpp"
+#include "../core/logging.hpp"
+#include "../core/noncopyable.hpp"
+#include "../core/tag.hpp"
+
+#include <chrono>
+#include <exception>
+#include <memory>
+
+namespace vdl {
+
+// ============================================================================
+// execution_span_t - 追踪区间
+// ============================================================================
+
+/**
+ * @brief 区间类型
+ */
+enum class span_kind_t : uint8_t {
+    execute = 0,     ///< execute()
+    query = 1,       ///< query()（文本查询）
+    reconnect = 2,   ///< 一次重连过程（从开始到成功或放弃）
+    heartbeat = 3    ///< 一次心跳（内层的 execute 另有区间）
+};
+
+inline const char* span_kind_name(span_kind_t kind) {
+    switch (kind) {
+    case span_kind_t::execute: return "execute";
+    case span_kind_t::query: return "query";
+    case span_kind_t::reconnect: return "reconnect";
+    case span_kind_t::heartbeat: return "heartbeat";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief 追踪区间
+ *
+ * on_span_begin() 和 on_span_end() 收到的是同一个对象，
+ * 观察者可以在 user_data 中保存自己的上下文（如 span 句柄）。
+ * 同一线程上的区间严格嵌套（心跳包含 execute，execute 可能包含重连），
+ * 需要父子关系时观察者可以用线程局部的栈维护。
+ */
+struct execution_span_t {
+    typedef std::chrono::steady_clock clock_type;
+
+    span_kind_t kind = span_kind_t::execute;
+    tag_t tag;                         ///< 命令标签（command_t::tag()）
+    uint8_t function_code = 0;         ///< 命令功能码（query/reconnect 为 0）
+    size_t bytes_sent = 0;             ///< 最后一次尝试发送的字节数
+    size_t bytes_received = 0;         ///< 返回给调用方的响应帧字节数
+    uint8_t attempt = 0;               ///< 已进行的尝试次数（从 1 开始）
+    error_t outcome{error_code_t::unknown};  ///< 结果（成功为 ok）
+    clock_type::time_point start;      ///< 开始时间
+    clock_type::duration duration{0};  ///< 持续时间（on_span_end 时有效）
+    void* user_data = nullptr;         ///< 观察者自用，设备不读写
+
+    bool ok() const {
+        return outcome.code() == error_code_t::ok;
+    }
+};
+
+// ============================================================================
+// i_execution_observer_t - 观察者接口
+// ============================================================================
+
+/**
+ * @brief 执行观察者接口
+ *
+ * 回调在执行调用的线程上同步进行，且持有设备锁，应尽快返回；
+ * 回调抛出的异常被记录并忽略。
+ *
+ * @code
+ * class otel_observer_t : public i_execution_observer_t {
+ * public:
+ *     void on_span_begin(execution_span_t& span) override {
+ *         span.user_data = tracer.start(span_kind_name(span.kind), span.tag.c_str());
+ *     }
+ *     void on_span_end(const execution_span_t& span) override {
+ *         tracer.end(span.user_data, span.ok(), span.attempt, span.bytes_sent);
+ *     }
+ * };
+ *
+ * device.set_execution_observer(std::make_shared<otel_observer_t>(), 10);  // 每 10 次采样 1 次
+ * @endcode
+ */
+class i_execution_observer_t {
+public:
+    virtual ~i_execution_observer_t() = default;
+
+    /**
+     * @brief 区间开始
+     */
+    virtual void on_span_begin(execution_span_t& span) {
+        (void)span;
+    }
+
+    /**
+     * @brief 区间结束
+     */
+    virtual void on_span_end(const execution_span_t& span) = 0;
+};
+
+using execution_observer_ptr_t = std::shared_ptr<i_execution_observer_t>;
+
+/**
+ * @brief 开始区间：记录开始时间并回调 on_span_begin()
+ */
+inline void begin_span(i_execution_observer_t& observer, execution_span_t& span) {
+    span.start = execution_span_t::clock_type::now();
+    try {
+        observer.on_span_begin(span);
+    } catch (const std::exception& e) {
+        VDL_LOG_WARN("Execution observer threw exception: %s", e.what());
+    }
+}
+
+/**
+ * @brief 结束区间：计算持续时间并回调 on_span_end()
+ */
+inline void end_span(i_execution_observer_t& observer, execution_span_t& span) {
+    span.duration = execution_span_t::clock_type::now() - span.start;
+    try {
+        observer.on_span_end(span);
+    } catch (const std::exception& e) {
+        VDL_LOG_WARN("Execution observer threw exception: %s", e.what());
+    }
+}
+
+// ============================================================================
+// execution_observer_slot_t - 观察者挂接点
+// ============================================================================
+
+/**
+ * @brief 观察者挂接点（含采样）
+ *
+ * 非线程安全，由所属对象的锁保护。
+ */
+class execution_observer_slot_t {
+public:
+    /**
+     * @brief 挂接观察者
+     * @param observer 观察者（nullptr 表示卸下）
+     * @param sample_every 每 sample_every 次调用观察 1 次（0 视为 1）
+     */
+    void set(execution_observer_ptr_t observer, uint32_t sample_every = 1) {
+        m_observer = observer.get();
+        m_owner = std::move(observer);
+        m_sample_every = sample_every == 0 ? 1 : sample_every;
+        m_counter = 0;
+    }
+
+    i_execution_observer_t* get() const {
+        return m_observer;
+    }
+
+    const execution_observer_ptr_t& shared() const {
+        return m_owner;
+    }
+
+    /**
+     * @brief 按采样率取观察者
+     * @return 本次调用不观察时返回 nullptr
+     */
+    i_execution_observer_t* sample() {
+        if (m_observer == nullptr) {
+            return nullptr;
+        }
+        if (m_sample_every > 1 && m_counter++ % m_sample_every != 0) {
+            return nullptr;
+        }
+        return m_observer;
+    }
+
+private:
+    execution_observer_ptr_t m_owner;
+    i_execution_observer_t* m_observer = nullptr;
+    uint32_t m_sample_every = 1;
+    uint32_t m_counter = 0;
+};
+
+// ============================================================================
+// execution_span_scope_t - 区间作用域
+// ============================================================================
+
+/**
+ * @brief 区间作用域：构造时 on_span_begin，析构时 on_span_end
+ *
+ * 观察者为 nullptr 时不做任何事，get() 返回 nullptr。
+ */
+class execution_span_scope_t : private noncopyable_t {
+public:
+    execution_span_scope_t(i_execution_observer_t* observer, span_kind_t kind,
+                           const tag_t& tag, uint8_t function_code)
+        : m_observer(observer) {
+        if (m_observer) {
+            m_span.kind = kind;
+            m_span.tag = tag;
+            m_span.function_code = function_code;
+            begin_span(*m_observer, m_span);
+        }
+    }
+
+    ~execution_span_scope_t() {
+        if (m_observer) {
+            end_span(*m_observer, m_span);
+        }
+    }
+
+    /**
+     * @brief 区间对象（未观察时为 nullptr）
+     */
+    execution_span_t* get() {
+        return m_observer ? &m_span : nullptr;
+    }
+
+    /**
+     * @brief 记录结果并原样返回
+     */
+    template <typename T>
+    result_t<T> finish(result_t<T> result) {
+        if (m_observer) {
+            m_span.outcome = result ? error_t(error_code_t::ok) : result.error();
+        }
+        return result;
+    }
+
+    /**
+     * @brief 记录失败并返回对应的 unexpected
+     */
+    tl::unexpected<error_t> fail(const error_t& error) {
+        if (m_observer) {
+            m_span.outcome = error;
+        }
+        return make_unexpected(error);
+    }
+
+private:
+    i_execution_observer_t* m_observer;
+    execution_span_t m_span;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_DEVICE_EXECUTION_OBSERVER_HPP
@@ -0,0 +1,235 @@
+/**
+ * @file identity_cache.hpp
+ * @brief 设备身份缓存
+ *
+ * 启动时逐台 *IDN? 是连接耗时的主要部分，而同一资源地址上的仪器很少更换。
+ * 身份缓存按资源字符串保存 device_info_t 并持久化到文本文件，
+ * 设备组据此在连接后立即得到身份，再在后台校验。
+ *
+ * 文件格式：每行一台设备，字段以制表符分隔：
+ * @code
+ * resource	manufacturer	model	serial_number	firmware_version	name
+ * @endcode
+ */
+
+#ifndef VDL_DEVICE_IDENTITY_CACHE_HPP
+#define VDL_DEVICE_IDENTITY_CACHE_HPP
+
+#include "device.hpp"
+#include "../codec/ascii_codec.hpp"
+#include "../core/noncopyable.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace vdl {
+
+// ============================================================================
+// 身份查询
+// ============================================================================
+
+/**
+ * @brief 身份查询函数
+ * @param device 已连接的设备
+ * @param timeout_ms 超时时间（0 使用设备的 command_timeout）
+ */
+using identify_fn_t = std::function<result_t<device_info_t>(i_device_t& device,
+                                                            milliseconds_t timeout_ms)>;
+
+/**
+ * @brief 比较两份身份（不比较 name，name 由应用自行命名）
+ */
+inline bool same_identity(const device_info_t& a, const device_info_t& b) {
+    return a.manufacturer == b.manufacturer && a.model == b.model &&
+           a.serial_number == b.serial_number && a.firmware_version == b.firmware_version;
+}
+
+/**
+ * @brief 解析 *IDN? 响应（<制造商>,<型号>,<序列号>,<固件版本>）
+ */
+inline device_info_t parse_idn(const std::string& text) {
+    device_info_t info;
+    std::string* fields[] = {&info.manufacturer, &info.model, &info.serial_number,
+                             &info.firmware_version};
+    size_t field = 0;
+    size_t begin = 0;
+    while (field < 4 && begin <= text.size()) {
+        // 固件版本可能本身带逗号，最后一个字段取到行尾
+        size_t end = field == 3 ? std::string::npos : text.find(',', begin);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        size_t first = begin;
+        size_t last = end;
+        while (first < last && (text[first] == ' ' || text[first] == '\t')) {
+            ++first;
+        }
+        while (last > first && (text[last - 1] == ' ' || text[last - 1] == '\t' ||
+                                text[last - 1] == '\r' || text[last - 1] == '\n')) {
+            --last;
+        }
+        fields[field++]->assign(text, first, last - first);
+        begin = end + 1;
+    }
+    return info;
+}
+
+/**
+ * @brief 以 ASCII 编解码器发送 *IDN? 并解析
+ */
+inline result_t<device_info_t> scpi_identify(i_device_t& device, milliseconds_t timeout_ms) {
+    const command_t cmd = make_ascii_command("*IDN?");
+    auto response = timeout_ms > 0 ? device.execute(cmd, timeout_ms) : device.execute(cmd);
+    if (!response) {
+        return make_unexpected(response.error());
+    }
+    device_info_t info = parse_idn(response_text(*response));
+    if (info.manufacturer.empty() && info.model.empty()) {
+        return make_error<device_info_t>(error_code_t::protocol_error, "Empty *IDN? response");
+    }
+    return make_ok(std::move(info));
+}
+
+// ============================================================================
+// device_identity_cache_t - 身份缓存
+// ============================================================================
+
+/**
+ * @brief 按资源字符串保存的设备身份（线程安全）
+ *
+ * @code
+ * device_identity_cache_t cache;
+ * cache.load("/var/lib/station/identity.tsv");   // 文件不存在时为空缓存
+ *
+ * device_group_t rack(devices, pool);
+ * rack.set_identity_cache(&cache, scpi_identify);
+ * rack.connect_all(5000);
+ * rack.wait_identified(5000);
+ * cache.save("/var/lib/station/identity.tsv");
+ * @endcode
+ */
+class device_identity_cache_t : private noncopyable_t {
+public:
+    /**
+     * @brief 从文件加载（合并到现有条目）
+     * @return 成功返回读入的条目数；文件不存在返回 file_not_found
+     */
+    result_t<size_t> load(const std::string& path) {
+        std::ifstream file(path.c_str());
+        if (!file) {
+            return make_error<size_t>(error_code_t::file_not_found, "Identity cache: " + path);
+        }
+        size_t count = 0;
+        std::string line;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (std::getline(file, line)) {
+            std::string fields[6];
+            size_t field = 0;
+            size_t begin = 0;
+            while (field < 6) {
+                const size_t end = line.find('\t', begin);
+                fields[field++] = line.substr(begin, end == std::string::npos ? end : end - begin);
+                if (end == std::string::npos) {
+                    break;
+                }
+                begin = end + 1;
+            }
+            if (field < 5 || fields[0].empty()) {
+                continue;
+            }
+            device_info_t& info = m_entries[fields[0]];
+            info.manufacturer = fields[1];
+            info.model = fields[2];
+            info.serial_number = fields[3];
+            info.firmware_version = fields[4];
+            info.name = fields[5];
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief 保存到文件（先写临时文件再改名，中途失败不会损坏原文件）
+     */
+    result_t<void> save(const std::string& path) const {
+        const std::string temp = path + ".tmp";
+        {
+            std::ofstream file(temp.c_str(), std::ios::trunc);
+            if (!file) {
+                return make_error_void(error_code_t::file_access_denied,
+                                       "Identity cache: cannot write " + temp);
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& entry : m_entries) {
+                file << _field(entry.first) << '\t' << _field(entry.second.manufacturer) << '\t'
+                     << _field(entry.second.model) << '\t'
+                     << _field(entry.second.serial_number) << '\t'
+                     << _field(entry.second.firmware_version) << '\t'
+                     << _field(entry.second.name) << '\n';
+            }
+            file.flush();
+            if (!file) {
+                return make_error_void(error_code_t::io_error, "Identity cache: write failed");
+            }
+        }
+        if (std::rename(temp.c_str(), path.c_str()) != 0) {
+            std::remove(temp.c_str());
+            return make_error_void(error_code_t::io_error, "Identity cache: rename failed");
+        }
+        return make_ok();
+    }
+
+    optional_t<device_info_t> find(const std::string& resource) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(resource);
+        if (it == m_entries.end()) {
+            return tl::nullopt;
+        }
+        return it->second;
+    }
+
+    void store(const std::string& resource, const device_info_t& info) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries[resource] = info;
+    }
+
+    void erase(const std::string& resource) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.erase(resource);
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+private:
+    /**
+     * @brief 字段中的制表符和换行替换为空格
+     */
+    static std::string _field(const std::string& value) {
+        std::string result = value;
+        for (char& c : result) {
+            if (c == '\t' || c == '\n' || c == '\r') {
+                c = ' ';
+            }
+        }
+        return result;
+    }
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, device_info_t> m_entries;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_DEVICE_IDENTITY_CACHE_HPP
@@ -0,0 +1,526 @@
+/**
+ * @file read_planner.hpp
+ * @brief 寄存器读取合并规划器
+ *
+ * 把大量零散的 address/count 读取请求合并为尽量少的读命令，
+ * 执行后再把响应数据按原请求切分，减少每个轮询周期的往返次数。
+ */
+
+#ifndef VDL_DEVICE_READ_PLANNER_HPP
+#define VDL_DEVICE_READ_PLANNER_HPP
+
+#include "../core/types.hpp"
+#include "../core/error.hpp"
+#include "../protocol/command.hpp"
+#include "../protocol/response.hpp"
+#include "command_priority.hpp"
+#include "device_impl.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace vdl {
+
+// ============================================================================
+// read_limits_t - 功能码的读取限制
+// ============================================================================
+
+/**
+ * @brief 单个功能码的读取限制
+ */
+struct read_limits_t {
+    uint16_t max_count = 125;       ///< 单条命令最多读取的单元数
+    uint8_t unit_bits = 16;         ///< 每个单元的位数（1 表示按位打包，否则须为 8 的倍数）
+};
+
+/**
+ * @brief 读取执行方式
+ */
+enum class read_mode_t : uint8_t {
+    batch,      ///< 通过 execute_batch 一次写出、顺序读回
+    async,      ///< 通过 execute_async 流水线发送（按关联键匹配响应）
+    chunked     ///< 以 bulk 优先级逐条 execute，分页之间更高优先级的命令可以插入
+};
+
+// ============================================================================
+// read_plan_t - 合并后的读取计划
+// ============================================================================
+
+class read_plan_result_t;
+
+/**
+ * @brief 合并后的读取计划
+ *
+ * 由 read_planner_t::build() 生成。计划只依赖请求列表，
+ * 轮询场景下构建一次、每个周期重复执行。
+ */
+class read_plan_t {
+public:
+    /**
+     * @brief 请求在合并命令中的位置
+     */
+    struct slot_t {
+        size_t command = k_invalid;     ///< 所属命令序号（k_invalid 表示请求无效）
+        uint16_t offset = 0;            ///< 相对命令起始地址的单元偏移
+        uint16_t count = 0;             ///< 请求的单元数
+        uint8_t unit_bits = 16;
+    };
+
+    static constexpr size_t k_invalid = static_cast<size_t>(-1);
+
+    /**
+     * @brief 合并后的读取命令
+     */
+    const std::vector<command_t>& commands() const {
+        return m_commands;
+    }
+
+    /**
+     * @brief 各请求的位置（与添加顺序一致）
+     */
+    const std::vector<slot_t>& slots() const {
+        return m_slots;
+    }
+
+    /**
+     * @brief 请求个数
+     */
+    size_t size() const {
+        return m_slots.size();
+    }
+
+    /**
+     * @brief 执行计划
+     * @param device 目标设备
+     * @param mode 执行方式
+     * @return 各请求的结果（引用本计划，计划须比结果存活更久）
+     */
+    read_plan_result_t execute(device_impl_t& device, read_mode_t mode = read_mode_t::batch) const;
+
+private:
+    friend class read_planner_t;
+
+    std::vector<command_t> m_commands;
+    std::vector<slot_t> m_slots;
+};
+
+// ============================================================================
+// read_plan_result_t - 计划执行结果
+// ============================================================================
+
+/**
+ * @brief 读取计划的执行结果
+ *
+ * 保存每条合并命令的响应，按请求序号切分数据；取值时不再复制响应。
+ * 16 位单元按大端解释，32 位值为高字在前。
+ */
+class read_plan_result_t {
+public:
+    read_plan_result_t(const read_plan_t& plan, std::vector<result_t<response_t>> responses)
+        : m_plan(&plan)
+        , m_responses(std::move(responses)) {
+    }
+
+    /**
+     * @brief 请求个数
+     */
+    size_t size() const {
+        return m_plan->size();
+    }
+
+    /**
+     * @brief 实际发送的命令数
+     */
+    size_t round_trips() const {
+        return m_responses.size();
+    }
+
+    /**
+     * @brief 请求是否成功
+     */
+    result_t<void> status(size_t index) const {
+        auto view = _view(index);
+        if (!view) {
+            return make_unexpected(view.error());
+        }
+        return make_ok();
+    }
+
+    /**
+     * @brief 请求对应的原始字节（仅适用于按字节对齐的单元）
+     */
+    result_t<const_byte_span_t> bytes(size_t index) const {
+        auto view = _view(index);
+        if (!view) {
+            return make_unexpected(view.error());
+        }
+        const read_plan_t::slot_t& slot = m_plan->slots()[index];
+        if (slot.unit_bits == 1) {
+            return make_error<const_byte_span_t>(error_code_t::invalid_argument,
+                                                 "Bit-packed request has no byte view");
+        }
+        return *view;
+    }
+
+    /**
+     * @brief 请求中第 item 个 16 位单元
+     */
+    result_t<uint16_t> as_uint16(size_t index, size_t item = 0) const {
+        auto data = _words(index, item, 1);
+        if (!data) {
+            return make_unexpected(data.error());
+        }
+        return static_cast<uint16_t>(((*data)[0] << 8) | (*data)[1]);
+    }
+
+    result_t<int16_t> as_int16(size_t index, size_t item = 0) const {
+        auto value = as_uint16(index, item);
+        if (!value) {
+            return make_unexpected(value.error());
+        }
+        return static_cast<int16_t>(*value);
+    }
+
+    /**
+     * @brief 从第 item 个 16 位单元开始的 32 位值（高字在前）
+     */
+    result_t<uint32_t> as_uint32(size_t index, size_t item = 0) const {
+        auto data = _words(index, item, 2);
+        if (!data) {
+            return make_unexpected(data.error());
+        }
+        return (static_cast<uint32_t>((*data)[0]) << 24) |
+               (static_cast<uint32_t>((*data)[1]) << 16) |
+               (static_cast<uint32_t>((*data)[2]) << 8) |
+               static_cast<uint32_t>((*data)[3]);
+    }
+
+    result_t<int32_t> as_int32(size_t index, size_t item = 0) const {
+        auto value = as_uint32(index, item);
+        if (!value) {
+            return make_unexpected(value.error());
+        }
+        return static_cast<int32_t>(*value);
+    }
+
+    /**
+     * @brief 从第 item 个 16 位单元开始的 IEEE 754 单精度值（高字在前）
+     */
+    result_t<float> as_float(size_t index, size_t item = 0) const {
+        auto value = as_uint32(index, item);
+        if (!value) {
+            return make_unexpected(value.error());
+        }
+        float result = 0.0f;
+        const uint32_t bits = *value;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    /**
+     * @brief 按位打包请求中的第 item 位（线圈/离散输入）
+     */
+    result_t<bool> as_bool(size_t index, size_t item = 0) const {
+        auto view = _view(index);
+        if (!view) {
+            return make_unexpected(view.error());
+        }
+        const read_plan_t::slot_t& slot = m_plan->slots()[index];
+        if (slot.unit_bits != 1) {
+            return make_error<bool>(error_code_t::invalid_argument, "Request is not bit-packed");
+        }
+        if (item >= slot.count) {
+            return make_error<bool>(error_code_t::out_of_range, "Bit index out of range");
+        }
+        const size_t bit = slot.offset + item;
+        return (((*view)[bit / 8] >> (bit % 8)) & 0x01) != 0;
+    }
+
+private:
+    /**
+     * @brief 请求在响应数据中的视图
+     *
+     * 字节单元返回恰好覆盖请求的部分；按位打包时返回整条响应数据，由调用方按位偏移取值。
+     */
+    result_t<const_byte_span_t> _view(size_t index) const {
+        if (index >= m_plan->size()) {
+            return make_error<const_byte_span_t>(error_code_t::out_of_range,
+                                                 "Request index out of range");
+        }
+        const read_plan_t::slot_t& slot = m_plan->slots()[index];
+        if (slot.command == read_plan_t::k_invalid || slot.command >= m_responses.size()) {
+            return make_error<const_byte_span_t>(error_code_t::invalid_argument,
+                                                 "Request exceeds read limits");
+        }
+        const result_t<response_t>& response = m_responses[slot.command];
+        if (!response) {
+            return make_unexpected(response.error());
+        }
+        if (!response->is_success()) {
+            return make_error<const_byte_span_t>(error_code_t::device_error,
+                                                 "Device rejected read");
+        }
+
+        const const_byte_span_t data = response->data_view();
+        size_t first = 0;
+        size_t length = 0;
+        if (slot.unit_bits == 1) {
+            length = (static_cast<size_t>(slot.offset) + slot.count + 7) / 8;
+        } else {
+            const size_t unit_bytes = slot.unit_bits / 8u;
+            first = static_cast<size_t>(slot.offset) * unit_bytes;
+            length = static_cast<size_t>(slot.count) * unit_bytes;
+        }
+        if (data.size() < first || data.size() - first < length) {
+            return make_error<const_byte_span_t>(error_code_t::invalid_size,
+                                                 "Response shorter than requested range");
+        }
+        return slot.unit_bits == 1 ? data.first(length) : data.subspan(first, length);
+    }
+
+    /**
+     * @brief 请求中从第 item 个 16 位单元开始的 words 个单元
+     */
+    result_t<const byte_t*> _words(size_t index, size_t item, size_t words) const {
+        auto view = bytes(index);
+        if (!view) {
+            return make_unexpected(view.error());
+        }
+        if (view->size() < 2 * (item + words)) {
+            return make_error<const byte_t*>(error_code_t::out_of_range,
+                                             "Register index out of range");
+        }
+        return view->data() + 2 * item;
+    }
+
+    const read_plan_t* m_plan;
+    std::vector<result_t<response_t>> m_responses;
+};
+
+inline read_plan_result_t read_plan_t::execute(device_impl_t& device, read_mode_t mode) const {
+    std::vector<result_t<response_t>> responses;
+    if (mode == read_mode_t::batch) {
+        responses = device.execute_batch(m_commands);
+    } else if (mode == read_mode_t::chunked) {
+        responses.reserve(m_commands.size());
+        command_priority_scope_t priority(command_priority_t::bulk);
+        for (const auto& cmd : m_commands) {
+            responses.push_back(device.execute(cmd));
+        }
+    } else {
+        std::vector<async_response_t> handles;
+        handles.reserve(m_commands.size());
+        for (const auto& cmd : m_commands) {
+            handles.push_back(device.execute_async(cmd));
+        }
+        responses.reserve(handles.size());
+        for (auto& handle : handles) {
+            responses.push_back(handle.get());
+        }
+    }
+    return read_plan_result_t(*this, std::move(responses));
+}
+
+// ============================================================================
+// read_planner_t - 读取合并规划器
+// ============================================================================
+
+/**
+ * @brief 寄存器读取合并规划器
+ *
+ * 同一功能码下，地址相邻、重叠或间隔不超过 max_gap 的请求合并为一条命令，
+ * 合并后的长度不超过该功能码的 max_count。间隔中的单元也会被读取，
+ * 对不允许读取空洞地址的设备应保持 max_gap 为 0。
+ *
+ * @code
+ * auto planner = read_planner_t::modbus(4);
+ * size_t volt = planner.add(0x03, 100, 2);
+ * size_t amps = planner.add(0x03, 104, 2);
+ * size_t run  = planner.add(0x01, 8, 1);
+ *
+ * const read_plan_t plan = planner.build();     // 2 条命令
+ * for (;;) {
+ *     auto values = plan.execute(device);
+ *     auto v = values.as_float(volt);
+ *     auto on = values.as_bool(run);
+ * }
+ * @endcode
+ */
+class read_planner_t {
+public:
+    /**
+     * @brief 构造函数
+     * @param max_gap 允许合并的最大地址间隔（单元）
+     * @param defaults 未单独配置的功能码使用的限制
+     */
+    explicit read_planner_t(uint16_t max_gap = 0, read_limits_t defaults = read_limits_t())
+        : m_max_gap(max_gap)
+        , m_defaults(defaults) {
+    }
+
+    /**
+     * @brief Modbus 的标准限制：线圈/离散输入 2000 位，寄存器 125 个
+     */
+    static read_planner_t modbus(uint16_t max_gap = 0) {
+        read_planner_t planner(max_gap);
+        planner.set_limits(0x01, 2000, 1);
+        planner.set_limits(0x02, 2000, 1);
+        planner.set_limits(0x03, 125, 16);
+        planner.set_limits(0x04, 125, 16);
+        return planner;
+    }
+
+    /**
+     * @brief 设置某个功能码的限制
+     */
+    read_planner_t& set_limits(uint8_t function_code, uint16_t max_count, uint8_t unit_bits) {
+        read_limits_t limits;
+        limits.max_count = max_count;
+        limits.unit_bits = unit_bits;
+        for (auto& entry : m_limits) {
+            if (entry.first == function_code) {
+                entry.second = limits;
+                return *this;
+            }
+        }
+        m_limits.push_back(std::make_pair(function_code, limits));
+        return *this;
+    }
+
+    /**
+     * @brief 功能码的限制
+     */
+    read_limits_t limits(uint8_t function_code) const {
+        for (const auto& entry : m_limits) {
+            if (entry.first == function_code) {
+                return entry.second;
+            }
+        }
+        return m_defaults;
+    }
+
+    /**
+     * @brief 添加读取请求
+     * @return 请求序号，用于从结果中取值
+     */
+    size_t add(uint8_t function_code, uint16_t address, uint16_t count) {
+        m_requests.push_back(request_t{function_code, address, count});
+        return m_requests.size() - 1;
+    }
+
+    size_t size() const {
+        return m_requests.size();
+    }
+
+    bool empty() const {
+        return m_requests.empty();
+    }
+
+    void clear() {
+        m_requests.clear();
+    }
+
+    uint16_t max_gap() const {
+        return m_max_gap;
+    }
+
+    /**
+     * @brief 生成合并后的计划
+     *
+     * 长度为 0、超过 max_count、越过地址空间末尾或单元位数不受支持的请求不参与合并，
+     * 在结果中得到 invalid_argument。
+     */
+    read_plan_t build() const {
+        read_plan_t plan;
+        plan.m_slots.resize(m_requests.size());
+
+        // 按（功能码, 地址）排序后顺序扫描
+        std::vector<size_t> order;
+        order.reserve(m_requests.size());
+        for (size_t i = 0; i < m_requests.size(); ++i) {
+            const request_t& req = m_requests[i];
+            const read_limits_t lim = limits(req.function_code);
+            if (req.count == 0 || req.count > lim.max_count ||
+                static_cast<uint32_t>(req.address) + req.count > 0x10000u ||
+                lim.unit_bits == 0 || (lim.unit_bits != 1 && lim.unit_bits % 8 != 0)) {
+                continue;
+            }
+            order.push_back(i);
+        }
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            const request_t& ra = m_requests[a];
+            const request_t& rb = m_requests[b];
+            if (ra.function_code != rb.function_code) {
+                return ra.function_code < rb.function_code;
+            }
+            return ra.address < rb.address;
+        });
+
+        size_t group_begin = 0;
+        uint32_t start = 0;
+        uint32_t end = 0;
+        for (size_t k = 0; k < order.size(); ++k) {
+            const request_t& req = m_requests[order[k]];
+            const uint32_t req_end = static_cast<uint32_t>(req.address) + req.count;
+            bool merge = false;
+            if (k > 0) {
+                const request_t& prev = m_requests[order[k - 1]];
+                const read_limits_t lim = limits(req.function_code);
+                merge = prev.function_code == req.function_code &&
+                        req.address <= end + m_max_gap &&
+                        std::max(end, req_end) - start <= lim.max_count;
+            }
+            if (!merge) {
+                if (k > 0) {
+                    _close_block(plan, order, group_begin, k, start, end);
+                }
+                group_begin = k;
+                start = req.address;
+                end = req_end;
+            } else if (req_end > end) {
+                end = req_end;
+            }
+        }
+        if (!order.empty()) {
+            _close_block(plan, order, group_begin, order.size(), start, end);
+        }
+        return plan;
+    }
+
+private:
+    struct request_t {
+        uint8_t function_code;
+        uint16_t address;
+        uint16_t count;
+    };
+
+    /**
+     * @brief 把 order[first, last) 的请求落到一条命令 [start, end) 上
+     */
+    void _close_block(read_plan_t& plan, const std::vector<size_t>& order,
+                      size_t first, size_t last, uint32_t start, uint32_t end) const {
+        const uint8_t fc = m_requests[order[first]].function_code;
+        const uint8_t unit_bits = limits(fc).unit_bits;
+        const size_t command = plan.m_commands.size();
+        plan.m_commands.push_back(make_read_command(fc, static_cast<uint16_t>(start),
+                                                    static_cast<uint16_t>(end - start)));
+        for (size_t k = first; k < last; ++k) {
+            const request_t& req = m_requests[order[k]];
+            read_plan_t::slot_t& slot = plan.m_slots[order[k]];
+            slot.command = command;
+            slot.offset = static_cast<uint16_t>(req.address - start);
+            slot.count = req.count;
+            slot.unit_bits = unit_bits;
+        }
+    }
+
+    uint16_t m_max_gap;
+    read_limits_t m_defaults;
+    std::vector<std::pair<uint8_t, read_limits_t>> m_limits;
+    std::vector<request_t> m_requests;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_DEVICE_READ_PLANNER_HPP
@@ -8,11 +8,28 @@
 #ifndef VDL_DEVICE_SCPI_ADAPTER_HPP
 #define VDL_DEVICE_SCPI_ADAPTER_HPP
 
+#include "command_priority.hpp"
 #include "device_impl.hpp"
+#include "../codec/ascii_codec.hpp"
+#include "../core/byte_swap.hpp"
 #include "../core/error.hpp"
 #include "../core/logging.hpp"
+#include "../core/number_parser.hpp"
+#include "scpi_batch.hpp"
+#include "scpi_shadow_cache.hpp"
+#include "scpi_format.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <complex>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <sstream>
 #include <stdexcept>
@@ -35,7 +52,7 @@ namespace vdl {
  * 
  * @code
  * auto transport = std::make_unique<tcp_transport_t>("192.168.1.100", 5025);
- * auto codec = std::make_unique<scpi_codec_t>();
+ * auto codec = std::make_unique<ascii_codec_t>();
  * device_impl_t device(std::move(transport), std::move(codec));
  * 
  * scpi_adapter_t scpi(&device);
@@ -85,6 +102,18 @@ public:
         return m_device.is_connected();
     }
 
+    /**
+     * @brief 查询是否走编解码器管线
+     *
+     * 设备使用 ascii_codec_t 时，查询通过 execute()/execute_batch() 完成，
+     * 享有重试、统计和批处理；否则按文本行直接读写。
+     * 不期望响应的命令和流式块读取始终直接读写。
+     */
+    bool uses_codec_pipeline() const {
+        const i_codec_t* codec = m_device.codec();
+        return codec != nullptr && std::strcmp(codec->name(), "ascii") == 0;
+    }
+
     // ========================================================================
     // 基础命令接口
     // ========================================================================
@@ -96,7 +125,47 @@ public:
      */
     result_t<void> command(const std::string& command) {
         VDL_LOG_DEBUG("SCPI CMD: %s", command.c_str());
-        auto result = m_device.write(command);
+        if (m_cache_enabled) {
+            _invalidate_on_reset(command);
+        }
+        // 程序消息必须以换行结束，否则仪器会与下一条消息拼接
+        if (!command.empty() && command.back() == '\n') {
+            return m_device.write(command);
+        }
+        scpi_command_buffer_t<> buffer;
+        buffer.append(command).terminate();
+        if (!buffer.overflow()) {
+            return m_device.write_raw(buffer.span());
+        }
+        return m_device.write(command + "\n");
+    }
+
+    /**
+     * @brief 发送已格式化好的命令（须含终止符），不做任何复制
+     */
+    result_t<void> command_raw(const_byte_span_t message) {
+        if (message.empty()) {
+            return make_error_void(error_code_t::invalid_argument, "Empty SCPI message");
+        }
+        return m_device.write_raw(message);
+    }
+
+    /**
+     * @brief 用预编译模板发送数值参数命令（无堆分配）
+     */
+    result_t<void> send(scpi_command_template_t& tpl, double value) {
+        auto result = command_raw(tpl.format(value));
+        if (result && m_cache_enabled) {
+            _cache_sent(tpl);
+        }
+        return result;
+    }
+
+    result_t<void> send(scpi_command_template_t& tpl, int value) {
+        auto result = command_raw(tpl.format(value));
+        if (result && m_cache_enabled) {
+            _cache_sent(tpl);
+        }
         return result;
     }
 
@@ -107,7 +176,38 @@ public:
      */
     result_t<std::string> query(const std::string& command) {
         VDL_LOG_DEBUG("SCPI QUERY: %s", command.c_str());
-        auto result = m_device.query(command);
+        auto result = uses_codec_pipeline() ? _execute_query(command) : m_device.query(command);
+        if (result) {
+            VDL_LOG_DEBUG("SCPI RESP: %s", result->c_str());
+        }
+        return result;
+    }
+
+    /**
+     * @brief 查询命令（响应文本分配在事务内存区中）
+     * @param command SCPI 查询命令字符串
+     * @param scope 事务作用域，返回的文本不能存活到作用域结束之后
+     * @return 成功返回响应字符串，失败返回错误
+     *
+     * 循环轮询时每轮开一个作用域，稳态下整个往返不做堆分配：
+     * @code
+     * vdl::arena_t arena;
+     * while (running) {
+     *     vdl::transaction_scope_t scope(arena);
+     *     auto text = scpi.query("MEAS:VOLT?", scope);
+     * }
+     * @endcode
+     */
+    result_t<arena_string_t> query(const std::string& command, transaction_scope_t& scope) {
+        VDL_LOG_DEBUG("SCPI QUERY: %s", command.c_str());
+        if (uses_codec_pipeline()) {
+            auto text = _execute_query(command);
+            if (!text) {
+                return make_unexpected(text.error());
+            }
+            return scope.make_string(text->data(), text->size());
+        }
+        auto result = m_device.query(command, scope);
         if (result) {
             VDL_LOG_DEBUG("SCPI RESP: %s", result->c_str());
         }
@@ -122,24 +222,29 @@ public:
      */
     result_t<std::string> query_value(const std::string& command, 
                                       size_t index = 0) {
-        auto result = query(command);
+        transaction_scope_t scope(_thread_arena());
+        auto result = query(command, scope);
         if (!result) {
-            return result;
+            return make_unexpected(result.error());
         }
 
-        // 分割逗号分隔的值
-        std::istringstream iss(*result);
-        std::string token;
+        // 分割逗号分隔的值（末尾逗号之后的空值不计）
+        const arena_string_t& text = *result;
+        size_t begin = 0;
         size_t current_index = 0;
-
-        while (std::getline(iss, token, ',')) {
+        while (begin < text.size()) {
+            size_t end = text.find(',', begin);
+            if (end == arena_string_t::npos) {
+                end = text.size();
+            }
             if (current_index == index) {
-                // 去除前后空格
-                token.erase(0, token.find_first_not_of(" \t\r\n"));
-                token.erase(token.find_last_not_of(" \t\r\n") + 1);
-                return make_ok(std::move(token));
+                const char* first = text.data() + begin;
+                const char* last = text.data() + end;
+                _trim(first, last);
+                return make_ok(std::string(first, last));
             }
             ++current_index;
+            begin = end + 1;
         }
 
         return make_error<std::string>(error_code_t::invalid_format,
@@ -156,29 +261,21 @@ public:
      * @return 成功返回数值，失败返回错误
      */
     result_t<double> query_double(const std::string& command) {
-        auto result = query(command);
+        transaction_scope_t scope(_thread_arena());
+        auto result = query(command, scope);
         if (!result) {
             return make_unexpected(result.error());
         }
 
-        // 获取第一个值（逗号分隔的情况下）
-        std::string value = *result;
-        size_t comma_pos = value.find(',');
-        if (comma_pos != std::string::npos) {
-            value = value.substr(0, comma_pos);
-        }
-
-        // 去除前后空格
-        value.erase(0, value.find_first_not_of(" \t\r\n"));
-        value.erase(value.find_last_not_of(" \t\r\n") + 1);
-
-        try {
-            double parsed_value = std::stod(value);
-            return make_ok(parsed_value);
-        } catch (const std::exception& e) {
+        // 只解析第一个值（逗号分隔的情况下），不复制
+        const char* first = result->data();
+        const char* last = _field_end(*result);
+        double parsed_value = 0.0;
+        if (!parse_double(first, last, parsed_value)) {
             return make_error<double>(error_code_t::invalid_format,
                                      "Cannot convert to double");
         }
+        return parsed_value;
     }
 
     /**
@@ -187,29 +284,25 @@ public:
      * @return 成功返回整数，失败返回错误
      */
     result_t<int> query_int(const std::string& command) {
-        auto result = query(command);
+        transaction_scope_t scope(_thread_arena());
+        auto result = query(command, scope);
         if (!result) {
             return make_unexpected(result.error());
         }
 
-        // 获取第一个值（逗号分隔的情况下）
-        std::string value = *result;
-        size_t comma_pos = value.find(',');
-        if (comma_pos != std::string::npos) {
-            value = value.substr(0, comma_pos);
-        }
-
-        // 去除前后空格
-        value.erase(0, value.find_first_not_of(" \t\r\n"));
-        value.erase(value.find_last_not_of(" \t\r\n") + 1);
-
-        try {
-            int parsed_value = std::stoi(value);
-            return make_ok(parsed_value);
-        } catch (const std::exception& e) {
+        // 第一个值（逗号分隔的情况下）：strtol 与 std::stoi 一样跳过前导空白，
+        // 在第一个非数字字符（包括逗号）处停止，直接在响应文本上解析
+        const char* text = result->c_str();
+        char* end = nullptr;
+        errno = 0;
+        const long parsed_value = std::strtol(text, &end, 10);
+        if (end == text || errno == ERANGE ||
+            parsed_value < std::numeric_limits<int>::min() ||
+            parsed_value > std::numeric_limits<int>::max()) {
             return make_error<int>(error_code_t::invalid_format,
                                   "Cannot convert to int");
         }
+        return static_cast<int>(parsed_value);
     }
 
     /**
@@ -218,12 +311,13 @@ public:
      * @return 成功返回布尔值，失败返回错误
      */
     result_t<bool> query_bool(const std::string& command) {
-        auto result = query(command);
+        transaction_scope_t scope(_thread_arena());
+        auto result = query(command, scope);
         if (!result) {
             return make_unexpected(result.error());
         }
 
-        std::string value = *result;
+        arena_string_t& value = *result;
         // 转换为小写
         std::transform(value.begin(), value.end(), value.begin(), ::tolower);
 
@@ -237,6 +331,376 @@ public:
         }
     }
 
+    // ========================================================================
+    // 设置缓存（写穿透影子缓存）
+    // ========================================================================
+
+    /**
+     * @brief 启用/禁用影子缓存（默认禁用）
+     *
+     * 启用后 set_double()/set_int() 写入的值被记录，get_double()/get_int()
+     * 直接返回记录值而不查询仪器。以下情况缓存失效：
+     * - 发送 *RST、*RCL 或 SYST:PRES
+     * - 设备重连（连接代数变化）
+     * - 调用 invalidate_cache()
+     */
+    void enable_shadow_cache(bool enable) {
+        m_cache_enabled = enable;
+        m_cache.invalidate();
+    }
+
+    bool shadow_cache_enabled() const {
+        return m_cache_enabled;
+    }
+
+    /**
+     * @brief 校验模式：读取时始终查询仪器，并用查询结果刷新缓存
+     */
+    void set_verify(bool verify) {
+        m_cache_verify = verify;
+    }
+
+    bool verify() const {
+        return m_cache_verify;
+    }
+
+    /**
+     * @brief 清空缓存
+     */
+    void invalidate_cache() {
+        m_cache.invalidate();
+    }
+
+    /**
+     * @brief 清除以 prefix 开头的缓存条目（用于相互关联的设置，如起止频率与中心/跨度）
+     */
+    void invalidate_cache(const std::string& prefix) {
+        m_cache.invalidate(prefix);
+    }
+
+    /**
+     * @brief 设置数值参数（发送 "HEADER value"）
+     * @param header SCPI 头，如 "SENS:FREQ:STAR"
+     * @param value 数值
+     */
+    result_t<void> set_double(const std::string& header, double value) {
+        scpi_command_buffer_t<> buffer;
+        buffer.append(header).append_char(' ').append_double(value).terminate();
+        if (buffer.overflow()) {
+            return make_error_void(error_code_t::invalid_size, "SCPI command too long");
+        }
+
+        auto result = command_raw(buffer.span());
+        if (result && m_cache_enabled) {
+            // 缓存实际发送的（已舍入的）值
+            double sent = value;
+            const char* text = buffer.c_str_data();
+            parse_double(text + header.size() + 1, text + buffer.size() - 1, sent);
+            m_cache.put(header, sent, m_device.connection_generation());
+        }
+        return result;
+    }
+
+    /**
+     * @brief 读取数值参数（启用缓存时优先返回缓存值）
+     * @param header SCPI 头，如 "SENS:FREQ:STAR"（自动追加 '?'）
+     */
+    result_t<double> get_double(const std::string& header) {
+        if (m_cache_enabled && !m_cache_verify) {
+            auto cached = m_cache.get(header, m_device.connection_generation());
+            if (cached) {
+                return *cached;
+            }
+        }
+
+        auto result = query_double(header + "?");
+        if (result && m_cache_enabled) {
+            m_cache.put(header, *result, m_device.connection_generation());
+        }
+        return result;
+    }
+
+    /**
+     * @brief 设置整数参数
+     */
+    result_t<void> set_int(const std::string& header, int value) {
+        scpi_command_buffer_t<> buffer;
+        buffer.append(header).append_char(' ').append_int(value).terminate();
+        if (buffer.overflow()) {
+            return make_error_void(error_code_t::invalid_size, "SCPI command too long");
+        }
+
+        auto result = command_raw(buffer.span());
+        if (result && m_cache_enabled) {
+            m_cache.put(header, static_cast<double>(value), m_device.connection_generation());
+        }
+        return result;
+    }
+
+    /**
+     * @brief 读取整数参数（启用缓存时优先返回缓存值）
+     */
+    result_t<int> get_int(const std::string& header) {
+        if (m_cache_enabled && !m_cache_verify) {
+            auto cached = m_cache.get(header, m_device.connection_generation());
+            if (cached) {
+                return static_cast<int>(*cached);
+            }
+        }
+
+        auto result = query_int(header + "?");
+        if (result && m_cache_enabled) {
+            m_cache.put(header, static_cast<double>(*result), m_device.connection_generation());
+        }
+        return result;
+    }
+
+    /**
+     * @brief 记录已知的设置值（如通过批处理写入的设置）
+     */
+    void update_cache(const std::string& header, double value) {
+        if (m_cache_enabled) {
+            m_cache.put(header, value, m_device.connection_generation());
+        }
+    }
+
+    // ========================================================================
+    // 批处理
+    // ========================================================================
+
+    /**
+     * @brief 执行批处理：合并为少量程序消息发送，并拆分复合响应
+     * @param batch 批处理
+     * @return 成功返回各查询的响应（按查询序号），失败返回第一个错误
+     *
+     * 执行期间持有设备锁，其他线程的请求不会插入批处理的消息之间。
+     */
+    result_t<scpi_batch_result_t> execute(const scpi_batch_t& batch) {
+        std::lock_guard<device_impl_t> guard(m_device);
+
+        std::vector<std::string> replies;
+        replies.reserve(batch.query_count());
+
+        const std::vector<scpi_message_t> messages = batch.build_messages();
+        if (uses_codec_pipeline()) {
+            auto result = _execute_pipelined(messages, replies);
+            if (!result) {
+                return make_unexpected(result.error());
+            }
+            return scpi_batch_result_t(std::move(replies));
+        }
+
+        for (const auto& message : messages) {
+            if (message.query_count == 0) {
+                auto result = command(message.text);
+                if (!result) {
+                    return make_unexpected(result.error());
+                }
+                continue;
+            }
+
+            auto reply = query(message.text);
+            if (!reply) {
+                return make_unexpected(reply.error());
+            }
+            auto split = split_scpi_reply(*reply, message.query_count, replies);
+            if (!split) {
+                return make_unexpected(split.error());
+            }
+        }
+
+        return scpi_batch_result_t(std::move(replies));
+    }
+
+    // ========================================================================
+    // 流式数据查询
+    // ========================================================================
+
+    /**
+     * @brief 查询逗号分隔的数值数据，边接收边解析
+     * @param command SCPI 查询命令
+     * @param out [out] 追加解析结果（失败时恢复原状）
+     * @return 成功返回解析出的个数，失败返回错误
+     *
+     * 不拼接完整的响应字符串，峰值内存为一个接收缓冲区加上输出数组。
+     */
+    result_t<size_t> query_data_doubles(const std::string& command, std::vector<double>& out) {
+        VDL_LOG_DEBUG("SCPI STREAM QUERY: %s", command.c_str());
+        const size_t original = out.size();
+        number_stream_parser_t parser(out);
+
+        auto result = m_device.query_chunked(command, [&parser](const char* data, size_t len) {
+            return parser.feed(data, len);
+        });
+        if (result) {
+            auto finished = parser.finish();
+            if (!finished) {
+                result = make_unexpected(finished.error());
+            }
+        }
+        if (!result) {
+            out.resize(original);
+            return make_unexpected(result.error());
+        }
+        return parser.count();
+    }
+
+    // ========================================================================
+    // 二进制块数据（FORM:DATA REAL,32 / REAL,64）
+    // ========================================================================
+
+    /**
+     * @brief 设置仪器二进制数据的字节序（FORM:BORD）
+     * @param order big 对应 NORM，little 对应 SWAP，native 取本机字节序
+     */
+    result_t<void> set_byte_order(byte_order_t order) {
+        if (order == byte_order_t::native) {
+            order = host_byte_order();
+        }
+        auto result = command(order == byte_order_t::big ? "FORM:BORD NORM" : "FORM:BORD SWAP");
+        if (result) {
+            m_byte_order = order;
+        }
+        return result;
+    }
+
+    /**
+     * @brief 查询仪器当前字节序（FORM:BORD?）并更新缓存
+     */
+    result_t<byte_order_t> query_byte_order() {
+        auto result = query("FORM:BORD?");
+        if (!result) {
+            return make_unexpected(result.error());
+        }
+        if (result->compare(0, 4, "SWAP") == 0) {
+            m_byte_order = byte_order_t::little;
+        } else if (result->compare(0, 4, "NORM") == 0) {
+            m_byte_order = byte_order_t::big;
+        } else {
+            return make_error<byte_order_t>(error_code_t::invalid_format,
+                                            "Unknown byte order: " + *result);
+        }
+        return m_byte_order;
+    }
+
+    /**
+     * @brief 当前假定的仪器字节序（默认 big，即 SCPI 的 NORM）
+     */
+    byte_order_t byte_order() const {
+        return m_byte_order;
+    }
+
+    /**
+     * @brief 查询并读取定长二进制块（#<n><length><bytes>）
+     */
+    result_t<bytes_t> query_binary_block(const std::string& command) {
+        VDL_LOG_DEBUG("SCPI BLOCK QUERY: %s", command.c_str());
+        bytes_t data;
+        auto result = m_device.query_binary_block(command, [&data](size_t length) {
+            data.resize(length);
+            return byte_span_t(data.data(), data.size());
+        });
+        if (!result) {
+            return make_unexpected(result.error());
+        }
+        return make_ok(std::move(data));
+    }
+
+    /**
+     * @brief 查询 REAL,64 格式的数组，块数据直接读入 out
+     * @return 成功返回元素个数
+     *
+     * @code
+     * scpi.command("FORM:DATA REAL,64");
+     * std::vector<double> trace;
+     * scpi.query_real64_array("CALC:DATA? FDAT", trace);
+     * @endcode
+     */
+    result_t<size_t> query_real64_array(const std::string& command, std::vector<double>& out) {
+        return _query_real_array(command, out);
+    }
+
+    /**
+     * @brief 查询 REAL,64 格式的数组，块数据直接读入调用方提供的缓冲区
+     * @param out 目标缓冲区（如 trace_file_writer_t::begin_sweep() 取得的记录）
+     * @return 成功返回元素个数；块长度超过 out 时返回 invalid_size
+     */
+    result_t<size_t> query_real64_array(const std::string& command, span_t<double> out) {
+        VDL_LOG_DEBUG("SCPI BLOCK QUERY: %s", command.c_str());
+        size_t count = 0;
+        auto result = m_device.query_binary_block(command, [&out, &count](size_t length) {
+            if (length % sizeof(double) != 0 || length / sizeof(double) > out.size()) {
+                return byte_span_t();
+            }
+            count = length / sizeof(double);
+            return byte_span_t(reinterpret_cast<byte_t*>(out.data()), length);
+        });
+        if (!result) {
+            return make_unexpected(result.error());
+        }
+
+        if (m_byte_order != host_byte_order()) {
+            byte_swap_in_place(reinterpret_cast<byte_t*>(out.data()), count, sizeof(double));
+        }
+        return count;
+    }
+
+    result_t<std::vector<double>> query_real64_array(const std::string& command) {
+        std::vector<double> out;
+        auto result = _query_real_array(command, out);
+        if (!result) {
+            return make_unexpected(result.error());
+        }
+        return make_ok(std::move(out));
+    }
+
+    /**
+     * @brief 分段查询 REAL,64 数组：每条命令返回一段，按顺序追加到 out
+     * @param commands 各段的查询命令（如按点范围分段的 CALC:DATA? 命令）
+     * @param out [out] 结果（失败时恢复原状）
+     * @param priority 各段的排队优先级
+     * @return 成功返回追加的元素个数
+     *
+     * 每段是一次独立的设备调用，段之间设备锁被释放，
+     * 其他线程排队中的更高优先级命令（如关闭输出）可以插在两段之间执行。
+     */
+    result_t<size_t> query_real64_array_chunked(const std::vector<std::string>& commands,
+                                                std::vector<double>& out,
+                                                command_priority_t priority = command_priority_t::bulk) {
+        const size_t original = out.size();
+        std::vector<double> segment;
+        auto result = for_each_chunk(commands.size(), [&](size_t index) -> result_t<void> {
+            auto count = _query_real_array(commands[index], segment);
+            if (!count) {
+                return make_error_void(count.error());
+            }
+            out.insert(out.end(), segment.begin(), segment.end());
+            return make_ok();
+        }, priority);
+        if (!result) {
+            out.resize(original);
+            return make_unexpected(result.error());
+        }
+        return out.size() - original;
+    }
+
+    /**
+     * @brief 查询 REAL,32 格式的数组，块数据直接读入 out
+     * @return 成功返回元素个数
+     */
+    result_t<size_t> query_real32_array(const std::string& command, std::vector<float>& out) {
+        return _query_real_array(command, out);
+    }
+
+    result_t<std::vector<float>> query_real32_array(const std::string& command) {
+        std::vector<float> out;
+        auto result = _query_real_array(command, out);
+        if (!result) {
+            return make_unexpected(result.error());
+        }
+        return make_ok(std::move(out));
+    }
+
     // ========================================================================
     // 设备管理命令
     // ========================================================================
@@ -276,6 +740,115 @@ public:
         return query_bool("*OPC?");
     }
 
+    // ========================================================================
+    // 事件驱动的操作完成
+    // ========================================================================
+
+    static constexpr uint8_t k_esr_opc = 0x01;   ///< 标准事件状态寄存器 OPC 位
+
+    /**
+     * @brief 配置 OPC → SRQ：*ESE 1 只放行 OPC，*SRE 32 在 ESB 置位时请求服务
+     *
+     * 同时读取一次 *ESR? 以清除之前残留的事件。
+     */
+    result_t<void> enable_opc_service_request() {
+        auto result = command("*ESE 1;*SRE 32");
+        if (!result) {
+            return result;
+        }
+        auto esr = query_int("*ESR?");
+        if (!esr) {
+            return make_error_void(esr.error());
+        }
+        return make_ok();
+    }
+
+    /**
+     * @brief 等待前面发送的 *OPC 生效
+     * @param timeout_ms 总超时时间
+     * @param poll_interval_ms 传输层不支持 SRQ 时轮询 *ESR? 的间隔
+     *
+     * 传输层支持 SRQ 时阻塞在服务请求事件上，不占用链路；
+     * 否则退化为周期性查询 *ESR?（不像 *OPC? 那样阻塞到操作结束）。
+     * 两种方式都会读取 *ESR?，从而清除 ESB 并撤销 SRQ。
+     */
+    result_t<void> wait_operation_complete(milliseconds_t timeout_ms,
+                                           milliseconds_t poll_interval_ms = 10) {
+        i_transport_t* transport = m_device.transport();
+        if (transport == nullptr) {
+            return make_error_void(error_code_t::not_connected, "No transport");
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::milliseconds(timeout_ms);
+        bool use_srq = true;
+
+        while (true) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                return make_error_void(error_code_t::timeout, "Operation complete timeout");
+            }
+            const auto remaining = static_cast<milliseconds_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count());
+
+            if (use_srq) {
+                auto srq = transport->wait_service_request(remaining);
+                if (!srq) {
+                    if (srq.error().code() != error_code_t::not_supported) {
+                        return srq;
+                    }
+                    use_srq = false;
+                    continue;
+                }
+                // 串行轮询应答 SRQ（清除 RQS）；不支持时忽略
+                (void)transport->read_status_byte();
+            }
+
+            auto esr = query_int("*ESR?");
+            if (!esr) {
+                return make_error_void(esr.error());
+            }
+            if ((static_cast<unsigned>(*esr) & k_esr_opc) != 0) {
+                return make_ok();
+            }
+
+            if (!use_srq) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(
+                    std::min(poll_interval_ms, remaining)));
+            }
+        }
+    }
+
+    /**
+     * @brief 发送命令并附加 *OPC，返回在操作完成时就绪的 future
+     * @param command 启动操作的命令（如 "INIT:IMM"）
+     * @param timeout_ms 等待操作完成的超时
+     * @param poll_interval_ms 退化为轮询时的间隔
+     *
+     * 需要先调用 enable_opc_service_request()。等待在后台线程中进行，
+     * future 析构时会等待该线程结束，因此适配器和设备必须比 future 活得久。
+     *
+     * @code
+     * scpi.enable_opc_service_request();
+     * auto done = scpi.start_operation("INIT:IMM", 30000);
+     * // ... 做其他事情 ...
+     * auto result = done.get();
+     * @endcode
+     */
+    std::future<result_t<void>> start_operation(const std::string& command,
+                                                milliseconds_t timeout_ms,
+                                                milliseconds_t poll_interval_ms = 10) {
+        auto sent = this->command(command + ";*OPC");
+        if (!sent) {
+            std::promise<result_t<void>> failed;
+            failed.set_value(std::move(sent));
+            return failed.get_future();
+        }
+        return std::async(std::launch::async, [this, timeout_ms, poll_interval_ms]() {
+            return wait_operation_complete(timeout_ms, poll_interval_ms);
+        });
+    }
+
     /**
      * @brief 查询错误队列
      * @return 成功返回错误消息，失败返回错误
@@ -318,28 +891,31 @@ public:
     static result_t<std::vector<double>> parse_data_doubles(
         const std::string& data_str) {
         std::vector<double> result;
-        std::istringstream iss(data_str);
-        std::string token;
-
-        while (std::getline(iss, token, ',')) {
-            // 去除前后空格
-            token.erase(0, token.find_first_not_of(" \t\r\n"));
-            token.erase(token.find_last_not_of(" \t\r\n") + 1);
-
-            if (token.empty()) continue;
-
-            try {
-                result.push_back(std::stod(token));
-            } catch (const std::exception& e) {
-                return make_error<std::vector<double>>(
-                    error_code_t::invalid_format,
-                    "Failed to parse double value");
-            }
+        auto count = parse_data_doubles(data_str, result);
+        if (!count) {
+            return make_unexpected(count.error());
         }
-
         return make_ok(std::move(result));
     }
 
+    /**
+     * @brief 将逗号分隔的数据追加到调用者提供的向量（可复用容量）
+     * @return 成功返回解析出的个数；失败时 out 保持不变
+     */
+    static result_t<size_t> parse_data_doubles(const std::string& data_str,
+                                               std::vector<double>& out) {
+        return parse_doubles_into(data_str.data(), data_str.size(), out);
+    }
+
+    /**
+     * @brief 将逗号分隔的数据写入固定大小的缓冲区
+     * @return 成功返回写入的个数；缓冲区不足返回 out_of_range
+     */
+    static result_t<size_t> parse_data_doubles(const std::string& data_str,
+                                               span_t<double> out) {
+        return parse_doubles_into(data_str.data(), data_str.size(), out);
+    }
+
     /**
      * @brief 将复数数据转换为向量对
      * 格式：实部1,虚部1,实部2,虚部2,...
@@ -347,27 +923,188 @@ public:
     static result_t<std::vector<std::pair<double, double>>> 
     parse_complex_data(const std::string& data_str) {
         std::vector<std::pair<double, double>> result;
-        auto values_result = parse_data_doubles(data_str);
-        if (!values_result) {
-            return make_unexpected(values_result.error());
-        }
+        result.reserve(estimate_value_count(data_str.data(), data_str.size()) / 2);
 
-        const auto& values = *values_result;
-        if (values.size() % 2 != 0) {
+        double real = 0.0;
+        bool has_real = false;
+        auto count = detail::parse_separated_values(
+            data_str.data(), data_str.size(), [&](double v) {
+                if (has_real) {
+                    result.emplace_back(real, v);
+                } else {
+                    real = v;
+                }
+                has_real = !has_real;
+                return true;
+            });
+        if (!count) {
+            return make_unexpected(count.error());
+        }
+        if (has_real) {
             return make_error<std::vector<std::pair<double, double>>>(
                 error_code_t::invalid_format,
                 "Complex data must have even number of values");
         }
 
-        for (size_t i = 0; i < values.size(); i += 2) {
-            result.push_back({values[i], values[i+1]});
-        }
-
         return make_ok(std::move(result));
     }
 
+    /**
+     * @brief 将复数数据追加到 std::complex 向量
+     * @return 成功返回复数个数；失败时 out 保持不变
+     */
+    static result_t<size_t> parse_complex_data(const std::string& data_str,
+                                               std::vector<std::complex<double>>& out) {
+        return parse_complex_into(data_str.data(), data_str.size(), out);
+    }
+
+    /**
+     * @brief 将复数数据拆分到实部/虚部两个向量
+     * @return 成功返回复数个数；失败时两个向量保持不变
+     */
+    static result_t<size_t> parse_complex_data(const std::string& data_str,
+                                               std::vector<double>& real_out,
+                                               std::vector<double>& imag_out) {
+        return parse_complex_into(data_str.data(), data_str.size(), real_out, imag_out);
+    }
+
 private:
+    /**
+     * @brief 经 execute() 完成一次查询
+     */
+    result_t<std::string> _execute_query(const std::string& command) {
+        auto response = m_device.execute(make_ascii_command(command));
+        if (!response) {
+            return make_unexpected(response.error());
+        }
+        return response_text(*response);
+    }
+
+    /**
+     * @brief 管线模式下执行批处理消息
+     *
+     * 连续的查询消息合并为一次 execute_batch()（一次写出、按序收取响应），
+     * 遇到不期望响应的消息时先完成已排队的查询，再直接写出该消息。
+     */
+    result_t<void> _execute_pipelined(const std::vector<scpi_message_t>& messages,
+                                      std::vector<std::string>& replies) {
+        std::vector<command_t> pending;
+        std::vector<size_t> pending_counts;
+
+        auto flush = [&]() -> result_t<void> {
+            if (pending.empty()) {
+                return make_ok();
+            }
+            auto results = m_device.execute_batch(pending);
+            for (size_t i = 0; i < results.size(); ++i) {
+                if (!results[i]) {
+                    return make_error_void(results[i].error());
+                }
+                auto split = split_scpi_reply(response_text(*results[i]), pending_counts[i], replies);
+                if (!split) {
+                    return split;
+                }
+            }
+            pending.clear();
+            pending_counts.clear();
+            return make_ok();
+        };
+
+        for (const auto& message : messages) {
+            if (message.query_count == 0) {
+                auto flushed = flush();
+                if (!flushed) {
+                    return flushed;
+                }
+                auto result = command(message.text);
+                if (!result) {
+                    return result;
+                }
+                continue;
+            }
+            pending.push_back(make_ascii_command(message.text));
+            pending_counts.push_back(message.query_count);
+        }
+        return flush();
+    }
+
+    template<typename T>
+    result_t<size_t> _query_real_array(const std::string& command, std::vector<T>& out) {
+        VDL_LOG_DEBUG("SCPI BLOCK QUERY: %s", command.c_str());
+        auto result = m_device.query_binary_block(command, [&out](size_t length) {
+            out.resize(length / sizeof(T));
+            const size_t usable = length % sizeof(T) == 0 ? length : 0;
+            return byte_span_t(reinterpret_cast<byte_t*>(out.data()), usable);
+        });
+        if (!result) {
+            out.clear();
+            return make_unexpected(result.error());
+        }
+
+        if (m_byte_order != host_byte_order()) {
+            byte_swap_in_place(reinterpret_cast<byte_t*>(out.data()), out.size(), sizeof(T));
+        }
+        return out.size();
+    }
+
+    /**
+     * @brief 本线程的事务内存区（类型转换查询的响应文本在其中分配）
+     *
+     * 按线程而不是按适配器持有：start_operation() 等后台任务与调用线程可能同时查询。
+     */
+    static arena_t& _thread_arena() {
+        static thread_local arena_t arena(256);
+        return arena;
+    }
+
+    /**
+     * @brief 第一个逗号（没有逗号时为文本末尾）
+     */
+    static const char* _field_end(const arena_string_t& text) {
+        const size_t comma_pos = text.find(',');
+        return text.data() + (comma_pos == arena_string_t::npos ? text.size() : comma_pos);
+    }
+
+    /**
+     * @brief 去除 [first, last) 前后的空白
+     */
+    static void _trim(const char*& first, const char*& last) {
+        while (first < last && std::strchr(" \t\r\n", *first) != nullptr) {
+            ++first;
+        }
+        while (last > first && std::strchr(" \t\r\n", *(last - 1)) != nullptr) {
+            --last;
+        }
+    }
+
+    void _cache_sent(const scpi_command_template_t& tpl) {
+        double sent = 0.0;
+        if (parse_double(tpl.argument_begin(), tpl.argument_end(), sent)) {
+            m_cache.put(tpl.header(), sent, m_device.connection_generation());
+        }
+    }
+
+    // 会使仪器设置整体改变的命令
+    void _invalidate_on_reset(const std::string& command) {
+        std::string upper = command;
+        for (auto& c : upper) {
+            if (c >= 'a' && c <= 'z') {
+                c = static_cast<char>(c - 'a' + 'A');
+            }
+        }
+        if (upper.find("*RST") != std::string::npos ||
+            upper.find("*RCL") != std::string::npos ||
+            upper.find("SYST:PRES") != std::string::npos ||
+            upper.find("SYSTEM:PRESET") != std::string::npos) {
+            m_cache.invalidate();
+        }
+    }
+
     device_impl_t& m_device;
+    byte_order_t m_byte_order = byte_order_t::big;  ///< 仪器二进制数据字节序（FORM:BORD）
+    scpi_shadow_cache_t m_cache;                    ///< 设置影子缓存
+    bool m_cache_enabled = false;
+    bool m_cache_verify = false;
 };
 
 }  // namespace vdl
@@ -0,0 +1,306 @@
+/**
+ * @file scpi_batch.hpp
+ * @brief SCPI 复合命令批处理
+ *
+ * 将多条 SCPI 命令/查询用 ';' 合并为少量程序消息，减少往返次数。
+ */
+
+#ifndef VDL_DEVICE_SCPI_BATCH_HPP
+#define VDL_DEVICE_SCPI_BATCH_HPP
+
+#include "../core/types.hpp"
+#include "../core/error.hpp"
+#include "../core/number_parser.hpp"
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vdl {
+
+// ============================================================================
+// scpi_message_t - 程序消息
+// ============================================================================
+
+/**
+ * @brief 合并后的一条程序消息
+ */
+struct scpi_message_t {
+    std::string text;           ///< 以 ';' 连接的消息文本（不含终止符）
+    size_t query_count = 0;     ///< 消息中的查询个数（即响应中 ';' 分隔的字段数）
+};
+
+// ============================================================================
+// scpi_batch_t - 批处理构建器
+// ============================================================================
+
+/**
+ * @brief SCPI 批处理构建器
+ *
+ * 收集命令和查询，按仪器输入缓冲区上限拼成一条或几条程序消息。
+ * 除每条消息的第一项外，不以 '*' 或 ':' 开头的命令会补上 ':'，
+ * 保证从根节点解析。
+ *
+ * @code
+ * scpi_batch_t batch;
+ * batch.command("SENS:FREQ:STAR 1E9")
+ *      .command("SENS:FREQ:STOP 6E9");
+ * size_t points = batch.query("SENS:SWE:POIN?");
+ *
+ * auto results = scpi.execute(batch);
+ * if (results) {
+ *     auto n = results->as_int(points);
+ * }
+ * @endcode
+ */
+class scpi_batch_t {
+public:
+    static constexpr size_t k_default_max_message_size = 512;  ///< 默认单条消息上限（含终止符）
+
+    /**
+     * @brief 构造函数
+     * @param max_message_size 单条程序消息的最大字节数（含终止符）
+     */
+    explicit scpi_batch_t(size_t max_message_size = k_default_max_message_size)
+        : m_max_message_size(max_message_size) {
+    }
+
+    /**
+     * @brief 添加命令（无响应）
+     */
+    scpi_batch_t& command(const std::string& text) {
+        m_entries.push_back(entry_t{text, false});
+        return *this;
+    }
+
+    /**
+     * @brief 添加查询
+     * @return 查询序号，用于从结果中取值
+     */
+    size_t query(const std::string& text) {
+        m_entries.push_back(entry_t{text, true});
+        return m_query_count++;
+    }
+
+    /**
+     * @brief 查询个数
+     */
+    size_t query_count() const {
+        return m_query_count;
+    }
+
+    /**
+     * @brief 条目总数
+     */
+    size_t size() const {
+        return m_entries.size();
+    }
+
+    bool empty() const {
+        return m_entries.empty();
+    }
+
+    void clear() {
+        m_entries.clear();
+        m_query_count = 0;
+    }
+
+    size_t max_message_size() const {
+        return m_max_message_size;
+    }
+
+    /**
+     * @brief 按消息上限拼接程序消息
+     *
+     * 单个条目超过上限时单独成为一条消息。
+     */
+    std::vector<scpi_message_t> build_messages() const {
+        std::vector<scpi_message_t> messages;
+        scpi_message_t current;
+
+        for (const auto& entry : m_entries) {
+            const bool needs_root = !entry.text.empty() &&
+                                    entry.text[0] != '*' && entry.text[0] != ':';
+            // 追加时需要的字节：';' + 可能的 ':' + 文本；1 字节留给终止符
+            const size_t extra = 1 + (needs_root ? 1 : 0) + entry.text.size();
+            if (!current.text.empty() && current.text.size() + extra + 1 > m_max_message_size) {
+                messages.push_back(std::move(current));
+                current = scpi_message_t();
+            }
+
+            if (!current.text.empty()) {
+                current.text.push_back(';');
+                if (needs_root) {
+                    current.text.push_back(':');
+                }
+            }
+            current.text += entry.text;
+            if (entry.is_query) {
+                ++current.query_count;
+            }
+        }
+
+        if (!current.text.empty()) {
+            messages.push_back(std::move(current));
+        }
+        return messages;
+    }
+
+private:
+    struct entry_t {
+        std::string text;
+        bool is_query;
+    };
+
+    std::vector<entry_t> m_entries;
+    size_t m_query_count = 0;
+    size_t m_max_message_size;
+};
+
+// ============================================================================
+// 响应拆分
+// ============================================================================
+
+/**
+ * @brief 将 ';' 分隔的复合响应拆分为各查询的结果
+ * @param reply 响应文本
+ * @param expected 期望的字段数
+ * @param out [out] 追加拆分后的字段（已去除前后空白）
+ * @return 字段数不符时返回 invalid_format
+ *
+ * 引号（"..." 或 '...'）内的 ';' 不作为分隔符。
+ */
+inline result_t<void> split_scpi_reply(const std::string& reply, size_t expected,
+                                       std::vector<std::string>& out) {
+    const size_t original = out.size();
+    char quote = 0;
+    size_t field_start = 0;
+
+    auto push_field = [&](size_t end) {
+        size_t first = field_start;
+        size_t last = end;
+        while (first < last && detail::is_number_space(reply[first])) ++first;
+        while (last > first && detail::is_number_space(reply[last - 1])) --last;
+        out.push_back(reply.substr(first, last - first));
+    };
+
+    for (size_t i = 0; i < reply.size(); ++i) {
+        const char c = reply[i];
+        if (quote) {
+            if (c == quote) {
+                quote = 0;
+            }
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == ';') {
+            push_field(i);
+            field_start = i + 1;
+        }
+    }
+    push_field(reply.size());
+
+    if (out.size() - original != expected) {
+        out.resize(original);
+        return make_error_void(error_code_t::invalid_format,
+                               "Compound reply field count mismatch");
+    }
+    return make_ok();
+}
+
+// ============================================================================
+// scpi_batch_result_t - 批处理结果
+// ============================================================================
+
+/**
+ * @brief 批处理中各查询的响应
+ */
+class scpi_batch_result_t {
+public:
+    scpi_batch_result_t() = default;
+
+    explicit scpi_batch_result_t(std::vector<std::string> replies)
+        : m_replies(std::move(replies)) {
+    }
+
+    /**
+     * @brief 响应个数（等于批处理中的查询个数）
+     */
+    size_t size() const {
+        return m_replies.size();
+    }
+
+    /**
+     * @brief 获取原始响应文本
+     */
+    result_t<std::string> text(size_t index) const {
+        if (index >= m_replies.size()) {
+            return make_error<std::string>(error_code_t::out_of_range,
+                                           "Query index out of range");
+        }
+        return m_replies[index];
+    }
+
+    /**
+     * @brief 获取数值响应
+     */
+    result_t<double> as_double(size_t index) const {
+        if (index >= m_replies.size()) {
+            return make_error<double>(error_code_t::out_of_range,
+                                      "Query index out of range");
+        }
+        double value = 0.0;
+        if (!parse_double(m_replies[index], value)) {
+            return make_error<double>(error_code_t::invalid_format,
+                                      "Cannot convert to double");
+        }
+        return value;
+    }
+
+    /**
+     * @brief 获取整数响应（接受 "+401" 或 "4.01E+02" 形式）
+     */
+    result_t<int> as_int(size_t index) const {
+        auto value = as_double(index);
+        if (!value) {
+            return make_unexpected(value.error());
+        }
+        if (std::floor(*value) != *value ||
+            *value < static_cast<double>(std::numeric_limits<int>::min()) ||
+            *value > static_cast<double>(std::numeric_limits<int>::max())) {
+            return make_error<int>(error_code_t::invalid_format, "Cannot convert to int");
+        }
+        return static_cast<int>(*value);
+    }
+
+    /**
+     * @brief 获取布尔响应（1/0/ON/OFF）
+     */
+    result_t<bool> as_bool(size_t index) const {
+        if (index >= m_replies.size()) {
+            return make_error<bool>(error_code_t::out_of_range,
+                                    "Query index out of range");
+        }
+        std::string value = m_replies[index];
+        for (auto& c : value) {
+            if (c >= 'a' && c <= 'z') {
+                c = static_cast<char>(c - 'a' + 'A');
+            }
+        }
+        if (value == "1" || value == "ON") {
+            return true;
+        }
+        if (value == "0" || value == "OFF") {
+            return false;
+        }
+        return make_error<bool>(error_code_t::invalid_format, "Cannot convert to bool");
+    }
+
+private:
+    std::vector<std::string> m_replies;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_DEVICE_SCPI_BATCH_HPP
@@ -0,0 +1,211 @@
+/**
+ * @file scpi_format.hpp
+ * @brief 无分配的 SCPI 命令格式化
+ *
+ * 在固定大小的缓冲区中拼装命令文本，直接以 const_byte_span_t 交给传输层。
+ */
+
+#ifndef VDL_DEVICE_SCPI_FORMAT_HPP
+#define VDL_DEVICE_SCPI_FORMAT_HPP
+
+#include "../core/types.hpp"
+#include "../core/buffer.hpp"
+#include "../core/number_format.hpp"
+
+#include <cstring>
+#include <string>
+
+namespace vdl {
+
+// ============================================================================
+// scpi_command_buffer_t - 命令缓冲区
+// ============================================================================
+
+/**
+ * @brief 固定容量的 SCPI 命令缓冲区
+ *
+ * 所有 append 操作都不分配内存；空间不足时置溢出标志，之后的追加被忽略。
+ *
+ * @code
+ * scpi_command_buffer_t<> cmd;
+ * cmd.append("SENS:FREQ:STAR ").append_double(1e9).terminate();
+ * device.write_raw(cmd.span());
+ * @endcode
+ */
+template<size_t N = 256>
+class scpi_command_buffer_t {
+public:
+    scpi_command_buffer_t() = default;
+
+    scpi_command_buffer_t& append(const char* text, size_t len) {
+        if (m_overflow || m_buffer.size() + len > N) {
+            m_overflow = true;
+            return *this;
+        }
+        std::memcpy(m_buffer.data() + m_buffer.size(), text, len);
+        m_buffer.set_size(m_buffer.size() + len);
+        return *this;
+    }
+
+    scpi_command_buffer_t& append(const char* text) {
+        return append(text, std::strlen(text));
+    }
+
+    scpi_command_buffer_t& append(const std::string& text) {
+        return append(text.data(), text.size());
+    }
+
+    scpi_command_buffer_t& append_char(char c) {
+        return append(&c, 1);
+    }
+
+    scpi_command_buffer_t& append_int(int64_t value) {
+        char text[24];
+        return append(text, format_int(text, sizeof(text), value));
+    }
+
+    scpi_command_buffer_t& append_double(double value, int significant_digits = 15) {
+        char text[k_max_formatted_double];
+        const size_t len = format_double(text, sizeof(text), value, significant_digits);
+        if (len == 0) {
+            m_overflow = true;
+        }
+        return append(text, len);
+    }
+
+    /**
+     * @brief 追加程序消息终止符 '\n'（已存在时不重复追加）
+     */
+    scpi_command_buffer_t& terminate() {
+        if (m_buffer.empty() || m_buffer[m_buffer.size() - 1] != '\n') {
+            append_char('\n');
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 回退到指定长度（用于复用已写好的命令头）
+     */
+    void truncate(size_t size) {
+        if (size < m_buffer.size()) {
+            m_buffer.set_size(size);
+        }
+        m_overflow = false;
+    }
+
+    void clear() {
+        m_buffer.clear();
+        m_overflow = false;
+    }
+
+    size_t size() const { return m_buffer.size(); }
+    bool empty() const { return m_buffer.empty(); }
+    bool overflow() const { return m_overflow; }
+    static constexpr size_t capacity() { return N; }
+
+    const char* c_str_data() const {
+        return reinterpret_cast<const char*>(m_buffer.data());
+    }
+
+    const_byte_span_t span() const {
+        return m_buffer.as_span();
+    }
+
+private:
+    static_buffer_t<N> m_buffer;
+    bool m_overflow = false;
+};
+
+// ============================================================================
+// scpi_command_template_t - 预编译命令模板
+// ============================================================================
+
+/**
+ * @brief 预先写好命令头的参数化命令
+ *
+ * 构造时写入 "HEADER "，每次 format() 只追加参数和终止符，
+ * 适合逐点扫描中反复设置频率/功率。
+ *
+ * @code
+ * scpi_command_template_t set_freq("SENS:FREQ:CW");
+ * for (double f : points) {
+ *     scpi.send(set_freq, f);
+ * }
+ * @endcode
+ */
+class scpi_command_template_t {
+public:
+    static constexpr size_t k_capacity = 128;
+
+    explicit scpi_command_template_t(const std::string& header)
+        : m_header(header) {
+        m_buffer.append(header).append_char(' ');
+        m_prefix_size = m_buffer.size();
+        m_header_overflow = m_buffer.overflow();
+    }
+
+    /**
+     * @brief 格式化浮点参数
+     * @return 完整的命令（含 '\n'）；命令头过长时返回空 span
+     */
+    const_byte_span_t format(double value, int significant_digits = 15) {
+        m_buffer.truncate(m_prefix_size);
+        m_buffer.append_double(value, significant_digits).terminate();
+        return _result();
+    }
+
+    /**
+     * @brief 格式化整数参数
+     */
+    const_byte_span_t format(int64_t value) {
+        m_buffer.truncate(m_prefix_size);
+        m_buffer.append_int(value).terminate();
+        return _result();
+    }
+
+    const_byte_span_t format(int value) {
+        return format(static_cast<int64_t>(value));
+    }
+
+    /**
+     * @brief 格式化关键字参数（如 ON/OFF）
+     */
+    const_byte_span_t format(const char* keyword) {
+        m_buffer.truncate(m_prefix_size);
+        m_buffer.append(keyword).terminate();
+        return _result();
+    }
+
+    /**
+     * @brief 命令头（不含空格）
+     */
+    const std::string& header() const {
+        return m_header;
+    }
+
+    /**
+     * @brief 最近一次 format() 写入的参数文本 [argument_begin(), argument_end())
+     */
+    const char* argument_begin() const {
+        return m_buffer.c_str_data() + m_prefix_size;
+    }
+
+    const char* argument_end() const {
+        const size_t size = m_buffer.size();
+        return m_buffer.c_str_data() + (size > m_prefix_size ? size - 1 : m_prefix_size);
+    }
+
+private:
+    const_byte_span_t _result() const {
+        return (m_header_overflow || m_buffer.overflow()) ? const_byte_span_t() : m_buffer.span();
+    }
+
+    std::string m_header;
+    scpi_command_buffer_t<k_capacity> m_buffer;
+    size_t m_prefix_size = 0;
+    bool m_header_overflow = false;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_DEVICE_SCPI_FORMAT_HPP
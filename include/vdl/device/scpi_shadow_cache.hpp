@@ -0,0 +1,109 @@
+/**
+ * @file scpi_shadow_cache.hpp
+ * @brief SCPI 仪器设置影子缓存
+ *
+ * 记录本端写入的仪器设置，避免重复查询。
+ */
+
+#ifndef VDL_DEVICE_SCPI_SHADOW_CACHE_HPP
+#define VDL_DEVICE_SCPI_SHADOW_CACHE_HPP
+
+#include "../core/types.hpp"
+#include "../core/error.hpp"
+
+#include <map>
+#include <string>
+
+namespace vdl {
+
+// ============================================================================
+// scpi_shadow_cache_t - 影子缓存
+// ============================================================================
+
+/**
+ * @brief 按 SCPI 头（如 "SENS:FREQ:STAR"）索引的设置缓存
+ *
+ * 缓存与连接代数绑定：代数变化（重连）后所有条目失效。
+ * 头在存取时统一为大写，并去掉开头的 ':' 和结尾的 '?'。
+ *
+ * @note 仪器可能对写入值取整或限幅，需要精确值时使用 verify 模式
+ */
+class scpi_shadow_cache_t {
+public:
+    /**
+     * @brief 查找缓存值
+     * @param header SCPI 头
+     * @param generation 当前连接代数
+     */
+    optional_t<double> get(const std::string& header, uint64_t generation) {
+        _sync_generation(generation);
+        auto it = m_values.find(normalize_header(header));
+        if (it == m_values.end()) {
+            return optional_t<double>();
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief 写入缓存值
+     */
+    void put(const std::string& header, double value, uint64_t generation) {
+        _sync_generation(generation);
+        m_values[normalize_header(header)] = value;
+    }
+
+    /**
+     * @brief 清空所有条目
+     */
+    void invalidate() {
+        m_values.clear();
+    }
+
+    /**
+     * @brief 清除以 prefix 开头的条目（如 "SENS:FREQ" 清除所有频率设置）
+     */
+    void invalidate(const std::string& prefix) {
+        const std::string key = normalize_header(prefix);
+        auto it = m_values.lower_bound(key);
+        while (it != m_values.end() && it->first.compare(0, key.size(), key) == 0) {
+            it = m_values.erase(it);
+        }
+    }
+
+    size_t size() const {
+        return m_values.size();
+    }
+
+    /**
+     * @brief 规范化 SCPI 头
+     */
+    static std::string normalize_header(const std::string& header) {
+        size_t first = 0;
+        size_t last = header.size();
+        while (first < last && (header[first] == ':' || header[first] == ' ')) ++first;
+        while (last > first && (header[last - 1] == '?' || header[last - 1] == ' ')) --last;
+
+        std::string key = header.substr(first, last - first);
+        for (auto& c : key) {
+            if (c >= 'a' && c <= 'z') {
+                c = static_cast<char>(c - 'a' + 'A');
+            }
+        }
+        return key;
+    }
+
+private:
+    void _sync_generation(uint64_t generation) {
+        if (generation != m_generation) {
+            m_values.clear();
+            m_generation = generation;
+        }
+    }
+
+    std::map<std::string, double> m_values;
+    uint64_t m_generation = 0;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_DEVICE_SCPI_SHADOW_CACHE_HPP
@@ -0,0 +1,581 @@
+/**
+ * @file trace_file.hpp
+ * @brief 迹线存储（POSIX 内存映射文件）
+ *
+ * 长时间浸泡测试的迹线不经过 vector<pair<double, double>> 和二次序列化，
+ * 直接追加到预分配的内存映射文件：数据驻留在页缓存而不是进程堆中。
+ *
+ * 文件格式（主机字节序，定长记录）：
+ * - 文件头（4096 字节）：trace_file_header_t + 元数据文本（扫描设置等）
+ * - 频率轴：points 个 float64，按页对齐
+ * - 扫描记录 × capacity：64 字节记录头 + 数值列（实数为 points 个 float64，
+ *   复数为 points 对 re/im 交错的 float64，与 REAL,64 块和 SDAT 文本的顺序一致）
+ *
+ * 解析器和二进制块读取器通过 begin_sweep() 拿到映射内存中的数值列直接写入；
+ * 其他进程的 trace_file_reader_t 以只读方式映射同一文件，不复制即可读取。
+ *
+ * @code
+ * trace_file_config_t config;
+ * config.path = "/data/soak/s21.vdltrace";
+ * config.points = 401;
+ * config.sample = trace_sample_t::complex64;
+ * config.capacity = 100000;
+ * config.metadata = "S21 1-6 GHz IFBW 1 kHz";
+ *
+ * trace_file_writer_t writer;
+ * writer.open(config, frequencies);
+ *
+ * auto slot = writer.begin_sweep();
+ * auto n = scpi.query_real64_array("CALC:DATA? SDAT", slot->values);   // 块数据直接读入文件
+ * writer.commit_sweep(*n);
+ * @endcode
+ */
+
+#ifndef VDL_DEVICE_TRACE_FILE_HPP
+#define VDL_DEVICE_TRACE_FILE_HPP
+
+#include "../core/types.hpp"
+#include "../core/error.hpp"
+#include "../core/noncopyable.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace vdl {
+
+// ============================================================================
+// 文件格式
+// ============================================================================
+
+/**
+ * @brief 数值类型
+ */
+enum class trace_sample_t : uint32_t {
+    real64 = 1,       ///< 每点一个 float64
+    complex64 = 2     ///< 每点 re/im 两个 float64（交错排列）
+};
+
+constexpr uint64_t k_trace_file_magic = 0x3145434152544C44ull;   ///< 按小端存储为 "DLTRACE1"
+constexpr uint32_t k_trace_file_version = 1;
+constexpr size_t k_trace_file_header_size = 4096;
+constexpr size_t k_trace_record_header_size = 64;
+constexpr size_t k_trace_metadata_capacity = 2048;
+
+/**
+ * @brief 文件头（位于文件起始处）
+ */
+struct trace_file_header_t {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t header_size;          ///< 文件头长度（含元数据区）
+    uint64_t points;               ///< 每次扫描的点数
+    uint32_t sample;               ///< trace_sample_t
+    uint32_t flags;                ///< bit0：写满后覆盖最旧的记录
+    uint64_t record_size;          ///< 每条记录的字节数（含记录头，64 字节对齐）
+    uint64_t capacity;             ///< 记录槽数
+    uint64_t axis_offset;          ///< 频率轴的文件偏移
+    uint64_t data_offset;          ///< 第一条记录的文件偏移
+    int64_t created_ns;            ///< 创建时间（自 1970-01-01 起的纳秒）
+    uint64_t metadata_offset;      ///< 元数据文本的文件偏移
+    uint64_t metadata_size;        ///< 元数据文本长度
+    uint64_t committed;            ///< 已提交的扫描总数（写入方 release 存储，读取方 acquire 加载）
+};
+
+/**
+ * @brief 记录头
+ *
+ * 写入方先把 sequence 置 0 再写数值，写完后存入序号 + 1；
+ * 读取方在读取前后各检查一次 sequence，两次一致才说明读取期间没有被覆盖。
+ */
+struct trace_record_header_t {
+    uint64_t sequence;             ///< 扫描序号 + 1（0 表示空闲或正在写入）
+    int64_t timestamp_ns;          ///< 提交时间（自 1970-01-01 起的纳秒）
+    uint64_t value_count;          ///< 有效的 float64 个数
+    uint64_t reserved[5];
+};
+
+static_assert(sizeof(trace_file_header_t) <= k_trace_file_header_size - k_trace_metadata_capacity,
+              "trace file header overlaps metadata");
+static_assert(sizeof(trace_record_header_t) == k_trace_record_header_size,
+              "trace record header must be 64 bytes");
+
+namespace detail {
+
+inline size_t trace_align(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+inline size_t trace_values_per_record(uint64_t points, trace_sample_t sample) {
+    return static_cast<size_t>(points) * (sample == trace_sample_t::complex64 ? 2 : 1);
+}
+
+inline int64_t trace_now_ns() {
+    return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief 映射内存中的 64 位计数器按原子变量访问
+ */
+inline std::atomic<uint64_t>& trace_atomic(uint64_t& value) {
+    static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+                  "atomic<uint64_t> must be layout-compatible with uint64_t");
+    return reinterpret_cast<std::atomic<uint64_t>&>(value);
+}
+
+inline const std::atomic<uint64_t>& trace_atomic(const uint64_t& value) {
+    return reinterpret_cast<const std::atomic<uint64_t>&>(value);
+}
+
+}  // namespace detail
+
+// ============================================================================
+// trace_file_writer_t - 写入方
+// ============================================================================
+
+/**
+ * @brief 迹线文件配置
+ */
+struct trace_file_config_t {
+    std::string path;
+    size_t points = 0;                              ///< 每次扫描的点数
+    trace_sample_t sample = trace_sample_t::complex64;
+    size_t capacity = 1024;                         ///< 预分配的记录数
+    bool overwrite = false;                         ///< 写满后覆盖最旧的记录（环形）
+    std::string metadata;                           ///< 元数据文本（最长 k_trace_metadata_capacity）
+};
+
+/**
+ * @brief 正在写入的扫描记录
+ */
+struct trace_slot_t {
+    uint64_t sequence = 0;          ///< 扫描序号
+    span_t<double> values;          ///< 映射内存中的数值列
+};
+
+/**
+ * @brief 内存映射的迹线文件写入方
+ *
+ * 文件按 capacity 预分配，写入不再扩展文件。
+ *
+ * @note 非线程安全：同一时间只能有一个线程写入
+ */
+class trace_file_writer_t : private noncopyable_t, private nonmovable_t {
+public:
+    trace_file_writer_t() = default;
+
+    ~trace_file_writer_t() {
+        close();
+    }
+
+    /**
+     * @brief 创建（覆盖）文件并写入文件头和频率轴
+     * @param config 配置
+     * @param frequencies 频率轴（points 个值；为空时写零）
+     */
+    result_t<void> open(const trace_file_config_t& config, span_t<const double> frequencies) {
+        if (m_base) {
+            return make_error_void(error_code_t::already_initialized, "Trace file: already open");
+        }
+        if (config.path.empty() || config.points == 0 || config.capacity == 0) {
+            return make_error_void(error_code_t::invalid_argument,
+                                   "Trace file: path, points and capacity are required");
+        }
+        if (!frequencies.empty() && frequencies.size() != config.points) {
+            return make_error_void(error_code_t::invalid_size,
+                                   "Trace file: frequency axis does not match point count");
+        }
+        if (config.metadata.size() > k_trace_metadata_capacity) {
+            return make_error_void(error_code_t::invalid_size, "Trace file: metadata too long");
+        }
+
+        const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        const size_t values = detail::trace_values_per_record(config.points, config.sample);
+        const size_t record_size = detail::trace_align(
+            k_trace_record_header_size + values * sizeof(double), 64);
+        const size_t axis_offset = detail::trace_align(k_trace_file_header_size, page);
+        const size_t data_offset = detail::trace_align(axis_offset + config.points * sizeof(double),
+                                                       page);
+        if (config.capacity > (static_cast<size_t>(-1) - data_offset) / record_size) {
+            return make_error_void(error_code_t::invalid_size, "Trace file: capacity too large");
+        }
+        const size_t size = data_offset + record_size * config.capacity;
+
+        const int fd = ::open(config.path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return make_error_void(errno == EACCES ? error_code_t::file_access_denied
+                                                   : error_code_t::io_error,
+                                   "Trace file: cannot create file");
+        }
+        const off_t length = static_cast<off_t>(size);
+        if (::posix_fallocate(fd, 0, length) != 0 && ::ftruncate(fd, length) != 0) {
+            ::close(fd);
+            return make_error_void(error_code_t::io_error, "Trace file: cannot preallocate file");
+        }
+        void* base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            return make_error_void(error_code_t::io_error, "Trace file: mmap failed");
+        }
+
+        m_base = static_cast<uint8_t*>(base);
+        m_size = size;
+        m_values = values;
+
+        trace_file_header_t* header = _header();
+        std::memset(header, 0, sizeof(*header));
+        header->magic = k_trace_file_magic;
+        header->version = k_trace_file_version;
+        header->header_size = static_cast<uint32_t>(k_trace_file_header_size);
+        header->points = config.points;
+        header->sample = static_cast<uint32_t>(config.sample);
+        header->flags = config.overwrite ? 1u : 0u;
+        header->record_size = record_size;
+        header->capacity = config.capacity;
+        header->axis_offset = axis_offset;
+        header->data_offset = data_offset;
+        header->created_ns = detail::trace_now_ns();
+        header->metadata_offset = k_trace_file_header_size - k_trace_metadata_capacity;
+        header->metadata_size = config.metadata.size();
+        std::memcpy(m_base + header->metadata_offset, config.metadata.data(),
+                    config.metadata.size());
+
+        double* axis = reinterpret_cast<double*>(m_base + axis_offset);
+        if (frequencies.empty()) {
+            std::memset(axis, 0, config.points * sizeof(double));
+        } else {
+            std::memcpy(axis, frequencies.data(), config.points * sizeof(double));
+        }
+
+        m_next = 0;
+        m_open_slot = false;
+        detail::trace_atomic(header->committed).store(0, std::memory_order_release);
+        return make_ok();
+    }
+
+    /**
+     * @brief 同步到磁盘并解除映射
+     */
+    void close() {
+        if (!m_base) {
+            return;
+        }
+        ::msync(m_base, m_size, MS_SYNC);
+        ::munmap(m_base, m_size);
+        m_base = nullptr;
+        m_size = 0;
+        m_open_slot = false;
+    }
+
+    bool is_open() const {
+        return m_base != nullptr;
+    }
+
+    // ========================================================================
+    // 写入
+    // ========================================================================
+
+    /**
+     * @brief 取得下一条记录的数值列（零拷贝写入）
+     * @return 文件已满且未开启覆盖时返回 out_of_range
+     *
+     * 未提交的记录会在下一次 begin_sweep() 时被重新使用。
+     */
+    result_t<trace_slot_t> begin_sweep() {
+        if (!m_base) {
+            return make_error<trace_slot_t>(error_code_t::invalid_state, "Trace file: not open");
+        }
+        const trace_file_header_t* header = _header();
+        if (m_next >= header->capacity && (header->flags & 1u) == 0) {
+            return make_error<trace_slot_t>(error_code_t::out_of_range, "Trace file: full");
+        }
+
+        trace_record_header_t* record = _record(m_next);
+        detail::trace_atomic(record->sequence).store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_open_slot = true;
+
+        trace_slot_t slot;
+        slot.sequence = m_next;
+        slot.values = span_t<double>(_values(record), m_values);
+        return slot;
+    }
+
+    /**
+     * @brief 提交 begin_sweep() 取得的记录
+     * @param value_count 写入的 float64 个数（不超过数值列长度）
+     */
+    result_t<void> commit_sweep(size_t value_count) {
+        if (!m_open_slot) {
+            return make_error_void(error_code_t::invalid_state, "Trace file: no open sweep");
+        }
+        if (value_count > m_values) {
+            return make_error_void(error_code_t::invalid_size, "Trace file: too many values");
+        }
+        trace_record_header_t* record = _record(m_next);
+        record->timestamp_ns = detail::trace_now_ns();
+        record->value_count = value_count;
+        detail::trace_atomic(record->sequence).store(m_next + 1, std::memory_order_release);
+
+        ++m_next;
+        m_open_slot = false;
+        detail::trace_atomic(_header()->committed).store(m_next, std::memory_order_release);
+        return make_ok();
+    }
+
+    /**
+     * @brief 复制一次扫描的数值并提交
+     */
+    result_t<void> append(span_t<const double> values) {
+        if (values.size() > m_values) {
+            return make_error_void(error_code_t::invalid_size, "Trace file: too many values");
+        }
+        auto slot = begin_sweep();
+        if (!slot) {
+            return make_error_void(slot.error());
+        }
+        if (!values.empty()) {
+            std::memcpy(slot->values.data(), values.data(), values.size() * sizeof(double));
+        }
+        return commit_sweep(values.size());
+    }
+
+    /**
+     * @brief 把已写入的数据刷到磁盘（异步）
+     */
+    result_t<void> flush() {
+        if (!m_base) {
+            return make_error_void(error_code_t::invalid_state, "Trace file: not open");
+        }
+        if (::msync(m_base, m_size, MS_ASYNC) != 0) {
+            return make_error_void(error_code_t::io_error, "Trace file: msync failed");
+        }
+        return make_ok();
+    }
+
+    uint64_t committed() const {
+        return m_base ? m_next : 0;
+    }
+
+    size_t values_per_sweep() const {
+        return m_values;
+    }
+
+private:
+    trace_file_header_t* _header() const {
+        return reinterpret_cast<trace_file_header_t*>(m_base);
+    }
+
+    trace_record_header_t* _record(uint64_t sequence) const {
+        const trace_file_header_t* header = _header();
+        const uint64_t index = sequence % header->capacity;
+        return reinterpret_cast<trace_record_header_t*>(
+            m_base + header->data_offset + index * header->record_size);
+    }
+
+    static double* _values(trace_record_header_t* record) {
+        return reinterpret_cast<double*>(reinterpret_cast<uint8_t*>(record) +
+                                         k_trace_record_header_size);
+    }
+
+    uint8_t* m_base = nullptr;
+    size_t m_size = 0;
+    size_t m_values = 0;             ///< 每条记录的 float64 个数
+    uint64_t m_next = 0;             ///< 下一条记录的序号
+    bool m_open_slot = false;
+};
+
+// ============================================================================
+// trace_file_reader_t - 读取方
+// ============================================================================
+
+/**
+ * @brief 一次扫描的只读视图（指向映射内存）
+ */
+struct trace_view_t {
+    uint64_t sequence = 0;
+    int64_t timestamp_ns = 0;
+    span_t<const double> values;
+};
+
+/**
+ * @brief 只读映射迹线文件（可在写入进程运行期间打开）
+ */
+class trace_file_reader_t : private noncopyable_t {
+public:
+    trace_file_reader_t() = default;
+
+    ~trace_file_reader_t() {
+        close();
+    }
+
+    result_t<void> open(const std::string& path) {
+        close();
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return make_error_void(errno == ENOENT ? error_code_t::file_not_found
+                                                   : error_code_t::file_access_denied,
+                                   "Trace file: cannot open file");
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 ||
+            info.st_size < static_cast<off_t>(k_trace_file_header_size)) {
+            ::close(fd);
+            return make_error_void(error_code_t::invalid_format, "Trace file: file too short");
+        }
+        const size_t size = static_cast<size_t>(info.st_size);
+        void* base = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            return make_error_void(error_code_t::io_error, "Trace file: mmap failed");
+        }
+        m_base = static_cast<const uint8_t*>(base);
+        m_size = size;
+
+        const trace_file_header_t& h = header();
+        const bool sample_valid = h.sample == static_cast<uint32_t>(trace_sample_t::real64) ||
+                                  h.sample == static_cast<uint32_t>(trace_sample_t::complex64);
+        if (h.magic != k_trace_file_magic || h.version != k_trace_file_version || !sample_valid ||
+            h.record_size < k_trace_record_header_size || h.capacity == 0 ||
+            h.data_offset + h.record_size * h.capacity > size ||
+            h.axis_offset + h.points * sizeof(double) > h.data_offset ||
+            h.metadata_offset + h.metadata_size > k_trace_file_header_size) {
+            close();
+            return make_error_void(error_code_t::invalid_format, "Trace file: not a VDL trace file");
+        }
+        return make_ok();
+    }
+
+    void close() {
+        if (m_base) {
+            ::munmap(const_cast<uint8_t*>(m_base), m_size);
+        }
+        m_base = nullptr;
+        m_size = 0;
+    }
+
+    bool is_open() const {
+        return m_base != nullptr;
+    }
+
+    const trace_file_header_t& header() const {
+        return *reinterpret_cast<const trace_file_header_t*>(m_base);
+    }
+
+    size_t points() const {
+        return static_cast<size_t>(header().points);
+    }
+
+    trace_sample_t sample() const {
+        return static_cast<trace_sample_t>(header().sample);
+    }
+
+    span_t<const double> frequencies() const {
+        return span_t<const double>(
+            reinterpret_cast<const double*>(m_base + header().axis_offset), points());
+    }
+
+    std::string metadata() const {
+        const trace_file_header_t& h = header();
+        return std::string(reinterpret_cast<const char*>(m_base + h.metadata_offset),
+                           static_cast<size_t>(h.metadata_size));
+    }
+
+    /**
+     * @brief 已提交的扫描总数
+     */
+    uint64_t committed() const {
+        return detail::trace_atomic(header().committed).load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief 仍保存在文件中的最早序号（覆盖模式下旧记录会被挤掉）
+     */
+    uint64_t first_available() const {
+        const uint64_t total = committed();
+        const uint64_t capacity = header().capacity;
+        return total > capacity ? total - capacity : 0;
+    }
+
+    /**
+     * @brief 零拷贝访问一次扫描
+     * @return 序号尚未提交或已被覆盖时返回 out_of_range
+     *
+     * 覆盖模式下视图可能在使用期间被改写，用完后以 still_valid() 确认。
+     */
+    result_t<trace_view_t> sweep(uint64_t sequence) const {
+        if (sequence < first_available() || sequence >= committed()) {
+            return make_error<trace_view_t>(error_code_t::out_of_range,
+                                            "Trace file: sweep not available");
+        }
+        const trace_record_header_t* record = _record(sequence);
+        if (detail::trace_atomic(record->sequence).load(std::memory_order_acquire) != sequence + 1) {
+            return make_error<trace_view_t>(error_code_t::out_of_range,
+                                            "Trace file: sweep overwritten");
+        }
+        trace_view_t view;
+        view.sequence = sequence;
+        view.timestamp_ns = record->timestamp_ns;
+        const size_t capacity = detail::trace_values_per_record(header().points, sample());
+        const size_t count = record->value_count < capacity
+            ? static_cast<size_t>(record->value_count) : capacity;
+        view.values = span_t<const double>(_values(record), count);
+        return view;
+    }
+
+    /**
+     * @brief 视图对应的记录是否仍未被覆盖
+     */
+    bool still_valid(const trace_view_t& view) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return detail::trace_atomic(_record(view.sequence)->sequence)
+                   .load(std::memory_order_relaxed) == view.sequence + 1;
+    }
+
+    /**
+     * @brief 复制一次扫描（覆盖模式下保证得到的是完整的一次扫描）
+     * @return 成功返回复制的 float64 个数
+     */
+    result_t<size_t> copy_sweep(uint64_t sequence, span_t<double> out) const {
+        auto view = sweep(sequence);
+        if (!view) {
+            return make_unexpected(view.error());
+        }
+        if (out.size() < view->values.size()) {
+            return make_error<size_t>(error_code_t::invalid_size,
+                                      "Trace file: output buffer too small");
+        }
+        std::memcpy(out.data(), view->values.data(), view->values.size() * sizeof(double));
+        if (!still_valid(*view)) {
+            return make_error<size_t>(error_code_t::out_of_range, "Trace file: sweep overwritten");
+        }
+        return view->values.size();
+    }
+
+private:
+    const trace_record_header_t* _record(uint64_t sequence) const {
+        const trace_file_header_t& h = header();
+        return reinterpret_cast<const trace_record_header_t*>(
+            m_base + h.data_offset + (sequence % h.capacity) * h.record_size);
+    }
+
+    static const double* _values(const trace_record_header_t* record) {
+        return reinterpret_cast<const double*>(reinterpret_cast<const uint8_t*>(record) +
+                                               k_trace_record_header_size);
+    }
+
+    const uint8_t* m_base = nullptr;
+    size_t m_size = 0;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_DEVICE_TRACE_FILE_HPP
@@ -0,0 +1,298 @@
+/**
+ * @file unsolicited_dispatcher.hpp
+ * @brief 主动上报帧的订阅与分发
+ *
+ * 接收泵把不属于任何在途请求的帧通过无锁队列交给分发线程，
+ * 分发线程按功能码调用订阅者回调，接收泵永远不会被用户代码阻塞。
+ */
+
+#ifndef VDL_DEVICE_UNSOLICITED_DISPATCHER_HPP
+#define VDL_DEVICE_UNSOLICITED_DISPATCHER_HPP
+
+#include "../core/types.hpp"
+#include "../core/noncopyable.hpp"
+#include "../core/spsc_queue.hpp"
+#include "../core/logging.hpp"
+#include "../protocol/response.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace vdl {
+
+/**
+ * @brief 主动上报帧回调（在分发线程中执行）
+ */
+using unsolicited_callback_t = std::function<void(const response_t&)>;
+
+/**
+ * @brief 订阅标识（0 表示无效）
+ */
+using subscription_id_t = uint64_t;
+
+// ============================================================================
+// unsolicited_dispatcher_t - 主动上报帧分发器
+// ============================================================================
+
+/**
+ * @brief 主动上报帧分发器
+ *
+ * - post() 只能由接收泵一个线程调用，无锁且不阻塞；队列满时丢弃并计数
+ * - 订阅者按功能码过滤，subscribe_all() 接收所有主动上报帧
+ * - 首次订阅时启动分发线程，回调中可以安全地订阅或取消订阅
+ * - claims() 供接收泵判断某个功能码是否有订阅者（无锁）
+ *
+ * @code
+ * unsolicited_dispatcher_t dispatcher;
+ * dispatcher.subscribe(0x41, [](const response_t& status) {
+ *     std::cout << "status: " << status.data().size() << " bytes" << std::endl;
+ * });
+ *
+ * // 接收泵线程
+ * dispatcher.post(std::move(frame));
+ * @endcode
+ */
+class unsolicited_dispatcher_t : private noncopyable_t, private nonmovable_t {
+public:
+    /**
+     * @brief 构造函数
+     * @param queue_capacity 待分发帧的最大数量
+     */
+    explicit unsolicited_dispatcher_t(size_t queue_capacity = k_default_queue_capacity)
+        : m_queue(queue_capacity) {
+        for (auto& count : m_claims) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ~unsolicited_dispatcher_t() {
+        stop();
+    }
+
+    // ========================================================================
+    // 订阅（任意线程）
+    // ========================================================================
+
+    /**
+     * @brief 订阅指定功能码的主动上报帧
+     * @return 订阅标识，用于 unsubscribe()
+     */
+    subscription_id_t subscribe(uint8_t function_code, unsolicited_callback_t callback) {
+        return _add(true, function_code, std::move(callback));
+    }
+
+    /**
+     * @brief 订阅所有主动上报帧
+     */
+    subscription_id_t subscribe_all(unsolicited_callback_t callback) {
+        return _add(false, 0, std::move(callback));
+    }
+
+    /**
+     * @brief 取消订阅
+     * @return 标识有效时返回 true
+     */
+    bool unsubscribe(subscription_id_t id) {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        for (auto it = m_subscribers.begin(); it != m_subscribers.end(); ++it) {
+            if ((*it)->id == id) {
+                if ((*it)->filtered) {
+                    m_claims[(*it)->function_code].fetch_sub(1, std::memory_order_relaxed);
+                }
+                m_subscribers.erase(it);
+                m_subscriber_count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 是否有订阅者
+     */
+    bool has_subscribers() const {
+        return m_subscriber_count.load(std::memory_order_relaxed) > 0;
+    }
+
+    /**
+     * @brief 是否有订阅者按功能码订阅了该帧
+     *
+     * 按顺序匹配的协议中，接收泵据此区分主动上报帧和请求的响应。
+     */
+    bool claims(uint8_t function_code) const {
+        return m_claims[function_code].load(std::memory_order_relaxed) > 0;
+    }
+
+    // ========================================================================
+    // 投递（接收泵线程）
+    // ========================================================================
+
+    /**
+     * @brief 投递一个主动上报帧
+     * @return 无订阅者或队列已满时返回 false（帧被丢弃）
+     */
+    bool post(response_t frame) {
+        if (!has_subscribers()) {
+            return false;
+        }
+        if (!m_queue.try_push(std::move(frame))) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        // 只有分发线程已准备休眠时才需要加锁唤醒；
+        // 两侧的全序栅栏保证“入队后读标志”和“置标志后读队列”至少一方看到对方
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleeping.exchange(false)) {
+            std::lock_guard<std::mutex> guard(m_wake_mutex);
+            m_wake.notify_one();
+        }
+        return true;
+    }
+
+    /**
+     * @brief 因队列已满被丢弃的帧数
+     */
+    uint64_t dropped_count() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 已交给订阅者的帧数
+     */
+    uint64_t delivered_count() const {
+        return m_delivered.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 停止分发线程（队列中未分发的帧被丢弃）
+     *
+     * 在回调中调用时分发线程在回调返回后退出。
+     */
+    void stop() {
+        std::thread worker;
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_stopped = true;
+            worker.swap(m_thread);
+        }
+        {
+            std::lock_guard<std::mutex> guard(m_wake_mutex);
+            m_running.store(false, std::memory_order_release);
+            m_wake.notify_one();
+        }
+        if (worker.joinable()) {
+            if (worker.get_id() == std::this_thread::get_id()) {
+                worker.detach();
+            } else {
+                worker.join();
+            }
+        }
+    }
+
+private:
+    struct subscriber_t {
+        subscription_id_t id;
+        bool filtered;                        ///< false 表示接收所有功能码
+        uint8_t function_code;
+        unsolicited_callback_t callback;
+    };
+
+    using subscriber_ptr_t = std::shared_ptr<subscriber_t>;
+
+    static constexpr size_t k_default_queue_capacity = 256;
+
+    subscription_id_t _add(bool filtered, uint8_t function_code,
+                           unsolicited_callback_t callback) {
+        if (!callback) {
+            return 0;
+        }
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (m_stopped) {
+            return 0;
+        }
+
+        subscriber_ptr_t sub = std::make_shared<subscriber_t>();
+        sub->id = ++m_next_id;
+        sub->filtered = filtered;
+        sub->function_code = function_code;
+        sub->callback = std::move(callback);
+        m_subscribers.push_back(sub);
+        if (filtered) {
+            m_claims[function_code].fetch_add(1, std::memory_order_relaxed);
+        }
+        m_subscriber_count.fetch_add(1, std::memory_order_relaxed);
+
+        if (!m_thread.joinable()) {
+            m_running.store(true, std::memory_order_release);
+            m_thread = std::thread([this] { _run(); });
+        }
+        return sub->id;
+    }
+
+    void _run() {
+        response_t frame;
+        std::vector<subscriber_ptr_t> targets;
+        while (m_running.load(std::memory_order_acquire)) {
+            if (m_queue.try_pop(frame)) {
+                _deliver(frame, targets);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            m_sleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // 声明休眠后再检查一次，避免错过生产者的唤醒
+            if (m_queue.empty() && m_running.load(std::memory_order_acquire)) {
+                m_wake.wait(lock);
+            }
+            m_sleeping.store(false);
+        }
+    }
+
+    void _deliver(const response_t& frame, std::vector<subscriber_ptr_t>& targets) {
+        targets.clear();
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            for (const auto& sub : m_subscribers) {
+                if (!sub->filtered || sub->function_code == frame.function_code()) {
+                    targets.push_back(sub);
+                }
+            }
+        }
+        if (targets.empty()) {
+            return;
+        }
+        // 不持锁调用，回调可以订阅或取消订阅
+        for (const auto& sub : targets) {
+            sub->callback(frame);
+        }
+        m_delivered.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    spsc_queue_t<response_t> m_queue;
+    std::atomic<uint32_t> m_claims[256];
+    std::atomic<size_t> m_subscriber_count{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_delivered{0};
+
+    std::mutex m_mutex;                           ///< 保护订阅者列表和线程句柄
+    std::vector<subscriber_ptr_t> m_subscribers;
+    subscription_id_t m_next_id = 0;
+    bool m_stopped = false;
+    std::thread m_thread;
+
+    std::mutex m_wake_mutex;                      ///< 仅用于分发线程休眠
+    std::condition_variable m_wake;
+    std::atomic<bool> m_sleeping{false};
+    std::atomic<bool> m_running{false};
+};
+
+}  // namespace vdl
+
+#endif  // VDL_DEVICE_UNSOLICITED_DISPATCHER_HPP
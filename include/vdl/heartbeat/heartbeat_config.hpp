@@ -49,8 +49,8 @@ struct heartbeat_config_t {
     /**
      * @brief 独占期间是否暂停心跳
      * 
-     * 当设备被独占锁定（device_guard）时，是否暂停心跳检测。
-     * 这避免了心跳与命令执行的冲突。
+     * 当设备被独占锁定（device_lock_t）或正在执行命令时，是否跳过本次心跳。
+     * 这避免了心跳插入到多步传输中间，也不会让心跳排队阻塞。
      * 默认: true
      */
     bool pause_during_lock = true;
@@ -62,6 +62,45 @@ struct heartbeat_config_t {
      * 默认: true
      */
     bool auto_reset_failures = true;
+
+    /**
+     * @brief 仅在空闲时发送心跳
+     * 
+     * 设备在 interval 内有成功的应用流量时不发送心跳，
+     * 该流量按一次心跳成功计入计数器和回调；
+     * 空闲满 interval 后才发送心跳。
+     * 默认: false
+     */
+    bool idle_only = false;
+
+    /**
+     * @brief 自适应超时
+     * 
+     * 根据心跳往返时间的平滑估计（RFC 6298 的 RTO）设置单次心跳超时，
+     * 并限制在 [min_timeout, max_timeout] 内；尚无样本时使用 timeout。
+     * 默认: false
+     */
+    bool adaptive_timeout = false;
+
+    /**
+     * @brief 自适应超时下限（毫秒）
+     * 默认: 10ms
+     */
+    milliseconds_t min_timeout = 10;
+
+    /**
+     * @brief 自适应超时上限（毫秒）
+     * 默认: 5000ms
+     */
+    milliseconds_t max_timeout = 5000;
+
+    /**
+     * @brief 自适应间隔倍数
+     * 
+     * 大于 0 时心跳间隔至少为 factor × RTO，慢链路上的心跳自动变稀疏。
+     * 默认: 0（固定使用 interval）
+     */
+    uint8_t rtt_interval_factor = 0;
 };
 
 }  // namespace vdl
@@ -2,7 +2,7 @@
  * @file heartbeat_runner.hpp
  * @brief 心跳运行器
  * 
- * 在独立线程中定期执行心跳检测。
+ * 在共享的心跳调度器上定期执行心跳检测。
  */
 
 #ifndef VDL_HEARTBEAT_HEARTBEAT_RUNNER_HPP
@@ -10,14 +10,16 @@
 
 #include "heartbeat_config.hpp"
 #include "heartbeat_strategy.hpp"
+#include "heartbeat_scheduler.hpp"
+#include "rtt_estimator.hpp"
 #include "../device/device.hpp"
+#include "../device/execution_observer.hpp"
 #include "../core/types.hpp"
 #include "../core/error.hpp"
+#include "../core/event_dispatcher.hpp"
 
-#include <thread>
 #include <atomic>
 #include <mutex>
-#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <chrono>
@@ -37,7 +39,8 @@ enum class heartbeat_event_t : uint8_t {
     max_failures = 2,    ///< 达到最大失败次数
     paused = 3,          ///< 心跳已暂停
     resumed = 4,         ///< 心跳已恢复
-    stopped = 5          ///< 心跳已停止
+    stopped = 5,         ///< 心跳已停止
+    skipped = 6          ///< 设备被占用，本次心跳跳过
 };
 
 /**
@@ -61,7 +64,10 @@ using heartbeat_callback_t = std::function<void(
 /**
  * @brief 心跳运行器
  * 
- * 在独立线程中定期执行心跳检测，监控设备连接状态。
+ * 定期执行心跳检测，监控设备连接状态。
+ * 
+ * 运行器不拥有线程：心跳作为周期任务登记在 heartbeat_scheduler_t 上，
+ * 由调度器的工作线程执行。默认使用进程级共享调度器。
  * 
  * 功能：
  * 1. 定期发送心跳命令
@@ -111,10 +117,25 @@ public:
         const heartbeat_config_t& config = heartbeat_config_t()
     );
 
+    /**
+     * @brief 构造函数（指定调度器）
+     * 
+     * @param device 设备引用
+     * @param strategy 心跳策略
+     * @param config 心跳配置
+     * @param scheduler 执行心跳的调度器（生命周期须长于运行器）
+     */
+    heartbeat_runner_t(
+        i_device_t& device,
+        heartbeat_strategy_ptr_t strategy,
+        const heartbeat_config_t& config,
+        heartbeat_scheduler_t& scheduler
+    );
+
     /**
      * @brief 析构函数
      * 
-     * 自动停止心跳线程（如果正在运行）。
+     * 自动停止心跳（如果正在运行）。
      */
     ~heartbeat_runner_t();
 
@@ -134,16 +155,16 @@ public:
     /**
      * @brief 停止心跳检测
      * 
-     * 等待后台线程完成并关闭。
+     * 从调度器注销心跳任务。
      * 
-     * @note 阻塞，直到线程完全停止
+     * @note 阻塞，直到正在执行的心跳完成
      */
     void stop();
 
     /**
      * @brief 暂停心跳检测
      * 
-     * 暂停后不再发送心跳，但线程仍在运行。
+     * 暂停后不再发送心跳，但任务仍在调度器上。
      * 调用 resume() 可以恢复。
      */
     void pause();
@@ -247,6 +268,45 @@ public:
         return m_total_failures.load();
     }
 
+    /**
+     * @brief 获取因设备被占用而跳过的心跳次数
+     */
+    uint64_t skipped_count() const {
+        return m_skipped_count.load();
+    }
+
+    /**
+     * @brief 心跳往返时间统计（微秒）
+     */
+    rtt_stats_t rtt_stats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_rtt.snapshot();
+    }
+
+    /**
+     * @brief 清除往返时间估计
+     */
+    void reset_rtt() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_rtt.reset();
+    }
+
+    /**
+     * @brief 下一次心跳使用的超时（adaptive_timeout 生效时由 RTO 推导）
+     */
+    milliseconds_t effective_timeout() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return _effective_timeout_locked(m_config);
+    }
+
+    /**
+     * @brief 下一次心跳使用的间隔（rtt_interval_factor 生效时可能大于 interval）
+     */
+    milliseconds_t effective_interval() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return _effective_interval_locked(m_config);
+    }
+
     /**
      * @brief 重置计数器
      */
@@ -254,6 +314,7 @@ public:
         m_failure_count.store(0);
         m_success_count.store(0);
         m_total_failures.store(0);
+        m_skipped_count.store(0);
     }
 
     /**
@@ -272,13 +333,29 @@ public:
      * 
      * @param callback 回调函数
      * 
-     * @note 回调函数在心跳线程中执行，应该快速完成
+     * @note 回调函数默认在调度器的工作线程中执行（不持有运行器的锁），应该快速完成；
+     *       慢回调请配合 set_event_dispatcher() 使用
      */
     void set_callback(heartbeat_callback_t callback) {
         std::lock_guard<std::mutex> lock(m_mutex);
         m_callback = callback;
     }
 
+    /**
+     * @brief 通过事件分发器异步执行回调
+     * 
+     * @param dispatcher 分发器（nullptr 表示在心跳线程中直接执行）
+     * @param coalesce_success 合并尚未执行的连续 success 事件
+     * 
+     * @note stop() 会等待已投递的事件执行完，之后不再有回调
+     */
+    void set_event_dispatcher(event_dispatcher_t* dispatcher, bool coalesce_success = false) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_dispatcher = dispatcher;
+        m_success_flag = coalesce_success ? event_dispatcher_t::make_coalesce_flag()
+                                          : event_dispatcher_t::coalesce_flag_t();
+    }
+
     /**
      * @brief 移除回调
      */
@@ -287,6 +364,19 @@ public:
         m_callback = nullptr;
     }
 
+    /**
+     * @brief 挂接执行观察者
+     *
+     * 每次实际发送的心跳产生一个 heartbeat 区间（跳过的心跳不产生），
+     * 设备上挂接的观察者另外看到内层的 execute 区间。
+     *
+     * @param observer 观察者（nullptr 表示卸下）
+     */
+    void set_execution_observer(execution_observer_ptr_t observer) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_observer = std::move(observer);
+    }
+
     /**
      * @brief 获取策略名称
      */
@@ -300,9 +390,26 @@ private:
     // ========================================================================
 
     /**
-     * @brief 运行循环（后台线程）
+     * @brief 调度器回调：执行一次心跳
+     * 
+     * @return 下一次心跳的延迟，负数表示结束
+     */
+    milliseconds_t _tick();
+
+    /**
+     * @brief idle_only 模式：判断是否有新的应用流量
+     * 
+     * @param config 当前配置
+     * @param next_delay [out] 有流量时到下一次空闲检查的延迟
+     * @return true 表示本次以应用流量代替心跳
      */
-    void _run_loop();
+    bool _recent_traffic(const heartbeat_config_t& config, milliseconds_t& next_delay);
+
+    /**
+     * @brief 由 RTT 估计推导超时/间隔（调用者持有 m_mutex）
+     */
+    milliseconds_t _effective_timeout_locked(const heartbeat_config_t& config) const;
+    milliseconds_t _effective_interval_locked(const heartbeat_config_t& config) const;
 
     /**
      * @brief 执行一次心跳检测
@@ -311,6 +418,11 @@ private:
      */
     bool _do_heartbeat();
 
+    /**
+     * @brief 记录一次心跳结果并触发相应回调
+     */
+    void _record_result(bool success, const heartbeat_config_t& config);
+
     /**
      * @brief 触发事件回调
      */
@@ -329,7 +441,8 @@ private:
     heartbeat_config_t m_config;
     heartbeat_callback_t m_callback;
 
-    std::unique_ptr<std::thread> m_thread;
+    heartbeat_scheduler_t& m_scheduler;
+    heartbeat_scheduler_t::task_id_t m_task_id = 0;
     std::atomic<bool> m_running{false};
     std::atomic<bool> m_paused{false};
     std::atomic<bool> m_stop_requested{false};
@@ -337,10 +450,17 @@ private:
     std::atomic<uint8_t> m_failure_count{0};
     std::atomic<uint64_t> m_success_count{0};
     std::atomic<uint64_t> m_total_failures{0};
+    std::atomic<uint64_t> m_skipped_count{0};
+
+    optional_t<command_t> m_cached_command;   ///< 复用的心跳命令（仅心跳任务访问）
+    std::chrono::steady_clock::time_point m_seen_activity;  ///< 已计入的设备活动时间（仅心跳任务访问）
+    rtt_estimator_t m_rtt;                    ///< 心跳往返时间估计（受 m_mutex 保护）
+    event_dispatcher_t* m_dispatcher = nullptr;             ///< 异步回调分发器（受 m_mutex 保护）
+    event_dispatcher_t::coalesce_flag_t m_success_flag;     ///< success 事件合并标志（受 m_mutex 保护）
+    execution_observer_ptr_t m_observer;                    ///< 心跳区间观察者（受 m_mutex 保护）
 
     error_t m_last_error;
     mutable std::mutex m_mutex;
-    std::condition_variable m_cv;
 };
 
 }  // namespace vdl
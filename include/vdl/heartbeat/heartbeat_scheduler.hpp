@@ -0,0 +1,164 @@
+/**
+ * @file heartbeat_scheduler.hpp
+ * @brief 共享心跳调度器
+ *
+ * 一个哈希时间轮线程 + 工作线程池承载任意数量的心跳运行器，
+ * 替代每个运行器一个线程的模型。
+ */
+
+#ifndef VDL_HEARTBEAT_HEARTBEAT_SCHEDULER_HPP
+#define VDL_HEARTBEAT_HEARTBEAT_SCHEDULER_HPP
+
+#include "../core/types.hpp"
+#include "../core/noncopyable.hpp"
+#include "../core/thread_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace vdl {
+
+// ============================================================================
+// heartbeat_scheduler_config_t - 调度器配置
+// ============================================================================
+
+/**
+ * @brief 心跳调度器配置
+ */
+struct heartbeat_scheduler_config_t {
+    size_t worker_count = 0;            ///< 执行心跳的工作线程数（0 表示随已登记任务数增长）
+    size_t max_workers = 64;            ///< worker_count 为 0 时工作线程数的上限
+    milliseconds_t tick = 10;           ///< 时间轮刻度（定时精度）
+    size_t wheel_size = 256;            ///< 时间轮槽数（向上取整为 2 的幂）
+    bool jitter_start = true;           ///< 首次触发在 [0, interval) 内随机错开，分散负载
+};
+
+// ============================================================================
+// heartbeat_scheduler_t - 哈希时间轮调度器
+// ============================================================================
+
+/**
+ * @brief 心跳调度器
+ *
+ * - 时间轮线程按刻度推进，只负责把到期任务交给工作线程池
+ * - 任务返回下一次触发的延迟（负数表示不再触发），执行期间不在轮上，
+ *   因此同一任务不会并发执行，慢设备也不会堆积
+ * - 没有任务时时间轮线程休眠，不产生空转唤醒
+ * - 心跳是会超时的阻塞查询：默认每登记一个任务增加一个工作线程（直到 max_workers），
+ *   无响应设备占住的线程不会让其他设备的心跳排队；固定 worker_count 时需自行保证足够
+ *
+ * @code
+ * heartbeat_scheduler_t scheduler;
+ * auto id = scheduler.schedule(1000, [] { probe(); return milliseconds_t(1000); });
+ * ...
+ * scheduler.cancel(id);
+ * @endcode
+ *
+ * @note heartbeat_runner_t 默认使用 instance() 返回的进程级调度器
+ */
+class heartbeat_scheduler_t : private noncopyable_t, private nonmovable_t {
+public:
+    using task_id_t = uint64_t;
+    using task_t = std::function<milliseconds_t()>;
+
+    explicit heartbeat_scheduler_t(
+        const heartbeat_scheduler_config_t& config = heartbeat_scheduler_config_t());
+
+    /**
+     * @brief 析构函数
+     *
+     * 停止时间轮并等待正在执行的任务完成；尚未触发的任务被丢弃。
+     */
+    ~heartbeat_scheduler_t();
+
+    /**
+     * @brief 进程级共享调度器（首次使用时创建）
+     */
+    static heartbeat_scheduler_t& instance();
+
+    /**
+     * @brief 添加周期任务
+     * @param interval 任务周期；启用 jitter_start 时首次延迟在 [0, interval) 内随机
+     * @param task 任务，返回下一次触发的延迟（负数表示结束）
+     * @return 任务 ID
+     */
+    task_id_t schedule(milliseconds_t interval, task_t task);
+
+    /**
+     * @brief 让任务尽快再执行一次（任务正在执行时无效果）
+     */
+    void trigger(task_id_t id);
+
+    /**
+     * @brief 取消任务
+     *
+     * 任务正在其他线程执行时等待其完成；在任务自身中调用时不等待。
+     */
+    void cancel(task_id_t id);
+
+    /**
+     * @brief 已登记的任务数
+     */
+    size_t task_count() const;
+
+    /**
+     * @brief 当前的工作线程数
+     */
+    size_t worker_threads() const {
+        return m_pool.thread_count();
+    }
+
+    /**
+     * @brief 配置
+     */
+    const heartbeat_scheduler_config_t& config() const {
+        return m_config;
+    }
+
+private:
+    struct entry_t {
+        task_id_t id = 0;
+        task_t task;
+        uint64_t expiry_tick = 0;       ///< 到期刻度（受 m_mutex 保护）
+        bool in_wheel = false;          ///< 是否在时间轮上（受 m_mutex 保护）
+        bool running = false;           ///< 是否正在执行（受 m_mutex 保护）
+        bool cancelled = false;         ///< 是否已取消（受 m_mutex 保护）
+        std::thread::id runner;         ///< 执行该任务的线程（受 m_mutex 保护）
+    };
+    using entry_ptr_t = std::shared_ptr<entry_t>;
+
+    void _timer_loop();
+    void _run_entry(const entry_ptr_t& entry);
+    void _insert_locked(const entry_ptr_t& entry, milliseconds_t delay);
+    void _remove_locked(const entry_ptr_t& entry);
+    milliseconds_t _initial_delay(milliseconds_t interval);
+
+    heartbeat_scheduler_config_t m_config;
+    size_t m_mask;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_timer_cv;     ///< 唤醒时间轮线程
+    std::condition_variable m_done_cv;      ///< cancel() 等待任务执行完成
+    std::vector<std::vector<entry_ptr_t>> m_wheel;
+    std::unordered_map<task_id_t, entry_ptr_t> m_entries;
+    task_id_t m_next_id = 0;
+    uint64_t m_current_tick = 0;
+    std::chrono::steady_clock::time_point m_epoch;
+    size_t m_wheel_count = 0;               ///< 时间轮上的任务数
+    uint64_t m_jitter_state;
+    bool m_stopping = false;
+
+    thread_pool_t m_pool;
+    std::thread m_timer_thread;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_HEARTBEAT_HEARTBEAT_SCHEDULER_HPP
@@ -48,6 +48,17 @@ public:
      */
     virtual result_t<command_t> make_heartbeat_command() = 0;
 
+    /**
+     * @brief 心跳命令是否固定不变
+     * 
+     * 返回 true 时运行器只调用一次 make_heartbeat_command() 并在之后的
+     * 心跳中复用该命令，避免每次心跳分配。默认 false：只有命令在策略的
+     * 整个生命周期内都不会变化（不带序号、没有可修改的载荷）的策略才应返回 true。
+     */
+    virtual bool is_command_reusable() const {
+        return false;
+    }
+
     /**
      * @brief 验证心跳响应
      * 
@@ -0,0 +1,195 @@
+/**
+ * @file rtt_estimator.hpp
+ * @brief 往返时间估计
+ *
+ * 按 RFC 6298 维护平滑 RTT 与偏差，推导重传超时（RTO），
+ * 并保留最近的样本用于百分位统计。
+ */
+
+#ifndef VDL_HEARTBEAT_RTT_ESTIMATOR_HPP
+#define VDL_HEARTBEAT_RTT_ESTIMATOR_HPP
+
+#include "../core/types.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace vdl {
+
+// ============================================================================
+// rtt_stats_t - RTT 统计快照
+// ============================================================================
+
+/**
+ * @brief RTT 统计快照（单位：微秒）
+ *
+ * 百分位基于最近 rtt_estimator_t::k_window 个样本。
+ */
+struct rtt_stats_t {
+    uint64_t samples = 0;          ///< 累计样本数
+    microseconds_t last = 0;       ///< 最近一次样本
+    microseconds_t srtt = 0;       ///< 平滑 RTT
+    microseconds_t rttvar = 0;     ///< RTT 偏差
+    microseconds_t rto = 0;        ///< 推导的超时（含退避）
+    microseconds_t min = 0;        ///< 窗口内最小值
+    microseconds_t max = 0;        ///< 窗口内最大值
+    microseconds_t p50 = 0;        ///< 中位数
+    microseconds_t p90 = 0;        ///< 90 百分位
+    microseconds_t p99 = 0;        ///< 99 百分位
+};
+
+// ============================================================================
+// rtt_estimator_t - RFC 6298 估计器
+// ============================================================================
+
+/**
+ * @brief RTT 估计器（RFC 6298）
+ *
+ * - 首个样本 R：SRTT = R，RTTVAR = R/2
+ * - 之后：RTTVAR = 3/4·RTTVAR + 1/4·|SRTT − R|，SRTT = 7/8·SRTT + 1/8·R
+ * - RTO = SRTT + max(G, 4·RTTVAR)，G 为时钟粒度
+ * - 超时后 RTO 加倍（退避），下一个有效样本清除退避
+ *
+ * @note 非线程安全，由调用者加锁
+ */
+class rtt_estimator_t {
+public:
+    static constexpr size_t k_window = 128;                 ///< 百分位窗口大小
+    static constexpr microseconds_t k_granularity = 1000;   ///< 时钟粒度 G（毫秒级超时）
+    static constexpr microseconds_t k_max_rto = 60000000;   ///< RTO 上限（60 秒）
+
+    /**
+     * @brief 加入一个往返样本
+     */
+    void add_sample(microseconds_t rtt) {
+        if (rtt < 0) {
+            rtt = 0;
+        }
+        if (m_samples == 0) {
+            m_srtt = rtt;
+            m_rttvar = rtt / 2;
+        } else {
+            const microseconds_t delta = m_srtt > rtt ? m_srtt - rtt : rtt - m_srtt;
+            m_rttvar = (3 * m_rttvar + delta) / 4;
+            m_srtt = (7 * m_srtt + rtt) / 8;
+        }
+        m_backoff = 0;
+        m_last = rtt;
+        m_window[static_cast<size_t>(m_samples % k_window)] = rtt;
+        ++m_samples;
+    }
+
+    /**
+     * @brief 记录一次超时（RTO 退避加倍）
+     */
+    void on_timeout() {
+        if (m_backoff < k_max_backoff) {
+            ++m_backoff;
+        }
+    }
+
+    bool has_sample() const {
+        return m_samples > 0;
+    }
+
+    uint64_t sample_count() const {
+        return m_samples;
+    }
+
+    microseconds_t srtt() const {
+        return m_srtt;
+    }
+
+    microseconds_t rttvar() const {
+        return m_rttvar;
+    }
+
+    /**
+     * @brief 当前超时估计（含退避；无样本时返回 0）
+     */
+    microseconds_t rto() const {
+        if (m_samples == 0) {
+            return 0;
+        }
+        const microseconds_t spread = 4 * m_rttvar;
+        microseconds_t rto = m_srtt + (spread > k_granularity ? spread : k_granularity);
+        for (uint8_t i = 0; i < m_backoff && rto < k_max_rto; ++i) {
+            rto *= 2;
+        }
+        return rto < k_max_rto ? rto : k_max_rto;
+    }
+
+    /**
+     * @brief 最近样本的百分位
+     * @param percent 0-100
+     */
+    microseconds_t percentile(uint8_t percent) const {
+        std::array<microseconds_t, k_window> sorted;
+        const size_t count = _sorted(sorted);
+        return _percentile(sorted, count, percent);
+    }
+
+    /**
+     * @brief 统计快照
+     */
+    rtt_stats_t snapshot() const {
+        rtt_stats_t stats;
+        stats.samples = m_samples;
+        stats.last = m_last;
+        stats.srtt = m_srtt;
+        stats.rttvar = m_rttvar;
+        stats.rto = rto();
+
+        std::array<microseconds_t, k_window> sorted;
+        const size_t count = _sorted(sorted);
+        if (count > 0) {
+            stats.min = sorted[0];
+            stats.max = sorted[count - 1];
+            stats.p50 = _percentile(sorted, count, 50);
+            stats.p90 = _percentile(sorted, count, 90);
+            stats.p99 = _percentile(sorted, count, 99);
+        }
+        return stats;
+    }
+
+    void reset() {
+        *this = rtt_estimator_t();
+    }
+
+private:
+    static constexpr uint8_t k_max_backoff = 6;
+
+    size_t _sorted(std::array<microseconds_t, k_window>& out) const {
+        const size_t count = m_samples < k_window ? static_cast<size_t>(m_samples) : k_window;
+        std::copy(m_window.begin(), m_window.begin() + static_cast<offset_t>(count), out.begin());
+        std::sort(out.begin(), out.begin() + static_cast<offset_t>(count));
+        return count;
+    }
+
+    static microseconds_t _percentile(const std::array<microseconds_t, k_window>& sorted,
+                                      size_t count, uint8_t percent) {
+        if (count == 0) {
+            return 0;
+        }
+        if (percent > 100) {
+            percent = 100;
+        }
+        // 最近秩法：第 ceil(p/100·n) 个样本
+        size_t rank = (count * percent + 99) / 100;
+        if (rank == 0) {
+            rank = 1;
+        }
+        return sorted[rank - 1];
+    }
+
+    std::array<microseconds_t, k_window> m_window{};
+    uint64_t m_samples = 0;
+    microseconds_t m_last = 0;
+    microseconds_t m_srtt = 0;
+    microseconds_t m_rttvar = 0;
+    uint8_t m_backoff = 0;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_HEARTBEAT_RTT_ESTIMATOR_HPP
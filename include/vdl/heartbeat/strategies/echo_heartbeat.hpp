@@ -95,7 +95,10 @@ public:
     }
 
     /**
-     * @brief 设置回显数据
+     * @brief 设置回显数据（下一次心跳起生效）
+     *
+     * 回显数据可变，因此本策略不声明 is_command_reusable()，
+     * 运行器每次心跳都重新生成命令。
      */
     void set_echo_data(const bytes_t& data) {
         m_echo_data = data;
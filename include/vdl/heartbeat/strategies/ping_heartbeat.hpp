@@ -53,6 +53,10 @@ public:
         return make_ok(std::move(cmd));
     }
 
+    bool is_command_reusable() const override {
+        return true;
+    }
+
     bool validate_response(const response_t& resp) override {
         // 只检查响应有效性（无 error_code）
         // 任何有效的响应都被认为是成功的心跳
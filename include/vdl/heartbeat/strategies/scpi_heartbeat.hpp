@@ -65,6 +65,10 @@ public:
         return make_ok(std::move(cmd));
     }
 
+    bool is_command_reusable() const override {
+        return true;
+    }
+
     bool validate_response(const response_t& resp) override {
         // 检查响应是否有效
         if (resp.is_error()) {
@@ -9,7 +9,10 @@
 #define VDL_PROTOCOL_COMMAND_HPP
 
 #include "../core/types.hpp"
+#include "../core/buffer.hpp"
+#include "../core/tag.hpp"
 
+#include <initializer_list>
 #include <string>
 
 namespace vdl {
@@ -41,6 +44,13 @@ enum class command_type_t : uint8_t {
  * - 功能码
  * - 参数数据
  * 
+ * 参数数据不超过 k_inline_payload_size 字节时存放在对象内部，标签是驻留字符串，
+ * 因此常见命令的创建、复制、移动都不分配堆内存。
+ * 
+ * @note 接口变更：data() 返回 payload_bytes_t 而不是 bytes_t，tag() 返回 tag_t（str()/c_str() 取字符串），
+ *       set_tag() 不再接受字符串字面量，需显式构造 tag_t。
+ *       需要 bytes_t 时用 data().to_bytes()，set_data() 仍接受 bytes_t。
+ * 
  * @code
  * // 创建读取命令
  * command_t cmd;
@@ -86,21 +96,34 @@ public:
     }
 
     command_t& set_data(const bytes_t& data) {
+        m_data.assign(data.data(), data.size());
+        return *this;
+    }
+
+    command_t& set_data(const_byte_span_t data) {
+        m_data.assign(data.data(), data.size());
+        return *this;
+    }
+
+    command_t& set_data(const payload_bytes_t& data) {
         m_data = data;
         return *this;
     }
 
-    command_t& set_data(bytes_t&& data) {
+    command_t& set_data(payload_bytes_t&& data) {
         m_data = std::move(data);
         return *this;
     }
 
     command_t& set_data(std::initializer_list<byte_t> data) {
-        m_data.assign(data.begin(), data.end());
+        m_data.assign(data);
         return *this;
     }
 
-    command_t& set_tag(const std::string& tag) {
+    /**
+     * @brief 设置标签（热路径上传入预先驻留的 static const tag_t，见 tag_t）
+     */
+    command_t& set_tag(const tag_t& tag) {
         m_tag = tag;
         return *this;
     }
@@ -113,9 +136,9 @@ public:
     uint8_t function_code() const { return m_function_code; }
     uint16_t address() const { return m_address; }
     uint16_t count() const { return m_count; }
-    const bytes_t& data() const { return m_data; }
-    bytes_t& data() { return m_data; }
-    const std::string& tag() const { return m_tag; }
+    const payload_bytes_t& data() const { return m_data; }
+    payload_bytes_t& data() { return m_data; }
+    const tag_t& tag() const { return m_tag; }
 
     // ========================================================================
     // 便捷方法
@@ -145,8 +168,8 @@ private:
     uint8_t m_function_code = 0;
     uint16_t m_address = 0;
     uint16_t m_count = 0;
-    bytes_t m_data;
-    std::string m_tag;  // 用于调试/追踪
+    payload_bytes_t m_data;
+    tag_t m_tag;        // 用于调试/追踪
 };
 
 // ============================================================================
@@ -10,8 +10,14 @@
 
 #include "../core/types.hpp"
 #include "../core/error.hpp"
+#include "../core/buffer.hpp"
+#include "../core/byte_swap.hpp"
 
+#include <cstring>
+#include <initializer_list>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace vdl {
 
@@ -42,6 +48,16 @@ enum class response_status_t : uint8_t {
  * - 功能码
  * - 响应数据
  * 
+ * 数据和原始帧可以是自有的 payload_bytes_t（短数据内联存储，不分配堆内存），
+ * 也可以是共享接收缓冲区的 byte_slice_t（由编解码器的 decode_slice() 设置）。
+ * data()/raw_frame() 返回只读视图（与 data_view()/raw_view() 相同），切片模式下零拷贝；
+ * 自有副本只在调用方需要时生成：mutable_data() 把切片转为自有数据，payload() 返回副本。
+ * 所有 const 访问器都不修改对象，可被多个线程同时读取（如事件分发线程和观察者）。
+ * 
+ * @note 接口变更：data() 与 raw_frame() 返回 const_byte_span_t 而不是 bytes_t。
+ *       size()/data()/operator[]/迭代器用法不变；需要修改数据时用 mutable_data()，
+ *       需要自有数据时用 payload()（bytes_t 用 payload().to_bytes()）。
+ * 
  * @code
  * // 检查响应
  * auto result = device.execute(cmd);
@@ -77,25 +93,73 @@ public:
     }
 
     response_t& set_data(const bytes_t& data) {
+        m_data.assign(data.data(), data.size());
+        m_data_slice.reset();
+        return *this;
+    }
+
+    response_t& set_data(const_byte_span_t data) {
+        m_data.assign(data.data(), data.size());
+        m_data_slice.reset();
+        return *this;
+    }
+
+    response_t& set_data(const payload_bytes_t& data) {
         m_data = data;
+        m_data_slice.reset();
         return *this;
     }
 
-    response_t& set_data(bytes_t&& data) {
+    response_t& set_data(payload_bytes_t&& data) {
         m_data = std::move(data);
+        m_data_slice.reset();
+        return *this;
+    }
+
+    response_t& set_data(std::initializer_list<byte_t> data) {
+        m_data.assign(data);
+        m_data_slice.reset();
+        return *this;
+    }
+
+    /**
+     * @brief 设置数据为共享切片（不复制）
+     */
+    response_t& set_data_slice(byte_slice_t slice) {
+        m_data.clear();
+        m_data_slice = std::move(slice);
         return *this;
     }
 
     response_t& set_raw_frame(const bytes_t& frame) {
-        m_raw_frame = frame;
+        m_raw_frame.assign(frame.data(), frame.size());
+        m_raw_slice.reset();
+        return *this;
+    }
+
+    response_t& set_raw_frame(const_byte_span_t frame) {
+        m_raw_frame.assign(frame.data(), frame.size());
+        m_raw_slice.reset();
         return *this;
     }
 
-    response_t& set_raw_frame(bytes_t&& frame) {
-        m_raw_frame = std::move(frame);
+    /**
+     * @brief 设置原始帧为共享切片（不复制）
+     */
+    response_t& set_raw_frame_slice(byte_slice_t slice) {
+        m_raw_frame.clear();
+        m_raw_slice = std::move(slice);
         return *this;
     }
 
+    /**
+     * @brief 丢弃原始帧
+     */
+    void clear_raw_frame() {
+        m_raw_frame.clear();
+        m_raw_slice.reset();
+    }
+
     // ========================================================================
     // 访问器
     // ========================================================================
@@ -103,9 +167,59 @@ public:
     response_status_t status() const { return m_status; }
     uint8_t function_code() const { return m_function_code; }
     uint8_t error_code() const { return m_error_code; }
-    const bytes_t& data() const { return m_data; }
-    bytes_t& data() { return m_data; }
-    const bytes_t& raw_frame() const { return m_raw_frame; }
+
+    /**
+     * @brief 获取数据的只读视图（同 data_view()，不复制）
+     */
+    const_byte_span_t data() const { return data_view(); }
+
+    /**
+     * @brief 获取数据的自有副本
+     */
+    payload_bytes_t payload() const { return payload_bytes_t(data_view()); }
+
+    /**
+     * @brief 获取可修改的数据（切片模式下此时才复制并转为自有数据）
+     */
+    payload_bytes_t& mutable_data() {
+        if (!m_data_slice.empty()) {
+            m_data.assign(m_data_slice.data(), m_data_slice.size());
+            m_data_slice.reset();
+        }
+        return m_data;
+    }
+
+    /**
+     * @brief 获取原始帧（只读视图，同 raw_view()）
+     */
+    const_byte_span_t raw_frame() const { return raw_view(); }
+
+    /**
+     * @brief 获取数据的只读视图（不复制）
+     */
+    const_byte_span_t data_view() const {
+        if (!m_data_slice.empty()) {
+            return m_data_slice.view();
+        }
+        return const_byte_span_t(m_data.data(), m_data.size());
+    }
+
+    /**
+     * @brief 获取原始帧的只读视图（不复制）
+     */
+    const_byte_span_t raw_view() const {
+        if (!m_raw_slice.empty()) {
+            return m_raw_slice.view();
+        }
+        return const_byte_span_t(m_raw_frame.data(), m_raw_frame.size());
+    }
+
+    /**
+     * @brief 数据是否为共享切片
+     */
+    bool is_data_shared() const {
+        return !m_data_slice.empty();
+    }
 
     // ========================================================================
     // 状态检查
@@ -136,7 +250,7 @@ public:
      * @brief 是否有数据
      */
     bool has_data() const {
-        return !m_data.empty();
+        return !data_view().empty();
     }
 
     // ========================================================================
@@ -147,24 +261,26 @@ public:
      * @brief 获取数据大小
      */
     size_t data_size() const {
-        return m_data.size();
+        return data_view().size();
     }
 
     /**
      * @brief 获取单个字节
      */
     byte_t get_byte(size_t index) const {
-        return (index < m_data.size()) ? m_data[index] : 0;
+        const_byte_span_t d = data_view();
+        return (index < d.size()) ? d[index] : 0;
     }
 
     /**
      * @brief 获取16位无符号整数（大端序）
      */
     uint16_t get_uint16_be(size_t offset) const {
-        if (offset + 2 > m_data.size()) return 0;
+        const_byte_span_t d = data_view();
+        if (offset + 2 > d.size()) return 0;
         return static_cast<uint16_t>(
-            (static_cast<uint16_t>(m_data[offset]) << 8) |
-            static_cast<uint16_t>(m_data[offset + 1])
+            (static_cast<uint16_t>(d[offset]) << 8) |
+            static_cast<uint16_t>(d[offset + 1])
         );
     }
 
@@ -172,10 +288,11 @@ public:
      * @brief 获取16位无符号整数（小端序）
      */
     uint16_t get_uint16_le(size_t offset) const {
-        if (offset + 2 > m_data.size()) return 0;
+        const_byte_span_t d = data_view();
+        if (offset + 2 > d.size()) return 0;
         return static_cast<uint16_t>(
-            static_cast<uint16_t>(m_data[offset]) |
-            (static_cast<uint16_t>(m_data[offset + 1]) << 8)
+            static_cast<uint16_t>(d[offset]) |
+            (static_cast<uint16_t>(d[offset + 1]) << 8)
         );
     }
 
@@ -183,22 +300,108 @@ public:
      * @brief 获取32位无符号整数（大端序）
      */
     uint32_t get_uint32_be(size_t offset) const {
-        if (offset + 4 > m_data.size()) return 0;
-        return (static_cast<uint32_t>(m_data[offset]) << 24) |
-               (static_cast<uint32_t>(m_data[offset + 1]) << 16) |
-               (static_cast<uint32_t>(m_data[offset + 2]) << 8) |
-               static_cast<uint32_t>(m_data[offset + 3]);
+        const_byte_span_t d = data_view();
+        if (offset + 4 > d.size()) return 0;
+        return (static_cast<uint32_t>(d[offset]) << 24) |
+               (static_cast<uint32_t>(d[offset + 1]) << 16) |
+               (static_cast<uint32_t>(d[offset + 2]) << 8) |
+               static_cast<uint32_t>(d[offset + 3]);
     }
 
     /**
      * @brief 获取32位无符号整数（小端序）
      */
     uint32_t get_uint32_le(size_t offset) const {
-        if (offset + 4 > m_data.size()) return 0;
-        return static_cast<uint32_t>(m_data[offset]) |
-               (static_cast<uint32_t>(m_data[offset + 1]) << 8) |
-               (static_cast<uint32_t>(m_data[offset + 2]) << 16) |
-               (static_cast<uint32_t>(m_data[offset + 3]) << 24);
+        const_byte_span_t d = data_view();
+        if (offset + 4 > d.size()) return 0;
+        return static_cast<uint32_t>(d[offset]) |
+               (static_cast<uint32_t>(d[offset + 1]) << 8) |
+               (static_cast<uint32_t>(d[offset + 2]) << 16) |
+               (static_cast<uint32_t>(d[offset + 3]) << 24);
+    }
+
+    // ========================================================================
+    // 批量数组访问
+    // ========================================================================
+
+    /**
+     * @brief 批量读取定宽数值数组
+     * @param offset 起始字节偏移
+     * @param count 元素个数
+     * @param order 数据的字节序
+     * @param out [out] 至少 count 个元素的输出区
+     * @return 成功返回 count；越界返回 out_of_range，输出区不足返回 invalid_size
+     *
+     * 只检查一次边界；字节序与本机不同时由批量内核翻转（见 byte_swap_copy()）。
+     *
+     * @code
+     * uint16_t regs[125];
+     * auto n = response.read_array<uint16_t>(0, 125, byte_order_t::big, regs);
+     * @endcode
+     */
+    template <typename T>
+    result_t<size_t> read_array(size_t offset, size_t count, byte_order_t order,
+                                span_t<T> out) const {
+        static_assert(std::is_arithmetic<T>::value, "read_array needs an arithmetic type");
+        auto bounds = _check_array<T>(offset, count);
+        if (!bounds) {
+            return make_unexpected(bounds.error());
+        }
+        if (out.size() < count) {
+            return make_error<size_t>(error_code_t::invalid_size, "Output span too small");
+        }
+        if (count == 0) {
+            return count;
+        }
+
+        const byte_t* src = data_view().data() + offset;
+        byte_t* dst = reinterpret_cast<byte_t*>(out.data());
+        if (needs_byte_swap(order)) {
+            byte_swap_copy(dst, src, count, sizeof(T));
+        } else {
+            std::memcpy(dst, src, count * sizeof(T));
+        }
+        return count;
+    }
+
+    /**
+     * @brief 批量读取到 vector（调整为 count 个元素，失败时保持不变）
+     */
+    template <typename T>
+    result_t<size_t> read_array(size_t offset, size_t count, byte_order_t order,
+                                std::vector<T>& out) const {
+        auto bounds = _check_array<T>(offset, count);
+        if (!bounds) {
+            return make_unexpected(bounds.error());
+        }
+        out.resize(count);
+        return read_array(offset, count, order, span_t<T>(out.data(), out.size()));
+    }
+
+    /**
+     * @brief 零拷贝数组视图
+     * @return 字节序与本机一致且地址满足 T 的对齐时返回指向数据的视图，
+     *         否则返回 not_supported（此时改用 read_array()）
+     *
+     * 视图与 data_view() 的有效期相同。
+     */
+    template <typename T>
+    result_t<span_t<const T>> view_array(size_t offset, size_t count, byte_order_t order) const {
+        static_assert(std::is_arithmetic<T>::value, "view_array needs an arithmetic type");
+        auto bounds = _check_array<T>(offset, count);
+        if (!bounds) {
+            return make_unexpected(bounds.error());
+        }
+        if (sizeof(T) > 1 && needs_byte_swap(order)) {
+            return make_error<span_t<const T>>(error_code_t::not_supported,
+                                               "Byte order differs from host");
+        }
+        const byte_t* src = data_view().data() + offset;
+        if (reinterpret_cast<uintptr_t>(src) % alignof(T) != 0) {
+            return make_error<span_t<const T>>(error_code_t::not_supported,
+                                               "Data is not aligned for element type");
+        }
+        return span_t<const T>(reinterpret_cast<const T*>(src), count);
     }
 
     /**
@@ -210,14 +413,30 @@ public:
         m_error_code = 0;
         m_data.clear();
         m_raw_frame.clear();
+        m_data_slice.reset();
+        m_raw_slice.reset();
     }
 
 private:
+    /**
+     * @brief 检查 [offset, offset + count * sizeof(T)) 是否在数据范围内（写成不会回绕的形式）
+     */
+    template <typename T>
+    result_t<void> _check_array(size_t offset, size_t count) const {
+        const size_t size = data_view().size();
+        if (offset > size || count > (size - offset) / sizeof(T)) {
+            return make_error_void(error_code_t::out_of_range, "Array exceeds response data");
+        }
+        return make_ok();
+    }
+
     response_status_t m_status = response_status_t::invalid;
     uint8_t m_function_code = 0;
     uint8_t m_error_code = 0;
-    bytes_t m_data;
-    bytes_t m_raw_frame;  // 原始帧（用于调试）
+    payload_bytes_t m_data;       // 自有数据（切片模式下为空）
+    payload_bytes_t m_raw_frame;  // 原始帧（用于调试）
+    byte_slice_t m_data_slice;    // 共享的数据切片
+    byte_slice_t m_raw_slice;     // 共享的原始帧切片
 };
 
 // ============================================================================
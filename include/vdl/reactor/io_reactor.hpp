@@ -0,0 +1,487 @@
+/**
+ * @file io_reactor.hpp
+ * @brief 单线程 I/O 反应器
+ *
+ * 在一个线程中监视大量非阻塞描述符并驱动定时器，
+ * 替代“每台设备一个阻塞线程 + 每个心跳一个线程”的模型。
+ */
+
+#ifndef VDL_REACTOR_IO_REACTOR_HPP
+#define VDL_REACTOR_IO_REACTOR_HPP
+
+#include "../core/types.hpp"
+#include "../core/error.hpp"
+#include "../core/noncopyable.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+namespace vdl {
+
+// ============================================================================
+// 事件与回调类型
+// ============================================================================
+
+/**
+ * @brief I/O 事件位
+ */
+enum io_event_t : uint32_t {
+    io_readable = 1u << 0,   ///< 可读
+    io_writable = 1u << 1,   ///< 可写
+    io_error = 1u << 2       ///< 错误或挂断
+};
+
+/**
+ * @brief 描述符事件回调（参数为 io_event_t 位组合）
+ */
+using io_handler_t = std::function<void(uint32_t events)>;
+
+/**
+ * @brief 定时器 ID（0 表示无效）
+ */
+using timer_id_t = uint64_t;
+
+// ============================================================================
+// io_reactor_t - 反应器
+// ============================================================================
+
+/**
+ * @brief 单线程 I/O 反应器
+ *
+ * Linux 上使用 epoll，其他 POSIX 平台退化为 poll。
+ *
+ * - watch()/modify()/unwatch()/add_timer()/cancel_timer() 只能在反应器线程中调用，
+ *   其他线程通过 post() 投递
+ * - 回调在反应器线程中执行，不得阻塞
+ *
+ * @code
+ * io_reactor_t reactor;
+ * std::thread loop([&] { reactor.run(); });
+ *
+ * reactor.post([&] {
+ *     reactor.add_timer(1000, 1000, [] { ... });   // 每秒执行
+ * });
+ *
+ * reactor.stop();
+ * loop.join();
+ * @endcode
+ */
+class io_reactor_t : private noncopyable_t, private nonmovable_t {
+public:
+    io_reactor_t() {
+#ifdef __linux__
+        m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+#endif
+        int fds[2] = {-1, -1};
+        if (::pipe(fds) == 0) {
+            m_wake_read = fds[0];
+            m_wake_write = fds[1];
+            _set_nonblocking(m_wake_read);
+            _set_nonblocking(m_wake_write);
+            _add_native(m_wake_read, io_readable);
+        }
+    }
+
+    ~io_reactor_t() {
+        if (m_wake_read >= 0) ::close(m_wake_read);
+        if (m_wake_write >= 0) ::close(m_wake_write);
+#ifdef __linux__
+        if (m_epoll >= 0) ::close(m_epoll);
+#endif
+    }
+
+    /**
+     * @brief 反应器是否创建成功
+     */
+    bool valid() const {
+#ifdef __linux__
+        return m_epoll >= 0 && m_wake_read >= 0;
+#else
+        return m_wake_read >= 0;
+#endif
+    }
+
+    // ========================================================================
+    // 事件循环
+    // ========================================================================
+
+    /**
+     * @brief 运行事件循环直到 stop()
+     */
+    void run() {
+        _bind_thread();
+        while (!m_stop_requested.load()) {
+            run_once(-1);
+        }
+        m_stop_requested.store(false);
+    }
+
+    /**
+     * @brief 处理一轮事件
+     * @param timeout_ms 最长等待时间，-1 表示等到下一个事件或定时器
+     * @return 本轮执行的回调数
+     */
+    size_t run_once(int timeout_ms = 0) {
+        _bind_thread();
+        size_t handled = 0;
+
+        int wait_ms = timeout_ms;
+        if (!m_timer_queue.empty()) {
+            const auto now = clock_t::now();
+            const auto due = m_timer_queue.begin()->first;
+            const int64_t until = due <= now ? 0 : static_cast<int64_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(due - now).count()) + 1;
+            if (wait_ms < 0 || until < wait_ms) {
+                wait_ms = static_cast<int>(until);
+            }
+        }
+        if (_has_posted()) {
+            wait_ms = 0;
+        }
+
+        handled += _poll_io(wait_ms);
+        handled += _run_posted();
+        handled += _run_timers();
+        return handled;
+    }
+
+    /**
+     * @brief 请求 run() 退出（线程安全）
+     */
+    void stop() {
+        m_stop_requested.store(true);
+        _wake();
+    }
+
+    /**
+     * @brief 投递任务到反应器线程（线程安全）
+     */
+    void post(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(m_post_mutex);
+            m_posted.push_back(std::move(task));
+        }
+        _wake();
+    }
+
+    /**
+     * @brief 当前线程是否为反应器线程
+     */
+    bool in_reactor_thread() const {
+        std::lock_guard<std::mutex> lock(m_post_mutex);
+        return m_thread_id == std::this_thread::get_id();
+    }
+
+    // ========================================================================
+    // 描述符监视
+    // ========================================================================
+
+    /**
+     * @brief 监视描述符
+     * @param fd 非阻塞描述符
+     * @param events 关注的事件（io_readable / io_writable）
+     * @param handler 事件回调
+     */
+    result_t<void> watch(int fd, uint32_t events, io_handler_t handler) {
+        if (fd < 0 || !handler) {
+            return make_error_void(error_code_t::invalid_argument, "Invalid descriptor or handler");
+        }
+        if (m_watches.count(fd) != 0) {
+            return make_error_void(error_code_t::already_initialized, "Descriptor already watched");
+        }
+        if (!_add_native(fd, events)) {
+            return make_error_void(error_code_t::io_error, "Failed to watch descriptor");
+        }
+        m_watches[fd] = watch_t{events, std::make_shared<io_handler_t>(std::move(handler))};
+        return make_ok();
+    }
+
+    /**
+     * @brief 修改关注的事件
+     */
+    result_t<void> modify(int fd, uint32_t events) {
+        auto it = m_watches.find(fd);
+        if (it == m_watches.end()) {
+            return make_error_void(error_code_t::invalid_argument, "Descriptor not watched");
+        }
+        if (it->second.events == events) {
+            return make_ok();
+        }
+#ifdef __linux__
+        struct epoll_event ev = _to_epoll(fd, events);
+        if (::epoll_ctl(m_epoll, EPOLL_CTL_MOD, fd, &ev) != 0) {
+            return make_error_void(error_code_t::io_error, "Failed to modify descriptor");
+        }
+#endif
+        it->second.events = events;
+        return make_ok();
+    }
+
+    /**
+     * @brief 停止监视描述符（不关闭描述符）
+     */
+    void unwatch(int fd) {
+        auto it = m_watches.find(fd);
+        if (it == m_watches.end()) {
+            return;
+        }
+#ifdef __linux__
+        ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+        m_watches.erase(it);
+    }
+
+    size_t watch_count() const {
+        return m_watches.size();
+    }
+
+    // ========================================================================
+    // 定时器
+    // ========================================================================
+
+    /**
+     * @brief 添加定时器
+     * @param delay_ms 首次触发延迟
+     * @param interval_ms 重复间隔，0 表示只触发一次
+     * @param callback 回调
+     * @return 定时器 ID
+     */
+    timer_id_t add_timer(milliseconds_t delay_ms, milliseconds_t interval_ms,
+                         std::function<void()> callback) {
+        const timer_id_t id = ++m_next_timer_id;
+        const auto due = clock_t::now() + std::chrono::milliseconds(delay_ms);
+        m_timers[id] = timer_t{due, interval_ms,
+                               std::make_shared<std::function<void()>>(std::move(callback))};
+        m_timer_queue.insert(std::make_pair(due, id));
+        return id;
+    }
+
+    /**
+     * @brief 取消定时器（可在定时器回调中调用）
+     */
+    void cancel_timer(timer_id_t id) {
+        auto it = m_timers.find(id);
+        if (it == m_timers.end()) {
+            return;
+        }
+        m_timer_queue.erase(std::make_pair(it->second.due, id));
+        m_timers.erase(it);
+    }
+
+    size_t timer_count() const {
+        return m_timers.size();
+    }
+
+private:
+    using clock_t = std::chrono::steady_clock;
+
+    struct watch_t {
+        uint32_t events;
+        std::shared_ptr<io_handler_t> handler;   // 回调中可能 unwatch 自己，调用时持有副本
+    };
+
+    struct timer_t {
+        clock_t::time_point due;
+        milliseconds_t interval;
+        std::shared_ptr<std::function<void()>> callback;
+    };
+
+    static void _set_nonblocking(int fd) {
+        const int flags = ::fcntl(fd, F_GETFL, 0);
+        if (flags >= 0) {
+            ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+        }
+    }
+
+    void _bind_thread() {
+        std::lock_guard<std::mutex> lock(m_post_mutex);
+        m_thread_id = std::this_thread::get_id();
+    }
+
+    void _wake() {
+        if (m_wake_write >= 0) {
+            const char byte = 1;
+            // 管道已满说明已有未处理的唤醒，忽略
+            (void)::write(m_wake_write, &byte, 1);
+        }
+    }
+
+    bool _has_posted() const {
+        std::lock_guard<std::mutex> lock(m_post_mutex);
+        return !m_posted.empty();
+    }
+
+#ifdef __linux__
+    static struct epoll_event _to_epoll(int fd, uint32_t events) {
+        struct epoll_event ev;
+        ev.events = 0;
+        if (events & io_readable) ev.events |= EPOLLIN;
+        if (events & io_writable) ev.events |= EPOLLOUT;
+        ev.data.fd = fd;
+        return ev;
+    }
+#endif
+
+    bool _add_native(int fd, uint32_t events) {
+#ifdef __linux__
+        struct epoll_event ev = _to_epoll(fd, events);
+        return ::epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &ev) == 0;
+#else
+        (void)fd;
+        (void)events;
+        return true;
+#endif
+    }
+
+    void _drain_wakeup() {
+        char scratch[64];
+        while (::read(m_wake_read, scratch, sizeof(scratch)) > 0) {
+        }
+    }
+
+    void _dispatch(int fd, uint32_t events) {
+        if (fd == m_wake_read) {
+            _drain_wakeup();
+            return;
+        }
+        auto it = m_watches.find(fd);
+        if (it == m_watches.end()) {
+            return;
+        }
+        std::shared_ptr<io_handler_t> handler = it->second.handler;
+        (*handler)(events);
+    }
+
+    size_t _poll_io(int wait_ms) {
+        size_t handled = 0;
+#ifdef __linux__
+        struct epoll_event events[64];
+        const int n = ::epoll_wait(m_epoll, events, 64, wait_ms);
+        for (int i = 0; i < n; ++i) {
+            uint32_t mask = 0;
+            if (events[i].events & EPOLLIN) mask |= io_readable;
+            if (events[i].events & EPOLLOUT) mask |= io_writable;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) mask |= io_error | io_readable;
+            const int fd = events[i].data.fd;
+            if (fd != m_wake_read) {
+                ++handled;
+            }
+            _dispatch(fd, mask);
+        }
+#else
+        std::vector<struct pollfd> fds;
+        fds.reserve(m_watches.size() + 1);
+        struct pollfd wake;
+        wake.fd = m_wake_read;
+        wake.events = POLLIN;
+        wake.revents = 0;
+        fds.push_back(wake);
+        for (const auto& entry : m_watches) {
+            struct pollfd pfd;
+            pfd.fd = entry.first;
+            pfd.events = 0;
+            if (entry.second.events & io_readable) pfd.events |= POLLIN;
+            if (entry.second.events & io_writable) pfd.events |= POLLOUT;
+            pfd.revents = 0;
+            fds.push_back(pfd);
+        }
+        const int n = ::poll(fds.data(), static_cast<nfds_t>(fds.size()), wait_ms);
+        for (int i = 0; n > 0 && i < static_cast<int>(fds.size()); ++i) {
+            const short revents = fds[static_cast<size_t>(i)].revents;
+            if (revents == 0) {
+                continue;
+            }
+            uint32_t mask = 0;
+            if (revents & POLLIN) mask |= io_readable;
+            if (revents & POLLOUT) mask |= io_writable;
+            if (revents & (POLLERR | POLLHUP)) mask |= io_error | io_readable;
+            if (i != 0) {
+                ++handled;
+            }
+            _dispatch(fds[static_cast<size_t>(i)].fd, mask);
+        }
+#endif
+        return handled;
+    }
+
+    size_t _run_posted() {
+        std::vector<std::function<void()>> tasks;
+        {
+            std::lock_guard<std::mutex> lock(m_post_mutex);
+            tasks.swap(m_posted);
+        }
+        for (auto& task : tasks) {
+            task();
+        }
+        return tasks.size();
+    }
+
+    size_t _run_timers() {
+        size_t handled = 0;
+        const auto now = clock_t::now();
+        while (!m_timer_queue.empty() && m_timer_queue.begin()->first <= now) {
+            const timer_id_t id = m_timer_queue.begin()->second;
+            m_timer_queue.erase(m_timer_queue.begin());
+
+            auto it = m_timers.find(id);
+            if (it == m_timers.end()) {
+                continue;
+            }
+            std::shared_ptr<std::function<void()>> callback = it->second.callback;
+            if (it->second.interval > 0) {
+                // 以计划时间为基准重排，避免漂移；落后太多时从当前时间重新开始
+                auto next = it->second.due + std::chrono::milliseconds(it->second.interval);
+                if (next <= now) {
+                    next = now + std::chrono::milliseconds(it->second.interval);
+                }
+                it->second.due = next;
+                m_timer_queue.insert(std::make_pair(next, id));
+            } else {
+                m_timers.erase(it);
+            }
+
+            (*callback)();
+            ++handled;
+        }
+        return handled;
+    }
+
+#ifdef __linux__
+    int m_epoll = -1;
+#endif
+    int m_wake_read = -1;
+    int m_wake_write = -1;
+    std::atomic<bool> m_stop_requested{false};
+
+    mutable std::mutex m_post_mutex;
+    std::vector<std::function<void()>> m_posted;
+    std::thread::id m_thread_id;
+
+    std::unordered_map<int, watch_t> m_watches;
+    std::map<timer_id_t, timer_t> m_timers;
+    std::set<std::pair<clock_t::time_point, timer_id_t>> m_timer_queue;
+    timer_id_t m_next_timer_id = 0;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_REACTOR_IO_REACTOR_HPP
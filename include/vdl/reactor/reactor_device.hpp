@@ -0,0 +1,912 @@
+/**
+ * @file reactor_device.hpp
+ * @brief 由 I/O 反应器驱动的设备
+ *
+ * 所有收发、解码、超时和心跳都在反应器线程中完成，
+ * 同步的 i_device_t 接口只是一层阻塞等待。
+ * 反应器持续解码接收到的数据（接收泵），不属于任何请求的帧交给订阅者。
+ */
+
+#ifndef VDL_REACTOR_REACTOR_DEVICE_HPP
+#define VDL_REACTOR_REACTOR_DEVICE_HPP
+
+#include "io_reactor.hpp"
+#include "../device/device.hpp"
+#include "../device/async_response.hpp"
+#include "../device/unsolicited_dispatcher.hpp"
+#include "../transport/transport.hpp"
+#include "../codec/codec.hpp"
+#include "../heartbeat/heartbeat_config.hpp"
+#include "../heartbeat/heartbeat_runner.hpp"
+#include "../heartbeat/heartbeat_strategy.hpp"
+#include "../core/buffer.hpp"
+#include "../core/fair_mutex.hpp"
+#include "../core/logging.hpp"
+#include "../core/memory.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+
+namespace vdl {
+
+namespace detail {
+
+// ============================================================================
+// reactor_channel_t - 反应器线程中的设备状态
+// ============================================================================
+
+/**
+ * @brief 反应器设备的内部状态
+ *
+ * 除 state()、锁和主动上报分发器之外的成员只在反应器线程中访问。
+ * 由 shared_ptr 持有：设备对象销毁后，已投递的任务仍可安全执行。
+ */
+class reactor_channel_t : private noncopyable_t {
+public:
+    reactor_channel_t(io_reactor_t& reactor, transport_ptr_t transport, codec_ptr_t codec)
+        : m_reactor(reactor)
+        , m_transport(std::move(transport))
+        , m_codec(std::move(codec))
+        , m_state(device_state_t::disconnected)
+        , m_rx_buffer(_rx_capacity()) {
+    }
+
+    ~reactor_channel_t() {
+        if (m_transport) {
+            m_transport->close();
+        }
+    }
+
+    device_state_t state() const {
+        return m_state;
+    }
+
+    i_transport_t* transport() {
+        return m_transport.get();
+    }
+
+    fair_mutex_t& lock() {
+        return m_lock;
+    }
+
+    unsolicited_dispatcher_t& unsolicited() {
+        return m_unsolicited;
+    }
+
+    void set_config(const device_config_t& config) {
+        m_config = config;
+    }
+
+    bool attached() const {
+        return m_fd >= 0;
+    }
+
+    // ========================================================================
+    // 连接（反应器线程）
+    // ========================================================================
+
+    /**
+     * @brief 将已打开的传输层注册到反应器
+     */
+    result_t<void> attach() {
+        const int fd = m_transport->native_handle();
+        if (fd < 0) {
+            m_state = device_state_t::error;
+            return make_error_void(error_code_t::not_supported,
+                                   "Transport has no pollable handle");
+        }
+
+        _reset_rx_buffer();
+        m_tx_buffer.clear();
+        m_tx_offset = 0;
+
+        auto result = m_reactor.watch(fd, io_readable, [this](uint32_t events) {
+            _on_io(events);
+        });
+        if (!result) {
+            m_state = device_state_t::error;
+            return result;
+        }
+
+        m_fd = fd;
+        m_state = device_state_t::connected;
+        VDL_LOG_INFO("Reactor device attached via %s", m_transport->type_name());
+        return make_ok();
+    }
+
+    /**
+     * @brief 注销并关闭传输层，以指定错误结束所有请求
+     */
+    void close(const error_t& error) {
+        stop_heartbeat();
+        _detach();
+        m_transport->close();
+        m_state = device_state_t::disconnected;
+        _fail_all(error);
+    }
+
+    // ========================================================================
+    // 请求（反应器线程）
+    // ========================================================================
+
+    void submit(const command_t& cmd, milliseconds_t timeout_ms, async_callback_t callback) {
+        if (m_state != device_state_t::connected) {
+            if (callback) {
+                callback(make_error<response_t>(error_code_t::not_connected,
+                                                "Device not connected"));
+            }
+            return;
+        }
+
+        request_ptr_t request = std::make_shared<request_t>();
+        request->cmd = cmd;
+        request->function_code = cmd.function_code();
+        request->callback = std::move(callback);
+        request->timer = m_reactor.add_timer(timeout_ms, 0, [this, request] {
+            request->timer = 0;
+            _on_timeout(request);
+        });
+
+        m_backlog.push_back(std::move(request));
+        _pump();
+    }
+
+    // ========================================================================
+    // 心跳（反应器线程）
+    // ========================================================================
+
+    void start_heartbeat(std::shared_ptr<i_heartbeat_strategy_t> strategy,
+                         const heartbeat_config_t& config,
+                         heartbeat_callback_t callback) {
+        stop_heartbeat();
+        m_hb_strategy = std::move(strategy);
+        m_hb_config = config;
+        m_hb_callback = std::move(callback);
+        m_hb_failures = 0;
+        m_hb_command = tl::nullopt;
+        if (!m_hb_strategy) {
+            return;
+        }
+        const milliseconds_t interval = std::max<milliseconds_t>(1, config.interval);
+        m_hb_timer = m_reactor.add_timer(interval, interval, [this] { _heartbeat_tick(); });
+    }
+
+    void stop_heartbeat() {
+        if (m_hb_timer != 0) {
+            m_reactor.cancel_timer(m_hb_timer);
+            m_hb_timer = 0;
+            _notify_heartbeat(heartbeat_event_t::stopped, m_hb_failures,
+                              error_t(error_code_t::ok, "Heartbeat stopped"));
+        }
+    }
+
+private:
+    struct request_t {
+        optional_t<command_t> cmd;            ///< 等待发送时保存命令，发送后清空
+        optional_t<uint32_t> key;             ///< 关联键（编解码器从请求帧中提取）
+        uint8_t function_code = 0;            ///< 请求的功能码（区分主动上报帧）
+        async_callback_t callback;
+        timer_id_t timer = 0;                 ///< 超时定时器
+    };
+
+    using request_ptr_t = std::shared_ptr<request_t>;
+
+    // ========================================================================
+    // I/O 事件
+    // ========================================================================
+
+    void _on_io(uint32_t events) {
+        if (events & io_writable) {
+            _flush_tx();
+        }
+        if (attached() && (events & io_readable)) {
+            _on_readable();
+        }
+    }
+
+    void _on_readable() {
+        byte_span_t space = m_rx_buffer.write_span();
+        if (!space.empty()) {
+            // 就绪事件保证数据已到达，超时只用于防御虚假唤醒
+            auto read_result = m_transport->read(space, 1);
+            if (!read_result) {
+                if (read_result.error().code() != error_code_t::timeout) {
+                    _on_transport_error(read_result.error());
+                }
+                return;
+            }
+            m_rx_buffer.commit_write(*read_result);
+        }
+        _drain_frames();
+    }
+
+    /**
+     * @brief 从接收缓冲区解出所有完整帧并分发
+     */
+    void _drain_frames() {
+        while (attached()) {
+            const_byte_span_t data_span = m_rx_buffer.linearize();
+            const size_t data_size = data_span.size();
+            if (data_size == 0) {
+                return;
+            }
+
+            const size_t frame_len = m_codec->frame_length(data_span);
+            if (frame_len > 0 && frame_len <= data_size) {
+                const optional_t<uint32_t> key =
+                    m_codec->correlation_key(data_span.first(frame_len));
+
+                byte_slice_t slab = m_rx_slabs.copy(data_span.first(frame_len));
+                size_t consumed = 0;
+                auto decode_result = m_codec->decode_slice(slab, consumed);
+                if (!decode_result && consumed == 0) {
+                    consumed = frame_len;
+                }
+                m_rx_buffer.consume(consumed);
+
+                if (decode_result && !m_config.retain_raw_frame) {
+                    decode_result->clear_raw_frame();
+                }
+                _dispatch(std::move(decode_result), key);
+                continue;
+            }
+
+            if (frame_len == 0) {
+                size_t skipped = 0;
+                auto resync_result = m_codec->decode(data_span, skipped);
+                if (!resync_result && skipped > 0 &&
+                    resync_result.error().code() != error_code_t::incomplete_frame) {
+                    VDL_LOG_DEBUG("Discarding %u bytes before frame start",
+                                  static_cast<unsigned>(skipped));
+                    m_rx_buffer.consume(skipped);
+                    continue;
+                }
+            }
+
+            if (m_rx_buffer.full()) {
+                m_rx_buffer.clear();
+                _dispatch(make_error<response_t>(error_code_t::frame_too_large,
+                                                 "Frame exceeds maximum size"), tl::nullopt);
+            }
+            return;
+        }
+    }
+
+    /**
+     * @brief 把一个解码结果交给对应的在途请求，不属于任何请求的帧交给订阅者
+     *
+     * - 带关联键的帧按键匹配，匹配不到即为主动上报帧
+     * - 按顺序匹配时，没有在途请求，或功能码已被订阅且与最早请求的功能码不同，
+     *   即为主动上报帧；其余帧是最早请求的响应
+     */
+    void _dispatch(result_t<response_t> result, const optional_t<uint32_t>& key) {
+        if (m_pending.empty()) {
+            if (result) {
+                _post_unsolicited(std::move(*result));
+            }
+            return;
+        }
+
+        // 单帧解码错误只影响最早的请求
+        request_ptr_t target;
+        if (!result) {
+            target = m_pending.front();
+            m_pending.pop_front();
+        } else if (!key) {
+            const uint8_t code = result->function_code();
+            if (code != m_pending.front()->function_code && m_unsolicited.claims(code)) {
+                _post_unsolicited(std::move(*result));
+                return;
+            }
+            target = m_pending.front();
+            m_pending.pop_front();
+        } else {
+            auto it = std::find_if(m_pending.begin(), m_pending.end(),
+                [&key](const request_ptr_t& r) { return r->key && *r->key == *key; });
+            if (it != m_pending.end()) {
+                target = *it;
+                m_pending.erase(it);
+            }
+        }
+
+        if (!target) {
+            _post_unsolicited(std::move(*result));
+            return;
+        }
+
+        _complete(target, std::move(result));
+        _pump();
+    }
+
+    /**
+     * @brief 把主动上报帧交给分发线程（无锁，不等待订阅者）
+     */
+    void _post_unsolicited(response_t frame) {
+        const uint8_t code = frame.function_code();
+        if (!m_unsolicited.post(std::move(frame))) {
+            VDL_LOG_DEBUG("Dropping unsolicited frame (function code 0x%02X)",
+                          static_cast<unsigned>(code));
+        }
+    }
+
+    // ========================================================================
+    // 发送
+    // ========================================================================
+
+    /**
+     * @brief 在窗口允许时编码排队的请求并发送
+     */
+    void _pump() {
+        const size_t window = std::max<size_t>(1, m_config.max_in_flight);
+        bool queued = false;
+        while (attached() && m_pending.size() < window && !m_backlog.empty()) {
+            request_ptr_t request = m_backlog.front();
+            m_backlog.pop_front();
+
+            auto size_result = m_codec->encoded_size(*request->cmd);
+            if (!size_result) {
+                _complete(request, make_unexpected(size_result.error()));
+                continue;
+            }
+            const size_t offset = m_tx_buffer.size();
+            m_tx_buffer.resize(offset + *size_result);
+            auto encode_result = m_codec->encode_into(
+                *request->cmd, byte_span_t(m_tx_buffer.data() + offset, *size_result));
+            if (!encode_result) {
+                m_tx_buffer.resize(offset);
+                _complete(request, make_unexpected(encode_result.error()));
+                continue;
+            }
+            m_tx_buffer.resize(offset + *encode_result);
+
+            request->key = m_codec->correlation_key(
+                const_byte_span_t(m_tx_buffer.data() + offset, *encode_result));
+            request->cmd = tl::nullopt;
+            m_pending.push_back(std::move(request));
+            queued = true;
+        }
+        if (queued) {
+            _flush_tx();
+        }
+    }
+
+    /**
+     * @brief 写出发送缓冲区，写不完时等待可写事件
+     */
+    void _flush_tx() {
+        while (attached() && m_tx_offset < m_tx_buffer.size()) {
+            const_byte_span_t rest(m_tx_buffer.data() + m_tx_offset,
+                                   m_tx_buffer.size() - m_tx_offset);
+            auto write_result = m_transport->write(rest, 1);
+            if (!write_result) {
+                if (write_result.error().code() == error_code_t::timeout) {
+                    break;
+                }
+                _on_transport_error(write_result.error());
+                return;
+            }
+            if (*write_result == 0) {
+                break;
+            }
+            m_tx_offset += *write_result;
+        }
+        if (!attached()) {
+            return;
+        }
+
+        const bool drained = m_tx_offset >= m_tx_buffer.size();
+        if (drained) {
+            // 发送缓冲区只增不减，稳定运行后编码不再分配内存
+            m_tx_buffer.clear();
+            m_tx_offset = 0;
+        }
+        m_reactor.modify(m_fd, drained ? io_readable : (io_readable | io_writable));
+    }
+
+    // ========================================================================
+    // 完成与错误
+    // ========================================================================
+
+    void _complete(const request_ptr_t& request, result_t<response_t> result) {
+        if (request->timer != 0) {
+            m_reactor.cancel_timer(request->timer);
+            request->timer = 0;
+        }
+        if (request->callback) {
+            async_callback_t cb = std::move(request->callback);
+            request->callback = nullptr;
+            cb(result);
+        }
+    }
+
+    void _on_timeout(const request_ptr_t& request) {
+        auto waiting = std::find(m_backlog.begin(), m_backlog.end(), request);
+        if (waiting != m_backlog.end()) {
+            m_backlog.erase(waiting);
+            _complete(request, make_error<response_t>(error_code_t::timeout, "Response timeout"));
+            return;
+        }
+
+        auto sent = std::find(m_pending.begin(), m_pending.end(), request);
+        if (sent == m_pending.end()) {
+            return;
+        }
+
+        const error_t err(error_code_t::timeout, "Response timeout");
+        if (request->key) {
+            // 带关联键的协议中其他请求不受影响
+            m_pending.erase(sent);
+            _complete(request, make_unexpected(err));
+            _pump();
+            return;
+        }
+
+        // 按顺序匹配的协议无法确定流的对齐位置，丢弃所有在途请求和已收到的数据
+        std::deque<request_ptr_t> pending;
+        pending.swap(m_pending);
+        m_rx_buffer.clear();
+        m_transport->flush_read();
+        for (auto& r : pending) {
+            _complete(r, make_unexpected(err));
+        }
+        _pump();
+    }
+
+    void _on_transport_error(const error_t& error) {
+        VDL_LOG_WARN("Reactor device transport error: %s", error.message().c_str());
+        stop_heartbeat();
+        _detach();
+        m_transport->close();
+        m_state = device_state_t::error;
+        _fail_all(error);
+    }
+
+    void _detach() {
+        if (m_fd >= 0) {
+            m_reactor.unwatch(m_fd);
+            m_fd = -1;
+        }
+        m_rx_buffer.clear();
+        m_tx_buffer.clear();
+        m_tx_offset = 0;
+    }
+
+    void _fail_all(const error_t& error) {
+        std::deque<request_ptr_t> requests;
+        requests.swap(m_pending);
+        for (auto& r : m_backlog) {
+            requests.push_back(std::move(r));
+        }
+        m_backlog.clear();
+        for (auto& r : requests) {
+            _complete(r, make_unexpected(error));
+        }
+    }
+
+    // ========================================================================
+    // 心跳
+    // ========================================================================
+
+    void _heartbeat_tick() {
+        if (m_hb_in_flight) {
+            return;
+        }
+
+        // 设备被独占或正在执行同步命令时跳过本次心跳
+        if (m_hb_config.pause_during_lock) {
+            if (!m_lock.try_lock()) {
+                _notify_heartbeat(heartbeat_event_t::skipped, m_hb_failures,
+                                  error_t(error_code_t::busy, "Heartbeat skipped: device busy"));
+                return;
+            }
+            m_lock.unlock();
+        }
+
+        if (m_state != device_state_t::connected) {
+            _record_heartbeat(false, error_t(error_code_t::not_connected, "Device not connected"));
+            return;
+        }
+
+        if (!m_hb_command || !m_hb_strategy->is_command_reusable()) {
+            auto cmd_result = m_hb_strategy->make_heartbeat_command();
+            if (!cmd_result) {
+                _record_heartbeat(false, cmd_result.error());
+                return;
+            }
+            m_hb_command = std::move(*cmd_result);
+        }
+
+        m_hb_in_flight = true;
+        submit(*m_hb_command, m_hb_config.timeout, [this](const result_t<response_t>& result) {
+            m_hb_in_flight = false;
+            if (!result) {
+                _record_heartbeat(false, result.error());
+            } else if (!m_hb_strategy || !m_hb_strategy->validate_response(*result)) {
+                _record_heartbeat(false, error_t(error_code_t::invalid_format,
+                                                 "Heartbeat response validation failed"));
+            } else {
+                _record_heartbeat(true, error_t(error_code_t::ok, "Heartbeat success"));
+            }
+        });
+    }
+
+    void _record_heartbeat(bool success, const error_t& error) {
+        if (success) {
+            if (m_hb_config.auto_reset_failures) {
+                m_hb_failures = 0;
+            }
+            _notify_heartbeat(heartbeat_event_t::success, 0, error);
+            return;
+        }
+
+        if (m_hb_failures < 0xFF) {
+            ++m_hb_failures;
+        }
+        if (m_hb_failures >= m_hb_config.max_failures) {
+            const uint8_t failures = m_hb_failures;
+            if (m_hb_config.auto_reset_failures) {
+                m_hb_failures = 0;
+            }
+            _notify_heartbeat(heartbeat_event_t::max_failures, failures, error);
+        } else {
+            _notify_heartbeat(heartbeat_event_t::failure, m_hb_failures, error);
+        }
+    }
+
+    void _notify_heartbeat(heartbeat_event_t event, uint8_t failures, const error_t& error) {
+        if (m_hb_callback) {
+            m_hb_callback(event, failures, error);
+        }
+    }
+
+    // ========================================================================
+    // 缓冲区
+    // ========================================================================
+
+    size_t _rx_capacity() const {
+        if (!m_codec) {
+            return k_default_rx_capacity;
+        }
+        return std::max<size_t>(1, m_codec->max_frame_size());
+    }
+
+    void _reset_rx_buffer() {
+        const size_t capacity = _rx_capacity();
+        if (m_rx_buffer.capacity() != capacity) {
+            m_rx_buffer = ring_buffer_t(capacity);
+        } else {
+            m_rx_buffer.clear();
+        }
+    }
+
+    static constexpr size_t k_default_rx_capacity = 65536;
+
+    io_reactor_t& m_reactor;
+    transport_ptr_t m_transport;
+    codec_ptr_t m_codec;
+    std::atomic<device_state_t> m_state;
+    device_config_t m_config;
+    fair_mutex_t m_lock;
+    unsolicited_dispatcher_t m_unsolicited;  ///< 线程安全
+
+    int m_fd = -1;                          ///< 已注册的描述符（传输层关闭后仍用于注销）
+    ring_buffer_t m_rx_buffer;
+    slab_cache_t m_rx_slabs;                ///< 解码用的整帧 slab，稳态下复用
+    bytes_t m_tx_buffer;                    ///< 已编码未写出的数据
+    size_t m_tx_offset = 0;                 ///< 发送缓冲区中已写出的字节数
+    std::deque<request_ptr_t> m_pending;    ///< 已发送等待响应的请求（按发送顺序）
+    std::deque<request_ptr_t> m_backlog;    ///< 在途窗口已满时等待发送的请求
+
+    std::shared_ptr<i_heartbeat_strategy_t> m_hb_strategy;
+    heartbeat_config_t m_hb_config;
+    heartbeat_callback_t m_hb_callback;
+    optional_t<command_t> m_hb_command;
+    timer_id_t m_hb_timer = 0;
+    uint8_t m_hb_failures = 0;
+    bool m_hb_in_flight = false;
+};
+
+}  // namespace detail
+
+// ============================================================================
+// reactor_device_t - 反应器设备
+// ============================================================================
+
+/**
+ * @brief 由 io_reactor_t 驱动的设备
+ *
+ * 一个反应器线程即可服务数百台设备：每台设备的描述符注册到反应器，
+ * 数据到达时读取、解码并完成对应的异步请求，心跳作为反应器定时器运行。
+ *
+ * - execute_async() 线程安全，回调在反应器线程中执行（不得阻塞）
+ * - execute() 阻塞等待异步请求完成，不能在反应器线程中调用
+ * - connect()/disconnect() 在反应器线程之外调用时需要反应器正在运行
+ * - 传输层必须提供 native_handle()（如 tcp_transport_t、serial_transport_t）
+ * - 设备主动上报的帧通过 subscribe() 接收，回调在独立的分发线程中执行
+ *
+ * @code
+ * io_reactor_t reactor;
+ * std::thread loop([&] { reactor.run(); });
+ *
+ * reactor_device_t device(reactor,
+ *     make_unique<tcp_transport_t>("192.168.1.100", 502),
+ *     make_unique<binary_codec_t>());
+ * device.connect();
+ *
+ * device.execute_async(cmd, [](const result_t<response_t>& r) { ... });
+ * auto result = device.execute(cmd);   // 同步调用
+ *
+ * device.subscribe(0x41, [](const response_t& status) { ... });  // 主动上报
+ * @endcode
+ */
+class reactor_device_t : public i_device_t {
+public:
+    /**
+     * @brief 构造函数
+     * @param reactor 驱动该设备的反应器（生命周期必须长于设备）
+     * @param transport 传输层实现
+     * @param codec 编解码器实现
+     */
+    reactor_device_t(io_reactor_t& reactor, transport_ptr_t transport, codec_ptr_t codec)
+        : m_reactor(reactor)
+        , m_channel(std::make_shared<detail::reactor_channel_t>(
+              reactor, std::move(transport), std::move(codec))) {
+    }
+
+    ~reactor_device_t() override {
+        // 订阅回调可能引用调用方对象，先停止分发线程
+        m_channel->unsolicited().stop();
+
+        // 不等待反应器：清理任务持有内部状态，执行完毕后释放
+        std::shared_ptr<detail::reactor_channel_t> channel = m_channel;
+        auto teardown = [channel] {
+            channel->close(error_t(error_code_t::not_connected, "Device destroyed"));
+        };
+        if (m_reactor.in_reactor_thread()) {
+            teardown();
+        } else {
+            m_reactor.post(teardown);
+        }
+    }
+
+    // ========================================================================
+    // i_device_t 实现 - 连接管理
+    // ========================================================================
+
+    result_t<void> connect() override {
+        std::lock_guard<fair_mutex_t> guard(m_channel->lock());
+        if (m_channel->state() == device_state_t::connected) {
+            return make_ok();
+        }
+
+        // 未注册时反应器不会访问传输层，可以在调用线程中阻塞打开
+        auto result = m_channel->transport()->open();
+        if (!result) {
+            return result;
+        }
+
+        std::shared_ptr<detail::reactor_channel_t> channel = m_channel;
+        return _call([channel] { return channel->attach(); });
+    }
+
+    void disconnect() override {
+        std::lock_guard<fair_mutex_t> guard(m_channel->lock());
+        std::shared_ptr<detail::reactor_channel_t> channel = m_channel;
+        _call([channel] {
+            channel->close(error_t(error_code_t::not_connected, "Device disconnected"));
+            return make_ok();
+        });
+    }
+
+    device_state_t state() const override {
+        return m_channel->state();
+    }
+
+    bool is_connected() const override {
+        return m_channel->state() == device_state_t::connected;
+    }
+
+    // ========================================================================
+    // i_device_t 实现 - 命令执行
+    // ========================================================================
+
+    result_t<response_t> execute(const command_t& cmd) override {
+        return execute(cmd, m_config.command_timeout);
+    }
+
+    result_t<response_t> execute(const command_t& cmd,
+                                  milliseconds_t timeout_ms) override {
+        if (m_reactor.in_reactor_thread()) {
+            return make_error<response_t>(error_code_t::invalid_state,
+                                          "Blocking execute on reactor thread");
+        }
+
+        std::lock_guard<fair_mutex_t> guard(m_channel->lock());
+        auto done = std::make_shared<std::promise<result_t<response_t>>>();
+        std::future<result_t<response_t>> future = done->get_future();
+        execute_async(cmd, timeout_ms, [done](const result_t<response_t>& result) {
+            done->set_value(result);
+        });
+        return future.get();
+    }
+
+    /**
+     * @brief 异步执行命令（线程安全）
+     * @param cmd 命令对象
+     * @param callback 完成回调，在反应器线程中执行
+     *
+     * 超过 max_in_flight 的请求在设备内排队，超时从提交时开始计算。
+     */
+    void execute_async(const command_t& cmd, async_callback_t callback) {
+        execute_async(cmd, m_config.command_timeout, std::move(callback));
+    }
+
+    /**
+     * @brief 异步执行命令（带超时，线程安全）
+     */
+    void execute_async(const command_t& cmd, milliseconds_t timeout_ms,
+                       async_callback_t callback) {
+        if (m_reactor.in_reactor_thread()) {
+            m_channel->submit(cmd, timeout_ms, std::move(callback));
+            return;
+        }
+        std::shared_ptr<detail::reactor_channel_t> channel = m_channel;
+        m_reactor.post([channel, cmd, timeout_ms, callback] {
+            channel->submit(cmd, timeout_ms, callback);
+        });
+    }
+
+    // ========================================================================
+    // 心跳
+    // ========================================================================
+
+    /**
+     * @brief 启动心跳（作为反应器定时器运行，不创建线程）
+     * @param strategy 心跳策略
+     * @param config 心跳配置
+     * @param callback 事件回调，在反应器线程中执行
+     */
+    void start_heartbeat(heartbeat_strategy_ptr_t strategy,
+                         const heartbeat_config_t& config = heartbeat_config_t(),
+                         heartbeat_callback_t callback = nullptr) {
+        std::shared_ptr<detail::reactor_channel_t> channel = m_channel;
+        std::shared_ptr<i_heartbeat_strategy_t> shared_strategy(std::move(strategy));
+        _run([channel, shared_strategy, config, callback] {
+            channel->start_heartbeat(shared_strategy, config, callback);
+        });
+    }
+
+    /**
+     * @brief 停止心跳（返回后回调不会再被调用）
+     */
+    void stop_heartbeat() {
+        std::shared_ptr<detail::reactor_channel_t> channel = m_channel;
+        _call([channel] {
+            channel->stop_heartbeat();
+            return make_ok();
+        });
+    }
+
+    // ========================================================================
+    // 主动上报帧
+    // ========================================================================
+
+    /**
+     * @brief 订阅指定功能码的主动上报帧（线程安全）
+     * @param function_code 功能码
+     * @param callback 回调，在分发线程中执行，可以阻塞而不影响接收
+     * @return 订阅标识
+     *
+     * 对按顺序匹配的协议，被订阅的功能码若与最早在途请求的功能码不同，
+     * 该帧按主动上报处理而不会被当作请求的响应。
+     */
+    subscription_id_t subscribe(uint8_t function_code, unsolicited_callback_t callback) {
+        return m_channel->unsolicited().subscribe(function_code, std::move(callback));
+    }
+
+    /**
+     * @brief 订阅所有主动上报帧（线程安全）
+     */
+    subscription_id_t subscribe_all(unsolicited_callback_t callback) {
+        return m_channel->unsolicited().subscribe_all(std::move(callback));
+    }
+
+    /**
+     * @brief 取消订阅（线程安全）
+     */
+    bool unsubscribe(subscription_id_t id) {
+        return m_channel->unsolicited().unsubscribe(id);
+    }
+
+    /**
+     * @brief 分发队列已满而丢弃的主动上报帧数
+     */
+    uint64_t unsolicited_dropped() const {
+        return m_channel->unsolicited().dropped_count();
+    }
+
+    // ========================================================================
+    // i_device_t 实现 - 独占访问
+    // ========================================================================
+
+    void lock() override {
+        m_channel->lock().lock();
+    }
+
+    bool try_lock() override {
+        return m_channel->lock().try_lock();
+    }
+
+    bool try_lock_for(milliseconds_t timeout_ms) override {
+        return m_channel->lock().try_lock_for(timeout_ms);
+    }
+
+    void unlock() override {
+        m_channel->lock().unlock();
+    }
+
+    // ========================================================================
+    // i_device_t 实现 - 设备信息
+    // ========================================================================
+
+    const device_info_t& info() const override {
+        return m_info;
+    }
+
+    const device_config_t& config() const override {
+        return m_config;
+    }
+
+    void set_config(const device_config_t& config) override {
+        m_config = config;
+        std::shared_ptr<detail::reactor_channel_t> channel = m_channel;
+        _run([channel, config] { channel->set_config(config); });
+    }
+
+    const char* type_name() const override {
+        return "reactor_device";
+    }
+
+    io_reactor_t& reactor() {
+        return m_reactor;
+    }
+
+private:
+    /**
+     * @brief 在反应器线程中执行（当前就是反应器线程时直接执行）
+     */
+    void _run(std::function<void()> task) {
+        if (m_reactor.in_reactor_thread()) {
+            task();
+        } else {
+            m_reactor.post(std::move(task));
+        }
+    }
+
+    /**
+     * @brief 在反应器线程中执行并等待结果
+     */
+    result_t<void> _call(std::function<result_t<void>()> task) {
+        if (m_reactor.in_reactor_thread()) {
+            return task();
+        }
+        auto done = std::make_shared<std::promise<result_t<void>>>();
+        std::future<result_t<void>> future = done->get_future();
+        m_reactor.post([task, done] { done->set_value(task()); });
+        return future.get();
+    }
+
+    io_reactor_t& m_reactor;
+    std::shared_ptr<detail::reactor_channel_t> m_channel;
+    device_info_t m_info;
+    device_config_t m_config;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_REACTOR_REACTOR_DEVICE_HPP
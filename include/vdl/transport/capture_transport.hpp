@@ -0,0 +1,809 @@
+/**
+ * @file capture_transport.hpp
+ * @brief 线路抓包（POSIX 内存映射文件）
+ *
+ * 以传输层装饰器的形式记录原始读写字节，不改变被装饰传输层的时序：
+ * 每条记录只需一次原子偏移递增和一次负载 memcpy，写入预分配的内存映射文件。
+ *
+ * 文件格式为 pcapng（主机字节序）：
+ * - 文件头：Section Header Block + 每个设备一个 Interface Description Block
+ *   （链路类型 LINKTYPE_USER0，if_name 为设备名，时间戳精度微秒）
+ * - 每次读写一个 Enhanced Packet Block，epb_flags 的低两位表示方向
+ *
+ * 可直接用 Wireshark/tshark 打开，也可用 capture_reader_t 读取。
+ *
+ * @code
+ * capture_config_t config;
+ * config.path = "/var/log/vdl/session.pcapng";
+ * auto capture = std::make_shared<capture_file_t>(config);
+ * capture->open();
+ *
+ * transport_ptr_t transport(new capture_transport_t(
+ *     make_unique<tcp_transport_t>("192.168.1.10", 5025), capture, "dmm"));
+ * @endcode
+ */
+
+#ifndef VDL_TRANSPORT_CAPTURE_TRANSPORT_HPP
+#define VDL_TRANSPORT_CAPTURE_TRANSPORT_HPP
+
+#include "transport.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace vdl {
+
+// ============================================================================
+// 抓包格式
+// ============================================================================
+
+/**
+ * @brief 数据方向
+ */
+enum class capture_direction_t : uint8_t {
+    inbound = 1,        ///< 设备 → 主机（read）
+    outbound = 2        ///< 主机 → 设备（write）
+};
+
+namespace detail {
+
+// pcapng 块类型与常量
+constexpr uint32_t k_pcapng_shb = 0x0A0D0D0A;
+constexpr uint32_t k_pcapng_idb = 0x00000001;
+constexpr uint32_t k_pcapng_epb = 0x00000006;
+constexpr uint32_t k_pcapng_byte_order_magic = 0x1A2B3C4D;
+constexpr uint16_t k_pcapng_linktype_user0 = 147;
+constexpr uint16_t k_pcapng_opt_end = 0;
+constexpr uint16_t k_pcapng_opt_if_name = 2;
+constexpr uint16_t k_pcapng_opt_if_tsresol = 9;
+constexpr uint16_t k_pcapng_opt_epb_flags = 2;
+constexpr size_t k_pcapng_shb_size = 28;
+constexpr size_t k_pcapng_epb_overhead = 44;        ///< 不含负载（及其填充）的 EPB 长度
+
+inline size_t pcapng_pad4(size_t size) {
+    return (size + 3) & ~static_cast<size_t>(3);
+}
+
+inline void pcapng_put16(uint8_t*& out, uint16_t value) {
+    std::memcpy(out, &value, sizeof(value));
+    out += sizeof(value);
+}
+
+inline void pcapng_put32(uint8_t*& out, uint32_t value) {
+    std::memcpy(out, &value, sizeof(value));
+    out += sizeof(value);
+}
+
+inline uint32_t pcapng_get32(const uint8_t* in) {
+    uint32_t value;
+    std::memcpy(&value, in, sizeof(value));
+    return value;
+}
+
+inline uint16_t pcapng_get16(const uint8_t* in) {
+    uint16_t value;
+    std::memcpy(&value, in, sizeof(value));
+    return value;
+}
+
+inline size_t pcapng_idb_size(const std::string& name) {
+    // 头部 16 + if_name 选项 + if_tsresol 选项 8 + opt_endofopt 4 + 尾部长度 4
+    return 16 + 4 + pcapng_pad4(name.size()) + 8 + 4 + 4;
+}
+
+inline void pcapng_write_shb(uint8_t* out) {
+    pcapng_put32(out, k_pcapng_shb);
+    pcapng_put32(out, static_cast<uint32_t>(k_pcapng_shb_size));
+    pcapng_put32(out, k_pcapng_byte_order_magic);
+    pcapng_put16(out, 1);                                   // 主版本
+    pcapng_put16(out, 0);                                   // 次版本
+    const int64_t section_length = -1;                      // 未指定
+    std::memcpy(out, &section_length, sizeof(section_length));
+    out += sizeof(section_length);
+    pcapng_put32(out, static_cast<uint32_t>(k_pcapng_shb_size));
+}
+
+inline void pcapng_write_idb(uint8_t* out, const std::string& name, uint32_t snap_length) {
+    const uint32_t total = static_cast<uint32_t>(pcapng_idb_size(name));
+    pcapng_put32(out, k_pcapng_idb);
+    pcapng_put32(out, total);
+    pcapng_put16(out, k_pcapng_linktype_user0);
+    pcapng_put16(out, 0);
+    pcapng_put32(out, snap_length);
+    pcapng_put16(out, k_pcapng_opt_if_name);
+    pcapng_put16(out, static_cast<uint16_t>(name.size()));
+    std::memcpy(out, name.data(), name.size());
+    std::memset(out + name.size(), 0, pcapng_pad4(name.size()) - name.size());
+    out += pcapng_pad4(name.size());
+    pcapng_put16(out, k_pcapng_opt_if_tsresol);
+    pcapng_put16(out, 1);
+    pcapng_put32(out, 6);                                   // 10^-6 秒，其余 3 字节为填充
+    pcapng_put32(out, k_pcapng_opt_end);
+    pcapng_put32(out, total);
+}
+
+}  // namespace detail
+
+// ============================================================================
+// capture_config_t - 抓包配置
+// ============================================================================
+
+/**
+ * @brief 抓包文件配置
+ *
+ * 文件写满 file_size 后滚动到下一个文件：path、path.1、path.2 ……
+ * max_files 大于 0 时文件名循环使用，只保留最近的 max_files 个文件。
+ */
+struct capture_config_t {
+    std::string path;                           ///< 首个文件路径
+    size_t file_size = 64 * 1024 * 1024;        ///< 每个文件预分配的大小
+    size_t max_files = 0;                       ///< 0 表示不限
+    uint32_t snap_length = 65536;               ///< 单条记录最多保存的字节（超出部分截断）
+};
+
+// ============================================================================
+// capture_file_t - 抓包文件写入器
+// ============================================================================
+
+/**
+ * @brief 内存映射的追加式抓包文件
+ *
+ * 多个 capture_transport_t 可共享同一个文件，每个设备对应一个接口 ID。
+ *
+ * - record() 无锁：原子递增写偏移预留空间，然后直接写入映射内存
+ * - 预留空间越过文件末尾时转入滚动（加锁，等待旧文件上的写入完成后截断并解除映射）
+ * - 未打开或打开失败时记录被丢弃并计数
+ *
+ * @note 线程安全
+ */
+class capture_file_t : private noncopyable_t, private nonmovable_t {
+public:
+    explicit capture_file_t(const capture_config_t& config)
+        : m_config(config) {}
+
+    ~capture_file_t() {
+        close();
+    }
+
+    /**
+     * @brief 创建（覆盖）首个文件并写入文件头
+     */
+    result_t<void> open() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_current.load()) {
+            return make_error_void(error_code_t::already_initialized, "Capture: already open");
+        }
+        if (m_config.path.empty()) {
+            return make_error_void(error_code_t::invalid_argument, "Capture: empty path");
+        }
+        if (m_config.snap_length == 0) {
+            m_config.snap_length = 1;
+        }
+        if (m_config.file_size < _header_size_locked() + _max_record_size()) {
+            return make_error_void(error_code_t::invalid_argument,
+                                   "Capture: file size too small for one record");
+        }
+        m_file_index = 0;
+        return _open_segment_locked();
+    }
+
+    /**
+     * @brief 截断到已写入的长度并关闭
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        segment_t* segment = m_current.load();
+        if (!segment) {
+            return;
+        }
+        m_current.store(nullptr);
+        _finish_segment_locked(segment);
+    }
+
+    bool is_open() const {
+        return m_current.load(std::memory_order_acquire) != nullptr;
+    }
+
+    /**
+     * @brief 登记一个设备，返回其接口 ID
+     *
+     * 已打开时立即写入接口描述块；之后滚动出的每个文件都会重写全部接口。
+     */
+    uint32_t add_interface(const std::string& name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const uint32_t id = static_cast<uint32_t>(m_interfaces.size());
+        m_interfaces.push_back(name.size() > 0xFFFF ? name.substr(0, 0xFFFF) : name);
+
+        segment_t* segment = m_current.load();
+        if (segment) {
+            const size_t size = detail::pcapng_idb_size(m_interfaces.back());
+            // 持锁期间不会滚动，写入者只会推进偏移
+            const size_t offset = segment->offset.fetch_add(size);
+            if (offset + size <= segment->size) {
+                detail::pcapng_write_idb(segment->base + offset, m_interfaces.back(),
+                                         m_config.snap_length);
+            } else {
+                _mark_end(segment, offset);
+                _roll_locked(segment);   // 新文件头已包含该接口
+            }
+        }
+        return id;
+    }
+
+    /**
+     * @brief 记录一段数据（热路径，任意线程）
+     * @return 文件未打开时返回 false
+     */
+    bool record(uint32_t interface_id, capture_direction_t direction, const_byte_span_t data) {
+        const size_t captured = data.size() < m_config.snap_length
+            ? data.size() : static_cast<size_t>(m_config.snap_length);
+        const size_t size = detail::k_pcapng_epb_overhead + detail::pcapng_pad4(captured);
+        const uint64_t timestamp = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+
+        while (true) {
+            segment_t* segment = _acquire();
+            if (!segment) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            const size_t offset = segment->offset.fetch_add(size, std::memory_order_relaxed);
+            if (offset + size <= segment->size) {
+                _write_epb(segment->base + offset, size, interface_id, direction, timestamp,
+                           data.data(), captured, data.size());
+                segment->writers.fetch_sub(1, std::memory_order_release);
+                m_records.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            _mark_end(segment, offset);
+            segment->writers.fetch_sub(1, std::memory_order_release);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_current.load() == segment) {
+                _roll_locked(segment);
+            }
+        }
+    }
+
+    // ========================================================================
+    // 统计
+    // ========================================================================
+
+    uint64_t record_count() const {
+        return m_records.load(std::memory_order_relaxed);
+    }
+
+    uint64_t dropped_count() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 已创建的文件数（含当前文件，max_files 循环覆盖的也计入）
+     */
+    size_t file_count() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_files_created;
+    }
+
+    /**
+     * @brief 第 index 个文件的路径（考虑 max_files 循环）
+     */
+    std::string file_path(size_t index) const {
+        if (m_config.max_files > 0) {
+            index %= m_config.max_files;
+        }
+        return index == 0 ? m_config.path : m_config.path + "." + std::to_string(index);
+    }
+
+    const capture_config_t& config() const {
+        return m_config;
+    }
+
+private:
+    struct segment_t {
+        int fd = -1;
+        uint8_t* base = nullptr;
+        size_t size = 0;
+        std::atomic<size_t> offset{0};
+        std::atomic<size_t> end{0};                 ///< 有效数据长度（越界的预留写入者设置）
+        std::atomic<bool> full{false};
+        std::atomic<uint32_t> writers{0};           ///< 正在写入映射内存的线程数
+    };
+
+    // 进入当前文件；返回后调用者必须递减 writers
+    segment_t* _acquire() {
+        while (true) {
+            segment_t* segment = m_current.load();
+            if (!segment) {
+                return nullptr;
+            }
+            segment->writers.fetch_add(1);
+            // 与滚动方“先替换再等待 writers 归零”配对（均为顺序一致操作）
+            if (m_current.load() == segment) {
+                return segment;
+            }
+            segment->writers.fetch_sub(1);
+        }
+    }
+
+    // 恰好有一个预留越过文件末尾，其起点即有效数据长度
+    static void _mark_end(segment_t* segment, size_t offset) {
+        if (offset <= segment->size && !segment->full.exchange(true)) {
+            segment->end.store(offset);
+        }
+    }
+
+    static void _write_epb(uint8_t* out, size_t size, uint32_t interface_id,
+                           capture_direction_t direction, uint64_t timestamp,
+                           const uint8_t* data, size_t captured, size_t original) {
+        uint32_t header[7];
+        header[0] = detail::k_pcapng_epb;
+        header[1] = static_cast<uint32_t>(size);
+        header[2] = interface_id;
+        header[3] = static_cast<uint32_t>(timestamp >> 32);
+        header[4] = static_cast<uint32_t>(timestamp);
+        header[5] = static_cast<uint32_t>(captured);
+        header[6] = static_cast<uint32_t>(original);
+        std::memcpy(out, header, sizeof(header));
+        out += sizeof(header);
+
+        std::memcpy(out, data, captured);
+        out += captured;
+        const size_t padding = detail::pcapng_pad4(captured) - captured;
+        std::memset(out, 0, padding);
+        out += padding;
+
+        uint32_t trailer[4];
+        trailer[0] = static_cast<uint32_t>(detail::k_pcapng_opt_epb_flags) | (4u << 16);
+        trailer[1] = static_cast<uint32_t>(direction);
+        trailer[2] = detail::k_pcapng_opt_end;
+        trailer[3] = static_cast<uint32_t>(size);
+        std::memcpy(out, trailer, sizeof(trailer));
+    }
+
+    size_t _max_record_size() const {
+        return detail::k_pcapng_epb_overhead + detail::pcapng_pad4(m_config.snap_length);
+    }
+
+    size_t _header_size_locked() const {
+        size_t size = detail::k_pcapng_shb_size;
+        for (const auto& name : m_interfaces) {
+            size += detail::pcapng_idb_size(name);
+        }
+        return size;
+    }
+
+    result_t<void> _open_segment_locked() {
+        const std::string path = file_path(m_file_index);
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return make_error_void(errno == EACCES ? error_code_t::file_access_denied
+                                                   : error_code_t::io_error,
+                                   "Capture: cannot create file");
+        }
+
+        size_t size = m_config.file_size;
+        const size_t header = _header_size_locked();
+        if (size < header + _max_record_size()) {
+            size = header + _max_record_size();    // 接口过多时保证至少容纳一条记录
+        }
+        const off_t length = static_cast<off_t>(size);
+        if (::posix_fallocate(fd, 0, length) != 0 && ::ftruncate(fd, length) != 0) {
+            ::close(fd);
+            return make_error_void(error_code_t::io_error, "Capture: cannot preallocate file");
+        }
+        void* base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            ::close(fd);
+            return make_error_void(error_code_t::io_error, "Capture: mmap failed");
+        }
+
+        std::unique_ptr<segment_t> segment(new segment_t());
+        segment->fd = fd;
+        segment->base = static_cast<uint8_t*>(base);
+        segment->size = size;
+
+        uint8_t* out = segment->base;
+        detail::pcapng_write_shb(out);
+        out += detail::k_pcapng_shb_size;
+        for (const auto& name : m_interfaces) {
+            detail::pcapng_write_idb(out, name, m_config.snap_length);
+            out += detail::pcapng_idb_size(name);
+        }
+        segment->offset.store(header);
+
+        ++m_files_created;
+
+        // 旧段对象保留到析构：迟到的写入者可能仍在读取其计数器
+        m_current.store(segment.get());
+        m_segments.push_back(std::move(segment));
+        return make_ok();
+    }
+
+    void _roll_locked(segment_t* segment) {
+        ++m_file_index;
+        auto opened = _open_segment_locked();
+        if (!opened) {
+            m_current.store(nullptr);
+        }
+        _finish_segment_locked(segment);
+    }
+
+    void _finish_segment_locked(segment_t* segment) {
+        while (segment->writers.load() != 0) {
+            std::this_thread::yield();
+        }
+        size_t used = segment->full.load() ? segment->end.load() : segment->offset.load();
+        if (used > segment->size) {
+            used = segment->size;
+        }
+        ::munmap(segment->base, segment->size);
+        segment->base = nullptr;
+        if (::ftruncate(segment->fd, static_cast<off_t>(used)) != 0) {
+            // 截断失败时保留预分配的零填充尾部，读取方遇到零块类型即停止
+        }
+        ::close(segment->fd);
+        segment->fd = -1;
+    }
+
+    capture_config_t m_config;
+    mutable std::mutex m_mutex;                     ///< 打开、滚动、登记接口
+    std::atomic<segment_t*> m_current{nullptr};
+    std::vector<std::unique_ptr<segment_t>> m_segments;
+    std::vector<std::string> m_interfaces;
+    size_t m_file_index = 0;                        ///< 当前文件序号
+    size_t m_files_created = 0;
+    std::atomic<uint64_t> m_records{0};
+    std::atomic<uint64_t> m_dropped{0};
+};
+
+using capture_file_ptr_t = std::shared_ptr<capture_file_t>;
+
+// ============================================================================
+// capture_reader_t - 抓包文件读取器
+// ============================================================================
+
+/**
+ * @brief 一条抓包记录
+ *
+ * data 指向映射内存，在读取器关闭前有效。
+ */
+struct capture_record_t {
+    uint32_t interface_id = 0;
+    capture_direction_t direction = capture_direction_t::inbound;
+    microseconds_t timestamp = 0;           ///< 自 1970-01-01 起的微秒数
+    size_t original_length = 0;             ///< 截断前的长度
+    const_byte_span_t data;
+};
+
+/**
+ * @brief 只读映射一个抓包文件并按顺序遍历记录
+ *
+ * 只支持本库写出的主机字节序文件；未知块被跳过。
+ */
+class capture_reader_t : private noncopyable_t {
+public:
+    capture_reader_t() = default;
+
+    ~capture_reader_t() {
+        close();
+    }
+
+    result_t<void> open(const std::string& path) {
+        close();
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return make_error_void(errno == ENOENT ? error_code_t::file_not_found
+                                                   : error_code_t::file_access_denied,
+                                   "Capture: cannot open file");
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(detail::k_pcapng_shb_size)) {
+            ::close(fd);
+            return make_error_void(error_code_t::invalid_format, "Capture: file too short");
+        }
+        const size_t size = static_cast<size_t>(info.st_size);
+        void* base = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            return make_error_void(error_code_t::io_error, "Capture: mmap failed");
+        }
+        m_base = static_cast<const uint8_t*>(base);
+        m_size = size;
+
+        if (detail::pcapng_get32(m_base) != detail::k_pcapng_shb ||
+            detail::pcapng_get32(m_base + 8) != detail::k_pcapng_byte_order_magic) {
+            close();
+            return make_error_void(error_code_t::invalid_format, "Capture: not a VDL capture file");
+        }
+        rewind();
+        return make_ok();
+    }
+
+    void close() {
+        if (m_base) {
+            ::munmap(const_cast<uint8_t*>(m_base), m_size);
+        }
+        m_base = nullptr;
+        m_size = 0;
+        m_offset = 0;
+        m_interfaces.clear();
+    }
+
+    bool is_open() const {
+        return m_base != nullptr;
+    }
+
+    /**
+     * @brief 回到第一条记录
+     */
+    void rewind() {
+        m_offset = m_base ? detail::pcapng_get32(m_base + 4) : 0;
+        m_interfaces.clear();
+    }
+
+    /**
+     * @brief 读取下一条记录
+     * @return 文件结束时返回 false
+     */
+    bool next(capture_record_t& out) {
+        while (m_base && m_offset + 12 <= m_size) {
+            const uint8_t* block = m_base + m_offset;
+            const uint32_t type = detail::pcapng_get32(block);
+            const uint32_t length = detail::pcapng_get32(block + 4);
+            if (type == 0 || length < 12 || (length & 3) != 0 || m_offset + length > m_size) {
+                m_offset = m_size;   // 预分配的零填充尾部或截断的块
+                return false;
+            }
+            m_offset += length;
+
+            if (type == detail::k_pcapng_idb) {
+                _parse_idb(block, length);
+            } else if (type == detail::k_pcapng_epb && length >= detail::k_pcapng_epb_overhead) {
+                const uint32_t captured = detail::pcapng_get32(block + 20);
+                if (28 + static_cast<size_t>(captured) + 4 > length) {
+                    continue;
+                }
+                out.interface_id = detail::pcapng_get32(block + 8);
+                out.timestamp = static_cast<microseconds_t>(
+                    (static_cast<uint64_t>(detail::pcapng_get32(block + 12)) << 32) |
+                    detail::pcapng_get32(block + 16));
+                out.original_length = detail::pcapng_get32(block + 24);
+                out.data = const_byte_span_t(block + 28, captured);
+                out.direction = _parse_direction(block + 28 + detail::pcapng_pad4(captured),
+                                                 block + length - 4);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 已读到的接口名（按接口 ID）
+     */
+    const std::vector<std::string>& interfaces() const {
+        return m_interfaces;
+    }
+
+private:
+    void _parse_idb(const uint8_t* block, uint32_t length) {
+        std::string name;
+        const uint8_t* option = block + 16;
+        const uint8_t* end = block + length - 4;
+        while (option + 4 <= end) {
+            const uint16_t code = detail::pcapng_get16(option);
+            const uint16_t size = detail::pcapng_get16(option + 2);
+            if (code == detail::k_pcapng_opt_end || option + 4 + size > end) {
+                break;
+            }
+            if (code == detail::k_pcapng_opt_if_name) {
+                name.assign(reinterpret_cast<const char*>(option + 4), size);
+            }
+            option += 4 + detail::pcapng_pad4(size);
+        }
+        m_interfaces.push_back(name);
+    }
+
+    static capture_direction_t _parse_direction(const uint8_t* option, const uint8_t* end) {
+        while (option + 4 <= end) {
+            const uint16_t code = detail::pcapng_get16(option);
+            const uint16_t size = detail::pcapng_get16(option + 2);
+            if (code == detail::k_pcapng_opt_end || option + 4 + size > end) {
+                break;
+            }
+            if (code == detail::k_pcapng_opt_epb_flags && size == 4) {
+                return (detail::pcapng_get32(option + 4) & 3u) ==
+                       static_cast<uint32_t>(capture_direction_t::outbound)
+                    ? capture_direction_t::outbound : capture_direction_t::inbound;
+            }
+            option += 4 + detail::pcapng_pad4(size);
+        }
+        return capture_direction_t::inbound;
+    }
+
+    const uint8_t* m_base = nullptr;
+    size_t m_size = 0;
+    size_t m_offset = 0;
+    std::vector<std::string> m_interfaces;
+};
+
+// ============================================================================
+// capture_transport_t - 抓包装饰器
+// ============================================================================
+
+/**
+ * @brief 记录读写字节的传输层装饰器
+ *
+ * 所有操作转发给被装饰的传输层，成功读写的字节同时写入抓包文件，
+ * 失败（超时等）不产生记录。
+ */
+class capture_transport_t : public i_transport_t {
+public:
+    /**
+     * @param inner 被装饰的传输层
+     * @param file 抓包文件（可与其他设备共享）
+     * @param device_name 接口名，用于区分同一文件中的设备
+     */
+    capture_transport_t(transport_ptr_t inner, capture_file_ptr_t file,
+                        const std::string& device_name)
+        : m_inner(std::move(inner))
+        , m_file(std::move(file))
+        , m_interface_id(m_file ? m_file->add_interface(device_name) : 0) {}
+
+    result_t<void> open() override {
+        return m_inner->open();
+    }
+
+    void close() override {
+        m_inner->close();
+    }
+
+    bool is_open() const override {
+        return m_inner->is_open();
+    }
+
+    result_t<size_t> read(byte_span_t buffer, milliseconds_t timeout_ms = 0) override {
+        auto result = m_inner->read(buffer, timeout_ms);
+        if (result && *result > 0) {
+            _record(capture_direction_t::inbound, buffer.first(*result));
+        }
+        return result;
+    }
+
+    result_t<size_t> write(const_byte_span_t data, milliseconds_t timeout_ms = 0) override {
+        auto result = m_inner->write(data, timeout_ms);
+        if (result && *result > 0) {
+            _record(capture_direction_t::outbound, data.first(*result));
+        }
+        return result;
+    }
+
+    result_t<size_t> writev(span_t<const const_byte_span_t> pieces,
+                            milliseconds_t timeout_ms = 0) override {
+        auto result = m_inner->writev(pieces, timeout_ms);
+        if (result) {
+            size_t left = *result;
+            for (size_t i = 0; i < pieces.size() && left > 0; ++i) {
+                const size_t size = pieces[i].size() < left ? pieces[i].size() : left;
+                if (size > 0) {
+                    _record(capture_direction_t::outbound, pieces[i].first(size));
+                }
+                left -= size;
+            }
+        }
+        return result;
+    }
+
+    result_t<size_t> readv(span_t<const byte_span_t> buffers,
+                           milliseconds_t timeout_ms = 0) override {
+        auto result = m_inner->readv(buffers, timeout_ms);
+        if (result) {
+            size_t left = *result;
+            for (size_t i = 0; i < buffers.size() && left > 0; ++i) {
+                const size_t size = buffers[i].size() < left ? buffers[i].size() : left;
+                if (size > 0) {
+                    _record(capture_direction_t::inbound, const_byte_span_t(buffers[i].data(), size));
+                }
+                left -= size;
+            }
+        }
+        return result;
+    }
+
+    void flush_read() override {
+        m_inner->flush_read();
+    }
+
+    void flush_write() override {
+        m_inner->flush_write();
+    }
+
+    result_t<void> wait_service_request(milliseconds_t timeout_ms) override {
+        return m_inner->wait_service_request(timeout_ms);
+    }
+
+    result_t<uint8_t> read_status_byte() override {
+        return m_inner->read_status_byte();
+    }
+
+    const transport_config_t& config() const override {
+        return m_inner->config();
+    }
+
+    void set_config(const transport_config_t& config) override {
+        m_inner->set_config(config);
+    }
+
+    const char* type_name() const override {
+        return m_inner->type_name();
+    }
+
+    int native_handle() const override {
+        return m_inner->native_handle();
+    }
+
+    transport_stats_t stats() const override {
+        return m_inner->stats();
+    }
+
+    void reset_stats() override {
+        m_inner->reset_stats();
+    }
+
+    // ========================================================================
+    // 抓包控制
+    // ========================================================================
+
+    /**
+     * @brief 暂停/恢复记录（不影响数据转发）
+     */
+    void set_capture_enabled(bool enabled) {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool capture_enabled() const {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    uint32_t interface_id() const {
+        return m_interface_id;
+    }
+
+    i_transport_t& inner() {
+        return *m_inner;
+    }
+
+    const capture_file_ptr_t& capture_file() const {
+        return m_file;
+    }
+
+private:
+    void _record(capture_direction_t direction, const_byte_span_t data) {
+        if (m_file && m_enabled.load(std::memory_order_relaxed)) {
+            m_file->record(m_interface_id, direction, data);
+        }
+    }
+
+    transport_ptr_t m_inner;
+    capture_file_ptr_t m_file;
+    const uint32_t m_interface_id;
+    std::atomic<bool> m_enabled{true};
+};
+
+}  // namespace vdl
+
+#endif  // VDL_TRANSPORT_CAPTURE_TRANSPORT_HPP
@@ -10,6 +10,9 @@
 #include "../core/buffer.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 
 namespace vdl {
 
@@ -106,29 +109,65 @@ public:
                                       "Mock: not connected");
         }
 
-        if (m_fail_write_times > 0) {
-            --m_fail_write_times;
-            return make_error<size_t>(error_code_t::write_failed,
-                                      "Mock: simulated transient write failure");
+        auto check = _check_write();
+        if (!check) {
+            return make_unexpected(check.error());
         }
 
-        if (m_should_fail_write) {
-            return make_error<size_t>(error_code_t::write_failed,
-                                      "Mock: simulated write failure");
+        // 保存写入的数据
+        m_write_buffer.insert(m_write_buffer.end(), data.begin(), data.end());
+
+        return data.size();
+    }
+
+    result_t<size_t> writev(span_t<const const_byte_span_t> pieces,
+                            milliseconds_t /*timeout_ms*/ = 0) override {
+        if (!m_is_open) {
+            return make_error<size_t>(error_code_t::not_connected,
+                                      "Mock: not connected");
         }
 
-        // 保存写入的数据
-        for (size_t i = 0; i < data.size(); ++i) {
-            m_write_buffer.push_back(data[i]);
+        auto check = _check_write();
+        if (!check) {
+            return make_unexpected(check.error());
         }
 
-        return data.size();
+        // 一次调用写出所有片段（模拟向量化系统调用）
+        size_t total = 0;
+        for (size_t i = 0; i < pieces.size(); ++i) {
+            m_write_buffer.insert(m_write_buffer.end(), pieces[i].begin(), pieces[i].end());
+            total += pieces[i].size();
+        }
+
+        return total;
     }
 
     void flush_read() override {
         m_read_buffer.clear();
     }
 
+    result_t<void> wait_service_request(milliseconds_t timeout_ms) override {
+        std::unique_lock<std::mutex> lock(m_srq_mutex);
+        if (!m_srq_supported) {
+            return transport_base_t::wait_service_request(timeout_ms);
+        }
+        if (!m_srq_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                               [this] { return m_srq_pending; })) {
+            return make_error_void(error_code_t::timeout, "Mock: no service request");
+        }
+        m_srq_pending = false;
+        return make_ok();
+    }
+
+    result_t<uint8_t> read_status_byte() override {
+        std::lock_guard<std::mutex> lock(m_srq_mutex);
+        if (!m_srq_supported) {
+            return transport_base_t::read_status_byte();
+        }
+        ++m_status_polls;
+        return m_status_byte;
+    }
+
     const char* type_name() const override {
         return "mock";
     }
@@ -157,6 +196,13 @@ public:
         return m_write_buffer;
     }
 
+    /**
+     * @brief 获取 write()/writev() 的调用次数
+     */
+    uint32_t write_call_count() const {
+        return m_write_calls;
+    }
+
     /**
      * @brief 清空已写入的数据
      */
@@ -232,7 +278,54 @@ public:
         m_auto_response.clear();
     }
 
+    /**
+     * @brief 设置是否模拟 SRQ 通道（默认不支持）
+     */
+    void set_service_request_supported(bool supported) {
+        std::lock_guard<std::mutex> lock(m_srq_mutex);
+        m_srq_supported = supported;
+    }
+
+    /**
+     * @brief 模拟仪器发出服务请求（可从其他线程调用）
+     * @param status_byte 之后串行轮询返回的状态字节
+     */
+    void raise_service_request(uint8_t status_byte = 0x60) {
+        {
+            std::lock_guard<std::mutex> lock(m_srq_mutex);
+            m_status_byte = status_byte;
+            m_srq_pending = true;
+        }
+        m_srq_cv.notify_all();
+    }
+
+    /**
+     * @brief 获取 read_status_byte 调用次数
+     */
+    uint32_t status_poll_count() const {
+        std::lock_guard<std::mutex> lock(m_srq_mutex);
+        return m_status_polls;
+    }
+
 private:
+    // 写入前的失败模拟检查（同时统计调用次数）
+    result_t<void> _check_write() {
+        ++m_write_calls;
+
+        if (m_fail_write_times > 0) {
+            --m_fail_write_times;
+            return make_error_void(error_code_t::write_failed,
+                                   "Mock: simulated transient write failure");
+        }
+
+        if (m_should_fail_write) {
+            return make_error_void(error_code_t::write_failed,
+                                   "Mock: simulated write failure");
+        }
+
+        return make_ok();
+    }
+
     bool m_is_open = false;
     bool m_should_fail_open = false;
     bool m_should_fail_read = false;
@@ -243,6 +336,7 @@ private:
 
     uint32_t m_fail_read_times = 0;
     uint32_t m_fail_write_times = 0;
+    uint32_t m_write_calls = 0;
 
     ring_buffer_t m_read_buffer{4096};
     bytes_t m_write_buffer;
@@ -250,6 +344,14 @@ private:
     // 自动响应功能
     bool m_auto_respond = false;
     bytes_t m_auto_response;
+
+    // SRQ 模拟（可能被等待线程并发访问）
+    mutable std::mutex m_srq_mutex;
+    std::condition_variable m_srq_cv;
+    bool m_srq_supported = false;
+    bool m_srq_pending = false;
+    uint8_t m_status_byte = 0;
+    uint32_t m_status_polls = 0;
 };
 
 }  // namespace vdl
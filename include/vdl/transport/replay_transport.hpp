@@ -0,0 +1,322 @@
+/**
+ * @file replay_transport.hpp
+ * @brief 抓包回放传输层（用于离线基准测试）
+ *
+ * 映射 capture_file_t 写出的抓包文件，read() 按原始分段交付仪器发回的字节，
+ * 可选地校验 write() 的内容与抓包中主机发出的字节一致。
+ * 同一份现场抓包可以反复驱动编解码器、设备层或 SCPI 解析，结果可重复。
+ */
+
+#ifndef VDL_TRANSPORT_REPLAY_TRANSPORT_HPP
+#define VDL_TRANSPORT_REPLAY_TRANSPORT_HPP
+
+#include "transport.hpp"
+#include "capture_transport.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vdl {
+
+// ============================================================================
+// replay_config_t - 回放配置
+// ============================================================================
+
+/**
+ * @brief 回放节奏
+ */
+enum class replay_timing_t : uint8_t {
+    max_speed,          ///< 数据立即可读
+    original            ///< 按抓包中相对上一次写入的时间间隔交付
+};
+
+/**
+ * @brief 回放配置
+ */
+struct replay_config_t {
+    std::string device_name;                            ///< 回放的接口名，空表示全部记录
+    replay_timing_t timing = replay_timing_t::max_speed;
+    double speed = 1.0;                                 ///< original 模式下的时间缩放（2.0 = 两倍速）
+    bool verify_writes = false;                         ///< 写入内容必须与抓包一致
+    bool loop = false;                                  ///< 回放结束后从头开始
+};
+
+// ============================================================================
+// replay_transport_t - 回放传输层
+// ============================================================================
+
+/**
+ * @brief 抓包回放传输层
+ *
+ * 入向（设备 → 主机）和出向记录分别组成两条流：
+ * - read() 每次最多交付当前入向记录的剩余部分，保留原始的分段方式
+ * - write() 按字节推进出向流（与调用方的分段方式无关）；
+ *   verify_writes 时内容不一致返回 protocol_error，多出的字节同样视为不一致
+ * - original 模式下入向记录的可读时刻 = 最近一次对应写入的实际时刻
+ *   + 两者在抓包中的时间差 / speed
+ * - 入向流耗尽后 read() 等待超时返回 timeout（loop 时重新开始）
+ *
+ * @note 与 mock_transport_t 一样非线程安全，由设备锁保护
+ */
+class replay_transport_t : public transport_base_t {
+public:
+    explicit replay_transport_t(const std::string& path,
+                                const replay_config_t& replay = replay_config_t())
+        : m_path(path)
+        , m_replay(replay) {
+        if (!(m_replay.speed > 0.0)) {
+            m_replay.speed = 1.0;
+        }
+    }
+
+    // ========================================================================
+    // i_transport_t 实现
+    // ========================================================================
+
+    /**
+     * @brief 映射抓包文件并建立记录索引
+     */
+    result_t<void> open() override {
+        close();
+        auto opened = m_reader.open(m_path);
+        if (!opened) {
+            return opened;
+        }
+
+        capture_record_t record;
+        while (m_reader.next(record)) {
+            if (!m_replay.device_name.empty()) {
+                const auto& names = m_reader.interfaces();
+                if (record.interface_id >= names.size() ||
+                    names[record.interface_id] != m_replay.device_name) {
+                    continue;
+                }
+            }
+            chunk_t chunk;
+            chunk.timestamp = record.timestamp;
+            chunk.data = record.data;
+            if (record.direction == capture_direction_t::inbound) {
+                m_inbound.push_back(chunk);
+            } else {
+                m_outbound.push_back(chunk);
+            }
+        }
+        m_is_open = true;
+        rewind();
+        return make_ok();
+    }
+
+    void close() override {
+        m_is_open = false;
+        m_inbound.clear();
+        m_outbound.clear();
+        m_reader.close();
+    }
+
+    bool is_open() const override {
+        return m_is_open;
+    }
+
+    result_t<size_t> read(byte_span_t buffer, milliseconds_t timeout_ms = 0) override {
+        const auto start = transport_counters_t::now();
+        auto result = _read(buffer, timeout_ms);
+        m_counters.record_read(buffer.size(), result, start);
+        return result;
+    }
+
+    result_t<size_t> write(const_byte_span_t data, milliseconds_t /*timeout_ms*/ = 0) override {
+        const auto start = transport_counters_t::now();
+        auto result = _write(data);
+        m_counters.record_write(data.size(), result, start);
+        return result;
+    }
+
+    /**
+     * @brief 丢弃已到可读时刻的入向数据
+     */
+    void flush_read() override {
+        const auto now = clock_t::now();
+        while (m_in_index < m_inbound.size() && _ready_time(m_inbound[m_in_index]) <= now) {
+            _next_inbound();
+        }
+    }
+
+    const char* type_name() const override {
+        return "replay";
+    }
+
+    // ========================================================================
+    // 回放控制
+    // ========================================================================
+
+    /**
+     * @brief 回到抓包开头（时间基准重置为当前时刻）
+     */
+    void rewind() {
+        m_in_index = 0;
+        m_in_offset = 0;
+        m_out_index = 0;
+        m_out_offset = 0;
+        m_anchor_recorded = _first_timestamp();
+        m_anchor_actual = clock_t::now();
+    }
+
+    /**
+     * @brief 入向、出向记录都已回放完
+     */
+    bool finished() const {
+        return m_in_index >= m_inbound.size() && m_out_index >= m_outbound.size();
+    }
+
+    size_t inbound_count() const { return m_inbound.size(); }
+    size_t outbound_count() const { return m_outbound.size(); }
+
+    /**
+     * @brief 尚未读取的入向记录数
+     */
+    size_t inbound_remaining() const {
+        return m_inbound.size() - m_in_index;
+    }
+
+    /**
+     * @brief verify_writes 下发现的不一致次数
+     */
+    uint64_t mismatch_count() const {
+        return m_mismatches;
+    }
+
+    const replay_config_t& replay_config() const {
+        return m_replay;
+    }
+
+private:
+    using clock_t = std::chrono::steady_clock;
+
+    struct chunk_t {
+        microseconds_t timestamp = 0;
+        const_byte_span_t data;
+    };
+
+    microseconds_t _first_timestamp() const {
+        microseconds_t first = 0;
+        if (!m_inbound.empty()) {
+            first = m_inbound.front().timestamp;
+        }
+        if (!m_outbound.empty() && (m_inbound.empty() || m_outbound.front().timestamp < first)) {
+            first = m_outbound.front().timestamp;
+        }
+        return first;
+    }
+
+    clock_t::time_point _ready_time(const chunk_t& chunk) const {
+        if (m_replay.timing == replay_timing_t::max_speed ||
+            chunk.timestamp <= m_anchor_recorded) {
+            return m_anchor_actual;
+        }
+        const double delay = static_cast<double>(chunk.timestamp - m_anchor_recorded) / m_replay.speed;
+        return m_anchor_actual + std::chrono::microseconds(static_cast<int64_t>(delay));
+    }
+
+    void _next_inbound() {
+        ++m_in_index;
+        m_in_offset = 0;
+    }
+
+    result_t<size_t> _read(byte_span_t buffer, milliseconds_t timeout_ms) {
+        if (!m_is_open) {
+            return make_error<size_t>(error_code_t::not_connected, "Replay: not open");
+        }
+        if (buffer.empty()) {
+            return static_cast<size_t>(0);
+        }
+        if (m_replay.loop && m_in_index >= m_inbound.size() && !m_inbound.empty()) {
+            rewind();
+        }
+
+        const milliseconds_t timeout = timeout_ms > 0 ? timeout_ms : m_config.read_timeout;
+        const auto deadline = clock_t::now() + std::chrono::milliseconds(timeout);
+        if (m_in_index >= m_inbound.size()) {
+            std::this_thread::sleep_until(deadline);
+            return make_error<size_t>(error_code_t::timeout, "Replay: end of capture");
+        }
+
+        const chunk_t& chunk = m_inbound[m_in_index];
+        const auto ready = _ready_time(chunk);
+        if (ready > clock_t::now()) {
+            if (ready > deadline) {
+                std::this_thread::sleep_until(deadline);
+                return make_error<size_t>(error_code_t::timeout, "Replay: no data available");
+            }
+            std::this_thread::sleep_until(ready);
+        }
+
+        const size_t left = chunk.data.size() - m_in_offset;
+        const size_t count = buffer.size() < left ? buffer.size() : left;
+        std::memcpy(buffer.data(), chunk.data.data() + m_in_offset, count);
+        m_in_offset += count;
+        if (m_in_offset >= chunk.data.size()) {
+            _next_inbound();
+        }
+        return count;
+    }
+
+    result_t<size_t> _write(const_byte_span_t data) {
+        if (!m_is_open) {
+            return make_error<size_t>(error_code_t::not_connected, "Replay: not open");
+        }
+
+        size_t done = 0;
+        while (done < data.size()) {
+            if (m_out_index >= m_outbound.size()) {
+                if (m_replay.verify_writes) {
+                    ++m_mismatches;
+                    return make_error<size_t>(error_code_t::protocol_error,
+                                              "Replay: write beyond end of capture");
+                }
+                break;
+            }
+            const chunk_t& chunk = m_outbound[m_out_index];
+            const size_t left = chunk.data.size() - m_out_offset;
+            const size_t count = data.size() - done < left ? data.size() - done : left;
+            if (m_replay.verify_writes &&
+                std::memcmp(data.data() + done, chunk.data.data() + m_out_offset, count) != 0) {
+                ++m_mismatches;
+                return make_error<size_t>(error_code_t::protocol_error,
+                                          "Replay: write does not match capture");
+            }
+            done += count;
+            m_out_offset += count;
+            if (m_out_offset >= chunk.data.size()) {
+                // 该写入在抓包中的时刻对应现在，后续响应相对它计时
+                m_anchor_recorded = chunk.timestamp;
+                m_anchor_actual = clock_t::now();
+                ++m_out_index;
+                m_out_offset = 0;
+            }
+        }
+        return data.size();
+    }
+
+    std::string m_path;
+    replay_config_t m_replay;
+    capture_reader_t m_reader;
+    bool m_is_open = false;
+
+    std::vector<chunk_t> m_inbound;
+    std::vector<chunk_t> m_outbound;
+    size_t m_in_index = 0;
+    size_t m_in_offset = 0;
+    size_t m_out_index = 0;
+    size_t m_out_offset = 0;
+
+    microseconds_t m_anchor_recorded = 0;       ///< 时间基准：抓包中的时刻
+    clock_t::time_point m_anchor_actual;        ///< 时间基准：对应的实际时刻
+    uint64_t m_mismatches = 0;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_TRANSPORT_REPLAY_TRANSPORT_HPP
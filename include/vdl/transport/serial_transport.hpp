@@ -0,0 +1,491 @@
+/**
+ * @file serial_transport.hpp
+ * @brief 串口传输层（POSIX termios）
+ *
+ * 适用于 RS-232/RS-485 设备及 USB 串口适配器，支持 Modbus RTU 式的字符间隔分帧。
+ */
+
+#ifndef VDL_TRANSPORT_SERIAL_TRANSPORT_HPP
+#define VDL_TRANSPORT_SERIAL_TRANSPORT_HPP
+
+#include "transport.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <string>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/serial.h>
+#endif
+
+namespace vdl {
+
+// ============================================================================
+// 串口参数
+// ============================================================================
+
+/**
+ * @brief 校验方式
+ */
+enum class serial_parity_t : uint8_t {
+    none,
+    odd,
+    even
+};
+
+/**
+ * @brief 流控方式
+ */
+enum class serial_flow_control_t : uint8_t {
+    none,
+    hardware,   ///< RTS/CTS
+    software    ///< XON/XOFF
+};
+
+/**
+ * @brief 串口配置
+ */
+struct serial_config_t {
+    uint32_t baud_rate = 9600;                                  ///< 波特率
+    uint8_t data_bits = 8;                                      ///< 数据位（5~8）
+    serial_parity_t parity = serial_parity_t::none;             ///< 校验
+    uint8_t stop_bits = 1;                                      ///< 停止位（1 或 2）
+    serial_flow_control_t flow_control = serial_flow_control_t::none;
+    bool low_latency = true;            ///< 设置 ASYNC_LOW_LATENCY（Linux；不支持的驱动忽略）
+    uint32_t inter_char_timeout_us = 0; ///< 字符间隔超时（微秒），0 表示不按间隔聚合
+};
+
+/**
+ * @brief Modbus RTU 的帧间隔（3.5 个字符时间；19200 波特以上固定为 1750us）
+ * @param baud_rate 波特率
+ * @param bits_per_char 每字符位数（起始位 + 数据位 + 校验位 + 停止位）
+ */
+inline uint32_t modbus_rtu_frame_gap_us(uint32_t baud_rate, uint32_t bits_per_char = 11) {
+    if (baud_rate == 0 || baud_rate > 19200) {
+        return 1750;
+    }
+    return static_cast<uint32_t>((35ULL * bits_per_char * 1000000ULL) / (10ULL * baud_rate));
+}
+
+// ============================================================================
+// serial_transport_t - 串口传输层
+// ============================================================================
+
+/**
+ * @brief 串口传输层
+ *
+ * 终端设为原始模式，VMIN = VTIME = 0，由 poll 控制等待：
+ * - 首字节等待 read_timeout（或调用者给定的超时）
+ * - 之后在 inter_char_timeout_us 内持续有数据到达时继续读入同一缓冲区，
+ *   一次 read() 返回整帧，而不是每个字节一次
+ * - 设置了帧检测函数（通常绑定编解码器的 frame_length()）时，
+ *   帧完整即返回，不必再等一个字符间隔
+ *
+ * 相比 VTIME（100ms 粒度），这里的间隔精确到微秒级。
+ *
+ * @code
+ * serial_config_t cfg;
+ * cfg.baud_rate = 19200;
+ * cfg.parity = serial_parity_t::even;
+ * cfg.inter_char_timeout_us = modbus_rtu_frame_gap_us(cfg.baud_rate);
+ *
+ * auto serial = make_unique<serial_transport_t>("/dev/ttyUSB0", cfg);
+ * binary_codec_t* codec_ptr = codec.get();
+ * serial->set_frame_detector([codec_ptr](const_byte_span_t data) {
+ *     return codec_ptr->frame_length(data);
+ * });
+ * @endcode
+ *
+ * @note 仅支持 POSIX 平台
+ */
+class serial_transport_t : public transport_base_t {
+public:
+    /**
+     * @brief 帧检测函数：返回完整帧的长度，不完整返回 0
+     */
+    using frame_detector_t = std::function<size_t(const_byte_span_t data)>;
+
+    /**
+     * @brief 构造函数
+     * @param device_path 设备路径（如 /dev/ttyUSB0）
+     * @param config 串口配置
+     */
+    explicit serial_transport_t(const std::string& device_path,
+                                const serial_config_t& config = serial_config_t())
+        : m_path(device_path)
+        , m_serial(config) {
+    }
+
+    ~serial_transport_t() override {
+        close();
+    }
+
+    // ========================================================================
+    // 连接管理
+    // ========================================================================
+
+    result_t<void> open() override {
+        if (is_open()) {
+            return make_ok();
+        }
+
+        speed_t speed = 0;
+        if (!_to_speed(m_serial.baud_rate, speed)) {
+            return make_error_void(error_code_t::invalid_argument, "Unsupported baud rate");
+        }
+
+        const int fd = ::open(m_path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (fd < 0) {
+            return make_error_void(error_code_t::connection_failed, "Cannot open serial port");
+        }
+
+        auto configured = _configure(fd, speed);
+        if (!configured) {
+            ::close(fd);
+            return configured;
+        }
+
+        ::tcflush(fd, TCIOFLUSH);
+        m_fd = fd;
+        return make_ok();
+    }
+
+    void close() override {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+    bool is_open() const override {
+        return m_fd >= 0;
+    }
+
+    // ========================================================================
+    // 读写操作
+    // ========================================================================
+
+    result_t<size_t> read(byte_span_t buffer, milliseconds_t timeout_ms = 0) override {
+        const auto start = transport_counters_t::now();
+        auto result = _read(buffer, timeout_ms);
+        m_counters.record_read(buffer.size(), result, start);
+        return result;
+    }
+
+    result_t<size_t> write(const_byte_span_t data, milliseconds_t timeout_ms = 0) override {
+        const auto start = transport_counters_t::now();
+        auto result = _write(data, timeout_ms);
+        m_counters.record_write(data.size(), result, start);
+        return result;
+    }
+
+    void flush_read() override {
+        if (is_open()) {
+            ::tcflush(m_fd, TCIFLUSH);
+        }
+    }
+
+    void flush_write() override {
+        if (is_open()) {
+            ::tcflush(m_fd, TCOFLUSH);
+        }
+    }
+
+    const char* type_name() const override {
+        return "serial";
+    }
+
+    // ========================================================================
+    // 串口特定接口
+    // ========================================================================
+
+    /**
+     * @brief 设置帧检测函数（传入空函数取消）
+     */
+    void set_frame_detector(frame_detector_t detector) {
+        m_frame_detector = std::move(detector);
+    }
+
+    /**
+     * @brief 设置字符间隔超时（立即生效）
+     */
+    void set_inter_char_timeout_us(uint32_t timeout_us) {
+        m_serial.inter_char_timeout_us = timeout_us;
+    }
+
+    /**
+     * @brief 串口配置；修改波特率等参数需重新 open()
+     */
+    const serial_config_t& serial_config() const {
+        return m_serial;
+    }
+
+    void set_serial_config(const serial_config_t& config) {
+        m_serial = config;
+    }
+
+    const std::string& device_path() const {
+        return m_path;
+    }
+
+    /**
+     * @brief 底层文件描述符（未打开时为 -1）
+     */
+    int native_handle() const override {
+        return m_fd;
+    }
+
+private:
+    result_t<size_t> _read(byte_span_t buffer, milliseconds_t timeout_ms) {
+        if (!is_open()) {
+            return make_error<size_t>(error_code_t::not_connected, "Serial: not connected");
+        }
+        if (buffer.empty()) {
+            return static_cast<size_t>(0);
+        }
+
+        if (timeout_ms == 0) {
+            timeout_ms = m_config.read_timeout;
+        }
+
+        // 首字节：先直接读取，没有数据再等待
+        size_t received = 0;
+        auto first = _read_some(buffer, received);
+        if (!first) {
+            return first;
+        }
+        if (received == 0) {
+            auto ready = _wait(POLLIN, static_cast<int64_t>(timeout_ms) * 1000);
+            if (!ready) {
+                return make_unexpected(ready.error());
+            }
+            if (!*ready) {
+                return make_error<size_t>(error_code_t::timeout, "Serial: read timeout");
+            }
+            auto more = _read_some(buffer, received);
+            if (!more) {
+                return more;
+            }
+        }
+
+        // 后续字节：字符间隔内有数据就继续读
+        while (received < buffer.size()) {
+            if (m_frame_detector) {
+                const size_t frame_len = m_frame_detector(const_byte_span_t(buffer.data(), received));
+                if (frame_len > 0 && frame_len <= received) {
+                    break;
+                }
+            }
+            if (m_serial.inter_char_timeout_us == 0) {
+                break;
+            }
+            auto ready = _wait(POLLIN, m_serial.inter_char_timeout_us);
+            if (!ready) {
+                return make_unexpected(ready.error());
+            }
+            if (!*ready) {
+                break;   // 间隔超时：帧结束
+            }
+            const size_t before = received;
+            auto more = _read_some(buffer, received);
+            if (!more) {
+                return more;
+            }
+            if (received == before) {
+                break;
+            }
+        }
+        return received;
+    }
+
+    result_t<size_t> _write(const_byte_span_t data, milliseconds_t timeout_ms) {
+        if (!is_open()) {
+            return make_error<size_t>(error_code_t::not_connected, "Serial: not connected");
+        }
+        if (timeout_ms == 0) {
+            timeout_ms = m_config.write_timeout;
+        }
+
+        while (true) {
+            const ssize_t n = ::write(m_fd, data.data(), data.size());
+            if (n >= 0) {
+                return static_cast<size_t>(n);
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return make_error<size_t>(error_code_t::write_failed, "Serial: write failed");
+            }
+            auto ready = _wait(POLLOUT, static_cast<int64_t>(timeout_ms) * 1000);
+            if (!ready) {
+                return make_unexpected(ready.error());
+            }
+            if (!*ready) {
+                return make_error<size_t>(error_code_t::timeout, "Serial: write timeout");
+            }
+        }
+    }
+
+    /**
+     * @brief 读取当前可用的数据，追加到 buffer[received..]
+     */
+    result_t<size_t> _read_some(byte_span_t buffer, size_t& received) {
+        while (true) {
+            const ssize_t n = ::read(m_fd, buffer.data() + received, buffer.size() - received);
+            if (n > 0) {
+                received += static_cast<size_t>(n);
+                return received;
+            }
+            if (n == 0 || errno == EAGAIN || errno == EWOULDBLOCK) {
+                return received;
+            }
+            if (errno != EINTR) {
+                return make_error<size_t>(error_code_t::read_failed, "Serial: read failed");
+            }
+        }
+    }
+
+    /**
+     * @brief 等待可读/可写
+     * @return 就绪返回 true，超时返回 false
+     */
+    result_t<bool> _wait(short events, int64_t timeout_us) {
+        struct pollfd pfd;
+        pfd.fd = m_fd;
+        pfd.events = events;
+        pfd.revents = 0;
+
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::microseconds(timeout_us);
+        while (true) {
+            const auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) {
+                return false;
+            }
+#ifdef __linux__
+            struct timespec ts;
+            ts.tv_sec = static_cast<time_t>(remaining / 1000000);
+            ts.tv_nsec = static_cast<long>((remaining % 1000000) * 1000);
+            const int ret = ::ppoll(&pfd, 1, &ts, nullptr);
+#else
+            const int ret = ::poll(&pfd, 1, static_cast<int>((remaining + 999) / 1000));
+#endif
+            if (ret > 0) {
+                return true;
+            }
+            if (ret < 0 && errno != EINTR) {
+                return make_error<bool>(error_code_t::io_error, "Serial: poll failed");
+            }
+        }
+    }
+
+    result_t<void> _configure(int fd, speed_t speed) const {
+        struct termios tio;
+        if (::tcgetattr(fd, &tio) != 0) {
+            return make_error_void(error_code_t::config_error, "Serial: tcgetattr failed");
+        }
+
+        ::cfmakeraw(&tio);
+        ::cfsetispeed(&tio, speed);
+        ::cfsetospeed(&tio, speed);
+
+        tio.c_cflag |= static_cast<tcflag_t>(CLOCAL | CREAD);
+        tio.c_cflag &= ~static_cast<tcflag_t>(CSIZE);
+        switch (m_serial.data_bits) {
+            case 5: tio.c_cflag |= CS5; break;
+            case 6: tio.c_cflag |= CS6; break;
+            case 7: tio.c_cflag |= CS7; break;
+            case 8: tio.c_cflag |= CS8; break;
+            default:
+                return make_error_void(error_code_t::invalid_argument, "Unsupported data bits");
+        }
+
+        tio.c_cflag &= ~static_cast<tcflag_t>(PARENB | PARODD);
+        if (m_serial.parity == serial_parity_t::even) {
+            tio.c_cflag |= PARENB;
+        } else if (m_serial.parity == serial_parity_t::odd) {
+            tio.c_cflag |= static_cast<tcflag_t>(PARENB | PARODD);
+        }
+
+        if (m_serial.stop_bits == 2) {
+            tio.c_cflag |= CSTOPB;
+        } else {
+            tio.c_cflag &= ~static_cast<tcflag_t>(CSTOPB);
+        }
+
+        tio.c_cflag &= ~static_cast<tcflag_t>(CRTSCTS);
+        tio.c_iflag &= ~static_cast<tcflag_t>(IXON | IXOFF | IXANY);
+        if (m_serial.flow_control == serial_flow_control_t::hardware) {
+            tio.c_cflag |= CRTSCTS;
+        } else if (m_serial.flow_control == serial_flow_control_t::software) {
+            tio.c_iflag |= static_cast<tcflag_t>(IXON | IXOFF);
+        }
+
+        // 等待由 poll 控制，read 不阻塞
+        tio.c_cc[VMIN] = 0;
+        tio.c_cc[VTIME] = 0;
+
+        if (::tcsetattr(fd, TCSANOW, &tio) != 0) {
+            return make_error_void(error_code_t::config_error, "Serial: tcsetattr failed");
+        }
+
+#ifdef __linux__
+        // USB 串口驱动默认的 16ms 延迟定时器会拖慢每次读取
+        if (m_serial.low_latency) {
+            struct serial_struct ss;
+            if (::ioctl(fd, TIOCGSERIAL, &ss) == 0) {
+                ss.flags |= static_cast<int>(ASYNC_LOW_LATENCY);
+                ::ioctl(fd, TIOCSSERIAL, &ss);
+            }
+        }
+#endif
+        return make_ok();
+    }
+
+    static bool _to_speed(uint32_t baud, speed_t& speed) {
+        switch (baud) {
+            case 1200: speed = B1200; return true;
+            case 2400: speed = B2400; return true;
+            case 4800: speed = B4800; return true;
+            case 9600: speed = B9600; return true;
+            case 19200: speed = B19200; return true;
+            case 38400: speed = B38400; return true;
+            case 57600: speed = B57600; return true;
+            case 115200: speed = B115200; return true;
+            case 230400: speed = B230400; return true;
+#ifdef B460800
+            case 460800: speed = B460800; return true;
+#endif
+#ifdef B921600
+            case 921600: speed = B921600; return true;
+#endif
+#ifdef B1000000
+            case 1000000: speed = B1000000; return true;
+#endif
+#ifdef B2000000
+            case 2000000: speed = B2000000; return true;
+#endif
+            default: return false;
+        }
+    }
+
+    std::string m_path;
+    serial_config_t m_serial;
+    frame_detector_t m_frame_detector;
+    int m_fd = -1;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_TRANSPORT_SERIAL_TRANSPORT_HPP
@@ -0,0 +1,424 @@
+/**
+ * @file sim_transport.hpp
+ * @brief 链路仿真传输层（用于性能测试）
+ *
+ * 在内存中模拟带延迟、带宽、抖动和分段交付的链路，
+ * 由脚本化的应答器生成仪器响应，无需硬件即可测试流水线、批量和超时行为。
+ */
+
+#ifndef VDL_TRANSPORT_SIM_TRANSPORT_HPP
+#define VDL_TRANSPORT_SIM_TRANSPORT_HPP
+
+#include "transport.hpp"
+#include "../codec/codec.hpp"
+#include "../core/memory.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <utility>
+
+namespace vdl {
+
+// ============================================================================
+// 链路参数
+// ============================================================================
+
+/**
+ * @brief 仿真链路参数
+ */
+struct sim_link_config_t {
+    uint32_t latency_us = 0;            ///< 单向延迟（微秒）
+    uint32_t jitter_us = 0;             ///< 每段数据额外的随机延迟上限（微秒）
+    uint64_t bandwidth_bps = 0;         ///< 每个方向的带宽（字节/秒），0 表示不限
+    size_t read_chunk_size = 0;         ///< 每次 read() 最多交付的字节数，0 表示不限
+    uint32_t seed = 1;                  ///< 抖动随机数种子（保证可重复）
+};
+
+/**
+ * @brief 应答器回调
+ * @param request 已到达仪器、尚未被处理的请求字节
+ * @param reply 追加要返回的响应字节
+ * @return 处理掉的请求字节数；0 表示请求还不完整
+ *
+ * 每次写入后反复调用，直到返回 0 或请求字节耗尽。
+ */
+using sim_responder_t = std::function<size_t(const_byte_span_t request, bytes_t& reply)>;
+
+/**
+ * @brief 命令处理回调：返回要回复的命令，返回空表示不回复
+ */
+using sim_command_handler_t = std::function<optional_t<command_t>(const response_t& request)>;
+
+/**
+ * @brief 基于编解码器的应答器
+ * @param codec 请求帧与响应帧格式相同的编解码器（如 binary_codec_t）
+ * @param handler 根据解码后的请求生成回复
+ *
+ * 请求帧用 codec 切分并解码后交给 handler，回复用 codec 编码。
+ */
+inline sim_responder_t make_codec_responder(std::shared_ptr<i_codec_t> codec,
+                                            sim_command_handler_t handler) {
+    return [codec, handler](const_byte_span_t request, bytes_t& reply) -> size_t {
+        const size_t frame_len = codec->frame_length(request);
+        if (frame_len == 0 || frame_len > request.size()) {
+            return 0;
+        }
+        size_t consumed = 0;
+        auto decoded = codec->decode(request.first(frame_len), consumed);
+        if (!decoded) {
+            return frame_len;   // 坏帧被仪器丢弃
+        }
+        optional_t<command_t> answer = handler(*decoded);
+        if (answer) {
+            auto frame = codec->encode(*answer);
+            if (frame) {
+                reply.insert(reply.end(), frame->begin(), frame->end());
+                size_class_pool_t::instance().release(std::move(*frame));
+            }
+        }
+        return frame_len;
+    };
+}
+
+// ============================================================================
+// sim_transport_t - 链路仿真传输层
+// ============================================================================
+
+/**
+ * @brief 链路仿真传输层
+ *
+ * 时间模型：
+ * - 写入立即返回，数据按带宽依次串行化，再经过单向延迟到达仪器
+ * - 应答器在写入时生成响应，响应按带宽串行化并经过延迟（加抖动）后可读
+ * - 数据保持顺序，抖动不会让后发送的数据先到达
+ * - read() 等待数据可读，最多交付 read_chunk_size 字节
+ *
+ * 所有接口线程安全。
+ *
+ * @code
+ * sim_link_config_t link;
+ * link.latency_us = 2000;           // 单向 2 ms
+ * link.bandwidth_bps = 1000000;     // 1 MB/s
+ *
+ * auto transport = make_unique<sim_transport_t>(link);
+ * transport->set_responder(make_codec_responder(
+ *     std::make_shared<binary_codec_t>(),
+ *     [](const response_t& req) -> optional_t<command_t> {
+ *         command_t reply;
+ *         reply.set_function_code(req.function_code()).set_data(req.data());
+ *         return reply;
+ *     }));
+ * @endcode
+ */
+class sim_transport_t : public transport_base_t {
+public:
+    explicit sim_transport_t(const sim_link_config_t& link = sim_link_config_t())
+        : m_link(link)
+        , m_random(link.seed) {
+    }
+
+    // ========================================================================
+    // i_transport_t 实现
+    // ========================================================================
+
+    result_t<void> open() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_open = true;
+        return make_ok();
+    }
+
+    void close() override {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_is_open = false;
+            m_incoming.clear();
+            m_request.clear();
+        }
+        m_cv.notify_all();
+    }
+
+    bool is_open() const override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_is_open;
+    }
+
+    result_t<size_t> read(byte_span_t buffer, milliseconds_t timeout_ms = 0) override {
+        const auto start = transport_counters_t::now();
+        auto result = _read(buffer, timeout_ms);
+        m_counters.record_read(buffer.size(), result, start);
+        return result;
+    }
+
+    result_t<size_t> write(const_byte_span_t data, milliseconds_t /*timeout_ms*/ = 0) override {
+        const const_byte_span_t pieces[] = {data};
+        return writev(span_t<const const_byte_span_t>(pieces, 1));
+    }
+
+    result_t<size_t> writev(span_t<const const_byte_span_t> pieces,
+                            milliseconds_t /*timeout_ms*/ = 0) override {
+        const auto start = transport_counters_t::now();
+        auto result = _writev(pieces);
+        size_t requested = 0;
+        for (size_t i = 0; i < pieces.size(); ++i) {
+            requested += pieces[i].size();
+        }
+        m_counters.record_write(requested, result, start);
+        return result;
+    }
+
+    void flush_read() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto now = clock_t::now();
+        while (!m_incoming.empty() && m_incoming.front().ready <= now) {
+            m_incoming.pop_front();
+        }
+    }
+
+    const char* type_name() const override {
+        return "sim";
+    }
+
+    // ========================================================================
+    // 仿真控制
+    // ========================================================================
+
+    /**
+     * @brief 设置应答器（为空时写入的数据被丢弃）
+     */
+    void set_responder(sim_responder_t responder) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_responder = std::move(responder);
+    }
+
+    /**
+     * @brief 修改链路参数（对之后写入的数据生效）
+     */
+    void set_link(const sim_link_config_t& link) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_link = link;
+        m_random.seed(link.seed);
+    }
+
+    sim_link_config_t link() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_link;
+    }
+
+    /**
+     * @brief 注入仪器主动发送的数据（经过链路延迟后可读）
+     */
+    void inject(const bytes_t& data) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            _schedule_reply(clock_t::now(), data);
+        }
+        m_cv.notify_all();
+    }
+
+    /**
+     * @brief 已写入的总字节数
+     */
+    uint64_t bytes_written() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_bytes_written;
+    }
+
+    /**
+     * @brief 已读取的总字节数
+     */
+    uint64_t bytes_read() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_bytes_read;
+    }
+
+    uint64_t write_call_count() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_write_calls;
+    }
+
+    uint64_t read_call_count() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_read_calls;
+    }
+
+private:
+    using clock_t = std::chrono::steady_clock;
+
+    result_t<size_t> _read(byte_span_t buffer, milliseconds_t timeout_ms) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_is_open) {
+            return make_error<size_t>(error_code_t::not_connected, "Sim: not connected");
+        }
+        ++m_read_calls;
+        if (buffer.empty()) {
+            return static_cast<size_t>(0);
+        }
+
+        if (timeout_ms == 0) {
+            timeout_ms = m_config.read_timeout;
+        }
+        const auto deadline = clock_t::now() + std::chrono::milliseconds(timeout_ms);
+
+        while (true) {
+            if (!m_is_open) {
+                return make_error<size_t>(error_code_t::connection_closed, "Sim: closed");
+            }
+            const auto now = clock_t::now();
+            if (!m_incoming.empty() && m_incoming.front().ready <= now) {
+                break;
+            }
+            if (now >= deadline) {
+                return make_error<size_t>(error_code_t::timeout, "Sim: read timeout");
+            }
+            auto wake = deadline;
+            if (!m_incoming.empty() && m_incoming.front().ready < wake) {
+                wake = m_incoming.front().ready;
+            }
+            m_cv.wait_until(lock, wake);
+        }
+
+        // 交付所有已到达的段，受缓冲区和分段大小限制
+        size_t limit = buffer.size();
+        if (m_link.read_chunk_size > 0 && m_link.read_chunk_size < limit) {
+            limit = m_link.read_chunk_size;
+        }
+        const auto now = clock_t::now();
+        size_t total = 0;
+        while (total < limit && !m_incoming.empty() && m_incoming.front().ready <= now) {
+            segment_t& seg = m_incoming.front();
+            const size_t n = std::min(limit - total, seg.data.size() - seg.offset);
+            std::copy(seg.data.begin() + static_cast<std::ptrdiff_t>(seg.offset),
+                      seg.data.begin() + static_cast<std::ptrdiff_t>(seg.offset + n),
+                      buffer.data() + total);
+            seg.offset += n;
+            total += n;
+            if (seg.offset == seg.data.size()) {
+                m_incoming.pop_front();
+            }
+        }
+        m_bytes_read += total;
+        return total;
+    }
+
+    result_t<size_t> _writev(span_t<const const_byte_span_t> pieces) {
+        size_t total = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_is_open) {
+                return make_error<size_t>(error_code_t::not_connected, "Sim: not connected");
+            }
+            ++m_write_calls;
+
+            for (size_t i = 0; i < pieces.size(); ++i) {
+                m_request.insert(m_request.end(), pieces[i].begin(), pieces[i].end());
+                total += pieces[i].size();
+            }
+            m_bytes_written += total;
+
+            // 请求串行化后经过单向延迟到达仪器
+            const auto arrival = _serialize(m_tx_busy_until, total) + _latency();
+            _respond(arrival);
+        }
+        m_cv.notify_all();
+        return total;
+    }
+
+    struct segment_t {
+        clock_t::time_point ready;   ///< 整段可读的时间
+        bytes_t data;
+        size_t offset = 0;           ///< 已交付的字节数
+    };
+
+    /**
+     * @brief 按带宽串行化 bytes 字节，返回最后一个字节发出的时间
+     */
+    clock_t::time_point _serialize(clock_t::time_point& busy_until, size_t bytes) {
+        const auto now = clock_t::now();
+        const auto start = busy_until > now ? busy_until : now;
+        auto done = start;
+        if (m_link.bandwidth_bps > 0) {
+            const uint64_t us = static_cast<uint64_t>(bytes) * 1000000u / m_link.bandwidth_bps;
+            done += std::chrono::microseconds(static_cast<int64_t>(us));
+        }
+        busy_until = done;
+        return done;
+    }
+
+    std::chrono::microseconds _latency() {
+        uint32_t extra = 0;
+        if (m_link.jitter_us > 0) {
+            std::uniform_int_distribution<uint32_t> dist(0, m_link.jitter_us);
+            extra = dist(m_random);
+        }
+        return std::chrono::microseconds(static_cast<int64_t>(m_link.latency_us) + extra);
+    }
+
+    /**
+     * @brief 让应答器处理已到达的请求字节
+     */
+    void _respond(clock_t::time_point arrival) {
+        if (!m_responder) {
+            m_request.clear();
+            return;
+        }
+        size_t offset = 0;
+        while (offset < m_request.size()) {
+            bytes_t reply;
+            const size_t used = m_responder(
+                const_byte_span_t(m_request.data() + offset, m_request.size() - offset), reply);
+            if (used == 0) {
+                break;
+            }
+            offset += std::min(used, m_request.size() - offset);
+            if (!reply.empty()) {
+                _schedule_reply(arrival, reply);
+            }
+        }
+        m_request.erase(m_request.begin(), m_request.begin() + static_cast<std::ptrdiff_t>(offset));
+    }
+
+    /**
+     * @brief 仪器从 sent_at 开始发送 data
+     */
+    void _schedule_reply(clock_t::time_point sent_at, const bytes_t& data) {
+        if (m_rx_busy_until < sent_at) {
+            m_rx_busy_until = sent_at;
+        }
+        segment_t seg;
+        seg.ready = _serialize(m_rx_busy_until, data.size()) + _latency();
+        // 保持顺序：抖动不能让后发的数据先到
+        if (!m_incoming.empty() && seg.ready < m_incoming.back().ready) {
+            seg.ready = m_incoming.back().ready;
+        }
+        seg.data = data;
+        m_incoming.push_back(std::move(seg));
+    }
+
+    sim_link_config_t m_link;
+    std::minstd_rand m_random;
+    sim_responder_t m_responder;
+
+    bool m_is_open = false;
+    bytes_t m_request;                       ///< 已到达仪器、尚未处理完的请求字节
+    std::deque<segment_t> m_incoming;        ///< 发往主机的数据段（按到达时间排序）
+    clock_t::time_point m_tx_busy_until;     ///< 主机到仪器方向的链路空闲时间
+    clock_t::time_point m_rx_busy_until;     ///< 仪器到主机方向的链路空闲时间
+
+    uint64_t m_bytes_written = 0;
+    uint64_t m_bytes_read = 0;
+    uint64_t m_write_calls = 0;
+    uint64_t m_read_calls = 0;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_TRANSPORT_SIM_TRANSPORT_HPP
@@ -0,0 +1,464 @@
+/**
+ * @file tcp_transport.hpp
+ * @brief TCP 传输层（POSIX 套接字）
+ *
+ * 用于原始套接字 SCPI（端口 5025）、Modbus TCP 等，无需 VISA。
+ */
+
+#ifndef VDL_TRANSPORT_TCP_TRANSPORT_HPP
+#define VDL_TRANSPORT_TCP_TRANSPORT_HPP
+
+#include "transport.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace vdl {
+
+// ============================================================================
+// tcp_options_t - TCP 选项
+// ============================================================================
+
+/**
+ * @brief TCP 套接字选项
+ */
+struct tcp_options_t {
+    bool no_delay = true;           ///< TCP_NODELAY：关闭 Nagle，短命令立即发出
+    bool keep_alive = false;        ///< SO_KEEPALIVE：检测半开连接
+    int keep_idle_s = 60;           ///< 空闲多久开始探测（秒）
+    int keep_interval_s = 10;       ///< 探测间隔（秒）
+    int keep_count = 3;             ///< 探测失败多少次判定断开
+};
+
+// ============================================================================
+// tcp_transport_t - TCP 传输层
+// ============================================================================
+
+/**
+ * @brief TCP 传输层
+ *
+ * - 套接字始终为非阻塞模式，超时由 poll() 实现；数据已就绪时直接 recv，不多一次 poll
+ * - connect 非阻塞，受 connect_timeout 限制；主机名经 getaddrinfo 解析，依次尝试各地址
+ * - read_buffer_size / write_buffer_size 非 0 时设置 SO_RCVBUF / SO_SNDBUF
+ *   （本传输层默认 0，即使用内核默认值）
+ * - writev/readv 使用 sendmsg/recvmsg，一次系统调用收发多个片段
+ *
+ * @code
+ * auto transport = make_unique<tcp_transport_t>("192.168.1.100", 5025);
+ * device_impl_t device(std::move(transport), make_unique<binary_codec_t>());
+ * @endcode
+ *
+ * @note 仅支持 POSIX 平台
+ */
+class tcp_transport_t : public transport_base_t {
+public:
+    /**
+     * @brief 构造函数
+     * @param host 主机地址（IP 或主机名）
+     * @param port 端口号
+     * @param options TCP 选项
+     */
+    tcp_transport_t(const std::string& host, uint16_t port,
+                    const tcp_options_t& options = tcp_options_t())
+        : m_host(host)
+        , m_port(port)
+        , m_options(options) {
+        m_config.read_buffer_size = 0;
+        m_config.write_buffer_size = 0;
+    }
+
+    ~tcp_transport_t() override {
+        close();
+    }
+
+    // ========================================================================
+    // 连接管理
+    // ========================================================================
+
+    result_t<void> open() override {
+        if (is_open()) {
+            return make_ok();
+        }
+
+        struct addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_protocol = IPPROTO_TCP;
+
+        struct addrinfo* addresses = nullptr;
+        const std::string service = std::to_string(m_port);
+        if (::getaddrinfo(m_host.c_str(), service.c_str(), &hints, &addresses) != 0 ||
+            addresses == nullptr) {
+            return make_error_void(error_code_t::address_invalid, "Cannot resolve host");
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::milliseconds(m_config.connect_timeout);
+        error_t last_error(error_code_t::connection_failed, "Failed to connect");
+
+        for (struct addrinfo* ai = addresses; ai != nullptr; ai = ai->ai_next) {
+            auto result = _connect_one(ai, deadline);
+            if (result) {
+                break;
+            }
+            last_error = result.error();
+            if (last_error.code() == error_code_t::timeout) {
+                break;
+            }
+        }
+        ::freeaddrinfo(addresses);
+
+        if (!is_open()) {
+            return make_error_void(last_error);
+        }
+        return make_ok();
+    }
+
+    void close() override {
+        if (m_socket >= 0) {
+            ::close(m_socket);
+            m_socket = -1;
+        }
+    }
+
+    bool is_open() const override {
+        return m_socket >= 0;
+    }
+
+    // ========================================================================
+    // 读写操作
+    // ========================================================================
+
+    result_t<size_t> read(byte_span_t buffer, milliseconds_t timeout_ms = 0) override {
+        const byte_span_t buffers[] = {buffer};
+        return readv(span_t<const byte_span_t>(buffers, 1), timeout_ms);
+    }
+
+    result_t<size_t> write(const_byte_span_t data, milliseconds_t timeout_ms = 0) override {
+        const const_byte_span_t pieces[] = {data};
+        return writev(span_t<const const_byte_span_t>(pieces, 1), timeout_ms);
+    }
+
+    result_t<size_t> writev(span_t<const const_byte_span_t> pieces,
+                            milliseconds_t timeout_ms = 0) override {
+        const auto start = transport_counters_t::now();
+        auto result = _writev(pieces, timeout_ms);
+        size_t requested = 0;
+        for (size_t i = 0; i < pieces.size() && i < k_max_iov; ++i) {
+            requested += pieces[i].size();
+        }
+        m_counters.record_write(requested, result, start);
+        return result;
+    }
+
+    result_t<size_t> readv(span_t<const byte_span_t> buffers,
+                           milliseconds_t timeout_ms = 0) override {
+        const auto start = transport_counters_t::now();
+        auto result = _readv(buffers, timeout_ms);
+        size_t requested = 0;
+        for (size_t i = 0; i < buffers.size() && i < k_max_iov; ++i) {
+            requested += buffers[i].size();
+        }
+        m_counters.record_read(requested, result, start);
+        return result;
+    }
+
+    /**
+     * @brief 丢弃内核接收缓冲区中已到达的数据
+     */
+    void flush_read() override {
+        if (!is_open()) {
+            return;
+        }
+        byte_t scratch[512];
+        while (::recv(m_socket, scratch, sizeof(scratch), 0) > 0) {
+        }
+    }
+
+    const char* type_name() const override {
+        return "tcp";
+    }
+
+    // ========================================================================
+    // TCP 特定接口
+    // ========================================================================
+
+    const std::string& host() const {
+        return m_host;
+    }
+
+    uint16_t port() const {
+        return m_port;
+    }
+
+    const tcp_options_t& options() const {
+        return m_options;
+    }
+
+    /**
+     * @brief 设置 TCP 选项（下次 open() 时生效）
+     */
+    void set_options(const tcp_options_t& options) {
+        m_options = options;
+    }
+
+    /**
+     * @brief 底层套接字描述符（未连接时为 -1）
+     */
+    int native_handle() const override {
+        return m_socket;
+    }
+
+private:
+    static constexpr size_t k_max_iov = 16;
+
+    result_t<size_t> _writev(span_t<const const_byte_span_t> pieces,
+                             milliseconds_t timeout_ms) {
+        if (!is_open()) {
+            return make_error<size_t>(error_code_t::not_connected, "TCP: not connected");
+        }
+
+        struct iovec iov[k_max_iov];
+        const size_t count = pieces.size() < k_max_iov ? pieces.size() : k_max_iov;
+        for (size_t i = 0; i < count; ++i) {
+            iov[i].iov_base = const_cast<byte_t*>(pieces[i].data());
+            iov[i].iov_len = pieces[i].size();
+        }
+
+        struct msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+
+        if (timeout_ms == 0) {
+            timeout_ms = m_config.write_timeout;
+        }
+        const auto deadline = _deadline(timeout_ms);
+
+        while (true) {
+            const ssize_t n = ::sendmsg(m_socket, &msg, k_send_flags);
+            if (n >= 0) {
+                return static_cast<size_t>(n);
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return _io_failure<size_t>(error_code_t::write_failed, "TCP: send failed");
+            }
+            auto ready = _wait(m_socket, POLLOUT, deadline);
+            if (!ready) {
+                return make_unexpected(ready.error());
+            }
+        }
+    }
+
+    result_t<size_t> _readv(span_t<const byte_span_t> buffers,
+                            milliseconds_t timeout_ms) {
+        if (!is_open()) {
+            return make_error<size_t>(error_code_t::not_connected, "TCP: not connected");
+        }
+
+        struct iovec iov[k_max_iov];
+        const size_t count = buffers.size() < k_max_iov ? buffers.size() : k_max_iov;
+        size_t capacity = 0;
+        for (size_t i = 0; i < count; ++i) {
+            iov[i].iov_base = buffers[i].data();
+            iov[i].iov_len = buffers[i].size();
+            capacity += buffers[i].size();
+        }
+        if (capacity == 0) {
+            return static_cast<size_t>(0);   // recv 返回 0 会被误判为对端关闭
+        }
+
+        struct msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+
+        if (timeout_ms == 0) {
+            timeout_ms = m_config.read_timeout;
+        }
+        const auto deadline = _deadline(timeout_ms);
+
+        while (true) {
+            // 先直接读取：数据已到达时省去一次 poll()
+            const ssize_t n = ::recvmsg(m_socket, &msg, 0);
+            if (n > 0) {
+                return static_cast<size_t>(n);
+            }
+            if (n == 0) {
+                close();
+                return make_error<size_t>(error_code_t::connection_closed,
+                                          "TCP: connection closed by peer");
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return _io_failure<size_t>(error_code_t::read_failed, "TCP: recv failed");
+            }
+            auto ready = _wait(m_socket, POLLIN, deadline);
+            if (!ready) {
+                return make_unexpected(ready.error());
+            }
+        }
+    }
+
+#ifdef MSG_NOSIGNAL
+    static constexpr int k_send_flags = MSG_NOSIGNAL;   // 对端关闭时返回 EPIPE 而不是 SIGPIPE
+#else
+    static constexpr int k_send_flags = 0;
+#endif
+
+    using steady_time_t = std::chrono::steady_clock::time_point;
+
+    static steady_time_t _deadline(milliseconds_t timeout_ms) {
+        return std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    }
+
+    /**
+     * @brief 等待套接字可读/可写，直到 deadline
+     */
+    static result_t<void> _wait(int fd, short events, steady_time_t deadline) {
+        while (true) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                return make_error_void(error_code_t::timeout, "TCP: timeout");
+            }
+            const auto remaining =
+                std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = events;
+            pfd.revents = 0;
+
+            // 向上取整，避免剩余不足 1ms 时空转
+            const int ret = ::poll(&pfd, 1, static_cast<int>(remaining) + 1);
+            if (ret > 0) {
+                return make_ok();   // 包括 POLLERR/POLLHUP，由随后的 recv/send 报告具体错误
+            }
+            if (ret < 0 && errno != EINTR) {
+                return make_error_void(error_code_t::io_error, "TCP: poll failed");
+            }
+        }
+    }
+
+    /**
+     * @brief 将 errno 转换为错误；连接已断开时关闭套接字
+     */
+    template<typename T>
+    result_t<T> _io_failure(error_code_t code, const char* message) {
+        if (errno == ECONNRESET || errno == EPIPE || errno == ENOTCONN) {
+            close();
+            return make_error<T>(error_code_t::connection_closed, message);
+        }
+        return make_error<T>(code, message);
+    }
+
+    /**
+     * @brief 尝试连接一个解析出的地址
+     */
+    result_t<void> _connect_one(const struct addrinfo* ai, steady_time_t deadline) {
+        int fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            return make_error_void(error_code_t::connection_failed, "TCP: socket() failed");
+        }
+
+        const int flags = ::fcntl(fd, F_GETFL, 0);
+        if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+            ::close(fd);
+            return make_error_void(error_code_t::connection_failed, "TCP: fcntl() failed");
+        }
+
+        // 缓冲区大小须在 connect 之前设置，才能影响窗口缩放协商
+        _apply_buffer_sizes(fd);
+
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            if (errno != EINPROGRESS) {
+                ::close(fd);
+                return make_error_void(error_code_t::connection_failed, "TCP: connection refused");
+            }
+
+            auto ready = _wait(fd, POLLOUT, deadline);
+            if (!ready) {
+                ::close(fd);
+                return make_error_void(ready.error().code() == error_code_t::timeout
+                                           ? error_code_t::timeout
+                                           : error_code_t::connection_failed,
+                                       "TCP: connect timeout");
+            }
+
+            int so_error = 0;
+            socklen_t len = sizeof(so_error);
+            if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &so_error, &len) != 0 || so_error != 0) {
+                ::close(fd);
+                return make_error_void(error_code_t::connection_failed, "TCP: connection refused");
+            }
+        }
+
+        _apply_options(fd);
+        m_socket = fd;
+        return make_ok();
+    }
+
+    void _apply_buffer_sizes(int fd) const {
+        if (m_config.read_buffer_size > 0) {
+            const int size = static_cast<int>(m_config.read_buffer_size);
+            ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+        }
+        if (m_config.write_buffer_size > 0) {
+            const int size = static_cast<int>(m_config.write_buffer_size);
+            ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+        }
+    }
+
+    void _apply_options(int fd) const {
+        const int no_delay = m_options.no_delay ? 1 : 0;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+
+        const int keep_alive = m_options.keep_alive ? 1 : 0;
+        ::setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &keep_alive, sizeof(keep_alive));
+        if (m_options.keep_alive) {
+#ifdef TCP_KEEPIDLE
+            ::setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE,
+                         &m_options.keep_idle_s, sizeof(m_options.keep_idle_s));
+#elif defined(TCP_KEEPALIVE)
+            ::setsockopt(fd, IPPROTO_TCP, TCP_KEEPALIVE,
+                         &m_options.keep_idle_s, sizeof(m_options.keep_idle_s));
+#endif
+#ifdef TCP_KEEPINTVL
+            ::setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL,
+                         &m_options.keep_interval_s, sizeof(m_options.keep_interval_s));
+#endif
+#ifdef TCP_KEEPCNT
+            ::setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT,
+                         &m_options.keep_count, sizeof(m_options.keep_count));
+#endif
+        }
+    }
+
+    std::string m_host;
+    uint16_t m_port;
+    tcp_options_t m_options;
+    int m_socket = -1;
+};
+
+}  // namespace vdl
+
+#endif  // VDL_TRANSPORT_TCP_TRANSPORT_HPP
@@ -11,6 +11,7 @@
 #include "../core/types.hpp"
 #include "../core/error.hpp"
 #include "../core/noncopyable.hpp"
+#include "transport_stats.hpp"
 
 #include <string>
 
@@ -22,13 +23,16 @@ namespace vdl {
 
 /**
  * @brief 传输层配置
+ *
+ * 缓冲区大小由具体传输层在 open() 时应用（如 VISA 的 viSetBuf、
+ * 套接字的 SO_RCVBUF/SO_SNDBUF），0 表示保持系统默认值。
  */
 struct transport_config_t {
     milliseconds_t connect_timeout = 5000;     ///< 连接超时
     milliseconds_t read_timeout = 1000;        ///< 读取超时
     milliseconds_t write_timeout = 1000;       ///< 写入超时
-    size_t read_buffer_size = 4096;            ///< 读缓冲区大小
-    size_t write_buffer_size = 4096;           ///< 写缓冲区大小
+    size_t read_buffer_size = 4096;            ///< 读缓冲区大小（驱动/内核侧）
+    size_t write_buffer_size = 4096;           ///< 写缓冲区大小（驱动/内核侧）
 };
 
 // ============================================================================
@@ -113,6 +117,63 @@ public:
         return make_ok();
     }
 
+    /**
+     * @brief 聚集写入（scatter-gather）
+     * @param pieces 按顺序发送的数据片段
+     * @param timeout_ms 超时时间
+     * @return 成功返回实际写入的总字节数（可能小于总长度），失败返回错误
+     * 
+     * 头部、负载、尾部可以分别存放，无需先拼接到临时缓冲区。
+     */
+    virtual result_t<size_t> writev(span_t<const const_byte_span_t> pieces,
+                                     milliseconds_t timeout_ms = 0) = 0;
+
+    /**
+     * @brief 分散读取（scatter-gather）
+     * @param buffers 按顺序填充的接收缓冲区
+     * @param timeout_ms 超时时间
+     * @return 成功返回实际读取的总字节数（可能只填充部分缓冲区），失败返回错误
+     */
+    virtual result_t<size_t> readv(span_t<const byte_span_t> buffers,
+                                    milliseconds_t timeout_ms = 0) = 0;
+
+    /**
+     * @brief 聚集写入所有片段
+     * @param pieces 数据片段
+     * @param timeout_ms 超时时间
+     * @return 成功返回 ok，失败返回错误
+     */
+    virtual result_t<void> writev_all(span_t<const const_byte_span_t> pieces,
+                                       milliseconds_t timeout_ms = 0) {
+        size_t index = 0;
+        size_t offset = 0;   // 当前片段内已写入的字节数
+
+        while (index < pieces.size()) {
+            if (offset >= pieces[index].size()) {
+                ++index;
+                offset = 0;
+                continue;
+            }
+
+            // 首个片段可能已部分写出，其余片段原样传递
+            if (offset == 0) {
+                auto result = writev(pieces.subspan(index), timeout_ms);
+                if (!result) {
+                    return make_error_void(result.error());
+                }
+                _advance_pieces(pieces, *result, index, offset);
+            } else {
+                auto result = write(pieces[index].subspan(offset), timeout_ms);
+                if (!result) {
+                    return make_error_void(result.error());
+                }
+                offset += *result;
+            }
+        }
+
+        return make_ok();
+    }
+
     /**
      * @brief 清空接收缓冲区
      */
@@ -123,6 +184,33 @@ public:
      */
     virtual void flush_write() {}
 
+    // ========================================================================
+    // 服务请求（SRQ）
+    // ========================================================================
+
+    /**
+     * @brief 等待仪器发出服务请求
+     * @param timeout_ms 超时时间（毫秒）
+     * @return 收到 SRQ 返回 ok，超时返回 timeout；
+     *         没有带外状态通道的传输层返回 not_supported
+     *
+     * 可与同一传输层上的读写并发调用。
+     */
+    virtual result_t<void> wait_service_request(milliseconds_t timeout_ms) {
+        (void)timeout_ms;
+        return make_error_void(error_code_t::not_supported,
+                               "Service request not supported by transport");
+    }
+
+    /**
+     * @brief 读取状态字节（串行轮询，不经过消息通道）
+     * @return 成功返回状态字节；不支持时返回 not_supported
+     */
+    virtual result_t<uint8_t> read_status_byte() {
+        return make_error<uint8_t>(error_code_t::not_supported,
+                                   "Status byte poll not supported by transport");
+    }
+
     // ========================================================================
     // 配置
     // ========================================================================
@@ -141,6 +229,49 @@ public:
      * @brief 获取传输类型名称（用于日志）
      */
     virtual const char* type_name() const = 0;
+
+    /**
+     * @brief 可供 poll/epoll 监视的底层描述符
+     * @return 描述符；未打开或不支持时返回 -1
+     *
+     * 反应器（io_reactor_t）据此把传输层注册到事件循环。
+     */
+    virtual int native_handle() const {
+        return -1;
+    }
+
+    // ========================================================================
+    // 统计
+    // ========================================================================
+
+    /**
+     * @brief I/O 统计快照
+     * @return 不统计的传输层返回全零
+     */
+    virtual transport_stats_t stats() const {
+        return transport_stats_t();
+    }
+
+    /**
+     * @brief 清零 I/O 统计
+     */
+    virtual void reset_stats() {}
+
+private:
+    // 将 written 字节计入片段序列，更新当前片段索引和片段内偏移
+    static void _advance_pieces(span_t<const const_byte_span_t> pieces, size_t written,
+                                size_t& index, size_t& offset) {
+        while (index < pieces.size() && written > 0) {
+            const size_t left = pieces[index].size() - offset;
+            if (written < left) {
+                offset += written;
+                return;
+            }
+            written -= left;
+            ++index;
+            offset = 0;
+        }
+    }
 };
 
 // ============================================================================
@@ -155,6 +286,9 @@ using transport_ptr_t = std::unique_ptr<i_transport_t>;
 
 /**
  * @brief 传输层基类，提供通用功能
+ *
+ * 派生类在 read()/readv() 和 write()/writev() 的最外层调用
+ * m_counters.record_read()/record_write()，stats() 即可反映实际的系统调用情况。
  */
 class transport_base_t : public i_transport_t {
 public:
@@ -166,8 +300,59 @@ public:
         m_config = config;
     }
 
+    transport_stats_t stats() const override {
+        return m_counters.snapshot();
+    }
+
+    void reset_stats() override {
+        m_counters.reset();
+    }
+
+    /**
+     * @brief 默认聚集写入：依次调用 write()
+     * 
+     * 遇到短写时立即返回已写入的字节数；支持向量化系统调用的传输层应重写。
+     */
+    result_t<size_t> writev(span_t<const const_byte_span_t> pieces,
+                            milliseconds_t timeout_ms = 0) override {
+        size_t total = 0;
+        for (size_t i = 0; i < pieces.size(); ++i) {
+            if (pieces[i].empty()) {
+                continue;
+            }
+            auto result = write(pieces[i], timeout_ms);
+            if (!result) {
+                if (total > 0) {
+                    return total;
+                }
+                return make_unexpected(result.error());
+            }
+            total += *result;
+            if (*result < pieces[i].size()) {
+                break;
+            }
+        }
+        return total;
+    }
+
+    /**
+     * @brief 默认分散读取：对第一个非空缓冲区调用一次 read()
+     * 
+     * 与 POSIX readv 一样允许只填充部分缓冲区，避免为填满后续缓冲区而阻塞。
+     */
+    result_t<size_t> readv(span_t<const byte_span_t> buffers,
+                           milliseconds_t timeout_ms = 0) override {
+        for (size_t i = 0; i < buffers.size(); ++i) {
+            if (!buffers[i].empty()) {
+                return read(buffers[i], timeout_ms);
+            }
+        }
+        return static_cast<size_t>(0);
+    }
+
 protected:
     transport_config_t m_config;
+    transport_counters_t m_counters;
 };
 
 }  // namespace vdl
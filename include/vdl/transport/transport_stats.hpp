@@ -0,0 +1,231 @@
+/**
+ * @file transport_stats.hpp
+ * @brief 传输层 I/O 统计
+ *
+ * 常开的无锁计数器，用于区分“线路慢”“仪器慢”和“读取过碎”。
+ */
+
+#ifndef VDL_TRANSPORT_TRANSPORT_STATS_HPP
+#define VDL_TRANSPORT_TRANSPORT_STATS_HPP
+
+#include "../core/types.hpp"
+#include "../core/error.hpp"
+#include "../core/noncopyable.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+namespace vdl {
+
+// ============================================================================
+// transport_stats_t - 统计快照
+// ============================================================================
+
+/**
+ * @brief 传输层统计快照
+ *
+ * 直方图按 2 的幂分桶：桶 0 统计值为 0 的样本，
+ * 桶 i（i >= 1）统计 [2^(i-1), 2^i) 内的样本，最后一个桶包含所有更大的值。
+ */
+struct transport_stats_t {
+    static constexpr size_t k_histogram_buckets = 32;
+
+    using histogram_t = std::array<uint64_t, k_histogram_buckets>;
+
+    uint64_t bytes_read = 0;               ///< 读取的字节数
+    uint64_t bytes_written = 0;            ///< 写入的字节数
+    uint64_t read_calls = 0;               ///< read()/readv() 调用次数
+    uint64_t write_calls = 0;              ///< write()/writev() 调用次数
+    uint64_t short_reads = 0;              ///< 成功但未填满缓冲区的读取
+    uint64_t short_writes = 0;             ///< 成功但未写完数据的写入
+    uint64_t read_timeouts = 0;            ///< 超时的读取
+    uint64_t write_timeouts = 0;           ///< 超时的写入
+    uint64_t read_errors = 0;              ///< 超时以外的读取错误
+    uint64_t write_errors = 0;             ///< 超时以外的写入错误
+
+    histogram_t read_size_histogram{};     ///< 每次成功读取的字节数
+    histogram_t read_time_histogram{};     ///< 每次读取的耗时（微秒）
+    histogram_t write_time_histogram{};    ///< 每次写入的耗时（微秒）
+
+    /**
+     * @brief 平均每次成功读取的字节数
+     */
+    double average_read_size() const {
+        const uint64_t reads = read_calls - read_timeouts - read_errors;
+        return reads == 0 ? 0.0 : static_cast<double>(bytes_read) / static_cast<double>(reads);
+    }
+};
+
+// ============================================================================
+// transport_counters_t - 无锁计数器
+// ============================================================================
+
+/**
+ * @brief 传输层计数器
+ *
+ * 所有计数使用 relaxed 原子操作，不加锁；每次调用的额外开销为
+ * 两次单调时钟读取和几次无竞争的原子加法。快照不保证各计数之间的一致性。
+ *
+ * @code
+ * result_t<size_t> read(byte_span_t buffer, milliseconds_t timeout_ms) override {
+ *     const auto start = transport_counters_t::now();
+ *     auto result = _read(buffer, timeout_ms);
+ *     m_counters.record_read(buffer.size(), result, start);
+ *     return result;
+ * }
+ * @endcode
+ */
+class transport_counters_t : private noncopyable_t {
+public:
+    using io_clock_t = std::chrono::steady_clock;
+
+    transport_counters_t() {
+        reset();
+    }
+
+    static io_clock_t::time_point now() {
+        return io_clock_t::now();
+    }
+
+    /**
+     * @brief 记录一次读取
+     * @param requested 缓冲区容量
+     * @param result 读取结果
+     * @param start 调用开始时间
+     */
+    void record_read(size_t requested, const result_t<size_t>& result,
+                     io_clock_t::time_point start) {
+        _add(m_read_calls, 1);
+        _add(m_read_time[_bucket(_elapsed_us(start))], 1);
+        if (!result) {
+            _add(result.error().code() == error_code_t::timeout ? m_read_timeouts : m_read_errors, 1);
+            return;
+        }
+        const size_t n = *result;
+        _add(m_bytes_read, n);
+        _add(m_read_size[_bucket(n)], 1);
+        if (n < requested) {
+            _add(m_short_reads, 1);
+        }
+    }
+
+    /**
+     * @brief 记录一次写入
+     * @param requested 待写入的字节数
+     * @param result 写入结果
+     * @param start 调用开始时间
+     */
+    void record_write(size_t requested, const result_t<size_t>& result,
+                      io_clock_t::time_point start) {
+        _add(m_write_calls, 1);
+        _add(m_write_time[_bucket(_elapsed_us(start))], 1);
+        if (!result) {
+            _add(result.error().code() == error_code_t::timeout ? m_write_timeouts : m_write_errors, 1);
+            return;
+        }
+        _add(m_bytes_written, *result);
+        if (*result < requested) {
+            _add(m_short_writes, 1);
+        }
+    }
+
+    /**
+     * @brief 读取快照
+     */
+    transport_stats_t snapshot() const {
+        transport_stats_t stats;
+        stats.bytes_read = _load(m_bytes_read);
+        stats.bytes_written = _load(m_bytes_written);
+        stats.read_calls = _load(m_read_calls);
+        stats.write_calls = _load(m_write_calls);
+        stats.short_reads = _load(m_short_reads);
+        stats.short_writes = _load(m_short_writes);
+        stats.read_timeouts = _load(m_read_timeouts);
+        stats.write_timeouts = _load(m_write_timeouts);
+        stats.read_errors = _load(m_read_errors);
+        stats.write_errors = _load(m_write_errors);
+        for (size_t i = 0; i < transport_stats_t::k_histogram_buckets; ++i) {
+            stats.read_size_histogram[i] = _load(m_read_size[i]);
+            stats.read_time_histogram[i] = _load(m_read_time[i]);
+            stats.write_time_histogram[i] = _load(m_write_time[i]);
+        }
+        return stats;
+    }
+
+    /**
+     * @brief 清零所有计数
+     */
+    void reset() {
+        _clear(m_bytes_read);
+        _clear(m_bytes_written);
+        _clear(m_read_calls);
+        _clear(m_write_calls);
+        _clear(m_short_reads);
+        _clear(m_short_writes);
+        _clear(m_read_timeouts);
+        _clear(m_write_timeouts);
+        _clear(m_read_errors);
+        _clear(m_write_errors);
+        for (size_t i = 0; i < transport_stats_t::k_histogram_buckets; ++i) {
+            _clear(m_read_size[i]);
+            _clear(m_read_time[i]);
+            _clear(m_write_time[i]);
+        }
+    }
+
+    /**
+     * @brief 样本所在的直方图桶
+     */
+    static size_t bucket_of(uint64_t value) {
+        return _bucket(value);
+    }
+
+private:
+    using counter_t = std::atomic<uint64_t>;
+
+    static void _add(counter_t& counter, uint64_t value) {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    static uint64_t _load(const counter_t& counter) {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+    static void _clear(counter_t& counter) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+
+    static uint64_t _elapsed_us(io_clock_t::time_point start) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            io_clock_t::now() - start).count();
+        return elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0;
+    }
+
+    static size_t _bucket(uint64_t value) {
+        size_t bucket = 0;
+        while (value != 0 && bucket + 1 < transport_stats_t::k_histogram_buckets) {
+            value >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    counter_t m_bytes_read;
+    counter_t m_bytes_written;
+    counter_t m_read_calls;
+    counter_t m_write_calls;
+    counter_t m_short_reads;
+    counter_t m_short_writes;
+    counter_t m_read_timeouts;
+    counter_t m_write_timeouts;
+    counter_t m_read_errors;
+    counter_t m_write_errors;
+    counter_t m_read_size[transport_stats_t::k_histogram_buckets];
+    counter_t m_read_time[transport_stats_t::k_histogram_buckets];
+    counter_t m_write_time[transport_stats_t::k_histogram_buckets];
+};
+
+}  // namespace vdl
+
+#endif  // VDL_TRANSPORT_TRANSPORT_STATS_HPP
@@ -39,9 +39,21 @@
 #include "core/types.hpp"
 #include "core/error.hpp"
 #include "core/buffer.hpp"
+#include "core/byte_swap.hpp"
+#include "core/tag.hpp"
+#include "core/spsc_ring_buffer.hpp"
+#include "core/spsc_queue.hpp"
+#include "core/mpsc_queue.hpp"
+#include "core/event_dispatcher.hpp"
+#include "core/deadline.hpp"
 #include "core/memory.hpp"
+#include "core/arena.hpp"
 #include "core/logging.hpp"
 #include "core/scope_guard.hpp"
+#include "core/fair_mutex.hpp"
+#include "core/thread_pool.hpp"
+#include "core/number_parser.hpp"
+#include "core/number_format.hpp"
 
 // ============================================================================
 // 协议模块
@@ -55,22 +67,45 @@
 // ============================================================================
 
 #include "codec/codec.hpp"
+#include "codec/crc16.hpp"
 #include "codec/binary_codec.hpp"
+#include "codec/modbus_codec.hpp"
+#include "codec/frame_layout.hpp"
+#include "codec/ascii_codec.hpp"
 
 // ============================================================================
 // 传输层模块
 // ============================================================================
 
 #include "transport/transport.hpp"
+#include "transport/transport_stats.hpp"
 #include "transport/mock_transport.hpp"
+#include "transport/sim_transport.hpp"
+#ifndef _WIN32
+#include "transport/tcp_transport.hpp"
+#include "transport/serial_transport.hpp"
+#include "transport/capture_transport.hpp"
+#include "transport/replay_transport.hpp"
+#endif
 
 // ============================================================================
 // 设备层模块
 // ============================================================================
 
 #include "device/device.hpp"
+#include "device/circuit_breaker.hpp"
+#include "device/async_response.hpp"
+#include "device/command_priority.hpp"
+#include "device/device_metrics.hpp"
+#include "device/execution_observer.hpp"
 #include "device/device_impl.hpp"
 #include "device/device_guard.hpp"
+#include "device/device_pool.hpp"
+#include "device/identity_cache.hpp"
+#include "device/device_group.hpp"
+#include "device/trace_file.hpp"
+#include "device/unsolicited_dispatcher.hpp"
+#include "device/read_planner.hpp"
 // #include "device/scpi_adapter.hpp"  // 在使用示例中直接包含
 
 // ============================================================================
@@ -79,11 +114,22 @@
 
 #include "heartbeat/heartbeat_config.hpp"
 #include "heartbeat/heartbeat_strategy.hpp"
+#include "heartbeat/rtt_estimator.hpp"
+#include "heartbeat/heartbeat_scheduler.hpp"
 #include "heartbeat/heartbeat_runner.hpp"
 #include "heartbeat/strategies/ping_heartbeat.hpp"
 #include "heartbeat/strategies/echo_heartbeat.hpp"
 #include "heartbeat/strategies/scpi_heartbeat.hpp"
 
+// ============================================================================
+// 反应器模块
+// ============================================================================
+
+#ifndef _WIN32
+#include "reactor/io_reactor.hpp"
+#include "reactor/reactor_device.hpp"
+#endif
+
 // ============================================================================
 // 版本信息
 // ============================================================================
@@ -4,8 +4,10 @@
  */
 
 #include "vdl/heartbeat/heartbeat_runner.hpp"
+#include "vdl/device/command_priority.hpp"
 #include "vdl/core/logging.hpp"
-#include "vdl/core/memory.hpp"
+
+#include <algorithm>
 
 namespace vdl {
 
@@ -17,10 +19,22 @@ heartbeat_runner_t::heartbeat_runner_t(
     i_device_t& device,
     heartbeat_strategy_ptr_t strategy,
     const heartbeat_config_t& config
+)
+    : heartbeat_runner_t(device, std::move(strategy), config,
+                         heartbeat_scheduler_t::instance())
+{
+}
+
+heartbeat_runner_t::heartbeat_runner_t(
+    i_device_t& device,
+    heartbeat_strategy_ptr_t strategy,
+    const heartbeat_config_t& config,
+    heartbeat_scheduler_t& scheduler
 )
     : m_device(device)
     , m_strategy(std::move(strategy))
     , m_config(config)
+    , m_scheduler(scheduler)
     , m_last_error(error_code_t::ok, "")
 {
 }
@@ -43,8 +57,14 @@ result_t<void> heartbeat_runner_t::start() {
     m_running.store(true);
     m_paused.store(false);
     m_stop_requested.store(false);
+    m_seen_activity = m_device.last_success_time();
     
-    m_thread = make_unique<std::thread>(&heartbeat_runner_t::_run_loop, this);
+    milliseconds_t interval;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        interval = m_config.interval;
+    }
+    m_task_id = m_scheduler.schedule(interval, [this] { return _tick(); });
     
     VDL_LOG_INFO("Heartbeat started with strategy: %s", strategy_name());
     
@@ -57,20 +77,26 @@ void heartbeat_runner_t::stop() {
     }
 
     m_stop_requested.store(true);
-    m_cv.notify_all();
-
-    if (m_thread && m_thread->joinable()) {
-        m_thread->join();
-    }
+    m_scheduler.cancel(m_task_id);
 
     m_running.store(false);
     m_paused.store(false);
-    m_thread.reset();
+    m_task_id = 0;
 
     VDL_LOG_INFO("Heartbeat stopped (strategy: %s)", strategy_name());
     
     _trigger_callback(heartbeat_event_t::stopped, m_failure_count.load(), 
                      error_t(error_code_t::ok, "Heartbeat stopped"));
+
+    // 停止后不再有回调：等待已投递的事件执行完
+    event_dispatcher_t* dispatcher;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        dispatcher = m_dispatcher;
+    }
+    if (dispatcher) {
+        dispatcher->flush();
+    }
 }
 
 void heartbeat_runner_t::pause() {
@@ -91,74 +117,124 @@ void heartbeat_runner_t::resume() {
     }
 
     m_paused.store(false);
-    m_cv.notify_all();
+    m_scheduler.trigger(m_task_id);   // 恢复后立即心跳一次，不等待剩余间隔
 
     VDL_LOG_INFO("Heartbeat resumed (strategy: %s)", strategy_name());
     _trigger_callback(heartbeat_event_t::resumed, m_failure_count.load(),
                      error_t(error_code_t::ok, "Heartbeat resumed"));
 }
 
-void heartbeat_runner_t::_run_loop() {
-    while (!m_stop_requested.load()) {
-        // 检查是否暂停
+milliseconds_t heartbeat_runner_t::_tick() {
+    if (m_stop_requested.load()) {
+        return -1;
+    }
+
+    // 获取当前配置的副本
+    heartbeat_config_t config;
+    execution_observer_ptr_t observer;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        config = m_config;
+        config.interval = _effective_interval_locked(m_config);
+        observer = m_observer;
+    }
+
+    // 暂停期间保留调度，resume() 会立即触发下一次心跳
+    if (m_paused.load()) {
+        return config.interval;
+    }
+
+    milliseconds_t idle_delay = 0;
+    if (config.idle_only && _recent_traffic(config, idle_delay)) {
+        return idle_delay;
+    }
+
+    // 心跳以最低优先级排队，不会挤在等待中的应用命令之前
+    command_priority_scope_t priority(command_priority_t::heartbeat);
+
+    // 设备被独占或正在执行命令时跳过本次心跳，而不是排队等待
+    bool device_locked = false;
+    if (config.pause_during_lock) {
+        device_locked = m_device.try_lock();
+    }
+
+    if (config.pause_during_lock && !device_locked) {
+        m_skipped_count.fetch_add(1);
+        _trigger_callback(heartbeat_event_t::skipped, m_failure_count.load(),
+                         error_t(error_code_t::busy, "Heartbeat skipped: device busy"));
+    } else {
+        // 执行心跳
+        bool success;
         {
-            std::unique_lock<std::mutex> lock(m_mutex);
-            m_cv.wait(lock, [this] { return !m_paused.load() || m_stop_requested.load(); });
+            execution_span_scope_t span(observer.get(), span_kind_t::heartbeat, tag_t(), 0);
+            success = _do_heartbeat();
+            if (execution_span_t* traced = span.get()) {
+                if (m_cached_command) {
+                    traced->tag = m_cached_command->tag();
+                    traced->function_code = m_cached_command->function_code();
+                }
+                traced->attempt = 1;
+                traced->outcome = success ? error_t(error_code_t::ok) : m_last_error;
+            }
         }
-
-        if (m_stop_requested.load()) {
-            break;
+        if (device_locked) {
+            m_device.unlock();
         }
+        // 心跳自身的响应不算作应用流量
+        m_seen_activity = m_device.last_success_time();
+        _record_result(success, config);
+    }
 
-        // 获取当前配置的副本
-        heartbeat_config_t config;
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            config = m_config;
+    return m_stop_requested.load() ? -1 : config.interval;
+}
+
+bool heartbeat_runner_t::_recent_traffic(const heartbeat_config_t& config,
+                                         milliseconds_t& next_delay) {
+    const auto last = m_device.last_success_time();
+    const auto idle = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - last).count();
+    if (last == std::chrono::steady_clock::time_point() || idle >= config.interval) {
+        return false;
+    }
+
+    // 空闲满 interval 时再检查
+    next_delay = config.interval - static_cast<milliseconds_t>(idle);
+    if (last != m_seen_activity) {
+        m_seen_activity = last;
+        _record_result(true, config);
+    }
+    return true;
+}
+
+void heartbeat_runner_t::_record_result(bool success, const heartbeat_config_t& config) {
+    if (success) {
+        m_success_count.fetch_add(1);
+
+        // 重置失败计数
+        if (config.auto_reset_failures) {
+            m_failure_count.store(0);
         }
 
-        // 执行心跳
-        bool success = _do_heartbeat();
+        _trigger_callback(heartbeat_event_t::success, 0,
+                         error_t(error_code_t::ok, "Heartbeat success"));
+    } else {
+        m_failure_count.fetch_add(1);
+        m_total_failures.fetch_add(1);
+
+        uint8_t failures = m_failure_count.load();
+
+        // 检查是否达到最大失败次数
+        if (failures >= config.max_failures) {
+            _trigger_callback(heartbeat_event_t::max_failures, failures, m_last_error);
 
-        if (success) {
-            m_success_count.fetch_add(1);
-            
-            // 重置失败计数
+            // 重置计数以允许新一轮重试
             if (config.auto_reset_failures) {
                 m_failure_count.store(0);
             }
-
-            _trigger_callback(heartbeat_event_t::success, 0,
-                             error_t(error_code_t::ok, "Heartbeat success"));
         } else {
-            m_failure_count.fetch_add(1);
-            m_total_failures.fetch_add(1);
-
-            uint8_t failures = m_failure_count.load();
-
-            // 检查是否达到最大失败次数
-            if (failures >= config.max_failures) {
-                _trigger_callback(heartbeat_event_t::max_failures, failures, m_last_error);
-                
-                // 重置计数以允许新一轮重试
-                if (config.auto_reset_failures) {
-                    m_failure_count.store(0);
-                }
-            } else {
-                _trigger_callback(heartbeat_event_t::failure, failures, m_last_error);
-            }
-        }
-
-        // 等待直到下一个心跳时间或被停止
-        if (!m_stop_requested.load()) {
-            std::unique_lock<std::mutex> lock(m_mutex);
-            // 使用 wait_for 等待指定时间或被唤醒
-            m_cv.wait_for(lock, std::chrono::milliseconds(config.interval), 
-                         [this] { return m_stop_requested.load(); });
+            _trigger_callback(heartbeat_event_t::failure, failures, m_last_error);
         }
     }
-
-    VDL_LOG_INFO("Heartbeat thread exiting (strategy: %s)", strategy_name());
 }
 
 bool heartbeat_runner_t::_do_heartbeat() {
@@ -170,25 +246,39 @@ bool heartbeat_runner_t::_do_heartbeat() {
     }
 
     // 获取配置的副本
-    heartbeat_config_t config;
+    milliseconds_t timeout;
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        config = m_config;
+        timeout = _effective_timeout_locked(m_config);
     }
 
-    // 生成心跳命令
-    auto cmd_result = m_strategy->make_heartbeat_command();
-    if (!cmd_result) {
-        m_last_error = cmd_result.error();
-        return false;
+    // 生成心跳命令（固定命令只生成一次）
+    if (!m_cached_command || !m_strategy->is_command_reusable()) {
+        auto cmd_result = m_strategy->make_heartbeat_command();
+        if (!cmd_result) {
+            m_last_error = cmd_result.error();
+            return false;
+        }
+        m_cached_command = std::move(*cmd_result);
     }
 
-    // 执行命令
-    auto exec_result = m_device.execute(*cmd_result, config.timeout);
+    // 执行命令并计时
+    const auto start = std::chrono::steady_clock::now();
+    auto exec_result = m_device.execute(*m_cached_command, timeout);
+    const auto rtt = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
     if (!exec_result) {
+        if (exec_result.error().code() == error_code_t::timeout) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_rtt.on_timeout();
+        }
         m_last_error = exec_result.error();
         return false;
     }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_rtt.add_sample(static_cast<microseconds_t>(rtt.count()));
+    }
 
     // 验证响应
     bool validated = m_strategy->validate_response(*exec_result);
@@ -201,18 +291,61 @@ bool heartbeat_runner_t::_do_heartbeat() {
     return true;
 }
 
+milliseconds_t heartbeat_runner_t::_effective_timeout_locked(
+    const heartbeat_config_t& config) const {
+    if (!config.adaptive_timeout || !m_rtt.has_sample()) {
+        return config.timeout;
+    }
+    // RTO 向上取整到毫秒
+    milliseconds_t timeout = (m_rtt.rto() + 999) / 1000;
+    timeout = std::max(timeout, config.min_timeout);
+    return std::min(timeout, config.max_timeout);
+}
+
+milliseconds_t heartbeat_runner_t::_effective_interval_locked(
+    const heartbeat_config_t& config) const {
+    if (config.rtt_interval_factor == 0 || !m_rtt.has_sample()) {
+        return config.interval;
+    }
+    const milliseconds_t scaled = config.rtt_interval_factor * ((m_rtt.rto() + 999) / 1000);
+    return std::max(config.interval, scaled);
+}
+
 void heartbeat_runner_t::_trigger_callback(
     heartbeat_event_t event,
     uint8_t failure_count,
     const error_t& error
 ) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    if (m_callback) {
-        try {
-            m_callback(event, failure_count, error);
-        } catch (const std::exception& e) {
-            VDL_LOG_WARN("Heartbeat callback threw exception: %s", e.what());
+    // 复制回调后释放锁：回调期间其他线程可以读取状态或修改配置
+    heartbeat_callback_t callback;
+    event_dispatcher_t* dispatcher;
+    event_dispatcher_t::coalesce_flag_t success_flag;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_callback) {
+            return;
+        }
+        callback = m_callback;
+        dispatcher = m_dispatcher;
+        success_flag = m_success_flag;
+    }
+
+    if (dispatcher) {
+        auto task = [callback, event, failure_count, error] {
+            callback(event, failure_count, error);
+        };
+        if (event == heartbeat_event_t::success && success_flag) {
+            dispatcher->post_coalesced(success_flag, std::move(task));
+        } else {
+            dispatcher->post(std::move(task));
         }
+        return;
+    }
+
+    try {
+        callback(event, failure_count, error);
+    } catch (const std::exception& e) {
+        VDL_LOG_WARN("Heartbeat callback threw exception: %s", e.what());
     }
 }
 
@@ -0,0 +1,254 @@
+/**
+ * @file heartbeat_scheduler.cpp
+ * @brief 共享心跳调度器实现
+ */
+
+#include "vdl/heartbeat/heartbeat_scheduler.hpp"
+#include "vdl/core/logging.hpp"
+
+#include <algorithm>
+
+namespace vdl {
+
+namespace {
+
+constexpr size_t k_scheduler_queue_capacity = 1024;  ///< 工作线程池队列容量
+
+size_t round_up_pow2(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+}  // namespace
+
+// ============================================================================
+// heartbeat_scheduler_t 实现
+// ============================================================================
+
+heartbeat_scheduler_t::heartbeat_scheduler_t(const heartbeat_scheduler_config_t& config)
+    : m_config(config)
+    , m_mask(round_up_pow2(config.wheel_size == 0 ? 1 : config.wheel_size) - 1)
+    , m_wheel(m_mask + 1)
+    , m_epoch(std::chrono::steady_clock::now())
+    , m_jitter_state(static_cast<uint64_t>(m_epoch.time_since_epoch().count()) ^
+                     reinterpret_cast<uintptr_t>(this))
+    , m_pool(config.worker_count, k_scheduler_queue_capacity)
+{
+    if (m_config.tick <= 0) {
+        m_config.tick = 1;
+    }
+    if (m_jitter_state == 0) {
+        m_jitter_state = 0x9E3779B97F4A7C15ULL;
+    }
+    m_timer_thread = std::thread(&heartbeat_scheduler_t::_timer_loop, this);
+}
+
+heartbeat_scheduler_t::~heartbeat_scheduler_t() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_timer_cv.notify_all();
+    if (m_timer_thread.joinable()) {
+        m_timer_thread.join();
+    }
+    // 已交给工作线程的任务看到 m_stopping 后直接返回
+    m_pool.shutdown();
+}
+
+heartbeat_scheduler_t& heartbeat_scheduler_t::instance() {
+    static heartbeat_scheduler_t scheduler;
+    return scheduler;
+}
+
+heartbeat_scheduler_t::task_id_t heartbeat_scheduler_t::schedule(milliseconds_t interval,
+                                                                 task_t task) {
+    auto entry = std::make_shared<entry_t>();
+    entry->task = std::move(task);
+
+    task_id_t id;
+    size_t task_count;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        id = ++m_next_id;
+        entry->id = id;
+        m_entries[id] = entry;
+        task_count = m_entries.size();
+        _insert_locked(entry, _initial_delay(interval));
+    }
+    if (m_config.worker_count == 0) {
+        // 每个任务同一时刻最多占用一个线程，线程数不少于任务数时不会互相阻塞
+        m_pool.grow(std::min(task_count, std::max<size_t>(1, m_config.max_workers)));
+    }
+    m_timer_cv.notify_one();
+    return id;
+}
+
+void heartbeat_scheduler_t::trigger(task_id_t id) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(id);
+        if (it == m_entries.end() || !it->second->in_wheel) {
+            return;
+        }
+        _remove_locked(it->second);
+        _insert_locked(it->second, 0);
+    }
+    m_timer_cv.notify_one();
+}
+
+void heartbeat_scheduler_t::cancel(task_id_t id) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(id);
+    if (it == m_entries.end()) {
+        return;
+    }
+    entry_ptr_t entry = it->second;
+    m_entries.erase(it);
+    entry->cancelled = true;
+    if (entry->in_wheel) {
+        _remove_locked(entry);
+    }
+
+    // 在任务自身中取消时不能等待自己
+    if (entry->runner != std::this_thread::get_id()) {
+        m_done_cv.wait(lock, [&entry] { return !entry->running; });
+    }
+}
+
+size_t heartbeat_scheduler_t::task_count() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+void heartbeat_scheduler_t::_timer_loop() {
+    const std::chrono::milliseconds tick(m_config.tick);
+    std::vector<entry_ptr_t> due;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopping) {
+        if (m_wheel_count == 0) {
+            m_timer_cv.wait(lock, [this] { return m_stopping || m_wheel_count > 0; });
+            continue;
+        }
+
+        const auto next_tick_at = m_epoch + tick * static_cast<int64_t>(m_current_tick + 1);
+        if (m_timer_cv.wait_until(lock, next_tick_at, [this] { return m_stopping; })) {
+            break;
+        }
+
+        // 推进到当前时刻，落后的刻度（如线程被延迟调度）逐一补上
+        const uint64_t target = static_cast<uint64_t>(
+            (std::chrono::steady_clock::now() - m_epoch) / tick);
+        while (m_current_tick < target) {
+            ++m_current_tick;
+            auto& slot = m_wheel[static_cast<size_t>(m_current_tick) & m_mask];
+            for (size_t i = 0; i < slot.size();) {
+                entry_ptr_t& entry = slot[i];
+                if (entry->expiry_tick > m_current_tick) {
+                    ++i;   // 属于后面的轮次
+                    continue;
+                }
+                entry->in_wheel = false;
+                entry->running = true;
+                due.push_back(std::move(entry));
+                entry = std::move(slot.back());
+                slot.pop_back();
+                --m_wheel_count;
+            }
+        }
+
+        if (due.empty()) {
+            continue;
+        }
+
+        // 释放锁后提交：队列满时 submit() 会阻塞
+        lock.unlock();
+        for (auto& entry : due) {
+            m_pool.submit([this, entry] { _run_entry(entry); });
+        }
+        due.clear();
+        lock.lock();
+    }
+}
+
+void heartbeat_scheduler_t::_run_entry(const entry_ptr_t& entry) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (entry->cancelled || m_stopping) {
+            entry->running = false;
+            m_done_cv.notify_all();
+            return;
+        }
+        entry->runner = std::this_thread::get_id();
+    }
+
+    const milliseconds_t next_delay = entry->task();
+
+    bool rescheduled = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        entry->running = false;
+        entry->runner = std::thread::id();
+        if (!entry->cancelled && !m_stopping) {
+            if (next_delay >= 0) {
+                _insert_locked(entry, next_delay);
+                rescheduled = true;
+            } else {
+                m_entries.erase(entry->id);
+            }
+        }
+    }
+    m_done_cv.notify_all();
+    if (rescheduled) {
+        m_timer_cv.notify_one();
+    }
+}
+
+void heartbeat_scheduler_t::_insert_locked(const entry_ptr_t& entry, milliseconds_t delay) {
+    if (m_wheel_count == 0) {
+        // 时间轮空闲时刻度停止推进，插入前与当前时刻对齐
+        m_current_tick = static_cast<uint64_t>(
+            (std::chrono::steady_clock::now() - m_epoch) /
+            std::chrono::milliseconds(m_config.tick));
+    }
+    uint64_t ticks = delay > 0
+        ? static_cast<uint64_t>((delay + m_config.tick - 1) / m_config.tick)
+        : 0;
+    if (ticks == 0) {
+        ticks = 1;
+    }
+    entry->expiry_tick = m_current_tick + ticks;
+    entry->in_wheel = true;
+    m_wheel[static_cast<size_t>(entry->expiry_tick) & m_mask].push_back(entry);
+    ++m_wheel_count;
+}
+
+void heartbeat_scheduler_t::_remove_locked(const entry_ptr_t& entry) {
+    auto& slot = m_wheel[static_cast<size_t>(entry->expiry_tick) & m_mask];
+    for (size_t i = 0; i < slot.size(); ++i) {
+        if (slot[i] == entry) {
+            slot[i] = std::move(slot.back());
+            slot.pop_back();
+            --m_wheel_count;
+            break;
+        }
+    }
+    entry->in_wheel = false;
+}
+
+milliseconds_t heartbeat_scheduler_t::_initial_delay(milliseconds_t interval) {
+    if (!m_config.jitter_start || interval <= 1) {
+        return 0;
+    }
+    // xorshift64：只用于错开首次触发时间
+    m_jitter_state ^= m_jitter_state << 13;
+    m_jitter_state ^= m_jitter_state >> 7;
+    m_jitter_state ^= m_jitter_state << 17;
+    return static_cast<milliseconds_t>(m_jitter_state % static_cast<uint64_t>(interval));
+}
+
+}  // namespace vdl
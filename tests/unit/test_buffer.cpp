@@ -5,6 +5,14 @@
 
 #include <catch.hpp>
 #include <vdl/core/buffer.hpp>
+#include <vdl/core/spsc_ring_buffer.hpp>
+#include <vdl/core/spsc_queue.hpp>
+#include <vdl/core/mpsc_queue.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
 
 // ============================================================================
 // ring_buffer_t 基础测试
@@ -166,3 +174,382 @@ TEST_CASE("ring_buffer_t null pointer handling", "[core][buffer]") {
     REQUIRE(buffer.read(nullptr, 10) == 0);
     REQUIRE(buffer.peek(nullptr, 10) == 0);
 }
+
+// ============================================================================
+// ring_buffer_t 零拷贝视图测试
+// ============================================================================
+
+TEST_CASE("ring_buffer_t readable views across wraparound", "[core][buffer]") {
+    vdl::ring_buffer_t buffer(8);
+
+    vdl::byte_t data1[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+    buffer.write(data1, 6);
+    buffer.skip(4);
+
+    vdl::byte_t data2[] = {0xAA, 0xBB, 0xCC, 0xDD};
+    buffer.write(data2, 4);
+    REQUIRE_FALSE(buffer.is_contiguous());
+
+    vdl::const_byte_span_t first = buffer.readable_first();
+    vdl::const_byte_span_t second = buffer.readable_second();
+    REQUIRE(first.size() == 4);
+    REQUIRE(second.size() == 2);
+    REQUIRE(first[0] == 0x05);
+    REQUIRE(second[1] == 0xDD);
+
+    vdl::const_byte_span_t linear = buffer.linearize();
+    REQUIRE(buffer.is_contiguous());
+    REQUIRE(linear.size() == 6);
+    REQUIRE(linear[0] == 0x05);
+    REQUIRE(linear[1] == 0x06);
+    REQUIRE(linear[2] == 0xAA);
+    REQUIRE(linear[5] == 0xDD);
+
+    // 整理后读写语义不变
+    vdl::byte_t out[6];
+    REQUIRE(buffer.read(out, 6) == 6);
+    REQUIRE(out[2] == 0xAA);
+    REQUIRE(buffer.empty());
+}
+
+TEST_CASE("ring_buffer_t write_span and commit_write", "[core][buffer]") {
+    vdl::ring_buffer_t buffer(16);
+
+    vdl::byte_span_t space = buffer.write_span();
+    REQUIRE(space.size() == 16);
+    space[0] = 0x10;
+    space[1] = 0x20;
+    space[2] = 0x30;
+    REQUIRE(buffer.commit_write(3) == 3);
+    REQUIRE(buffer.size() == 3);
+
+    vdl::const_byte_span_t view = buffer.linearize();
+    REQUIRE(view.size() == 3);
+    REQUIRE(view[2] == 0x30);
+
+    // 提交不超过可用空间
+    REQUIRE(buffer.commit_write(100) == 13);
+    REQUIRE(buffer.full());
+}
+
+TEST_CASE("ring_buffer_t write_span compacts instead of wrapping", "[core][buffer]") {
+    vdl::ring_buffer_t buffer(16);
+
+    vdl::byte_t data[14] = {};
+    for (vdl::byte_t i = 0; i < 14; ++i) {
+        data[i] = i;
+    }
+    buffer.write(data, 14);
+    buffer.skip(12);  // 剩余 {12, 13}，尾部仅剩 2 字节
+
+    vdl::byte_span_t space = buffer.write_span();
+    REQUIRE(space.size() == 14);
+    REQUIRE(buffer.is_contiguous());
+
+    vdl::const_byte_span_t view = buffer.readable_first();
+    REQUIRE(view.size() == 2);
+    REQUIRE(view[0] == 12);
+    REQUIRE(view[1] == 13);
+}
+
+// ============================================================================
+// byte_slice_t 测试
+// ============================================================================
+
+TEST_CASE("byte_slice_t shares the underlying buffer", "[core][buffer]") {
+    vdl::byte_slice_t frame(vdl::bytes_t{0x01, 0x02, 0x03, 0x04, 0x05});
+    REQUIRE(frame.size() == 5);
+    REQUIRE(frame.use_count() == 1);
+
+    vdl::byte_slice_t payload = frame.subslice(1, 3);
+    REQUIRE(payload.size() == 3);
+    REQUIRE(payload.data() == frame.data() + 1);
+    REQUIRE(frame.use_count() == 2);
+    REQUIRE(payload.to_bytes() == vdl::bytes_t({0x02, 0x03, 0x04}));
+
+    // 超出范围的子切片被截断
+    REQUIRE(frame.subslice(3).size() == 2);
+    REQUIRE(frame.subslice(5).empty());
+
+    frame.reset();
+    REQUIRE(frame.empty());
+    REQUIRE(payload.use_count() == 1);
+    REQUIRE(payload.view()[0] == 0x02);
+}
+
+// ============================================================================
+// spsc_ring_buffer_t 测试
+// ============================================================================
+
+TEST_CASE("spsc_ring_buffer_t rounds capacity to power of two", "[core][buffer][spsc]") {
+    vdl::spsc_ring_buffer_t rb(100);
+    REQUIRE(rb.capacity() == 128);
+    REQUIRE(rb.empty());
+    REQUIRE(rb.available() == 128);
+}
+
+TEST_CASE("spsc_ring_buffer_t wraps and linearizes", "[core][buffer][spsc]") {
+    vdl::spsc_ring_buffer_t rb(8);
+
+    const vdl::byte_t first[] = {1, 2, 3, 4, 5, 6};
+    REQUIRE(rb.write(first, sizeof(first)) == 6);
+    REQUIRE(rb.consume(4) == 4);
+
+    // 写入跨越缓冲区末尾
+    const vdl::byte_t second[] = {7, 8, 9, 10, 11};
+    REQUIRE(rb.write(second, sizeof(second)) == 5);
+    REQUIRE(rb.size() == 7);
+    REQUIRE(rb.read_span().size() == 4);   // 到末尾为止
+
+    vdl::const_byte_span_t all = rb.linearize();
+    REQUIRE(all.size() == 7);
+    for (size_t i = 0; i < all.size(); ++i) {
+        REQUIRE(all[i] == static_cast<vdl::byte_t>(i + 5));
+    }
+
+    // 满时拒绝写入
+    const vdl::byte_t more[] = {12, 13};
+    REQUIRE(rb.write(more, sizeof(more)) == 1);
+    REQUIRE(rb.full());
+
+    vdl::byte_t out[8];
+    REQUIRE(rb.read(out, sizeof(out)) == 8);
+    REQUIRE(out[7] == 12);
+    REQUIRE(rb.empty());
+}
+
+TEST_CASE("spsc_ring_buffer_t write_span commits in place", "[core][buffer][spsc]") {
+    vdl::spsc_ring_buffer_t rb(16);
+    vdl::byte_span_t space = rb.write_span();
+    REQUIRE(space.size() == 16);
+    space[0] = 0xAA;
+    space[1] = 0xBB;
+    REQUIRE(rb.commit_write(2) == 2);
+
+    vdl::const_byte_span_t data = rb.linearize();
+    REQUIRE(data.size() == 2);
+    REQUIRE(data[0] == 0xAA);
+    REQUIRE(data[1] == 0xBB);
+
+    rb.clear();
+    REQUIRE(rb.empty());
+    REQUIRE(rb.write_span().size() == 16);
+}
+
+TEST_CASE("spsc_ring_buffer_t hands off a stream between threads", "[core][buffer][spsc]") {
+    vdl::spsc_ring_buffer_t rb(256);
+    const size_t total = 1 << 18;
+
+    std::thread producer([&rb, total] {
+        size_t sent = 0;
+        vdl::byte_t chunk[61];
+        while (sent < total) {
+            const size_t n = std::min(sizeof(chunk), total - sent);
+            for (size_t i = 0; i < n; ++i) {
+                chunk[i] = static_cast<vdl::byte_t>((sent + i) & 0xFF);
+            }
+            size_t written = 0;
+            while (written < n) {
+                const size_t w = rb.write(chunk + written, n - written);
+                if (w == 0) {
+                    std::this_thread::yield();
+                }
+                written += w;
+            }
+            sent += n;
+        }
+    });
+
+    size_t received = 0;
+    bool in_order = true;
+    while (received < total) {
+        vdl::const_byte_span_t data = rb.linearize();
+        for (size_t i = 0; i < data.size(); ++i) {
+            in_order = in_order && data[i] == static_cast<vdl::byte_t>((received + i) & 0xFF);
+        }
+        if (data.empty()) {
+            std::this_thread::yield();
+        }
+        received += rb.consume(data.size());
+    }
+    producer.join();
+
+    REQUIRE(in_order);
+    REQUIRE(rb.empty());
+}
+
+// ============================================================================
+// spsc_queue_t 测试
+// ============================================================================
+
+TEST_CASE("spsc_queue_t pushes and pops in order", "[core][spsc]") {
+    vdl::spsc_queue_t<std::unique_ptr<int>> queue(3);
+    REQUIRE(queue.capacity() == 4);
+
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(queue.try_push(std::unique_ptr<int>(new int(i))));
+    }
+    std::unique_ptr<int> extra(new int(4));
+    REQUIRE_FALSE(queue.try_push(std::move(extra)));
+    REQUIRE(extra != nullptr);
+
+    std::unique_ptr<int> out;
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(queue.try_pop(out));
+        REQUIRE(*out == i);
+    }
+    REQUIRE_FALSE(queue.try_pop(out));
+    REQUIRE(queue.empty());
+
+    // 析构时释放未取出的元素
+    REQUIRE(queue.try_push(std::move(extra)));
+}
+
+TEST_CASE("spsc_queue_t hands off objects between threads", "[core][spsc]") {
+    vdl::spsc_queue_t<std::vector<int>> queue(16);
+    const int total = 20000;
+
+    std::thread producer([&queue, total] {
+        for (int i = 0; i < total; ++i) {
+            std::vector<int> item(1, i);
+            while (!queue.try_push(std::move(item))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    bool in_order = true;
+    std::vector<int> item;
+    while (expected < total) {
+        if (!queue.try_pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        in_order = in_order && item.size() == 1 && item[0] == expected;
+        ++expected;
+    }
+    producer.join();
+
+    REQUIRE(in_order);
+    REQUIRE(queue.empty());
+}
+
+// ============================================================================
+// mpsc_queue_t 测试
+// ============================================================================
+
+TEST_CASE("mpsc_queue_t pushes and pops in order", "[core][mpsc]") {
+    vdl::mpsc_queue_t<std::unique_ptr<int>> queue(3);
+    REQUIRE(queue.capacity() == 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(queue.try_push(std::unique_ptr<int>(new int(i))));
+    }
+    std::unique_ptr<int> extra(new int(99));
+    REQUIRE_FALSE(queue.try_push(std::move(extra)));
+    REQUIRE(extra != nullptr);   // 失败时不移动
+    REQUIRE(queue.size() == 4u);
+
+    std::unique_ptr<int> out;
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(queue.try_pop(out));
+        REQUIRE(*out == i);
+    }
+    REQUIRE_FALSE(queue.try_pop(out));
+    REQUIRE(queue.push_count() == 4u);
+    REQUIRE(queue.pop_count() == 4u);
+
+    // 析构时释放未取出的元素
+    REQUIRE(queue.try_push(std::move(extra)));
+}
+
+TEST_CASE("mpsc_queue_t accepts concurrent producers", "[core][mpsc]") {
+    vdl::mpsc_queue_t<std::pair<int, int>> queue(64);
+    const int producers = 4;
+    const int per_producer = 5000;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p, per_producer] {
+            for (int i = 0; i < per_producer; ++i) {
+                while (!queue.try_push(std::make_pair(p, i))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // 每个生产者的元素保持各自的顺序
+    std::vector<int> next(producers, 0);
+    bool in_order = true;
+    int received = 0;
+    std::pair<int, int> item;
+    while (received < producers * per_producer) {
+        if (!queue.try_pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        in_order = in_order && item.second == next[static_cast<size_t>(item.first)];
+        ++next[static_cast<size_t>(item.first)];
+        ++received;
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(in_order);
+    REQUIRE(queue.empty());
+}
+
+// ============================================================================
+// small_bytes_t 测试
+// ============================================================================
+
+TEST_CASE("small_bytes_t stores short data inline", "[core][buffer][small_bytes]") {
+    vdl::small_bytes_t<8> bytes = {1, 2, 3};
+    REQUIRE(bytes.is_inline());
+    REQUIRE(bytes.size() == 3);
+    REQUIRE(bytes[2] == 3);
+    REQUIRE(bytes == vdl::bytes_t({1, 2, 3}));
+
+    // 移动内联数据时复制内容
+    vdl::small_bytes_t<8> moved(std::move(bytes));
+    REQUIRE(moved.is_inline());
+    REQUIRE(moved == vdl::bytes_t({1, 2, 3}));
+    REQUIRE(bytes.empty());
+
+    vdl::small_bytes_t<8> copy = moved;
+    copy.push_back(4);
+    REQUIRE(copy.size() == 4);
+    REQUIRE(copy != moved);
+}
+
+TEST_CASE("small_bytes_t spills to the heap", "[core][buffer][small_bytes]") {
+    vdl::small_bytes_t<4> bytes;
+    for (int i = 0; i < 20; ++i) {
+        bytes.push_back(static_cast<vdl::byte_t>(i));
+    }
+    REQUIRE_FALSE(bytes.is_inline());
+    REQUIRE(bytes.size() == 20);
+    REQUIRE(bytes.back() == 19);
+
+    // 移动堆数据时接管指针
+    const vdl::byte_t* heap = bytes.data();
+    vdl::small_bytes_t<4> moved;
+    moved = std::move(bytes);
+    REQUIRE(moved.data() == heap);
+    REQUIRE(bytes.is_inline());
+    REQUIRE(bytes.empty());
+
+    // 追加自身的数据
+    moved.append(moved.data(), moved.size());
+    REQUIRE(moved.size() == 40);
+    REQUIRE(moved[39] == 19);
+
+    moved.assign(moved.data() + 38, 2);
+    REQUIRE(moved == vdl::bytes_t({18, 19}));
+
+    moved.resize(6, 0xFF);
+    REQUIRE(moved.to_bytes() == vdl::bytes_t({18, 19, 0xFF, 0xFF, 0xFF, 0xFF}));
+}
@@ -5,7 +5,12 @@
 
 #include <catch.hpp>
 #include <vdl/codec/codec.hpp>
+#include <vdl/codec/ascii_codec.hpp>
 #include <vdl/codec/binary_codec.hpp>
+#include <vdl/codec/frame_layout.hpp>
+#include <vdl/codec/modbus_codec.hpp>
+
+#include <vector>
 
 // ============================================================================
 // binary_codec_t 编码测试
@@ -176,3 +181,731 @@ TEST_CASE("binary_codec_t max_frame_size", "[codec][binary]") {
     codec.set_max_frame_size(256);
     REQUIRE(codec.max_frame_size() == 256);
 }
+
+// ============================================================================
+// binary_codec_t 分段编码测试
+// ============================================================================
+
+TEST_CASE("binary_codec_t encode_parts matches encode", "[codec][binary]") {
+    vdl::binary_codec_t codec;
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x10).set_data({0x01, 0x02, 0x03, 0x04, 0x05});
+
+    auto frame = codec.encode(cmd);
+    REQUIRE(frame.has_value());
+
+    vdl::frame_parts_t parts;
+    REQUIRE(codec.encode_parts(cmd, parts).has_value());
+    REQUIRE(parts.total_size() == frame->size());
+
+    // 负载引用命令数据，不拷贝
+    REQUIRE(parts.payload.data() == cmd.data().data());
+
+    vdl::bytes_t joined;
+    joined.insert(joined.end(), parts.header.data(), parts.header.data() + parts.header.size());
+    joined.insert(joined.end(), parts.payload.begin(), parts.payload.end());
+    joined.insert(joined.end(), parts.trailer.data(), parts.trailer.data() + parts.trailer.size());
+    REQUIRE(joined == *frame);
+}
+
+TEST_CASE("binary_codec_t encode_parts respects max_frame_size", "[codec][binary]") {
+    vdl::binary_codec_t codec;
+    codec.set_max_frame_size(8);
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x10).set_data(vdl::bytes_t(16, 0x00));
+
+    vdl::frame_parts_t parts;
+    auto result = codec.encode_parts(cmd, parts);
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().code() == vdl::error_code_t::frame_too_large);
+}
+
+// ============================================================================
+// binary_codec_t encode_into 测试
+// ============================================================================
+
+TEST_CASE("binary_codec_t encode_into writes caller buffer", "[codec][binary]") {
+    vdl::binary_codec_t codec;
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x03).set_data({0x00, 0x01, 0x00, 0x0A});
+
+    auto size = codec.encoded_size(cmd);
+    REQUIRE(size.has_value());
+    REQUIRE(*size == vdl::binary_frame::MIN_FRAME_SIZE + 4);
+
+    vdl::static_buffer_t<32> out;
+    auto written = codec.encode_into(cmd, vdl::byte_span_t(out.data(), out.capacity()));
+    REQUIRE(written.has_value());
+    REQUIRE(*written == *size);
+
+    auto frame = codec.encode(cmd);
+    REQUIRE(frame.has_value());
+    REQUIRE(vdl::bytes_equal(vdl::const_byte_span_t(out.data(), *written),
+                             vdl::const_byte_span_t(frame->data(), frame->size())));
+}
+
+TEST_CASE("binary_codec_t encode_into rejects small buffer", "[codec][binary]") {
+    vdl::binary_codec_t codec;
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x03).set_data({0x00, 0x01});
+
+    vdl::static_buffer_t<4> out;
+    auto written = codec.encode_into(cmd, vdl::byte_span_t(out.data(), out.capacity()));
+    REQUIRE_FALSE(written.has_value());
+    REQUIRE(written.error().code() == vdl::error_code_t::invalid_size);
+}
+
+TEST_CASE("i_codec_t default encode_into falls back to encode", "[codec]") {
+    // 只实现 encode() 的编解码器
+    class plain_codec_t : public vdl::codec_base_t {
+    public:
+        vdl::result_t<vdl::bytes_t> encode(const vdl::command_t& cmd) override {
+            return vdl::bytes_t(cmd.data().begin(), cmd.data().end());
+        }
+        vdl::result_t<vdl::response_t> decode(vdl::const_byte_span_t, size_t& consumed) override {
+            consumed = 0;
+            return vdl::make_error<vdl::response_t>(vdl::error_code_t::incomplete_frame);
+        }
+        size_t frame_length(vdl::const_byte_span_t) const override { return 0; }
+        const char* name() const override { return "plain"; }
+    };
+
+    plain_codec_t codec;
+    vdl::command_t cmd;
+    cmd.set_data({0x01, 0x02, 0x03});
+
+    auto size = codec.encoded_size(cmd);
+    REQUIRE(size.has_value());
+    REQUIRE(*size == 3);
+
+    vdl::bytes_t out(8, 0x00);
+    auto written = codec.encode_into(cmd, vdl::byte_span_t(out.data(), out.size()));
+    REQUIRE(written.has_value());
+    REQUIRE(*written == 3);
+    REQUIRE(out[2] == 0x03);
+
+    REQUIRE_FALSE(codec.encode_into(cmd, vdl::byte_span_t(out.data(), 2)).has_value());
+}
+
+TEST_CASE("binary_codec_t decode_slice references the frame buffer", "[codec][binary]") {
+    vdl::binary_codec_t codec;
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x03).set_data({0x10, 0x20, 0x30});
+    auto frame = codec.encode(cmd);
+    REQUIRE(frame.has_value());
+
+    vdl::byte_slice_t slab(std::move(*frame));
+    size_t consumed = 0;
+    auto resp = codec.decode_slice(slab, consumed);
+    REQUIRE(resp.has_value());
+    REQUIRE(consumed == slab.size());
+    REQUIRE(resp->is_data_shared());
+    REQUIRE(resp->data_view().data() == slab.data() + vdl::binary_frame::HEADER_SIZE);
+    REQUIRE(resp->raw_view().data() == slab.data());
+    REQUIRE(resp->payload() == vdl::bytes_t({0x10, 0x20, 0x30}));
+}
+
+// ============================================================================
+// crc16_ccitt_t 测试
+// ============================================================================
+
+TEST_CASE("crc16_ccitt_t check value", "[codec][crc]") {
+    const char* text = "123456789";
+    const auto* data = reinterpret_cast<const vdl::byte_t*>(text);
+
+    // CRC-16/CCITT-FALSE 标准校验值
+    REQUIRE(vdl::crc16_ccitt_t::compute(data, 9) == 0x29B1);
+    REQUIRE(vdl::crc16_ccitt_t::compute_bitwise(data, 9) == 0x29B1);
+    REQUIRE(vdl::crc16_ccitt_t::compute(data, 0) == 0xFFFF);
+}
+
+TEST_CASE("crc16_ccitt_t matches bitwise reference", "[codec][crc]") {
+    vdl::bytes_t data(1029);
+    uint32_t seed = 12345;
+    for (auto& b : data) {
+        seed = seed * 1103515245u + 12345u;
+        b = static_cast<vdl::byte_t>(seed >> 16);
+    }
+
+    for (size_t len = 0; len <= 40; ++len) {
+        REQUIRE(vdl::crc16_ccitt_t::compute(data.data(), len) ==
+                vdl::crc16_ccitt_t::compute_bitwise(data.data(), len));
+    }
+    REQUIRE(vdl::crc16_ccitt_t::compute(data.data(), data.size()) ==
+            vdl::crc16_ccitt_t::compute_bitwise(data.data(), data.size()));
+}
+
+TEST_CASE("crc16_ccitt_t incremental update", "[codec][crc]") {
+    vdl::bytes_t data(100);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<vdl::byte_t>(i * 7 + 3);
+    }
+    const uint16_t expected = vdl::crc16_ccitt_t::compute(data.data(), data.size());
+
+    vdl::crc16_ccitt_t crc;
+    crc.update(data.data(), 3);
+    crc.update(data[3]);
+    crc.update(vdl::const_byte_span_t(data.data() + 4, 50));
+    crc.update(data.data() + 54, data.size() - 54);
+    REQUIRE(crc.value() == expected);
+
+    crc.reset();
+    REQUIRE(crc.value() == 0xFFFF);
+    REQUIRE(vdl::binary_frame::crc16(data.data(), data.size()) == expected);
+}
+
+// ============================================================================
+// binary_codec_t decode_all 测试
+// ============================================================================
+
+namespace {
+
+vdl::bytes_t make_binary_frame(vdl::uint8_t fc, const vdl::bytes_t& data) {
+    vdl::binary_codec_t codec;
+    vdl::command_t cmd;
+    cmd.set_function_code(fc).set_data(data);
+    return *codec.encode(cmd);
+}
+
+}  // namespace
+
+TEST_CASE("binary_codec_t decode_all extracts every frame", "[codec][binary]") {
+    vdl::binary_codec_t codec;
+
+    vdl::bytes_t stream;
+    for (vdl::uint8_t fc = 1; fc <= 3; ++fc) {
+        auto frame = make_binary_frame(fc, {fc, 0xAA});
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+
+    std::vector<vdl::uint8_t> codes;
+    size_t consumed = codec.decode_all(vdl::const_byte_span_t(stream.data(), stream.size()),
+                                       [&](vdl::response_t& resp) {
+                                           codes.push_back(resp.function_code());
+                                       });
+
+    REQUIRE(consumed == stream.size());
+    REQUIRE(codes == std::vector<vdl::uint8_t>({1, 2, 3}));
+}
+
+TEST_CASE("binary_codec_t decode_all skips noise with stray SOF", "[codec][binary]") {
+    vdl::binary_codec_t codec;
+
+    // 噪声中的 0xAA 声明了一个很长的帧，但其后存在校验通过的真实帧
+    vdl::bytes_t stream = {0x00, 0x13, 0xAA, 0x40, 0x00, 0x01, 0x37, 0xAA, 0x02, 0x00};
+    auto frame1 = make_binary_frame(0x05, {0x10, 0x20});
+    stream.insert(stream.end(), frame1.begin(), frame1.end());
+    stream.insert(stream.end(), {0x55, 0xAA, 0x01});  // 噪声
+    auto frame2 = make_binary_frame(0x06, {});
+    stream.insert(stream.end(), frame2.begin(), frame2.end());
+
+    std::vector<vdl::uint8_t> codes;
+    size_t consumed = codec.decode_all(vdl::const_byte_span_t(stream.data(), stream.size()),
+                                       [&](vdl::response_t& resp) {
+                                           codes.push_back(resp.function_code());
+                                       });
+
+    REQUIRE(consumed == stream.size());
+    REQUIRE(codes == std::vector<vdl::uint8_t>({0x05, 0x06}));
+}
+
+TEST_CASE("binary_codec_t decode_all keeps trailing partial frame", "[codec][binary]") {
+    vdl::binary_codec_t codec;
+
+    auto frame1 = make_binary_frame(0x01, {0x01});
+    auto frame2 = make_binary_frame(0x02, {0x02, 0x03, 0x04});
+
+    vdl::bytes_t stream = {0x99, 0x98};
+    stream.insert(stream.end(), frame1.begin(), frame1.end());
+    stream.insert(stream.end(), frame2.begin(), frame2.begin() + 5);
+
+    size_t frames = 0;
+    size_t consumed = codec.decode_all(vdl::const_byte_span_t(stream.data(), stream.size()),
+                                       [&](vdl::response_t&) { ++frames; });
+
+    REQUIRE(frames == 1);
+    REQUIRE(consumed == 2 + frame1.size());
+
+    // 纯噪声全部被消耗
+    vdl::bytes_t noise = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+    REQUIRE(codec.decode_all(vdl::const_byte_span_t(noise.data(), noise.size()), nullptr) ==
+            noise.size());
+}
+
+// ============================================================================
+// Modbus 编解码器测试
+// ============================================================================
+
+namespace {
+
+vdl::bytes_t with_modbus_crc(vdl::bytes_t frame) {
+    const vdl::uint16_t crc = vdl::crc16_modbus_t::compute(frame.data(), frame.size());
+    frame.push_back(static_cast<vdl::byte_t>(crc & 0xFF));
+    frame.push_back(static_cast<vdl::byte_t>(crc >> 8));
+    return frame;
+}
+
+}  // namespace
+
+TEST_CASE("crc16_modbus_t check value", "[codec][crc][modbus]") {
+    const vdl::byte_t data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    REQUIRE(vdl::crc16_modbus_t::compute(data, 9) == 0x4B37);
+    REQUIRE(vdl::crc16_modbus_t::compute_bitwise(data, 9) == 0x4B37);
+
+    vdl::crc16_modbus_t crc;
+    crc.update(data, 4).update(data + 4, 5);
+    REQUIRE(crc.value() == 0x4B37);
+}
+
+TEST_CASE("modbus_rtu_codec_t encodes read and write requests", "[codec][modbus]") {
+    vdl::modbus_rtu_codec_t codec(0x01);
+
+    auto read = codec.encode(vdl::make_read_command(vdl::modbus::read_holding_registers, 0x0000, 10));
+    REQUIRE(read.has_value());
+    REQUIRE(*read == vdl::bytes_t({0x01, 0x03, 0x00, 0x00, 0x00, 0x0A, 0xC5, 0xCD}));
+
+    // 分段编码与整帧编码一致
+    auto write = vdl::make_write_command(vdl::modbus::write_multiple_registers, 0x0010,
+                                         {0x00, 0x0A, 0x01, 0x02});
+    auto whole = codec.encode(write);
+    REQUIRE(whole.has_value());
+    REQUIRE(*whole == with_modbus_crc({0x01, 0x10, 0x00, 0x10, 0x00, 0x02, 0x04,
+                                       0x00, 0x0A, 0x01, 0x02}));
+    vdl::frame_parts_t parts;
+    REQUIRE(codec.encode_parts(write, parts).has_value());
+    vdl::bytes_t joined(parts.header.data(), parts.header.data() + parts.header.size());
+    joined.insert(joined.end(), parts.payload.begin(), parts.payload.end());
+    joined.insert(joined.end(), parts.trailer.data(), parts.trailer.data() + parts.trailer.size());
+    REQUIRE(joined == *whole);
+
+    // 字段不合法
+    REQUIRE_FALSE(codec.encode(vdl::make_read_command(0x03, 0, 0)).has_value());
+    REQUIRE_FALSE(codec.encode(vdl::make_write_command(0x06, 0, {0x01})).has_value());
+}
+
+TEST_CASE("modbus_rtu_codec_t decodes responses", "[codec][modbus]") {
+    vdl::modbus_rtu_codec_t codec;
+
+    const vdl::bytes_t frame = with_modbus_crc({0x01, 0x03, 0x04, 0x00, 0x0A, 0x01, 0x02});
+    const vdl::const_byte_span_t span(frame.data(), frame.size());
+    REQUIRE(codec.frame_length(span.first(2)) == 0);
+    REQUIRE(codec.frame_length(span.first(3)) == frame.size());
+
+    size_t consumed = 0;
+    REQUIRE(codec.decode(span.first(5), consumed).error().code() ==
+            vdl::error_code_t::incomplete_frame);
+
+    vdl::byte_slice_t slab{vdl::bytes_t(frame)};
+    auto resp = codec.decode_slice(slab, consumed);
+    REQUIRE(resp.has_value());
+    REQUIRE(consumed == frame.size());
+    REQUIRE(resp->is_success());
+    REQUIRE(resp->function_code() == 0x03);
+    REQUIRE(resp->get_uint16_be(0) == 0x000A);
+    REQUIRE(resp->get_uint16_be(2) == 0x0102);
+    REQUIRE(resp->data_view().data() == slab.data() + 3);
+
+    // 异常响应
+    const vdl::bytes_t exception = with_modbus_crc({0x01, 0x83, 0x02});
+    auto failed = codec.decode(vdl::const_byte_span_t(exception.data(), exception.size()), consumed);
+    REQUIRE(failed.has_value());
+    REQUIRE(failed->is_error());
+    REQUIRE(failed->function_code() == 0x03);
+    REQUIRE(failed->error_code() == 0x02);
+
+    // 写单个寄存器的回显
+    const vdl::bytes_t echo = with_modbus_crc({0x01, 0x06, 0x00, 0x01, 0x00, 0x03});
+    auto written = codec.decode(vdl::const_byte_span_t(echo.data(), echo.size()), consumed);
+    REQUIRE(written.has_value());
+    REQUIRE(written->data_size() == 4);
+
+    // CRC 错误时只跳过一个字节
+    vdl::bytes_t corrupted = frame;
+    corrupted[4] ^= 0xFF;
+    auto bad = codec.decode(vdl::const_byte_span_t(corrupted.data(), corrupted.size()), consumed);
+    REQUIRE(bad.error().code() == vdl::error_code_t::checksum_error);
+    REQUIRE(consumed == 1);
+}
+
+TEST_CASE("modbus_tcp_codec_t numbers transactions", "[codec][modbus]") {
+    vdl::modbus_tcp_codec_t codec(0x11);
+
+    auto cmd = vdl::make_read_command(vdl::modbus::read_input_registers, 0x0100, 2);
+    auto first = codec.encode(cmd);
+    auto second = codec.encode(cmd);
+    REQUIRE(first.has_value());
+    REQUIRE(second.has_value());
+    REQUIRE(*first == vdl::bytes_t({0x00, 0x01, 0x00, 0x00, 0x00, 0x06, 0x11,
+                                    0x04, 0x01, 0x00, 0x00, 0x02}));
+    REQUIRE((*second)[1] == 0x02);
+    REQUIRE(codec.next_transaction_id() == 3);
+
+    auto key = codec.correlation_key(vdl::const_byte_span_t(second->data(), second->size()));
+    REQUIRE(key.has_value());
+    REQUIRE(*key == 2);
+
+    const vdl::bytes_t reply = {0x00, 0x02, 0x00, 0x00, 0x00, 0x07, 0x11,
+                                0x04, 0x04, 0x12, 0x34, 0x56, 0x78};
+    const vdl::const_byte_span_t span(reply.data(), reply.size());
+    REQUIRE(codec.frame_length(span.first(5)) == 0);
+    REQUIRE(codec.frame_length(span) == reply.size());
+
+    size_t consumed = 0;
+    auto resp = codec.decode(span, consumed);
+    REQUIRE(resp.has_value());
+    REQUIRE(consumed == reply.size());
+    REQUIRE(resp->get_uint32_be(0) == 0x12345678);
+    REQUIRE(resp->raw_view().size() == reply.size());
+
+    // 协议号不为 0 的帧被丢弃
+    vdl::bytes_t bogus = reply;
+    bogus[3] = 0x01;
+    auto bad = codec.decode(vdl::const_byte_span_t(bogus.data(), bogus.size()), consumed);
+    REQUIRE(bad.error().code() == vdl::error_code_t::invalid_frame);
+    REQUIRE(consumed == bogus.size());
+}
+
+// ============================================================================
+// 编译期帧格式测试
+// ============================================================================
+
+namespace {
+
+// 与 binary_codec_t 相同的帧格式
+typedef vdl::layout::frame_layout_t<
+    vdl::layout::marker_t<0xAA>,
+    vdl::layout::length_t<2>,
+    vdl::layout::function_t,
+    vdl::layout::payload_t,
+    vdl::layout::checksum_t<vdl::layout::crc16_ccitt_policy_t>
+> binary_layout_t;
+
+// STX | LEN(BE16, 含功能码) | FUNC | DATA | SUM8(不含 STX) | ETX
+typedef vdl::layout::frame_layout_t<
+    vdl::layout::marker_t<0x02>,
+    vdl::layout::length_t<2, vdl::byte_order_t::big, 1>,
+    vdl::layout::function_t,
+    vdl::layout::payload_t,
+    vdl::layout::checksum_t<vdl::layout::sum8_policy_t, vdl::byte_order_t::little, 1>,
+    vdl::layout::marker_t<0x03>
+> stx_layout_t;
+
+static_assert(binary_layout_t::header_size == 4, "binary header");
+static_assert(binary_layout_t::trailer_size == 2, "binary trailer");
+static_assert(stx_layout_t::fixed_size == 6, "stx fixed size");
+static_assert(stx_layout_t::max_payload_size() == 0xFFFE, "stx payload range");
+
+}  // namespace
+
+TEST_CASE("layout_codec_t matches binary_codec_t byte for byte", "[codec][layout]") {
+    vdl::binary_codec_t reference;
+    vdl::layout_codec_t<binary_layout_t> codec("binary_layout");
+    REQUIRE(std::string(codec.name()) == "binary_layout");
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x03).set_data({0x00, 0x01, 0x00, 0x0A, 0x55});
+
+    auto expected = reference.encode(cmd);
+    auto actual = codec.encode(cmd);
+    REQUIRE(actual.has_value());
+    REQUIRE(*actual == *expected);
+
+    vdl::frame_parts_t parts;
+    REQUIRE(codec.encode_parts(cmd, parts).has_value());
+    vdl::bytes_t joined(parts.header.data(), parts.header.data() + parts.header.size());
+    joined.insert(joined.end(), parts.payload.begin(), parts.payload.end());
+    joined.insert(joined.end(), parts.trailer.data(), parts.trailer.data() + parts.trailer.size());
+    REQUIRE(joined == *expected);
+
+    // 解码 binary_codec_t 生成的帧
+    vdl::bytes_t stream = {0x11, 0x22};
+    stream.insert(stream.end(), expected->begin(), expected->end());
+    const vdl::const_byte_span_t span(stream.data(), stream.size());
+
+    size_t consumed = 0;
+    auto skipped = codec.decode(span, consumed);
+    REQUIRE(skipped.error().code() == vdl::error_code_t::invalid_frame);
+    REQUIRE(consumed == 2);
+
+    const vdl::const_byte_span_t frame = span.subspan(2);
+    REQUIRE(codec.frame_length(frame.first(3)) == 0);
+    REQUIRE(codec.frame_length(frame) == expected->size());
+
+    auto resp = codec.decode(frame, consumed);
+    REQUIRE(resp.has_value());
+    REQUIRE(consumed == expected->size());
+    REQUIRE(resp->function_code() == 0x03);
+    REQUIRE(resp->data_size() == 5);
+    REQUIRE(resp->get_byte(4) == 0x55);
+}
+
+TEST_CASE("frame_layout_t handles big-endian length, bias and end markers", "[codec][layout]") {
+    vdl::layout_codec_t<stx_layout_t> codec;
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x10).set_data({0x01, 0x02});
+    auto frame = codec.encode(cmd);
+    REQUIRE(frame.has_value());
+    const vdl::byte_t sum = static_cast<vdl::byte_t>(0x00 + 0x03 + 0x10 + 0x01 + 0x02);
+    REQUIRE(*frame == vdl::bytes_t({0x02, 0x00, 0x03, 0x10, 0x01, 0x02, sum, 0x03}));
+
+    size_t consumed = 0;
+    const vdl::const_byte_span_t span(frame->data(), frame->size());
+    REQUIRE(codec.frame_length(span) == 8);
+
+    // 切片模式共享 slab
+    vdl::byte_slice_t slab{vdl::bytes_t(*frame)};
+    auto resp = codec.decode_slice(slab, consumed);
+    REQUIRE(resp.has_value());
+    REQUIRE(resp->function_code() == 0x10);
+    REQUIRE(resp->data_view().data() == slab.data() + 4);
+
+    SECTION("incomplete") {
+        REQUIRE(codec.decode(span.first(7), consumed).error().code() ==
+                vdl::error_code_t::incomplete_frame);
+        REQUIRE(consumed == 0);
+    }
+
+    SECTION("bad checksum") {
+        vdl::bytes_t bad = *frame;
+        bad[4] ^= 0x01;
+        auto result = codec.decode(vdl::const_byte_span_t(bad.data(), bad.size()), consumed);
+        REQUIRE(result.error().code() == vdl::error_code_t::checksum_error);
+        REQUIRE(consumed == 1);
+    }
+
+    SECTION("bad end marker") {
+        vdl::bytes_t bad = *frame;
+        bad[7] = 0x04;
+        auto result = codec.decode(vdl::const_byte_span_t(bad.data(), bad.size()), consumed);
+        REQUIRE(result.error().code() == vdl::error_code_t::invalid_frame);
+        REQUIRE(consumed == 1);
+    }
+
+    SECTION("length below bias") {
+        const vdl::bytes_t bad = {0x02, 0x00, 0x00, 0x10, 0x00, 0x03};
+        auto result = codec.decode(vdl::const_byte_span_t(bad.data(), bad.size()), consumed);
+        REQUIRE(result.error().code() == vdl::error_code_t::invalid_frame);
+        REQUIRE(consumed == 1);
+    }
+}
+
+TEST_CASE("frame_layout_t rejects payloads beyond the length field", "[codec][layout]") {
+    typedef vdl::layout::frame_layout_t<
+        vdl::layout::length_t<1>,
+        vdl::layout::payload_t,
+        vdl::layout::checksum_t<vdl::layout::xor8_policy_t>
+    > short_layout_t;
+
+    vdl::command_t cmd;
+    cmd.set_data(vdl::bytes_t(256, 0x01));
+    vdl::bytes_t out(300);
+    auto result = short_layout_t::encode_into(cmd, vdl::byte_span_t(out.data(), out.size()));
+    REQUIRE(result.error().code() == vdl::error_code_t::frame_too_large);
+
+    cmd.set_data({0x0F, 0xF0});
+    result = short_layout_t::encode_into(cmd, vdl::byte_span_t(out.data(), out.size()));
+    REQUIRE(result.value() == 4);
+    REQUIRE(out[0] == 0x02);
+    REQUIRE(out[3] == static_cast<vdl::byte_t>(0x02 ^ 0x0F ^ 0xF0));
+}
+
+// ============================================================================
+// ascii_codec_t 测试
+// ============================================================================
+
+TEST_CASE("ascii_codec_t appends the terminator once", "[codec][ascii]") {
+    vdl::ascii_codec_t codec;
+
+    auto frame = codec.encode(vdl::make_ascii_command("*IDN?"));
+    REQUIRE(frame.has_value());
+    REQUIRE(std::string(frame->begin(), frame->end()) == "*IDN?\n");
+
+    frame = codec.encode(vdl::make_ascii_command("*RST\n"));
+    REQUIRE(frame.has_value());
+    REQUIRE(std::string(frame->begin(), frame->end()) == "*RST\n");
+
+    vdl::frame_parts_t parts;
+    REQUIRE(codec.encode_parts(vdl::make_ascii_command("MEAS?"), parts).has_value());
+    REQUIRE(parts.header.size() == 0);
+    REQUIRE(parts.payload.size() == 5);
+    REQUIRE(parts.trailer.size() == 1);
+    REQUIRE(parts.trailer.data()[0] == '\n');
+}
+
+TEST_CASE("ascii_codec_t frames lines and strips the terminator", "[codec][ascii]") {
+    vdl::ascii_codec_t codec;
+    const std::string stream = "1.25\r\n+3";
+    const vdl::const_byte_span_t buffer(reinterpret_cast<const vdl::byte_t*>(stream.data()),
+                                        stream.size());
+
+    REQUIRE(codec.frame_length(buffer) == 6);
+    REQUIRE(codec.frame_length(buffer.subspan(6)) == 0);
+
+    size_t consumed = 0;
+    auto response = codec.decode(buffer, consumed);
+    REQUIRE(response.has_value());
+    REQUIRE(consumed == 6);
+    REQUIRE(vdl::response_text(*response) == "1.25");
+
+    response = codec.decode(buffer.subspan(6), consumed);
+    REQUIRE(response.error().code() == vdl::error_code_t::incomplete_frame);
+    REQUIRE(consumed == 0);
+}
+
+TEST_CASE("ascii_codec_t skips definite-length blocks", "[codec][ascii]") {
+    vdl::ascii_codec_t codec;
+    std::string stream = "#14\n\n\x01\x02\nNEXT\n";
+    const vdl::const_byte_span_t buffer(reinterpret_cast<const vdl::byte_t*>(stream.data()),
+                                        stream.size());
+
+    REQUIRE(codec.frame_length(buffer) == 8);
+    REQUIRE(codec.frame_length(buffer.first(6)) == 0);
+
+    size_t consumed = 0;
+    auto response = codec.decode(buffer, consumed);
+    REQUIRE(response.has_value());
+    REQUIRE(consumed == 8);
+    REQUIRE(response->data_view().size() == 7);
+
+    // 字段中间的 '#' 是普通文本
+    const std::string text = "A#12\n";
+    REQUIRE(codec.frame_length(vdl::const_byte_span_t(
+        reinterpret_cast<const vdl::byte_t*>(text.data()), text.size())) == 5);
+}
+
+TEST_CASE("ascii_codec_t supports multi-byte terminators", "[codec][ascii]") {
+    vdl::ascii_codec_t codec("\r\n");
+    auto frame = codec.encode(vdl::make_ascii_command("VOLT?"));
+    REQUIRE(frame.has_value());
+    REQUIRE(std::string(frame->begin(), frame->end()) == "VOLT?\r\n");
+
+    const std::string stream = "A\nB\r\n";
+    const vdl::const_byte_span_t buffer(reinterpret_cast<const vdl::byte_t*>(stream.data()),
+                                        stream.size());
+    REQUIRE(codec.frame_length(buffer) == 5);
+
+    size_t consumed = 0;
+    auto response = codec.decode(buffer, consumed);
+    REQUIRE(response.has_value());
+    REQUIRE(vdl::response_text(*response) == "A\nB");
+}
+
+// ============================================================================
+// 流解码器测试
+// ============================================================================
+
+namespace {
+
+vdl::bytes_t encode_binary_frame(vdl::byte_t function_code, const vdl::bytes_t& data) {
+    vdl::binary_codec_t codec;
+    vdl::command_t cmd;
+    cmd.set_function_code(function_code);
+    cmd.set_data(data);
+    return codec.encode(cmd).value();
+}
+
+}  // namespace
+
+TEST_CASE("binary_stream_decoder_t assembles frames fed byte by byte", "[codec][stream]") {
+    vdl::binary_codec_t codec;
+    auto decoder = codec.make_stream_decoder();
+
+    vdl::bytes_t payload(3000);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<vdl::byte_t>(i * 7);
+    }
+    vdl::bytes_t stream = encode_binary_frame(0x03, payload);
+    const vdl::bytes_t second = encode_binary_frame(0x04, {0x01});
+    stream.insert(stream.end(), second.begin(), second.end());
+
+    std::vector<vdl::response_t> frames;
+    auto collect = [&frames](vdl::response_t& resp) { frames.push_back(resp); };
+    for (size_t i = 0; i + 1 < stream.size(); ++i) {
+        decoder->feed(vdl::const_byte_span_t(&stream[i], 1), collect);
+    }
+    REQUIRE(frames.size() == 1);
+    REQUIRE(decoder->buffered() == second.size() - 1);
+
+    REQUIRE(decoder->feed(vdl::const_byte_span_t(&stream.back(), 1), collect) == 1);
+    REQUIRE(frames.size() == 2);
+    REQUIRE(frames[0].function_code() == 0x03);
+    REQUIRE(frames[0].data_view().size() == payload.size());
+    REQUIRE(std::equal(payload.begin(), payload.end(), frames[0].data_view().data()));
+    REQUIRE(frames[1].function_code() == 0x04);
+    REQUIRE(decoder->buffered() == 0);
+    REQUIRE(decoder->discarded() == 0);
+}
+
+TEST_CASE("binary_stream_decoder_t resynchronises after noise and bad CRC", "[codec][stream]") {
+    vdl::binary_codec_t codec;
+    codec.set_max_frame_size(256);
+    auto decoder = codec.make_stream_decoder();
+
+    const vdl::bytes_t good = encode_binary_frame(0x03, {0x10, 0x20});
+    vdl::bytes_t corrupt = encode_binary_frame(0x05, {0x01, 0x02});
+    corrupt.back() ^= 0xFF;
+
+    // 噪声、长度超限的伪 SOF、CRC 错误的帧，之后是正常帧
+    vdl::bytes_t stream = {0x00, 0x11, 0xAA, 0xFF, 0xFF, 0x01};
+    stream.insert(stream.end(), corrupt.begin(), corrupt.end());
+    stream.insert(stream.end(), good.begin(), good.end());
+
+    size_t count = 0;
+    vdl::byte_t function_code = 0;
+    const size_t frames = decoder->feed(vdl::const_byte_span_t(stream.data(), stream.size()),
+        [&](vdl::response_t& resp) {
+            ++count;
+            function_code = resp.function_code();
+        });
+    REQUIRE(frames == 1);
+    REQUIRE(count == 1);
+    REQUIRE(function_code == 0x03);
+    REQUIRE(decoder->discarded() == 6 + corrupt.size());
+    REQUIRE(decoder->buffered() == 0);
+}
+
+TEST_CASE("codec_stream_decoder_t wraps stateless codecs", "[codec][stream]") {
+    vdl::ascii_codec_t codec;
+    auto decoder = codec.make_stream_decoder();
+
+    std::vector<std::string> lines;
+    auto collect = [&lines](vdl::response_t& resp) { lines.push_back(vdl::response_text(resp)); };
+    const std::string first = "+1.5\r\n+2.";
+    const std::string second = "5\n#13\n\nA\n";
+
+    REQUIRE(decoder->feed(vdl::const_byte_span_t(
+        reinterpret_cast<const vdl::byte_t*>(first.data()), first.size()), collect) == 1);
+    REQUIRE(decoder->buffered() == 3);
+    REQUIRE(decoder->feed(vdl::const_byte_span_t(
+        reinterpret_cast<const vdl::byte_t*>(second.data()), second.size()), collect) == 2);
+    REQUIRE(lines.size() == 3);
+    REQUIRE(lines[0] == "+1.5");
+    REQUIRE(lines[1] == "+2.5");
+    REQUIRE(lines[2] == "#13\n\nA");
+    REQUIRE(decoder->buffered() == 0);
+}
+
+TEST_CASE("codec_stream_decoder_t waits for the announced frame length", "[codec][stream]") {
+    vdl::modbus_rtu_codec_t codec;
+    vdl::codec_stream_decoder_t decoder(codec);
+
+    // 从站 1，功能码 3，2 个寄存器
+    vdl::bytes_t frame = {0x01, 0x03, 0x04, 0x00, 0x0A, 0x01, 0x02};
+    const uint16_t crc = vdl::crc16_modbus_t::compute(frame.data(), frame.size());
+    frame.push_back(static_cast<vdl::byte_t>(crc & 0xFF));
+    frame.push_back(static_cast<vdl::byte_t>(crc >> 8));
+
+    size_t count = 0;
+    auto collect = [&count](vdl::response_t&) { ++count; };
+    REQUIRE(decoder.feed(vdl::const_byte_span_t(frame.data(), 4), collect) == 0);
+    REQUIRE(decoder.feed(vdl::const_byte_span_t(frame.data() + 4, 3), collect) == 0);
+    REQUIRE(decoder.feed(vdl::const_byte_span_t(frame.data() + 7, 2), collect) == 1);
+    REQUIRE(count == 1);
+    REQUIRE(decoder.buffered() == 0);
+}
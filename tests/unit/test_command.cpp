@@ -29,7 +29,7 @@ TEST_CASE("command_t builder pattern", "[protocol][command]") {
        .set_address(0x0100)
        .set_count(1)
        .set_data({0x12, 0x34})
-       .set_tag("test_cmd");
+       .set_tag(vdl::tag_t("test_cmd"));
 
     REQUIRE(cmd.type() == vdl::command_type_t::write);
     REQUIRE(cmd.function_code() == 0x06);
@@ -86,7 +86,7 @@ TEST_CASE("command_t clear", "[protocol][command]") {
        .set_function_code(0xFF)
        .set_address(0x1234)
        .set_data({0x01, 0x02})
-       .set_tag("test");
+       .set_tag(vdl::tag_t("test"));
 
     cmd.clear();
 
@@ -127,6 +127,36 @@ TEST_CASE("make_execute_command", "[protocol][command]") {
     REQUIRE(cmd.function_code() == 0x08);
 }
 
+TEST_CASE("command_t keeps short payloads inline", "[protocol][command]") {
+    vdl::command_t cmd;
+    cmd.set_data({0x01, 0x02, 0x03, 0x04});
+    REQUIRE(cmd.data().is_inline());
+
+    vdl::command_t copy = cmd;
+    REQUIRE(copy.data().is_inline());
+    REQUIRE(copy.data() == vdl::bytes_t({0x01, 0x02, 0x03, 0x04}));
+
+    cmd.set_data(vdl::bytes_t(100, 0xAA));
+    REQUIRE_FALSE(cmd.data().is_inline());
+    REQUIRE(cmd.data().size() == 100);
+}
+
+TEST_CASE("command_t tags are interned", "[protocol][command]") {
+    vdl::command_t a;
+    vdl::command_t b;
+    a.set_tag(vdl::tag_t("poll"));
+    b.set_tag(vdl::tag_t(std::string("poll")));
+
+    REQUIRE(a.tag() == b.tag());
+    REQUIRE(a.tag().c_str() == b.tag().c_str());
+    REQUIRE(a.tag() == "poll");
+    REQUIRE(a.tag() != std::string("other"));
+
+    const vdl::tag_t empty("");
+    REQUIRE(empty.empty());
+    REQUIRE(std::string(empty.c_str()).empty());
+}
+
 // ============================================================================
 // command_type_t 测试
 // ============================================================================
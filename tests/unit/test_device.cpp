@@ -4,11 +4,34 @@
  */
 
 #include <catch.hpp>
+#include <vdl/device/command_priority.hpp>
 #include <vdl/device/device.hpp>
 #include <vdl/device/device_impl.hpp>
+#include <vdl/device/device_group.hpp>
 #include <vdl/device/device_guard.hpp>
+#include <vdl/device/identity_cache.hpp>
+#include <vdl/device/device_pool.hpp>
+#include <vdl/device/read_planner.hpp>
+#include <vdl/device/scpi_adapter.hpp>
+#include <vdl/device/trace_file.hpp>
 #include <vdl/transport/mock_transport.hpp>
+#include <vdl/transport/sim_transport.hpp>
+#include <vdl/codec/ascii_codec.hpp>
 #include <vdl/codec/binary_codec.hpp>
+#include <vdl/codec/modbus_codec.hpp>
+#include <vdl/heartbeat/strategies/ping_heartbeat.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 // ============================================================================
 // device_state_t 测试
@@ -229,6 +252,134 @@ TEST_CASE("make_device_guard factory function", "[device][guard]") {
     REQUIRE_FALSE(device.is_connected());
 }
 
+// ============================================================================
+// device_pool_t 测试
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief 创建基于 mock 传输层的设备，并统计创建次数
+ */
+vdl::device_factory_t make_mock_factory(std::atomic<int>& created, bool respond = true) {
+    return [&created, respond](const std::string&) -> vdl::result_t<vdl::device_ptr_t> {
+        ++created;
+        auto transport = vdl::make_unique<vdl::mock_transport_t>();
+        if (respond) {
+            vdl::command_t ping;
+            ping.set_function_code(0x00);
+            vdl::binary_codec_t codec_helper;
+            transport->enable_auto_response(*codec_helper.encode(ping));
+        }
+        vdl::device_ptr_t device(new vdl::device_impl_t(std::move(transport),
+                                                        vdl::make_unique<vdl::binary_codec_t>()));
+        vdl::device_config_t cfg;
+        cfg.max_retries = 1;
+        device->set_config(cfg);
+        return device;
+    };
+}
+
+}  // namespace
+
+TEST_CASE("device_pool_t keeps sessions warm", "[device][pool]") {
+    std::atomic<int> created{0};
+    vdl::device_pool_t pool(make_mock_factory(created));
+
+    const vdl::i_device_t* first = nullptr;
+    {
+        auto lease = pool.acquire("mock::1");
+        REQUIRE(lease.has_value());
+        REQUIRE(lease->is_connected());
+        first = &lease->device();
+    }
+    REQUIRE(pool.idle_count("mock::1") == 1);
+
+    // 归还后连接保持打开，再次借出无需重新创建
+    auto again = pool.acquire("mock::1");
+    REQUIRE(again.has_value());
+    REQUIRE(&again->device() == first);
+    REQUIRE(again->is_connected());
+    REQUIRE(created.load() == 1);
+
+    auto other = pool.acquire("mock::2");
+    REQUIRE(other.has_value());
+    REQUIRE(created.load() == 2);
+}
+
+TEST_CASE("device_pool_t caps sessions per resource", "[device][pool]") {
+    std::atomic<int> created{0};
+    vdl::device_pool_config_t cfg;
+    cfg.max_sessions_per_resource = 1;
+    vdl::device_pool_t pool(make_mock_factory(created), nullptr, cfg);
+
+    auto held = pool.acquire("mock::1");
+    REQUIRE(held.has_value());
+
+    auto busy = pool.acquire("mock::1", 20);
+    REQUIRE_FALSE(busy.has_value());
+    REQUIRE(busy.error().code() == vdl::error_code_t::timeout);
+
+    // 另一线程归还后等待者拿到同一会话
+    std::thread releaser([&held] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        held->release();
+    });
+    auto waited = pool.acquire("mock::1", 1000);
+    releaser.join();
+    REQUIRE(waited.has_value());
+    REQUIRE(created.load() == 1);
+    REQUIRE(pool.session_count("mock::1") == 1);
+}
+
+TEST_CASE("device_pool_t health checks idle sessions", "[device][pool]") {
+    vdl::device_pool_config_t cfg;
+    cfg.health_check_interval = 0;   // 每次借出前都检查
+    cfg.health_check_timeout = 20;
+    auto ping = [](const std::string&) -> vdl::heartbeat_strategy_ptr_t {
+        return vdl::make_unique<vdl::ping_heartbeat_t>();
+    };
+
+    SECTION("healthy session is reused") {
+        std::atomic<int> created{0};
+        vdl::device_pool_t pool(make_mock_factory(created), ping, cfg);
+        { auto lease = pool.acquire("mock::1"); REQUIRE(lease.has_value()); }
+        { auto lease = pool.acquire("mock::1"); REQUIRE(lease.has_value()); }
+        REQUIRE(created.load() == 1);
+    }
+
+    SECTION("unresponsive session is replaced") {
+        std::atomic<int> created{0};
+        vdl::device_pool_t pool(make_mock_factory(created, /*respond=*/false), ping, cfg);
+        { auto lease = pool.acquire("mock::1"); REQUIRE(lease.has_value()); }
+        auto lease = pool.acquire("mock::1");
+        REQUIRE(lease.has_value());
+        REQUIRE(created.load() == 2);
+        REQUIRE(pool.session_count("mock::1") == 1);
+    }
+}
+
+TEST_CASE("device_pool_t evicts idle and invalidated sessions", "[device][pool]") {
+    std::atomic<int> created{0};
+    vdl::device_pool_config_t cfg;
+    cfg.idle_timeout = 1;
+    vdl::device_pool_t pool(make_mock_factory(created), nullptr, cfg);
+
+    { auto lease = pool.acquire("mock::1"); REQUIRE(lease.has_value()); }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    REQUIRE(pool.evict_idle() == 1);
+    REQUIRE(pool.session_count("mock::1") == 0);
+
+    {
+        auto lease = pool.acquire("mock::1");
+        REQUIRE(lease.has_value());
+        lease->invalidate();
+    }
+    REQUIRE(pool.idle_count("mock::1") == 0);
+    REQUIRE(pool.session_count("mock::1") == 0);
+    REQUIRE(created.load() == 2);
+}
+
 // ============================================================================
 // 重试机制测试
 // ============================================================================
@@ -468,3 +619,2395 @@ TEST_CASE("device_impl manual reconnect", "[device][reconnect]") {
     REQUIRE(device.is_connected());
     REQUIRE(transport_ptr->open_count() == 2u);
 }
+
+// ============================================================================
+// 后台重连与熔断器测试
+// ============================================================================
+
+namespace {
+
+bool wait_reconnect_done(vdl::device_impl_t& device, int timeout_ms = 2000) {
+    const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (device.reconnecting()) {
+        if (std::chrono::steady_clock::now() >= until) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST_CASE("circuit_breaker_t opens and half-opens", "[device][reconnect][breaker]") {
+    vdl::circuit_breaker_config_t cfg;
+    cfg.failure_threshold = 2;
+    cfg.open_duration = 30;
+    vdl::circuit_breaker_t breaker(cfg);
+
+    REQUIRE(breaker.allow());
+    breaker.record_failure();
+    REQUIRE(breaker.state() == vdl::circuit_state_t::closed);
+    REQUIRE(breaker.allow());
+    breaker.record_failure();
+    REQUIRE(breaker.state() == vdl::circuit_state_t::open);
+    REQUIRE_FALSE(breaker.allow());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    REQUIRE(breaker.allow());
+    REQUIRE(breaker.state() == vdl::circuit_state_t::half_open);
+    REQUIRE_FALSE(breaker.allow());  // 只放行一次试探
+
+    breaker.record_failure();
+    REQUIRE(breaker.state() == vdl::circuit_state_t::open);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    REQUIRE(breaker.allow());
+    breaker.record_success();
+    REQUIRE(breaker.state() == vdl::circuit_state_t::closed);
+    REQUIRE(breaker.failure_count() == 0u);
+
+    SECTION("threshold 0 disables the breaker") {
+        cfg.failure_threshold = 0;
+        breaker.set_config(cfg);
+        for (int i = 0; i < 5; ++i) {
+            breaker.record_failure();
+        }
+        REQUIRE(breaker.allow());
+        REQUIRE(breaker.state() == vdl::circuit_state_t::closed);
+    }
+}
+
+TEST_CASE("device_impl background reconnect fails fast", "[device][reconnect]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+
+    vdl::device_config_t cfg;
+    cfg.max_retries = 2;
+    cfg.retry_delay = 0;
+    cfg.reconnect_delay = 100;
+    cfg.background_reconnect = true;
+    device.set_config(cfg);
+
+    std::vector<vdl::reconnect_event_t> events;
+    device.set_reconnect_callback([&events](vdl::reconnect_event_t event, uint8_t, uint8_t,
+                                            const vdl::error_t&) {
+        events.push_back(event);
+    });
+
+    REQUIRE(device.connect().has_value());
+    transport_ptr->set_fail_write_times(cfg.max_retries);
+    transport_ptr->set_fail_open_times(1);  // 第一次重连失败，退避后成功
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x06);
+
+    auto first = device.execute(cmd);
+    REQUIRE_FALSE(first.has_value());
+    REQUIRE(first.error().code() == vdl::error_code_t::write_failed);
+
+    // 退避期间新的调用立即返回，不等待重连
+    const auto start = std::chrono::steady_clock::now();
+    auto second = device.execute(cmd);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    REQUIRE_FALSE(second.has_value());
+    REQUIRE(second.error().code() == vdl::error_code_t::not_connected);
+    REQUIRE(elapsed < std::chrono::milliseconds(50));
+
+    REQUIRE(wait_reconnect_done(device));
+    REQUIRE(device.state() == vdl::device_state_t::connected);
+    REQUIRE(transport_ptr->open_count() == 3u);  // 1 次连接 + 2 次重连尝试
+
+    REQUIRE(events.size() == 4u);
+    REQUIRE(events[0] == vdl::reconnect_event_t::started);
+    REQUIRE(events[1] == vdl::reconnect_event_t::attempting);
+    REQUIRE(events[2] == vdl::reconnect_event_t::attempting);
+    REQUIRE(events[3] == vdl::reconnect_event_t::success);
+}
+
+TEST_CASE("device_impl waits for background reconnect", "[device][reconnect]") {
+    vdl::command_t cmd;
+    cmd.set_function_code(0x03);
+    vdl::binary_codec_t codec_helper;
+    auto frame = codec_helper.encode(cmd);
+    REQUIRE(frame.has_value());
+
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    transport_ptr->enable_auto_response(*frame);
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+
+    vdl::device_config_t cfg;
+    cfg.max_retries = 2;
+    cfg.retry_delay = 0;
+    cfg.reconnect_delay = 20;
+    cfg.background_reconnect = true;
+    cfg.reconnect_wait = 2000;
+    device.set_config(cfg);
+
+    REQUIRE(device.connect().has_value());
+    transport_ptr->set_fail_write_times(cfg.max_retries);
+    transport_ptr->set_fail_open_times(1);
+
+    REQUIRE_FALSE(device.execute(cmd).has_value());
+
+    // reconnect_wait 内等待重连完成，随后正常执行
+    auto result = device.execute(cmd);
+    REQUIRE(result.has_value());
+    REQUIRE(device.state() == vdl::device_state_t::connected);
+}
+
+TEST_CASE("device_impl circuit breaker stops reconnect attempts", "[device][reconnect][breaker]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+
+    vdl::device_config_t cfg;
+    cfg.max_retries = 1;
+    cfg.retry_delay = 0;
+    cfg.reconnect_delay = 0;
+    cfg.background_reconnect = true;
+    cfg.breaker.failure_threshold = 1;
+    cfg.breaker.open_duration = 50;
+    device.set_config(cfg);
+
+    REQUIRE(device.connect().has_value());
+    transport_ptr->set_fail_write_times(1);
+    transport_ptr->set_fail_open(true);
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x07);
+    REQUIRE_FALSE(device.execute(cmd).has_value());
+    REQUIRE(wait_reconnect_done(device));
+    REQUIRE(device.state() == vdl::device_state_t::error);
+    REQUIRE(device.circuit_state() == vdl::circuit_state_t::open);
+    const uint32_t opens = transport_ptr->open_count();
+
+    // 熔断期间不再尝试重连
+    auto rejected = device.execute(cmd);
+    REQUIRE_FALSE(rejected.has_value());
+    REQUIRE(rejected.error().code() == vdl::error_code_t::not_connected);
+    REQUIRE(rejected.error().message() == "Circuit breaker open");
+    REQUIRE(transport_ptr->open_count() == opens);
+
+    // 冷却期结束：半开试探一次，成功后熔断器闭合
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    transport_ptr->set_fail_open(false);
+    REQUIRE_FALSE(device.execute(cmd).has_value());
+    REQUIRE(wait_reconnect_done(device));
+    REQUIRE(device.state() == vdl::device_state_t::connected);
+    REQUIRE(device.circuit_state() == vdl::circuit_state_t::closed);
+}
+
+TEST_CASE("device_impl disconnect stops background reconnect", "[device][reconnect]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+
+    vdl::device_config_t cfg;
+    cfg.max_retries = 5;
+    cfg.retry_delay = 0;
+    cfg.reconnect_delay = 5000;
+    cfg.background_reconnect = true;
+    device.set_config(cfg);
+
+    REQUIRE(device.connect().has_value());
+    transport_ptr->set_fail_write_times(cfg.max_retries);
+    transport_ptr->set_fail_open(true);
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x08);
+    REQUIRE_FALSE(device.execute(cmd).has_value());
+
+    // 退避等待可被中断
+    const auto start = std::chrono::steady_clock::now();
+    device.disconnect();
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1000));
+    REQUIRE_FALSE(device.reconnecting());
+    REQUIRE(device.state() == vdl::device_state_t::disconnected);
+}
+
+// ============================================================================
+// 持久接收缓冲区测试
+// ============================================================================
+
+TEST_CASE("device_impl keeps bytes after a frame for the next execute", "[device][rx_buffer]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+
+    vdl::device_config_t cfg;
+    cfg.max_retries = 1;
+    cfg.retry_delay = 0;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    vdl::binary_codec_t codec_helper;
+    vdl::command_t first;
+    first.set_function_code(0x11).set_data({0x01});
+    vdl::command_t second;
+    second.set_function_code(0x22).set_data({0x02, 0x03});
+
+    // 两个响应帧在一次读取中同时到达
+    auto frame1 = codec_helper.encode(first);
+    auto frame2 = codec_helper.encode(second);
+    REQUIRE(frame1.has_value());
+    REQUIRE(frame2.has_value());
+    vdl::bytes_t both = *frame1;
+    both.insert(both.end(), frame2->begin(), frame2->end());
+    transport_ptr->set_response(both);
+
+    auto result1 = device.execute(first);
+    REQUIRE(result1.has_value());
+    REQUIRE(result1->function_code() == 0x11);
+
+    // 第二个响应来自遗留字节，传输层已无数据
+    auto result2 = device.execute(second);
+    REQUIRE(result2.has_value());
+    REQUIRE(result2->function_code() == 0x22);
+    REQUIRE(result2->data().size() == 2);
+}
+
+TEST_CASE("device_impl skips garbage before a frame", "[device][rx_buffer]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    REQUIRE(device.connect().has_value());
+
+    vdl::binary_codec_t codec_helper;
+    vdl::command_t cmd;
+    cmd.set_function_code(0x05).set_data({0x10, 0x20, 0x30});
+    auto frame = codec_helper.encode(cmd);
+    REQUIRE(frame.has_value());
+
+    vdl::bytes_t noisy = {0x00, 0x13, 0x37};
+    noisy.insert(noisy.end(), frame->begin(), frame->end());
+    transport_ptr->set_response(noisy);
+
+    auto result = device.execute(cmd);
+    REQUIRE(result.has_value());
+    REQUIRE(result->function_code() == 0x05);
+}
+
+TEST_CASE("device_impl disconnect discards buffered bytes", "[device][rx_buffer]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+
+    vdl::device_config_t cfg;
+    cfg.max_retries = 1;
+    cfg.retry_delay = 0;
+    cfg.auto_reconnect = false;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    // 文本行之后的剩余数据在下一次 read() 中返回
+    const std::string lines = "first\nsecond\n";
+    transport_ptr->set_response(vdl::bytes_t(lines.begin(), lines.end()));
+
+    auto line1 = device.read();
+    REQUIRE(line1.has_value());
+    REQUIRE(*line1 == "first");
+
+    device.disconnect();
+    REQUIRE(device.connect().has_value());
+
+    // 断开时缓冲区被清空，遗留的 "second" 不再可见
+    auto line2 = device.read();
+    REQUIRE_FALSE(line2.has_value());
+    REQUIRE(line2.error().code() == vdl::error_code_t::timeout);
+}
+
+// ============================================================================
+// 流水线执行测试
+// ============================================================================
+
+namespace {
+
+// 以第一个数据字节作为关联键的测试编解码器
+class keyed_codec_t : public vdl::binary_codec_t {
+public:
+    vdl::optional_t<vdl::uint32_t> correlation_key(vdl::const_byte_span_t frame) const override {
+        if (frame.size() <= vdl::binary_frame::HEADER_SIZE) {
+            return tl::nullopt;
+        }
+        return static_cast<vdl::uint32_t>(frame[vdl::binary_frame::HEADER_SIZE]);
+    }
+};
+
+vdl::bytes_t encode_frame(vdl::uint8_t function_code, const vdl::bytes_t& data) {
+    vdl::binary_codec_t codec;
+    vdl::command_t cmd;
+    cmd.set_function_code(function_code).set_data(data);
+    return *codec.encode(cmd);
+}
+
+}  // namespace
+
+TEST_CASE("device_impl execute_async completes in FIFO order", "[device][async]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+
+    vdl::device_config_t cfg;
+    cfg.max_in_flight = 2;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    vdl::bytes_t replies;
+    for (vdl::uint8_t fc = 1; fc <= 3; ++fc) {
+        auto frame = encode_frame(fc, {fc});
+        replies.insert(replies.end(), frame.begin(), frame.end());
+    }
+    transport_ptr->set_response(replies);
+
+    std::vector<vdl::uint8_t> completed;
+    auto on_done = [&completed](const vdl::result_t<vdl::response_t>& r) {
+        REQUIRE(r.has_value());
+        completed.push_back(r->function_code());
+    };
+
+    auto h1 = device.execute_async(vdl::command_t().set_function_code(1), on_done);
+    auto h2 = device.execute_async(vdl::command_t().set_function_code(2), on_done);
+    REQUIRE(device.in_flight() == 2);
+    REQUIRE_FALSE(h1.is_ready());
+
+    // 窗口已满：发送第三个请求前先完成第一个
+    auto h3 = device.execute_async(vdl::command_t().set_function_code(3), on_done);
+    REQUIRE(h1.is_ready());
+    REQUIRE(device.in_flight() == 2);
+
+    // 等待第三个请求会顺带完成第二个
+    auto r3 = h3.get();
+    REQUIRE(r3.has_value());
+    REQUIRE(r3->function_code() == 3);
+    REQUIRE(h2.is_ready());
+    REQUIRE(h2.get()->function_code() == 2);
+
+    REQUIRE(completed == std::vector<vdl::uint8_t>{1, 2, 3});
+    REQUIRE(device.in_flight() == 0);
+    REQUIRE(transport_ptr->get_written_data().size() == 3 * vdl::binary_frame::MIN_FRAME_SIZE);
+}
+
+TEST_CASE("device_impl execute_async matches responses by correlation key", "[device][async]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<keyed_codec_t>();
+
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    REQUIRE(device.connect().has_value());
+
+    // 设备乱序应答
+    vdl::bytes_t replies = encode_frame(0x20, {0x02, 0xBB});
+    auto first = encode_frame(0x10, {0x01, 0xAA});
+    replies.insert(replies.end(), first.begin(), first.end());
+    transport_ptr->set_response(replies);
+
+    vdl::command_t cmd1;
+    cmd1.set_function_code(0x10).set_data({0x01});
+    vdl::command_t cmd2;
+    cmd2.set_function_code(0x20).set_data({0x02});
+
+    auto h1 = device.execute_async(cmd1);
+    auto h2 = device.execute_async(cmd2);
+
+    auto r1 = h1.get();
+    REQUIRE(r1.has_value());
+    REQUIRE(r1->function_code() == 0x10);
+    REQUIRE(r1->data()[1] == 0xAA);
+
+    // h2 在等待 h1 时已被分发
+    REQUIRE(h2.is_ready());
+    REQUIRE(h2.get()->function_code() == 0x20);
+}
+
+TEST_CASE("device_impl pipelines Modbus TCP requests by transaction id", "[device][async][modbus]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::modbus_tcp_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    // 网关先返回第二个请求（事务号 2）的响应
+    transport_ptr->set_response({0x00, 0x02, 0x00, 0x00, 0x00, 0x05, 0x01, 0x03, 0x02, 0x00, 0xBB,
+                                 0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x01, 0x03, 0x02, 0x00, 0xAA});
+
+    auto h1 = device.execute_async(vdl::make_read_command(vdl::modbus::read_holding_registers, 0, 1));
+    auto h2 = device.execute_async(vdl::make_read_command(vdl::modbus::read_holding_registers, 1, 1));
+    REQUIRE(device.in_flight() == 2);
+
+    auto r1 = h1.get();
+    REQUIRE(r1.has_value());
+    REQUIRE(r1->get_uint16_be(0) == 0x00AA);
+    REQUIRE(h2.is_ready());
+    REQUIRE(h2.get()->get_uint16_be(0) == 0x00BB);
+    REQUIRE(transport_ptr->get_written_data().size() == 2 * 12);
+}
+
+TEST_CASE("device_impl execute_async fails pending requests on timeout", "[device][async]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+
+    vdl::device_config_t cfg;
+    cfg.auto_reconnect = false;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    auto h1 = device.execute_async(vdl::command_t().set_function_code(1));
+    auto h2 = device.execute_async(vdl::command_t().set_function_code(2));
+
+    auto r1 = h1.get();
+    REQUIRE_FALSE(r1.has_value());
+    REQUIRE(r1.error().code() == vdl::error_code_t::timeout);
+    REQUIRE(h2.is_ready());
+    REQUIRE_FALSE(h2.get().has_value());
+    REQUIRE(device.in_flight() == 0);
+}
+
+TEST_CASE("device_impl execute drains pending async requests first", "[device][async]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    REQUIRE(device.connect().has_value());
+
+    vdl::bytes_t replies = encode_frame(0x01, {});
+    auto second = encode_frame(0x02, {});
+    replies.insert(replies.end(), second.begin(), second.end());
+    transport_ptr->set_response(replies);
+
+    auto handle = device.execute_async(vdl::command_t().set_function_code(0x01));
+    auto sync_result = device.execute(vdl::command_t().set_function_code(0x02));
+
+    REQUIRE(handle.is_ready());
+    REQUIRE(handle.get()->function_code() == 0x01);
+    REQUIRE(sync_result.has_value());
+    REQUIRE(sync_result->function_code() == 0x02);
+}
+
+// ============================================================================
+// 批量执行测试
+// ============================================================================
+
+TEST_CASE("device_impl pipelining hides link latency", "[device][async][sim]") {
+    vdl::sim_link_config_t link;
+    link.latency_us = 5000;   // 往返 10 ms
+    auto transport = vdl::make_unique<vdl::sim_transport_t>(link);
+    transport->set_responder(vdl::make_codec_responder(std::make_shared<vdl::binary_codec_t>(),
+        [](const vdl::response_t& request) -> vdl::optional_t<vdl::command_t> {
+            vdl::command_t reply;
+            reply.set_function_code(request.function_code());
+            return reply;
+        }));
+
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    vdl::device_config_t cfg;
+    cfg.max_in_flight = 8;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    // 8 个请求同时在途，总耗时接近一次往返而不是八次
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<vdl::async_response_t> handles;
+    for (uint8_t i = 1; i <= 8; ++i) {
+        handles.push_back(device.execute_async(vdl::command_t().set_function_code(i)));
+    }
+    for (size_t i = 0; i < handles.size(); ++i) {
+        auto result = handles[i].get();
+        REQUIRE(result.has_value());
+        REQUIRE(result->function_code() == static_cast<uint8_t>(i + 1));
+    }
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(60));
+}
+
+TEST_CASE("device_impl async handles can be waited on from other threads", "[device][async][sim]") {
+    vdl::sim_link_config_t link;
+    link.latency_us = 1000;
+    auto transport = vdl::make_unique<vdl::sim_transport_t>(link);
+    transport->set_responder(vdl::make_codec_responder(std::make_shared<vdl::binary_codec_t>(),
+        [](const vdl::response_t& request) -> vdl::optional_t<vdl::command_t> {
+            vdl::command_t reply;
+            reply.set_function_code(request.function_code());
+            return reply;
+        }));
+
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    vdl::device_config_t cfg;
+    cfg.max_in_flight = 8;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    // 每个句柄由独立线程轮询/等待；完成它的可能是任意一个线程
+    for (int round = 0; round < 20; ++round) {
+        std::vector<vdl::async_response_t> handles;
+        for (uint8_t i = 1; i <= 8; ++i) {
+            handles.push_back(device.execute_async(vdl::command_t().set_function_code(i)));
+        }
+        std::atomic<int> matched{0};
+        std::vector<std::thread> waiters;
+        for (size_t i = 0; i < handles.size(); ++i) {
+            waiters.emplace_back([&handles, &matched, i] {
+                if (i % 2 == 0) {
+                    while (!handles[i].is_ready()) {
+                        std::this_thread::yield();
+                        if (i == 0) {
+                            handles[i].wait();   // 至少一个线程驱动接收
+                        }
+                    }
+                }
+                auto result = handles[i].get();
+                if (result && result->function_code() == static_cast<uint8_t>(i + 1)) {
+                    ++matched;
+                }
+            });
+        }
+        for (auto& t : waiters) {
+            t.join();
+        }
+        REQUIRE(matched.load() == 8);
+    }
+}
+
+TEST_CASE("device_impl execute bounds retries by the call deadline", "[device][deadline][sim]") {
+    // 不回复的设备：每次尝试都会超时
+    vdl::device_impl_t device(vdl::make_unique<vdl::sim_transport_t>(),
+                              vdl::make_unique<vdl::binary_codec_t>());
+    vdl::device_config_t cfg;
+    cfg.max_retries = 3;
+    cfg.retry_delay = 100;
+    cfg.auto_reconnect = false;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    // 按每次读取计时需要 3 * 100 + 2 * 100 ms，截止时间把整个调用限制在 100 ms
+    const auto start = std::chrono::steady_clock::now();
+    auto result = device.execute(vdl::command_t().set_function_code(0x01), 100);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().code() == vdl::error_code_t::timeout);
+    REQUIRE(elapsed >= std::chrono::milliseconds(90));
+    REQUIRE(elapsed < std::chrono::milliseconds(250));
+}
+
+TEST_CASE("device_impl execute is cancelled from another thread", "[device][deadline][sim]") {
+    auto transport = vdl::make_unique<vdl::sim_transport_t>();
+    auto* sim = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    vdl::cancellation_token_t token;
+    std::thread canceller([token] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        token.cancel();
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    auto result = device.execute(vdl::command_t().set_function_code(0x01), 5000, token);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    canceller.join();
+
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().code() == vdl::error_code_t::operation_cancelled);
+    REQUIRE(elapsed < std::chrono::milliseconds(500));
+    REQUIRE(device.is_connected());
+
+    // 已取消的令牌立即生效；重置后可复用
+    auto again = device.execute(vdl::command_t().set_function_code(0x02), 5000, token);
+    REQUIRE_FALSE(again.has_value());
+    REQUIRE(again.error().code() == vdl::error_code_t::operation_cancelled);
+    token.reset();
+
+    sim->set_responder([](vdl::const_byte_span_t request, vdl::bytes_t& reply) {
+        reply.insert(reply.end(), request.begin(), request.end());
+        return request.size();
+    });
+    auto answered = device.execute(vdl::command_t().set_function_code(0x03), 500, token);
+    REQUIRE(answered.has_value());
+    REQUIRE(answered->function_code() == 0x03);
+}
+
+TEST_CASE("device_impl text read is cancellable", "[device][deadline][sim]") {
+    vdl::device_impl_t device(vdl::make_unique<vdl::sim_transport_t>(),
+                              vdl::make_unique<vdl::binary_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    vdl::cancellation_token_t token;
+    std::thread canceller([token] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        token.cancel();
+    });
+    const auto start = std::chrono::steady_clock::now();
+    auto result = device.read(5000, token);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    canceller.join();
+
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().code() == vdl::error_code_t::operation_cancelled);
+    REQUIRE(elapsed < std::chrono::milliseconds(500));
+}
+
+TEST_CASE("device_impl execute_batch sends one write and decodes in order", "[device][batch]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    REQUIRE(device.connect().has_value());
+
+    std::vector<vdl::command_t> cmds;
+    vdl::bytes_t replies;
+    for (vdl::uint8_t fc = 1; fc <= 5; ++fc) {
+        cmds.push_back(vdl::command_t().set_function_code(fc).set_data({fc, fc}));
+        auto frame = encode_frame(fc, {static_cast<vdl::byte_t>(fc * 10)});
+        replies.insert(replies.end(), frame.begin(), frame.end());
+    }
+    transport_ptr->set_response(replies);
+
+    auto results = device.execute_batch(cmds);
+    REQUIRE(results.size() == 5);
+    for (size_t i = 0; i < results.size(); ++i) {
+        REQUIRE(results[i].has_value());
+        REQUIRE(results[i]->function_code() == static_cast<vdl::uint8_t>(i + 1));
+        REQUIRE(results[i]->data()[0] == static_cast<vdl::byte_t>((i + 1) * 10));
+    }
+
+    // 五个命令连续写出
+    REQUIRE(transport_ptr->get_written_data().size() == 5 * (vdl::binary_frame::MIN_FRAME_SIZE + 2));
+}
+
+TEST_CASE("basic_device_t dispatches statically to concrete transport and codec", "[device][static]") {
+    typedef vdl::basic_device_t<vdl::mock_transport_t, vdl::binary_codec_t> fast_device_t;
+    static_assert(vdl::detail::is_direct_dispatch_t<vdl::mock_transport_t>::value, "direct transport");
+    static_assert(!vdl::detail::is_direct_dispatch_t<vdl::i_codec_t>::value, "erased codec");
+
+    fast_device_t device(vdl::make_unique<vdl::mock_transport_t>(),
+                         vdl::make_unique<vdl::binary_codec_t>());
+    vdl::mock_transport_t* transport = device.transport();   // 无需向下转换
+    REQUIRE(device.connect().has_value());
+
+    auto reply = encode_frame(0x03, {0x12, 0x34});
+    transport->set_response(reply);
+    auto result = device.execute(vdl::command_t().set_function_code(0x03).set_data({0x00}));
+    REQUIRE(result.has_value());
+    REQUIRE(result->get_uint16_be(0) == 0x1234);
+
+    std::vector<vdl::command_t> cmds(3, vdl::command_t().set_function_code(0x04));
+    vdl::bytes_t replies;
+    for (int i = 0; i < 3; ++i) {
+        auto frame = encode_frame(0x04, {static_cast<vdl::byte_t>(i)});
+        replies.insert(replies.end(), frame.begin(), frame.end());
+    }
+    transport->set_response(replies);
+    auto results = device.execute_batch(cmds);
+    REQUIRE(results.size() == 3);
+    REQUIRE(results[2].has_value());
+    REQUIRE(results[2]->get_byte(0) == 2);
+
+    transport->set_response(reply);
+    auto handle = device.execute_async(vdl::command_t().set_function_code(0x03));
+    REQUIRE(handle.get()->get_uint16_be(0) == 0x1234);
+}
+
+TEST_CASE("device_impl execute_batch reports per-command errors", "[device][batch]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+    codec->set_max_frame_size(16);
+
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    REQUIRE(device.connect().has_value());
+
+    std::vector<vdl::command_t> cmds;
+    cmds.push_back(vdl::command_t().set_function_code(0x01));
+    cmds.push_back(vdl::command_t().set_function_code(0x02).set_data(vdl::bytes_t(32, 0x00)));
+    cmds.push_back(vdl::command_t().set_function_code(0x03));
+
+    vdl::bytes_t replies = encode_frame(0x01, {});
+    auto third = encode_frame(0x03, {});
+    replies.insert(replies.end(), third.begin(), third.end());
+    transport_ptr->set_response(replies);
+
+    auto results = device.execute_batch(cmds);
+    REQUIRE(results.size() == 3);
+    REQUIRE(results[0].has_value());
+    REQUIRE_FALSE(results[1].has_value());
+    REQUIRE(results[1].error().code() == vdl::error_code_t::frame_too_large);
+    REQUIRE(results[2].has_value());
+    REQUIRE(results[2]->function_code() == 0x03);
+}
+
+TEST_CASE("device_impl execute_batch fails unanswered tail", "[device][batch]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+
+    vdl::device_config_t cfg;
+    cfg.max_retries = 1;
+    cfg.retry_delay = 0;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    std::vector<vdl::command_t> cmds;
+    cmds.push_back(vdl::command_t().set_function_code(0x0A));
+    cmds.push_back(vdl::command_t().set_function_code(0x0B));
+    transport_ptr->set_response(encode_frame(0x0A, {}));
+
+    auto results = device.execute_batch(cmds);
+    REQUIRE(results.size() == 2);
+    REQUIRE(results[0].has_value());
+    REQUIRE_FALSE(results[1].has_value());
+    REQUIRE(results[1].error().code() == vdl::error_code_t::timeout);
+}
+
+TEST_CASE("device_impl execute_batch retries unanswered commands", "[device][batch]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+
+    vdl::device_config_t cfg;
+    cfg.max_retries = 2;
+    cfg.retry_delay = 0;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    std::vector<vdl::command_t> cmds;
+    cmds.push_back(vdl::command_t().set_function_code(0x0A));
+    cmds.push_back(vdl::command_t().set_function_code(0x0B));
+
+    // 第一次写入失败，整批在第二轮重发
+    transport_ptr->set_fail_write_times(1);
+    vdl::bytes_t replies = encode_frame(0x0A, {});
+    auto second = encode_frame(0x0B, {});
+    replies.insert(replies.end(), second.begin(), second.end());
+    transport_ptr->set_response(replies);
+
+    auto results = device.execute_batch(cmds);
+    REQUIRE(results.size() == 2);
+    REQUIRE(results[0].has_value());
+    REQUIRE(results[0]->function_code() == 0x0A);
+    REQUIRE(results[1].has_value());
+    REQUIRE(results[1]->function_code() == 0x0B);
+    REQUIRE(device.is_connected());
+}
+
+TEST_CASE("device_impl execute_batch bounds the whole batch by one deadline", "[device][batch][deadline][sim]") {
+    // 不回复的设备：每个响应、每次重试都会超时
+    vdl::device_impl_t device(vdl::make_unique<vdl::sim_transport_t>(),
+                              vdl::make_unique<vdl::binary_codec_t>());
+    vdl::device_config_t cfg;
+    cfg.max_retries = 3;
+    cfg.retry_delay = 50;
+    cfg.auto_reconnect = false;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    std::vector<vdl::command_t> cmds;
+    for (uint8_t i = 1; i <= 4; ++i) {
+        cmds.push_back(vdl::command_t().set_function_code(i));
+    }
+
+    // 按每个响应计时需要 3 * 4 * 100 ms 加重试间隔，截止时间把整批限制在 100 ms
+    const auto start = std::chrono::steady_clock::now();
+    auto results = device.execute_batch(vdl::span_t<const vdl::command_t>(cmds.data(), cmds.size()),
+                                        100);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(results.size() == 4);
+    for (const auto& result : results) {
+        REQUIRE_FALSE(result.has_value());
+        REQUIRE(result.error().code() == vdl::error_code_t::timeout);
+    }
+    REQUIRE(elapsed >= std::chrono::milliseconds(90));
+    REQUIRE(elapsed < std::chrono::milliseconds(250));
+}
+
+TEST_CASE("device_impl execute_batch is cancelled from another thread", "[device][batch][deadline][sim]") {
+    vdl::device_impl_t device(vdl::make_unique<vdl::sim_transport_t>(),
+                              vdl::make_unique<vdl::binary_codec_t>());
+    vdl::device_config_t cfg;
+    cfg.max_retries = 2;
+    cfg.retry_delay = 2000;
+    cfg.auto_reconnect = false;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    std::vector<vdl::command_t> cmds;
+    cmds.push_back(vdl::command_t().set_function_code(0x01));
+
+    vdl::cancellation_token_t token;
+    std::thread canceller([token] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        token.cancel();
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    auto results = device.execute_batch(vdl::span_t<const vdl::command_t>(cmds.data(), cmds.size()),
+                                        5000, token);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    canceller.join();
+
+    REQUIRE(results.size() == 1);
+    REQUIRE_FALSE(results[0].has_value());
+    REQUIRE(results[0].error().code() == vdl::error_code_t::operation_cancelled);
+    REQUIRE(elapsed < std::chrono::milliseconds(1000));
+    REQUIRE(device.is_connected());
+}
+
+// ============================================================================
+// 设备独占锁测试
+// ============================================================================
+
+TEST_CASE("device_lock_t excludes other threads", "[device][lock]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    REQUIRE(device.connect().has_value());
+
+    vdl::device_lock_t lock(device);
+    REQUIRE(lock.owns_lock());
+
+    // 同一线程可重入
+    REQUIRE(device.try_lock());
+    device.unlock();
+
+    bool other_try = true;
+    bool other_timed = true;
+    std::thread other([&]() {
+        other_try = device.try_lock();
+        other_timed = device.try_lock_for(20);
+    });
+    other.join();
+    REQUIRE_FALSE(other_try);
+    REQUIRE_FALSE(other_timed);
+
+    lock.unlock();
+    REQUIRE_FALSE(lock.owns_lock());
+
+    std::thread after([&]() {
+        other_try = device.try_lock();
+        if (other_try) {
+            device.unlock();
+        }
+    });
+    after.join();
+    REQUIRE(other_try);
+}
+
+TEST_CASE("device_impl execute waits for device lock", "[device][lock]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    REQUIRE(device.connect().has_value());
+
+    transport_ptr->enable_auto_response(encode_frame(0x01, {}));
+
+    std::atomic<bool> done{false};
+    std::thread worker;
+    {
+        vdl::device_lock_t lock(device, 100);
+        REQUIRE(lock.owns_lock());
+
+        worker = std::thread([&]() {
+            auto result = device.execute(vdl::command_t().set_function_code(0x01));
+            done.store(result.has_value());
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        // 持锁期间其他线程的命令不会写出
+        REQUIRE(transport_ptr->get_written_data().empty());
+        REQUIRE_FALSE(done.load());
+    }
+
+    worker.join();
+    REQUIRE(done.load());
+    REQUIRE_FALSE(transport_ptr->get_written_data().empty());
+}
+
+TEST_CASE("device_impl execute sends scatter-encoded frame in one write", "[device][writev]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    REQUIRE(device.connect().has_value());
+
+    transport_ptr->set_response(encode_frame(0x10, {0x00}));
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x10).set_data(vdl::bytes_t(1024, 0x5A));
+    auto result = device.execute(cmd);
+    REQUIRE(result.has_value());
+
+    vdl::binary_codec_t helper;
+    REQUIRE(transport_ptr->write_call_count() == 1);
+    REQUIRE(transport_ptr->get_written_data() == *helper.encode(cmd));
+}
+
+TEST_CASE("device_impl retain_raw_frame option", "[device][rx_buffer]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    REQUIRE(device.connect().has_value());
+
+    transport_ptr->set_response(encode_frame(0x01, {0x11, 0x22}));
+    auto with_raw = device.execute(vdl::command_t().set_function_code(0x01));
+    REQUIRE(with_raw.has_value());
+    REQUIRE(with_raw->raw_view().size() == vdl::binary_frame::MIN_FRAME_SIZE + 2);
+    REQUIRE(with_raw->is_data_shared());
+
+    vdl::device_config_t cfg = device.config();
+    cfg.retain_raw_frame = false;
+    device.set_config(cfg);
+
+    transport_ptr->set_response(encode_frame(0x01, {0x11, 0x22}));
+    auto without_raw = device.execute(vdl::command_t().set_function_code(0x01));
+    REQUIRE(without_raw.has_value());
+    REQUIRE(without_raw->raw_view().empty());
+    REQUIRE(without_raw->payload() == vdl::bytes_t({0x11, 0x22}));
+}
+
+TEST_CASE("device_impl reuses receive slabs once responses are released", "[device][rx_buffer]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    REQUIRE(device.connect().has_value());
+
+    const vdl::byte_t* first_data = nullptr;
+    {
+        transport_ptr->set_response(encode_frame(0x01, {0x11, 0x22}));
+        auto first = device.execute(vdl::command_t().set_function_code(0x01));
+        REQUIRE(first.has_value());
+        first_data = first->data_view().data();
+    }
+
+    // 上一个响应已释放：同一个 slab 被复用
+    transport_ptr->set_response(encode_frame(0x01, {0x33, 0x44}));
+    auto second = device.execute(vdl::command_t().set_function_code(0x01));
+    REQUIRE(second.has_value());
+    REQUIRE(second->data_view().data() == first_data);
+
+    // 仍被持有的响应不会被后续帧覆盖
+    transport_ptr->set_response(encode_frame(0x01, {0x55, 0x66}));
+    auto third = device.execute(vdl::command_t().set_function_code(0x01));
+    REQUIRE(third.has_value());
+    REQUIRE(second->payload() == vdl::bytes_t({0x33, 0x44}));
+    REQUIRE(third->payload() == vdl::bytes_t({0x55, 0x66}));
+}
+
+// ============================================================================
+// 二进制块测试
+// ============================================================================
+
+namespace {
+
+vdl::bytes_t make_block(const vdl::bytes_t& payload, const std::string& trailer) {
+    std::string len = std::to_string(payload.size());
+    std::string header = "#" + std::to_string(len.size()) + len;
+    vdl::bytes_t block(header.begin(), header.end());
+    block.insert(block.end(), payload.begin(), payload.end());
+    block.insert(block.end(), trailer.begin(), trailer.end());
+    return block;
+}
+
+}  // namespace
+
+TEST_CASE("device_impl read_binary_block keeps stream in sync", "[device][block]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+    codec->set_max_frame_size(16);   // 接收缓冲区小于块，剩余数据直接读入目标
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    REQUIRE(device.connect().has_value());
+
+    vdl::bytes_t payload(100);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<vdl::byte_t>(i);
+    }
+    transport_ptr->set_response(make_block(payload, "\r\n"));
+    transport_ptr->set_response(make_block({0x01, 0x02, 0x03}, "\n"));
+    const std::string line = "OK\n";
+    transport_ptr->set_response(vdl::bytes_t(line.begin(), line.end()));
+
+    auto block = device.read_binary_block();
+    REQUIRE(block.has_value());
+    REQUIRE(*block == payload);
+
+    // 目标缓冲区不足：整块被丢弃，后续数据不受影响
+    vdl::byte_t small[2];
+    auto too_small = device.read_binary_block([&small](size_t) {
+        return vdl::byte_span_t(small, sizeof(small));
+    });
+    REQUIRE_FALSE(too_small.has_value());
+    REQUIRE(too_small.error().code() == vdl::error_code_t::invalid_size);
+
+    auto text = device.read();
+    REQUIRE(text.has_value());
+    REQUIRE(*text == "OK");
+}
+
+TEST_CASE("device_impl read_binary_block rejects malformed header", "[device][block]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    const std::string text = "1.0,2.0\n";
+    transport_ptr->set_response(vdl::bytes_t(text.begin(), text.end()));
+    auto result = device.read_binary_block();
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().code() == vdl::error_code_t::invalid_format);
+
+    device.disconnect();
+    REQUIRE(device.connect().has_value());
+    const std::string indefinite = "#0abc\n";
+    transport_ptr->set_response(vdl::bytes_t(indefinite.begin(), indefinite.end()));
+    result = device.read_binary_block();
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().code() == vdl::error_code_t::not_supported);
+}
+
+TEST_CASE("device_impl read_binary_block rejects lengths above max_block_size", "[device][block]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+    codec->set_max_frame_size(16);
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    vdl::device_config_t cfg;
+    cfg.max_block_size = 64;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    // 块头声明 999999999 字节：不调用分配器，也不等待数据
+    const std::string header = "#9999999999";
+    transport_ptr->set_response(vdl::bytes_t(header.begin(), header.end()));
+    bool allocated = false;
+    auto result = device.read_binary_block([&allocated](size_t) {
+        allocated = true;
+        return vdl::byte_span_t();
+    }, 5000);
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().code() == vdl::error_code_t::frame_too_large);
+    REQUIRE_FALSE(allocated);
+
+    // 不超过上限的块仍可读取，且不受 max_frame_size 限制
+    transport_ptr->set_response(make_block(vdl::bytes_t(64, 0x5A), "\n"));
+    auto block = device.read_binary_block();
+    REQUIRE(block.has_value());
+    REQUIRE(block->size() == 64);
+}
+
+TEST_CASE("scpi_adapter_t query_real64_array swaps byte order", "[device][block]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    vdl::scpi_adapter_t scpi(device);
+    REQUIRE(scpi.connect().has_value());
+    REQUIRE(scpi.byte_order() == vdl::byte_order_t::big);
+
+    // 仪器默认 FORM:BORD NORM（大端）
+    const double values[] = {1.5, -2.25, 1e9};
+    vdl::bytes_t payload;
+    for (double v : values) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &v, sizeof(bits));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            payload.push_back(static_cast<vdl::byte_t>(bits >> shift));
+        }
+    }
+    transport_ptr->set_response(make_block(payload, "\n"));
+
+    std::vector<double> trace;
+    auto result = scpi.query_real64_array("CALC:DATA? FDAT", trace);
+    REQUIRE(result.has_value());
+    REQUIRE(*result == 3);
+    REQUIRE(trace == std::vector<double>{1.5, -2.25, 1e9});
+
+    const vdl::bytes_t written = transport_ptr->get_written_data();
+    REQUIRE(std::string(written.begin(), written.end()) == "CALC:DATA? FDAT\n");
+
+    // 长度不是元素大小的整数倍
+    transport_ptr->set_response(make_block({0x00, 0x01, 0x02}, "\n"));
+    auto bad = scpi.query_real32_array("CALC:DATA? FDAT");
+    REQUIRE_FALSE(bad.has_value());
+    REQUIRE(bad.error().code() == vdl::error_code_t::invalid_size);
+}
+
+// ============================================================================
+// 分块文本读取测试
+// ============================================================================
+
+TEST_CASE("device_impl read_chunked delivers a line in pieces", "[device][chunked]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+    codec->set_max_frame_size(8);   // 每块最多 8 字节
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    REQUIRE(device.connect().has_value());
+
+    const std::string text = "0123456789abcdefghij\nnext\n";
+    transport_ptr->set_response(vdl::bytes_t(text.begin(), text.end()));
+
+    std::string collected;
+    size_t chunks = 0;
+    auto result = device.read_chunked([&](const char* data, size_t len) {
+        collected.append(data, len);
+        ++chunks;
+        return vdl::make_ok();
+    });
+    REQUIRE(result.has_value());
+    REQUIRE(*result == 20);
+    REQUIRE(collected == "0123456789abcdefghij");
+    REQUIRE(chunks >= 3);
+
+    auto next = device.read();
+    REQUIRE(next.has_value());
+    REQUIRE(*next == "next");
+}
+
+TEST_CASE("scpi_adapter_t query_data_doubles parses while streaming", "[device][chunked]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+    codec->set_max_frame_size(7);   // 块边界落在数值中间
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    vdl::scpi_adapter_t scpi(device);
+    REQUIRE(scpi.connect().has_value());
+
+    const std::string text = "+1.000000E+00,-2.500000E-01,+3.125000E+02\r\n";
+    transport_ptr->set_response(vdl::bytes_t(text.begin(), text.end()));
+
+    std::vector<double> trace;
+    auto result = scpi.query_data_doubles("CALC:DATA? FDAT", trace);
+    REQUIRE(result.has_value());
+    REQUIRE(*result == 3);
+    REQUIRE(trace == std::vector<double>{1.0, -0.25, 312.5});
+
+    // 解析失败时读完整行并恢复输出
+    const std::string bad = "1.0,oops,3.0\nOK\n";
+    transport_ptr->set_response(vdl::bytes_t(bad.begin(), bad.end()));
+    auto failed = scpi.query_data_doubles("CALC:DATA? FDAT", trace);
+    REQUIRE_FALSE(failed.has_value());
+    REQUIRE(failed.error().code() == vdl::error_code_t::invalid_format);
+    REQUIRE(trace.size() == 3);
+
+    auto next = device.read();
+    REQUIRE(next.has_value());
+    REQUIRE(*next == "OK");
+}
+
+TEST_CASE("device_impl read honors read_terminator", "[device][rx_buffer]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+    codec->set_max_frame_size(12);  // 后续行跨越多次读取
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    REQUIRE(device.connect().has_value());
+
+    SECTION("lf strips carriage returns") {
+        const std::string text = "ab\rcdefg\r\nrest\n";
+        transport_ptr->set_response(vdl::bytes_t(text.begin(), text.end()));
+        auto line = device.read();
+        REQUIRE(line.has_value());
+        REQUIRE(*line == "abcdefg");
+        auto rest = device.read();
+        REQUIRE(rest.has_value());
+        REQUIRE(*rest == "rest");
+    }
+
+    SECTION("crlf keeps bare newlines") {
+        vdl::device_config_t cfg = device.config();
+        cfg.read_terminator = vdl::line_terminator_t::crlf;
+        device.set_config(cfg);
+
+        const std::string text = "one\ntwo\r\nnext\r\n";
+        transport_ptr->set_response(vdl::bytes_t(text.begin(), text.end()));
+        auto line = device.read();
+        REQUIRE(line.has_value());
+        REQUIRE(*line == "one\ntwo");
+
+        std::string collected;
+        auto chunked = device.read_chunked([&](const char* data, size_t len) {
+            collected.append(data, len);
+            return vdl::make_ok();
+        });
+        REQUIRE(chunked.has_value());
+        REQUIRE(collected == "next");
+    }
+
+    SECTION("eoi returns what one read delivers") {
+        vdl::device_config_t cfg = device.config();
+        cfg.read_terminator = vdl::line_terminator_t::eoi;
+        device.set_config(cfg);
+
+        const std::string text = "1,2\n";
+        transport_ptr->set_response(vdl::bytes_t(text.begin(), text.end()));
+        auto message = device.read();
+        REQUIRE(message.has_value());
+        REQUIRE(*message == "1,2\n");
+    }
+}
+
+// ============================================================================
+// SCPI 批处理测试
+// ============================================================================
+
+TEST_CASE("scpi_batch_t joins entries within message limit", "[device][scpi]") {
+    vdl::scpi_batch_t batch(40);
+    batch.command("SENS:FREQ:STAR 1E9").command("*CLS");
+    REQUIRE(batch.query(":SENS:FREQ:STOP?") == 0);
+    REQUIRE(batch.query("SENS:SWE:POIN?") == 1);
+
+    auto messages = batch.build_messages();
+    REQUIRE(messages.size() == 2);
+    REQUIRE(messages[0].text == "SENS:FREQ:STAR 1E9;*CLS");
+    REQUIRE(messages[0].query_count == 0);
+    REQUIRE(messages[1].text == ":SENS:FREQ:STOP?;:SENS:SWE:POIN?");
+    REQUIRE(messages[1].query_count == 2);
+    for (const auto& message : messages) {
+        REQUIRE(message.text.size() + 1 <= batch.max_message_size());
+    }
+}
+
+TEST_CASE("split_scpi_reply respects quoted strings", "[device][scpi]") {
+    std::vector<std::string> fields;
+    REQUIRE(vdl::split_scpi_reply("+1.0E9; \"a;b\" ;401", 3, fields).has_value());
+    REQUIRE(fields == std::vector<std::string>{"+1.0E9", "\"a;b\"", "401"});
+
+    REQUIRE_FALSE(vdl::split_scpi_reply("1;2", 3, fields).has_value());
+    REQUIRE(fields.size() == 3);
+}
+
+TEST_CASE("scpi_adapter_t execute coalesces round trips", "[device][scpi]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    vdl::scpi_adapter_t scpi(device);
+    REQUIRE(scpi.connect().has_value());
+
+    const std::string reply = "+1.000000000E+09;+6.000000000E+09;+401;1\n";
+    transport_ptr->set_response(vdl::bytes_t(reply.begin(), reply.end()));
+
+    vdl::scpi_batch_t batch;
+    batch.command("SENS:SWE:POIN 401");
+    const size_t start = batch.query("SENS:FREQ:STAR?");
+    const size_t stop = batch.query("SENS:FREQ:STOP?");
+    const size_t points = batch.query("SENS:SWE:POIN?");
+    const size_t cont = batch.query("INIT:CONT?");
+
+    auto result = scpi.execute(batch);
+    REQUIRE(result.has_value());
+    REQUIRE(result->size() == 4);
+    REQUIRE(*result->as_double(start) == 1e9);
+    REQUIRE(*result->as_double(stop) == 6e9);
+    REQUIRE(*result->as_int(points) == 401);
+    REQUIRE(*result->as_bool(cont));
+    REQUIRE_FALSE(result->as_bool(start).has_value());
+    REQUIRE_FALSE(result->text(4).has_value());
+
+    const vdl::bytes_t written = transport_ptr->get_written_data();
+    REQUIRE(std::string(written.begin(), written.end()) ==
+            "SENS:SWE:POIN 401;:SENS:FREQ:STAR?;:SENS:FREQ:STOP?;:SENS:SWE:POIN?;:INIT:CONT?\n");
+    REQUIRE(transport_ptr->write_call_count() == 1);
+}
+
+TEST_CASE("scpi_adapter_t routes queries through execute with ascii_codec_t", "[device][scpi][ascii]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::ascii_codec_t>());
+    vdl::scpi_adapter_t scpi(device);
+    REQUIRE(scpi.connect().has_value());
+    REQUIRE(scpi.uses_codec_pipeline());
+
+    const std::string reply = "KEYSIGHT,E5080B,MY1234,A.15\r\n";
+    transport_ptr->set_response(vdl::bytes_t(reply.begin(), reply.end()));
+
+    auto idn = scpi.query("*IDN?");
+    REQUIRE(idn.has_value());
+    REQUIRE(*idn == "KEYSIGHT,E5080B,MY1234,A.15");
+
+    const vdl::bytes_t written = transport_ptr->get_written_data();
+    REQUIRE(std::string(written.begin(), written.end()) == "*IDN?\n");
+}
+
+TEST_CASE("scpi_adapter_t pipelines batch messages with ascii_codec_t", "[device][scpi][ascii]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::ascii_codec_t>());
+    vdl::scpi_adapter_t scpi(device);
+    REQUIRE(scpi.connect().has_value());
+
+    const std::string reply = "+1E9\n+6E9\n+401\n";
+    transport_ptr->set_response(vdl::bytes_t(reply.begin(), reply.end()));
+
+    // 消息上限很小，每个条目单独成为一条消息
+    vdl::scpi_batch_t batch(24);
+    const size_t start = batch.query("SENS:FREQ:STAR?");
+    const size_t stop = batch.query("SENS:FREQ:STOP?");
+    const size_t points = batch.query("SENS:SWE:POIN?");
+    batch.command("SYST:BEEP:STAT OFF");
+
+    auto result = scpi.execute(batch);
+    REQUIRE(result.has_value());
+    REQUIRE(result->size() == 3);
+    REQUIRE(*result->as_double(start) == 1e9);
+    REQUIRE(*result->as_double(stop) == 6e9);
+    REQUIRE(*result->as_int(points) == 401);
+
+    const vdl::bytes_t written = transport_ptr->get_written_data();
+    REQUIRE(std::string(written.begin(), written.end()) ==
+            "SENS:FREQ:STAR?\nSENS:FREQ:STOP?\nSENS:SWE:POIN?\nSYST:BEEP:STAT OFF\n");
+    // 三条查询一次写出，命令单独写出
+    REQUIRE(transport_ptr->write_call_count() == 2);
+}
+
+TEST_CASE("scpi_adapter_t shadow cache serves settings locally", "[device][scpi]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    vdl::scpi_adapter_t scpi(device);
+    REQUIRE(scpi.connect().has_value());
+    scpi.enable_shadow_cache(true);
+
+    REQUIRE(scpi.set_double("SENS:FREQ:STAR", 1.5e9).has_value());
+    REQUIRE(scpi.set_int("SENS:SWE:POIN", 401).has_value());
+    transport_ptr->clear_written_data();
+
+    // 缓存命中：不产生任何通信
+    REQUIRE(*scpi.get_double(":sens:freq:star?") == 1.5e9);
+    REQUIRE(*scpi.get_int("SENS:SWE:POIN") == 401);
+    REQUIRE(transport_ptr->get_written_data().empty());
+
+    SECTION("verify mode still queries the instrument") {
+        scpi.set_verify(true);
+        const std::string reply = "+1.400000000E+09\n";
+        transport_ptr->set_response(vdl::bytes_t(reply.begin(), reply.end()));
+        REQUIRE(*scpi.get_double("SENS:FREQ:STAR") == 1.4e9);
+        REQUIRE_FALSE(transport_ptr->get_written_data().empty());
+
+        scpi.set_verify(false);
+        REQUIRE(*scpi.get_double("SENS:FREQ:STAR") == 1.4e9);   // 已用查询结果刷新
+    }
+
+    SECTION("*RST invalidates") {
+        REQUIRE(scpi.reset().has_value());
+        const std::string reply = "+201\n";
+        transport_ptr->set_response(vdl::bytes_t(reply.begin(), reply.end()));
+        REQUIRE(*scpi.get_int("SENS:SWE:POIN") == 201);
+    }
+
+    SECTION("reconnect invalidates") {
+        const uint64_t generation = device.connection_generation();
+        device.disconnect();
+        REQUIRE(device.connect().has_value());
+        REQUIRE(device.connection_generation() == generation + 1);
+
+        const std::string reply = "+2.000000000E+09\n";
+        transport_ptr->set_response(vdl::bytes_t(reply.begin(), reply.end()));
+        REQUIRE(*scpi.get_double("SENS:FREQ:STAR") == 2e9);
+    }
+
+    SECTION("prefix invalidation") {
+        scpi.invalidate_cache("SENS:FREQ");
+        REQUIRE(*scpi.get_int("SENS:SWE:POIN") == 401);
+        REQUIRE(transport_ptr->get_written_data().empty());
+    }
+}
+
+TEST_CASE("device_impl query with a transaction scope reuses arena memory", "[device][scpi][arena]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    vdl::scpi_adapter_t scpi(device);
+    REQUIRE(scpi.connect().has_value());
+
+    vdl::arena_t arena(512);
+    const vdl::byte_t* first = nullptr;
+    for (int i = 0; i < 3; ++i) {
+        vdl::transaction_scope_t scope(arena);
+        const std::string reply = "+1.250000E+00,+2.500000E+00\r\n";    // 超过短字符串缓冲区
+        transport_ptr->set_response(vdl::bytes_t(reply.begin(), reply.end()));
+
+        auto text = scpi.query("MEAS:VOLT?", scope);
+        REQUIRE(text.has_value());
+        REQUIRE(*text == "+1.250000E+00,+2.500000E+00");
+        REQUIRE(text->get_allocator().arena() == &arena);
+        if (i == 0) {
+            first = reinterpret_cast<const vdl::byte_t*>(text->data());
+        }
+        REQUIRE(reinterpret_cast<const vdl::byte_t*>(text->data()) == first);
+    }
+    REQUIRE(arena.block_count() == 1);
+
+    const vdl::bytes_t written = transport_ptr->get_written_data();
+    REQUIRE(std::string(written.begin(), written.end()) == "MEAS:VOLT?\nMEAS:VOLT?\nMEAS:VOLT?\n");
+}
+
+TEST_CASE("scpi_adapter_t typed queries parse the first field", "[device][scpi][arena]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    vdl::scpi_adapter_t scpi(device);
+    REQUIRE(scpi.connect().has_value());
+
+    auto respond = [transport_ptr](const std::string& reply) {
+        transport_ptr->set_response(vdl::bytes_t(reply.begin(), reply.end()));
+    };
+
+    respond("+1.5E+03,+7\n");
+    REQUIRE(*scpi.query_double("X?") == 1500.0);
+    respond(" +401 ,0\n");
+    REQUIRE(*scpi.query_int("X?") == 401);
+    respond("-12abc\n");
+    REQUIRE(*scpi.query_int("X?") == -12);
+    respond("FOO\n");
+    REQUIRE_FALSE(scpi.query_int("X?").has_value());
+    respond("99999999999\n");
+    REQUIRE_FALSE(scpi.query_int("X?").has_value());
+    respond("ON\n");
+    REQUIRE(*scpi.query_bool("X?"));
+    respond("a, b ,c,\n");
+    REQUIRE(*scpi.query_value("X?", 1) == "b");
+    respond("a, b ,c,\n");
+    REQUIRE_FALSE(scpi.query_value("X?", 3).has_value());
+}
+
+TEST_CASE("scpi_command_template_t reuses its header", "[device][scpi]") {
+    vdl::scpi_command_template_t tpl("SENS:FREQ:CW");
+
+    auto first = tpl.format(1e9);
+    REQUIRE(std::string(first.begin(), first.end()) == "SENS:FREQ:CW 1000000000\n");
+
+    auto second = tpl.format(2.5e-3);
+    REQUIRE(std::string(second.begin(), second.end()) == "SENS:FREQ:CW 0.0025\n");
+    REQUIRE(std::string(tpl.argument_begin(), tpl.argument_end()) == "0.0025");
+
+    auto keyword = tpl.format("MAX");
+    REQUIRE(std::string(keyword.begin(), keyword.end()) == "SENS:FREQ:CW MAX\n");
+
+    vdl::scpi_command_buffer_t<8> small;
+    small.append("SENS:FREQ:STAR ").append_double(1e9);
+    REQUIRE(small.overflow());
+}
+
+TEST_CASE("scpi_adapter_t send writes formatted template", "[device][scpi]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    vdl::scpi_adapter_t scpi(device);
+    REQUIRE(scpi.connect().has_value());
+    scpi.enable_shadow_cache(true);
+
+    vdl::scpi_command_template_t power("SOUR:POW");
+    REQUIRE(scpi.send(power, -10.5).has_value());
+    REQUIRE(scpi.send(power, 3).has_value());
+    REQUIRE(scpi.command("*WAI").has_value());
+
+    const vdl::bytes_t written = transport_ptr->get_written_data();
+    REQUIRE(std::string(written.begin(), written.end()) == "SOUR:POW -10.5\nSOUR:POW 3\n*WAI\n");
+    REQUIRE(*scpi.get_double("SOUR:POW") == 3.0);
+}
+
+TEST_CASE("scpi_adapter_t start_operation completes on service request", "[device][scpi][srq]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    transport_ptr->set_service_request_supported(true);
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    vdl::scpi_adapter_t scpi(device);
+    REQUIRE(scpi.connect().has_value());
+
+    const std::string replies = "+0\n+1\n";   // enable 清除残留事件，随后的 *ESR? 带 OPC 位
+    transport_ptr->set_response(vdl::bytes_t(replies.begin(), replies.end()));
+    REQUIRE(scpi.enable_opc_service_request().has_value());
+
+    auto done = scpi.start_operation("INIT:IMM", 2000);
+    REQUIRE(done.wait_for(std::chrono::milliseconds(20)) == std::future_status::timeout);
+
+    transport_ptr->raise_service_request();
+    REQUIRE(done.wait_for(std::chrono::seconds(2)) == std::future_status::ready);
+    REQUIRE(done.get().has_value());
+    REQUIRE(transport_ptr->status_poll_count() == 1);
+
+    const vdl::bytes_t written = transport_ptr->get_written_data();
+    REQUIRE(std::string(written.begin(), written.end()) ==
+            "*ESE 1;*SRE 32\n*ESR?\nINIT:IMM;*OPC\n*ESR?\n");
+}
+
+TEST_CASE("scpi_adapter_t wait_operation_complete polls ESR without SRQ", "[device][scpi][srq]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    vdl::scpi_adapter_t scpi(device);
+    REQUIRE(scpi.connect().has_value());
+
+    const std::string replies = "+0\n+32\n+33\n";
+    transport_ptr->set_response(vdl::bytes_t(replies.begin(), replies.end()));
+
+    auto done = scpi.start_operation("INIT:IMM", 2000, 1);
+    REQUIRE(done.get().has_value());
+
+    const vdl::bytes_t written = transport_ptr->get_written_data();
+    REQUIRE(std::string(written.begin(), written.end()) ==
+            "INIT:IMM;*OPC\n*ESR?\n*ESR?\n*ESR?\n");
+
+    // 操作一直未完成时超时
+    transport_ptr->enable_auto_response(vdl::bytes_t{'+', '0', '\n'});
+    auto timeout = scpi.wait_operation_complete(20, 1);
+    REQUIRE_FALSE(timeout.has_value());
+    REQUIRE(timeout.error().code() == vdl::error_code_t::timeout);
+}
+
+// ============================================================================
+// read_planner_t 测试
+// ============================================================================
+
+TEST_CASE("read_planner_t merges adjacent reads within limits", "[device][planner]") {
+    SECTION("adjacent and overlapping ranges") {
+        vdl::read_planner_t planner;
+        planner.add(0x03, 102, 2);
+        planner.add(0x03, 100, 2);
+        planner.add(0x03, 101, 1);
+        planner.add(0x03, 106, 1);
+
+        auto plan = planner.build();
+        REQUIRE(plan.commands().size() == 2);
+        REQUIRE(plan.commands()[0].address() == 100);
+        REQUIRE(plan.commands()[0].count() == 4);
+        REQUIRE(plan.commands()[1].address() == 106);
+        REQUIRE(plan.slots()[0].offset == 2);
+        REQUIRE(plan.slots()[2].offset == 1);
+        REQUIRE(plan.slots()[3].command == 1);
+    }
+
+    SECTION("gap and function code") {
+        vdl::read_planner_t planner(4);
+        planner.add(0x03, 100, 2);
+        planner.add(0x03, 106, 1);
+        planner.add(0x04, 102, 1);
+
+        auto plan = planner.build();
+        REQUIRE(plan.commands().size() == 2);
+        REQUIRE(plan.commands()[0].function_code() == 0x03);
+        REQUIRE(plan.commands()[0].count() == 7);
+        REQUIRE(plan.commands()[1].function_code() == 0x04);
+    }
+
+    SECTION("max count splits blocks and rejects oversized requests") {
+        vdl::read_planner_t planner = vdl::read_planner_t::modbus(10);
+        for (uint16_t i = 0; i < 20; ++i) {
+            planner.add(0x03, static_cast<uint16_t>(i * 10), 2);
+        }
+        size_t too_big = planner.add(0x03, 1000, 126);
+
+        auto plan = planner.build();
+        REQUIRE(plan.commands().size() == 2);
+        REQUIRE(plan.commands()[0].count() == 122);
+        REQUIRE(plan.commands()[1].address() == 130);
+        const size_t k_invalid = vdl::read_plan_t::k_invalid;
+        REQUIRE(plan.slots()[too_big].command == k_invalid);
+    }
+}
+
+TEST_CASE("read_plan_t slices merged responses per request", "[device][planner][modbus]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::modbus_tcp_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    auto planner = vdl::read_planner_t::modbus();
+    const size_t status = planner.add(0x03, 0, 1);
+    const size_t total = planner.add(0x03, 1, 2);
+    const size_t coils = planner.add(0x01, 8, 3);
+    const size_t invalid = planner.add(0x03, 10, 0);
+    const vdl::read_plan_t plan = planner.build();
+    REQUIRE(plan.commands().size() == 2);
+
+    // 功能码 0x01 的命令排在前面（事务号 1），寄存器读取为事务号 2
+    const vdl::bytes_t replies = {
+        0x00, 0x01, 0x00, 0x00, 0x00, 0x04, 0x01, 0x01, 0x01, 0x05,
+        0x00, 0x02, 0x00, 0x00, 0x00, 0x09, 0x01, 0x03, 0x06, 0x00, 0x01, 0x00, 0x02, 0x00, 0x03};
+
+    auto check = [&](const vdl::read_plan_result_t& values) {
+        REQUIRE(values.round_trips() == 2);
+        REQUIRE(values.as_uint16(status).value() == 1);
+        REQUIRE(values.as_uint32(total).value() == 0x00020003u);
+        REQUIRE(values.bytes(total).value().size() == 4);
+        REQUIRE(values.as_bool(coils, 0).value());
+        REQUIRE_FALSE(values.as_bool(coils, 1).value());
+        REQUIRE(values.as_bool(coils, 2).value());
+        REQUIRE_FALSE(values.as_bool(coils, 3).has_value());
+        REQUIRE_FALSE(values.as_uint16(status, 1).has_value());
+        REQUIRE(values.status(invalid).error().code() == vdl::error_code_t::invalid_argument);
+    };
+
+    SECTION("batch") {
+        transport_ptr->set_response(replies);
+        check(plan.execute(device));
+    }
+
+    SECTION("async") {
+        transport_ptr->set_response(replies);
+        check(plan.execute(device, vdl::read_mode_t::async));
+    }
+
+    SECTION("chunked") {
+        transport_ptr->set_response(replies);
+        check(plan.execute(device, vdl::read_mode_t::chunked));
+    }
+}
+
+// ============================================================================
+// 分阶段延迟指标
+// ============================================================================
+
+TEST_CASE("latency_histogram_t buckets bound the relative error", "[device][metrics]") {
+    const uint64_t values[] = {0, 1, 7, 8, 15, 16, 17, 100, 1000, 12345, 999999, 123456789};
+    for (uint64_t v : values) {
+        const size_t bucket = vdl::latency_histogram_t::bucket_of(v);
+        const uint64_t upper = vdl::latency_histogram_t::bucket_upper(bucket);
+        REQUIRE(upper >= v);
+        REQUIRE(static_cast<double>(upper - v) <= static_cast<double>(v) * 0.125 + 0.5);
+        if (bucket > 0) {
+            REQUIRE(vdl::latency_histogram_t::bucket_upper(bucket - 1) < v);
+        }
+    }
+
+    vdl::latency_histogram_t histogram;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        histogram.record(i * 1000);
+    }
+    const vdl::latency_summary_t summary = histogram.summary();
+    REQUIRE(summary.count == 1000);
+    REQUIRE(summary.mean_ns == 500500);
+    REQUIRE(summary.p50_ns >= 500000);
+    REQUIRE(summary.p50_ns <= 562500);
+    REQUIRE(summary.p99_ns >= 990000);
+    REQUIRE(summary.p999_ns >= 999000);
+    REQUIRE(summary.max_ns >= 1000000);
+}
+
+TEST_CASE("device_impl metrics record execute phases per function code", "[device][metrics]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* mock = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    vdl::binary_codec_t helper;
+    vdl::command_t read_cmd;
+    read_cmd.set_function_code(0x03).set_data({0x00, 0x01});
+    vdl::command_t write_cmd;
+    write_cmd.set_function_code(0x06).set_data({0x00, 0x01, 0x00, 0x02});
+
+    for (int i = 0; i < 3; ++i) {
+        mock->set_response(helper.encode(read_cmd).value());
+        REQUIRE(device.execute(read_cmd).has_value());
+    }
+    mock->set_response(helper.encode(write_cmd).value());
+    REQUIRE(device.execute(write_cmd).has_value());
+
+    const std::string reply = "+1.0\n";
+    mock->set_response(vdl::bytes_t(reply.begin(), reply.end()));
+    REQUIRE(device.query("MEAS?").has_value());
+
+    const vdl::device_metrics_t metrics = device.metrics();
+    REQUIRE(metrics.executions == 4);
+    REQUIRE(metrics.queries == 1);
+    REQUIRE(metrics.failures == 0);
+    REQUIRE(metrics.retries == 0);
+    REQUIRE(metrics.phase(vdl::execute_phase_t::encode).count == 4);
+    REQUIRE(metrics.phase(vdl::execute_phase_t::write).count == 5);
+    REQUIRE(metrics.phase(vdl::execute_phase_t::first_byte).count == 5);
+    REQUIRE(metrics.phase(vdl::execute_phase_t::receive).count == 5);
+    REQUIRE(metrics.phase(vdl::execute_phase_t::total).count == 5);
+    REQUIRE(metrics.phase(vdl::execute_phase_t::total).p99_ns >=
+            metrics.phase(vdl::execute_phase_t::total).p50_ns);
+
+    REQUIRE(metrics.functions.size() == 2);
+    REQUIRE(metrics.function(0x03) != nullptr);
+    REQUIRE(metrics.function(0x03)->count == 3);
+    REQUIRE(metrics.function(0x06)->count == 1);
+    REQUIRE(metrics.function(0x04) == nullptr);
+
+    device.reset_metrics();
+    REQUIRE(device.metrics().executions == 0);
+    REQUIRE(device.metrics().phase(vdl::execute_phase_t::total).count == 0);
+}
+
+TEST_CASE("device_impl metrics count retries and reconnects", "[device][metrics]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* mock = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+
+    vdl::device_config_t cfg;
+    cfg.max_retries = 2;
+    cfg.retry_delay = 0;
+    cfg.reconnect_delay = 0;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x03).set_data({0x01});
+
+    // 第一次写失败，重试成功
+    mock->set_fail_write_times(1);
+    mock->set_response(vdl::binary_codec_t().encode(cmd).value());
+    REQUIRE(device.execute(cmd).has_value());
+
+    // 写入一直失败：重试用尽后触发重连
+    mock->set_fail_write(true);
+    REQUIRE_FALSE(device.execute(cmd).has_value());
+    mock->set_fail_write(false);
+
+    const vdl::device_metrics_t metrics = device.metrics();
+    REQUIRE(metrics.executions == 2);
+    REQUIRE(metrics.failures == 1);
+    REQUIRE(metrics.retries == 2);
+    REQUIRE(metrics.phase(vdl::execute_phase_t::retry_wait).count == 2);
+    REQUIRE(metrics.phase(vdl::execute_phase_t::total).count == 1);
+    REQUIRE(metrics.reconnect_attempts >= 1);
+    REQUIRE(metrics.reconnects + metrics.reconnect_failures == 1);
+    REQUIRE(metrics.phase(vdl::execute_phase_t::reconnect).count == 1);
+}
+
+// ============================================================================
+// 执行观察者
+// ============================================================================
+
+namespace {
+
+class recording_observer_t : public vdl::i_execution_observer_t {
+public:
+    void on_span_begin(vdl::execution_span_t& span) override {
+        span.user_data = this;
+        ++begins;
+    }
+
+    void on_span_end(const vdl::execution_span_t& span) override {
+        REQUIRE(span.user_data == this);
+        spans.push_back(span);
+    }
+
+    int begins = 0;
+    std::vector<vdl::execution_span_t> spans;
+};
+
+}  // namespace
+
+TEST_CASE("device_impl execution observer sees execute and query spans", "[device][observer]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* mock = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    auto observer = std::make_shared<recording_observer_t>();
+    device.set_execution_observer(observer);
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x03).set_data({0x00, 0x01}).set_tag(vdl::tag_t("poll"));
+    const vdl::bytes_t frame = vdl::binary_codec_t().encode(cmd).value();
+    mock->set_response(frame);
+    REQUIRE(device.execute(cmd).has_value());
+
+    const std::string reply = "+1.0\n";
+    mock->set_response(vdl::bytes_t(reply.begin(), reply.end()));
+    REQUIRE(device.query("MEAS?").has_value());
+
+    REQUIRE(observer->begins == 2);
+    REQUIRE(observer->spans.size() == 2);
+
+    const vdl::execution_span_t& exec = observer->spans[0];
+    REQUIRE(exec.kind == vdl::span_kind_t::execute);
+    REQUIRE(exec.tag == vdl::tag_t("poll"));
+    REQUIRE(exec.function_code == 0x03);
+    REQUIRE(exec.attempt == 1);
+    REQUIRE(exec.bytes_sent == frame.size());
+    REQUIRE(exec.bytes_received == frame.size());
+    REQUIRE(exec.ok());
+
+    const vdl::execution_span_t& query = observer->spans[1];
+    REQUIRE(query.kind == vdl::span_kind_t::query);
+    REQUIRE(query.bytes_sent == 6);
+    REQUIRE(query.bytes_received == reply.size());
+    REQUIRE(query.ok());
+
+    // 卸下后不再回调
+    device.set_execution_observer(nullptr);
+    mock->set_response(frame);
+    REQUIRE(device.execute(cmd).has_value());
+    REQUIRE(observer->spans.size() == 2);
+}
+
+TEST_CASE("device_impl execution observer reports retries, failures and reconnects",
+          "[device][observer]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* mock = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+
+    vdl::device_config_t cfg;
+    cfg.max_retries = 2;
+    cfg.retry_delay = 0;
+    cfg.reconnect_delay = 0;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    auto observer = std::make_shared<recording_observer_t>();
+    device.set_execution_observer(observer);
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x03).set_data({0x01});
+
+    mock->set_fail_read_times(1);
+    mock->set_response(vdl::binary_codec_t().encode(cmd).value());
+    REQUIRE(device.execute(cmd).has_value());
+
+    mock->set_fail_write(true);
+    REQUIRE_FALSE(device.execute(cmd).has_value());
+    mock->set_fail_write(false);
+
+    // 重连区间嵌套在失败的 execute 区间内，先结束
+    REQUIRE(observer->spans.size() == 3);
+    REQUIRE(observer->spans[0].attempt == 2);
+    REQUIRE(observer->spans[0].ok());
+
+    REQUIRE(observer->spans[1].kind == vdl::span_kind_t::reconnect);
+    REQUIRE(observer->spans[1].attempt >= 1);
+
+    REQUIRE(observer->spans[2].kind == vdl::span_kind_t::execute);
+    REQUIRE(observer->spans[2].attempt == 2);
+    REQUIRE_FALSE(observer->spans[2].ok());
+    REQUIRE(observer->spans[2].outcome.code() == vdl::error_code_t::write_failed);
+}
+
+TEST_CASE("device_impl execution observer sampling", "[device][observer]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* mock = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    auto observer = std::make_shared<recording_observer_t>();
+    device.set_execution_observer(observer, 3);
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x03).set_data({0x01});
+    const vdl::bytes_t frame = vdl::binary_codec_t().encode(cmd).value();
+    for (int i = 0; i < 7; ++i) {
+        mock->set_response(frame);
+        REQUIRE(device.execute(cmd).has_value());
+    }
+
+    // 第 1、4、7 次被观察
+    REQUIRE(observer->spans.size() == 3);
+    REQUIRE(observer->begins == 3);
+}
+
+// ============================================================================
+// 设备组
+// ============================================================================
+
+namespace {
+
+std::unique_ptr<vdl::device_impl_t> make_sim_echo_device(uint32_t latency_us) {
+    vdl::sim_link_config_t link;
+    link.latency_us = latency_us;
+    auto transport = vdl::make_unique<vdl::sim_transport_t>(link);
+    transport->set_responder(vdl::make_codec_responder(std::make_shared<vdl::binary_codec_t>(),
+        [](const vdl::response_t& request) -> vdl::optional_t<vdl::command_t> {
+            vdl::command_t reply;
+            reply.set_function_code(request.function_code()).set_data(request.data());
+            return reply;
+        }));
+    auto device = vdl::make_unique<vdl::device_impl_t>(std::move(transport),
+                                                       vdl::make_unique<vdl::binary_codec_t>());
+    vdl::device_config_t cfg;
+    cfg.max_retries = 1;
+    cfg.auto_reconnect = false;
+    device->set_config(cfg);
+    device->connect();
+    return device;
+}
+
+}  // namespace
+
+TEST_CASE("device_group_t gather runs devices in parallel", "[device][group][sim]") {
+    std::vector<std::unique_ptr<vdl::device_impl_t>> devices;
+    std::vector<vdl::i_device_t*> members;
+    for (int i = 0; i < 4; ++i) {
+        devices.push_back(make_sim_echo_device(20000));   // 往返 40 ms
+        members.push_back(devices.back().get());
+    }
+    vdl::thread_pool_t pool(4);
+    vdl::device_group_t group(members, pool);
+    REQUIRE(group.size() == 4);
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x03).set_data({0x01, 0x02});
+
+    // 四台设备同时往返，总耗时接近一次往返而不是四次
+    const auto start = std::chrono::steady_clock::now();
+    vdl::device_group_t::results_t results = group.gather(cmd);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(results.size() == 4);
+    for (const auto& result : results) {
+        REQUIRE(result.has_value());
+        REQUIRE(result->function_code() == 0x03);
+    }
+    REQUIRE(elapsed < std::chrono::milliseconds(120));
+
+    REQUIRE(group.broadcast(cmd).has_value());
+
+    auto all = group.gather_all(cmd);
+    REQUIRE(all.has_value());
+    REQUIRE(all->size() == 4);
+
+    std::vector<vdl::command_t> commands(4);
+    for (uint8_t i = 0; i < 4; ++i) {
+        commands[i].set_function_code(static_cast<uint8_t>(0x10 + i));
+    }
+    results = group.scatter(commands);
+    for (uint8_t i = 0; i < 4; ++i) {
+        REQUIRE(results[i].has_value());
+        REQUIRE(results[i]->function_code() == 0x10 + i);
+    }
+
+    commands.pop_back();
+    results = group.scatter(commands);
+    REQUIRE(results.size() == 4);
+    REQUIRE(results[0].error().code() == vdl::error_code_t::invalid_argument);
+}
+
+TEST_CASE("device_group_t deadline returns partial results", "[device][group][sim]") {
+    std::vector<std::unique_ptr<vdl::device_impl_t>> devices;
+    devices.push_back(make_sim_echo_device(1000));
+    devices.push_back(make_sim_echo_device(1000));
+    devices.push_back(make_sim_echo_device(150000));   // 往返 300 ms
+    // 线程池在设备之前析构：截止时间后仍在执行的调用先结束
+    vdl::thread_pool_t pool(3);
+    vdl::device_group_t group({devices[0].get(), devices[1].get(), devices[2].get()}, pool);
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x03);
+
+    const auto start = std::chrono::steady_clock::now();
+    vdl::device_group_t::results_t results = group.gather(cmd, 100);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(results.size() == 3);
+    REQUIRE(results[0].has_value());
+    REQUIRE(results[1].has_value());
+    REQUIRE_FALSE(results[2].has_value());
+    REQUIRE(results[2].error().code() == vdl::error_code_t::timeout);
+    REQUIRE(elapsed < std::chrono::milliseconds(250));
+
+    // 第三台设备超时后已断开，全部成功的汇集失败
+    auto all = group.gather_all(cmd, 100);
+    REQUIRE_FALSE(all.has_value());
+}
+
+// ============================================================================
+// trace_file_writer_t / trace_file_reader_t 测试
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief 测试用临时迹线文件（析构时删除）
+ */
+class temp_trace_path_t {
+public:
+    temp_trace_path_t() {
+        char pattern[] = "/tmp/vdl-trace-XXXXXX";
+        const int fd = ::mkstemp(pattern);
+        REQUIRE(fd >= 0);
+        ::close(fd);
+        m_path = pattern;
+    }
+
+    ~temp_trace_path_t() {
+        ::unlink(m_path.c_str());
+    }
+
+    const std::string& path() const {
+        return m_path;
+    }
+
+private:
+    std::string m_path;
+};
+
+}  // namespace
+
+TEST_CASE("trace_file round-trips sweeps through the mapping", "[device][trace_file]") {
+    temp_trace_path_t temp;
+    vdl::trace_file_config_t config;
+    config.path = temp.path();
+    config.points = 3;
+    config.sample = vdl::trace_sample_t::complex64;
+    config.capacity = 4;
+    config.metadata = "S21 IFBW 1kHz";
+
+    std::vector<double> frequencies{1e9, 2e9, 3e9};
+    vdl::trace_file_writer_t writer;
+    REQUIRE(writer.open(config, vdl::span_t<const double>(frequencies.data(),
+                                                          frequencies.size())).has_value());
+    REQUIRE(writer.values_per_sweep() == 6);
+
+    std::vector<double> sweep{1, -1, 2, -2, 3, -3};
+    REQUIRE(writer.append(vdl::span_t<const double>(sweep.data(), sweep.size())).has_value());
+
+    vdl::trace_file_reader_t reader;
+    REQUIRE(reader.open(temp.path()).has_value());
+    REQUIRE(reader.points() == 3);
+    REQUIRE(reader.sample() == vdl::trace_sample_t::complex64);
+    REQUIRE(reader.metadata() == "S21 IFBW 1kHz");
+    REQUIRE(std::vector<double>(reader.frequencies().begin(), reader.frequencies().end()) ==
+            frequencies);
+    REQUIRE(reader.committed() == 1);
+
+    // 读取方看到写入方随后提交的扫描
+    auto slot = writer.begin_sweep();
+    REQUIRE(slot.has_value());
+    REQUIRE(slot->sequence == 1);
+    auto parsed = vdl::scpi_adapter_t::parse_data_doubles("4,-4,5,-5", slot->values);
+    REQUIRE(parsed.has_value());
+    REQUIRE(reader.committed() == 1);
+    REQUIRE(writer.commit_sweep(*parsed).has_value());
+    REQUIRE(reader.committed() == 2);
+
+    auto view = reader.sweep(1);
+    REQUIRE(view.has_value());
+    REQUIRE(std::vector<double>(view->values.begin(), view->values.end()) ==
+            std::vector<double>{4, -4, 5, -5});
+    REQUIRE(reader.still_valid(*view));
+
+    std::vector<double> copy(6);
+    auto copied = reader.copy_sweep(0, vdl::span_t<double>(copy));
+    REQUIRE(copied.has_value());
+    REQUIRE(*copied == 6);
+    REQUIRE(copy == sweep);
+
+    REQUIRE_FALSE(reader.sweep(2).has_value());
+
+    vdl::trace_file_reader_t missing;
+    auto not_found = missing.open(temp.path() + ".missing");
+    REQUIRE_FALSE(not_found.has_value());
+    REQUIRE(not_found.error().code() == vdl::error_code_t::file_not_found);
+}
+
+TEST_CASE("trace_file capacity and overwrite mode", "[device][trace_file]") {
+    temp_trace_path_t temp;
+    vdl::trace_file_config_t config;
+    config.path = temp.path();
+    config.points = 2;
+    config.sample = vdl::trace_sample_t::real64;
+    config.capacity = 2;
+
+    std::vector<double> sweep{0, 0};
+    auto values = vdl::span_t<const double>(sweep.data(), sweep.size());
+
+    SECTION("fixed capacity rejects further sweeps") {
+        vdl::trace_file_writer_t writer;
+        REQUIRE(writer.open(config, vdl::span_t<const double>()).has_value());
+        REQUIRE(writer.append(values).has_value());
+        REQUIRE(writer.append(values).has_value());
+        auto full = writer.append(values);
+        REQUIRE_FALSE(full.has_value());
+        REQUIRE(full.error().code() == vdl::error_code_t::out_of_range);
+    }
+
+    SECTION("overwrite keeps the newest sweeps") {
+        config.overwrite = true;
+        vdl::trace_file_writer_t writer;
+        REQUIRE(writer.open(config, vdl::span_t<const double>()).has_value());
+        for (int i = 0; i < 5; ++i) {
+            sweep[0] = i;
+            REQUIRE(writer.append(values).has_value());
+        }
+        REQUIRE(writer.flush().has_value());
+
+        vdl::trace_file_reader_t reader;
+        REQUIRE(reader.open(temp.path()).has_value());
+        REQUIRE(reader.committed() == 5);
+        REQUIRE(reader.first_available() == 3);
+        REQUIRE_FALSE(reader.sweep(2).has_value());
+
+        auto view = reader.sweep(4);
+        REQUIRE(view.has_value());
+        REQUIRE(view->values[0] == 4);
+        REQUIRE(reader.still_valid(*view));
+
+        // 下一次写入覆盖同一槽位后视图失效
+        sweep[0] = 5;
+        REQUIRE(writer.append(values).has_value());
+        auto old_view = reader.sweep(3);
+        REQUIRE_FALSE(old_view.has_value());
+        sweep[0] = 6;
+        REQUIRE(writer.append(values).has_value());
+        REQUIRE_FALSE(reader.still_valid(*view));
+    }
+}
+
+TEST_CASE("scpi_adapter_t query_real64_array reads into a trace record", "[device][trace_file]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    vdl::scpi_adapter_t scpi(device);
+    REQUIRE(scpi.connect().has_value());
+
+    temp_trace_path_t temp;
+    vdl::trace_file_config_t config;
+    config.path = temp.path();
+    config.points = 1;
+    config.sample = vdl::trace_sample_t::complex64;
+    config.capacity = 1;
+    vdl::trace_file_writer_t writer;
+    REQUIRE(writer.open(config, vdl::span_t<const double>()).has_value());
+
+    // 仪器默认 FORM:BORD NORM（大端），读入后就地转换
+    const double values[] = {0.5, -0.25};
+    vdl::bytes_t payload;
+    for (double v : values) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &v, sizeof(bits));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            payload.push_back(static_cast<vdl::byte_t>(bits >> shift));
+        }
+    }
+    transport_ptr->set_response(make_block(payload, "\n"));
+
+    auto slot = writer.begin_sweep();
+    REQUIRE(slot.has_value());
+    auto count = scpi.query_real64_array("CALC:DATA? SDAT", slot->values);
+    REQUIRE(count.has_value());
+    REQUIRE(*count == 2);
+    REQUIRE(writer.commit_sweep(*count).has_value());
+
+    vdl::trace_file_reader_t reader;
+    REQUIRE(reader.open(temp.path()).has_value());
+    auto view = reader.sweep(0);
+    REQUIRE(view.has_value());
+    REQUIRE(view->values[0] == 0.5);
+    REQUIRE(view->values[1] == -0.25);
+
+    // 块比记录长
+    vdl::bytes_t longer(3 * sizeof(double), 0);
+    transport_ptr->set_response(make_block(longer, "\n"));
+    double small[2];
+    auto too_long = scpi.query_real64_array("CALC:DATA? SDAT", vdl::span_t<double>(small, 2));
+    REQUIRE_FALSE(too_long.has_value());
+    REQUIRE(too_long.error().code() == vdl::error_code_t::invalid_size);
+}
+TEST_CASE("parse_idn splits *IDN? fields", "[device][group]") {
+    const vdl::device_info_t info = vdl::parse_idn("Keysight Technologies, E5071C ,MY46100123,A.11.10, build 7\r\n");
+    REQUIRE(info.manufacturer == "Keysight Technologies");
+    REQUIRE(info.model == "E5071C");
+    REQUIRE(info.serial_number == "MY46100123");
+    REQUIRE(info.firmware_version == "A.11.10, build 7");
+
+    const vdl::device_info_t partial = vdl::parse_idn("ACME,PSU-1");
+    REQUIRE(partial.model == "PSU-1");
+    REQUIRE(partial.serial_number.empty());
+}
+
+TEST_CASE("device_group_t connect_all uses the identity cache", "[device][group][sim]") {
+    std::vector<std::unique_ptr<vdl::device_impl_t>> devices;
+    std::map<vdl::i_device_t*, std::string> serials;
+    vdl::thread_pool_t pool(4);
+    vdl::device_group_t group({}, pool);
+    for (int i = 0; i < 4; ++i) {
+        devices.push_back(make_sim_echo_device(20000));   // 往返 40 ms
+        devices.back()->disconnect();
+        serials[devices.back().get()] = "SN" + std::to_string(i);
+        group.add(*devices.back(), "SIM::" + std::to_string(i));
+    }
+
+    std::atomic<int> identify_calls{0};
+    std::mutex serials_mutex;
+    auto identify = [&](vdl::i_device_t& device,
+                        vdl::milliseconds_t timeout_ms) -> vdl::result_t<vdl::device_info_t> {
+        ++identify_calls;
+        vdl::command_t cmd;
+        cmd.set_function_code(0x01);
+        auto response = timeout_ms > 0 ? device.execute(cmd, timeout_ms) : device.execute(cmd);
+        if (!response) {
+            return vdl::make_unexpected(response.error());
+        }
+        vdl::device_info_t info;
+        info.manufacturer = "ACME";
+        info.model = "SIM-1";
+        std::lock_guard<std::mutex> lock(serials_mutex);
+        info.serial_number = serials[&device];
+        return info;
+    };
+
+    vdl::device_identity_cache_t cache;
+    group.set_identity_cache(&cache, identify);
+    std::vector<std::pair<size_t, std::string>> changed;
+    group.set_identity_callback([&](size_t index, const vdl::device_info_t& info) {
+        std::lock_guard<std::mutex> lock(serials_mutex);
+        changed.push_back(std::make_pair(index, info.serial_number));
+    });
+
+    // 首次启动：并行连接并查询身份
+    vdl::device_group_t::connect_results_t results = group.connect_all(2000);
+    REQUIRE(results.size() == 4);
+    for (size_t i = 0; i < 4; ++i) {
+        REQUIRE(results[i].has_value());
+        REQUIRE(group.device(i).is_connected());
+        REQUIRE(group.info(i).serial_number == "SN" + std::to_string(i));
+    }
+    REQUIRE(identify_calls == 4);
+    REQUIRE(cache.size() == 4);
+    REQUIRE(group.wait_identified(1000));
+
+    // 再次启动：身份取自缓存，连接返回后在后台校验
+    group.disconnect_all();
+    {
+        std::lock_guard<std::mutex> lock(serials_mutex);
+        serials[devices[2].get()] = "SN2-new";
+    }
+    results = group.connect_all(2000);
+    for (const auto& result : results) {
+        REQUIRE(result.has_value());
+    }
+    REQUIRE(group.info(0).serial_number == "SN0");
+    REQUIRE(group.wait_identified(1000));
+    REQUIRE(identify_calls == 8);
+    REQUIRE(changed.size() == 1);
+    REQUIRE(changed[0].first == 2);
+    REQUIRE(changed[0].second == "SN2-new");
+    REQUIRE(group.info(2).serial_number == "SN2-new");
+    REQUIRE(cache.find("SIM::2")->serial_number == "SN2-new");
+
+    // 缓存文件往返
+    temp_trace_path_t temp;
+    REQUIRE(cache.save(temp.path()).has_value());
+    vdl::device_identity_cache_t loaded;
+    auto count = loaded.load(temp.path());
+    REQUIRE(count.has_value());
+    REQUIRE(*count == 4);
+    REQUIRE(loaded.find("SIM::3")->serial_number == "SN3");
+    REQUIRE(loaded.find("SIM::3")->model == "SIM-1");
+    REQUIRE_FALSE(loaded.find("SIM::9").has_value());
+
+    auto missing = loaded.load(temp.path() + ".missing");
+    REQUIRE_FALSE(missing.has_value());
+    REQUIRE(missing.error().code() == vdl::error_code_t::file_not_found);
+}
+
+TEST_CASE("device_group_guard_t disconnects only what it connected", "[device][group][sim]") {
+    std::vector<std::unique_ptr<vdl::device_impl_t>> devices;
+    for (int i = 0; i < 3; ++i) {
+        devices.push_back(make_sim_echo_device(1000));
+    }
+    devices[0]->disconnect();
+    devices[1]->disconnect();
+    vdl::thread_pool_t pool(3);
+    vdl::device_group_t group({devices[0].get(), devices[1].get(), devices[2].get()}, pool);
+
+    {
+        vdl::device_group_guard_t guard(group, 1000);
+        REQUIRE_FALSE(guard.has_error());
+        REQUIRE(guard.results().size() == 3);
+        for (auto& device : devices) {
+            REQUIRE(device->is_connected());
+        }
+    }
+    REQUIRE_FALSE(devices[0]->is_connected());
+    REQUIRE_FALSE(devices[1]->is_connected());
+    REQUIRE(devices[2]->is_connected());
+
+    devices[0]->disconnect();
+    {
+        vdl::device_group_guard_t guard(group);
+        guard.release();
+    }
+    REQUIRE(devices[0]->is_connected());
+}
+
+// ============================================================================
+// 命令优先级
+// ============================================================================
+
+TEST_CASE("device_impl control commands overtake a chunked bulk transfer", "[device][priority][sim]") {
+    vdl::sim_link_config_t link;
+    link.latency_us = 10000;   // 往返 20 ms
+    auto transport = vdl::make_unique<vdl::sim_transport_t>(link);
+    std::mutex order_mutex;
+    std::vector<uint8_t> order;
+    transport->set_responder(vdl::make_codec_responder(std::make_shared<vdl::binary_codec_t>(),
+        [&](const vdl::response_t& request) -> vdl::optional_t<vdl::command_t> {
+            {
+                std::lock_guard<std::mutex> lock(order_mutex);
+                order.push_back(request.function_code());
+            }
+            vdl::command_t reply;
+            reply.set_function_code(request.function_code());
+            return reply;
+        }));
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    vdl::command_t chunk;
+    chunk.set_function_code(0x20);
+    std::atomic<bool> bulk_started{false};
+    vdl::result_t<void> bulk_result = vdl::make_ok();
+    std::thread bulk([&] {
+        bulk_result = vdl::for_each_chunk(6, [&](size_t) -> vdl::result_t<void> {
+            bulk_started = true;
+            auto response = device.execute(chunk);
+            if (!response) {
+                return vdl::make_error_void(response.error());
+            }
+            return vdl::make_ok();
+        });
+    });
+
+    while (!bulk_started) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    {
+        vdl::command_priority_scope_t priority(vdl::command_priority_t::control);
+        vdl::command_t off;
+        off.set_function_code(0x01);
+        REQUIRE(device.execute(off).has_value());
+    }
+    bulk.join();
+    REQUIRE(bulk_result.has_value());
+
+    // 控制命令只等了正在进行的一块
+    std::lock_guard<std::mutex> lock(order_mutex);
+    REQUIRE(order.size() == 7);
+    const size_t position = static_cast<size_t>(
+        std::find(order.begin(), order.end(), 0x01) - order.begin());
+    REQUIRE(position <= 2);
+
+    const vdl::device_metrics_t metrics = device.metrics();
+    const vdl::lock_wait_stats_t& control = metrics.queue(vdl::command_priority_t::control);
+    REQUIRE(control.waits == 1);
+    REQUIRE(control.waiting == 0);
+    REQUIRE(control.max_wait_ns > 0);
+    REQUIRE(control.max_wait_ns < 40000000u);
+    REQUIRE(metrics.queue(vdl::command_priority_t::normal).waits == 0);
+
+    device.reset_metrics();
+    REQUIRE(device.metrics().queue(vdl::command_priority_t::control).waits == 0);
+}
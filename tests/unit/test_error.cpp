@@ -90,6 +90,37 @@ TEST_CASE("error_t with_context", "[core][error]") {
     REQUIRE(err.context() == "in file A <- at line 10");
 }
 
+TEST_CASE("error_t keeps static messages by pointer", "[core][error]") {
+    static const char* const k_message = "Read timeout";
+    vdl::error_t err(vdl::error_code_t::timeout, k_message);
+    REQUIRE(err.message().c_str() == k_message);
+
+    vdl::error_t copy = err;
+    REQUIRE(copy.message().c_str() == k_message);
+    REQUIRE(copy.context().empty());
+
+    // 错误结果保持紧凑
+    REQUIRE(sizeof(vdl::error_t) <= 3 * sizeof(void*));
+    REQUIRE(sizeof(vdl::result_t<size_t>) <= 4 * sizeof(void*));
+}
+
+TEST_CASE("error_t context is copy-on-write", "[core][error]") {
+    vdl::error_t err(vdl::error_code_t::read_failed, std::string("dynamic ") + "message");
+    err.with_context("first");
+
+    vdl::error_t copy = err;
+    REQUIRE(copy.context().c_str() == err.context().c_str());   // 共享详情
+
+    copy.with_context("second");
+    REQUIRE(err.context() == "first");
+    REQUIRE(copy.context() == "first <- second");
+    REQUIRE(copy.message() == "dynamic message");
+
+    vdl::error_t moved = std::move(copy);
+    REQUIRE(moved.context() == "first <- second");
+    REQUIRE(moved.to_string() == "read_failed(1007): dynamic message [first <- second]");
+}
+
 TEST_CASE("error_t to_string", "[core][error]") {
     vdl::error_t err(vdl::error_code_t::timeout, "Operation timed out");
     auto str = err.to_string();
@@ -0,0 +1,180 @@
+/**
+ * @file test_fair_mutex.cpp
+ * @brief 测试 fair_mutex_t
+ */
+
+#include <catch.hpp>
+#include <vdl/core/fair_mutex.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// fair_mutex_t 测试
+// ============================================================================
+
+TEST_CASE("fair_mutex_t lock and unlock", "[core][fair_mutex]") {
+    vdl::fair_mutex_t mutex;
+
+    REQUIRE_FALSE(mutex.is_locked());
+    mutex.lock();
+    REQUIRE(mutex.is_locked());
+    REQUIRE(mutex.owned_by_current_thread());
+    mutex.unlock();
+    REQUIRE_FALSE(mutex.is_locked());
+    REQUIRE_FALSE(mutex.owned_by_current_thread());
+}
+
+TEST_CASE("fair_mutex_t is recursive", "[core][fair_mutex]") {
+    vdl::fair_mutex_t mutex;
+
+    mutex.lock();
+    REQUIRE(mutex.try_lock());
+    {
+        std::lock_guard<vdl::fair_mutex_t> guard(mutex);
+        REQUIRE(mutex.is_locked());
+    }
+    mutex.unlock();
+    REQUIRE(mutex.is_locked());
+    mutex.unlock();
+    REQUIRE_FALSE(mutex.is_locked());
+}
+
+TEST_CASE("fair_mutex_t try_lock fails when held by another thread", "[core][fair_mutex]") {
+    vdl::fair_mutex_t mutex;
+    mutex.lock();
+
+    bool try_result = true;
+    bool timed_result = true;
+    std::thread other([&]() {
+        try_result = mutex.try_lock();
+        timed_result = mutex.try_lock_for(20);
+    });
+    other.join();
+
+    REQUIRE_FALSE(try_result);
+    REQUIRE_FALSE(timed_result);
+    mutex.unlock();
+}
+
+TEST_CASE("fair_mutex_t try_lock_for succeeds when released in time", "[core][fair_mutex]") {
+    vdl::fair_mutex_t mutex;
+    mutex.lock();
+
+    std::atomic<bool> acquired{false};
+    std::thread other([&]() {
+        if (mutex.try_lock_for(2000)) {
+            acquired.store(true);
+            mutex.unlock();
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    mutex.unlock();
+    other.join();
+
+    REQUIRE(acquired.load());
+    REQUIRE_FALSE(mutex.is_locked());
+}
+
+TEST_CASE("fair_mutex_t hands off in FIFO order", "[core][fair_mutex]") {
+    vdl::fair_mutex_t mutex;
+    mutex.lock();
+
+    std::mutex order_mutex;
+    std::vector<int> order;
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&, i]() {
+            std::lock_guard<vdl::fair_mutex_t> guard(mutex);
+            std::lock_guard<std::mutex> order_guard(order_mutex);
+            order.push_back(i);
+        });
+        // 保证按顺序进入等待队列
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    mutex.unlock();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    REQUIRE(order == std::vector<int>({0, 1, 2, 3}));
+}
+
+TEST_CASE("fair_mutex_t hands off by priority, FIFO within a level", "[core][fair_mutex]") {
+    vdl::fair_mutex_t mutex;
+    mutex.lock();
+
+    std::mutex order_mutex;
+    std::vector<int> order;
+    std::vector<std::thread> threads;
+
+    // 依次以优先级 3、2、2、0 排队
+    const uint8_t priorities[] = {3, 2, 2, 0};
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&, i]() {
+            vdl::lock_priority_scope_t scope(priorities[i]);
+            std::lock_guard<vdl::fair_mutex_t> guard(mutex);
+            std::lock_guard<std::mutex> order_guard(order_mutex);
+            order.push_back(i);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    REQUIRE(mutex.wait_stats(2).waiting == 2);
+    REQUIRE(mutex.wait_stats(0).waiting == 1);
+
+    mutex.unlock();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    REQUIRE(order == std::vector<int>({3, 1, 2, 0}));
+    const vdl::lock_wait_stats_t stats = mutex.wait_stats(3);
+    REQUIRE(stats.waiting == 0);
+    REQUIRE(stats.waits == 1);
+    REQUIRE(stats.max_wait_ns >= 60000000u);
+    REQUIRE(mutex.wait_stats(2).waits == 2);
+
+    mutex.reset_wait_stats();
+    REQUIRE(mutex.wait_stats(3).waits == 0);
+}
+
+TEST_CASE("lock_priority_scope_t nests and restores", "[core][fair_mutex]") {
+    REQUIRE(vdl::current_lock_priority() == vdl::k_default_lock_priority);
+    {
+        vdl::lock_priority_scope_t outer(0);
+        REQUIRE(vdl::current_lock_priority() == 0);
+        {
+            vdl::lock_priority_scope_t inner(200);    // 超出范围取最低优先级
+            REQUIRE(vdl::current_lock_priority() == vdl::k_lock_priority_levels - 1);
+        }
+        REQUIRE(vdl::current_lock_priority() == 0);
+    }
+    REQUIRE(vdl::current_lock_priority() == vdl::k_default_lock_priority);
+}
+
+TEST_CASE("fair_mutex_t serializes concurrent increments", "[core][fair_mutex]") {
+    vdl::fair_mutex_t mutex;
+    int counter = 0;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 1000; ++i) {
+                std::lock_guard<vdl::fair_mutex_t> guard(mutex);
+                ++counter;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    REQUIRE(counter == 4000);
+}
@@ -7,15 +7,23 @@
 #include <vdl/heartbeat/heartbeat_config.hpp>
 #include <vdl/heartbeat/heartbeat_strategy.hpp>
 #include <vdl/heartbeat/heartbeat_runner.hpp>
+#include <vdl/heartbeat/heartbeat_scheduler.hpp>
+#include <vdl/heartbeat/rtt_estimator.hpp>
 #include <vdl/heartbeat/strategies/ping_heartbeat.hpp>
 #include <vdl/heartbeat/strategies/echo_heartbeat.hpp>
 #include <vdl/heartbeat/strategies/scpi_heartbeat.hpp>
 #include <vdl/device/device_impl.hpp>
+#include <vdl/device/device_guard.hpp>
 #include <vdl/transport/mock_transport.hpp>
+#include <vdl/transport/sim_transport.hpp>
 #include <vdl/codec/binary_codec.hpp>
 #include <vdl/core/memory.hpp>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 #include <chrono>
 
 // ============================================================================
@@ -299,3 +307,527 @@ TEST_CASE("heartbeat_runner_t counters", "[heartbeat]") {
     REQUIRE(runner.success_count() > 0);
     REQUIRE(runner.failure_count() == 0);
 }
+
+TEST_CASE("heartbeat_runner_t picks up echo data changed between beats", "[heartbeat]") {
+    REQUIRE(vdl::ping_heartbeat_t().is_command_reusable());
+    REQUIRE(vdl::scpi_heartbeat_t().is_command_reusable());
+    REQUIRE_FALSE(vdl::echo_heartbeat_t().is_command_reusable());
+
+    // 仿真设备原样回显载荷
+    auto transport = vdl::make_unique<vdl::sim_transport_t>(vdl::sim_link_config_t());
+    transport->set_responder(vdl::make_codec_responder(std::make_shared<vdl::binary_codec_t>(),
+        [](const vdl::response_t& request) -> vdl::optional_t<vdl::command_t> {
+            vdl::command_t reply;
+            reply.set_function_code(request.function_code()).set_data(request.data());
+            return reply;
+        }));
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    auto strategy = vdl::make_unique<vdl::echo_heartbeat_t>(static_cast<uint8_t>(0x08), vdl::bytes_t{0x01, 0x02});
+    auto* echo = strategy.get();
+    vdl::heartbeat_config_t config;
+    config.interval = 30;
+    vdl::heartbeat_runner_t runner(device, std::move(strategy), config);
+    REQUIRE(runner.start().has_value());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    runner.pause();
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    const uint64_t before = runner.success_count();
+    REQUIRE(before > 0);
+
+    echo->set_echo_data({0x0A, 0x0B, 0x0C});
+    runner.resume();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    runner.stop();
+
+    REQUIRE(runner.success_count() > before);
+    REQUIRE(runner.total_failures() == 0);
+}
+
+TEST_CASE("heartbeat_runner_t reports heartbeat spans to an observer", "[heartbeat]") {
+    struct observer_t : vdl::i_execution_observer_t {
+        void on_span_end(const vdl::execution_span_t& span) override {
+            std::lock_guard<std::mutex> lock(mutex);
+            spans.push_back(span);
+        }
+        std::mutex mutex;
+        std::vector<vdl::execution_span_t> spans;
+    };
+
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    device.connect();
+
+    vdl::command_t ping_cmd;
+    ping_cmd.set_function_code(0x00);
+    transport_ptr->enable_auto_response(vdl::binary_codec_t().encode(ping_cmd).value());
+
+    vdl::heartbeat_config_t config;
+    config.interval = 50;
+    vdl::heartbeat_runner_t runner(device, vdl::make_unique<vdl::ping_heartbeat_t>(), config);
+    auto observer = std::make_shared<observer_t>();
+    runner.set_execution_observer(observer);
+
+    runner.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(180));
+    runner.stop();
+
+    std::lock_guard<std::mutex> lock(observer->mutex);
+    REQUIRE_FALSE(observer->spans.empty());
+    for (const auto& span : observer->spans) {
+        REQUIRE(span.kind == vdl::span_kind_t::heartbeat);
+        REQUIRE(span.function_code == 0x00);
+        REQUIRE(span.attempt == 1);
+        REQUIRE(span.ok());
+    }
+}
+
+TEST_CASE("heartbeat_runner_t skips beats while device is locked", "[heartbeat]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    auto codec = vdl::make_unique<vdl::binary_codec_t>();
+    vdl::device_impl_t device(std::move(transport), std::move(codec));
+    device.connect();
+
+    vdl::command_t ping_cmd;
+    ping_cmd.set_function_code(0x00);
+    vdl::binary_codec_t codec_helper;
+    auto frame = codec_helper.encode(ping_cmd);
+    if (frame) {
+        transport_ptr->enable_auto_response(*frame);
+    }
+
+    auto strategy = vdl::make_unique<vdl::ping_heartbeat_t>();
+    vdl::heartbeat_config_t config;
+    config.interval = 20;
+    config.pause_during_lock = true;
+
+    vdl::heartbeat_runner_t runner(device, std::move(strategy), config);
+
+    {
+        vdl::device_lock_t lock(device);
+        REQUIRE(lock.owns_lock());
+
+        runner.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        // 持锁期间心跳不会向设备写入任何数据
+        REQUIRE(transport_ptr->get_written_data().empty());
+        REQUIRE(runner.skipped_count() > 0);
+        REQUIRE(runner.success_count() == 0);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    runner.stop();
+
+    REQUIRE(runner.success_count() > 0);
+    REQUIRE(runner.failure_count() == 0);
+}
+
+// ============================================================================
+// heartbeat_scheduler_t 测试
+// ============================================================================
+
+TEST_CASE("heartbeat_scheduler_t runs periodic tasks", "[heartbeat][scheduler]") {
+    vdl::heartbeat_scheduler_config_t config;
+    config.worker_count = 1;
+    config.tick = 5;
+    config.jitter_start = false;
+    vdl::heartbeat_scheduler_t scheduler(config);
+
+    std::atomic<int> fired{0};
+    auto id = scheduler.schedule(10, [&fired] {
+        fired.fetch_add(1);
+        return vdl::milliseconds_t(10);
+    });
+    REQUIRE(scheduler.task_count() == 1u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    scheduler.cancel(id);
+    const int after_cancel = fired.load();
+    REQUIRE(after_cancel >= 3);
+    REQUIRE(scheduler.task_count() == 0u);
+
+    // 取消后不再执行
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    REQUIRE(fired.load() == after_cancel);
+}
+
+TEST_CASE("heartbeat_scheduler_t one-shot task and trigger", "[heartbeat][scheduler]") {
+    vdl::heartbeat_scheduler_config_t config;
+    config.worker_count = 1;
+    config.tick = 5;
+    config.jitter_start = false;
+    vdl::heartbeat_scheduler_t scheduler(config);
+
+    std::atomic<int> once{0};
+    scheduler.schedule(0, [&once] {
+        once.fetch_add(1);
+        return vdl::milliseconds_t(-1);   // 只执行一次
+    });
+
+    std::atomic<int> slow{0};
+    auto slow_id = scheduler.schedule(0, [&slow] {
+        slow.fetch_add(1);
+        return vdl::milliseconds_t(60000);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE(once.load() == 1);
+    REQUIRE(slow.load() == 1);
+    REQUIRE(scheduler.task_count() == 1u);
+
+    // trigger() 提前触发，无需等待 60 秒的间隔
+    scheduler.trigger(slow_id);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE(slow.load() == 2);
+    scheduler.cancel(slow_id);
+}
+
+TEST_CASE("heartbeat_scheduler_t keeps healthy heartbeats on time behind blocked ones", "[heartbeat][scheduler]") {
+    vdl::heartbeat_scheduler_config_t config;   // worker_count 默认随任务数增长
+    config.tick = 5;
+    config.jitter_start = false;
+    vdl::heartbeat_scheduler_t scheduler(config);
+
+    // 两台无响应设备：每次心跳阻塞到超时
+    std::vector<vdl::heartbeat_scheduler_t::task_id_t> ids;
+    for (int i = 0; i < 2; ++i) {
+        ids.push_back(scheduler.schedule(10, [] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            return vdl::milliseconds_t(10);
+        }));
+    }
+
+    std::atomic<int> healthy{0};
+    ids.push_back(scheduler.schedule(10, [&healthy] {
+        healthy.fetch_add(1);
+        return vdl::milliseconds_t(10);
+    }));
+    REQUIRE(scheduler.worker_threads() == 3u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    REQUIRE(healthy.load() >= 5);
+    for (auto id : ids) {
+        scheduler.cancel(id);
+    }
+}
+
+TEST_CASE("heartbeat_scheduler_t cancel waits for a running task", "[heartbeat][scheduler]") {
+    vdl::heartbeat_scheduler_config_t config;
+    config.worker_count = 1;
+    config.tick = 1;
+    config.jitter_start = false;
+    vdl::heartbeat_scheduler_t scheduler(config);
+
+    std::atomic<bool> entered{false};
+    std::atomic<bool> finished{false};
+    auto id = scheduler.schedule(0, [&entered, &finished] {
+        entered.store(true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished.store(true);
+        return vdl::milliseconds_t(1000);
+    });
+
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+    scheduler.cancel(id);
+    REQUIRE(finished.load());
+}
+
+TEST_CASE("heartbeat_scheduler_t hosts many runners on few threads", "[heartbeat][scheduler]") {
+    vdl::heartbeat_scheduler_config_t sched_config;
+    sched_config.worker_count = 1;
+    sched_config.tick = 5;
+    vdl::heartbeat_scheduler_t scheduler(sched_config);
+
+    vdl::command_t ping_cmd;
+    ping_cmd.set_function_code(0x00);
+    vdl::binary_codec_t codec_helper;
+    auto frame = codec_helper.encode(ping_cmd);
+    REQUIRE(frame.has_value());
+
+    constexpr size_t k_devices = 16;
+    std::vector<std::unique_ptr<vdl::device_impl_t>> devices;
+    std::vector<std::unique_ptr<vdl::heartbeat_runner_t>> runners;
+    std::atomic<int> successes{0};
+
+    vdl::heartbeat_config_t config;
+    config.interval = 20;
+
+    for (size_t i = 0; i < k_devices; ++i) {
+        auto transport = vdl::make_unique<vdl::mock_transport_t>();
+        transport->enable_auto_response(*frame);
+        devices.emplace_back(new vdl::device_impl_t(std::move(transport),
+                                                    vdl::make_unique<vdl::binary_codec_t>()));
+        devices.back()->connect();
+
+        runners.emplace_back(new vdl::heartbeat_runner_t(
+            *devices.back(), vdl::make_unique<vdl::ping_heartbeat_t>(), config, scheduler));
+        runners.back()->set_callback([&successes](vdl::heartbeat_event_t event, uint8_t,
+                                                  const vdl::error_t&) {
+            if (event == vdl::heartbeat_event_t::success) {
+                successes.fetch_add(1);
+            }
+        });
+        REQUIRE(runners.back()->start().has_value());
+    }
+    REQUIRE(scheduler.task_count() == k_devices);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+    for (auto& runner : runners) {
+        runner->stop();
+        REQUIRE(runner->success_count() > 0);
+        REQUIRE(runner->failure_count() == 0);
+    }
+    REQUIRE(scheduler.task_count() == 0u);
+    REQUIRE(successes.load() >= static_cast<int>(k_devices));
+}
+
+TEST_CASE("heartbeat_runner_t idle_only counts application traffic", "[heartbeat]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    device.connect();
+    REQUIRE(device.last_success_time() == std::chrono::steady_clock::time_point());
+
+    vdl::command_t ping_cmd;
+    ping_cmd.set_function_code(0x00);
+    vdl::binary_codec_t codec_helper;
+    auto frame = codec_helper.encode(ping_cmd);
+    REQUIRE(frame.has_value());
+    transport_ptr->enable_auto_response(*frame);
+
+    REQUIRE(device.execute(ping_cmd).has_value());
+    REQUIRE(device.last_success_time() != std::chrono::steady_clock::time_point());
+
+    vdl::heartbeat_config_t config;
+    config.interval = 100;
+    config.idle_only = true;
+    vdl::heartbeat_runner_t runner(device, vdl::make_unique<vdl::ping_heartbeat_t>(), config);
+    REQUIRE(runner.start().has_value());
+
+    // 应用流量持续时不发送心跳，流量计为心跳成功
+    uint32_t app_writes = 1;
+    for (int i = 0; i < 20; ++i) {
+        REQUIRE(device.execute(ping_cmd).has_value());
+        ++app_writes;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    {
+        vdl::device_lock_t lock(device);
+        REQUIRE(transport_ptr->write_call_count() == app_writes);
+    }
+    REQUIRE(runner.success_count() > 0);
+
+    // 空闲满 interval 后恢复心跳
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    runner.stop();
+    REQUIRE(transport_ptr->write_call_count() > app_writes);
+    REQUIRE(runner.failure_count() == 0);
+}
+
+// ============================================================================
+// RTT 估计与自适应超时测试
+// ============================================================================
+
+TEST_CASE("rtt_estimator_t follows RFC 6298", "[heartbeat][rtt]") {
+    vdl::rtt_estimator_t rtt;
+    REQUIRE_FALSE(rtt.has_sample());
+    REQUIRE(rtt.rto() == 0);
+
+    rtt.add_sample(100000);
+    REQUIRE(rtt.srtt() == 100000);
+    REQUIRE(rtt.rttvar() == 50000);
+    REQUIRE(rtt.rto() == 300000);
+
+    rtt.add_sample(100000);
+    REQUIRE(rtt.srtt() == 100000);
+    REQUIRE(rtt.rttvar() == 37500);
+    REQUIRE(rtt.rto() == 250000);
+
+    // 超时退避，下一个样本清除退避
+    rtt.on_timeout();
+    REQUIRE(rtt.rto() == 500000);
+    rtt.on_timeout();
+    REQUIRE(rtt.rto() == 1000000);
+    rtt.add_sample(100000);
+    REQUIRE(rtt.rto() < 500000);
+
+    SECTION("granularity floor") {
+        vdl::rtt_estimator_t fast;
+        fast.add_sample(10);
+        const vdl::microseconds_t granularity = vdl::rtt_estimator_t::k_granularity;
+        REQUIRE(fast.rto() == 10 + granularity);
+    }
+}
+
+TEST_CASE("rtt_estimator_t percentiles", "[heartbeat][rtt]") {
+    vdl::rtt_estimator_t rtt;
+    for (vdl::microseconds_t i = 100; i >= 1; --i) {
+        rtt.add_sample(i * 1000);
+    }
+
+    auto stats = rtt.snapshot();
+    REQUIRE(stats.samples == 100u);
+    REQUIRE(stats.min == 1000);
+    REQUIRE(stats.max == 100000);
+    REQUIRE(stats.p50 == 50000);
+    REQUIRE(stats.p90 == 90000);
+    REQUIRE(stats.p99 == 99000);
+    REQUIRE(stats.last == 1000);
+    REQUIRE(rtt.percentile(100) == 100000);
+
+    // 窗口只保留最近的样本
+    for (size_t i = 0; i < vdl::rtt_estimator_t::k_window; ++i) {
+        rtt.add_sample(7);
+    }
+    REQUIRE(rtt.snapshot().max == 7);
+
+    rtt.reset();
+    REQUIRE(rtt.snapshot().samples == 0u);
+}
+
+TEST_CASE("heartbeat_runner_t adapts timeout and interval to RTT", "[heartbeat][rtt]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    device.connect();
+
+    vdl::command_t ping_cmd;
+    ping_cmd.set_function_code(0x00);
+    vdl::binary_codec_t codec_helper;
+    auto frame = codec_helper.encode(ping_cmd);
+    REQUIRE(frame.has_value());
+    transport_ptr->enable_auto_response(*frame);
+
+    vdl::heartbeat_config_t config;
+    config.interval = 10;
+    config.timeout = 500;
+    config.adaptive_timeout = true;
+    config.min_timeout = 20;
+    config.rtt_interval_factor = 50;
+    vdl::heartbeat_runner_t runner(device, vdl::make_unique<vdl::ping_heartbeat_t>(), config);
+
+    // 尚无样本时使用配置值
+    REQUIRE(runner.effective_timeout() == 500);
+    REQUIRE(runner.effective_interval() == 10);
+
+    REQUIRE(runner.start().has_value());
+    for (int i = 0; i < 200 && runner.rtt_stats().samples == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    runner.stop();
+
+    auto stats = runner.rtt_stats();
+    REQUIRE(stats.samples > 0);
+    const vdl::microseconds_t granularity = vdl::rtt_estimator_t::k_granularity;
+    REQUIRE(stats.rto >= granularity);
+    // 回环设备的 RTO 远小于 500ms，超时收敛到下限附近
+    REQUIRE(runner.effective_timeout() >= config.min_timeout);
+    REQUIRE(runner.effective_timeout() < 500);
+    REQUIRE(runner.effective_interval() >= 50);
+
+    runner.reset_rtt();
+    REQUIRE(runner.effective_timeout() == 500);
+}
+
+// ============================================================================
+// 异步事件分发测试
+// ============================================================================
+
+TEST_CASE("heartbeat_runner_t slow callbacks do not delay beats", "[heartbeat][event]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+    device.connect();
+
+    vdl::command_t ping_cmd;
+    ping_cmd.set_function_code(0x00);
+    vdl::binary_codec_t codec_helper;
+    auto frame = codec_helper.encode(ping_cmd);
+    REQUIRE(frame.has_value());
+    transport_ptr->enable_auto_response(*frame);
+
+    vdl::event_dispatcher_t dispatcher;
+    vdl::heartbeat_config_t config;
+    config.interval = 10;
+    vdl::heartbeat_runner_t runner(device, vdl::make_unique<vdl::ping_heartbeat_t>(), config);
+    runner.set_event_dispatcher(&dispatcher, true);
+
+    std::atomic<int> delivered{0};
+    std::atomic<bool> stopped_seen{false};
+    runner.set_callback([&delivered, &stopped_seen](vdl::heartbeat_event_t event, uint8_t,
+                                                    const vdl::error_t&) {
+        if (event == vdl::heartbeat_event_t::stopped) {
+            stopped_seen.store(true);
+            return;
+        }
+        delivered.fetch_add(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    });
+
+    REQUIRE(runner.start().has_value());
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // 回调期间读取状态不会被阻塞
+    const auto start = std::chrono::steady_clock::now();
+    runner.set_interval(10);
+    (void)runner.last_error();
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20));
+
+    runner.stop();
+    REQUIRE(stopped_seen.load());   // stop() 等待已投递的事件执行完
+
+    // 心跳节奏不受 50ms 回调影响，连续的 success 事件被合并
+    REQUIRE(runner.success_count() > static_cast<uint64_t>(delivered.load()));
+    REQUIRE(dispatcher.coalesced_count() > 0u);
+}
+
+TEST_CASE("device_impl reconnect callback on event dispatcher", "[heartbeat][event]") {
+    auto transport = vdl::make_unique<vdl::mock_transport_t>();
+    auto* transport_ptr = transport.get();
+    vdl::device_impl_t device(std::move(transport), vdl::make_unique<vdl::binary_codec_t>());
+
+    vdl::device_config_t cfg;
+    cfg.max_retries = 2;
+    cfg.retry_delay = 0;
+    cfg.reconnect_delay = 0;
+    device.set_config(cfg);
+
+    vdl::event_dispatcher_t dispatcher;
+    device.set_event_dispatcher(&dispatcher);
+
+    std::vector<vdl::reconnect_event_t> events;
+    std::thread::id callback_thread;
+    device.set_reconnect_callback([&events, &callback_thread](vdl::reconnect_event_t event,
+                                                              uint8_t, uint8_t,
+                                                              const vdl::error_t&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        events.push_back(event);
+        callback_thread = std::this_thread::get_id();
+    });
+
+    REQUIRE(device.connect().has_value());
+    transport_ptr->set_fail_write_times(cfg.max_retries);
+
+    vdl::command_t cmd;
+    cmd.set_function_code(0x08);
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE_FALSE(device.execute(cmd).has_value());
+    // 三个 30ms 的回调不占用出错命令的线程
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(60));
+    REQUIRE(device.is_connected());
+
+    dispatcher.flush();
+    REQUIRE(events.size() == 3u);
+    REQUIRE(events[0] == vdl::reconnect_event_t::started);
+    REQUIRE(events[1] == vdl::reconnect_event_t::attempting);
+    REQUIRE(events[2] == vdl::reconnect_event_t::success);
+    REQUIRE(callback_thread != std::this_thread::get_id());
+}
@@ -5,6 +5,12 @@
 
 #include <catch.hpp>
 #include <vdl/core/logging.hpp>
+#include <vdl/core/spdlog_sink.hpp>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 // ============================================================================
 // log_level_t 测试
@@ -94,3 +100,192 @@ TEST_CASE("log level iteration", "[core][logging]") {
     
     vdl::set_log_level(original);
 }
+
+// ============================================================================
+// 输出端与异步后端测试
+// ============================================================================
+
+namespace {
+
+class capture_sink_t : public vdl::i_log_sink_t {
+public:
+    void write(const vdl::log_record_t& record) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_messages.emplace_back(record.message, record.length);
+        m_levels.push_back(record.level);
+    }
+
+    std::vector<std::string> messages() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_messages;
+    }
+
+    std::vector<vdl::log_level_t> levels() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_levels;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<std::string> m_messages;
+    std::vector<vdl::log_level_t> m_levels;
+};
+
+// 恢复全局日志配置
+struct log_config_guard_t {
+    log_config_guard_t() : level(vdl::get_log_level()) {}
+    ~log_config_guard_t() {
+        vdl::disable_async_logging();
+        vdl::set_log_sink(nullptr);
+        vdl::set_log_level(level);
+    }
+    vdl::log_level_t level;
+};
+
+int g_evaluated = 0;
+
+int count_evaluation() {
+    return ++g_evaluated;
+}
+
+}  // namespace
+
+TEST_CASE("log sink receives formatted records", "[core][logging]") {
+    log_config_guard_t guard;
+    auto sink = std::make_shared<capture_sink_t>();
+    vdl::set_log_sink(sink);
+    vdl::set_log_level(vdl::log_level_t::info);
+
+    VDL_LOG_DEBUG("hidden %d", 1);
+    VDL_LOG_INFO("value=%d name=%s", 42, "dmm");
+    VDL_LOG_ERROR("failed: %s", "timeout");
+
+    auto messages = sink->messages();
+    REQUIRE(messages.size() == 2);
+    REQUIRE(messages[0] == "value=42 name=dmm");
+    REQUIRE(messages[1] == "failed: timeout");
+    REQUIRE(sink->levels()[1] == vdl::log_level_t::error);
+    REQUIRE(vdl::get_log_sink() == sink);
+}
+
+TEST_CASE("filtered log arguments are not evaluated", "[core][logging]") {
+    log_config_guard_t guard;
+    auto sink = std::make_shared<capture_sink_t>();
+    vdl::set_log_sink(sink);
+    g_evaluated = 0;
+
+    vdl::set_log_level(vdl::log_level_t::warn);
+    VDL_LOG_DEBUG("value %d", count_evaluation());
+    REQUIRE(g_evaluated == 0);
+
+    VDL_LOG_WARN("value %d", count_evaluation());
+    REQUIRE(g_evaluated == 1);
+
+    // 编译期过滤的宏形式：参数只出现在不求值的上下文中
+    VDL_LOG_DISCARD_("value %d", count_evaluation());
+    REQUIRE(g_evaluated == 1);
+    REQUIRE(sink->messages().size() == 1);
+}
+
+TEST_CASE("long log messages are truncated", "[core][logging]") {
+    log_config_guard_t guard;
+    auto sink = std::make_shared<capture_sink_t>();
+    vdl::set_log_sink(sink);
+    vdl::set_log_level(vdl::log_level_t::info);
+
+    const std::string payload(2000, 'x');
+    VDL_LOG_INFO("%s", payload.c_str());
+
+    auto messages = sink->messages();
+    REQUIRE(messages.size() == 1);
+    REQUIRE(messages[0].size() == vdl::async_log_backend_t::k_message_size - 1);
+}
+
+TEST_CASE("async logging delivers records in order", "[core][logging]") {
+    log_config_guard_t guard;
+    auto sink = std::make_shared<capture_sink_t>();
+    vdl::set_log_sink(sink);
+    vdl::set_log_level(vdl::log_level_t::info);
+
+    vdl::enable_async_logging(256, 5);
+    REQUIRE(vdl::async_logging_enabled());
+
+    for (int i = 0; i < 100; ++i) {
+        VDL_LOG_INFO("record %d", i);
+    }
+    vdl::flush_log();
+
+    auto messages = sink->messages();
+    REQUIRE(messages.size() == 100);
+    REQUIRE(messages.front() == "record 0");
+    REQUIRE(messages.back() == "record 99");
+    REQUIRE(vdl::log_dropped_count() == 0);
+
+    // 关闭后恢复同步输出
+    vdl::disable_async_logging();
+    REQUIRE_FALSE(vdl::async_logging_enabled());
+    VDL_LOG_INFO("sync %d", 1);
+    REQUIRE(sink->messages().size() == 101);
+}
+
+TEST_CASE("async log backend drops when full", "[core][logging]") {
+    log_config_guard_t guard;
+    auto sink = std::make_shared<capture_sink_t>();
+    vdl::set_log_sink(sink);
+
+    vdl::async_log_backend_t backend(4, 10000);
+    vdl::log_record_t record;
+    record.message = "m";
+    record.length = 1;
+
+    // 后台线程休眠期间最多容纳 capacity 条，其余丢弃且不阻塞
+    size_t accepted = 0;
+    for (int i = 0; i < 64; ++i) {
+        if (backend.push(record)) {
+            ++accepted;
+        }
+    }
+    REQUIRE(accepted < 64);
+    REQUIRE(backend.dropped_count() == 64 - accepted);
+
+    backend.flush();
+    REQUIRE(sink->messages().size() == accepted);
+
+    backend.stop();
+    REQUIRE_FALSE(backend.push(record));
+}
+
+TEST_CASE("async logging from multiple threads", "[core][logging]") {
+    log_config_guard_t guard;
+    auto sink = std::make_shared<capture_sink_t>();
+    vdl::set_log_sink(sink);
+    vdl::set_log_level(vdl::log_level_t::info);
+    vdl::enable_async_logging(4096, 5);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 50; ++i) {
+                VDL_LOG_INFO("thread %d record %d", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    vdl::flush_log();
+
+    REQUIRE(sink->messages().size() + vdl::log_dropped_count() == 200);
+}
+
+TEST_CASE("spdlog sink forwards records", "[core][logging]") {
+    log_config_guard_t guard;
+    auto logger = std::make_shared<spdlog::logger>("vdl_test");
+    logger->set_level(spdlog::level::off);
+    auto sink = std::make_shared<vdl::spdlog_sink_t>(logger);
+    vdl::set_log_sink(sink);
+    vdl::set_log_level(vdl::log_level_t::info);
+
+    VDL_LOG_INFO("forwarded %d", 1);
+    REQUIRE(sink->logger() == logger);
+}
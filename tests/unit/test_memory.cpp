@@ -5,6 +5,11 @@
 
 #include <catch.hpp>
 #include <vdl/core/memory.hpp>
+#include <vdl/core/arena.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
 
 // ============================================================================
 // buffer_pool_t 测试
@@ -194,3 +199,202 @@ TEST_CASE("mem_compare null safety", "[core][memory]") {
     REQUIRE(vdl::mem_compare(a, nullptr, 4) == 0);
     REQUIRE(vdl::mem_compare(a, a, 0) == 0);
 }
+
+// ============================================================================
+// size_class_pool_t 测试
+// ============================================================================
+
+TEST_CASE("size_class_pool_t size classes", "[core][memory][pool]") {
+    REQUIRE(vdl::size_class_pool_t::class_index(0) == 0);
+    REQUIRE(vdl::size_class_pool_t::class_index(64) == 0);
+    REQUIRE(vdl::size_class_pool_t::class_index(65) == 1);
+    REQUIRE(vdl::size_class_pool_t::class_index(4096) == 6);
+    REQUIRE(vdl::size_class_pool_t::class_size(6) == 4096);
+
+    const size_t count = vdl::size_class_pool_t::k_class_count;
+    REQUIRE(vdl::size_class_pool_t::class_index((1u << 20) + 1) == count);
+}
+
+TEST_CASE("size_class_pool_t reuses released buffers", "[core][memory][pool]") {
+    vdl::size_class_pool_t pool;
+
+    vdl::bytes_t first = pool.acquire(100);
+    REQUIRE(first.size() == 100);
+    REQUIRE(first.capacity() >= 128);
+    const vdl::byte_t* address = first.data();
+    REQUIRE(pool.allocation_count() == 1);
+
+    pool.release(std::move(first));
+    vdl::bytes_t second = pool.acquire(120);
+    REQUIRE(second.data() == address);
+    REQUIRE(second.size() == 120);
+    REQUIRE(second[119] == 0);
+    REQUIRE(pool.allocation_count() == 1);
+
+    // 稳态循环不再分配
+    pool.release(std::move(second));
+    for (int i = 0; i < 100; ++i) {
+        vdl::bytes_t buffer = pool.acquire(static_cast<size_t>(65 + i % 60));
+        pool.release(std::move(buffer));
+    }
+    REQUIRE(pool.allocation_count() == 1);
+
+    // 超大请求不经过池
+    vdl::bytes_t huge = pool.acquire(2u << 20);
+    REQUIRE(huge.size() == (2u << 20));
+    REQUIRE(pool.oversize_count() == 1);
+    pool.release(std::move(huge));
+}
+
+TEST_CASE("size_class_pool_t trims to the high-water mark", "[core][memory][pool]") {
+    vdl::size_class_pool_t pool;
+    const size_t index = vdl::size_class_pool_t::class_index(256);
+
+    // 突发：同时持有 32 个缓冲区
+    std::vector<vdl::bytes_t> burst;
+    for (int i = 0; i < 32; ++i) {
+        burst.push_back(pool.acquire(256));
+    }
+    for (auto& buffer : burst) {
+        pool.release(std::move(buffer));
+    }
+    burst.clear();
+
+    // 第一次修剪保留峰值所需的缓冲区
+    pool.trim();
+    const size_t kept = pool.cached_count(index);
+    REQUIRE(kept >= 16);
+
+    // 之后只用到少量缓冲区，再次修剪时释放多余的
+    for (int i = 0; i < 4; ++i) {
+        vdl::bytes_t buffer = pool.acquire(256);
+        pool.release(std::move(buffer));
+    }
+    pool.trim();
+    REQUIRE(pool.cached_count(index) < kept);
+}
+
+TEST_CASE("size_class_pool_t is thread-safe", "[core][memory][pool]") {
+    vdl::size_class_pool_t pool(64);
+    std::vector<std::thread> threads;
+    std::atomic<int> errors{0};
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool, &errors, t] {
+            std::vector<vdl::bytes_t> held;
+            for (int i = 0; i < 2000; ++i) {
+                vdl::bytes_t buffer = pool.acquire(static_cast<size_t>(64 << (i % 4)));
+                buffer[0] = static_cast<vdl::byte_t>(t);
+                held.push_back(std::move(buffer));
+                if (held.size() > 16) {
+                    for (auto& item : held) {
+                        if (item[0] != static_cast<vdl::byte_t>(t)) {
+                            ++errors;
+                        }
+                        pool.release(std::move(item));
+                    }
+                    held.clear();
+                }
+            }
+            for (auto& item : held) {
+                pool.release(std::move(item));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(errors.load() == 0);
+    REQUIRE(pool.allocation_count() < 4 * 2000);
+}
+
+TEST_CASE("slab_cache_t reuses unreferenced slabs", "[core][memory][pool]") {
+    vdl::slab_cache_t cache(2);
+    const vdl::byte_t frame[] = {1, 2, 3, 4};
+
+    const vdl::byte_t* address = nullptr;
+    {
+        vdl::byte_slice_t slice = cache.copy(vdl::const_byte_span_t(frame, 4));
+        REQUIRE(slice.size() == 4);
+        REQUIRE(slice.data()[3] == 4);
+        address = slice.data();
+    }
+    vdl::byte_slice_t again = cache.copy(vdl::const_byte_span_t(frame, 3));
+    REQUIRE(again.data() == address);
+    REQUIRE(again.size() == 3);
+    REQUIRE(cache.reuse_count() == 1);
+
+    // 仍被引用的 slab 不会被覆盖
+    vdl::byte_slice_t other = cache.copy(vdl::const_byte_span_t(frame + 1, 3));
+    REQUIRE(other.data() != again.data());
+    REQUIRE(again.data()[0] == 1);
+    REQUIRE(other.data()[0] == 2);
+}
+
+// ============================================================================
+// arena_t 测试
+// ============================================================================
+
+TEST_CASE("arena_t allocates aligned memory and reuses blocks", "[core][memory][arena]") {
+    vdl::arena_t arena(64);
+
+    void* a = arena.allocate(3, 1);
+    void* b = arena.allocate(8, 8);
+    REQUIRE(reinterpret_cast<uintptr_t>(b) % 8 == 0);
+    REQUIRE(static_cast<vdl::byte_t*>(b) > static_cast<vdl::byte_t*>(a));
+    REQUIRE(arena.bytes_used() == 11);
+    REQUIRE(arena.block_count() == 1);
+
+    // 超过当前块：新建更大的块
+    arena.allocate(100);
+    REQUIRE(arena.block_count() == 2);
+    const size_t reserved = arena.bytes_reserved();
+
+    arena.reset();
+    REQUIRE(arena.bytes_used() == 0);
+    REQUIRE(arena.allocate(3, 1) == a);
+    arena.allocate(100);
+    REQUIRE(arena.block_count() == 2);
+    REQUIRE(arena.bytes_reserved() == reserved);
+
+    arena.release();
+    REQUIRE(arena.block_count() == 0);
+    REQUIRE(arena.bytes_reserved() == 0);
+}
+
+TEST_CASE("transaction_scope_t rewinds on exit", "[core][memory][arena]") {
+    vdl::arena_t arena(256);
+    void* outer = arena.allocate(16);
+
+    const vdl::byte_t* first = nullptr;
+    {
+        vdl::transaction_scope_t scope(arena);
+        vdl::arena_bytes_t bytes = scope.make_bytes(32);
+        REQUIRE(bytes.size() == 32);
+        REQUIRE(bytes[31] == 0);
+        first = bytes.data();
+
+        vdl::arena_string_t text = scope.make_string("MEAS:VOLT?", 10);
+        text += " 1.25";
+        REQUIRE(text == "MEAS:VOLT? 1.25");
+    }
+    {
+        vdl::transaction_scope_t scope(arena);
+        vdl::arena_bytes_t bytes = scope.make_bytes(32);
+        REQUIRE(bytes.data() == first);
+    }
+
+    // 作用域之前的分配不受影响
+    REQUIRE(arena.allocate(1, 1) == static_cast<vdl::byte_t*>(outer) + 16);
+    REQUIRE(arena.block_count() == 1);
+}
+
+TEST_CASE("arena_allocator_t without an arena uses the heap", "[core][memory][arena]") {
+    vdl::arena_bytes_t bytes;
+    bytes.assign(1000, 7);
+    REQUIRE(bytes.size() == 1000);
+    REQUIRE(bytes.get_allocator().arena() == nullptr);
+
+    vdl::arena_t arena;
+    REQUIRE(vdl::arena_allocator_t<char>(arena) == vdl::arena_allocator_t<vdl::byte_t>(arena));
+    REQUIRE(vdl::arena_allocator_t<char>(arena) != vdl::arena_allocator_t<char>());
+}
@@ -0,0 +1,266 @@
+/**
+ * @file test_number_parser.cpp
+ * @brief 测试与 locale 无关的数值解析
+ */
+
+#include <catch.hpp>
+#include <vdl/core/number_parser.hpp>
+#include <vdl/core/number_format.hpp>
+#include <vdl/device/scpi_adapter.hpp>
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// 单值解析测试
+// ============================================================================
+
+TEST_CASE("parse_double basic formats", "[core][number_parser]") {
+    double v = 0.0;
+
+    REQUIRE(vdl::parse_double(std::string("0"), v));
+    REQUIRE(v == 0.0);
+
+    REQUIRE(vdl::parse_double(std::string("-1.5"), v));
+    REQUIRE(v == -1.5);
+
+    REQUIRE(vdl::parse_double(std::string("+1.23456789012E-03"), v));
+    REQUIRE(v == 1.23456789012E-03);
+
+    REQUIRE(vdl::parse_double(std::string("  1e9\r\n"), v));
+    REQUIRE(v == 1e9);
+
+    REQUIRE(vdl::parse_double(std::string(".25"), v));
+    REQUIRE(v == 0.25);
+
+    REQUIRE(vdl::parse_double(std::string("9.91E37"), v));
+    REQUIRE(v == 9.91E37);
+
+    REQUIRE(vdl::parse_double(std::string("0.000000000000000000000000001"), v));
+    REQUIRE(v == 1e-27);
+
+    REQUIRE(vdl::parse_double(std::string("-inf"), v));
+    REQUIRE(std::isinf(v));
+    REQUIRE(v < 0.0);
+
+    REQUIRE(vdl::parse_double(std::string("NaN"), v));
+    REQUIRE(std::isnan(v));
+}
+
+TEST_CASE("parse_double rejects malformed input", "[core][number_parser]") {
+    double v = 0.0;
+
+    REQUIRE_FALSE(vdl::parse_double(std::string(""), v));
+    REQUIRE_FALSE(vdl::parse_double(std::string("abc"), v));
+    REQUIRE_FALSE(vdl::parse_double(std::string("1.5x"), v));
+    REQUIRE_FALSE(vdl::parse_double(std::string("1e"), v));
+    REQUIRE_FALSE(vdl::parse_double(std::string("1,5"), v));
+    REQUIRE_FALSE(vdl::parse_double(std::string("-"), v));
+}
+
+TEST_CASE("parse_double matches strtod", "[core][number_parser]") {
+    const char* samples[] = {
+        "3.14159265358979323846",
+        "1.7976931348623157e308",
+        "2.2250738585072014e-308",
+        "123456789012345678901234567890",
+        "0.1", "0.3", "1e23", "4.9e-324",
+        "-8.123456789012345e-12"
+    };
+
+    for (const char* text : samples) {
+        double v = 0.0;
+        REQUIRE(vdl::parse_double(std::string(text), v));
+        REQUIRE(v == std::strtod(text, nullptr));
+    }
+
+    // 快速路径覆盖的典型仪器输出
+    char buffer[32];
+    for (int i = 0; i < 1000; ++i) {
+        const double expected = (i - 500) * 1.234567e-3;
+        std::snprintf(buffer, sizeof(buffer), "%.12E", expected);
+        double v = 0.0;
+        REQUIRE(vdl::parse_double(std::string(buffer), v));
+        REQUIRE(v == std::strtod(buffer, nullptr));
+    }
+}
+
+// ============================================================================
+// 批量解析测试
+// ============================================================================
+
+TEST_CASE("parse_doubles_into appends to vector", "[core][number_parser]") {
+    const std::string text = "1.0, -2.5E+01,3e-3 ,, 4\n";
+    std::vector<double> out{42.0};
+
+    auto result = vdl::parse_doubles_into(text.data(), text.size(), out);
+    REQUIRE(result.has_value());
+    REQUIRE(*result == 4);
+    REQUIRE(out.size() == 5);
+    REQUIRE(out[0] == 42.0);
+    REQUIRE(out[1] == 1.0);
+    REQUIRE(out[2] == -25.0);
+    REQUIRE(out[3] == 3e-3);
+    REQUIRE(out[4] == 4.0);
+}
+
+TEST_CASE("parse_doubles_into restores vector on error", "[core][number_parser]") {
+    const std::string text = "1.0,2.0,bad,4.0";
+    std::vector<double> out{7.0};
+
+    auto result = vdl::parse_doubles_into(text.data(), text.size(), out);
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().code() == vdl::error_code_t::invalid_format);
+    REQUIRE(out.size() == 1);
+    REQUIRE(out[0] == 7.0);
+}
+
+TEST_CASE("parse_doubles_into fixed span", "[core][number_parser]") {
+    const std::string text = "1,2,3";
+    double storage[3] = {0.0, 0.0, 0.0};
+
+    auto result = vdl::parse_doubles_into(text.data(), text.size(),
+                                          vdl::span_t<double>(storage, 3));
+    REQUIRE(result.has_value());
+    REQUIRE(*result == 3);
+    REQUIRE(storage[2] == 3.0);
+
+    auto overflow = vdl::parse_doubles_into(text.data(), text.size(),
+                                            vdl::span_t<double>(storage, 2));
+    REQUIRE_FALSE(overflow.has_value());
+    REQUIRE(overflow.error().code() == vdl::error_code_t::out_of_range);
+}
+
+TEST_CASE("parse_complex_into interleaved and SoA", "[core][number_parser]") {
+    const std::string text = "1,2,-3.5,4.25";
+
+    SECTION("complex vector") {
+        std::vector<std::complex<double>> out;
+        auto result = vdl::parse_complex_into(text.data(), text.size(), out);
+        REQUIRE(result.has_value());
+        REQUIRE(*result == 2);
+        REQUIRE(out[0] == std::complex<double>(1.0, 2.0));
+        REQUIRE(out[1] == std::complex<double>(-3.5, 4.25));
+    }
+
+    SECTION("separate arrays") {
+        std::vector<double> re;
+        std::vector<double> im;
+        auto result = vdl::parse_complex_into(text.data(), text.size(), re, im);
+        REQUIRE(result.has_value());
+        REQUIRE(*result == 2);
+        REQUIRE(re == std::vector<double>{1.0, -3.5});
+        REQUIRE(im == std::vector<double>{2.0, 4.25});
+    }
+
+    SECTION("odd count") {
+        const std::string odd = "1,2,3";
+        std::vector<std::complex<double>> out;
+        auto result = vdl::parse_complex_into(odd.data(), odd.size(), out);
+        REQUIRE_FALSE(result.has_value());
+        REQUIRE(out.empty());
+    }
+}
+
+TEST_CASE("scpi_adapter_t parse helpers", "[core][number_parser]") {
+    auto doubles = vdl::scpi_adapter_t::parse_data_doubles("+1.0E+00,-2.0E+00");
+    REQUIRE(doubles.has_value());
+    REQUIRE(*doubles == std::vector<double>{1.0, -2.0});
+
+    auto pairs = vdl::scpi_adapter_t::parse_complex_data("1,2,3,4");
+    REQUIRE(pairs.has_value());
+    REQUIRE(pairs->size() == 2);
+    REQUIRE((*pairs)[1].first == 3.0);
+    REQUIRE((*pairs)[1].second == 4.0);
+
+    REQUIRE_FALSE(vdl::scpi_adapter_t::parse_complex_data("1,2,3").has_value());
+}
+
+// ============================================================================
+// 增量解析测试
+// ============================================================================
+
+TEST_CASE("number_stream_parser_t carries tokens across chunks", "[core][number_parser]") {
+    const std::string text = "1.25,-3.5E+02, 7,1e-3 ,42";
+
+    // 所有可能的两段切分都应得到同样的结果
+    for (size_t split = 0; split <= text.size(); ++split) {
+        std::vector<double> out;
+        vdl::number_stream_parser_t parser(out);
+        REQUIRE(parser.feed(text.data(), split).has_value());
+        REQUIRE(parser.feed(text.data() + split, text.size() - split).has_value());
+        REQUIRE(parser.finish().has_value());
+        REQUIRE(parser.count() == 5);
+        REQUIRE(out == std::vector<double>{1.25, -350.0, 7.0, 1e-3, 42.0});
+    }
+
+    // 逐字节送入
+    std::vector<double> out;
+    vdl::number_stream_parser_t parser(out);
+    for (char c : text) {
+        REQUIRE(parser.feed(&c, 1).has_value());
+    }
+    REQUIRE(parser.finish().has_value());
+    REQUIRE(out.size() == 5);
+}
+
+TEST_CASE("number_stream_parser_t reports errors", "[core][number_parser]") {
+    std::vector<double> out;
+    vdl::number_stream_parser_t parser(out);
+
+    REQUIRE(parser.feed("1,2,x", 5).has_value());   // "x" 尚未结束
+    REQUIRE_FALSE(parser.feed(",3", 2).has_value());
+    REQUIRE_FALSE(parser.finish().has_value());
+
+    std::vector<double> long_out;
+    vdl::number_stream_parser_t long_parser(long_out);
+    const std::string digits(vdl::number_stream_parser_t::k_max_token_size + 1, '1');
+    REQUIRE_FALSE(long_parser.feed(digits.data(), digits.size()).has_value());
+}
+
+// ============================================================================
+// 格式化测试
+// ============================================================================
+
+TEST_CASE("format_int writes without allocation", "[core][number_parser]") {
+    char text[24];
+    size_t len = vdl::format_int(text, sizeof(text), 0);
+    REQUIRE(std::string(text, len) == "0");
+
+    len = vdl::format_int(text, sizeof(text), -401);
+    REQUIRE(std::string(text, len) == "-401");
+
+    len = vdl::format_int(text, sizeof(text), std::numeric_limits<int64_t>::min());
+    REQUIRE(std::string(text, len) == "-9223372036854775808");
+
+    REQUIRE(vdl::format_int(text, 2, 12345) == 0);
+}
+
+TEST_CASE("format_double round-trips through parse_double", "[core][number_parser]") {
+    char text[vdl::k_max_formatted_double];
+
+    size_t len = vdl::format_double(text, sizeof(text), 1.5e9);
+    REQUIRE(std::string(text, len) == "1500000000");
+
+    len = vdl::format_double(text, sizeof(text), -0.25);
+    REQUIRE(std::string(text, len) == "-0.25");
+
+    len = vdl::format_double(text, sizeof(text), std::numeric_limits<double>::infinity());
+    REQUIRE(std::string(text, len) == "INF");
+
+    const double samples[] = {3.14159265358979, 1.234567e-12, 6.02214076e23, -9.87654321e-3};
+    for (double value : samples) {
+        len = vdl::format_double(text, sizeof(text), value, 17);
+        REQUIRE(len > 0);
+        double parsed = 0.0;
+        REQUIRE(vdl::parse_double(text, text + len, parsed));
+        REQUIRE(parsed == value);
+    }
+
+    REQUIRE(vdl::format_double(text, 3, 1.2345) == 0);
+}
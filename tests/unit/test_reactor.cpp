@@ -0,0 +1,416 @@
+/**
+ * @file test_reactor.cpp
+ * @brief 测试 io_reactor_t 和 reactor_device_t
+ */
+
+#include <catch.hpp>
+
+#ifndef _WIN32
+
+#include <vdl/reactor/io_reactor.hpp>
+#include <vdl/reactor/reactor_device.hpp>
+#include <vdl/transport/tcp_transport.hpp>
+#include <vdl/codec/binary_codec.hpp>
+#include <vdl/heartbeat/strategies/echo_heartbeat.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief 在后台线程中运行反应器
+ */
+class reactor_thread_t {
+public:
+    reactor_thread_t() : m_thread([this] { m_reactor.run(); }) {}
+
+    ~reactor_thread_t() {
+        m_reactor.stop();
+        m_thread.join();
+    }
+
+    vdl::io_reactor_t& reactor() { return m_reactor; }
+
+private:
+    vdl::io_reactor_t m_reactor;
+    std::thread m_thread;
+};
+
+/**
+ * @brief 回环 TCP 服务器：原样回送收到的数据（可关闭回送模拟无响应设备）
+ *
+ * push() 模拟设备主动上报；set_prefix() 设置每次回送前先发送的数据。
+ */
+class echo_server_t {
+public:
+    explicit echo_server_t(bool echo = true) : m_echo(echo) {
+        m_listen = ::socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(m_listen, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+        ::listen(m_listen, 1);
+
+        socklen_t len = sizeof(addr);
+        ::getsockname(m_listen, reinterpret_cast<struct sockaddr*>(&addr), &len);
+        m_port = ntohs(addr.sin_port);
+
+        m_thread = std::thread([this] { _serve(); });
+    }
+
+    ~echo_server_t() {
+        ::shutdown(m_listen, SHUT_RDWR);
+        const int peer = m_peer.exchange(-1);
+        if (peer >= 0) {
+            ::shutdown(peer, SHUT_RDWR);
+        }
+        m_thread.join();
+        if (peer >= 0) {
+            ::close(peer);
+        }
+        ::close(m_listen);
+    }
+
+    uint16_t port() const { return m_port; }
+
+    size_t received() const { return m_received.load(); }
+
+    void set_prefix(const vdl::bytes_t& prefix) {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_prefix = prefix;
+    }
+
+    bool push(const vdl::bytes_t& data) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (m_peer.load() < 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::lock_guard<std::mutex> guard(m_mutex);
+        const int peer = m_peer.load();
+        return peer >= 0 &&
+               ::send(peer, data.data(), data.size(), 0) == static_cast<ssize_t>(data.size());
+    }
+
+private:
+    void _serve() {
+        const int peer = ::accept(m_listen, nullptr, nullptr);
+        if (peer < 0) {
+            return;
+        }
+        m_peer = peer;
+        char buffer[1024];
+        while (true) {
+            const ssize_t n = ::recv(peer, buffer, sizeof(buffer), 0);
+            if (n <= 0) {
+                break;
+            }
+            m_received += static_cast<size_t>(n);
+            if (m_echo) {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                if (!m_prefix.empty()) {
+                    ::send(peer, m_prefix.data(), m_prefix.size(), 0);
+                }
+                ::send(peer, buffer, static_cast<size_t>(n), 0);
+            }
+        }
+    }
+
+    bool m_echo;
+    std::mutex m_mutex;
+    vdl::bytes_t m_prefix;
+    int m_listen = -1;
+    std::atomic<int> m_peer{-1};
+    std::atomic<size_t> m_received{0};
+    uint16_t m_port = 0;
+    std::thread m_thread;
+};
+
+vdl::command_t make_echo_command(uint8_t value) {
+    vdl::command_t cmd;
+    cmd.set_function_code(0x10);
+    cmd.set_data({value, static_cast<uint8_t>(value + 1)});
+    return cmd;
+}
+
+vdl::bytes_t make_status_frame(uint8_t value) {
+    vdl::command_t status;
+    status.set_function_code(0x41);
+    status.set_data({value});
+    return *vdl::binary_codec_t().encode(status);
+}
+
+}  // namespace
+
+// ============================================================================
+// io_reactor_t 测试
+// ============================================================================
+
+TEST_CASE("io_reactor_t runs posted tasks and timers", "[reactor]") {
+    vdl::io_reactor_t reactor;
+    REQUIRE(reactor.valid());
+
+    int posted = 0;
+    int once = 0;
+    int periodic = 0;
+    std::thread producer([&reactor, &posted] {
+        reactor.post([&posted] { ++posted; });
+    });
+    producer.join();
+
+    reactor.add_timer(5, 0, [&once] { ++once; });
+    vdl::timer_id_t id = reactor.add_timer(1, 2, [&periodic] { ++periodic; });
+    REQUIRE(reactor.timer_count() == 2);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while ((once == 0 || periodic < 3) && std::chrono::steady_clock::now() < deadline) {
+        reactor.run_once(50);
+    }
+    reactor.cancel_timer(id);
+
+    REQUIRE(posted == 1);
+    REQUIRE(once == 1);
+    REQUIRE(periodic >= 3);
+    REQUIRE(reactor.timer_count() == 0);
+}
+
+TEST_CASE("io_reactor_t dispatches descriptor readiness", "[reactor]") {
+    vdl::io_reactor_t reactor;
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+
+    std::vector<uint32_t> seen;
+    REQUIRE(reactor.watch(fds[0], vdl::io_readable, [&](uint32_t events) {
+        char byte = 0;
+        REQUIRE(::read(fds[0], &byte, 1) == 1);
+        seen.push_back(events);
+    }).has_value());
+    REQUIRE_FALSE(reactor.watch(fds[0], vdl::io_readable, [](uint32_t) {}).has_value());
+
+    REQUIRE(reactor.run_once(0) == 0);
+    REQUIRE(::write(fds[1], "x", 1) == 1);
+    REQUIRE(reactor.run_once(100) == 1);
+    REQUIRE(seen.size() == 1);
+    REQUIRE((seen[0] & vdl::io_readable) != 0);
+
+    reactor.unwatch(fds[0]);
+    REQUIRE(reactor.watch_count() == 0);
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+// ============================================================================
+// reactor_device_t 测试
+// ============================================================================
+
+TEST_CASE("reactor_device_t executes synchronously over the reactor", "[reactor][device]") {
+    echo_server_t server;
+    reactor_thread_t loop;
+    vdl::reactor_device_t device(loop.reactor(),
+        vdl::make_unique<vdl::tcp_transport_t>("127.0.0.1", server.port()),
+        vdl::make_unique<vdl::binary_codec_t>());
+
+    REQUIRE(device.connect().has_value());
+    REQUIRE(device.is_connected());
+
+    auto result = device.execute(make_echo_command(0x20));
+    REQUIRE(result.has_value());
+    REQUIRE(result->function_code() == 0x10);
+    REQUIRE(result->payload() == vdl::bytes_t({0x20, 0x21}));
+
+    device.disconnect();
+    REQUIRE(device.state() == vdl::device_state_t::disconnected);
+    REQUIRE_FALSE(device.execute(make_echo_command(0x01)).has_value());
+}
+
+TEST_CASE("reactor_device_t pipelines async requests", "[reactor][device]") {
+    echo_server_t server;
+    reactor_thread_t loop;
+    vdl::reactor_device_t device(loop.reactor(),
+        vdl::make_unique<vdl::tcp_transport_t>("127.0.0.1", server.port()),
+        vdl::make_unique<vdl::binary_codec_t>());
+
+    vdl::device_config_t cfg;
+    cfg.max_in_flight = 4;
+    device.set_config(cfg);
+    REQUIRE(device.connect().has_value());
+
+    // 回调在反应器线程中按发送顺序完成（断言留到主线程）
+    const int count = 32;
+    std::vector<int> order;
+    std::promise<void> finished;
+    for (int i = 0; i < count; ++i) {
+        device.execute_async(make_echo_command(static_cast<uint8_t>(i)),
+            [&order, &finished](const vdl::result_t<vdl::response_t>& result) {
+                order.push_back(result ? result->data()[0] : -1);
+                if (order.size() == count) {
+                    finished.set_value();
+                }
+            });
+    }
+    REQUIRE(finished.get_future().wait_for(std::chrono::seconds(2)) == std::future_status::ready);
+    for (int i = 0; i < count; ++i) {
+        REQUIRE(order[static_cast<size_t>(i)] == i);
+    }
+}
+
+TEST_CASE("reactor_device_t times out unanswered requests", "[reactor][device]") {
+    echo_server_t server(/*echo=*/false);
+    reactor_thread_t loop;
+    vdl::reactor_device_t device(loop.reactor(),
+        vdl::make_unique<vdl::tcp_transport_t>("127.0.0.1", server.port()),
+        vdl::make_unique<vdl::binary_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    const auto start = std::chrono::steady_clock::now();
+    auto result = device.execute(make_echo_command(0x01), 50);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().code() == vdl::error_code_t::timeout);
+    REQUIRE(elapsed >= std::chrono::milliseconds(40));
+    REQUIRE(elapsed < std::chrono::milliseconds(1000));
+    REQUIRE(device.is_connected());
+}
+
+TEST_CASE("reactor_device_t rejects blocking execute on reactor thread", "[reactor][device]") {
+    echo_server_t server;
+    reactor_thread_t loop;
+    vdl::reactor_device_t device(loop.reactor(),
+        vdl::make_unique<vdl::tcp_transport_t>("127.0.0.1", server.port()),
+        vdl::make_unique<vdl::binary_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    std::promise<vdl::error_code_t> code;
+    loop.reactor().post([&device, &code] {
+        auto result = device.execute(make_echo_command(0x01));
+        code.set_value(result ? vdl::error_code_t::ok : result.error().code());
+    });
+    REQUIRE(code.get_future().get() == vdl::error_code_t::invalid_state);
+}
+
+TEST_CASE("reactor_device_t runs heartbeat as reactor timer", "[reactor][device][heartbeat]") {
+    echo_server_t server;
+    reactor_thread_t loop;
+    vdl::reactor_device_t device(loop.reactor(),
+        vdl::make_unique<vdl::tcp_transport_t>("127.0.0.1", server.port()),
+        vdl::make_unique<vdl::binary_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    vdl::heartbeat_config_t hb;
+    hb.interval = 5;
+    hb.timeout = 200;
+    hb.pause_during_lock = false;
+
+    std::atomic<int> successes{0};
+    device.start_heartbeat(vdl::make_unique<vdl::echo_heartbeat_t>(static_cast<uint8_t>(0x08)), hb,
+        [&successes](vdl::heartbeat_event_t event, uint8_t, const vdl::error_t&) {
+            if (event == vdl::heartbeat_event_t::success) {
+                ++successes;
+            }
+        });
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (successes.load() < 3 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    device.stop_heartbeat();
+    REQUIRE(successes.load() >= 3);
+}
+
+TEST_CASE("reactor_device_t delivers unsolicited frames to subscribers", "[reactor][device][unsolicited]") {
+    echo_server_t server;
+    reactor_thread_t loop;
+    vdl::reactor_device_t device(loop.reactor(),
+        vdl::make_unique<vdl::tcp_transport_t>("127.0.0.1", server.port()),
+        vdl::make_unique<vdl::binary_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    std::mutex mutex;
+    std::vector<uint8_t> statuses;
+    std::atomic<int> others{0};
+    const vdl::subscription_id_t id = device.subscribe(0x41,
+        [&mutex, &statuses](const vdl::response_t& frame) {
+            std::lock_guard<std::mutex> guard(mutex);
+            statuses.push_back(frame.data()[0]);
+        });
+    REQUIRE(id != 0);
+    REQUIRE(device.subscribe(0x42, [&others](const vdl::response_t&) { ++others; }) != 0);
+
+    // 空闲时到达的上报帧
+    REQUIRE(server.push(make_status_frame(1)));
+
+    // 在响应之前到达的上报帧不会被当作响应
+    server.set_prefix(make_status_frame(2));
+    auto result = device.execute(make_echo_command(0x30));
+    REQUIRE(result.has_value());
+    REQUIRE(result->function_code() == 0x10);
+    REQUIRE(result->payload() == vdl::bytes_t({0x30, 0x31}));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (statuses.size() >= 2) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        REQUIRE(statuses == std::vector<uint8_t>({1, 2}));
+    }
+    REQUIRE(others.load() == 0);
+    REQUIRE(device.unsubscribe(id));
+    REQUIRE_FALSE(device.unsubscribe(id));
+}
+
+TEST_CASE("reactor_device_t keeps receiving while a subscriber blocks", "[reactor][device][unsolicited]") {
+    echo_server_t server;
+    reactor_thread_t loop;
+    vdl::reactor_device_t device(loop.reactor(),
+        vdl::make_unique<vdl::tcp_transport_t>("127.0.0.1", server.port()),
+        vdl::make_unique<vdl::binary_codec_t>());
+    REQUIRE(device.connect().has_value());
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> delivered{0};
+    device.subscribe_all([released, &delivered](const vdl::response_t&) {
+        released.wait();
+        ++delivered;
+    });
+
+    REQUIRE(server.push(make_status_frame(1)));
+    REQUIRE(server.push(make_status_frame(2)));
+
+    // 订阅者被阻塞时请求照常完成
+    for (uint8_t i = 0; i < 4; ++i) {
+        auto result = device.execute(make_echo_command(i), 500);
+        REQUIRE(result.has_value());
+        REQUIRE(result->data()[0] == i);
+    }
+    REQUIRE(delivered.load() == 0);
+
+    release.set_value();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (delivered.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(delivered.load() == 2);
+    REQUIRE(device.unsolicited_dropped() == 0);
+}
+
+#endif  // _WIN32
@@ -6,6 +6,11 @@
 #include <catch.hpp>
 #include <vdl/protocol/response.hpp>
 
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
 // ============================================================================
 // response_t 基本测试
 // ============================================================================
@@ -164,3 +169,169 @@ TEST_CASE("response_status_t values", "[protocol][response]") {
     REQUIRE(static_cast<uint8_t>(vdl::response_status_t::timeout) == 0x03);
     REQUIRE(static_cast<uint8_t>(vdl::response_status_t::invalid) == 0xFF);
 }
+
+// ============================================================================
+// response_t 共享切片测试
+// ============================================================================
+
+TEST_CASE("response_t slice-backed views are zero-copy", "[protocol][response]") {
+    vdl::byte_slice_t frame(vdl::bytes_t{0xAA, 0x12, 0x34, 0x56, 0x78, 0xFF});
+
+    vdl::response_t resp;
+    resp.set_data_slice(frame.subslice(1, 4));
+    resp.set_raw_frame_slice(frame);
+
+    REQUIRE(resp.is_data_shared());
+    REQUIRE(resp.data_view().data() == frame.data() + 1);
+    REQUIRE(resp.raw_view().size() == 6);
+    REQUIRE(resp.data_size() == 4);
+    REQUIRE(resp.has_data());
+    REQUIRE(resp.get_uint16_be(0) == 0x1234);
+    REQUIRE(resp.get_uint32_le(0) == 0x78563412);
+
+    // data()/raw_frame() 是切片视图，payload() 才复制
+    REQUIRE(resp.data().data() == frame.data() + 1);
+    REQUIRE(resp.payload() == vdl::bytes_t({0x12, 0x34, 0x56, 0x78}));
+    REQUIRE(resp.is_data_shared());
+    REQUIRE(resp.raw_frame().data() == frame.data());
+    REQUIRE(resp.raw_frame().size() == 6);
+
+    // 获取可修改数据后转为自有数据
+    resp.mutable_data()[0] = 0x00;
+    REQUIRE_FALSE(resp.is_data_shared());
+    REQUIRE(resp.get_byte(0) == 0x00);
+    REQUIRE(frame.data()[1] == 0x12);
+
+    resp.clear_raw_frame();
+    REQUIRE(resp.raw_view().empty());
+    REQUIRE(resp.raw_frame().empty());
+}
+
+TEST_CASE("response_t const accessors are safe to call concurrently", "[protocol][response]") {
+    vdl::bytes_t bytes(256);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<vdl::byte_t>(i);
+    }
+    vdl::byte_slice_t frame(std::move(bytes));
+
+    vdl::response_t resp;
+    resp.set_data_slice(frame.subslice(4, 200));
+    resp.set_raw_frame_slice(frame);
+    const vdl::response_t& shared = resp;
+
+    // 多个只读者同时访问（如分发线程与观察者），各自看到同一份数据
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&shared, &mismatches] {
+            for (int i = 0; i < 200; ++i) {
+                const vdl::const_byte_span_t data = shared.data();
+                if (data.size() != 200 || data[0] != 4 || data[199] != 203 ||
+                    shared.raw_frame().size() != 256 || shared.get_byte(1) != 5) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (auto& t : readers) {
+        t.join();
+    }
+    REQUIRE(mismatches.load() == 0);
+    REQUIRE(resp.is_data_shared());
+}
+
+TEST_CASE("response_t set_data replaces slice", "[protocol][response]") {
+    vdl::byte_slice_t frame(vdl::bytes_t{0x01, 0x02});
+
+    vdl::response_t resp;
+    resp.set_data_slice(frame);
+    resp.set_data({0x09});
+
+    REQUIRE_FALSE(resp.is_data_shared());
+    REQUIRE(resp.data_size() == 1);
+    REQUIRE(resp.get_byte(0) == 0x09);
+}
+
+TEST_CASE("response_t read_array converts byte order in bulk", "[protocol][response][array]") {
+    // 125 个大端寄存器（Modbus 最大读取数）
+    vdl::bytes_t payload;
+    for (vdl::uint16_t i = 0; i < 125; ++i) {
+        const vdl::uint16_t value = static_cast<vdl::uint16_t>(0x0100 * i + 0x0A);
+        payload.push_back(static_cast<vdl::byte_t>(value >> 8));
+        payload.push_back(static_cast<vdl::byte_t>(value & 0xFF));
+    }
+    vdl::response_t resp;
+    resp.set_data(payload);
+
+    vdl::uint16_t regs[125] = {};
+    auto n = resp.read_array<vdl::uint16_t>(0, 125, vdl::byte_order_t::big, regs);
+    REQUIRE(n.value() == 125);
+    for (size_t i = 0; i < 125; ++i) {
+        REQUIRE(regs[i] == resp.get_uint16_be(i * 2));
+    }
+
+    std::vector<vdl::int32_t> words;
+    REQUIRE(resp.read_array(2, 10, vdl::byte_order_t::little, words).value() == 10);
+    REQUIRE(words.size() == 10);
+    REQUIRE(static_cast<vdl::uint32_t>(words[0]) == resp.get_uint32_le(2));
+
+    // 越界与输出区不足
+    REQUIRE(resp.read_array(1, 125, vdl::byte_order_t::big, words).error().code() ==
+            vdl::error_code_t::out_of_range);
+    REQUIRE(words.size() == 10);
+    REQUIRE(resp.read_array(0, 4, vdl::byte_order_t::big, vdl::span_t<vdl::uint16_t>(regs, 3))
+                .error().code() == vdl::error_code_t::invalid_size);
+}
+
+TEST_CASE("response_t read_array decodes floating point", "[protocol][response][array]") {
+    const float values[] = {1.5f, -2.25f, 1e-3f};
+    const double wide = 3.141592653589793;
+    vdl::bytes_t payload;
+    for (float f : values) {
+        vdl::uint32_t bits = 0;
+        std::memcpy(&bits, &f, 4);
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            payload.push_back(static_cast<vdl::byte_t>(bits >> shift));
+        }
+    }
+    vdl::uint64_t bits = 0;
+    std::memcpy(&bits, &wide, 8);
+    for (int shift = 0; shift < 64; shift += 8) {
+        payload.push_back(static_cast<vdl::byte_t>(bits >> shift));
+    }
+
+    vdl::response_t resp;
+    resp.set_data(payload);
+
+    float floats[3] = {};
+    REQUIRE(resp.read_array<float>(0, 3, vdl::byte_order_t::big, floats).has_value());
+    REQUIRE(floats[0] == 1.5f);
+    REQUIRE(floats[1] == -2.25f);
+    REQUIRE(floats[2] == 1e-3f);
+
+    double d = 0.0;
+    REQUIRE(resp.read_array<double>(12, 1, vdl::byte_order_t::little,
+                                    vdl::span_t<double>(&d, 1)).has_value());
+    REQUIRE(d == wide);
+}
+
+TEST_CASE("response_t view_array is zero-copy when byte order matches", "[protocol][response][array]") {
+    vdl::byte_slice_t frame(vdl::bytes_t{0x01, 0x00, 0x02, 0x00, 0x03, 0x00, 0x04, 0x00, 0x05});
+    vdl::response_t resp;
+    resp.set_data_slice(frame);
+
+    auto view = resp.view_array<vdl::uint16_t>(0, 4, vdl::host_byte_order());
+    REQUIRE(view.has_value());
+    REQUIRE(static_cast<const void*>(view->data()) == static_cast<const void*>(frame.data()));
+    REQUIRE(view->size() == 4);
+
+    const vdl::byte_order_t other = vdl::host_byte_order() == vdl::byte_order_t::little
+                                        ? vdl::byte_order_t::big
+                                        : vdl::byte_order_t::little;
+    REQUIRE(resp.view_array<vdl::uint16_t>(0, 4, other).error().code() ==
+            vdl::error_code_t::not_supported);
+    REQUIRE(resp.view_array<vdl::uint16_t>(1, 4, vdl::byte_order_t::native).error().code() ==
+            vdl::error_code_t::not_supported);
+    REQUIRE(resp.view_array<vdl::uint16_t>(0, 5, vdl::byte_order_t::native).error().code() ==
+            vdl::error_code_t::out_of_range);
+}
@@ -0,0 +1,209 @@
+/**
+ * @file test_thread_pool.cpp
+ * @brief 测试 thread_pool_t
+ */
+
+#include <catch.hpp>
+#include <vdl/core/thread_pool.hpp>
+#include <vdl/core/event_dispatcher.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// thread_pool_t 测试
+// ============================================================================
+
+TEST_CASE("thread_pool_t returns task results", "[core][thread_pool]") {
+    vdl::thread_pool_t pool(2);
+    REQUIRE(pool.thread_count() == 2);
+
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 10; ++i) {
+        results.push_back(pool.submit([i] { return i * i; }));
+    }
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(results[static_cast<size_t>(i)].get() == i * i);
+    }
+}
+
+TEST_CASE("thread_pool_t grow adds workers", "[core][thread_pool]") {
+    vdl::thread_pool_t pool(1);
+    pool.grow(3);
+    REQUIRE(pool.thread_count() == 3);
+    pool.grow(2);   // 不减少
+    REQUIRE(pool.thread_count() == 3);
+
+    auto result = pool.submit([] { return 7; });
+    REQUIRE(result.get() == 7);
+
+    pool.shutdown();
+    pool.grow(5);   // 关闭后无操作
+    REQUIRE(pool.thread_count() == 0);
+}
+
+TEST_CASE("thread_pool_t runs tasks concurrently", "[core][thread_pool]") {
+    vdl::thread_pool_t pool(3);
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+
+    std::vector<std::future<void>> results;
+    for (int i = 0; i < 3; ++i) {
+        results.push_back(pool.submit([&running, &peak] {
+            const int now = ++running;
+            int expected = peak.load();
+            while (now > expected && !peak.compare_exchange_weak(expected, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            --running;
+        }));
+    }
+    for (auto& f : results) {
+        f.get();
+    }
+    REQUIRE(peak.load() == 3);
+}
+
+TEST_CASE("thread_pool_t bounds its queue", "[core][thread_pool]") {
+    vdl::thread_pool_t pool(1, 1);
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+
+    auto blocker = pool.submit([gate] { gate.wait(); });
+    // 等待工作线程取走第一个任务
+    while (pool.pending() != 0) {
+        std::this_thread::yield();
+    }
+    auto queued = pool.submit([] {});
+    REQUIRE(pool.pending() == 1);
+
+    // 队列已满，第三个任务的提交被阻塞
+    std::atomic<bool> submitted{false};
+    std::thread producer([&pool, &submitted] {
+        pool.submit([] {}).wait();
+        submitted = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE_FALSE(submitted.load());
+
+    release.set_value();
+    producer.join();
+    REQUIRE(submitted.load());
+    blocker.get();
+    queued.get();
+}
+
+TEST_CASE("thread_pool_t drains queue on shutdown", "[core][thread_pool]") {
+    std::atomic<int> executed{0};
+    {
+        vdl::thread_pool_t pool(1);
+        for (int i = 0; i < 5; ++i) {
+            pool.submit([&executed] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                ++executed;
+            });
+        }
+        pool.shutdown();
+        REQUIRE_FALSE(pool.submit([] {}).valid());
+    }
+    REQUIRE(executed.load() == 5);
+}
+
+// ============================================================================
+// event_dispatcher_t 测试
+// ============================================================================
+
+TEST_CASE("event_dispatcher_t delivers events in order on its own thread", "[core][event]") {
+    vdl::event_dispatcher_t dispatcher(8);
+    std::vector<int> seen;
+    std::thread::id executor;
+    const std::thread::id caller = std::this_thread::get_id();
+
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(dispatcher.post([&seen, &executor, i] {
+            seen.push_back(i);
+            executor = std::this_thread::get_id();
+        }));
+    }
+    dispatcher.flush();
+
+    REQUIRE(seen.size() == 100u);
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(seen[static_cast<size_t>(i)] == i);
+    }
+    REQUIRE(executor != caller);
+    REQUIRE(dispatcher.delivered_count() == 100u);
+}
+
+TEST_CASE("event_dispatcher_t does not block producers on slow callbacks", "[core][event]") {
+    vdl::event_dispatcher_t dispatcher;
+    std::atomic<int> done{0};
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 5; ++i) {
+        dispatcher.post([&done] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            done.fetch_add(1);
+        });
+    }
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20));
+
+    dispatcher.flush();
+    REQUIRE(done.load() == 5);
+}
+
+TEST_CASE("event_dispatcher_t flush does not miss the completion wakeup", "[core][event]") {
+    vdl::event_dispatcher_t dispatcher;
+    std::atomic<int> runs{0};
+
+    // 事件刚执行完、flush() 刚登记等待者的交错反复出现
+    for (int i = 0; i < 5000; ++i) {
+        dispatcher.post([&runs] { runs.fetch_add(1, std::memory_order_relaxed); });
+        dispatcher.flush();
+        REQUIRE(runs.load(std::memory_order_relaxed) == i + 1);
+    }
+}
+
+TEST_CASE("event_dispatcher_t coalesces pending events", "[core][event]") {
+    vdl::event_dispatcher_t dispatcher;
+    auto flag = vdl::event_dispatcher_t::make_coalesce_flag();
+    std::atomic<int> runs{0};
+
+    // 阻塞分发线程，使合并事件在队列中排队
+    std::mutex gate;
+    gate.lock();
+    dispatcher.post([&gate] {
+        std::lock_guard<std::mutex> hold(gate);
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        dispatcher.post_coalesced(flag, [&runs] { runs.fetch_add(1); });
+    }
+    gate.unlock();
+    dispatcher.flush();
+
+    REQUIRE(runs.load() == 1);
+    REQUIRE(dispatcher.coalesced_count() == 9u);
+
+    // 执行后标志清除，新事件再次入队
+    dispatcher.post_coalesced(flag, [&runs] { runs.fetch_add(1); });
+    dispatcher.flush();
+    REQUIRE(runs.load() == 2);
+}
+
+TEST_CASE("event_dispatcher_t drains on stop and survives throwing callbacks", "[core][event]") {
+    std::atomic<int> runs{0};
+    {
+        vdl::event_dispatcher_t dispatcher;
+        dispatcher.post([] { throw std::runtime_error("callback failure"); });
+        for (int i = 0; i < 10; ++i) {
+            dispatcher.post([&runs] { runs.fetch_add(1); });
+        }
+    }
+    REQUIRE(runs.load() == 10);
+}
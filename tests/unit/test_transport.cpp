@@ -6,6 +6,19 @@
 #include <catch.hpp>
 #include <vdl/transport/transport.hpp>
 #include <vdl/transport/mock_transport.hpp>
+#include <vdl/transport/sim_transport.hpp>
+#include <vdl/transport/tcp_transport.hpp>
+#include <vdl/transport/serial_transport.hpp>
+#include <vdl/transport/capture_transport.hpp>
+#include <vdl/transport/replay_transport.hpp>
+#include <vdl/codec/binary_codec.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 // ============================================================================
 // mock_transport_t 基础测试
@@ -174,3 +187,968 @@ TEST_CASE("mock_transport_t flush_read", "[transport][mock]") {
     REQUIRE_FALSE(result.has_value());
     REQUIRE(result.error().code() == vdl::error_code_t::timeout);
 }
+
+// ============================================================================
+// 聚集/分散读写测试
+// ============================================================================
+
+namespace {
+
+// 每次 write 最多写出 chunk 字节，用于验证默认 writev 的短写处理
+class trickle_transport_t : public vdl::transport_base_t {
+public:
+    explicit trickle_transport_t(size_t chunk) : m_chunk(chunk) {}
+
+    vdl::result_t<void> open() override { return vdl::make_ok(); }
+    void close() override {}
+    bool is_open() const override { return true; }
+
+    vdl::result_t<size_t> read(vdl::byte_span_t buffer,
+                               vdl::milliseconds_t /*timeout_ms*/ = 0) override {
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            buffer[i] = static_cast<vdl::byte_t>(i);
+        }
+        return buffer.size();
+    }
+
+    vdl::result_t<size_t> write(vdl::const_byte_span_t data,
+                                vdl::milliseconds_t /*timeout_ms*/ = 0) override {
+        ++write_calls;
+        size_t n = std::min(m_chunk, data.size());
+        written.insert(written.end(), data.begin(), data.begin() + static_cast<std::ptrdiff_t>(n));
+        return n;
+    }
+
+    const char* type_name() const override { return "trickle"; }
+
+    vdl::bytes_t written;
+    size_t write_calls = 0;
+
+private:
+    size_t m_chunk;
+};
+
+}  // namespace
+
+TEST_CASE("transport_base_t writev_all handles short writes", "[transport][writev]") {
+    trickle_transport_t transport(3);
+
+    vdl::bytes_t a = {0x01, 0x02};
+    vdl::bytes_t b = {0x03, 0x04, 0x05, 0x06, 0x07};
+    vdl::bytes_t c = {0x08};
+    vdl::const_byte_span_t pieces[] = {
+        vdl::const_byte_span_t(a.data(), a.size()),
+        vdl::const_byte_span_t(),
+        vdl::const_byte_span_t(b.data(), b.size()),
+        vdl::const_byte_span_t(c.data(), c.size()),
+    };
+
+    auto result = transport.writev_all(vdl::span_t<const vdl::const_byte_span_t>(pieces, 4));
+    REQUIRE(result.has_value());
+    REQUIRE(transport.written == vdl::bytes_t({0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08}));
+}
+
+TEST_CASE("transport_base_t writev stops at first short write", "[transport][writev]") {
+    trickle_transport_t transport(3);
+
+    vdl::bytes_t a = {0x01, 0x02};
+    vdl::bytes_t b = {0x03, 0x04, 0x05, 0x06};
+    vdl::const_byte_span_t pieces[] = {
+        vdl::const_byte_span_t(a.data(), a.size()),
+        vdl::const_byte_span_t(b.data(), b.size()),
+    };
+
+    auto result = transport.writev(vdl::span_t<const vdl::const_byte_span_t>(pieces, 2));
+    REQUIRE(result.has_value());
+    REQUIRE(*result == 5);
+    REQUIRE(transport.write_calls == 2);
+}
+
+TEST_CASE("transport_base_t readv fills first buffer", "[transport][writev]") {
+    trickle_transport_t transport(3);
+
+    vdl::bytes_t first(4, 0xFF);
+    vdl::bytes_t second(4, 0xFF);
+    vdl::byte_span_t buffers[] = {
+        vdl::byte_span_t(),
+        vdl::byte_span_t(first.data(), first.size()),
+        vdl::byte_span_t(second.data(), second.size()),
+    };
+
+    auto result = transport.readv(vdl::span_t<const vdl::byte_span_t>(buffers, 3));
+    REQUIRE(result.has_value());
+    REQUIRE(*result == 4);
+    REQUIRE(first == vdl::bytes_t({0x00, 0x01, 0x02, 0x03}));
+    REQUIRE(second == vdl::bytes_t(4, 0xFF));
+}
+
+TEST_CASE("mock_transport_t writev writes all pieces in one call", "[transport][mock][writev]") {
+    vdl::mock_transport_t transport;
+    transport.open();
+
+    vdl::bytes_t a = {0xAA, 0xBB};
+    vdl::bytes_t b = {0xCC};
+    vdl::const_byte_span_t pieces[] = {
+        vdl::const_byte_span_t(a.data(), a.size()),
+        vdl::const_byte_span_t(b.data(), b.size()),
+    };
+
+    auto result = transport.writev_all(vdl::span_t<const vdl::const_byte_span_t>(pieces, 2));
+    REQUIRE(result.has_value());
+    REQUIRE(transport.write_call_count() == 1);
+    REQUIRE(transport.get_written_data() == vdl::bytes_t({0xAA, 0xBB, 0xCC}));
+}
+
+// ============================================================================
+// 服务请求测试
+// ============================================================================
+
+TEST_CASE("transport_base_t service request defaults to not_supported", "[transport][srq]") {
+    vdl::mock_transport_t transport;
+    transport.open();
+
+    auto srq = transport.wait_service_request(10);
+    REQUIRE_FALSE(srq.has_value());
+    REQUIRE(srq.error().code() == vdl::error_code_t::not_supported);
+    REQUIRE_FALSE(transport.read_status_byte().has_value());
+}
+
+TEST_CASE("mock_transport_t simulates service request", "[transport][mock][srq]") {
+    vdl::mock_transport_t transport;
+    transport.open();
+    transport.set_service_request_supported(true);
+
+    auto timeout = transport.wait_service_request(5);
+    REQUIRE_FALSE(timeout.has_value());
+    REQUIRE(timeout.error().code() == vdl::error_code_t::timeout);
+
+    std::thread raiser([&transport] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        transport.raise_service_request(0x60);
+    });
+    REQUIRE(transport.wait_service_request(2000).has_value());
+    raiser.join();
+
+    auto stb = transport.read_status_byte();
+    REQUIRE(stb.has_value());
+    REQUIRE(*stb == 0x60);
+    REQUIRE(transport.status_poll_count() == 1);
+}
+
+// ============================================================================
+// sim_transport_t 测试
+// ============================================================================
+
+namespace {
+
+// 原样回送所有请求字节
+size_t echo_responder(vdl::const_byte_span_t request, vdl::bytes_t& reply) {
+    reply.insert(reply.end(), request.begin(), request.end());
+    return request.size();
+}
+
+}  // namespace
+
+TEST_CASE("sim_transport_t delays replies by round trip latency", "[transport][sim]") {
+    vdl::sim_link_config_t link;
+    link.latency_us = 10000;
+    vdl::sim_transport_t transport(link);
+    transport.set_responder(echo_responder);
+    REQUIRE(transport.open().has_value());
+
+    const vdl::bytes_t request = {0x01, 0x02, 0x03};
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE(transport.write(vdl::const_byte_span_t(request.data(), request.size())).has_value());
+
+    // 请求到达前读取超时
+    vdl::bytes_t buffer(16);
+    auto early = transport.read(vdl::byte_span_t(buffer.data(), buffer.size()), 5);
+    REQUIRE_FALSE(early.has_value());
+    REQUIRE(early.error().code() == vdl::error_code_t::timeout);
+
+    auto result = transport.read(vdl::byte_span_t(buffer.data(), buffer.size()), 500);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    REQUIRE(result.has_value());
+    REQUIRE(*result == 3);
+    REQUIRE(elapsed >= std::chrono::milliseconds(20));
+    REQUIRE(std::equal(request.begin(), request.end(), buffer.begin()));
+}
+
+TEST_CASE("sim_transport_t delivers replies in chunks", "[transport][sim]") {
+    vdl::sim_link_config_t link;
+    link.read_chunk_size = 3;
+    vdl::sim_transport_t transport(link);
+    transport.set_responder(echo_responder);
+    REQUIRE(transport.open().has_value());
+
+    const vdl::bytes_t request = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    REQUIRE(transport.write(vdl::const_byte_span_t(request.data(), request.size())).has_value());
+
+    std::vector<size_t> sizes;
+    vdl::bytes_t buffer(16);
+    while (true) {
+        auto result = transport.read(vdl::byte_span_t(buffer.data(), buffer.size()), 10);
+        if (!result) {
+            break;
+        }
+        sizes.push_back(*result);
+    }
+    REQUIRE(sizes == std::vector<size_t>({3, 3, 3, 1}));
+    REQUIRE(transport.bytes_read() == 10);
+}
+
+TEST_CASE("sim_transport_t limits bandwidth", "[transport][sim]") {
+    vdl::sim_link_config_t link;
+    link.bandwidth_bps = 1000000;   // 1 MB/s：每个方向 10000 字节需要 10 ms
+    vdl::sim_transport_t transport(link);
+    transport.set_responder(echo_responder);
+    REQUIRE(transport.open().has_value());
+
+    const vdl::bytes_t request(10000, 0x55);
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE(transport.write(vdl::const_byte_span_t(request.data(), request.size())).has_value());
+
+    vdl::bytes_t buffer(request.size());
+    size_t total = 0;
+    while (total < buffer.size()) {
+        auto result = transport.read(vdl::byte_span_t(buffer.data() + total, buffer.size() - total), 500);
+        REQUIRE(result.has_value());
+        total += *result;
+    }
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+}
+
+TEST_CASE("sim_transport_t codec responder replies to decoded commands", "[transport][sim]") {
+    auto codec = std::make_shared<vdl::binary_codec_t>();
+    vdl::sim_transport_t transport;
+    transport.set_responder(vdl::make_codec_responder(codec,
+        [](const vdl::response_t& request) -> vdl::optional_t<vdl::command_t> {
+            if (request.function_code() == 0x7F) {
+                return tl::nullopt;   // 模拟不回复的命令
+            }
+            vdl::command_t reply;
+            reply.set_function_code(static_cast<uint8_t>(request.function_code() + 1));
+            return reply;
+        }));
+    REQUIRE(transport.open().has_value());
+
+    vdl::command_t silent;
+    silent.set_function_code(0x7F);
+    vdl::command_t query;
+    query.set_function_code(0x03);
+    auto silent_frame = codec->encode(silent);
+    auto query_frame = codec->encode(query);
+    REQUIRE(silent_frame.has_value());
+    REQUIRE(query_frame.has_value());
+
+    // 两帧一次写入，应答器逐帧处理
+    vdl::bytes_t both = *silent_frame;
+    both.insert(both.end(), query_frame->begin(), query_frame->end());
+    REQUIRE(transport.write(vdl::const_byte_span_t(both.data(), both.size())).has_value());
+
+    vdl::bytes_t buffer(64);
+    auto result = transport.read(vdl::byte_span_t(buffer.data(), buffer.size()), 100);
+    REQUIRE(result.has_value());
+    size_t consumed = 0;
+    auto decoded = codec->decode(vdl::const_byte_span_t(buffer.data(), *result), consumed);
+    REQUIRE(decoded.has_value());
+    REQUIRE(decoded->function_code() == 0x04);
+}
+
+// ============================================================================
+// 传输层统计测试
+// ============================================================================
+
+TEST_CASE("transport_counters_t buckets samples by power of two", "[transport][stats]") {
+    REQUIRE(vdl::transport_counters_t::bucket_of(0) == 0);
+    REQUIRE(vdl::transport_counters_t::bucket_of(1) == 1);
+    REQUIRE(vdl::transport_counters_t::bucket_of(2) == 2);
+    REQUIRE(vdl::transport_counters_t::bucket_of(3) == 2);
+    REQUIRE(vdl::transport_counters_t::bucket_of(4096) == 13);
+    REQUIRE(vdl::transport_counters_t::bucket_of(~uint64_t(0)) ==
+            vdl::transport_stats_t::k_histogram_buckets - 1);
+}
+
+TEST_CASE("transport_base_t counts calls, short reads and timeouts", "[transport][stats]") {
+    vdl::sim_link_config_t link;
+    link.read_chunk_size = 3;
+    vdl::sim_transport_t transport(link);
+    transport.set_responder(echo_responder);
+    REQUIRE(transport.open().has_value());
+    REQUIRE(transport.stats().read_calls == 0);
+
+    const vdl::bytes_t request = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    REQUIRE(transport.write(vdl::const_byte_span_t(request.data(), request.size())).has_value());
+
+    // 分段交付：3 + 3 + 3 + 1，随后一次超时
+    vdl::bytes_t buffer(16);
+    while (transport.read(vdl::byte_span_t(buffer.data(), buffer.size()), 10)) {
+    }
+
+    const vdl::i_transport_t& base = transport;
+    vdl::transport_stats_t stats = base.stats();
+    REQUIRE(stats.write_calls == 1);
+    REQUIRE(stats.bytes_written == 10);
+    REQUIRE(stats.short_writes == 0);
+    REQUIRE(stats.read_calls == 5);
+    REQUIRE(stats.bytes_read == 10);
+    REQUIRE(stats.short_reads == 4);
+    REQUIRE(stats.read_timeouts == 1);
+    REQUIRE(stats.read_errors == 0);
+    REQUIRE(stats.read_size_histogram[2] == 3);   // 3 字节
+    REQUIRE(stats.read_size_histogram[1] == 1);   // 1 字节
+    REQUIRE(stats.average_read_size() == Approx(2.5));
+
+    uint64_t timed = 0;
+    for (uint64_t count : stats.read_time_histogram) {
+        timed += count;
+    }
+    REQUIRE(timed == stats.read_calls);
+    // 超时的读取至少等待了 10ms（桶 14 起为 8192us 以上）
+    uint64_t slow = 0;
+    for (size_t i = 14; i < stats.read_time_histogram.size(); ++i) {
+        slow += stats.read_time_histogram[i];
+    }
+    REQUIRE(slow >= 1);
+
+    transport.reset_stats();
+    stats = transport.stats();
+    REQUIRE(stats.read_calls == 0);
+    REQUIRE(stats.bytes_written == 0);
+    REQUIRE(stats.read_time_histogram[0] == 0);
+}
+
+// ============================================================================
+// tcp_transport_t 测试（本机回环）
+// ============================================================================
+
+#ifndef _WIN32
+
+namespace {
+
+/**
+ * @brief 本机回环监听端口，接受一个连接
+ */
+class loopback_server_t {
+public:
+    loopback_server_t() {
+        m_listen = ::socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(m_listen, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+        ::listen(m_listen, 1);
+
+        socklen_t len = sizeof(addr);
+        ::getsockname(m_listen, reinterpret_cast<struct sockaddr*>(&addr), &len);
+        m_port = ntohs(addr.sin_port);
+    }
+
+    ~loopback_server_t() {
+        close_peer();
+        ::close(m_listen);
+    }
+
+    uint16_t port() const { return m_port; }
+
+    int accept_peer() {
+        m_peer = ::accept(m_listen, nullptr, nullptr);
+        return m_peer;
+    }
+
+    void send_text(const std::string& text) {
+        ::send(m_peer, text.data(), text.size(), 0);
+    }
+
+    std::string receive(size_t count) {
+        std::string text(count, '\0');
+        size_t received = 0;
+        while (received < count) {
+            const ssize_t n = ::recv(m_peer, &text[received], count - received, 0);
+            if (n <= 0) {
+                break;
+            }
+            received += static_cast<size_t>(n);
+        }
+        text.resize(received);
+        return text;
+    }
+
+    void close_peer() {
+        if (m_peer >= 0) {
+            ::close(m_peer);
+            m_peer = -1;
+        }
+    }
+
+private:
+    int m_listen = -1;
+    int m_peer = -1;
+    uint16_t m_port = 0;
+};
+
+}  // namespace
+
+TEST_CASE("tcp_transport_t exchanges data over loopback", "[transport][tcp]") {
+    loopback_server_t server;
+    vdl::tcp_transport_t transport("127.0.0.1", server.port());
+    REQUIRE(transport.open().has_value());
+    REQUIRE(transport.is_open());
+    REQUIRE(server.accept_peer() >= 0);
+
+    int no_delay = 0;
+    socklen_t len = sizeof(no_delay);
+    ::getsockopt(transport.native_handle(), IPPROTO_TCP, TCP_NODELAY, &no_delay, &len);
+    REQUIRE(no_delay != 0);
+
+    // 聚集写入一次发出头部和负载
+    const std::string head = "*IDN";
+    const std::string tail = "?\n";
+    const vdl::const_byte_span_t pieces[] = {
+        vdl::const_byte_span_t(reinterpret_cast<const vdl::byte_t*>(head.data()), head.size()),
+        vdl::const_byte_span_t(reinterpret_cast<const vdl::byte_t*>(tail.data()), tail.size()),
+    };
+    REQUIRE(transport.writev_all(vdl::span_t<const vdl::const_byte_span_t>(pieces, 2)).has_value());
+    REQUIRE(server.receive(6) == "*IDN?\n");
+
+    server.send_text("VDL,TCP,0,1.0\n");
+    vdl::bytes_t buffer(64);
+    size_t total = 0;
+    while (total < 14) {
+        auto result = transport.read(vdl::byte_span_t(buffer.data() + total, buffer.size() - total), 500);
+        REQUIRE(result.has_value());
+        total += *result;
+    }
+    REQUIRE(std::string(buffer.begin(), buffer.begin() + 14) == "VDL,TCP,0,1.0\n");
+
+    // read()/write() 经由 readv()/writev()，每次调用只计一次
+    const vdl::transport_stats_t stats = transport.stats();
+    REQUIRE(stats.bytes_written == 6);
+    REQUIRE(stats.write_calls >= 1);
+    REQUIRE(stats.bytes_read == 14);
+    REQUIRE(stats.read_calls >= 1);
+}
+
+TEST_CASE("tcp_transport_t read times out and detects peer close", "[transport][tcp]") {
+    loopback_server_t server;
+    vdl::tcp_transport_t transport("127.0.0.1", server.port());
+    REQUIRE(transport.open().has_value());
+    REQUIRE(server.accept_peer() >= 0);
+
+    vdl::bytes_t buffer(16);
+    const auto begin = std::chrono::steady_clock::now();
+    auto timeout = transport.read(vdl::make_span(buffer), 30);
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    REQUIRE_FALSE(timeout.has_value());
+    REQUIRE(timeout.error().code() == vdl::error_code_t::timeout);
+    REQUIRE(elapsed >= std::chrono::milliseconds(25));
+
+    server.close_peer();
+    auto closed = transport.read(vdl::make_span(buffer), 500);
+    REQUIRE_FALSE(closed.has_value());
+    REQUIRE(closed.error().code() == vdl::error_code_t::connection_closed);
+    REQUIRE_FALSE(transport.is_open());
+}
+
+TEST_CASE("tcp_transport_t applies socket options", "[transport][tcp]") {
+    loopback_server_t server;
+    vdl::tcp_options_t options;
+    options.keep_alive = true;
+    vdl::tcp_transport_t transport("localhost", server.port(), options);
+
+    REQUIRE(transport.config().read_buffer_size == 0);
+    vdl::transport_config_t config = transport.config();
+    config.read_buffer_size = 256 * 1024;
+    transport.set_config(config);
+
+    REQUIRE(transport.open().has_value());
+
+    int keep_alive = 0;
+    socklen_t len = sizeof(keep_alive);
+    ::getsockopt(transport.native_handle(), SOL_SOCKET, SO_KEEPALIVE, &keep_alive, &len);
+    REQUIRE(keep_alive != 0);
+
+    int rcvbuf = 0;
+    len = sizeof(rcvbuf);
+    ::getsockopt(transport.native_handle(), SOL_SOCKET, SO_RCVBUF, &rcvbuf, &len);
+    REQUIRE(rcvbuf >= 256 * 1024);
+}
+
+TEST_CASE("tcp_transport_t reports connection failures", "[transport][tcp]") {
+    uint16_t closed_port = 0;
+    {
+        loopback_server_t server;
+        closed_port = server.port();
+    }
+    vdl::tcp_transport_t refused("127.0.0.1", closed_port);
+    auto result = refused.open();
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().code() == vdl::error_code_t::connection_failed);
+    REQUIRE_FALSE(refused.is_open());
+
+    vdl::bytes_t buffer(4);
+    REQUIRE(refused.read(vdl::make_span(buffer)).error().code() ==
+            vdl::error_code_t::not_connected);
+}
+
+// ============================================================================
+// serial_transport_t 测试（伪终端）
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief 伪终端主端，从端路径交给 serial_transport_t
+ */
+class pty_pair_t {
+public:
+    pty_pair_t() {
+        m_master = ::posix_openpt(O_RDWR | O_NOCTTY);
+        ::grantpt(m_master);
+        ::unlockpt(m_master);
+        m_slave_path = ::ptsname(m_master);
+    }
+
+    ~pty_pair_t() {
+        ::close(m_master);
+    }
+
+    const std::string& slave_path() const { return m_slave_path; }
+
+    void send_text(const std::string& text) {
+        REQUIRE(::write(m_master, text.data(), text.size()) == static_cast<ssize_t>(text.size()));
+    }
+
+private:
+    int m_master = -1;
+    std::string m_slave_path;
+};
+
+std::string read_text(vdl::serial_transport_t& serial, size_t capacity,
+                      vdl::milliseconds_t timeout_ms = 500) {
+    vdl::bytes_t buffer(capacity);
+    auto result = serial.read(vdl::make_span(buffer), timeout_ms);
+    REQUIRE(result.has_value());
+    return std::string(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(*result));
+}
+
+}  // namespace
+
+TEST_CASE("serial_transport_t aggregates bytes within inter-character gap", "[transport][serial]") {
+    pty_pair_t pty;
+    vdl::serial_config_t config;
+    config.baud_rate = 115200;
+    config.inter_char_timeout_us = 50000;
+    vdl::serial_transport_t serial(pty.slave_path(), config);
+    REQUIRE(serial.open().has_value());
+
+    std::thread writer([&pty] {
+        pty.send_text("\x01\x03");
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        pty.send_text("\x04\x05");
+    });
+    const std::string frame = read_text(serial, 16);
+    writer.join();
+    REQUIRE(frame == "\x01\x03\x04\x05");
+
+    // 不按间隔聚合时返回已到达的数据
+    serial.set_inter_char_timeout_us(0);
+    pty.send_text("AB");
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    REQUIRE(read_text(serial, 16) == "AB");
+}
+
+TEST_CASE("serial_transport_t returns as soon as frame detector completes", "[transport][serial]") {
+    pty_pair_t pty;
+    vdl::serial_config_t config;
+    config.inter_char_timeout_us = 2000000;   // 足够长，只能靠帧检测提前返回
+    vdl::serial_transport_t serial(pty.slave_path(), config);
+    serial.set_frame_detector([](vdl::const_byte_span_t data) -> size_t {
+        return data.size() >= 4 ? 4 : 0;
+    });
+    REQUIRE(serial.open().has_value());
+
+    const auto begin = std::chrono::steady_clock::now();
+    pty.send_text("WXYZ");
+    REQUIRE(read_text(serial, 16) == "WXYZ");
+    REQUIRE(std::chrono::steady_clock::now() - begin < std::chrono::seconds(1));
+}
+
+TEST_CASE("serial_transport_t timeouts and configuration errors", "[transport][serial]") {
+    pty_pair_t pty;
+    vdl::serial_transport_t serial(pty.slave_path());
+    REQUIRE(serial.open().has_value());
+
+    vdl::bytes_t buffer(8);
+    auto timeout = serial.read(vdl::make_span(buffer), 20);
+    REQUIRE_FALSE(timeout.has_value());
+    REQUIRE(timeout.error().code() == vdl::error_code_t::timeout);
+
+    serial.close();
+    vdl::serial_config_t bad;
+    bad.baud_rate = 12345;
+    serial.set_serial_config(bad);
+    auto result = serial.open();
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().code() == vdl::error_code_t::invalid_argument);
+
+    vdl::serial_transport_t missing("/dev/vdl-no-such-tty");
+    REQUIRE_FALSE(missing.open().has_value());
+}
+
+TEST_CASE("modbus_rtu_frame_gap_us follows the spec", "[transport][serial]") {
+    REQUIRE(vdl::modbus_rtu_frame_gap_us(9600) == 4010);
+    REQUIRE(vdl::modbus_rtu_frame_gap_us(115200) == 1750);
+}
+
+// ============================================================================
+// capture_transport_t 测试
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief 测试用临时目录（析构时删除其中的文件）
+ */
+class temp_dir_t {
+public:
+    temp_dir_t() {
+        char pattern[] = "/tmp/vdl-capture-XXXXXX";
+        const char* dir = ::mkdtemp(pattern);
+        REQUIRE(dir != nullptr);
+        m_path = dir;
+    }
+
+    ~temp_dir_t() {
+        const std::string command = "rm -rf " + m_path;
+        (void)std::system(command.c_str());
+    }
+
+    std::string file(const std::string& name) const {
+        return m_path + "/" + name;
+    }
+
+private:
+    std::string m_path;
+};
+
+std::vector<vdl::capture_record_t> read_capture(const std::string& path,
+                                                 vdl::capture_reader_t& reader) {
+    REQUIRE(reader.open(path).has_value());
+    std::vector<vdl::capture_record_t> records;
+    vdl::capture_record_t record;
+    while (reader.next(record)) {
+        records.push_back(record);
+    }
+    return records;
+}
+
+std::string record_text(const vdl::capture_record_t& record) {
+    return std::string(record.data.begin(), record.data.end());
+}
+
+}  // namespace
+
+TEST_CASE("capture_transport_t records reads and writes", "[transport][capture]") {
+    temp_dir_t dir;
+    vdl::capture_config_t config;
+    config.path = dir.file("session.pcapng");
+    auto capture = std::make_shared<vdl::capture_file_t>(config);
+    REQUIRE(capture->open().has_value());
+
+    auto* mock = new vdl::mock_transport_t();
+    vdl::capture_transport_t transport(vdl::transport_ptr_t(mock), capture, "dmm");
+    REQUIRE(std::string(transport.type_name()) == "mock");
+    REQUIRE(transport.open().has_value());
+
+    const std::string request = "*IDN?\n";
+    REQUIRE(transport.write_all(vdl::const_byte_span_t(
+        reinterpret_cast<const uint8_t*>(request.data()), request.size())).has_value());
+    mock->set_response({'O', 'K', '\n'});
+    vdl::bytes_t buffer(16);
+    auto read = transport.read(vdl::make_span(buffer));
+    REQUIRE(read.has_value());
+    REQUIRE(*read == 3);
+
+    // 超时不产生记录
+    REQUIRE_FALSE(transport.read(vdl::make_span(buffer)).has_value());
+    REQUIRE(capture->record_count() == 2);
+    capture->close();
+
+    vdl::capture_reader_t reader;
+    auto records = read_capture(config.path, reader);
+    REQUIRE(records.size() == 2);
+    REQUIRE(records[0].direction == vdl::capture_direction_t::outbound);
+    REQUIRE(record_text(records[0]) == request);
+    REQUIRE(records[1].direction == vdl::capture_direction_t::inbound);
+    REQUIRE(record_text(records[1]) == "OK\n");
+    REQUIRE(records[1].timestamp >= records[0].timestamp);
+    REQUIRE(records[0].interface_id == transport.interface_id());
+    REQUIRE(reader.interfaces().size() == 1);
+    REQUIRE(reader.interfaces()[0] == "dmm");
+}
+
+TEST_CASE("capture_file_t separates devices and truncates to snap length", "[transport][capture]") {
+    temp_dir_t dir;
+    vdl::capture_config_t config;
+    config.path = dir.file("multi.pcapng");
+    config.snap_length = 4;
+    auto capture = std::make_shared<vdl::capture_file_t>(config);
+    const uint32_t psu = capture->add_interface("psu");
+    REQUIRE(capture->open().has_value());
+    const uint32_t scope = capture->add_interface("scope");
+    REQUIRE(psu != scope);
+
+    const uint8_t payload[] = {1, 2, 3, 4, 5, 6, 7};
+    REQUIRE(capture->record(psu, vdl::capture_direction_t::outbound, vdl::const_byte_span_t(payload, 7)));
+    REQUIRE(capture->record(scope, vdl::capture_direction_t::inbound, vdl::const_byte_span_t(payload, 2)));
+    capture->close();
+
+    vdl::capture_reader_t reader;
+    auto records = read_capture(config.path, reader);
+    REQUIRE(records.size() == 2);
+    REQUIRE(records[0].interface_id == psu);
+    REQUIRE(records[0].data.size() == 4);
+    REQUIRE(records[0].original_length == 7);
+    REQUIRE(records[1].interface_id == scope);
+    REQUIRE(records[1].data.size() == 2);
+    REQUIRE(reader.interfaces().size() == 2);
+    REQUIRE(reader.interfaces()[1] == "scope");
+
+    // 关闭后的记录被丢弃
+    REQUIRE_FALSE(capture->record(psu, vdl::capture_direction_t::outbound, vdl::const_byte_span_t(payload, 1)));
+    REQUIRE(capture->dropped_count() == 1);
+}
+
+TEST_CASE("capture_file_t rolls over at the size limit", "[transport][capture]") {
+    temp_dir_t dir;
+    vdl::capture_config_t config;
+    config.path = dir.file("roll.pcapng");
+    config.file_size = 1024;
+    config.snap_length = 64;
+    vdl::capture_file_t capture(config);
+    const uint32_t id = capture.add_interface("dev");
+    REQUIRE(capture.open().has_value());
+
+    const uint8_t payload[32] = {0};
+    const int k_records = 100;
+    for (int i = 0; i < k_records; ++i) {
+        REQUIRE(capture.record(id, vdl::capture_direction_t::inbound, vdl::const_byte_span_t(payload, 32)));
+    }
+    const size_t files = capture.file_count();
+    REQUIRE(files > 1);
+    capture.close();
+
+    size_t total = 0;
+    for (size_t i = 0; i < files; ++i) {
+        vdl::capture_reader_t reader;
+        auto records = read_capture(capture.file_path(i), reader);
+        REQUIRE(reader.interfaces().size() == 1);
+        total += records.size();
+    }
+    REQUIRE(total == static_cast<size_t>(k_records));
+}
+
+TEST_CASE("capture_file_t accepts concurrent writers across rollovers", "[transport][capture]") {
+    temp_dir_t dir;
+    vdl::capture_config_t config;
+    config.path = dir.file("threads.pcapng");
+    config.file_size = 4096;
+    config.snap_length = 64;
+    vdl::capture_file_t capture(config);
+    REQUIRE(capture.open().has_value());
+
+    const int k_threads = 4;
+    const int k_per_thread = 200;
+    std::vector<uint32_t> ids;
+    for (int t = 0; t < k_threads; ++t) {
+        ids.push_back(capture.add_interface("dev" + std::to_string(t)));
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < k_threads; ++t) {
+        threads.emplace_back([&capture, &ids, t] {
+            uint8_t payload[8];
+            for (int i = 0; i < k_per_thread; ++i) {
+                std::memset(payload, t, sizeof(payload));
+                capture.record(ids[static_cast<size_t>(t)], vdl::capture_direction_t::outbound,
+                               vdl::const_byte_span_t(payload, sizeof(payload)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const size_t files = capture.file_count();
+    capture.close();
+    REQUIRE(capture.record_count() == static_cast<uint64_t>(k_threads * k_per_thread));
+
+    std::vector<int> per_device(k_threads, 0);
+    for (size_t i = 0; i < files; ++i) {
+        vdl::capture_reader_t reader;
+        for (const auto& record : read_capture(capture.file_path(i), reader)) {
+            REQUIRE(record.interface_id < static_cast<uint32_t>(k_threads));
+            REQUIRE(record.data[0] == static_cast<uint8_t>(record.interface_id));
+            ++per_device[record.interface_id];
+        }
+    }
+    for (int count : per_device) {
+        REQUIRE(count == k_per_thread);
+    }
+}
+
+TEST_CASE("capture_reader_t rejects foreign files", "[transport][capture]") {
+    temp_dir_t dir;
+    vdl::capture_reader_t reader;
+    auto missing = reader.open(dir.file("missing.pcapng"));
+    REQUIRE_FALSE(missing.has_value());
+    REQUIRE(missing.error().code() == vdl::error_code_t::file_not_found);
+
+    const std::string path = dir.file("garbage.bin");
+    FILE* file = std::fopen(path.c_str(), "wb");
+    REQUIRE(file != nullptr);
+    const char junk[64] = "not a capture";
+    std::fwrite(junk, 1, sizeof(junk), file);
+    std::fclose(file);
+    auto garbage = reader.open(path);
+    REQUIRE_FALSE(garbage.has_value());
+    REQUIRE(garbage.error().code() == vdl::error_code_t::invalid_format);
+}
+
+// ============================================================================
+// replay_transport_t 测试
+// ============================================================================
+
+namespace {
+
+vdl::const_byte_span_t text_span(const std::string& text) {
+    return vdl::const_byte_span_t(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+// 写出一个抓包：dmm 一问一答两轮，psu 一条响应
+void write_session(const std::string& path, int reply_delay_ms = 0) {
+    vdl::capture_config_t config;
+    config.path = path;
+    vdl::capture_file_t capture(config);
+    const uint32_t dmm = capture.add_interface("dmm");
+    const uint32_t psu = capture.add_interface("psu");
+    REQUIRE(capture.open().has_value());
+
+    capture.record(dmm, vdl::capture_direction_t::outbound, text_span("MEAS?\n"));
+    if (reply_delay_ms > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(reply_delay_ms));
+    }
+    capture.record(dmm, vdl::capture_direction_t::inbound, text_span("1.5"));
+    capture.record(dmm, vdl::capture_direction_t::inbound, text_span("\n"));
+    capture.record(psu, vdl::capture_direction_t::inbound, text_span("PSU\n"));
+    capture.record(dmm, vdl::capture_direction_t::outbound, text_span("*IDN?\n"));
+    capture.record(dmm, vdl::capture_direction_t::inbound, text_span("VDL,DMM\n"));
+    capture.close();
+}
+
+std::string replay_read(vdl::replay_transport_t& replay, size_t capacity = 64) {
+    vdl::bytes_t buffer(capacity);
+    auto result = replay.read(vdl::make_span(buffer), 200);
+    REQUIRE(result.has_value());
+    return std::string(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(*result));
+}
+
+}  // namespace
+
+TEST_CASE("replay_transport_t serves recorded chunks and verifies writes", "[transport][replay]") {
+    temp_dir_t dir;
+    const std::string path = dir.file("session.pcapng");
+    write_session(path);
+
+    vdl::replay_config_t config;
+    config.device_name = "dmm";
+    config.verify_writes = true;
+    vdl::replay_transport_t replay(path, config);
+    REQUIRE(replay.open().has_value());
+    REQUIRE(std::string(replay.type_name()) == "replay");
+    REQUIRE(replay.inbound_count() == 3);
+    REQUIRE(replay.outbound_count() == 2);
+
+    // 写入的分段方式与抓包无关
+    REQUIRE(replay.write(text_span("MEA")).has_value());
+    REQUIRE(replay.write(text_span("S?\n")).has_value());
+    REQUIRE(replay_read(replay) == "1.5");
+    REQUIRE(replay_read(replay) == "\n");
+
+    auto mismatch = replay.write(text_span("*RST\n"));
+    REQUIRE_FALSE(mismatch.has_value());
+    REQUIRE(mismatch.error().code() == vdl::error_code_t::protocol_error);
+    REQUIRE(replay.mismatch_count() == 1);
+
+    replay.rewind();
+    REQUIRE(replay.write(text_span("MEAS?\n")).has_value());
+    REQUIRE(replay_read(replay, 2) == "1.");
+    REQUIRE(replay_read(replay, 2) == "5");
+    REQUIRE(replay_read(replay) == "\n");
+    REQUIRE(replay.write(text_span("*IDN?\n")).has_value());
+    REQUIRE(replay_read(replay) == "VDL,DMM\n");
+    REQUIRE(replay.finished());
+
+    vdl::bytes_t buffer(8);
+    auto end = replay.read(vdl::make_span(buffer), 10);
+    REQUIRE_FALSE(end.has_value());
+    REQUIRE(end.error().code() == vdl::error_code_t::timeout);
+    REQUIRE_FALSE(replay.write(text_span("x")).has_value());
+    REQUIRE(replay.stats().read_calls == 7);
+}
+
+TEST_CASE("replay_transport_t replays all devices and loops", "[transport][replay]") {
+    temp_dir_t dir;
+    const std::string path = dir.file("session.pcapng");
+    write_session(path);
+
+    vdl::replay_config_t config;
+    config.loop = true;
+    vdl::replay_transport_t replay(path, config);
+    REQUIRE(replay.open().has_value());
+    REQUIRE(replay.inbound_count() == 4);
+
+    std::string first;
+    for (size_t i = 0; i < replay.inbound_count(); ++i) {
+        first += replay_read(replay);
+    }
+    REQUIRE(first == "1.5\nPSU\nVDL,DMM\n");
+    REQUIRE(replay_read(replay) == "1.5");
+
+    vdl::replay_transport_t missing(dir.file("missing.pcapng"));
+    REQUIRE_FALSE(missing.open().has_value());
+    REQUIRE_FALSE(missing.is_open());
+}
+
+TEST_CASE("replay_transport_t keeps original reply timing", "[transport][replay]") {
+    temp_dir_t dir;
+    const std::string path = dir.file("timed.pcapng");
+    write_session(path, 60);
+
+    vdl::replay_config_t config;
+    config.device_name = "dmm";
+    config.timing = vdl::replay_timing_t::original;
+    vdl::replay_transport_t replay(path, config);
+    REQUIRE(replay.open().has_value());
+
+    REQUIRE(replay.write(text_span("MEAS?\n")).has_value());
+    vdl::bytes_t buffer(16);
+    auto early = replay.read(vdl::make_span(buffer), 10);
+    REQUIRE_FALSE(early.has_value());
+    REQUIRE(early.error().code() == vdl::error_code_t::timeout);
+
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE(replay_read(replay) == "1.5");
+    const auto waited = std::chrono::steady_clock::now() - start;
+    REQUIRE(waited >= std::chrono::milliseconds(30));
+
+    // 加速回放时间隔按 speed 缩短
+    config.speed = 1000.0;
+    vdl::replay_transport_t fast(path, config);
+    REQUIRE(fast.open().has_value());
+    REQUIRE(fast.write(text_span("MEAS?\n")).has_value());
+    REQUIRE(fast.read(vdl::make_span(buffer), 50).has_value());
+}
+
+#endif  // _WIN32
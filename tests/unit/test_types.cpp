@@ -5,7 +5,11 @@
 
 #include <catch.hpp>
 #include <vdl/core/types.hpp>
+#include <vdl/core/byte_swap.hpp>
+#include <vdl/core/deadline.hpp>
 
+#include <chrono>
+#include <thread>
 #include <vector>
 
 // ============================================================================
@@ -176,3 +180,78 @@ TEST_CASE("const span_t is read-only", "[core][types][span]") {
     // span[0] = 100;  // 编译错误
     REQUIRE(span[0] == 1);
 }
+
+// ============================================================================
+// deadline_t / cancellation_token_t 测试
+// ============================================================================
+
+TEST_CASE("deadline_t reports remaining time", "[core][deadline]") {
+    vdl::deadline_t deadline = vdl::deadline_t::after(1000);
+    REQUIRE_FALSE(deadline.expired());
+    REQUIRE(deadline.remaining_ms() > 900);
+    REQUIRE(deadline.remaining_ms() <= 1000);
+    REQUIRE(deadline.remaining_ms(10) == 10);
+
+    vdl::deadline_t passed = vdl::deadline_t::after(0);
+    REQUIRE(passed.expired());
+    REQUIRE(passed.remaining_ms() == 0);
+
+    // 未到期时至少剩 1 ms，不会被传输层当成“使用默认超时”
+    vdl::deadline_t soon = vdl::deadline_t::after(1);
+    REQUIRE((soon.expired() || soon.remaining_ms() == 1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    REQUIRE(soon.expired());
+
+    vdl::deadline_t never = vdl::deadline_t::never();
+    REQUIRE(never.is_never());
+    REQUIRE_FALSE(never.expired());
+    REQUIRE(never.remaining_ms() > 1000000);
+}
+
+TEST_CASE("cancellation_token_t copies share state", "[core][deadline]") {
+    vdl::cancellation_token_t token;
+    vdl::cancellation_token_t copy = token;
+    REQUIRE_FALSE(copy.cancelled());
+
+    std::thread([token] { token.cancel(); }).join();
+    REQUIRE(copy.cancelled());
+
+    copy.reset();
+    REQUIRE_FALSE(token.cancelled());
+}
+
+// ============================================================================
+// 字节序转换测试
+// ============================================================================
+
+TEST_CASE("byte_swap scalar conversions", "[core][types][byte_swap]") {
+    REQUIRE(vdl::byte_swap(static_cast<vdl::uint16_t>(0x1234)) == 0x3412);
+    REQUIRE(vdl::byte_swap(static_cast<vdl::uint32_t>(0x12345678u)) == 0x78563412u);
+    REQUIRE(vdl::byte_swap(static_cast<vdl::uint64_t>(0x0102030405060708ull)) == 0x0807060504030201ull);
+    REQUIRE_FALSE(vdl::needs_byte_swap(vdl::byte_order_t::native));
+    REQUIRE_FALSE(vdl::needs_byte_swap(vdl::host_byte_order()));
+}
+
+TEST_CASE("byte_swap_copy handles every width and tail length", "[core][types][byte_swap]") {
+    const size_t widths[] = {1, 2, 3, 4, 8};
+    for (size_t width : widths) {
+        for (size_t count = 0; count < 21; ++count) {
+            std::vector<vdl::byte_t> src(width * count);
+            for (size_t i = 0; i < src.size(); ++i) {
+                src[i] = static_cast<vdl::byte_t>(i * 7 + 1);
+            }
+            std::vector<vdl::byte_t> dst(src.size());
+            vdl::byte_swap_copy(dst.data(), src.data(), count, width);
+
+            std::vector<vdl::byte_t> in_place = src;
+            vdl::byte_swap_in_place(in_place.data(), count, width);
+
+            for (size_t e = 0; e < count; ++e) {
+                for (size_t b = 0; b < width; ++b) {
+                    REQUIRE(dst[e * width + b] == src[e * width + (width - 1 - b)]);
+                }
+            }
+            REQUIRE(in_place == dst);
+        }
+    }
+}